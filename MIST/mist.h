@@ -1,74 +1,338 @@
-/**
-********************************************************************************
-* @file     mist.h
-* @author   Bachmann electronic GmbH
-* @version  $Revision: 3.90 $ $LastChangedBy: BE $
-* @date     $LastChangeDate: 2013-06-10 11:00:00 $
-*
-* @brief    This file contains all definitions and declarations which are
-*           exported by the module and can be used by other modules
-*           on other CPUs.
-*
-********************************************************************************
-* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
-*******************************************************************************/
-
-/* Avoid problems with multiple including */
-#ifndef MIST__H
-#define MIST__H
-
-
-/*--- Defines ---*/
-
-/* Possible SMI's and SVI's (ATTENTION: SMI numbers must be even!) */
-#define MIST_PROC_APPSTAT    100  /* SVI example */
-#define MIST_PROC_DEMOCALL   102  /* SMI example */
-
-/* Possible error codes of software module */
-#define MIST_E_OK            0    /* Everything ok */
-#define MIST_E_FAILED       -1    /* General error */
-
-
-/*--- Structures ---*/
-
-/* Structure for SVI-call MIST_PROC_APPSTAT */
-typedef struct
-{
-    BOOL8   Stop;                       /* Stop application ? */
-}
-MIST_APPSTAT_C;
-
-/* Structure for SVI-Reply MIST_PROC_APPSTAT */
-typedef struct
-{
-    UINT32  RetCode;                    /* Return code */
-    UINT32  EventCount;                 /* Event counter */
-    UINT32  DelayTime;                  /* Delay for chaser light */
-    BOOL8   Stop;                       /* Stop chaser light */
-}
-MIST_APPSTAT_R;
-
-/* Structure for SVI-call MIST_DEMOCALL */
-typedef struct
-{
-    UINT32  Spare;                      /* Not used, 0 for now */
-}
-MIST_DEMOCALL_C;
-
-/* Structure for SVI-Reply MIST_DEMOCALL */
-typedef struct
-{
-    SINT32  RetCode;                    /* OK or error code */
-    UINT32  CallCount;                  /* Number of calls */
-    CHAR    String[128];                /* String */
-}
-MIST_DEMOCALL_R;
-
-
-/*--- Function prototyping ---*/
-
-
-/*--- Variable definitions ---*/
-
-
-#endif
+/**
+********************************************************************************
+* @file     mist.h
+* @author   Bachmann electronic GmbH
+* @version  $Revision: 3.90 $ $LastChangedBy: BE $
+* @date     $LastChangeDate: 2013-06-10 11:00:00 $
+*
+* @brief    This file contains all definitions and declarations which are
+*           exported by the module and can be used by other modules
+*           on other CPUs.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef MIST__H
+#define MIST__H
+
+
+/*--- Defines ---*/
+
+/* Possible SMI's and SVI's (ATTENTION: SMI numbers must be even!) */
+#define MIST_PROC_APPSTAT    100  /* SVI example */
+#define MIST_PROC_DEMOCALL   102  /* SMI example */
+#define MIST_PROC_GETEVENTS  104  /* Read overrun events of the tasks */
+#define MIST_PROC_GETVAR     106  /* Read a variable of the process image of a task */
+#define MIST_PROC_SETVAR     108  /* Write an input variable of the process image of a task */
+#define MIST_PROC_TRCDUMP    110  /* Write the cycle traces of the tasks to a file */
+#define MIST_PROC_SVIFIND    112  /* Resolve names of SVI variables to handles */
+#define MIST_PROC_SVIREAD    114  /* Read a list of SVI variables by their handles */
+#define MIST_PROC_SVISUB     116  /* Subscribe to the changes of a list of SVI variables */
+#define MIST_PROC_SVIUPDATE  118  /* Read the changed values of a subscription */
+#define MIST_PROC_SVIUNSUB   120  /* Cancel a subscription */
+
+/* Overrun policies of the tasks (mconfig OverrunPolicy) */
+#define MIST_OVR_CATCHUP     0    /* catch up a backlog of up to CatchUpMax cycles, drop larger ones */
+#define MIST_OVR_SKIP        1    /* drop the missed cycles, run the latest one at once */
+#define MIST_OVR_PHASE       2    /* run at once, the following cycles are timed from now */
+#define MIST_OVR_ABORT       3    /* stop the cycles of the task until the module is restarted */
+
+/* Export of the ST program variables to the SVI (mconfig SviExport) */
+#define MIST_SVIEXP_OFF      0    /* none */
+#define MIST_SVIEXP_ATTR     1    /* variables declared with {attribute 'svi' := 'r' | 'rw'} */
+#define MIST_SVIEXP_ALL      2    /* all except VAR_TEMP and {attribute 'svi' := 'none'}, read only by default */
+
+/* Sizes for MIST_PROC_GETEVENTS */
+#define MIST_EVT_NAMELEN     16   /* max. length of the task name incl. termination */
+#define MIST_EVT_MAXREPLY    32   /* max. number of events in one reply */
+
+/* Sizes for MIST_PROC_GETVAR and MIST_PROC_SETVAR */
+#define MIST_IMG_NAMELEN     32   /* max. length of the variable name incl. termination */
+#define MIST_IMG_MAXDATA     256  /* max. size of a variable in bytes */
+
+/* Sizes for MIST_PROC_TRCDUMP */
+#define MIST_TRC_PATHLEN     128  /* max. length of the file name incl. termination */
+
+/* Sizes for MIST_PROC_SVIFIND and MIST_PROC_SVIREAD */
+#define MIST_SVI_MAXLIST     256  /* max. number of variables in one call */
+#define MIST_SVI_NAMEBUF     8192 /* max. size of the names in one call */
+#define MIST_SVI_MAXDATA     8192 /* max. size of the values in one reply */
+#define MIST_SVI_NOHANDLE    0xFFFFFFFF /* variable not found */
+
+/* Sizes for MIST_PROC_SVISUB and MIST_PROC_SVIUPDATE */
+#define MIST_SVI_MAXSUBS     16   /* max. number of subscriptions, the least recently used one is replaced */
+#define MIST_SVI_MAXUPDATE   (MIST_SVI_MAXDATA + MIST_SVI_MAXLIST * 4)  /* max. size of the changes in one reply */
+
+/* Possible error codes of software module */
+#define MIST_E_OK            0    /* Everything ok */
+#define MIST_E_FAILED       -1    /* General error */
+
+
+/*--- Structures ---*/
+
+/* Structure for SVI-call MIST_PROC_APPSTAT */
+typedef struct
+{
+    BOOL8   Stop;                       /* Stop application ? */
+}
+MIST_APPSTAT_C;
+
+/* Structure for SVI-Reply MIST_PROC_APPSTAT */
+typedef struct
+{
+    UINT32  RetCode;                    /* Return code */
+    UINT32  EventCount;                 /* Event counter */
+    UINT32  DelayTime;                  /* Delay for chaser light */
+    BOOL8   Stop;                       /* Stop chaser light */
+}
+MIST_APPSTAT_R;
+
+/* Structure for SVI-call MIST_DEMOCALL */
+typedef struct
+{
+    UINT32  Spare;                      /* Not used, 0 for now */
+}
+MIST_DEMOCALL_C;
+
+/* Structure for SVI-Reply MIST_DEMOCALL */
+typedef struct
+{
+    SINT32  RetCode;                    /* OK or error code */
+    UINT32  CallCount;                  /* Number of calls */
+    CHAR    String[128];                /* String */
+}
+MIST_DEMOCALL_R;
+
+
+/* Overrun event of a task */
+typedef struct MIST_EVENT
+{
+    UINT32  Seq;                        /* Sequence number, starting with 1 */
+    UINT32  Time;                       /* Time of day in s */
+    UINT32  ProcTime;                   /* Processor time in us */
+    CHAR    TaskName[MIST_EVT_NAMELEN]; /* Task which has overrun */
+    UINT32  Policy;                     /* Overrun policy of the task, MIST_OVR_xxx */
+    UINT32  Late;                       /* Delay of the cycle start in us */
+    UINT32  Skipped;                    /* Number of cycles dropped */
+}
+MIST_EVENT;
+
+/* Structure for SMI-call MIST_PROC_GETEVENTS */
+typedef struct
+{
+    UINT32  FirstSeq;                   /* First event to read, 0 = oldest one available */
+    UINT32  MaxEvents;                  /* Max. number of events, up to MIST_EVT_MAXREPLY */
+}
+MIST_GETEVENTS_C;
+
+/* Structure for SMI-Reply MIST_PROC_GETEVENTS */
+typedef struct
+{
+    SINT32  RetCode;                    /* OK or error code */
+    UINT32  NextSeq;                    /* FirstSeq for the following call */
+    UINT32  NbOfLost;                   /* Events overwritten before they could be read */
+    UINT32  NbOfEvents;                 /* Number of valid entries in Event[] */
+    MIST_EVENT Event[MIST_EVT_MAXREPLY]; /* Events, only NbOfEvents are sent */
+}
+MIST_GETEVENTS_R;
+
+/*
+ * Structure for SMI-call MIST_PROC_GETVAR
+ * VAR_INPUT and VAR_OUTPUT variables of the ST program of a task, outputs
+ * as of the end of the last cycle. The value is in the byte order of the CPU.
+ */
+typedef struct
+{
+    CHAR    TaskName[MIST_EVT_NAMELEN]; /* Task name or configuration group, e.g. "ControlTask" */
+    CHAR    VarName[MIST_IMG_NAMELEN];  /* Variable name, case insensitive */
+}
+MIST_GETVAR_C;
+
+/* Structure for SMI-Reply MIST_PROC_GETVAR */
+typedef struct
+{
+    SINT32  RetCode;                    /* OK or error code */
+    UINT32  Cycle;                      /* Outputs: cycle of the value, inputs: number of writes */
+    UINT32  Size;                       /* Size of the variable in bytes */
+    UINT8   Data[MIST_IMG_MAXDATA];     /* Value, only Size bytes are sent */
+}
+MIST_GETVAR_R;
+
+/*
+ * Structure for SMI-call MIST_PROC_SETVAR
+ * VAR_INPUT variables only, the program gets the value at the start
+ * of its next cycle.
+ */
+typedef struct
+{
+    CHAR    TaskName[MIST_EVT_NAMELEN]; /* Task name or configuration group, e.g. "ControlTask" */
+    CHAR    VarName[MIST_IMG_NAMELEN];  /* Variable name, case insensitive */
+    UINT32  Size;                       /* Size of the variable in bytes */
+    UINT8   Data[MIST_IMG_MAXDATA];     /* Value, only Size bytes need to be sent */
+}
+MIST_SETVAR_C;
+
+/* Structure for SMI-Reply MIST_PROC_SETVAR */
+typedef struct
+{
+    SINT32  RetCode;                    /* OK or error code */
+}
+MIST_SETVAR_R;
+
+/*
+ * Structure for SMI-call MIST_PROC_TRCDUMP
+ * The file is overwritten, see tools/mist_trc2json.c for its format.
+ */
+typedef struct
+{
+    CHAR    FileName[MIST_TRC_PATHLEN]; /* File to be written, "" = mconfig (Trace)File */
+}
+MIST_TRCDUMP_C;
+
+/* Structure for SMI-Reply MIST_PROC_TRCDUMP */
+typedef struct
+{
+    SINT32  RetCode;                    /* OK or error code */
+    UINT32  NbOfRecords;                /* Number of records written */
+}
+MIST_TRCDUMP_R;
+
+/*
+ * Structure for SMI-call MIST_PROC_SVIFIND
+ * Names of SVI variables one after the other, each terminated by 0,
+ * only the used part of Names needs to be sent.
+ */
+typedef struct
+{
+    UINT32  NbOfNames;                  /* Number of names, max. MIST_SVI_MAXLIST */
+    CHAR    Names[MIST_SVI_NAMEBUF];    /* Names, e.g. "CycleCounter\0ControlTask/ExecMax\0" */
+}
+MIST_SVIFIND_C;
+
+/* A variable of the reply MIST_PROC_SVIFIND */
+typedef struct
+{
+    UINT32  Handle;                     /* Handle for MIST_PROC_SVIREAD, MIST_SVI_NOHANDLE = not found */
+    UINT32  Format;                     /* Format and access type, SVI_F_xxx */
+    UINT32  Size;                       /* Size in bytes */
+}
+MIST_SVI_INFO;
+
+/* Structure for SMI-Reply MIST_PROC_SVIFIND */
+typedef struct
+{
+    SINT32  RetCode;                    /* OK or error code */
+    UINT32  IndexId;                    /* Id of the handles, to be sent with MIST_PROC_SVIREAD */
+    UINT32  NbOfVars;                   /* Number of entries in Var, as NbOfNames */
+    MIST_SVI_INFO Var[MIST_SVI_MAXLIST];        /* Variables in the order of the names */
+}
+MIST_SVIFIND_R;
+
+/*
+ * Structure for SMI-call MIST_PROC_SVIREAD
+ * Only the used part of Handle needs to be sent.
+ */
+typedef struct
+{
+    UINT32  IndexId;                    /* Id of the handles, from MIST_PROC_SVIFIND */
+    UINT32  NbOfVars;                   /* Number of handles, max. MIST_SVI_MAXLIST */
+    UINT32  Handle[MIST_SVI_MAXLIST];   /* Handles from MIST_PROC_SVIFIND */
+}
+MIST_SVIREAD_C;
+
+/*
+ * Structure for SMI-Reply MIST_PROC_SVIREAD
+ * The values one after the other without padding, in the order of the
+ * handles, only Size bytes of Data are sent. RetCode = SMI_E_FAILED:
+ * the handles are not valid any more, to be resolved again.
+ */
+typedef struct
+{
+    SINT32  RetCode;                    /* OK or error code */
+    UINT32  Size;                       /* Size of the values in bytes */
+    UINT8   Data[MIST_SVI_MAXDATA];     /* Values */
+}
+MIST_SVIREAD_R;
+
+/* A variable of the call MIST_PROC_SVISUB */
+typedef struct
+{
+    UINT32  Handle;                     /* Handle from MIST_PROC_SVIFIND */
+    REAL32  Deadband;                   /* Min. change of a numeric value to be sent, 0 = every change */
+}
+MIST_SVI_SUBVAR;
+
+/*
+ * Structure for SMI-call MIST_PROC_SVISUB
+ * Only the used part of Var needs to be sent. The size of all values
+ * must not exceed MIST_SVI_MAXDATA.
+ */
+typedef struct
+{
+    UINT32  IndexId;                    /* Id of the handles, from MIST_PROC_SVIFIND */
+    UINT32  NbOfVars;                   /* Number of variables, max. MIST_SVI_MAXLIST */
+    MIST_SVI_SUBVAR Var[MIST_SVI_MAXLIST];      /* Variables */
+}
+MIST_SVISUB_C;
+
+/* Structure for SMI-Reply MIST_PROC_SVISUB */
+typedef struct
+{
+    SINT32  RetCode;                    /* OK or error code */
+    UINT32  SubId;                      /* Id of the subscription, to be sent with MIST_PROC_SVIUPDATE */
+}
+MIST_SVISUB_R;
+
+/*
+ * Structure for SMI-call MIST_PROC_SVIUPDATE
+ * The first call after the subscription returns all values.
+ */
+typedef struct
+{
+    UINT32  SubId;                      /* Id of the subscription, from MIST_PROC_SVISUB */
+    UINT32  Full;                       /* 1 = all values, e.g. after a lost reply */
+}
+MIST_SVIUPDATE_C;
+
+/*
+ * Structure for SMI-Reply MIST_PROC_SVIUPDATE
+ * The variables which have changed by more than their deadband since they
+ * were last sent, one after the other without padding: the position of the
+ * variable in the list of MIST_PROC_SVISUB (UINT32) followed by its value.
+ * Only Size bytes of Data are sent, none if nothing has changed.
+ * RetCode = SMI_E_FAILED: the subscription is not valid any more, e.g.
+ * replaced or the handles have changed, to be subscribed again.
+ */
+typedef struct
+{
+    SINT32  RetCode;                    /* OK or error code */
+    UINT32  NbOfChanged;                /* Number of variables in Data */
+    UINT32  Size;                       /* Size of Data in bytes */
+    UINT8   Data[MIST_SVI_MAXUPDATE];   /* Positions and values */
+}
+MIST_SVIUPDATE_R;
+
+/* Structure for SMI-call MIST_PROC_SVIUNSUB */
+typedef struct
+{
+    UINT32  SubId;                      /* Id of the subscription, from MIST_PROC_SVISUB */
+}
+MIST_SVIUNSUB_C;
+
+/* Structure for SMI-Reply MIST_PROC_SVIUNSUB */
+typedef struct
+{
+    SINT32  RetCode;                    /* OK or error code */
+}
+MIST_SVIUNSUB_R;
+
+
+/*--- Function prototyping ---*/
+
+
+/*--- Variable definitions ---*/
+
+
+#endif
@@ -1,1132 +1,3065 @@
-/**
-********************************************************************************
-* @file     mist_app.c
-* @author   Bachmann electronic GmbH
-* @version  $Revision: 3.90 $ $LastChangedBy: BE $
-* @date     $LastChangeDate: 2013-06-10 11:00:00 $
-*
-* @brief    This file contains the application algorithms
-*           and the application specific SVI interface.
-*
-********************************************************************************
-* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
-*******************************************************************************/
-
-/* VxWorks includes */
-#include <vxWorks.h>
-#include <taskLib.h>
-#include <tickLib.h>
-#include <intLib.h>
-#include <semLib.h>
-#include <sysLib.h>
-#include <inetLib.h>
-#include <string.h>
-#include <stdio.h>
-#include <symLib.h>
-#include <sysSymTbl.h>
-
-/* MSys includes */
-#include <mtypes.h>
-#include <msys_e.h>
-#include <mio.h>
-#include <mio_e.h>
-#include <res_e.h>
-#include <svi_e.h>
-#include <log_e.h>
-#include <prof_e.h>
-#include <lst_e.h>
-
-/* Project includes */
-#include "mist.h"
-#include "mist_e.h"
-#include "mist_int.h"
-
-/* Functions: administration, to be called from outside this file */
-SINT32  mist_AppEOI(VOID);
-VOID    mist_AppDeinit(VOID);
-SINT32  mist_CfgRead(VOID);
-SINT32  mist_SviSrvInit(VOID);
-VOID    mist_SviSrvDeinit(VOID);
-
-/* Functions: administration, to be called only from within this file */
-MLOCAL VOID mist_CfgInit(VOID);
-
-/* Functions: task administration, being called only within this file */
-MLOCAL SINT32 Task_CreateAll(VOID);
-MLOCAL VOID Task_DeleteAll(VOID);
-MLOCAL SINT32 Task_CfgRead(VOID);
-MLOCAL SINT32 Task_InitTiming(TASK_PROPERTIES * pTaskData);
-MLOCAL SINT32 Task_InitTiming_Tick(TASK_PROPERTIES * pTaskData);
-MLOCAL SINT32 Task_InitTiming_Sync(TASK_PROPERTIES * pTaskData);
-MLOCAL VOID Task_WaitCycle(TASK_PROPERTIES * pTaskData);
-
-/* Functions: worker task "Control" */
-MLOCAL VOID Control_Main(TASK_PROPERTIES * pTaskData);
-MLOCAL VOID Control_CycleInit(VOID);
-MLOCAL VOID Control_CycleStart(VOID);
-MLOCAL VOID Control_Cycle(VOID);
-MLOCAL VOID Control_CycleEnd(TASK_PROPERTIES * pTaskData);
-
-/* Global variables: data structure for mconfig parameters */
-MIST_BASE_PARMS mist_BaseParams;
-
-
-/* Global variables: miscellaneous */
-MLOCAL UINT32 CycleCount = 0;
-
-/*
- * Global variables: Settings for application task
- * A reference to these settings must be registered in TaskList[], see below.
- * If no configuration group is being specified, all values must be set properly
- * in this initialization.
- */
-MLOCAL TASK_PROPERTIES TaskProperties_aControl = {
-    "aMIST_Ctrl",                 /* unique task name, maximum length 14 */
-    "ControlTask",                      /* configuration group name */
-    Control_Main,                       /* task entry function (function pointer) */
-    0,                                  /* default task priority (->Task_CfgRead) */
-    10.0,                               /* default task cycle time in ms (->Task_CfgRead) */
-    0,                                  /* default task time base (->Task_CfgRead, 0=tick, 1=sync) */
-    5,                                  /* default ratio of watchdog time / cycle time
-                                         * (->Task_CfgRead) */
-    10000,                              /* task stack size in bytes, standard size is 10000 */
-    TRUE                                /* task uses floating point operations */
-};
-
-/*
- * Global variables: List of all application tasks
- * TaskList[] is being used for all task administration functions.
- */
-MLOCAL TASK_PROPERTIES *TaskList[] = {
-    &TaskProperties_aControl
-};
-
-/*
- * Global variables: SVI server variables list
- * The following variables will be exported to the SVI of the module.
- * Variables in SviGlobVarList will be directly accessible.
- * Those in SviVirtVarList via read/write function pointers.
- * The settings in the SviGlobVarList are:
- * Visible name of SVI variable, max. length = SVI_ADDRLEN
- * - Visible format and access rights (see defines SVI_F_xxx from svi.h)
- * - Size of variable in bytes
- * - Pointer to variable in the software project
- */
-MLOCAL SVI_GLOBVAR SviGlobVarList[] = {
-    {"CycleCounter", SVI_F_INOUT | SVI_F_UINT32, sizeof(UINT32), (UINT32 *) & CycleCount, 0, NULL,
-     NULL}
-    ,
-    {"ModuleVersion", SVI_F_OUT | SVI_F_STRING, sizeof(mist_Version),
-     (UINT32 *) mist_Version, 0, NULL, NULL}
-};
-
-/**
-********************************************************************************
-* @brief Main entry function of the aTask of the application.
-*        The input parameter is being passed by the task spawn call.
-*
-* @param[in]  pointer to task properties data structure
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID Control_Main(TASK_PROPERTIES * pTaskData)
-{
-    /* Initialization upon task entry */
-    Control_CycleInit();
-
-    /*
-     * This loop is executed endlessly
-     * as long as there is no request to quit the task
-     */
-    while (!pTaskData->Quit)
-    {
-        /* cycle start administration */
-        Control_CycleStart();
-
-        /* operational code */
-        Control_Cycle();
-
-        /* cycle end administration */
-        Control_CycleEnd(pTaskData);
-    }
-}
-
-/**
-********************************************************************************
-* @brief Administration code to be called once before first cycle start.
-*
-* @param[in]  N/A
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID Control_CycleInit(VOID)
-{
-
-    /* TODO: add what is necessary before cyclic operation starts */
-
-}
-
-/**
-********************************************************************************
-* @brief Administration code to be called once at each task cycle start.
-*
-* @param[in]  N/A
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID Control_CycleStart(VOID)
-{
-
-    /* TODO: add what is necessary at each cycle start */
-
-}
-
-/**
-********************************************************************************
-* @brief Cyclic application code.
-*
-* @param[in]  N/A
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID Control_Cycle(VOID)
-{
-
-    /* TODO: add operational code to be called in this task */
-
-    /* Increase cycle counter */
-    CycleCount++;
-
-}
-
-/**
-********************************************************************************
-* @brief Administration code to be called at each task cycle end
-*
-* @param[in]  pointer to task properties data structure
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID Control_CycleEnd(TASK_PROPERTIES * pTaskData)
-{
-
-    /* TODO: add what is to be called at each cycle end */
-
-    /*
-     * This is the very end of the cycle
-     * Delay task in order to match desired cycle time
-     */
-    Task_WaitCycle(pTaskData);
-}
-
-/**
-********************************************************************************
-* @brief Performs the second phase of the module initialization.
-* 		  Called at "End Of Init" by the bTask.
-*
-* @param[in]  N/A
-* @param[out] N/A
-*
-* @retval     = 0 .. OK
-* @retval     < 0 .. ERROR
-*******************************************************************************/
-SINT32 mist_AppEOI(VOID)
-{
-
-    /* do while(0), to be left as soon as there is an error */
-    do
-    {
-        /* TODO: set module info string, maximum length is SMI_DESCLEN_A */
-        snprintf(mist_ModuleInfoDesc, sizeof(mist_ModuleInfoDesc), "TODO: set application specific module info string");
-
-        /* TODO: add all initializations required by your application */
-
-        /* Start all application tasks listed in TaskList */
-        if (Task_CreateAll() < 0)
-            break;
-
-        /* At this point, all init actions are done successfully */
-        return (OK);
-    }
-    while (0);
-
-    /*
-     * At this point, an init action returned an error.
-     * The application code is being de-initialized.
-     */
-    mist_AppDeinit();
-    return (ERROR);
-}
-
-/**
-********************************************************************************
-* @brief Frees all resources of the application
-*        Called at De-Init of the module by the bTask.
-*        The function does not quit on an error.
-*
-* @param[in]  N/A
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-VOID mist_AppDeinit(VOID)
-{
-
-    /* TODO: Free all resources which have been allocated by the application */
-
-    /* Delete all application tasks listed in TaskList */
-    Task_DeleteAll();
-
-}
-
-/**
-********************************************************************************
-* @brief Reads the settings from configuration file mconfig
-*        for all tasks registered in TaskList[].
-*        The task name in TaskList[] is being used as configuration group name.
-*        The initialization values in TaskList[] are being used as default values.
-*        For general configuration data, mist_CfgParams is being used.
-*        Being called by mist_CfgRead.
-*        All parameters are stored in the task properties data structure.
-*        All parameters are being treated as optional.
-*        There is no limitation checking of the parameters, the limits are being
-*        specified in the cru and checked by the configurator.
-*
-* @param[in]  N/A
-* @param[out] N/A
-*
-* @retval     = 0 .. OK
-* @retval     < 0 .. ERROR
-*******************************************************************************/
-MLOCAL SINT32 Task_CfgRead(VOID)
-{
-    UINT32  idx;
-    UINT32  NbOfTasks = sizeof(TaskList) / sizeof(TASK_PROPERTIES *);
-    SINT32  ret;
-    CHAR    section[PF_KEYLEN_A];
-    CHAR    group[PF_KEYLEN_A];
-    CHAR    key[PF_KEYLEN_A];
-    SINT32  TmpVal;
-    CHAR    TmpStrg[32];
-    UINT32  Error = FALSE;
-    CHAR    Func[] = "Task_CfgRead";
-
-    /* section name is the application name, for all tasks */
-    snprintf(section, sizeof(section), mist_BaseParams.AppName);
-
-    /* For all application tasks listed in TaskList */
-    for (idx = 0; idx < NbOfTasks; idx++)
-    {
-        if (!TaskList[idx])
-        {
-            LOG_E(0, Func, "Invalid task properties pointer in task list entry #%d!", idx);
-            Error = TRUE;
-            continue;
-        }
-
-        /* group name is specified in the task properties */
-        snprintf(group, sizeof(group), TaskList[idx]->CfgGroup);
-
-        /* if no group name has been specified: skip configuration reading for this task */
-        if (strlen(group) < 1)
-        {
-            LOG_I(0, Func, "Could not find task configuration for task '%s' in mconfig ",
-                  TaskList[idx]->Name);
-            continue;
-        }
-
-        /*
-         * Read the desired value for the task cycle time.
-         * If the keyword has not been found, the initialization value remains
-         * in the task properties.
-         */
-        snprintf(key, sizeof(key), "CycleTime");
-        snprintf(TmpStrg, sizeof(TmpStrg), "%f", TaskList[idx]->CycleTime_ms);
-        ret = pf_GetStrg(section, group, key, "", (CHAR *) & TmpStrg, sizeof(TmpStrg),
-                         mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
-        /* keyword has been found */
-        if (ret >= 0)
-        {
-            *((REAL32 *) & TaskList[idx]->CycleTime_ms) = atof(TmpStrg);
-        }
-        /* keyword has not been found */
-        else
-        {
-            LOG_W(0, Func, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
-            LOG_W(0, Func, " -> using initialization value of %f ms", TaskList[idx]->CycleTime_ms);
-        }
-
-        /*
-         * Read the desired value for the task priority.
-         * If the keyword has not been found, the initialization value remains
-         * in the task properties.
-         * As an additional fall back, the priority in the base parms will be used.
-         */
-        snprintf(key, sizeof(key), "Priority");
-        ret = pf_GetInt(section, group, key, TaskList[idx]->Priority, &TmpVal,
-                        mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
-        /* keyword has been found */
-        if (ret >= 0)
-        {
-            TaskList[idx]->Priority = TmpVal;
-        }
-        /* keyword has not been found */
-        else
-        {
-            LOG_W(0, Func, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
-            if (TaskList[idx]->Priority == 0)
-            {
-                TaskList[idx]->Priority = mist_BaseParams.DefaultPriority;
-                LOG_W(0, Func, " -> using base parms value of %d", TaskList[idx]->Priority);
-            }
-            else
-                LOG_W(0, Func, " -> using initialization value of %d", TaskList[idx]->Priority);
-        }
-
-        /*
-         * Read the software watchdog time ratio.
-         * If the keyword has not been found, the initialization value remains
-         * in the task properties.
-         */
-        snprintf(key, sizeof(key), "WatchdogRatio");
-        ret = pf_GetInt(section, group, key, TaskList[idx]->WDogRatio, &TmpVal,
-                        mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
-        /* keyword has been found */
-        if (ret >= 0)
-        {
-            TaskList[idx]->WDogRatio = TmpVal;
-        }
-        /* keyword has not been found */
-        else
-        {
-            LOG_W(0, Func, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
-            LOG_W(0, Func, " -> using initialization value of %d", TaskList[idx]->WDogRatio);
-        }
-
-        /*
-         * Read the time base for the cycle time.
-         * If the keyword has not been found, the initialization value remains
-         * in the task properties.
-         */
-        snprintf(key, sizeof(key), "TimeBase");
-        ret = pf_GetInt(section, group, key, TaskList[idx]->TimeBase, &TmpVal,
-                        mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
-        /* keyword has been found */
-        if (ret >= 0)
-        {
-            TaskList[idx]->TimeBase = TmpVal;
-        }
-        /* keyword has not been found */
-        else
-        {
-            LOG_W(0, Func, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
-            LOG_W(0, Func, " -> using initialization value of %d", TaskList[idx]->TimeBase);
-        }
-    }
-
-    /* Evaluate overall error flag */
-    if (Error)
-        return (ERROR);
-    else
-        return (OK);
-}
-
-/**
-********************************************************************************
-* @brief Starts all tasks which are registered in the global task list
-*        - task watchdog is being created if specified
-*        - priority is being checked and corrected if necessary
-*        - semaphore for cycle timing is being created
-*        - sync session is being started if necessary
-*        - sync ISR is being attached if necessary
-*        If there is an error creating a task, no further tasks will be started.
-*
-* @param[in]  N/A
-* @param[out] N/A
-*
-* @retval     = 0 .. OK
-* @retval     < 0 .. ERROR
-*******************************************************************************/
-MLOCAL SINT32 Task_CreateAll(VOID)
-{
-    UINT32  idx;
-    UINT8   TaskName[M_TSKNAMELEN_A];
-    UINT32  NbOfTasks = sizeof(TaskList) / sizeof(TASK_PROPERTIES *);
-    UINT32  TaskOptions;
-    UINT32  wdogtime_us;
-    CHAR    Func[] = "Task_CreateAll";
-
-    /* For all application tasks listed in TaskList */
-    for (idx = 0; idx < NbOfTasks; idx++)
-    {
-        if (!TaskList[idx])
-        {
-            LOG_E(0, Func, "Invalid task properties pointer!");
-            return (ERROR);
-        }
-
-        /* Initialize what is necessary */
-        TaskList[idx]->SyncSessionId = ERROR;
-        TaskList[idx]->TaskId = ERROR;
-        TaskList[idx]->WdogId = 0;
-        TaskList[idx]->Quit = FALSE;
-
-        /* Create software watchdog if required */
-        if (TaskList[idx]->WDogRatio > 0)
-        {
-            /* check watchdog ratio, minimum useful value is 2 */
-            if (TaskList[idx]->WDogRatio < 3)
-            {
-                TaskList[idx]->WDogRatio = 3;
-                LOG_W(0, Func, "Watchdog ratio increased to 3!");
-            }
-
-            wdogtime_us = (TaskList[idx]->CycleTime_ms * 1000) * TaskList[idx]->WDogRatio;
-            TaskList[idx]->WdogId = sys_WdogCreate(mist_AppName, wdogtime_us);
-            if (TaskList[idx]->WdogId == 0)
-            {
-                LOG_E(0, Func, "Could not create watchdog!");
-                return (ERROR);
-            }
-        }
-
-        /* Create binary semaphore for cycle timing */
-        TaskList[idx]->CycleSema = semBCreate(SEM_Q_PRIORITY, SEM_EMPTY);
-        if (!TaskList[idx]->CycleSema)
-        {
-            LOG_E(0, Func, "Could not create cycle timing semaphore for task '%s'!",
-                  TaskList[idx]->Name);
-            return (ERROR);
-        }
-
-        /* Initialize task cycle timing infrastructure */
-        Task_InitTiming(TaskList[idx]);
-
-        /* In case the priority has not been properly set */
-        if (TaskList[idx]->Priority == 0)
-        {
-            LOG_E(0, Func, "Invalid priority for task '%s'", TaskList[idx]->Name);
-            return (ERROR);
-        }
-
-        /* make sure task name string is terminated */
-        TaskList[idx]->Name[M_TSKNAMELEN_A - 2] = 0;
-
-        /* If no task name has been set: use application name and index */
-        if (strlen(TaskList[idx]->Name) < 1)
-            snprintf(TaskList[idx]->Name, sizeof(TaskList[idx]->Name), "a%s_%d", mist_AppName, idx + 1);
-
-        snprintf(TaskName, sizeof(TaskList[idx]->Name), "%s", TaskList[idx]->Name);
-
-        /* Task options */
-        TaskOptions = 0;
-        if (TaskList[idx]->UseFPU)
-            TaskOptions |= VX_FP_TASK;
-
-        /* Spawn task with properties set in task list */
-        TaskList[idx]->TaskId = sys_TaskSpawn(mist_AppName, TaskName,
-                                              TaskList[idx]->Priority, TaskOptions,
-                                              TaskList[idx]->StackSize,
-                                              (FUNCPTR) TaskList[idx]->pMainFunc, TaskList[idx]);
-
-        /* Check if task has been created successfully */
-        if (TaskList[idx]->TaskId == ERROR)
-        {
-            LOG_E(0, Func, "Error in sys_TaskSpawn for task '%s'!", TaskName);
-            return (ERROR);
-        }
-    }
-
-    /* At this point, all tasks have been started successfully */
-    return (OK);
-}
-
-/**
-********************************************************************************
-* @brief Deletes all tasks which are registered in the global task list
-*        Undo for all operations in Task_CreateAll
-*        The function will not be left upon an error.
-*
-* @param[in]  N/A
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID Task_DeleteAll(VOID)
-{
-    UINT32  idx;
-    UINT32  NbOfTasks = sizeof(TaskList) / sizeof(TASK_PROPERTIES *);
-    UINT32  RequestTime;
-    CHAR    Func[] = "Task_DeleteAll";
-
-    /*
-     * Delete software watchdog if present
-     * This must be done first, because tasks will end their cyclic operation
-     * and thus won't trigger their watchdogs any more.
-     */
-    for (idx = 0; idx < NbOfTasks; idx++)
-    {
-        if (TaskList[idx]->WdogId)
-            sys_WdogDelete(TaskList[idx]->WdogId);
-    }
-
-    /*
-     * Set quit request for all existing tasks
-     * This should make tasks complete their cycle and quit operation.
-     */
-    for (idx = 0; idx < NbOfTasks; idx++)
-        TaskList[idx]->Quit = TRUE;
-
-    /*
-     * Give all cycle semaphores of listed tasks
-     * This wakes up all tasks and thus speeds up the completion.
-     */
-    for (idx = 0; idx < NbOfTasks; idx++)
-    {
-        if (TaskList[idx]->CycleSema)
-            semGive(TaskList[idx]->CycleSema);
-    }
-
-    /* Take a time stamp for the timeout check */
-    RequestTime = m_GetProcTime();
-
-    /*
-     * Wait for all tasks to quit their cycle.
-     * Apply a timeout of 500ms
-     * Wait one tick in case of missing task quit
-     */
-    do
-    {
-        UINT32  AllTasksQuitted = TRUE;
-
-        /* allow one tick for tasks to complete */
-        taskDelay(1);
-
-        /* Check if all tasks have terminated their cycles */
-        for (idx = 0; idx < NbOfTasks; idx++)
-            AllTasksQuitted &= (taskIdVerify(TaskList[idx]->TaskId) == ERROR);
-
-        /* If all tasks have terminated themselves */
-        if (AllTasksQuitted)
-        {
-            if (mist_BaseParams.DebugMode & APP_DBG_INFO1)
-                LOG_I(0, Func, "All tasks have terminated by themselves");
-            break;
-        }
-        /* If timeout waiting for task self termination is over */
-        else if ((m_GetProcTime() - RequestTime) > 500000)
-        {
-            LOG_W(0, Func, "Timeout at waiting for tasks to terminate by themselves");
-            break;
-        }
-    }
-    while (TRUE);
-
-    /* Cleanup resources and delete all remaining tasks */
-    for (idx = 0; idx < NbOfTasks; idx++)
-    {
-        /* Stop sync session if present and detach ISR */
-        if (TaskList[idx]->SyncSessionId >= 0)
-        {
-            LOG_I(0, Func, "Stopping sync session for task %s", TaskList[idx]->Name);
-            mio_StopSyncSession(TaskList[idx]->SyncSessionId);
-        }
-
-        /* Delete semaphore for cycle timing */
-        if (TaskList[idx]->CycleSema)
-        {
-            if (semDelete(TaskList[idx]->CycleSema) < 0)
-                LOG_W(0, Func, "Could not delete cycle semaphore of task %s!", TaskList[idx]->Name);
-            else
-            	TaskList[idx]->CycleSema = 0;
-        }
-
-        /* Remove application tasks which still exist */
-        if (taskIdVerify(TaskList[idx]->TaskId) == OK)
-        {
-            if (taskDelete(TaskList[idx]->TaskId) == ERROR)
-                LOG_E(0, Func, "Could not delete task %s!", TaskList[idx]->Name);
-            else
-                LOG_W(0, Func, "Task %s had to be deleted!", TaskList[idx]->Name);
-
-            TaskList[idx]->TaskId = ERROR;
-        }
-    }
-}
-
-/**
-********************************************************************************
-* @brief Initializes infrastructure for task timing
-*
-* @param[in]  pointer to task properties data structure
-* @param[out] N/A
-*
-* @retval     = 0 .. OK
-* @retval     < 0 .. ERROR
-*******************************************************************************/
-MLOCAL SINT32 Task_InitTiming(TASK_PROPERTIES * pTaskData)
-{
-    CHAR    Func[] = "Task_InitTiming";
-
-    if (!pTaskData)
-    {
-        LOG_E(0, Func, "Invalid input pointer!");
-        return (ERROR);
-    }
-
-    /* independent of timing model */
-    pTaskData->NbOfCycleBacklogs = 0;
-    pTaskData->NbOfSkippedCycles = 0;
-
-    /* depending on timing model */
-    switch (pTaskData->TimeBase)
-    {
-            /* Tick based timing */
-        case 0:
-            return (Task_InitTiming_Tick(pTaskData));
-            /* Sync based timing */
-        case 1:
-            pTaskData->SyncSessionId = ERROR;
-            return (Task_InitTiming_Sync(pTaskData));
-            /* Undefined */
-        default:
-            LOG_E(0, Func, "Unknown timing model!");
-            return (ERROR);
-    }
-}
-
-/**
-********************************************************************************
-* @brief Initializes infrastructure for task timing with tick timer
-*
-* @param[in]  pointer to task properties data structure
-* @param[out] N/A
-*
-* @retval     = 0 .. OK
-* @retval     < 0 .. ERROR
-*******************************************************************************/
-MLOCAL SINT32 Task_InitTiming_Tick(TASK_PROPERTIES * pTaskData)
-{
-    REAL32  TmpReal;
-    CHAR    Func[] = "Task_InitTiming_Tick";
-
-    if (!pTaskData)
-    {
-        LOG_E(0, Func, "Invalid input pointer!");
-        return (ERROR);
-    }
-
-    /*
-     * Calculate and check cycle time in ticks as integer value
-     */
-    TmpReal = ((pTaskData->CycleTime_ms / 1000.0) * sysClkRateGet()) + 0.5;
-    pTaskData->CycleTime = (UINT32) TmpReal;
-
-    /* If cycle time is less than a full tick */
-    if (pTaskData->CycleTime < 1)
-    {
-        pTaskData->CycleTime = 1;
-        LOG_W(0, Func, "Cycle time too small for tick rate %d, increased to 1 tick!",
-              sysClkRateGet());
-    }
-
-    /* Take first cycle start time stamp */
-    pTaskData->PrevCycleStart = tickGet();
-
-    /* Initialize cycle time grid */
-    pTaskData->NextCycleStart = tickGet() + pTaskData->CycleTime;
-
-    return (OK);
-}
-
-/**
-********************************************************************************
-* @brief Initializes infrastructure for task timing with sync event.
-*
-* @param[in]  pointer to task properties data structure
-* @param[out] N/A
-*
-* @retval     = 0 .. OK
-* @retval     < 0 .. Error
-*******************************************************************************/
-MLOCAL SINT32 Task_InitTiming_Sync(TASK_PROPERTIES * pTaskData)
-{
-    SINT32  ret;
-    REAL32  SyncCycle_us, TmpReal;
-    SYS_CPUINFO CpuInfo;
-    CHAR    Func[] = "Task_InitTiming_Sync";
-
-    if (!pTaskData)
-    {
-        LOG_E(0, Func, "Invalid input pointer!");
-        return (ERROR);
-    }
-
-    /* Start sync session for this module (multiple starts are possible) */
-    pTaskData->SyncSessionId = mio_StartSyncSession(mist_AppName);
-    if (pTaskData->SyncSessionId < 0)
-    {
-        LOG_E(0, Func, "Could not start sync session for task '%s'!", pTaskData->Name);
-        return (ERROR);
-    }
-
-    /* Get cpu info, contains sync timer settings (always returns OK) */
-    sys_GetCpuInfo(&CpuInfo);
-
-    /* Calculate and check period time of sync timer */
-    SyncCycle_us = CpuInfo.pExtCpuInfo->SyncHigh + CpuInfo.pExtCpuInfo->SyncLow;
-    if ((SyncCycle_us == 0) || (CpuInfo.pExtCpuInfo->SyncHigh == 0)
-        || (CpuInfo.pExtCpuInfo->SyncLow == 0))
-    {
-        LOG_E(0, Func, "System sync configuration invalid, can't use sync for task '%s'!",
-              pTaskData->Name);
-        return (ERROR);
-    }
-
-    /* Calculate multiple of specified task cycle time */
-    TmpReal = ((pTaskData->CycleTime_ms * 1000) / SyncCycle_us) + 0.5;
-    pTaskData->CycleTime = TmpReal;
-
-    /* If cycle time is less than a full sync */
-    if (pTaskData->CycleTime < 1)
-    {
-        pTaskData->CycleTime = 1;
-        LOG_W(0, Func, "Cycle time too small for sync cycle %d us, increased to 1 sync!",
-              SyncCycle_us);
-    }
-
-    /*
-     * For application tasks,
-     * MIO_SYNC_IN (falling edge of sync signal) is the normal option.
-     */
-    pTaskData->SyncEdge = MIO_SYNC_IN;
-
-    /*
-     * Attach semGive to sync event
-     * -> semGive will be called according to the sync attach settings below.
-     * -> semGive will give the semaphore pTaskData->CycleSema.
-     * -> the task will be triggered as soon as this semaphore is given.
-     */
-    ret = mio_AttachSync(pTaskData->SyncSessionId,      /* from mio_StartSyncSession */
-                         pTaskData->SyncEdge,   /* selection of sync edge */
-                         pTaskData->CycleTime,  /* number of sync cycles */
-                         (VOID *) semGive,      /* register semGive as ISR */
-                         (UINT32) pTaskData->CycleSema);        /* semaphore id for semGive */
-    if (ret < 0)
-    {
-        LOG_W(0, Func, "Could not attach to sync for task '%s'!", pTaskData->Name);
-        if (pTaskData->SyncSessionId >= 0)
-        	mio_StopSyncSession(pTaskData->SyncSessionId);
-        pTaskData->SyncSessionId = ERROR;
-        return (ERROR);
-    }
-
-    return (OK);
-}
-
-/**
-********************************************************************************
-* @brief Performs the necessary wait time for the specified cycle.
-*        The wait time results from cycle time minus own run time.
-*        NOTE: The time unit depends on the used time base (ticks or sync periods).
-*
-* @param[in]  pointer to task properties data structure
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID Task_WaitCycle(TASK_PROPERTIES * pTaskData)
-{
-    UINT32  PrevCycleStart = 0;
-    UINT32  NextCycleStart = 0;
-    UINT32  CycleTime = 0;
-    UINT32  TimeToWait = 0;
-    UINT32  SkipNow = 0;
-    UINT32  TimeNow = 0;
-    UINT32  Backlog = 0;
-    UINT32  MaxBacklog = 0;
-    UINT32  CyclesSkipped = 0;
-
-    /* Emergency behavior in case of missing task settings */
-    if (!pTaskData)
-    {
-        LOG_E(0, "Task_WaitCycle", "Invalid input pointer, using alternative taskDelay(1000)");
-        taskDelay(1000);
-        return;
-    }
-
-    /* Trigger software watchdog if existing */
-    if (pTaskData->WdogId)
-        sys_WdogTrigg(pTaskData->WdogId);
-
-    /*
-     * Handle tick based cycle timing ("Time" unit is ticks)
-     */
-    if (pTaskData->TimeBase == 0)
-    {
-        /* Use local variables to make calculation as compressed as possible */
-        PrevCycleStart = pTaskData->PrevCycleStart;
-        NextCycleStart = pTaskData->NextCycleStart;
-        CycleTime = pTaskData->CycleTime;
-        MaxBacklog = CycleTime * 2;
-
-        /* Calculate the time to wait before the next cycle can start. */
-        NextCycleStart = PrevCycleStart + CycleTime;
-        PrevCycleStart = NextCycleStart;
-
-        /*
-         * As soon as the current time stamp has been taken,
-         * the code until semTake processing should be kept as short as possible,
-         * so that the probability of being interrupted is as small as possible.
-         */
-        TimeNow = tickGet();
-
-        /* This is the amount of until the next scheduled cycle start. */
-        TimeToWait = NextCycleStart - TimeNow;
-
-        /* Limit wait time to minimum 1 */
-        if (!TimeToWait)
-            TimeToWait++;
-
-        /*
-         * As long as the next scheduled cycle start lies in the future,
-         * the resulting wait time must be smaller than the cycle time.
-         * If the resulting wait time is higher than the cycle time,
-         * the next scheduled cycle start already lies in the past.
-         * This means that there is a cycle backlog.
-         * NOTE: since the wait time is an unsigned value, a negative difference
-         * is being interpreted as a large positive value.
-         */
-        if (TimeToWait > CycleTime)
-        {
-            /* Calculate cycle backlog */
-            Backlog = TimeNow - NextCycleStart;
-
-            /* As long as the backlog is below the limit */
-            if (Backlog <= MaxBacklog)
-            {
-                /* Try to catch, but still use a small task delay */
-                TimeToWait = 1;
-            }
-            /* If the backlog is beyond the limit */
-            else
-            {
-                /* Skip the backlog and recalculate next cycle start */
-                SkipNow = (Backlog / CycleTime) + 1;
-                NextCycleStart = NextCycleStart + (SkipNow * CycleTime);
-                PrevCycleStart = NextCycleStart;
-                TimeToWait = NextCycleStart - TimeNow;
-                CyclesSkipped += SkipNow;
-            }
-        }
-    }
-
-    /*
-     * Handle sync based cycle timing ("Time" unit is syncs)
-     */
-    else if (pTaskData->TimeBase == 1)
-    {
-        /*
-         * In case of sync timing, it is assumed, that the sync interrupt
-         * directly determines the cycle time.
-         * It would also be possible to use a multiple of sync's as cycle time.
-         * The logic necessary for that is not yet implemented.
-         */
-        TimeToWait = WAIT_FOREVER;
-    }
-
-    /* Register cycle end in system timing statistics */
-    sys_CycleEnd();
-
-    /*
-     * Wait for the calculated number of time units
-     * by taking the cycle semaphore with a calculated timeout
-     */
-    semTake(pTaskData->CycleSema, TimeToWait);
-
-    /*
-     * Waiting for the cycle semaphore has now timed out in case of tick
-     * or been given in case of sync.
-     */
-
-    /* Register cycle start in system timing statistics */
-    sys_CycleStart();
-
-    /*
-     * The above logic uses local variables in order to keep the processing short.
-     * Some of these local variables must be rescued for the next call of this
-     * function.
-     */
-    pTaskData->PrevCycleStart = PrevCycleStart;
-    pTaskData->NextCycleStart = NextCycleStart;
-    pTaskData->NbOfSkippedCycles += CyclesSkipped;
-    if (Backlog)
-        pTaskData->NbOfCycleBacklogs++;
-
-    /*
-     * Consideration of software module state
-     * If the module is in stop or eoi state,
-     * all cyclic tasks of this module shall be stopped.
-     * If the software module receives the RpcStart call,
-     * it will give the state semaphore, and all tasks will continue.
-     */
-    if ((mist_ModState == RES_S_STOP) || (mist_ModState == RES_S_EOI))
-    {
-        /* Disable software watchdog if present */
-        if (pTaskData->WdogId)
-            sys_WdogDisable(pTaskData->WdogId);
-
-        LOG_I(0, "Task_WaitCycle", "Stopping task '%s' due to module stop", pTaskData->Name);
-
-        /*
-         * semaphore will be given by SMI server with calls
-         * RpcStart or RpcEndOfInit
-         */
-        semTake(mist_StateSema, WAIT_FOREVER);
-    }
-}
-
-/**
-********************************************************************************
-* @brief Initializes the module configuration data structure
-*        with the values obtained in the module init.
-*
-* @param[in]  N/A
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID mist_CfgInit(VOID)
-{
-    /* Configuration file name (profile name) */
-    strncpy(mist_BaseParams.CfgFileName, mist_ProfileName, M_PATHLEN);
-
-    /* Application name */
-    strncpy(mist_BaseParams.AppName, mist_AppName, M_MODNAMELEN);
-
-    /* Line number in configuration file (used as start line for searching) */
-    mist_BaseParams.CfgLine = mist_CfgLine;
-
-    /* Worker task priority from module base parameters (BaseParms) */
-    mist_BaseParams.DefaultPriority = mist_AppPrio;
-
-    /* Debug mode from module base parameters (BaseParms) */
-    mist_BaseParams.DebugMode = mist_Debug;
-
-}
-
-/**
-********************************************************************************
-* @brief Calls all configuration read functions of the application
-*        Being called at module init by the bTask.
-*
-* @param[in]  N/A
-* @param[out] N/A
-*
-* @retval     = 0 .. OK
-* @retval     < 0 .. ERROR
-*******************************************************************************/
-SINT32 mist_CfgRead(VOID)
-{
-    SINT32  ret;
-
-    /* Initialize configuration with values taken at module init */
-    mist_CfgInit();
-
-    /* Read all task configuration settings from mconfig.ini */
-    ret = Task_CfgRead();
-    if (ret < 0)
-        return ret;
-
-    /*
-     * TODO:
-     * Call other specific configuration read functions here
-     */
-
-    return (OK);
-}
-
-/**
-********************************************************************************
-* @brief Initializes the SVI-Interface.
-*        Being called at module init by the bTask.
-*
-* @param[in]  N/A
-* @param[out] N/A
-*
-* @retval     = 0 .. OK
-* @retval     < 0 .. ERROR
-*******************************************************************************/
-SINT32 mist_SviSrvInit(VOID)
-{
-    SINT32  ret;
-    UINT32  NbOfGlobVars = sizeof(SviGlobVarList) / sizeof(SVI_GLOBVAR);
-    UINT32  i;
-    CHAR    Func[] = "mist_SviSrvInit";
-
-    /* If there are any SVI variables to be exported */
-    if (NbOfGlobVars)
-    {
-        /* Initialize SVI-handler */
-        mist_SviHandle = svi_Init(mist_AppName, 0, 0);
-        if (!mist_SviHandle)
-        {
-            LOG_E(0, Func, "Could not initialize SVI server handle!");
-            return (ERROR);
-        }
-    }
-    else
-    {
-        mist_SviHandle = 0;
-        return (OK);
-    }
-
-    /* Add the global variables from the list SviGlobVarList */
-    for (i = 0; i < NbOfGlobVars; i++)
-    {
-        ret = svi_AddGlobVar(mist_SviHandle, SviGlobVarList[i].VarName,
-                             SviGlobVarList[i].Format, SviGlobVarList[i].Size,
-                             SviGlobVarList[i].pVar, 0, SviGlobVarList[i].UserParam,
-                             SviGlobVarList[i].pSviStart, SviGlobVarList[i].pSviEnd);
-        if (ret)
-        {
-            LOG_E(0, Func, "Could not add SVI variable '%s'!, Error %d",
-                  SviGlobVarList[i].VarName, ret);
-            /*
-             * TODO:
-             * Decide if the module shall be de-installed in this case.
-             * If yes, return an error here.
-             */
-        }
-    }
-
-    return (OK);
-}
-
-/**
-********************************************************************************
-* @brief Frees SVI server resources according to mist_SviSrvInit()
-*        Being called at module deinit by the bTask.
-*
-* @param[in]  N/A
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-VOID mist_SviSrvDeinit(VOID)
-{
-    /* If there was no or no successful SVI init */
-    if (!mist_SviHandle)
-        return;
-
-    if (svi_DeInit(mist_SviHandle) < 0)
-        LOG_E(0, "mist_SviSrvDeinit", "Could not de-initialize SVI server");
-
-    mist_SviHandle = 0;
-}
-
+/**
+********************************************************************************
+* @file     mist_app.c
+* @author   Bachmann electronic GmbH
+* @version  $Revision: 3.90 $ $LastChangedBy: BE $
+* @date     $LastChangeDate: 2013-06-10 11:00:00 $
+*
+* @brief    This file contains the application algorithms
+*           and the application specific SVI interface.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
+*******************************************************************************/
+
+#if defined(__linux__)
+#define _GNU_SOURCE                     /* pthread_setaffinity_np */
+#endif
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <taskLib.h>
+#include <tickLib.h>
+#include <intLib.h>
+#include <semLib.h>
+#include <sysLib.h>
+#include <inetLib.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <symLib.h>
+#include <sysSymTbl.h>
+#include <time.h>
+#if defined(__linux__)
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#elif defined(_WRS_CONFIG_SMP)
+#include <vxCpuLib.h>
+#endif
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <mio.h>
+#include <mio_e.h>
+#include <res_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <prof_e.h>
+#include <lst_e.h>
+
+/* Project includes */
+#include "mist.h"
+#include "mist_e.h"
+#include "mist_int.h"
+#include "mist_prg.h"
+#include "mist_vm.h"
+
+/* Functions: administration, to be called from outside this file */
+SINT32  mist_AppEOI(VOID);
+VOID    mist_AppDeinit(VOID);
+SINT32  mist_AppOnlineChange(VOID);
+SINT32  mist_CfgRead(VOID);
+SINT32  mist_SviSrvInit(VOID);
+VOID    mist_SviSrvDeinit(VOID);
+
+/* Functions: administration, to be called only from within this file */
+MLOCAL VOID mist_CfgInit(VOID);
+
+/* Functions: task administration, being called only within this file */
+MLOCAL SINT32 Task_CreateAll(VOID);
+MLOCAL VOID Task_DeleteAll(VOID);
+MLOCAL SINT32 Task_CfgRead(TASK_PROPERTIES * const *pList);
+MLOCAL UINT32 Task_CfgMask(VOID);
+MLOCAL VOID Task_ListBuild(UINT32 Mask);
+MLOCAL VOID Task_SviAddAll(VOID);
+MLOCAL VOID Task_SviExport(TASK_PROPERTIES * pTaskData, MIST_VM * pVm);
+MLOCAL SINT32 Task_SviStart(SVI_VAR * pVar, UINT32 UserParam);
+MLOCAL VOID Task_SviEnd(SVI_VAR * pVar, UINT32 UserParam);
+MLOCAL SINT32 Task_PrgLoadAll(VOID);
+MLOCAL VOID Task_PrgFreeAll(VOID);
+MLOCAL VOID Task_PrgRetire(TASK_PROPERTIES * pTaskData);
+MLOCAL VOID Task_PrgSwap(TASK_PROPERTIES * pTaskData);
+MLOCAL UINT32 Task_NbOfCores(VOID);
+MLOCAL VOID Task_SetAffinity(TASK_PROPERTIES * pTaskData);
+MLOCAL SINT32 Task_InitTiming(TASK_PROPERTIES * pTaskData);
+MLOCAL SINT32 Task_InitTiming_Tick(TASK_PROPERTIES * pTaskData);
+MLOCAL SINT32 Task_InitTiming_Sync(TASK_PROPERTIES * pTaskData);
+MLOCAL SINT32 Task_InitTiming_HighRes(TASK_PROPERTIES * pTaskData);
+MLOCAL VOID Task_ExitTiming(TASK_PROPERTIES * pTaskData);
+MLOCAL VOID Task_WaitCycle(TASK_PROPERTIES * pTaskData);
+#if defined(__linux__)
+MLOCAL UINT64 Task_HrNow(VOID);
+#else
+MLOCAL VOID Task_HrIsr(int Arg);
+#endif
+MLOCAL UINT32 Task_Overrun(TASK_PROPERTIES * pTaskData, UINT32 Late, UINT32 * pSkip);
+MLOCAL VOID Task_PhaseReset(TASK_PROPERTIES * pTaskData);
+MLOCAL VOID Task_StatsEnd(TASK_PROPERTIES * pTaskData);
+MLOCAL VOID Task_StatsStart(TASK_PROPERTIES * pTaskData);
+MLOCAL MIST_IMAGE *Task_ImgFind(const CHAR * pTaskName);
+
+/* Functions: worker task "Control" */
+MLOCAL VOID Control_Main(TASK_PROPERTIES * pTaskData);
+MLOCAL VOID Control_CycleInit(VOID);
+MLOCAL VOID Control_CycleStart(TASK_PROPERTIES * pTaskData);
+MLOCAL VOID Control_Cycle(TASK_PROPERTIES * pTaskData);
+MLOCAL VOID Control_CycleEnd(TASK_PROPERTIES * pTaskData);
+
+/* Functions: timing benchmark task, see mist_TimingBench() */
+MLOCAL VOID Bench_Main(TASK_PROPERTIES * pTaskData);
+
+/* Functions: test functions, to be called from the shell */
+SINT32  mist_TimingBench(UINT32 CycleTime_us, UINT32 Cycles);
+VOID    mist_EvtShow(UINT32 FirstSeq);
+VOID    mist_SchedShow(VOID);
+VOID    mist_ImgShow(CHAR * pTaskName, CHAR * pVarName);
+SINT32  mist_TrcDump(CHAR * pFileName);
+
+/* Global variables: data structure for mconfig parameters */
+MIST_BASE_PARMS mist_BaseParams;
+
+
+/* Global variables: miscellaneous */
+MLOCAL UINT32 CycleCount = 0;
+
+/*
+ * Global variables: high resolution timer (TimeBase 2)
+ * The auxiliary clock is shared by all tasks using it. The first task sets
+ * its rate, the cycle times of the tasks are multiples of its period.
+ */
+#if !defined(__linux__)
+MLOCAL UINT32 HrRate = 0;                   /* rate of the timer in Hz, 0 = not running */
+#endif
+MLOCAL TASK_PROPERTIES *HrTaskList[TASK_HR_MAX];
+MLOCAL UINT32 NbOfHrTasks = 0;
+
+/*
+ * Global variables: overrun events of all tasks, see Task_Overrun()
+ * The tasks write without a lock, each one reserves its entry by
+ * incrementing EvtHead. An entry is complete when its Seq is set.
+ */
+MLOCAL MIST_EVENT EvtRing[TASK_EVT_RING];
+MLOCAL UINT32 EvtHead = 0;                  /* number of events written so far */
+
+/* Global variables: number of cycles of the timing benchmark task */
+MLOCAL UINT32 BenchCycles = 0;
+
+/*
+ * Global variables: Default settings of the application tasks
+ * Every configuration group ControlTask, ControlTask2 .. ControlTask<TASK_MAX>
+ * found in mconfig starts a task with these settings, see Task_ListBuild().
+ * The number of the group is appended to the task and group name.
+ * If no configuration group is being specified, all values must be set properly
+ * in this initialization.
+ */
+MLOCAL const TASK_PROPERTIES TaskDefaults = {
+    "aMIST_Ctrl",                 /* unique task name, maximum length 12 */
+    "ControlTask",                      /* configuration group name */
+    Control_Main,                       /* task entry function (function pointer) */
+    0,                                  /* default task priority (->Task_CfgRead) */
+    10.0,                               /* default task cycle time in ms (->Task_CfgRead) */
+    0,                                  /* default task time base (->Task_CfgRead, 0=tick, 1=sync,
+                                         * 2=high resolution timer) */
+    5,                                  /* default ratio of watchdog time / cycle time
+                                         * (->Task_CfgRead) */
+    10000,                              /* task stack size in bytes, standard size is 10000 */
+    TRUE,                               /* task uses floating point operations */
+    "",                                 /* ST program executed in each cycle (->Task_CfgRead) */
+    MIST_VM_BUDGET,                     /* max. loop iterations of the ST program per cycle
+                                         * (->Task_CfgRead) */
+    0,                                  /* execution of the ST program (->Task_CfgRead, 0=VM,
+                                         * 1=generated C code) */
+    MIST_OVR_CATCHUP,                   /* handling of a cycle backlog (->Task_CfgRead) */
+    2,                                  /* max. backlog in cycles which is caught up (->Task_CfgRead) */
+    0,                                  /* worst case execution time in us, 0 = measured
+                                         * (->Task_CfgRead, mist_SchedCheck) */
+    -1,                                 /* CPU core, -1 = any core or set by the partitioner
+                                         * (->Task_CfgRead, mist_SchedPartition) */
+    0,                                  /* additional worker tasks executing independent parts
+                                         * of the ST program in parallel (->Task_CfgRead) */
+    MIST_SVIEXP_ATTR                    /* export of the ST program variables to the SVI
+                                         * (->Task_CfgRead, mist_SviExport) */
+};
+
+/*
+ * Global variables: List of all application tasks
+ * TaskList[] is being used for all task administration functions.
+ * It is built from the configuration while no task is running.
+ * The settings of group n are kept in TaskPool[n - 1], so the SVI variables
+ * of a task remain valid when the list is built again (TaskSviMask).
+ */
+MLOCAL TASK_PROPERTIES TaskPool[TASK_MAX];
+MLOCAL TASK_PROPERTIES *TaskList[TASK_MAX];
+MLOCAL UINT32 NbOfTasks = 0;
+MLOCAL UINT32 TaskMask = 0;                 /* groups in TaskList, bit n - 1 = group n */
+MLOCAL UINT32 TaskSviMask = 0;              /* groups with SVI variables */
+MLOCAL SEM_ID TaskSviSema = NULL;           /* SviSnap of all tasks, taken by the SVI readers only */
+
+/*
+ * Global variables: SVI server variables list
+ * The following variables will be exported to the SVI of the module.
+ * Variables in SviGlobVarList will be directly accessible.
+ * Those in SviVirtVarList via read/write function pointers.
+ * The settings in the SviGlobVarList are:
+ * Visible name of SVI variable, max. length = SVI_ADDRLEN
+ * - Visible format and access rights (see defines SVI_F_xxx from svi.h)
+ * - Size of variable in bytes
+ * - Pointer to variable in the software project
+ */
+MLOCAL SVI_GLOBVAR SviGlobVarList[] = {
+    {"CycleCounter", SVI_F_INOUT | SVI_F_UINT32, sizeof(UINT32), (UINT32 *) & CycleCount, 0, NULL,
+     NULL}
+    ,
+    {"ModuleVersion", SVI_F_OUT | SVI_F_STRING, sizeof(mist_Version),
+     (UINT32 *) mist_Version, 0, NULL, NULL}
+};
+
+/*
+ * Global variables: SVI server variables of each task
+ * The following variables are exported for every task in TaskList[],
+ * prefixed with the configuration group (or task name) of the task,
+ * e.g. "ControlTask/ExecMax". The cycle statistics are written by the task
+ * only, see TASK_STATS. Writing StatsReset restarts them.
+ * The variables with Task_SviStart() are a consistency group: they are read
+ * from the copy SviSnap, taken at the start of a read without blocking the
+ * task. A list read (MIST_PROC_SVIREAD) of consecutive variables of the group
+ * takes one copy for all of them, i.e. values of the same cycle.
+ */
+MLOCAL SVI_TASKVAR SviTaskVarList[] = {
+    {"ExecTime", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32), offsetof(TASK_PROPERTIES, SviSnap.Stats.ExecTime),
+     Task_SviStart, Task_SviEnd},
+    {"ExecMin", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32), offsetof(TASK_PROPERTIES, SviSnap.Stats.ExecMin),
+     Task_SviStart, Task_SviEnd},
+    {"ExecMax", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32), offsetof(TASK_PROPERTIES, SviSnap.Stats.ExecMax),
+     Task_SviStart, Task_SviEnd},
+    {"ExecMean", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32), offsetof(TASK_PROPERTIES, SviSnap.Stats.ExecMean),
+     Task_SviStart, Task_SviEnd},
+    {"ExecHistogram", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32) * TASK_HIST_BUCKETS,
+     offsetof(TASK_PROPERTIES, SviSnap.Stats.Hist), Task_SviStart, Task_SviEnd},
+    {"Jitter", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32), offsetof(TASK_PROPERTIES, SviSnap.Stats.Jitter),
+     Task_SviStart, Task_SviEnd},
+    {"JitterMax", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32), offsetof(TASK_PROPERTIES, SviSnap.Stats.JitterMax),
+     Task_SviStart, Task_SviEnd},
+    {"JitterMean", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32), offsetof(TASK_PROPERTIES, SviSnap.Stats.JitterMean),
+     Task_SviStart, Task_SviEnd},
+    {"Period", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32), offsetof(TASK_PROPERTIES, SviSnap.Stats.Period),
+     Task_SviStart, Task_SviEnd},
+    {"Cycles", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32), offsetof(TASK_PROPERTIES, SviSnap.Stats.NbOfCycles),
+     Task_SviStart, Task_SviEnd},
+    {"CycleBacklogs", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32), offsetof(TASK_PROPERTIES, SviSnap.NbOfCycleBacklogs),
+     Task_SviStart, Task_SviEnd},
+    {"SkippedCycles", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32), offsetof(TASK_PROPERTIES, SviSnap.NbOfSkippedCycles),
+     Task_SviStart, Task_SviEnd},
+    {"Aborted", SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32), offsetof(TASK_PROPERTIES, SviSnap.Aborted),
+     Task_SviStart, Task_SviEnd},
+    {"Core", SVI_F_OUT | SVI_F_SINT32, sizeof(SINT32), offsetof(TASK_PROPERTIES, SviSnap.CoreUsed),
+     Task_SviStart, Task_SviEnd},
+    {"StatsReset", SVI_F_INOUT | SVI_F_UINT32, sizeof(UINT32), offsetof(TASK_PROPERTIES, Stats.Reset), NULL, NULL}
+};
+
+/**
+********************************************************************************
+* @brief Main entry function of the aTask of the application.
+*        The input parameter is being passed by the task spawn call.
+*
+* @param[in]  pointer to task properties data structure
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Control_Main(TASK_PROPERTIES * pTaskData)
+{
+    /* Initialization upon task entry */
+    Task_SetAffinity(pTaskData);
+    Control_CycleInit();
+
+    /*
+     * This loop is executed endlessly
+     * as long as there is no request to quit the task
+     */
+    while (!pTaskData->Quit)
+    {
+        /* cycle start administration */
+        Control_CycleStart(pTaskData);
+
+        /* operational code */
+        Control_Cycle(pTaskData);
+
+        /* cycle end administration */
+        Control_CycleEnd(pTaskData);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Administration code to be called once before first cycle start.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Control_CycleInit(VOID)
+{
+
+    /* TODO: add what is necessary before cyclic operation starts */
+
+}
+
+/**
+********************************************************************************
+* @brief Administration code to be called once at each task cycle start.
+*
+* @param[in]  pointer to task properties data structure
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Control_CycleStart(TASK_PROPERTIES * pTaskData)
+{
+    MIST_VM *pVm = pTaskData->pVm;
+
+    MIST_TRC(pTaskData->pTrc, MIST_TRC_CYCLE, 0, pVm ? pVm->NbOfCycles : CycleCount);
+
+    /* Inputs of the ST program: latest snapshot of the process image */
+    if (pVm && pVm->pImg)
+        mist_ImgInputs(pVm->pImg, pVm->pMem);
+
+    /* Values written by SVI clients into the exported variables */
+    if (pVm && pVm->pSviMap)
+        mist_SviExportIn(pVm->pSviMap, pVm->pMem);
+
+    /* TODO: add what is necessary at each cycle start */
+
+}
+
+/**
+********************************************************************************
+* @brief Cyclic application code.
+*        Executes one cycle of the configured ST program. After a run time
+*        fault the program is stopped, the fault is logged once.
+*
+* @param[in]  pointer to task properties data structure
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Control_Cycle(TASK_PROPERTIES * pTaskData)
+{
+    MIST_VM *pVm = pTaskData->pVm;
+    CHAR    Func[] = "Control_Cycle";
+
+    /* ST program, either generated C code or VM on the same data area */
+    if (pVm && !pVm->Fault)
+    {
+        if (pTaskData->pCycleFunc)
+        {
+            pTaskData->pCycleFunc(pTaskData);
+            if (pVm->Fault)
+                LOG_E(0, Func, "Program '%s' stopped: %s!", pVm->pCode->Name, mist_VmFaultText(pVm->Fault));
+        }
+        else if (mist_VmRunPar(pVm, pTaskData->pPar) < 0)
+            LOG_E(0, Func, "Program '%s' stopped at instruction %u: %s!", pVm->pCode->Name,
+                  pVm->FaultPc, mist_VmFaultText(pVm->Fault));
+        if (pVm->Fault)
+            MIST_TRC(pTaskData->pTrc, MIST_TRC_FAULT, pVm->Fault, pVm->FaultPc);
+    }
+
+    /* Increase cycle counter */
+    CycleCount++;
+
+}
+
+/**
+********************************************************************************
+* @brief Administration code to be called at each task cycle end
+*
+* @param[in]  pointer to task properties data structure
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Control_CycleEnd(TASK_PROPERTIES * pTaskData)
+{
+    MIST_VM *pVm = pTaskData->pVm;
+
+    /* Outputs of the ST program: published for other tasks as one snapshot */
+    if (pVm && pVm->pImg && !pVm->Fault)
+        mist_ImgOutputs(pVm->pImg, pVm->pMem, pVm->NbOfCycles);
+
+    /* Values of the exported variables for SVI clients */
+    if (pVm && pVm->pSviMap && !pVm->Fault)
+        mist_SviExportOut(pVm->pSviMap, pVm->pMem);
+
+    MIST_TRC(pTaskData->pTrc, MIST_TRC_CYCLEEND, 0, pVm ? pVm->NbOfCycles : CycleCount);
+
+    /* TODO: add what is to be called at each cycle end */
+
+    /*
+     * This is the very end of the cycle
+     * Delay task in order to match desired cycle time
+     */
+    Task_WaitCycle(pTaskData);
+}
+
+/**
+********************************************************************************
+* @brief Performs the second phase of the module initialization.
+* 		  Called at "End Of Init" by the bTask.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_AppEOI(VOID)
+{
+
+    /* do while(0), to be left as soon as there is an error */
+    do
+    {
+        /* TODO: set module info string, maximum length is SMI_DESCLEN_A */
+        snprintf(mist_ModuleInfoDesc, sizeof(mist_ModuleInfoDesc), "TODO: set application specific module info string");
+
+        /* TODO: add all initializations required by your application */
+
+        /* Compile the ST programs of all tasks, before any task is running */
+        if (Task_PrgLoadAll() < 0)
+            break;
+
+        /* Distribute the tasks on the CPU cores and check their load before they are started */
+        mist_SchedPartition(TaskList, NbOfTasks, Task_NbOfCores());
+        if (mist_SchedCheck(TaskList, NbOfTasks) < 0)
+            break;
+
+        /* Export the SVI variables of tasks added by a new configuration */
+        Task_SviAddAll();
+
+        /* Start all application tasks listed in TaskList */
+        if (Task_CreateAll() < 0)
+            break;
+
+        /* At this point, all init actions are done successfully */
+        return (OK);
+    }
+    while (0);
+
+    /*
+     * At this point, an init action returned an error.
+     * The application code is being de-initialized.
+     */
+    mist_AppDeinit();
+    return (ERROR);
+}
+
+/**
+********************************************************************************
+* @brief Frees all resources of the application
+*        Called at De-Init of the module by the bTask.
+*        The function does not quit on an error.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_AppDeinit(VOID)
+{
+
+    /* TODO: Free all resources which have been allocated by the application */
+
+    /* Delete all application tasks listed in TaskList */
+    Task_DeleteAll();
+
+    /* The ST programs are released when no task is executing them any more */
+    Task_PrgFreeAll();
+
+    /* The task list is built again by the next configuration */
+    NbOfTasks = 0;
+    TaskMask = 0;
+
+}
+
+/**
+********************************************************************************
+* @brief Takes over a new configuration without stopping the tasks
+*        (online change). The programs of all tasks are compiled and
+*        instantiated in the background. Each task switches to its new
+*        program between two cycles (Task_PrgSwap()), variables which are
+*        unchanged keep their values (mist_VmXferMap()).
+*        The configuration is read into a copy of the task properties,
+*        only the settings of the programs (Program, LoopBudget, Backend,
+*        SviExport) are taken over. A change of any other setting or of
+*        the configured tasks requires a restart of the tasks.
+*        Called by RpcNewCfg while the module is running.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     = 0 .. OK, the tasks execute the new programs
+* @retval     > 0 .. online change not possible, the tasks must be restarted
+* @retval     < 0 .. ERROR, nothing has changed
+*******************************************************************************/
+SINT32 mist_AppOnlineChange(VOID)
+{
+    UINT32  idx;
+    TASK_PROPERTIES *pCfg;
+    TASK_PROPERTIES *CfgList[TASK_MAX];
+    BOOL    Swap[TASK_MAX];
+    UINT32  NbOfKept;
+    UINT32  Pending;
+    UINT32  Timeout = 500000;
+    UINT32  RequestTime;
+    MIST_CODE *pCode;
+    CHAR    Func[] = "mist_AppOnlineChange";
+
+    /* All tasks must be running, a previous online change must be complete */
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if ((TaskList[idx]->TaskId == ERROR) || TaskList[idx]->SwapReq)
+            return (1);
+    }
+
+    /* Tasks added or removed */
+    if (Task_CfgMask() != TaskMask)
+    {
+        LOG_I(0, Func, "Configured tasks have changed, the tasks are restarted");
+        return (1);
+    }
+
+    /*
+     * The new configuration is read into a copy, the running tasks keep their settings.
+     * The copy is too large for the stack of the SMI server.
+     */
+    pCfg = malloc(NbOfTasks * sizeof(TASK_PROPERTIES));
+    if (!pCfg)
+    {
+        LOG_E(0, Func, "No memory!");
+        return (ERROR);
+    }
+
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        Task_PrgRetire(TaskList[idx]);
+        pCfg[idx] = *TaskList[idx];
+        CfgList[idx] = &pCfg[idx];
+        Swap[idx] = FALSE;
+    }
+
+    if (Task_CfgRead(CfgList) < 0)
+    {
+        free(pCfg);
+        return (1);
+    }
+
+    /* Only the settings of the programs may change */
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if ((pCfg[idx].CycleTime_ms != TaskList[idx]->CycleTime_ms) ||
+            (pCfg[idx].Priority != TaskList[idx]->Priority) ||
+            (pCfg[idx].WDogRatio != TaskList[idx]->WDogRatio) ||
+            (pCfg[idx].TimeBase != TaskList[idx]->TimeBase) ||
+            (pCfg[idx].OverrunPolicy != TaskList[idx]->OverrunPolicy) ||
+            (pCfg[idx].CatchUpMax != TaskList[idx]->CatchUpMax) ||
+            (pCfg[idx].Wcet != TaskList[idx]->Wcet) ||
+            (pCfg[idx].Core != TaskList[idx]->Core) ||
+            (pCfg[idx].Workers != TaskList[idx]->Workers))
+        {
+            LOG_I(0, Func, "Settings of task %s have changed, the tasks are restarted", TaskList[idx]->Name);
+            free(pCfg);
+            return (1);
+        }
+    }
+
+    /* Prepare the new programs, the tasks keep running */
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        pCode = NULL;
+        if (pCfg[idx].PrgFile[0] && (mist_PrgCacheLoad(pCfg[idx].PrgFile, &pCode) < 0))
+        {
+            LOG_E(0, Func, "Could not compile program '%s' of task %s!", pCfg[idx].PrgFile,
+                  TaskList[idx]->Name);
+            break;
+        }
+
+        if ((pCode == TaskList[idx]->pCode) && (pCfg[idx].LoopBudget == TaskList[idx]->LoopBudget) &&
+            (pCfg[idx].Backend == TaskList[idx]->Backend) && (pCfg[idx].SviExport == TaskList[idx]->SviExport))
+        {
+            mist_PrgCacheRelease(pCode);
+            continue;
+        }
+
+        Swap[idx] = TRUE;
+        TaskList[idx]->pNewCode = pCode;
+        if (!pCode)
+            continue;
+
+        TaskList[idx]->pNewVm = mist_VmCreate(pCode, pCfg[idx].LoopBudget);
+        if (!TaskList[idx]->pNewVm)
+            break;
+        TaskList[idx]->pNewVm->pTrc = TaskList[idx]->pTrc;
+        if (TaskList[idx]->Workers)
+            mist_VmParInit(TaskList[idx]->pNewVm, TaskList[idx]->Workers + 1);
+        Task_SviExport(&pCfg[idx], TaskList[idx]->pNewVm);
+
+        if (pCfg[idx].Backend)
+        {
+            TaskList[idx]->pNewCycleFunc = mist_CGenFind(pCode);
+            if (!TaskList[idx]->pNewCycleFunc)
+                LOG_W(0, Func, "Task %s executes program '%s' with the VM!", TaskList[idx]->Name, pCode->Name);
+        }
+
+        NbOfKept = 0;
+        if (TaskList[idx]->pCode &&
+            (mist_VmXferMap(TaskList[idx]->pCode, pCode, &TaskList[idx]->pXfer, &TaskList[idx]->NbOfXfers,
+                            &NbOfKept) < 0))
+            break;
+
+        LOG_I(0, Func, "Task %s: program '%s' prepared, %u of %u variables keep their values",
+              TaskList[idx]->Name, pCode->Name, NbOfKept, pCode->NbOfVars);
+    }
+
+    /* On an error, nothing changes */
+    if (idx < NbOfTasks)
+    {
+        for (idx = 0; idx < NbOfTasks; idx++)
+            Task_PrgRetire(TaskList[idx]);
+        free(pCfg);
+        return (ERROR);
+    }
+
+    /* Take over the settings of the programs, they are not used by the tasks themselves */
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        memcpy(TaskList[idx]->PrgFile, pCfg[idx].PrgFile, sizeof(pCfg[idx].PrgFile));
+        TaskList[idx]->LoopBudget = pCfg[idx].LoopBudget;
+        TaskList[idx]->Backend = pCfg[idx].Backend;
+        TaskList[idx]->SviExport = pCfg[idx].SviExport;
+    }
+    free(pCfg);
+
+    /* Hand the new programs over, the tasks switch at the end of their current cycle */
+    MIST_BARRIER();
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if (Swap[idx])
+            TaskList[idx]->SwapReq = TRUE;
+        if (Timeout < TaskList[idx]->CycleTime_ms * 3000)
+            Timeout = TaskList[idx]->CycleTime_ms * 3000;
+    }
+
+    /* Wait for all tasks to switch, one tick at a time */
+    RequestTime = m_GetProcTime();
+    do
+    {
+        taskDelay(1);
+        for (idx = 0, Pending = 0; idx < NbOfTasks; idx++)
+            Pending += TaskList[idx]->SwapReq;
+    }
+    while (Pending && ((m_GetProcTime() - RequestTime) <= Timeout));
+    MIST_BARRIER();
+
+    /* Release the old programs, a task which has not switched yet keeps its request */
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if (!Swap[idx])
+            continue;
+
+        if (TaskList[idx]->SwapReq)
+        {
+            LOG_W(0, Func, "Task %s has not switched to its new program yet", TaskList[idx]->Name);
+            continue;
+        }
+
+        LOG_I(0, Func, "Task %s switched to program '%s' in %u us", TaskList[idx]->Name,
+              TaskList[idx]->pCode ? TaskList[idx]->pCode->Name : "", TaskList[idx]->SwapTime);
+        Task_PrgRetire(TaskList[idx]);
+    }
+
+    mist_PrgCachePurge(FALSE);
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Reads the settings from configuration file mconfig
+*        for all tasks registered in TaskList[].
+*        If no task is running, TaskList[] is built from the configuration
+*        groups first, see Task_ListBuild().
+*        The group name in TaskList[] is being used as configuration group name.
+*        The initialization values in TaskDefaults are being used as default values.
+*        For general configuration data, mist_CfgParams is being used.
+*        Being called by mist_CfgRead and, with a copy of the task
+*        properties, by mist_AppOnlineChange.
+*        All parameters are stored in the task properties data structure.
+*        All parameters are being treated as optional.
+*        There is no limitation checking of the parameters, the limits are being
+*        specified in the cru and checked by the configurator.
+*
+* @param[in]  pList   task properties of the tasks in TaskList[], TaskList itself
+*                     or a copy
+* @param[out] pList   settings read
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Task_CfgRead(TASK_PROPERTIES * const *pList)
+{
+    UINT32  idx;
+    SINT32  ret;
+    CHAR    section[PF_KEYLEN_A];
+    CHAR    group[PF_KEYLEN_A];
+    CHAR    key[PF_KEYLEN_A];
+    SINT32  TmpVal;
+    CHAR    TmpStrg[32];
+    CHAR    TmpPath[M_PATHLEN_A];
+    UINT32  Error = FALSE;
+    CHAR    Func[] = "Task_CfgRead";
+
+    /* section name is the application name, for all tasks */
+    snprintf(section, sizeof(section), mist_BaseParams.AppName);
+
+    /* One task for each configuration group */
+    if (!NbOfTasks)
+        Task_ListBuild(Task_CfgMask());
+
+    /* For all application tasks listed in TaskList */
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if (!pList[idx])
+        {
+            LOG_E(0, Func, "Invalid task properties pointer in task list entry #%d!", idx);
+            Error = TRUE;
+            continue;
+        }
+
+        /* group name is specified in the task properties */
+        snprintf(group, sizeof(group), pList[idx]->CfgGroup);
+
+        /* if no group name has been specified: skip configuration reading for this task */
+        if (strlen(group) < 1)
+        {
+            LOG_I(0, Func, "Could not find task configuration for task '%s' in mconfig ",
+                  pList[idx]->Name);
+            continue;
+        }
+
+        /*
+         * Read the desired value for the task cycle time.
+         * If the keyword has not been found, the initialization value remains
+         * in the task properties.
+         */
+        snprintf(key, sizeof(key), "CycleTime");
+        snprintf(TmpStrg, sizeof(TmpStrg), "%f", pList[idx]->CycleTime_ms);
+        ret = pf_GetStrg(section, group, key, "", (CHAR *) & TmpStrg, sizeof(TmpStrg),
+                         mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
+        /* keyword has been found */
+        if (ret >= 0)
+        {
+            *((REAL32 *) & pList[idx]->CycleTime_ms) = atof(TmpStrg);
+        }
+        /* keyword has not been found */
+        else
+        {
+            LOG_W(0, Func, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
+            LOG_W(0, Func, " -> using initialization value of %f ms", pList[idx]->CycleTime_ms);
+        }
+
+        /*
+         * Read the desired value for the task priority.
+         * If the keyword has not been found, the initialization value remains
+         * in the task properties.
+         * As an additional fall back, the priority in the base parms will be used.
+         */
+        snprintf(key, sizeof(key), "Priority");
+        ret = pf_GetInt(section, group, key, pList[idx]->Priority, &TmpVal,
+                        mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
+        /* keyword has been found */
+        if (ret >= 0)
+        {
+            pList[idx]->Priority = TmpVal;
+        }
+        /* keyword has not been found */
+        else
+        {
+            LOG_W(0, Func, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
+            if (pList[idx]->Priority == 0)
+            {
+                pList[idx]->Priority = mist_BaseParams.DefaultPriority;
+                LOG_W(0, Func, " -> using base parms value of %d", pList[idx]->Priority);
+            }
+            else
+                LOG_W(0, Func, " -> using initialization value of %d", pList[idx]->Priority);
+        }
+
+        /*
+         * Read the software watchdog time ratio.
+         * If the keyword has not been found, the initialization value remains
+         * in the task properties.
+         */
+        snprintf(key, sizeof(key), "WatchdogRatio");
+        ret = pf_GetInt(section, group, key, pList[idx]->WDogRatio, &TmpVal,
+                        mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
+        /* keyword has been found */
+        if (ret >= 0)
+        {
+            pList[idx]->WDogRatio = TmpVal;
+        }
+        /* keyword has not been found */
+        else
+        {
+            LOG_W(0, Func, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
+            LOG_W(0, Func, " -> using initialization value of %d", pList[idx]->WDogRatio);
+        }
+
+        /*
+         * Read the time base for the cycle time.
+         * If the keyword has not been found, the initialization value remains
+         * in the task properties.
+         */
+        snprintf(key, sizeof(key), "TimeBase");
+        ret = pf_GetInt(section, group, key, pList[idx]->TimeBase, &TmpVal,
+                        mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
+        /* keyword has been found */
+        if (ret >= 0)
+        {
+            pList[idx]->TimeBase = TmpVal;
+        }
+        /* keyword has not been found */
+        else
+        {
+            LOG_W(0, Func, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
+            LOG_W(0, Func, " -> using initialization value of %d", pList[idx]->TimeBase);
+        }
+
+        /*
+         * Read the path/name of the ST program and its loop budget.
+         * If the keyword has not been found, the initialization value remains
+         * in the task properties.
+         */
+        snprintf(key, sizeof(key), "Program");
+        ret = pf_GetStrg(section, group, key, "", (CHAR *) & TmpPath, sizeof(TmpPath),
+                         mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
+        /* keyword has been found */
+        if (ret >= 0)
+        {
+            snprintf(pList[idx]->PrgFile, sizeof(pList[idx]->PrgFile), "%s", TmpPath);
+        }
+        /* keyword has not been found */
+        else
+        {
+            LOG_W(0, Func, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
+            LOG_W(0, Func, " -> using initialization value of '%s'", pList[idx]->PrgFile);
+        }
+
+        snprintf(key, sizeof(key), "LoopBudget");
+        ret = pf_GetInt(section, group, key, pList[idx]->LoopBudget, &TmpVal,
+                        mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
+        /* keyword has been found */
+        if (ret >= 0)
+        {
+            pList[idx]->LoopBudget = TmpVal;
+        }
+        /* keyword has not been found */
+        else
+        {
+            LOG_W(0, Func, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
+            LOG_W(0, Func, " -> using initialization value of %d", pList[idx]->LoopBudget);
+        }
+
+        snprintf(key, sizeof(key), "Backend");
+        ret = pf_GetInt(section, group, key, pList[idx]->Backend, &TmpVal,
+                        mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
+        /* keyword has been found */
+        if (ret >= 0)
+        {
+            pList[idx]->Backend = TmpVal;
+        }
+        /* keyword has not been found */
+        else
+        {
+            LOG_W(0, Func, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
+            LOG_W(0, Func, " -> using initialization value of %d", pList[idx]->Backend);
+        }
+
+        /*
+         * Read the handling of a cycle backlog.
+         * If the keyword has not been found, the initialization value remains
+         * in the task properties.
+         */
+        snprintf(key, sizeof(key), "OverrunPolicy");
+        ret = pf_GetInt(section, group, key, pList[idx]->OverrunPolicy, &TmpVal,
+                        mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
+        /* keyword has been found */
+        if ((ret >= 0) && (TmpVal >= MIST_OVR_CATCHUP) && (TmpVal <= MIST_OVR_ABORT))
+        {
+            pList[idx]->OverrunPolicy = TmpVal;
+        }
+        /* keyword has not been found */
+        else
+        {
+            LOG_W(0, Func, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
+            LOG_W(0, Func, " -> using initialization value of %d", pList[idx]->OverrunPolicy);
+        }
+
+        snprintf(key, sizeof(key), "CatchUpMax");
+        ret = pf_GetInt(section, group, key, pList[idx]->CatchUpMax, &TmpVal,
+                        mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
+        /* keyword has been found */
+        if (ret >= 0)
+        {
+            pList[idx]->CatchUpMax = TmpVal;
+        }
+        /* keyword has not been found */
+        else
+        {
+            LOG_W(0, Func, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
+            LOG_W(0, Func, " -> using initialization value of %d", pList[idx]->CatchUpMax);
+        }
+
+        snprintf(key, sizeof(key), "WCET");
+        ret = pf_GetInt(section, group, key, pList[idx]->Wcet, &TmpVal,
+                        mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
+        /* keyword has been found */
+        if (ret >= 0)
+        {
+            pList[idx]->Wcet = TmpVal;
+        }
+        /* keyword has not been found */
+        else
+        {
+            LOG_W(0, Func, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
+            LOG_W(0, Func, " -> using initialization value of %d", pList[idx]->Wcet);
+        }
+
+        snprintf(key, sizeof(key), "Core");
+        ret = pf_GetInt(section, group, key, pList[idx]->Core, &TmpVal,
+                        mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
+        /* keyword has been found */
+        if ((ret >= 0) && (TmpVal >= -1) && (TmpVal < TASK_CORE_MAX))
+        {
+            pList[idx]->Core = TmpVal;
+        }
+        /* keyword has not been found */
+        else
+        {
+            LOG_W(0, Func, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
+            LOG_W(0, Func, " -> using initialization value of %d", pList[idx]->Core);
+        }
+
+        snprintf(key, sizeof(key), "Workers");
+        ret = pf_GetInt(section, group, key, pList[idx]->Workers, &TmpVal,
+                        mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
+        /* keyword has been found */
+        if ((ret >= 0) && (TmpVal >= 0) && (TmpVal < MIST_PAR_MAXWORKERS))
+        {
+            pList[idx]->Workers = TmpVal;
+        }
+        /* keyword has not been found */
+        else
+        {
+            LOG_W(0, Func, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
+            LOG_W(0, Func, " -> using initialization value of %u", pList[idx]->Workers);
+        }
+
+        /*
+         * Read which variables of the ST program are exported to the SVI.
+         * If the keyword has not been found, the initialization value remains
+         * in the task properties.
+         */
+        snprintf(key, sizeof(key), "SviExport");
+        ret = pf_GetInt(section, group, key, pList[idx]->SviExport, &TmpVal,
+                        mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
+        /* keyword has been found */
+        if ((ret >= 0) && (TmpVal >= MIST_SVIEXP_OFF) && (TmpVal <= MIST_SVIEXP_ALL))
+        {
+            pList[idx]->SviExport = TmpVal;
+        }
+        /* keyword has not been found */
+        else
+        {
+            LOG_W(0, Func, "Missing configuration parameter '[%s](%s)%s'", section, group, key);
+            LOG_W(0, Func, " -> using initialization value of %u", pList[idx]->SviExport);
+        }
+    }
+
+    /* Evaluate overall error flag */
+    if (Error)
+        return (ERROR);
+    else
+        return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Determines the configuration groups of the tasks in mconfig:
+*        ControlTask, ControlTask2 .. ControlTask<TASK_MAX>. A group is
+*        found by its key CycleTime. The first task is always started,
+*        with the default settings if its group is missing.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     groups found, bit n - 1 = group n
+*******************************************************************************/
+MLOCAL UINT32 Task_CfgMask(VOID)
+{
+    UINT32  Nb;
+    UINT32  Mask = 1;
+    CHAR    section[PF_KEYLEN_A];
+    CHAR    group[PF_KEYLEN_A];
+    CHAR    TmpStrg[32];
+
+    snprintf(section, sizeof(section), mist_BaseParams.AppName);
+
+    for (Nb = 2; Nb <= TASK_MAX; Nb++)
+    {
+        snprintf(group, sizeof(group), "%s%u", TaskDefaults.CfgGroup, Nb);
+        if (pf_GetStrg(section, group, "CycleTime", "", TmpStrg, sizeof(TmpStrg),
+                       mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName) >= 0)
+            Mask |= 1 << (Nb - 1);
+    }
+
+    return (Mask);
+}
+
+/**
+********************************************************************************
+* @brief Builds the task list for the configuration groups in Mask.
+*        Each task starts with the default settings, the number of the
+*        group is appended to the task and group name. The max. execution
+*        time measured in the previous runs is kept for mist_SchedCheck().
+*        No task may be running.
+*
+* @param[in]  Mask    configuration groups, see Task_CfgMask()
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Task_ListBuild(UINT32 Mask)
+{
+    TASK_PROPERTIES *pTaskData;
+    UINT32  Measured;
+    UINT32  Nb;
+
+    NbOfTasks = 0;
+    for (Nb = 1; Nb <= TASK_MAX; Nb++)
+    {
+        if (!(Mask & (1 << (Nb - 1))))
+            continue;
+
+        pTaskData = &TaskPool[Nb - 1];
+        Measured = pTaskData->WcetMeasured;
+        if (pTaskData->Stats.ExecMax > Measured)
+            Measured = pTaskData->Stats.ExecMax;
+
+        *pTaskData = TaskDefaults;
+        pTaskData->WcetMeasured = Measured;
+        if (Nb > 1)
+        {
+            snprintf(pTaskData->Name, sizeof(pTaskData->Name), "%s%u", TaskDefaults.Name, Nb);
+            snprintf(pTaskData->CfgGroup, sizeof(pTaskData->CfgGroup), "%s%u", TaskDefaults.CfgGroup, Nb);
+        }
+        TaskList[NbOfTasks++] = pTaskData;
+    }
+    TaskMask = Mask;
+
+    LOG_I(0, "Task_ListBuild", "%u tasks configured", NbOfTasks);
+}
+
+/**
+********************************************************************************
+* @brief Starts all tasks which are registered in the global task list
+*        - task watchdog is being created if specified
+*        - priority is being checked and corrected if necessary
+*        - semaphore for cycle timing is being created
+*        - sync session is being started if necessary
+*        - sync ISR is being attached if necessary
+*        If there is an error creating a task, no further tasks will be started.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Task_CreateAll(VOID)
+{
+    UINT32  idx;
+    UINT8   TaskName[M_TSKNAMELEN_A];
+    UINT32  TaskOptions;
+    UINT32  wdogtime_us;
+    CHAR    Func[] = "Task_CreateAll";
+
+    /* For all application tasks listed in TaskList */
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if (!TaskList[idx])
+        {
+            LOG_E(0, Func, "Invalid task properties pointer!");
+            return (ERROR);
+        }
+
+        /* Initialize what is necessary */
+        TaskList[idx]->SyncSessionId = ERROR;
+        TaskList[idx]->TaskId = ERROR;
+        TaskList[idx]->WdogId = 0;
+        TaskList[idx]->Quit = FALSE;
+
+        /* Create software watchdog if required */
+        if (TaskList[idx]->WDogRatio > 0)
+        {
+            /* check watchdog ratio, minimum useful value is 2 */
+            if (TaskList[idx]->WDogRatio < 3)
+            {
+                TaskList[idx]->WDogRatio = 3;
+                LOG_W(0, Func, "Watchdog ratio increased to 3!");
+            }
+
+            wdogtime_us = (TaskList[idx]->CycleTime_ms * 1000) * TaskList[idx]->WDogRatio;
+            TaskList[idx]->WdogId = sys_WdogCreate(mist_AppName, wdogtime_us);
+            if (TaskList[idx]->WdogId == 0)
+            {
+                LOG_E(0, Func, "Could not create watchdog!");
+                return (ERROR);
+            }
+        }
+
+        /* Create binary semaphore for cycle timing */
+        TaskList[idx]->CycleSema = semBCreate(SEM_Q_PRIORITY, SEM_EMPTY);
+        if (!TaskList[idx]->CycleSema)
+        {
+            LOG_E(0, Func, "Could not create cycle timing semaphore for task '%s'!",
+                  TaskList[idx]->Name);
+            return (ERROR);
+        }
+
+        /* Initialize task cycle timing infrastructure */
+        Task_InitTiming(TaskList[idx]);
+
+        /* In case the priority has not been properly set */
+        if (TaskList[idx]->Priority == 0)
+        {
+            LOG_E(0, Func, "Invalid priority for task '%s'", TaskList[idx]->Name);
+            return (ERROR);
+        }
+
+        /* Worker tasks for the parallel execution of the ST program, same priority */
+        if (TaskList[idx]->Workers)
+        {
+            TaskList[idx]->pPar = mist_ParCreate(TaskList[idx]->Name, TaskList[idx]->Workers + 1,
+                                                 TaskList[idx]->Priority);
+            if (!TaskList[idx]->pPar)
+                return (ERROR);
+        }
+
+        /* Cycle trace, the program records its segments in the same ring */
+        TaskList[idx]->pTrc = mist_TrcCreate(TaskList[idx]->Name);
+        if (TaskList[idx]->pVm)
+            TaskList[idx]->pVm->pTrc = TaskList[idx]->pTrc;
+
+        /* make sure task name string is terminated */
+        TaskList[idx]->Name[M_TSKNAMELEN_A - 2] = 0;
+
+        /* If no task name has been set: use application name and index */
+        if (strlen(TaskList[idx]->Name) < 1)
+            snprintf(TaskList[idx]->Name, sizeof(TaskList[idx]->Name), "a%s_%d", mist_AppName, idx + 1);
+
+        snprintf(TaskName, sizeof(TaskList[idx]->Name), "%s", TaskList[idx]->Name);
+
+        /* Task options */
+        TaskOptions = 0;
+        if (TaskList[idx]->UseFPU)
+            TaskOptions |= VX_FP_TASK;
+
+        /* Spawn task with properties set in task list */
+        TaskList[idx]->TaskId = sys_TaskSpawn(mist_AppName, TaskName,
+                                              TaskList[idx]->Priority, TaskOptions,
+                                              TaskList[idx]->StackSize,
+                                              (FUNCPTR) TaskList[idx]->pMainFunc, TaskList[idx]);
+
+        /* Check if task has been created successfully */
+        if (TaskList[idx]->TaskId == ERROR)
+        {
+            LOG_E(0, Func, "Error in sys_TaskSpawn for task '%s'!", TaskName);
+            return (ERROR);
+        }
+    }
+
+    /* At this point, all tasks have been started successfully */
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Deletes all tasks which are registered in the global task list
+*        Undo for all operations in Task_CreateAll
+*        The function will not be left upon an error.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Task_DeleteAll(VOID)
+{
+    MIST_TRC *pTrc;
+    UINT32  idx;
+    UINT32  RequestTime;
+    CHAR    Func[] = "Task_DeleteAll";
+
+    /*
+     * Delete software watchdog if present
+     * This must be done first, because tasks will end their cyclic operation
+     * and thus won't trigger their watchdogs any more.
+     */
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if (TaskList[idx]->WdogId)
+            sys_WdogDelete(TaskList[idx]->WdogId);
+    }
+
+    /*
+     * Set quit request for all existing tasks
+     * This should make tasks complete their cycle and quit operation.
+     */
+    for (idx = 0; idx < NbOfTasks; idx++)
+        TaskList[idx]->Quit = TRUE;
+
+    /*
+     * Give all cycle semaphores of listed tasks
+     * This wakes up all tasks and thus speeds up the completion.
+     */
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if (TaskList[idx]->CycleSema)
+            semGive(TaskList[idx]->CycleSema);
+    }
+
+    /* Take a time stamp for the timeout check */
+    RequestTime = m_GetProcTime();
+
+    /*
+     * Wait for all tasks to quit their cycle.
+     * Apply a timeout of 500ms
+     * Wait one tick in case of missing task quit
+     */
+    do
+    {
+        UINT32  AllTasksQuitted = TRUE;
+
+        /* allow one tick for tasks to complete */
+        taskDelay(1);
+
+        /* Check if all tasks have terminated their cycles */
+        for (idx = 0; idx < NbOfTasks; idx++)
+            AllTasksQuitted &= (taskIdVerify(TaskList[idx]->TaskId) == ERROR);
+
+        /* If all tasks have terminated themselves */
+        if (AllTasksQuitted)
+        {
+            if (mist_BaseParams.DebugMode & APP_DBG_INFO1)
+                LOG_I(0, Func, "All tasks have terminated by themselves");
+            break;
+        }
+        /* If timeout waiting for task self termination is over */
+        else if ((m_GetProcTime() - RequestTime) > 500000)
+        {
+            LOG_W(0, Func, "Timeout at waiting for tasks to terminate by themselves");
+            break;
+        }
+    }
+    while (TRUE);
+
+    /* Cleanup resources and delete all remaining tasks */
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        /* Stop sync session or high resolution timer */
+        Task_ExitTiming(TaskList[idx]);
+
+        /* Delete semaphore for cycle timing */
+        if (TaskList[idx]->CycleSema)
+        {
+            if (semDelete(TaskList[idx]->CycleSema) < 0)
+                LOG_W(0, Func, "Could not delete cycle semaphore of task %s!", TaskList[idx]->Name);
+            else
+            	TaskList[idx]->CycleSema = 0;
+        }
+
+        /* Remove application tasks which still exist */
+        if (taskIdVerify(TaskList[idx]->TaskId) == OK)
+        {
+            if (taskDelete(TaskList[idx]->TaskId) == ERROR)
+                LOG_E(0, Func, "Could not delete task %s!", TaskList[idx]->Name);
+            else
+                LOG_W(0, Func, "Task %s had to be deleted!", TaskList[idx]->Name);
+
+            TaskList[idx]->TaskId = ERROR;
+        }
+
+        /* End the worker tasks, the application task does not use them any more */
+        mist_ParDelete(TaskList[idx]->pPar);
+        TaskList[idx]->pPar = NULL;
+
+        /* The trace is lost, dumps skip the task from now on */
+        pTrc = TaskList[idx]->pTrc;
+        TaskList[idx]->pTrc = NULL;
+        if (TaskList[idx]->pVm)
+            TaskList[idx]->pVm->pTrc = NULL;
+        if (TaskList[idx]->pNewVm)
+            TaskList[idx]->pNewVm->pTrc = NULL;
+        MIST_BARRIER();
+        mist_TrcDelete(pTrc);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Number of CPU cores the tasks can be bound to.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     number of cores, 1 = no affinity supported
+*******************************************************************************/
+MLOCAL UINT32 Task_NbOfCores(VOID)
+{
+#if defined(__linux__)
+    long    Nb = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return ((Nb > 1) ? (UINT32) Nb : 1);
+#elif defined(_WRS_CONFIG_SMP)
+    return (vxCpuConfiguredGet());
+#else
+    return (1);
+#endif
+}
+
+/**
+********************************************************************************
+* @brief Binds the calling task to its CPU core (CoreUsed, see
+*        mist_SchedPartition). To be called by the task itself upon entry,
+*        before its first cycle. Tasks with CoreUsed = -1 are not bound.
+*
+* @param[in]  pointer to task properties data structure
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Task_SetAffinity(TASK_PROPERTIES * pTaskData)
+{
+#if defined(__linux__)
+    cpu_set_t Affinity;
+    int     ret;
+    CHAR    Func[] = "Task_SetAffinity";
+#elif defined(_WRS_CONFIG_SMP)
+    cpuset_t Affinity;
+    CHAR    Func[] = "Task_SetAffinity";
+#endif
+
+    if (pTaskData->CoreUsed < 0)
+        return;
+
+#if defined(__linux__)
+    CPU_ZERO(&Affinity);
+    CPU_SET(pTaskData->CoreUsed, &Affinity);
+    ret = pthread_setaffinity_np(pthread_self(), sizeof(Affinity), &Affinity);
+    if (ret != 0)
+    {
+        LOG_W(0, Func, "Task %s: could not bind to core %d (errno %d), running on any core", pTaskData->Name,
+              pTaskData->CoreUsed, ret);
+        pTaskData->CoreUsed = -1;
+    }
+#elif defined(_WRS_CONFIG_SMP)
+    CPUSET_ZERO(Affinity);
+    CPUSET_SET(Affinity, pTaskData->CoreUsed);
+    if (taskCpuAffinitySet(taskIdSelf(), Affinity) == ERROR)
+    {
+        LOG_W(0, Func, "Task %s: could not bind to core %d, running on any core", pTaskData->Name,
+              pTaskData->CoreUsed);
+        pTaskData->CoreUsed = -1;
+    }
+#endif
+}
+
+/**
+********************************************************************************
+* @brief Compiles the ST programs of all tasks which are registered in the
+*        global task list and creates their program instances.
+*        Tasks without program are skipped. Must be called before the tasks
+*        are being started. Programs with unchanged source are taken from
+*        the program cache, programs no task needs any more are removed
+*        from it.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Task_PrgLoadAll(VOID)
+{
+    UINT32  idx;
+    CHAR    Func[] = "Task_PrgLoadAll";
+
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if (!TaskList[idx]->PrgFile[0])
+            continue;
+
+        if (mist_PrgCacheLoad(TaskList[idx]->PrgFile, &TaskList[idx]->pCode) < 0)
+        {
+            LOG_E(0, Func, "Could not compile program '%s' of task %s!", TaskList[idx]->PrgFile,
+                  TaskList[idx]->Name);
+            return (ERROR);
+        }
+
+        TaskList[idx]->pVm = mist_VmCreate(TaskList[idx]->pCode, TaskList[idx]->LoopBudget);
+        if (!TaskList[idx]->pVm)
+            return (ERROR);
+
+        /* Clones of the VM for the worker tasks, without them the program is executed serially */
+        if (TaskList[idx]->Workers)
+            mist_VmParInit(TaskList[idx]->pVm, TaskList[idx]->Workers + 1);
+
+        /* Generated C code, the VM remains as fallback */
+        if (TaskList[idx]->Backend)
+        {
+            TaskList[idx]->pCycleFunc = mist_CGenFind(TaskList[idx]->pCode);
+            if (!TaskList[idx]->pCycleFunc)
+                LOG_W(0, Func, "Task %s executes program '%s' with the VM!", TaskList[idx]->Name,
+                      TaskList[idx]->pCode->Name);
+        }
+
+        LOG_I(0, Func, "Task %s executes program '%s', %u instructions, %u nodes optimized away, %u bytes data%s",
+              TaskList[idx]->Name, TaskList[idx]->pCode->Name, TaskList[idx]->pCode->NbOfInstr,
+              TaskList[idx]->pCode->NbOfOptNodes, TaskList[idx]->pCode->MemSize,
+              TaskList[idx]->pCycleFunc ? ", generated C code" : "");
+    }
+
+    mist_PrgCachePurge(FALSE);
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Releases the ST programs of all tasks which are registered in the
+*        global task list. Undo for Task_PrgLoadAll, the tasks must have
+*        been deleted before. The compiled programs remain in the program
+*        cache for the next configuration.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Task_PrgFreeAll(VOID)
+{
+    UINT32  idx;
+
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        TaskList[idx]->pCycleFunc = NULL;
+        mist_VmDelete(TaskList[idx]->pVm);
+        TaskList[idx]->pVm = NULL;
+        mist_PrgCacheRelease(TaskList[idx]->pCode);
+        TaskList[idx]->pCode = NULL;
+
+        /* Program of an online change, taken over or not */
+        TaskList[idx]->SwapReq = FALSE;
+        Task_PrgRetire(TaskList[idx]);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Releases the second program slot of a task, used by the online
+*        change: either the program prepared for the switch or the program
+*        executed before the switch. Must not be called while a switch is
+*        requested.
+*
+* @param[in]  pointer to task properties data structure
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Task_PrgRetire(TASK_PROPERTIES * pTaskData)
+{
+    pTaskData->pNewCycleFunc = NULL;
+    mist_VmDelete(pTaskData->pNewVm);
+    pTaskData->pNewVm = NULL;
+    mist_PrgCacheRelease(pTaskData->pNewCode);
+    pTaskData->pNewCode = NULL;
+    free(pTaskData->pXfer);
+    pTaskData->pXfer = NULL;
+    pTaskData->NbOfXfers = 0;
+}
+
+/**
+********************************************************************************
+* @brief Switches a task to the program prepared by the online change.
+*        Called by the task itself between two cycles. Unchanged variables
+*        keep their values, the old program remains in the second slot to
+*        be released by mist_AppOnlineChange. Only copies memory, so the
+*        switch costs no more than the copy of the data area.
+*
+* @param[in]  pointer to task properties data structure
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Task_PrgSwap(TASK_PROPERTIES * pTaskData)
+{
+    MIST_CODE *pCode = pTaskData->pCode;
+    MIST_VM *pVm = pTaskData->pVm;
+    VOIDFUNCPTR pCycleFunc = pTaskData->pCycleFunc;
+    UINT32  Start = m_GetProcTime();
+
+    MIST_BARRIER();
+    if (pVm && pTaskData->pNewVm)
+        mist_VmXfer(pTaskData->pNewVm, pVm, pTaskData->pXfer, pTaskData->NbOfXfers);
+
+    pTaskData->pCode = pTaskData->pNewCode;
+    pTaskData->pVm = pTaskData->pNewVm;
+    pTaskData->pCycleFunc = pTaskData->pNewCycleFunc;
+    pTaskData->pNewCode = pCode;
+    pTaskData->pNewVm = pVm;
+    pTaskData->pNewCycleFunc = pCycleFunc;
+
+    pTaskData->SwapTime = m_GetProcTime() - Start;
+    MIST_TRC(pTaskData->pTrc, MIST_TRC_SWAP, 0, pTaskData->SwapTime);
+    MIST_BARRIER();
+    pTaskData->SwapReq = FALSE;
+}
+
+/**
+********************************************************************************
+* @brief Initializes infrastructure for task timing
+*
+* @param[in]  pointer to task properties data structure
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Task_InitTiming(TASK_PROPERTIES * pTaskData)
+{
+    CHAR    Func[] = "Task_InitTiming";
+
+    if (!pTaskData)
+    {
+        LOG_E(0, Func, "Invalid input pointer!");
+        return (ERROR);
+    }
+
+    /* independent of timing model */
+    pTaskData->NbOfCycleBacklogs = 0;
+    pTaskData->NbOfSkippedCycles = 0;
+    memset(&pTaskData->Stats, 0, sizeof(pTaskData->Stats));
+
+    /* depending on timing model */
+    switch (pTaskData->TimeBase)
+    {
+            /* Tick based timing */
+        case 0:
+            return (Task_InitTiming_Tick(pTaskData));
+            /* Sync based timing */
+        case 1:
+            pTaskData->SyncSessionId = ERROR;
+            return (Task_InitTiming_Sync(pTaskData));
+            /* High resolution timer, tick as fall back */
+        case 2:
+            if (Task_InitTiming_HighRes(pTaskData) == OK)
+                return (OK);
+            LOG_W(0, Func, "Task '%s' uses tick timing!", pTaskData->Name);
+            pTaskData->TimeBase = 0;
+            return (Task_InitTiming_Tick(pTaskData));
+            /* Undefined */
+        default:
+            LOG_E(0, Func, "Unknown timing model!");
+            return (ERROR);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Initializes infrastructure for task timing with tick timer
+*
+* @param[in]  pointer to task properties data structure
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Task_InitTiming_Tick(TASK_PROPERTIES * pTaskData)
+{
+    REAL32  TmpReal;
+    CHAR    Func[] = "Task_InitTiming_Tick";
+
+    if (!pTaskData)
+    {
+        LOG_E(0, Func, "Invalid input pointer!");
+        return (ERROR);
+    }
+
+    /*
+     * Calculate and check cycle time in ticks as integer value
+     */
+    TmpReal = ((pTaskData->CycleTime_ms / 1000.0) * sysClkRateGet()) + 0.5;
+    pTaskData->CycleTime = (UINT32) TmpReal;
+
+    /* If cycle time is less than a full tick */
+    if (pTaskData->CycleTime < 1)
+    {
+        pTaskData->CycleTime = 1;
+        LOG_W(0, Func, "Cycle time too small for tick rate %d, increased to 1 tick!",
+              sysClkRateGet());
+    }
+
+    /* Nominal period for the cycle statistics */
+    pTaskData->Stats.Period = (UINT32) (((UINT64) pTaskData->CycleTime * 1000000) / sysClkRateGet());
+
+    /* Take first cycle start time stamp */
+    pTaskData->PrevCycleStart = tickGet();
+
+    /* Initialize cycle time grid */
+    pTaskData->NextCycleStart = tickGet() + pTaskData->CycleTime;
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Initializes infrastructure for task timing with sync event.
+*
+* @param[in]  pointer to task properties data structure
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. Error
+*******************************************************************************/
+MLOCAL SINT32 Task_InitTiming_Sync(TASK_PROPERTIES * pTaskData)
+{
+    SINT32  ret;
+    REAL32  SyncCycle_us, TmpReal;
+    SYS_CPUINFO CpuInfo;
+    CHAR    Func[] = "Task_InitTiming_Sync";
+
+    if (!pTaskData)
+    {
+        LOG_E(0, Func, "Invalid input pointer!");
+        return (ERROR);
+    }
+
+    /* Start sync session for this module (multiple starts are possible) */
+    pTaskData->SyncSessionId = mio_StartSyncSession(mist_AppName);
+    if (pTaskData->SyncSessionId < 0)
+    {
+        LOG_E(0, Func, "Could not start sync session for task '%s'!", pTaskData->Name);
+        return (ERROR);
+    }
+
+    /* Get cpu info, contains sync timer settings (always returns OK) */
+    sys_GetCpuInfo(&CpuInfo);
+
+    /* Calculate and check period time of sync timer */
+    SyncCycle_us = CpuInfo.pExtCpuInfo->SyncHigh + CpuInfo.pExtCpuInfo->SyncLow;
+    if ((SyncCycle_us == 0) || (CpuInfo.pExtCpuInfo->SyncHigh == 0)
+        || (CpuInfo.pExtCpuInfo->SyncLow == 0))
+    {
+        LOG_E(0, Func, "System sync configuration invalid, can't use sync for task '%s'!",
+              pTaskData->Name);
+        return (ERROR);
+    }
+
+    /* Calculate multiple of specified task cycle time */
+    TmpReal = ((pTaskData->CycleTime_ms * 1000) / SyncCycle_us) + 0.5;
+    pTaskData->CycleTime = TmpReal;
+
+    /* If cycle time is less than a full sync */
+    if (pTaskData->CycleTime < 1)
+    {
+        pTaskData->CycleTime = 1;
+        LOG_W(0, Func, "Cycle time too small for sync cycle %d us, increased to 1 sync!",
+              SyncCycle_us);
+    }
+
+    /* Nominal period for the cycle statistics */
+    pTaskData->Stats.Period = (UINT32) (pTaskData->CycleTime * SyncCycle_us);
+
+    /*
+     * For application tasks,
+     * MIO_SYNC_IN (falling edge of sync signal) is the normal option.
+     */
+    pTaskData->SyncEdge = MIO_SYNC_IN;
+
+    /*
+     * Attach semGive to sync event
+     * -> semGive will be called according to the sync attach settings below.
+     * -> semGive will give the semaphore pTaskData->CycleSema.
+     * -> the task will be triggered as soon as this semaphore is given.
+     */
+    ret = mio_AttachSync(pTaskData->SyncSessionId,      /* from mio_StartSyncSession */
+                         pTaskData->SyncEdge,   /* selection of sync edge */
+                         pTaskData->CycleTime,  /* number of sync cycles */
+                         (VOID *) semGive,      /* register semGive as ISR */
+                         (UINT32) pTaskData->CycleSema);        /* semaphore id for semGive */
+    if (ret < 0)
+    {
+        LOG_W(0, Func, "Could not attach to sync for task '%s'!", pTaskData->Name);
+        if (pTaskData->SyncSessionId >= 0)
+        	mio_StopSyncSession(pTaskData->SyncSessionId);
+        pTaskData->SyncSessionId = ERROR;
+        return (ERROR);
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Initializes infrastructure for task timing with the high resolution
+*        timer, for cycle times below a tick.
+*        The auxiliary clock gives the cycle semaphore (Task_HrIsr()), the
+*        cycle time is a number of its periods. The first task sets the
+*        rate of the clock to its cycle time, further tasks use multiples.
+*        The host build waits for absolute deadlines with clock_nanosleep(),
+*        the cycle time is in ns.
+*
+* @param[in]  pointer to task properties data structure
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Task_InitTiming_HighRes(TASK_PROPERTIES * pTaskData)
+{
+    UINT32  Period_us;
+#if !defined(__linux__)
+    UINT32  Rate;
+    SINT32  Lock;
+#endif
+    CHAR    Func[] = "Task_InitTiming_HighRes";
+
+    if (!pTaskData)
+    {
+        LOG_E(0, Func, "Invalid input pointer!");
+        return (ERROR);
+    }
+
+    Period_us = (UINT32) (pTaskData->CycleTime_ms * 1000.0 + 0.5);
+    if (Period_us < 1)
+        Period_us = 1;
+
+#if defined(__linux__)
+    /* Deadlines in ns, the first cycle has just started */
+    pTaskData->CycleTime = Period_us * 1000;
+    pTaskData->HrDeadline = Task_HrNow() + pTaskData->CycleTime;
+    pTaskData->Stats.Period = Period_us;
+#else
+    if (NbOfHrTasks >= TASK_HR_MAX)
+    {
+        LOG_E(0, Func, "Too many tasks use the high resolution timer!");
+        return (ERROR);
+    }
+
+    /* The first task sets the rate of the timer */
+    if (!HrRate)
+    {
+        Rate = (UINT32) (1000000.0 / Period_us + 0.5);
+        if ((sysAuxClkConnect((FUNCPTR) Task_HrIsr, 0) == ERROR) || (sysAuxClkRateSet(Rate) == ERROR))
+        {
+            LOG_E(0, Func, "High resolution timer does not support %u Hz for task '%s'!", Rate, pTaskData->Name);
+            return (ERROR);
+        }
+        HrRate = Rate;
+        sysAuxClkEnable();
+    }
+
+    /* Calculate cycle time in timer periods */
+    pTaskData->CycleTime = (UINT32) (((REAL64) Period_us * HrRate) / 1000000.0 + 0.5);
+    if (pTaskData->CycleTime < 1)
+        pTaskData->CycleTime = 1;
+    pTaskData->Stats.Period = (UINT32) (((UINT64) pTaskData->CycleTime * 1000000) / HrRate);
+    if (pTaskData->Stats.Period != Period_us)
+        LOG_W(0, Func, "Cycle time of task '%s' is %u us, %u periods of the timer with %u Hz!", pTaskData->Name,
+              pTaskData->Stats.Period, pTaskData->CycleTime, HrRate);
+
+    pTaskData->HrCount = 0;
+    pTaskData->HrCycles = 0;
+    pTaskData->NextCycleStart = 0;
+
+    /* Registration last, the timer may signal the first cycle right away */
+    Lock = intLock();
+    HrTaskList[NbOfHrTasks++] = pTaskData;
+    intUnlock(Lock);
+#endif
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Releases the infrastructure for task timing. Undo for
+*        Task_InitTiming, the task must not wait for its cycle any more.
+*
+* @param[in]  pointer to task properties data structure
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Task_ExitTiming(TASK_PROPERTIES * pTaskData)
+{
+    UINT32  i;
+    SINT32  Lock;
+    CHAR    Func[] = "Task_ExitTiming";
+
+    /* Stop sync session if present and detach ISR */
+    if (pTaskData->SyncSessionId >= 0)
+    {
+        LOG_I(0, Func, "Stopping sync session for task %s", pTaskData->Name);
+        mio_StopSyncSession(pTaskData->SyncSessionId);
+        pTaskData->SyncSessionId = ERROR;
+    }
+
+    /* Detach from the high resolution timer, the last task stops it */
+    for (i = 0; i < NbOfHrTasks; i++)
+    {
+        if (HrTaskList[i] != pTaskData)
+            continue;
+
+        Lock = intLock();
+        HrTaskList[i] = HrTaskList[--NbOfHrTasks];
+        intUnlock(Lock);
+
+#if !defined(__linux__)
+        if (!NbOfHrTasks)
+        {
+            sysAuxClkDisable();
+            HrRate = 0;
+        }
+#endif
+        break;
+    }
+}
+
+#if defined(__linux__)
+/**
+********************************************************************************
+* @brief Time stamp of the high resolution timer of the host build.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     monotonic time in ns
+*******************************************************************************/
+MLOCAL UINT64 Task_HrNow(VOID)
+{
+    struct timespec Now;
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return ((UINT64) Now.tv_sec * 1000000000 + Now.tv_nsec);
+}
+#else
+/**
+********************************************************************************
+* @brief ISR of the high resolution timer, counts the periods of all tasks
+*        using it and gives their cycle semaphores.
+*
+* @param[in]  Arg      not used
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Task_HrIsr(int Arg)
+{
+    TASK_PROPERTIES *pTaskData;
+    UINT32  i;
+
+    for (i = 0; i < NbOfHrTasks; i++)
+    {
+        pTaskData = HrTaskList[i];
+        if (++pTaskData->HrCount >= pTaskData->CycleTime)
+        {
+            pTaskData->HrCount = 0;
+            pTaskData->HrCycles++;
+            semGive(pTaskData->CycleSema);
+        }
+    }
+}
+#endif
+
+/**
+********************************************************************************
+* @brief Performs the necessary wait time for the specified cycle.
+*        The wait time results from cycle time minus own run time.
+*        A cycle start which is already overdue is handled according to
+*        the overrun policy of the task, see Task_Overrun().
+*        NOTE: The time unit depends on the used time base (ticks, sync periods
+*        or periods of the high resolution timer, ns on the host build).
+*
+* @param[in]  pointer to task properties data structure
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Task_WaitCycle(TASK_PROPERTIES * pTaskData)
+{
+    UINT32  PrevCycleStart = 0;
+    UINT32  NextCycleStart = 0;
+    UINT32  CycleTime = 0;
+    UINT32  TimeToWait = 0;
+    UINT32  SkipNow = 0;
+    UINT32  TimeNow = 0;
+    UINT32  Backlog = 0;
+    UINT32  CyclesSkipped = 0;
+    UINT32  Action;
+    UINT32  Abort = FALSE;
+#if defined(__linux__)
+    UINT64  Deadline = 0;
+    UINT64  Now;
+    UINT64  Late;
+    struct timespec Wake;
+#else
+    UINT32  Due;
+    SINT32  Lock;
+#endif
+
+    /* Emergency behavior in case of missing task settings */
+    if (!pTaskData)
+    {
+        LOG_E(0, "Task_WaitCycle", "Invalid input pointer, using alternative taskDelay(1000)");
+        taskDelay(1000);
+        return;
+    }
+
+    /* Record the execution time of the cycle */
+    TASK_SEQ_BEGIN(pTaskData);
+    Task_StatsEnd(pTaskData);
+    TASK_SEQ_END(pTaskData);
+
+    /* Trigger software watchdog if existing */
+    if (pTaskData->WdogId)
+        sys_WdogTrigg(pTaskData->WdogId);
+
+    /*
+     * Online change: switch to the prepared program at the end of the cycle,
+     * before the wait time is calculated, so the next cycle starts on time.
+     */
+    if (pTaskData->SwapReq)
+        Task_PrgSwap(pTaskData);
+
+    /*
+     * Handle tick based cycle timing ("Time" unit is ticks)
+     */
+    if (pTaskData->TimeBase == 0)
+    {
+        /* Use local variables to make calculation as compressed as possible */
+        PrevCycleStart = pTaskData->PrevCycleStart;
+        NextCycleStart = pTaskData->NextCycleStart;
+        CycleTime = pTaskData->CycleTime;
+
+        /* Calculate the time to wait before the next cycle can start. */
+        NextCycleStart = PrevCycleStart + CycleTime;
+        PrevCycleStart = NextCycleStart;
+
+        /*
+         * As soon as the current time stamp has been taken,
+         * the code until semTake processing should be kept as short as possible,
+         * so that the probability of being interrupted is as small as possible.
+         */
+        TimeNow = tickGet();
+
+        /* This is the amount of until the next scheduled cycle start. */
+        TimeToWait = NextCycleStart - TimeNow;
+
+        /* Limit wait time to minimum 1 */
+        if (!TimeToWait)
+            TimeToWait++;
+
+        /*
+         * As long as the next scheduled cycle start lies in the future,
+         * the resulting wait time must be smaller than the cycle time.
+         * If the resulting wait time is higher than the cycle time,
+         * the next scheduled cycle start already lies in the past.
+         * This means that there is a cycle backlog.
+         * NOTE: since the wait time is an unsigned value, a negative difference
+         * is being interpreted as a large positive value.
+         */
+        if (TimeToWait > CycleTime)
+        {
+            /* Calculate cycle backlog */
+            Backlog = TimeNow - NextCycleStart;
+
+            /* Skip cycles or restart the timing as the policy requests */
+            Action = Task_Overrun(pTaskData, Backlog, &SkipNow);
+            if (Action == MIST_OVR_ABORT)
+                Abort = TRUE;
+            if (Action == MIST_OVR_PHASE)
+                NextCycleStart = TimeNow;
+            else
+                NextCycleStart = NextCycleStart + (SkipNow * CycleTime);
+            PrevCycleStart = NextCycleStart;
+            CyclesSkipped += SkipNow;
+
+            /*
+             * Recalculate the wait time. If the cycle is still overdue,
+             * try to catch up, but still use a small task delay.
+             */
+            TimeToWait = NextCycleStart - TimeNow;
+            if (!TimeToWait || (TimeToWait > CycleTime))
+                TimeToWait = 1;
+        }
+    }
+
+    /*
+     * Handle sync based cycle timing ("Time" unit is syncs)
+     */
+    else if (pTaskData->TimeBase == 1)
+    {
+        /*
+         * In case of sync timing, it is assumed, that the sync interrupt
+         * directly determines the cycle time.
+         * It would also be possible to use a multiple of sync's as cycle time.
+         * The logic necessary for that is not yet implemented.
+         */
+        TimeToWait = WAIT_FOREVER;
+    }
+
+    /*
+     * Handle high resolution timing ("Time" unit is timer periods, ns on the host)
+     */
+    else if (pTaskData->TimeBase == 2)
+    {
+        CycleTime = pTaskData->CycleTime;
+#if defined(__linux__)
+        /*
+         * The deadlines are absolute, each one lies exactly one cycle time
+         * after the previous one, so the wake up latency does not drift.
+         * A backlog is handled like with tick timing.
+         */
+        Deadline = pTaskData->HrDeadline;
+        Now = Task_HrNow();
+        if (Now > Deadline)
+        {
+            Late = Now - Deadline;
+            Backlog = (Late > 0xFFFFFFFF) ? 0xFFFFFFFF : (UINT32) Late;
+            Action = Task_Overrun(pTaskData, Backlog, &SkipNow);
+            if (Action == MIST_OVR_ABORT)
+                Abort = TRUE;
+            if (Action == MIST_OVR_PHASE)
+                Deadline = Now;
+            else
+                Deadline += (UINT64) SkipNow * CycleTime;
+            CyclesSkipped += SkipNow;
+        }
+        pTaskData->HrDeadline = Deadline + CycleTime;
+#else
+        /*
+         * The timer ISR gives the semaphore and counts the cycles.
+         * If the cycle is already signalled, the task has overrun.
+         */
+        NextCycleStart = pTaskData->NextCycleStart + 1;
+        TimeToWait = WAIT_FOREVER;
+        Due = pTaskData->HrCycles - NextCycleStart;
+        if ((SINT32) Due >= 0)
+        {
+            /* Late by the periods counted so far, rounded up */
+            Backlog = Due * CycleTime + pTaskData->HrCount + 1;
+            Action = Task_Overrun(pTaskData, Backlog, &SkipNow);
+            if (Action == MIST_OVR_ABORT)
+                Abort = TRUE;
+            if (Action == MIST_OVR_PHASE)
+            {
+                Lock = intLock();
+                pTaskData->HrCount = 0;
+                NextCycleStart = pTaskData->HrCycles;
+                intUnlock(Lock);
+            }
+            else
+                NextCycleStart += SkipNow;
+            CyclesSkipped += SkipNow;
+
+            /* The semaphore may still be given, start at once if the cycle is due */
+            semTake(pTaskData->CycleSema, NO_WAIT);
+            if ((SINT32) (pTaskData->HrCycles - NextCycleStart) >= 0)
+                TimeToWait = NO_WAIT;
+        }
+#endif
+    }
+
+    /* Register cycle end in system timing statistics */
+    sys_CycleEnd();
+
+    /*
+     * Wait for the calculated number of time units
+     * by taking the cycle semaphore with a calculated timeout
+     */
+#if defined(__linux__)
+    if (pTaskData->TimeBase == 2)
+    {
+        Wake.tv_sec = Deadline / 1000000000;
+        Wake.tv_nsec = Deadline % 1000000000;
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &Wake, NULL) == EINTR)
+            ;
+    }
+    else
+#endif
+    semTake(pTaskData->CycleSema, TimeToWait);
+
+    /*
+     * Waiting for the cycle semaphore has now timed out in case of tick
+     * or been given in case of sync.
+     */
+
+    /* Register cycle start in system timing statistics */
+    sys_CycleStart();
+
+    /*
+     * The above logic uses local variables in order to keep the processing short.
+     * Some of these local variables must be rescued for the next call of this
+     * function.
+     */
+    pTaskData->PrevCycleStart = PrevCycleStart;
+    pTaskData->NextCycleStart = NextCycleStart;
+    TASK_SEQ_BEGIN(pTaskData);
+    pTaskData->NbOfSkippedCycles += CyclesSkipped;
+    if (Backlog)
+        pTaskData->NbOfCycleBacklogs++;
+
+    /* Overrun policy "abort": the task is stopped like on a module stop */
+    if (Abort)
+        pTaskData->Aborted = TRUE;
+    TASK_SEQ_END(pTaskData);
+    if (Abort)
+        LOG_E(0, "Task_WaitCycle", "Stopping task '%s' due to cycle overrun, restart the module to continue",
+              pTaskData->Name);
+
+    /*
+     * Consideration of software module state
+     * If the module is in stop or eoi state,
+     * all cyclic tasks of this module shall be stopped.
+     * If the software module receives the RpcStart call,
+     * it will give the state semaphore, and all tasks will continue.
+     */
+    if (pTaskData->Aborted || (mist_ModState == RES_S_STOP) || (mist_ModState == RES_S_EOI))
+    {
+        /* Disable software watchdog if present */
+        if (pTaskData->WdogId)
+            sys_WdogDisable(pTaskData->WdogId);
+
+        if (!pTaskData->Aborted)
+            LOG_I(0, "Task_WaitCycle", "Stopping task '%s' due to module stop", pTaskData->Name);
+
+        /* The stop is not recorded as start jitter */
+        pTaskData->Stats.CycleStart = 0;
+
+        /*
+         * semaphore will be given by SMI server with calls
+         * RpcStart or RpcEndOfInit
+         */
+        semTake(mist_StateSema, WAIT_FOREVER);
+
+        /* The cycles missed while stopped are not an overrun */
+        TASK_SEQ_BEGIN(pTaskData);
+        pTaskData->Aborted = FALSE;
+        TASK_SEQ_END(pTaskData);
+        Task_PhaseReset(pTaskData);
+    }
+
+    /* Record the start jitter of the next cycle */
+    TASK_SEQ_BEGIN(pTaskData);
+    Task_StatsStart(pTaskData);
+    TASK_SEQ_END(pTaskData);
+}
+
+/**
+********************************************************************************
+* @brief Handles a cycle start which is already overdue according to the
+*        overrun policy of the task and records an overrun event:
+*        - MIST_OVR_CATCHUP: the cycles are run at once as long as the
+*          backlog does not exceed CatchUpMax cycles (0 = no limit),
+*          a larger backlog is dropped up to the next cycle start
+*        - MIST_OVR_SKIP: the missed cycles are dropped, the latest one
+*          is run at once
+*        - MIST_OVR_PHASE: like MIST_OVR_SKIP, but the following cycles
+*          are timed from now on
+*        - MIST_OVR_ABORT: the task stops its cycles
+*        The event is written without lock, see mist_EvtRead(). If its
+*        entry is still being written by a task the ring has lapped, the
+*        event is dropped and counted as lost by the reader.
+*
+* @param[in]  pTaskData   pointer to task properties data structure
+* @param[in]  Late        time since the scheduled cycle start (time units of the task)
+* @param[out] pSkip       number of cycles to drop
+*
+* @retval     action to take, MIST_OVR_xxx
+*******************************************************************************/
+MLOCAL UINT32 Task_Overrun(TASK_PROPERTIES * pTaskData, UINT32 Late, UINT32 * pSkip)
+{
+    MIST_EVENT *pEvt;
+    UINT32  CycleTime = pTaskData->CycleTime;
+    UINT32  Policy = pTaskData->OverrunPolicy;
+    UINT32  Cycles = Late / CycleTime;
+    UINT32  Skip = 0;
+    UINT32  Seq;
+    UINT32  Old;
+    UINT32  Late_us = (UINT32) (((UINT64) Late * pTaskData->Stats.Period) / CycleTime);
+
+    switch (Policy)
+    {
+        case MIST_OVR_SKIP:
+        case MIST_OVR_PHASE:
+        case MIST_OVR_ABORT:
+            Skip = Cycles;
+            break;
+
+        default:
+            /* Late > CatchUpMax * CycleTime, without overflow */
+            Policy = MIST_OVR_CATCHUP;
+            if (pTaskData->CatchUpMax && (Late - 1) / CycleTime >= pTaskData->CatchUpMax)
+                Skip = Cycles + 1;
+            break;
+    }
+
+    /* Reserve an entry, it is invalid until Seq is set */
+    Seq = MIST_FETCH_INC(&EvtHead) + 1;
+    pEvt = &EvtRing[Seq & (TASK_EVT_RING - 1)];
+    Old = pEvt->Seq;
+    if ((Old != TASK_EVT_BUSY) && MIST_CAS(&pEvt->Seq, Old, TASK_EVT_BUSY))
+    {
+        MIST_BARRIER();
+        pEvt->Time = time(NULL);
+        pEvt->ProcTime = m_GetProcTime();
+        strncpy(pEvt->TaskName, pTaskData->Name, MIST_EVT_NAMELEN - 1);
+        pEvt->TaskName[MIST_EVT_NAMELEN - 1] = 0;
+        pEvt->Policy = Policy;
+        pEvt->Late = Late_us;
+        pEvt->Skipped = Skip;
+        MIST_BARRIER();
+        pEvt->Seq = Seq;
+    }
+
+    MIST_TRC(pTaskData->pTrc, MIST_TRC_OVERRUN, Policy, Late_us);
+
+    *pSkip = Skip;
+    return (Policy);
+}
+
+/**
+********************************************************************************
+* @brief Restarts the cycle timing of a task from now on, e.g. after the
+*        task has been stopped. The cycles missed are not recorded.
+*
+* @param[in]  pointer to task properties data structure
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Task_PhaseReset(TASK_PROPERTIES * pTaskData)
+{
+#if !defined(__linux__)
+    SINT32  Lock;
+#endif
+
+    if (pTaskData->TimeBase == 0)
+    {
+        pTaskData->PrevCycleStart = tickGet();
+        pTaskData->NextCycleStart = pTaskData->PrevCycleStart;
+    }
+    else if (pTaskData->TimeBase == 2)
+    {
+#if defined(__linux__)
+        pTaskData->HrDeadline = Task_HrNow() + pTaskData->CycleTime;
+#else
+        Lock = intLock();
+        pTaskData->HrCount = 0;
+        pTaskData->NextCycleStart = pTaskData->HrCycles;
+        intUnlock(Lock);
+#endif
+    }
+}
+
+/**
+********************************************************************************
+* @brief Records the execution time of a cycle in the cycle statistics.
+*        Called by the task at the end of each cycle, O(1) and without lock:
+*        the task is the only writer, a restart requested via SVI is
+*        executed here as well.
+*
+* @param[in]  pointer to task properties data structure
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Task_StatsEnd(TASK_PROPERTIES * pTaskData)
+{
+    TASK_STATS *pStats = &pTaskData->Stats;
+    UINT32  Period = pStats->Period;
+    UINT32  CycleStart = pStats->CycleStart;
+    UINT32  ExecTime;
+    UINT32  Bucket;
+
+    if (pStats->Reset)
+    {
+        memset(pStats, 0, sizeof(*pStats));
+        pStats->Period = Period;
+        pStats->CycleStart = CycleStart;
+    }
+
+    /* No cycle start recorded yet */
+    if (!CycleStart)
+        return;
+
+    ExecTime = m_GetProcTime() - CycleStart;
+
+    /* Histogram bucket = number of significant bits */
+#ifdef __GNUC__
+    Bucket = ExecTime ? 32 - __builtin_clz(ExecTime) : 0;
+#else
+    for (Bucket = 0; (Bucket < 32) && (ExecTime >> Bucket); Bucket++)
+        ;
+#endif
+    if (Bucket >= TASK_HIST_BUCKETS)
+        Bucket = TASK_HIST_BUCKETS - 1;
+    pStats->Hist[Bucket]++;
+
+    if (!pStats->NbOfCycles || (ExecTime < pStats->ExecMin))
+        pStats->ExecMin = ExecTime;
+    if (ExecTime > pStats->ExecMax)
+        pStats->ExecMax = ExecTime;
+    pStats->ExecSum += ExecTime;
+    pStats->NbOfCycles++;
+    pStats->ExecMean = (UINT32) (pStats->ExecSum / pStats->NbOfCycles);
+    pStats->ExecTime = ExecTime;
+}
+
+/**
+********************************************************************************
+* @brief Records the start of a cycle in the cycle statistics. The jitter is
+*        the deviation of the time since the previous cycle start from the
+*        nominal period, skipped cycles show up as jitter as well.
+*        Called by the task at the start of each cycle, O(1) and without lock.
+*
+* @param[in]  pointer to task properties data structure
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Task_StatsStart(TASK_PROPERTIES * pTaskData)
+{
+    TASK_STATS *pStats = &pTaskData->Stats;
+    UINT32  Now = m_GetProcTime();
+    UINT32  Jitter;
+
+    if (pStats->CycleStart)
+    {
+        Jitter = Now - pStats->CycleStart;
+        Jitter = (Jitter > pStats->Period) ? Jitter - pStats->Period : pStats->Period - Jitter;
+
+        if (Jitter > pStats->JitterMax)
+            pStats->JitterMax = Jitter;
+        pStats->JitterSum += Jitter;
+        pStats->NbOfStarts++;
+        pStats->JitterMean = (UINT32) (pStats->JitterSum / pStats->NbOfStarts);
+        pStats->Jitter = Jitter;
+    }
+    pStats->CycleStart = Now;
+}
+
+/**
+********************************************************************************
+* @brief Main entry function of the timing benchmark task, waits for
+*        BenchCycles cycles without any load.
+*
+* @param[in]  pointer to task properties data structure
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Bench_Main(TASK_PROPERTIES * pTaskData)
+{
+    UINT32  i;
+
+    Task_SetAffinity(pTaskData);
+    for (i = 0; (i < BenchCycles) && !pTaskData->Quit; i++)
+        Task_WaitCycle(pTaskData);
+}
+
+/**
+********************************************************************************
+* @brief Test function: compares the cycle jitter of the time bases tick,
+*        sync and high resolution timer. A task with the priority and the
+*        core of the control task waits for the given number of cycles with
+*        each time base, the cycle statistics are printed. The module must be
+*        running.
+*        Example: mist_TimingBench 500, 10000
+*
+* @param[in]  CycleTime_us  cycle time in us, 0 = 1000
+* @param[in]  Cycles        number of cycles per time base, 0 = 1000
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_TimingBench(UINT32 CycleTime_us, UINT32 Cycles)
+{
+    MLOCAL const CHAR *const Names[] = { "Tick", "Sync", "HighRes" };
+    TASK_PROPERTIES Bench;
+    UINT32  TimeBase;
+    UINT32  RequestTime;
+
+    if (!CycleTime_us)
+        CycleTime_us = 1000;
+    if (!Cycles)
+        Cycles = 1000;
+    BenchCycles = Cycles;
+
+    for (TimeBase = 0; TimeBase < 3; TimeBase++)
+    {
+        /* Settings of the control task, no watchdog and no program */
+        memset(&Bench, 0, sizeof(Bench));
+        snprintf(Bench.Name, sizeof(Bench.Name), "aMIST_Bench");
+        Bench.Priority = NbOfTasks ? TaskList[0]->Priority : mist_BaseParams.DefaultPriority;
+        Bench.CoreUsed = NbOfTasks ? TaskList[0]->CoreUsed : -1;
+        Bench.CycleTime_ms = CycleTime_us / 1000.0;
+        Bench.TimeBase = TimeBase;
+        Bench.OverrunPolicy = TaskDefaults.OverrunPolicy;
+        Bench.CatchUpMax = TaskDefaults.CatchUpMax;
+        Bench.SyncSessionId = ERROR;
+        Bench.TaskId = ERROR;
+
+        Bench.CycleSema = semBCreate(SEM_Q_PRIORITY, SEM_EMPTY);
+        if (!Bench.CycleSema)
+            return (ERROR);
+
+        if ((Task_InitTiming(&Bench) < 0) || (Bench.TimeBase != TimeBase))
+        {
+            printf("%-8s not available\n", Names[TimeBase]);
+            Task_ExitTiming(&Bench);
+            semDelete(Bench.CycleSema);
+            continue;
+        }
+
+        Bench.TaskId = sys_TaskSpawn(mist_AppName, Bench.Name, Bench.Priority, VX_FP_TASK, 10000,
+                                     (FUNCPTR) Bench_Main, &Bench);
+        if (Bench.TaskId == ERROR)
+        {
+            Task_ExitTiming(&Bench);
+            semDelete(Bench.CycleSema);
+            return (ERROR);
+        }
+
+        /* Wait for the end of the task, at most twice the expected time */
+        RequestTime = m_GetProcTime();
+        while (taskIdVerify(Bench.TaskId) == OK)
+        {
+            taskDelay(1);
+            if ((m_GetProcTime() - RequestTime) / 2 > (UINT64) Cycles * Bench.Stats.Period + 1000000)
+            {
+                Bench.Quit = TRUE;
+                semGive(Bench.CycleSema);
+            }
+        }
+
+        printf("%-8s %u cycles of %u us: jitter mean %u us, max %u us, %u backlogs, %u cycles skipped\n",
+               Names[TimeBase], Bench.Stats.NbOfStarts, Bench.Stats.Period, Bench.Stats.JitterMean,
+               Bench.Stats.JitterMax, Bench.NbOfCycleBacklogs, Bench.NbOfSkippedCycles);
+
+        Task_ExitTiming(&Bench);
+        semDelete(Bench.CycleSema);
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Reads overrun events of the tasks (MIST_PROC_GETEVENTS).
+*        The ring keeps the latest TASK_EVT_RING events. Seq of an entry is
+*        read before and after copying it, an entry which has been
+*        overwritten meanwhile is counted as lost. An entry which is not
+*        written yet is read with the next call if it is the latest one,
+*        otherwise it is counted as lost: it has been dropped by
+*        Task_Overrun() or its task has been stopped while writing it.
+*        No lock is taken, so the tasks are never delayed by a reader.
+*
+* @param[in]  FirstSeq    first event to read, 0 = oldest one available
+* @param[out] pEvt        buffer for up to MaxEvents events
+* @param[in]  MaxEvents   size of the buffer
+* @param[out] pNextSeq    FirstSeq for the following call
+* @param[out] pNbOfLost   events overwritten or dropped before they could be read
+*
+* @retval     number of events read
+*******************************************************************************/
+UINT32 mist_EvtRead(UINT32 FirstSeq, MIST_EVENT * pEvt, UINT32 MaxEvents, UINT32 * pNextSeq,
+                    UINT32 * pNbOfLost)
+{
+    MIST_EVENT *pSlot;
+    UINT32  Head = EvtHead;
+    UINT32  Oldest = (Head > TASK_EVT_RING) ? Head - TASK_EVT_RING + 1 : 1;
+    UINT32  Seq;
+    UINT32  SlotSeq;
+    UINT32  NbOfEvents = 0;
+    UINT32  NbOfLost = 0;
+
+    MIST_BARRIER();
+
+    if (!FirstSeq || (FirstSeq > Head + 1))
+        FirstSeq = Oldest;
+    if (FirstSeq < Oldest)
+    {
+        NbOfLost = Oldest - FirstSeq;
+        FirstSeq = Oldest;
+    }
+
+    for (Seq = FirstSeq; (Seq <= Head) && (NbOfEvents < MaxEvents); Seq++)
+    {
+        pSlot = &EvtRing[Seq & (TASK_EVT_RING - 1)];
+        SlotSeq = pSlot->Seq;
+        MIST_BARRIER();
+        pEvt[NbOfEvents] = *pSlot;
+        MIST_BARRIER();
+
+        /* Not yet written: the latest one is read with the next call */
+        if ((SlotSeq == TASK_EVT_BUSY) || (SlotSeq < Seq))
+        {
+            if (Seq == Head)
+                break;
+            NbOfLost++;
+            continue;
+        }
+
+        /* Overwritten before or while copying */
+        if ((SlotSeq != Seq) || (pSlot->Seq != Seq))
+        {
+            NbOfLost++;
+            continue;
+        }
+        NbOfEvents++;
+    }
+
+    *pNextSeq = Seq;
+    *pNbOfLost = NbOfLost;
+    return (NbOfEvents);
+}
+
+/**
+********************************************************************************
+* @brief Prints the overrun events of the tasks, to be called from the shell.
+*
+* @param[in]  FirstSeq    first event to print, 0 = oldest one available
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_EvtShow(UINT32 FirstSeq)
+{
+    MIST_EVENT Evt[16];
+    CHAR   *Names[] = { "CatchUp", "Skip", "PhaseReset", "Abort" };
+    UINT32  NbOfEvents;
+    UINT32  NbOfLost;
+    UINT32  i;
+
+    printf("%8s %10s %10s %-15s %-10s %10s %8s\n", "Seq", "Time", "ProcTime", "Task", "Policy", "Late[us]",
+           "Skipped");
+    do
+    {
+        NbOfEvents = mist_EvtRead(FirstSeq, Evt, sizeof(Evt) / sizeof(Evt[0]), &FirstSeq, &NbOfLost);
+        if (NbOfLost)
+            printf("%u events lost\n", NbOfLost);
+        for (i = 0; i < NbOfEvents; i++)
+            printf("%8u %10u %10u %-15s %-10s %10u %8u\n", Evt[i].Seq, Evt[i].Time, Evt[i].ProcTime,
+                   Evt[i].TaskName, Names[Evt[i].Policy & 3], Evt[i].Late, Evt[i].Skipped);
+    }
+    while (NbOfEvents || NbOfLost);
+}
+
+/**
+********************************************************************************
+* @brief Prints the schedulability analysis of the configured tasks with
+*        their current max. execution times, to be called from the shell.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_SchedShow(VOID)
+{
+    mist_SchedPrint(TaskList, NbOfTasks);
+}
+
+/**
+********************************************************************************
+* @brief Process image of the ST program of a task, see mist_img.c.
+*        The image is released by an online change or a restart of the
+*        tasks, which are done by the SMI server task as well.
+*
+* @param[in]  pTaskName   task name or configuration group
+* @param[out] N/A
+*
+* @retval     != NULL .. image
+* @retval     = NULL  .. no such task or program without inputs and outputs
+*******************************************************************************/
+MLOCAL MIST_IMAGE *Task_ImgFind(const CHAR * pTaskName)
+{
+    MIST_VM *pVm;
+    UINT32  idx;
+
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if (strcmp(TaskList[idx]->Name, pTaskName) && strcmp(TaskList[idx]->CfgGroup, pTaskName))
+            continue;
+        pVm = TaskList[idx]->pVm;
+        return (pVm ? pVm->pImg : NULL);
+    }
+    return (NULL);
+}
+
+/**
+********************************************************************************
+* @brief Reads a VAR_INPUT or VAR_OUTPUT variable of the ST program of a
+*        task (MIST_PROC_GETVAR). Outputs are read as of the end of the last
+*        cycle. No lock is taken, the task is never delayed by a reader.
+*
+* @param[in]  pTaskName   task name or configuration group
+* @param[in]  pVarName    variable name, case insensitive
+* @param[out] pBuf        value
+* @param[in]  Size        size of pBuf
+* @param[out] pCycle      outputs: cycle of the value, inputs: number of writes
+*
+* @retval     > 0 .. size of the variable in bytes
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_ImgGetVar(const CHAR * pTaskName, const CHAR * pVarName, VOID * pBuf, UINT32 Size, UINT32 * pCycle)
+{
+    MIST_IMAGE *pImg = Task_ImgFind(pTaskName);
+
+    if (!pImg)
+        return (ERROR);
+    return (mist_ImgRead(pImg, pVarName, pBuf, Size, pCycle));
+}
+
+/**
+********************************************************************************
+* @brief Writes a VAR_INPUT variable of the ST program of a task
+*        (MIST_PROC_SETVAR), the program gets it at its next cycle start.
+*
+* @param[in]  pTaskName   task name or configuration group
+* @param[in]  pVarName    variable name, case insensitive
+* @param[in]  pData       value
+* @param[in]  Size        size of the variable in bytes
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_ImgSetVar(const CHAR * pTaskName, const CHAR * pVarName, const VOID * pData, UINT32 Size)
+{
+    MIST_IMAGE *pImg = Task_ImgFind(pTaskName);
+
+    if (!pImg)
+        return (ERROR);
+    return (mist_ImgWrite(pImg, pVarName, pData, Size));
+}
+
+/**
+********************************************************************************
+* @brief Prints a variable of the process image of a task, to be called
+*        from the shell.
+*        Example: mist_ImgShow "ControlTask", "Setpoint"
+*
+* @param[in]  pTaskName   task name or configuration group
+* @param[in]  pVarName    variable name
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_ImgShow(CHAR * pTaskName, CHAR * pVarName)
+{
+    UINT8   Data[MIST_IMG_MAXDATA];
+    UINT32  Cycle;
+    SINT32  Size;
+    SINT32  i;
+
+    if (!pTaskName || !pVarName)
+    {
+        printf("usage: mist_ImgShow \"task\", \"variable\"\n");
+        return;
+    }
+
+    Size = mist_ImgGetVar(pTaskName, pVarName, Data, sizeof(Data), &Cycle);
+    if (Size < 0)
+    {
+        printf("%s: no variable '%s' in the process image\n", pTaskName, pVarName);
+        return;
+    }
+
+    printf("%s.%s, %d bytes, cycle %u:", pTaskName, pVarName, Size, Cycle);
+    for (i = 0; i < Size; i++)
+        printf("%s%02X", (i % 16) ? " " : "\n    ", Data[i]);
+    printf("\n");
+}
+
+/**
+********************************************************************************
+* @brief Writes the cycle traces of all tasks to a file, see mist_trc.c.
+*        Called by the SMI server (MIST_PROC_TRCDUMP) and by the panic
+*        handler, the tasks keep running.
+*
+* @param[in]  pFileName   file to be written, NULL or "" = (Trace)File
+* @param[in]  Reason      reason of the dump, MIST_TRC_R_xxx
+* @param[in]  Arg         written to the headers, panic: mode of the signal
+* @param[out] N/A
+*
+* @retval     >= 0 .. number of records written
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_AppTrcDump(const CHAR * pFileName, UINT32 Reason, UINT32 Arg)
+{
+    return (mist_TrcWrite(TaskList, NbOfTasks, pFileName, Reason, Arg));
+}
+
+/**
+********************************************************************************
+* @brief Writes the cycle traces of all tasks to a file, to be called from
+*        the shell.
+*        Example: mist_TrcDump "/cfc0/app/mist.trc"
+*
+* @param[in]  pFileName   file to be written, NULL = (Trace)File
+* @param[out] N/A
+*
+* @retval     >= 0 .. number of records written
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_TrcDump(CHAR * pFileName)
+{
+    return (mist_AppTrcDump(pFileName, MIST_TRC_R_SHELL, 0));
+}
+
+/**
+********************************************************************************
+* @brief Initializes the module configuration data structure
+*        with the values obtained in the module init.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID mist_CfgInit(VOID)
+{
+    /* Configuration file name (profile name) */
+    strncpy(mist_BaseParams.CfgFileName, mist_ProfileName, M_PATHLEN);
+
+    /* Application name */
+    strncpy(mist_BaseParams.AppName, mist_AppName, M_MODNAMELEN);
+
+    /* Line number in configuration file (used as start line for searching) */
+    mist_BaseParams.CfgLine = mist_CfgLine;
+
+    /* Worker task priority from module base parameters (BaseParms) */
+    mist_BaseParams.DefaultPriority = mist_AppPrio;
+
+    /* Debug mode from module base parameters (BaseParms) */
+    mist_BaseParams.DebugMode = mist_Debug;
+
+}
+
+/**
+********************************************************************************
+* @brief Calls all configuration read functions of the application
+*        Being called at module init by the bTask.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_CfgRead(VOID)
+{
+    SINT32  ret;
+
+    /* Initialize configuration with values taken at module init */
+    mist_CfgInit();
+
+    /* Read all task configuration settings from mconfig.ini */
+    ret = Task_CfgRead(TaskList);
+    if (ret < 0)
+        return ret;
+
+    /* Mode of the schedulability check of the tasks */
+    ret = mist_SchedCfgRead();
+    if (ret < 0)
+        return ret;
+
+    /* Cycle trace of the tasks */
+    ret = mist_TrcCfgRead();
+    if (ret < 0)
+        return ret;
+
+    /*
+     * TODO:
+     * Call other specific configuration read functions here
+     */
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Initializes the SVI-Interface.
+*        Being called at module init by the bTask.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_SviSrvInit(VOID)
+{
+    SINT32  ret;
+    UINT32  NbOfGlobVars = sizeof(SviGlobVarList) / sizeof(SVI_GLOBVAR);
+    UINT32  NbOfTaskVars = sizeof(SviTaskVarList) / sizeof(SVI_TASKVAR);
+    UINT32  i;
+    CHAR    Func[] = "mist_SviSrvInit";
+
+    /* If there are any SVI variables to be exported */
+    if (NbOfGlobVars || (NbOfTaskVars && NbOfTasks))
+    {
+        /* Initialize SVI-handler */
+        mist_SviHandle = svi_Init(mist_AppName, 0, 0);
+        if (!mist_SviHandle)
+        {
+            LOG_E(0, Func, "Could not initialize SVI server handle!");
+            return (ERROR);
+        }
+    }
+    else
+    {
+        mist_SviHandle = 0;
+        return (OK);
+    }
+
+    /* Lock of the consistency group of the task variables, see Task_SviStart() */
+    TaskSviSema = semMCreate(SEM_Q_PRIORITY | SEM_INVERSION_SAFE);
+    if (!TaskSviSema)
+    {
+        LOG_E(0, Func, "Could not create SVI semaphore!");
+        svi_DeInit(mist_SviHandle);
+        mist_SviHandle = 0;
+        return (ERROR);
+    }
+
+    /* Add the global variables from the list SviGlobVarList */
+    for (i = 0; i < NbOfGlobVars; i++)
+    {
+        ret = mist_SviAdd(SviGlobVarList[i].VarName,
+                          SviGlobVarList[i].Format, SviGlobVarList[i].Size,
+                          SviGlobVarList[i].pVar, SviGlobVarList[i].UserParam,
+                          SviGlobVarList[i].pSviStart, SviGlobVarList[i].pSviEnd);
+        if (ret)
+        {
+            LOG_E(0, Func, "Could not add SVI variable '%s'!, Error %d",
+                  SviGlobVarList[i].VarName, ret);
+            /*
+             * TODO:
+             * Decide if the module shall be de-installed in this case.
+             * If yes, return an error here.
+             */
+        }
+    }
+
+    /* Add the variables from the list SviTaskVarList for each task */
+    Task_SviAddAll();
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Adds the variables from the list SviTaskVarList for each task in
+*        TaskList[] which has no SVI variables yet. The variables of a task
+*        remain when it is removed by a new configuration, see TaskPool[].
+*        Exports the variables of the ST programs which have been loaded.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Task_SviAddAll(VOID)
+{
+    SINT32  ret;
+    UINT32  NbOfTaskVars = sizeof(SviTaskVarList) / sizeof(SVI_TASKVAR);
+    UINT32  Bit;
+    UINT32  i, idx;
+    CHAR    SviName[SVI_ADDRLEN + 1];
+    CHAR    Func[] = "Task_SviAddAll";
+
+    if (!mist_SviHandle)
+        return;
+
+    for (idx = 0; idx < NbOfTasks; idx++)
+    {
+        if (TaskList[idx]->pVm && !TaskList[idx]->pVm->pSviMap)
+            Task_SviExport(TaskList[idx], TaskList[idx]->pVm);
+
+        Bit = 1 << (TaskList[idx] - TaskPool);
+        if (TaskSviMask & Bit)
+            continue;
+        TaskSviMask |= Bit;
+
+        for (i = 0; i < NbOfTaskVars; i++)
+        {
+            snprintf(SviName, sizeof(SviName), "%s/%s",
+                     TaskList[idx]->CfgGroup[0] ? TaskList[idx]->CfgGroup : TaskList[idx]->Name,
+                     SviTaskVarList[i].VarName);
+            ret = mist_SviAdd(SviName, SviTaskVarList[i].Format, SviTaskVarList[i].Size,
+                              (UINT8 *) TaskList[idx] + SviTaskVarList[i].Offset,
+                              (UINT32) (TaskList[idx] - TaskPool), SviTaskVarList[i].pSviStart,
+                              SviTaskVarList[i].pSviEnd);
+            if (ret)
+                LOG_E(0, Func, "Could not add SVI variable '%s'!, Error %d", SviName, ret);
+        }
+    }
+}
+
+/**
+********************************************************************************
+* @brief Exports the variables of the ST program of a task to the SVI as
+*        "<task group>/<program>/<variable>", selected by the setting
+*        SviExport of the task.
+*
+* @param[in]  pTaskData   pointer to task properties data structure
+* @param[in]  pVm         program instance, not running yet
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Task_SviExport(TASK_PROPERTIES * pTaskData, MIST_VM * pVm)
+{
+    CHAR    Prefix[SVI_ADDRLEN + 1];
+
+    snprintf(Prefix, sizeof(Prefix), "%s/%s", pTaskData->CfgGroup[0] ? pTaskData->CfgGroup : pTaskData->Name,
+             pVm->pCode->Name);
+    pVm->pSviMap = mist_SviExport(Prefix, pVm->pCode, pTaskData->SviExport, pVm->pMem);
+}
+
+/**
+********************************************************************************
+* @brief Lock function of the consistency group of the task variables, see
+*        SviTaskVarList. Copies the values of the task into SviSnap, which
+*        the SVI reads until Task_SviEnd().
+*        The task is never blocked: it writes the values between two
+*        increments of SviSeq, the copy is repeated until it has not
+*        overlapped such a write (seqlock). The readers are serialized by
+*        TaskSviSema, which the task never takes.
+*        A reader of higher priority may have preempted the task inside its
+*        write, so it waits a tick after TASK_SVI_SPIN failed copies. After
+*        TASK_SVI_YIELDS ticks, e.g. if the task has been deleted while
+*        writing, the read fails.
+*
+* @param[in]  pVar        SVI variable, not used
+* @param[in]  UserParam   index of the task in TaskPool[]
+* @param[out] N/A
+*
+* @retval     = 0 .. OK, SviSnap valid until Task_SviEnd()
+* @retval     < 0 .. ERROR, no consistent copy
+*******************************************************************************/
+MLOCAL SINT32 Task_SviStart(SVI_VAR * pVar, UINT32 UserParam)
+{
+    TASK_PROPERTIES *pTaskData;
+    TASK_SVISNAP *pSnap;
+    UINT32  Seq;
+    UINT32  Spin = 0;
+    UINT32  Yields = 0;
+
+    if ((UserParam >= TASK_MAX) || !TaskSviSema || (semTake(TaskSviSema, WAIT_FOREVER) < 0))
+        return (ERROR);
+
+    pTaskData = &TaskPool[UserParam];
+    pSnap = &pTaskData->SviSnap;
+    for (;;)
+    {
+        Seq = pTaskData->SviSeq;
+        MIST_BARRIER();
+        pSnap->Stats = pTaskData->Stats;
+        pSnap->NbOfCycleBacklogs = pTaskData->NbOfCycleBacklogs;
+        pSnap->NbOfSkippedCycles = pTaskData->NbOfSkippedCycles;
+        pSnap->Aborted = pTaskData->Aborted;
+        pSnap->CoreUsed = pTaskData->CoreUsed;
+        MIST_BARRIER();
+        if (!(Seq & 1) && (Seq == pTaskData->SviSeq))
+            break;
+
+        /*
+         * The task is writing on another core or the reader has preempted it.
+         * taskDelay(0) would only let tasks of the same priority run.
+         */
+        if (++Spin >= TASK_SVI_SPIN)
+        {
+            if (++Yields > TASK_SVI_YIELDS)
+            {
+                semGive(TaskSviSema);
+                return (ERROR);
+            }
+            taskDelay(1);
+            Spin = 0;
+        }
+    }
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Release function of the consistency group of the task variables,
+*        see Task_SviStart().
+*
+* @param[in]  pVar        SVI variable, not used
+* @param[in]  UserParam   index of the task in TaskPool[]
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Task_SviEnd(SVI_VAR * pVar, UINT32 UserParam)
+{
+    semGive(TaskSviSema);
+}
+
+/**
+********************************************************************************
+* @brief Frees SVI server resources according to mist_SviSrvInit()
+*        Being called at module deinit by the bTask.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_SviSrvDeinit(VOID)
+{
+    /* If there was no or no successful SVI init */
+    if (!mist_SviHandle)
+        return;
+
+    if (svi_DeInit(mist_SviHandle) < 0)
+        LOG_E(0, "mist_SviSrvDeinit", "Could not de-initialize SVI server");
+
+    mist_SviClear();
+    mist_SviHandle = 0;
+    TaskSviMask = 0;
+
+    if (TaskSviSema)
+        semDelete(TaskSviSema);
+    TaskSviSema = NULL;
+}
+
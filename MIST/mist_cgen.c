@@ -0,0 +1,2107 @@
+/**
+********************************************************************************
+* @file     mist_cgen.c
+* @author   Bachmann electronic GmbH
+* @version  $Revision: 3.90 $ $LastChangedBy: BE $
+* @date     $LastChangeDate: 2013-06-10 11:00:00 $
+*
+* @brief    This file contains the C code generator for Structured Text (ST)
+*           programs. The syntax tree of a program compiled by mist_Compile()
+*           is translated into a C function with the entry signature of
+*           Control_Cycle(), working on the data area of a VM instance.
+*           Built with the module, the program is optimized by the cross
+*           compiler like hand written code.
+*
+*           The generated code has the semantics of the VM down to the bit:
+*           the same data layout, 32 bit integer arithmetic with wrap-around,
+*           the conversion functions of mist_vm.c, faults for array bounds
+*           and division by zero and the loop budget counted at the same
+*           backward jumps. Floating point results are identical as long as
+*           every operation is rounded to its own precision: use SSE math or
+*           -ffloat-store on x87. The generated file switches off the
+*           contraction into fused multiply-add itself (FP_CONTRACT and
+*           fp-contract=off), older PowerPC compilers need -mno-fused-madd.
+*           If a statement could raise several faults, the reported reason
+*           may differ from the VM, the data area is the same.
+*
+*           Usage:
+*           - mist_PrgGenC("/cfc0/app/plant.st", "/cfc0/app/plant_st.c")
+*             writes the C file, which is added to the module project
+*           - Backend = "C" in the configuration group of the task selects
+*             the generated function, if it is linked and has been generated
+*             from the same source, see mist_CGenFind()
+*           - mist_PrgCmpC("/cfc0/app/plant.st", 1000) runs the VM and the
+*             generated code with the same inputs, checks that the results
+*             are identical and measures the speedup
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <symLib.h>
+#include <sysSymTbl.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+
+/* Project includes */
+#include "mist_int.h"
+#include "mist_prg.h"
+#include "mist_vm.h"
+
+/* Limits of CASE statements translated to a switch */
+#define CGEN_MAXRANGE    16              /* max. number of values of a label range */
+#define CGEN_MAXCASES    1024            /* max. number of case values */
+
+/* Properties of the elementary data types in the data area */
+typedef struct CGEN_TYPE
+{
+    const CHAR *pName;                  /* C type, NULL = not supported */
+    UINT8   Cls;                        /* computation class MIST_CLS_xxx */
+    UINT8   Size;                       /* size in bytes */
+} CGEN_TYPE;
+
+/* Loop being generated, for EXIT and CONTINUE */
+typedef struct CGEN_LOOP
+{
+    struct CGEN_LOOP *pOuter;           /* enclosing loop */
+    UINT32  Id;                         /* number of the loop, part of its labels */
+    BOOL    ContUsed;                   /* label L<Id>_cont is needed */
+    BOOL    ExitUsed;                   /* label L<Id>_exit is needed */
+} CGEN_LOOP;
+
+/* Generator state */
+typedef struct CGEN
+{
+    FILE   *pFile;                      /* output file */
+    const MIST_POU *pPou;               /* program being generated */
+    UINT32  Indent;                     /* indentation level of the next line */
+    UINT32  NbOfLoops;                  /* loops generated so far */
+    CGEN_LOOP *pLoop;                   /* innermost loop */
+    BOOL    Top;                        /* next expression needs no parentheses */
+    BOOL    UsesFault;                  /* program can stop with a fault */
+    BOOL    UsesBudget;                 /* program has loops */
+    BOOL    UsesReturn;                 /* program contains RETURN */
+} CGEN;
+
+/* Elementary data types, index is MIST_KW_xxx, see CompType[] in mist_comp.c */
+MLOCAL const CGEN_TYPE CGenType[MIST_KW_COUNT] = {
+    [MIST_KW_BOOL] = {"UINT8", MIST_CLS_BOOL, 1},
+    [MIST_KW_SINT] = {"SINT8", MIST_CLS_INT, 1},
+    [MIST_KW_INT] = {"SINT16", MIST_CLS_INT, 2},
+    [MIST_KW_DINT] = {"SINT32", MIST_CLS_INT, 4},
+    [MIST_KW_USINT] = {"UINT8", MIST_CLS_INT, 1},
+    [MIST_KW_UINT] = {"UINT16", MIST_CLS_INT, 2},
+    [MIST_KW_UDINT] = {"UINT32", MIST_CLS_UINT, 4},
+    [MIST_KW_REAL] = {"REAL32", MIST_CLS_REAL, 4},
+    [MIST_KW_LREAL] = {"REAL64", MIST_CLS_LREAL, 8},
+    [MIST_KW_TIME] = {"SINT32", MIST_CLS_INT, 4},
+    [MIST_KW_BYTE] = {"UINT8", MIST_CLS_INT, 1},
+    [MIST_KW_WORD] = {"UINT16", MIST_CLS_INT, 2},
+    [MIST_KW_DWORD] = {"UINT32", MIST_CLS_UINT, 4}
+};
+
+/* C types and helper suffixes of the computation classes, index is MIST_CLS_xxx */
+MLOCAL const CHAR *const CGenClsType[] = {"SINT32", "SINT32", "SINT32", "UINT32", "REAL32", "REAL64"};
+MLOCAL const CHAR *const CGenClsSfx[] = {"", "", "", "U", "F", "D"};
+
+/* C operators of binary operations, index is MIST_OP_xxx */
+MLOCAL const CHAR *const CGenOp[MIST_OP_XOR + 1] = {
+    [MIST_OP_ADD] = "+", [MIST_OP_SUB] = "-", [MIST_OP_MUL] = "*", [MIST_OP_DIV] = "/",
+    [MIST_OP_MOD] = "%", [MIST_OP_EQ] = "==", [MIST_OP_NE] = "!=", [MIST_OP_LT] = "<",
+    [MIST_OP_LE] = "<=", [MIST_OP_GT] = ">", [MIST_OP_GE] = ">=", [MIST_OP_AND] = "&",
+    [MIST_OP_OR] = "|", [MIST_OP_XOR] = "^"
+};
+
+/* C library functions of the math functions, index is MIST_FN_xxx */
+MLOCAL const CHAR *const CGenMath[MIST_FN_COUNT] = {
+    "sqrt", "sin", "cos", "tan", "asin", "acos", "atan", "exp", "log", "log10"
+};
+
+/* Helpers of the generated code, each one does what the VM instruction does */
+MLOCAL const CHAR *const CGenHelpers[] = {
+    "#ifdef __GNUC__",
+    "#define CG_INLINE        static __inline__",
+    "#else",
+    "#define CG_INLINE        static",
+    "#endif",
+    "",
+    "/* 32 bit integer arithmetic with wrap-around */",
+    "#define CG_ADD(a, b)     ((SINT32) ((UINT32) (a) + (UINT32) (b)))",
+    "#define CG_SUB(a, b)     ((SINT32) ((UINT32) (a) - (UINT32) (b)))",
+    "#define CG_MUL(a, b)     ((SINT32) ((UINT32) (a) * (UINT32) (b)))",
+    "#define CG_NEG(a)        ((SINT32) (0u - (UINT32) (a)))",
+    "",
+    "/* Faults: the first one is kept, the statement is finished without storing */",
+    "CG_INLINE UINT32 Cg_Idx(UINT32 Index, UINT32 Lower, UINT32 Count, UINT32 * pFault)",
+    "{",
+    "    Index -= Lower;",
+    "    if (Index < Count)",
+    "        return (Index);",
+    "    if (!*pFault)",
+    "        *pFault = MIST_VM_E_BOUNDS;",
+    "    return (0);",
+    "}",
+    "",
+    "CG_INLINE UINT32 Cg_DivZero(UINT32 * pFault)",
+    "{",
+    "    if (!*pFault)",
+    "        *pFault = MIST_VM_E_DIVZERO;",
+    "    return (0);",
+    "}",
+    "",
+    "CG_INLINE SINT32 Cg_Div(SINT32 a, SINT32 b, UINT32 * pFault)",
+    "{",
+    "    if (!b)",
+    "        return ((SINT32) Cg_DivZero(pFault));",
+    "    return ((b == -1) ? CG_NEG(a) : a / b);",
+    "}",
+    "",
+    "CG_INLINE SINT32 Cg_Mod(SINT32 a, SINT32 b, UINT32 * pFault)",
+    "{",
+    "    if (!b)",
+    "        return ((SINT32) Cg_DivZero(pFault));",
+    "    return ((b == -1) ? 0 : a % b);",
+    "}",
+    "",
+    "CG_INLINE UINT32 Cg_DivU(UINT32 a, UINT32 b, UINT32 * pFault)",
+    "{",
+    "    return (b ? a / b : Cg_DivZero(pFault));",
+    "}",
+    "",
+    "CG_INLINE UINT32 Cg_ModU(UINT32 a, UINT32 b, UINT32 * pFault)",
+    "{",
+    "    return (b ? a % b : Cg_DivZero(pFault));",
+    "}",
+    "",
+    "/* MIN, MAX and ABS */",
+    "CG_INLINE SINT32 Cg_Min(SINT32 a, SINT32 b) { return ((a < b) ? a : b); }",
+    "CG_INLINE SINT32 Cg_Max(SINT32 a, SINT32 b) { return ((a > b) ? a : b); }",
+    "CG_INLINE UINT32 Cg_MinU(UINT32 a, UINT32 b) { return ((a < b) ? a : b); }",
+    "CG_INLINE UINT32 Cg_MaxU(UINT32 a, UINT32 b) { return ((a > b) ? a : b); }",
+    "CG_INLINE REAL32 Cg_MinF(REAL32 a, REAL32 b) { return ((a < b) ? a : b); }",
+    "CG_INLINE REAL32 Cg_MaxF(REAL32 a, REAL32 b) { return ((a > b) ? a : b); }",
+    "CG_INLINE REAL64 Cg_MinD(REAL64 a, REAL64 b) { return ((a < b) ? a : b); }",
+    "CG_INLINE REAL64 Cg_MaxD(REAL64 a, REAL64 b) { return ((a > b) ? a : b); }",
+    "CG_INLINE SINT32 Cg_Abs(SINT32 a) { return ((a < 0) ? CG_NEG(a) : a); }",
+    "CG_INLINE REAL32 Cg_AbsF(REAL32 a) { return ((a < 0) ? -a : a); }",
+    "CG_INLINE REAL64 Cg_AbsD(REAL64 a) { return ((a < 0) ? -a : a); }",
+    NULL
+};
+
+/* Functions: code generator, being called only within this file */
+MLOCAL VOID CGen_Printf(CGEN * g, const CHAR * pFmt, ...);
+MLOCAL VOID CGen_Indent(CGEN * g);
+MLOCAL VOID CGen_Line(CGEN * g, const CHAR * pFmt, ...);
+MLOCAL VOID CGen_Label(CGEN * g, const CHAR * pFmt, ...);
+MLOCAL VOID CGen_Check(CGEN * g);
+MLOCAL BOOL CGen_ConstIndex(const MIST_NODE * pNode);
+MLOCAL BOOL CGen_PlainDiv(const MIST_NODE * pDivisor, UINT32 Cls);
+MLOCAL BOOL CGen_MayFault(const MIST_NODE * pNode);
+MLOCAL VOID CGen_Scan(CGEN * g, const MIST_NODE * pStmt);
+MLOCAL VOID CGen_Int(CGEN * g, SINT32 Value, UINT32 Cls);
+MLOCAL VOID CGen_Real(CGEN * g, REAL64 Value, UINT32 Cls);
+MLOCAL VOID CGen_Lit(CGEN * g, const MIST_NODE * pNode, UINT32 Cls);
+MLOCAL VOID CGen_Index(CGEN * g, const MIST_NODE * pNode);
+MLOCAL VOID CGen_Call(CGEN * g, const MIST_NODE * pNode);
+MLOCAL VOID CGen_Value(CGEN * g, const MIST_NODE * pNode, BOOL Top);
+MLOCAL VOID CGen_Expr(CGEN * g, const MIST_NODE * pNode, UINT32 Cls);
+MLOCAL VOID CGen_Target(CGEN * g, const MIST_NODE * pTarget, BOOL InIdx);
+MLOCAL VOID CGen_Assign(CGEN * g, const MIST_NODE * pNode);
+MLOCAL VOID CGen_Block(CGEN * g, const MIST_NODE * pStmt);
+MLOCAL VOID CGen_StmtList(CGEN * g, const MIST_NODE * pStmt);
+MLOCAL BOOL CGen_CondBegin(CGEN * g, const MIST_NODE * pCond);
+MLOCAL VOID CGen_CondEnd(CGEN * g);
+MLOCAL VOID CGen_IfCond(CGEN * g, const CHAR * pPrefix, const MIST_NODE * pCond, BOOL Local, BOOL Negate);
+MLOCAL VOID CGen_If(CGEN * g, const MIST_NODE * pNode);
+MLOCAL VOID CGen_Labels(CGEN * g, const MIST_NODE * pLabel, UINT32 Cls);
+MLOCAL BOOL CGen_CaseSwitch(CGEN * g, const MIST_NODE * pNode, UINT32 Cls, BOOL Local);
+MLOCAL VOID CGen_Case(CGEN * g, const MIST_NODE * pNode);
+MLOCAL VOID CGen_LoopBegin(CGEN * g, CGEN_LOOP * pLoop);
+MLOCAL VOID CGen_LoopEnd(CGEN * g, CGEN_LOOP * pLoop);
+MLOCAL VOID CGen_Budget(CGEN * g);
+MLOCAL VOID CGen_For(CGEN * g, const MIST_NODE * pNode);
+MLOCAL VOID CGen_Stmt(CGEN * g, const MIST_NODE * pNode);
+MLOCAL VOID CGen_Vars(CGEN * g);
+MLOCAL SINT32 CGen_Symbol(const MIST_CODE * pCode, const CHAR * pSuffix, CHAR ** ppValue);
+MLOCAL SINT32 CGen_Load(const CHAR * pFileName, MIST_SOURCE * pSrc, MIST_UNIT * pUnit, MIST_CODE ** ppCode);
+MLOCAL VOID CGen_Inputs(const MIST_POU * pPou, UINT8 * pMem1, UINT8 * pMem2, UINT32 * pSeed);
+MLOCAL SINT32 CGen_Compare(const MIST_POU * pPou, const MIST_VM * pVm, const MIST_VM * pVmC, UINT32 Cycle);
+
+/* Functions: test functions, to be called from the shell */
+SINT32  mist_PrgGenC(CHAR * pFileName, CHAR * pOutName);
+SINT32  mist_PrgCmpC(CHAR * pFileName, UINT32 Cycles);
+
+
+/**
+********************************************************************************
+* @brief Writes text to the output file. CGen_Indent() starts an indented
+*        line, CGen_Line() writes a whole line, CGen_Label() a label line.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pFmt     format string
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Printf(CGEN * g, const CHAR * pFmt, ...)
+{
+    va_list Args;
+
+    va_start(Args, pFmt);
+    vfprintf(g->pFile, pFmt, Args);
+    va_end(Args);
+}
+
+MLOCAL VOID CGen_Indent(CGEN * g)
+{
+    fprintf(g->pFile, "%*s", (int) (g->Indent * 4), "");
+}
+
+MLOCAL VOID CGen_Line(CGEN * g, const CHAR * pFmt, ...)
+{
+    va_list Args;
+
+    if (*pFmt)
+        CGen_Indent(g);
+    va_start(Args, pFmt);
+    vfprintf(g->pFile, pFmt, Args);
+    va_end(Args);
+    fputc('\n', g->pFile);
+}
+
+MLOCAL VOID CGen_Label(CGEN * g, const CHAR * pFmt, ...)
+{
+    va_list Args;
+
+    fprintf(g->pFile, "%*s", (int) (g->Indent * 4 - 2), "");
+    va_start(Args, pFmt);
+    vfprintf(g->pFile, pFmt, Args);
+    va_end(Args);
+    fputc('\n', g->pFile);
+}
+
+/**
+********************************************************************************
+* @brief Writes the fault check behind an expression which may fault.
+*
+* @param[in]  g        pointer to generator state
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Check(CGEN * g)
+{
+    CGen_Line(g, "if (Fault)");
+    CGen_Line(g, "    goto L_Fault;");
+}
+
+/**
+********************************************************************************
+* @brief Checks if all indexes of an array element are literals, the VM
+*        calculates the offset at compile time then.
+*
+* @param[in]  pNode    MIST_N_INDEX node
+* @param[out] N/A
+*
+* @retval     TRUE, FALSE
+*******************************************************************************/
+MLOCAL BOOL CGen_ConstIndex(const MIST_NODE * pNode)
+{
+    const MIST_NODE *pIdx;
+
+    for (pIdx = pNode->pB; pIdx; pIdx = pIdx->pNext)
+    {
+        if (pIdx->Type != MIST_N_INT)
+            return (FALSE);
+    }
+    return (TRUE);
+}
+
+/**
+********************************************************************************
+* @brief Checks if an integer division can use the C operator directly:
+*        the divisor is a literal, neither 0 (fault) nor -1 (overflow).
+*
+* @param[in]  pDivisor divisor expression
+* @param[in]  Cls      class of the division, MIST_CLS_INT or MIST_CLS_UINT
+* @param[out] N/A
+*
+* @retval     TRUE, FALSE
+*******************************************************************************/
+MLOCAL BOOL CGen_PlainDiv(const MIST_NODE * pDivisor, UINT32 Cls)
+{
+    if (pDivisor->Type != MIST_N_INT)
+        return (FALSE);
+    return (pDivisor->u.Int && ((Cls == MIST_CLS_UINT) || (pDivisor->u.Int != -1)));
+}
+
+/**
+********************************************************************************
+* @brief Checks if an expression can stop the program: array indexes
+*        calculated at run time and integer divisions. The first operands
+*        are walked in a loop, see mist_NodeChain().
+*
+* @param[in]  pNode    expression, NULL is allowed
+* @param[out] N/A
+*
+* @retval     TRUE, FALSE
+*******************************************************************************/
+MLOCAL BOOL CGen_MayFault(const MIST_NODE * pNode)
+{
+    const MIST_NODE *pArg;
+    UINT32  Cls;
+
+    for (; pNode; pNode = pNode->pA)
+    {
+        switch (pNode->Type)
+        {
+            case MIST_N_INDEX:
+                return (!CGen_ConstIndex(pNode));
+
+            case MIST_N_UNARY:
+                break;
+
+            case MIST_N_BINARY:
+            case MIST_N_RANGE:
+                Cls = (pNode->pA->Class > pNode->pB->Class) ? pNode->pA->Class : pNode->pB->Class;
+                if ((pNode->Type == MIST_N_BINARY) && ((pNode->Op == MIST_OP_DIV) || (pNode->Op == MIST_OP_MOD)) &&
+                    (pNode->Class <= MIST_CLS_UINT) && !CGen_PlainDiv(pNode->pB, Cls))
+                    return (TRUE);
+                if (CGen_MayFault(pNode->pB))
+                    return (TRUE);
+                break;
+
+            case MIST_N_CALL:
+                for (pArg = pNode->pA; pArg; pArg = pArg->pNext)
+                {
+                    if (CGen_MayFault(pArg))
+                        return (TRUE);
+                }
+                return (FALSE);
+
+            default:
+                return (FALSE);
+        }
+    }
+    return (FALSE);
+}
+
+/**
+********************************************************************************
+* @brief Determines which labels and variables the cycle function needs.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pStmt    statement list
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Scan(CGEN * g, const MIST_NODE * pStmt)
+{
+    const MIST_NODE *pElem;
+    const MIST_NODE *pLabel;
+    const MIST_NODE *pNext;
+
+    for (; pStmt; pStmt = pNext)
+    {
+        pNext = pStmt->pNext;
+        switch (pStmt->Type)
+        {
+            case MIST_N_ASSIGN:
+                g->UsesFault |= CGen_MayFault(pStmt->pA) || CGen_MayFault(pStmt->pB);
+                break;
+
+            case MIST_N_IF:
+                g->UsesFault |= CGen_MayFault(pStmt->pA);
+                CGen_Scan(g, pStmt->pBody);
+                /* The ELSE part of the last statement continues the loop, a chain of ELSIF doesn't recurse */
+                if (!pNext)
+                    pNext = pStmt->pElse;
+                else
+                    CGen_Scan(g, pStmt->pElse);
+                break;
+
+            case MIST_N_CASE:
+                g->UsesFault |= CGen_MayFault(pStmt->pA);
+                for (pElem = pStmt->pBody; pElem; pElem = pElem->pNext)
+                {
+                    for (pLabel = pElem->pA; pLabel; pLabel = pLabel->pNext)
+                        g->UsesFault |= CGen_MayFault(pLabel);
+                    CGen_Scan(g, pElem->pBody);
+                }
+                CGen_Scan(g, pStmt->pElse);
+                break;
+
+            case MIST_N_FOR:
+                g->UsesFault |= CGen_MayFault(pStmt->pB) || CGen_MayFault(pStmt->pC) || CGen_MayFault(pStmt->pD);
+                g->UsesBudget = TRUE;
+                CGen_Scan(g, pStmt->pBody);
+                break;
+
+            case MIST_N_WHILE:
+            case MIST_N_REPEAT:
+                g->UsesFault |= CGen_MayFault(pStmt->pA);
+                g->UsesBudget = TRUE;
+                CGen_Scan(g, pStmt->pBody);
+                break;
+
+            case MIST_N_RETURN:
+                g->UsesReturn = TRUE;
+                break;
+        }
+    }
+}
+
+/**
+********************************************************************************
+* @brief Writes an integer constant of a computation class.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  Value    value, the bits are used for MIST_CLS_UINT
+* @param[in]  Cls      MIST_CLS_BOOL, MIST_CLS_INT or MIST_CLS_UINT
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Int(CGEN * g, SINT32 Value, UINT32 Cls)
+{
+    if (Cls == MIST_CLS_UINT)
+        CGen_Printf(g, "%uu", (UINT32) Value);
+    else if (Value == (SINT32) 0x80000000)
+        CGen_Printf(g, "(-2147483647 - 1)");
+    else if (Value < 0)
+        CGen_Printf(g, "(%d)", Value);
+    else
+        CGen_Printf(g, "%d", Value);
+}
+
+/**
+********************************************************************************
+* @brief Writes a floating point constant, the text converts back to
+*        exactly the same value.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  Value    value
+* @param[in]  Cls      MIST_CLS_REAL or MIST_CLS_LREAL
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Real(CGEN * g, REAL64 Value, UINT32 Cls)
+{
+    CHAR    Buf[40];
+    REAL32  Single;
+
+    if (Cls == MIST_CLS_REAL)
+    {
+        Single = (REAL32) Value;
+        Value = Single;
+    }
+
+    /* Infinity, e.g. 1E300 as REAL */
+    if (Value - Value != 0)
+    {
+        CGen_Printf(g, "(%s%sHUGE_VAL)", (Value < 0) ? "-" : "", (Cls == MIST_CLS_REAL) ? "(REAL32) " : "");
+        return;
+    }
+
+    snprintf(Buf, sizeof(Buf), "%.*g", (Cls == MIST_CLS_REAL) ? 9 : 17, Value);
+    if (!strpbrk(Buf, ".eE"))
+        strcat(Buf, ".0");
+    CGen_Printf(g, (Buf[0] == '-') ? "(%s%s)" : "%s%s", Buf, (Cls == MIST_CLS_REAL) ? "f" : "");
+}
+
+/**
+********************************************************************************
+* @brief Writes a literal converted to a computation class,
+*        like Comp_LitValue() in mist_comp.c.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pNode    literal node
+* @param[in]  Cls      requested class
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Lit(CGEN * g, const MIST_NODE * pNode, UINT32 Cls)
+{
+    if (pNode->Type != MIST_N_INT)
+        CGen_Real(g, pNode->u.Real, Cls);
+    else if (Cls <= MIST_CLS_UINT)
+        CGen_Int(g, pNode->u.Int, Cls);
+    else if (pNode->Class == MIST_CLS_UINT)
+        CGen_Real(g, (REAL64) (UINT32) pNode->u.Int, Cls);
+    else
+        CGen_Real(g, (REAL64) pNode->u.Int, Cls);
+}
+
+/**
+********************************************************************************
+* @brief Writes the element number of an array element. Literal indexes
+*        are resolved here, indexes checked by the compiler are used
+*        directly, all others are bounds checked at run time.
+*        Dimensions are combined like a Horner scheme.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pNode    MIST_N_INDEX node
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Index(CGEN * g, const MIST_NODE * pNode)
+{
+    const MIST_VAR *pVar = pNode->pA->u.pVar;
+    const MIST_NODE *pIdx;
+    BOOL    Const = CGen_ConstIndex(pNode);
+    UINT32  Elem = 0;
+    UINT32  Count;
+    UINT32  Dim;
+
+    for (Dim = 1; (Dim < pVar->NbOfDims) && !Const; Dim++)
+        CGen_Printf(g, "(");
+
+    for (pIdx = pNode->pB, Dim = 0; pIdx; pIdx = pIdx->pNext, Dim++)
+    {
+        Count = (UINT32) (pVar->Upper[Dim] - pVar->Lower[Dim]) + 1;
+        if (Const)
+        {
+            Elem = Elem * Count + (UINT32) (pIdx->u.Int - pVar->Lower[Dim]);
+            continue;
+        }
+
+        if (Dim)
+            CGen_Printf(g, ") * %u + ", Count);
+        if ((pIdx->Type == MIST_N_INT) && (pIdx->u.Int >= pVar->Lower[Dim]) && (pIdx->u.Int <= pVar->Upper[Dim]))
+            CGen_Printf(g, "%u", (UINT32) (pIdx->u.Int - pVar->Lower[Dim]));
+        else if (pNode->Op & MIST_IX_CHECKED)
+        {
+            /* Proven within bounds by the compiler, see Comp_Induct() */
+            CGen_Printf(g, "((UINT32) ");
+            CGen_Expr(g, pIdx, pIdx->Class);
+            CGen_Printf(g, " - (UINT32) ");
+            CGen_Int(g, pVar->Lower[Dim], MIST_CLS_INT);
+            CGen_Printf(g, ")");
+        }
+        else
+        {
+            CGen_Printf(g, "Cg_Idx((UINT32) ");
+            CGen_Expr(g, pIdx, pIdx->Class);
+            CGen_Printf(g, ", ");
+            CGen_Int(g, pVar->Lower[Dim], MIST_CLS_INT);
+            CGen_Printf(g, ", %u, &Fault)", Count);
+        }
+    }
+
+    if (Const)
+        CGen_Printf(g, "%u", Elem);
+}
+
+/**
+********************************************************************************
+* @brief Writes a call of a standard function, like Comp_Call() in
+*        mist_comp.c.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pNode    MIST_N_CALL node, resolved by the compiler
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Call(CGEN * g, const MIST_NODE * pNode)
+{
+    const MIST_NODE *pArg = pNode->pA;
+    const CGEN_TYPE *pTo;
+    UINT32  Cls = pNode->Class;
+    UINT32  From = pArg->Class;
+
+    switch (pNode->Op)
+    {
+        case MIST_F_CONV:
+            pTo = &CGenType[pNode->DataType];
+            if (pTo->Cls == MIST_CLS_BOOL)
+            {
+                /* Anything but zero is TRUE */
+                if (From == MIST_CLS_BOOL)
+                    CGen_Expr(g, pArg, From);
+                else
+                {
+                    CGen_Printf(g, "(");
+                    CGen_Expr(g, pArg, From);
+                    CGen_Printf(g, (From == MIST_CLS_REAL) ? " != 0.0f)" : (From == MIST_CLS_LREAL) ? " != 0.0)" : " != 0)");
+                }
+            }
+            else if (pTo->Cls >= MIST_CLS_REAL)
+            {
+                CGen_Printf(g, "(%s) ", CGenClsType[pTo->Cls]);
+                CGen_Expr(g, pArg, From);
+            }
+            else
+            {
+                /* Integers: REAL is rounded, then truncated to the destination size */
+                if (pTo->Size < 4)
+                    CGen_Printf(g, "(SINT32) (%s) ", pTo->pName);
+                else
+                    CGen_Printf(g, "(%s) ", CGenClsType[pTo->Cls]);
+                if (From >= MIST_CLS_REAL)
+                    CGen_Printf(g, (pTo->Cls == MIST_CLS_UINT) ? "mist_VmRoundU(" : "mist_VmRound(");
+                CGen_Expr(g, pArg, From);
+                if (From >= MIST_CLS_REAL)
+                    CGen_Printf(g, ")");
+            }
+            return;
+
+        case MIST_F_TRUNC:
+            if (From <= MIST_CLS_UINT)
+            {
+                CGen_Printf(g, "(SINT32) ");
+                CGen_Expr(g, pArg, From);
+                return;
+            }
+            CGen_Printf(g, "mist_VmTrunc(");
+            CGen_Expr(g, pArg, From);
+            CGen_Printf(g, ")");
+            return;
+
+        case MIST_F_ABS:
+            if (Cls == MIST_CLS_UINT)
+            {
+                CGen_Expr(g, pArg, Cls);
+                return;
+            }
+            CGen_Printf(g, "Cg_Abs%s(", CGenClsSfx[Cls]);
+            CGen_Expr(g, pArg, Cls);
+            CGen_Printf(g, ")");
+            return;
+
+        case MIST_F_EXPT:
+            CGen_Printf(g, (Cls == MIST_CLS_REAL) ? "(REAL32) pow(" : "pow(");
+            CGen_Expr(g, pArg, Cls);
+            CGen_Printf(g, ", ");
+            CGen_Expr(g, pArg->pNext, Cls);
+            CGen_Printf(g, ")");
+            return;
+
+        case MIST_F_MIN:
+        case MIST_F_MAX:
+            /* MIN(a, b, c) = MIN(MIN(a, b), c) */
+            for (pArg = pArg->pNext; pArg; pArg = pArg->pNext)
+                CGen_Printf(g, "Cg_%s%s(", (pNode->Op == MIST_F_MIN) ? "Min" : "Max", CGenClsSfx[Cls]);
+            CGen_Expr(g, pNode->pA, Cls);
+            for (pArg = pNode->pA->pNext; pArg; pArg = pArg->pNext)
+            {
+                CGen_Printf(g, ", ");
+                CGen_Expr(g, pArg, Cls);
+                CGen_Printf(g, ")");
+            }
+            return;
+
+        case MIST_F_LIMIT:
+            /* LIMIT(MN, IN, MX) = MIN(MAX(IN, MN), MX) */
+            CGen_Printf(g, "Cg_Min%s(Cg_Max%s(", CGenClsSfx[Cls], CGenClsSfx[Cls]);
+            CGen_Expr(g, pArg->pNext, Cls);
+            CGen_Printf(g, ", ");
+            CGen_Expr(g, pArg, Cls);
+            CGen_Printf(g, "), ");
+            CGen_Expr(g, pArg->pNext->pNext, Cls);
+            CGen_Printf(g, ")");
+            return;
+
+        case MIST_F_SEL:
+            /* Only the selected input is evaluated */
+            CGen_Printf(g, "(");
+            CGen_Expr(g, pArg, MIST_CLS_BOOL);
+            CGen_Printf(g, " ? ");
+            CGen_Expr(g, pArg->pNext->pNext, Cls);
+            CGen_Printf(g, " : ");
+            CGen_Expr(g, pArg->pNext, Cls);
+            CGen_Printf(g, ")");
+            return;
+
+        default:
+            /* Math functions, always calculated in double precision */
+            CGen_Printf(g, "%s%s(", (Cls == MIST_CLS_REAL) ? "(REAL32) " : "",
+                        CGenMath[pNode->Op - MIST_F_SQRT + MIST_FN_SQRT]);
+            CGen_Expr(g, pArg, Cls);
+            CGen_Printf(g, ")");
+            return;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Writes the part of a binary operation before or after its first
+*        operand. CGen_Value() writes a line of first operands in a loop,
+*        see mist_NodeChain().
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pNode    MIST_N_BINARY node
+* @param[in]  Top      TRUE .. the outer parentheses can be omitted
+* @param[in]  Open     TRUE .. part before, FALSE .. operator, second operand and end
+* @param[out] N/A
+*
+* @retval     class of the operands
+*******************************************************************************/
+MLOCAL UINT32 CGen_Binary(CGEN * g, const MIST_NODE * pNode, BOOL Top, BOOL Open)
+{
+    UINT32  Cls = pNode->Class;
+    UINT32  Op = pNode->Op;
+    BOOL    Plain = FALSE;
+
+    if (Cls == MIST_CLS_BOOL)
+        Cls = (pNode->pA->Class > pNode->pB->Class) ? pNode->pA->Class : pNode->pB->Class;
+
+    if (((Op == MIST_OP_DIV) || (Op == MIST_OP_MOD)) && (Cls <= MIST_CLS_UINT) && !CGen_PlainDiv(pNode->pB, Cls))
+    {
+        if (Open)
+            CGen_Printf(g, "Cg_%s%s(", (Op == MIST_OP_DIV) ? "Div" : "Mod", CGenClsSfx[Cls]);
+    }
+    else if (Op == MIST_OP_POW)
+    {
+        if (Open)
+            CGen_Printf(g, (Cls == MIST_CLS_REAL) ? "(REAL32) pow(" : "pow(");
+    }
+    else if ((Cls == MIST_CLS_INT) && ((Op == MIST_OP_ADD) || (Op == MIST_OP_SUB) || (Op == MIST_OP_MUL)))
+    {
+        if (Open)
+            CGen_Printf(g, (Op == MIST_OP_ADD) ? "CG_ADD(" : (Op == MIST_OP_SUB) ? "CG_SUB(" : "CG_MUL(");
+    }
+    else
+    {
+        /* Plain C operator */
+        Plain = TRUE;
+        if (Open && !Top)
+            CGen_Printf(g, "(");
+    }
+    if (Open)
+        return (Cls);
+
+    if (Plain)
+        CGen_Printf(g, " %s ", CGenOp[Op]);
+    else
+        CGen_Printf(g, ", ");
+    CGen_Expr(g, pNode->pB, Cls);
+    if (!Plain)
+        CGen_Printf(g, (Op == MIST_OP_DIV) || (Op == MIST_OP_MOD) ? ", &Fault)" : ")");
+    else if (!Top)
+        CGen_Printf(g, ")");
+    return (Cls);
+}
+
+/**
+********************************************************************************
+* @brief Writes an expression in its own class, like Comp_Value() in
+*        mist_comp.c. The C type of the result is CGenClsType[].
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pNode    expression, no literal
+* @param[in]  Top      TRUE .. the outer parentheses can be omitted
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Value(CGEN * g, const MIST_NODE * pNode, BOOL Top)
+{
+    const MIST_NODE *pBin;
+    UINT32  Cls = pNode->Class;
+    UINT32  Op = pNode->Op;
+    UINT32  Len;
+    UINT32  Level;
+
+    switch (pNode->Type)
+    {
+        case MIST_N_VAR:
+            CGen_Printf(g, "V_%s", pNode->u.pVar->pName);
+            return;
+
+        case MIST_N_INDEX:
+            CGen_Printf(g, "A_%s[", pNode->pA->u.pVar->pName);
+            CGen_Index(g, pNode);
+            CGen_Printf(g, "]");
+            return;
+
+        case MIST_N_UNARY:
+            if ((Op == MIST_OP_NOT) && (Cls == MIST_CLS_BOOL))
+                CGen_Printf(g, "(");
+            else if (Op == MIST_OP_NOT)
+                CGen_Printf(g, "(~");
+            else if (Cls == MIST_CLS_INT)
+                CGen_Printf(g, "CG_NEG(");
+            else if (Cls == MIST_CLS_UINT)
+                CGen_Printf(g, "(0u - ");
+            else
+                CGen_Printf(g, "(-");
+            CGen_Expr(g, pNode->pA, Cls);
+            CGen_Printf(g, ((Op == MIST_OP_NOT) && (Cls == MIST_CLS_BOOL)) ? " ^ 1)" : ")");
+            return;
+
+        case MIST_N_BINARY:
+            /* Opening parts from the outermost node, the rest from the innermost node upwards */
+            Len = mist_NodeChain(pNode);
+            for (pBin = pNode, Level = 0; Level < Len; pBin = pBin->pA, Level++)
+            {
+                /* Conversion of a first operand, see CGen_Expr() */
+                if (Level && (pBin->Class != Cls) && (CGenClsType[pBin->Class] != CGenClsType[Cls]))
+                    CGen_Printf(g, "(%s) ", CGenClsType[Cls]);
+                Cls = CGen_Binary(g, pBin, Top && !Level, TRUE);
+            }
+            CGen_Expr(g, pBin, Cls);
+            while (Len--)
+                CGen_Binary(g, mist_NodeLeft(pNode, Len), Top && !Len, FALSE);
+            return;
+
+        case MIST_N_CALL:
+            CGen_Call(g, pNode);
+            return;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Writes an expression converted to a class, like Comp_Expr() in
+*        mist_comp.c. All implicit conversions are C casts, because every
+*        class has its own C type.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pNode    expression, classes assigned by the compiler
+* @param[in]  Cls      requested class
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Expr(CGEN * g, const MIST_NODE * pNode, UINT32 Cls)
+{
+    BOOL    Top = g->Top;
+
+    g->Top = FALSE;
+    if ((pNode->Type == MIST_N_INT) || (pNode->Type == MIST_N_REAL))
+    {
+        CGen_Lit(g, pNode, Cls);
+        return;
+    }
+    if ((pNode->Class == Cls) || (CGenClsType[pNode->Class] == CGenClsType[Cls]))
+    {
+        CGen_Value(g, pNode, Top);
+        return;
+    }
+    CGen_Printf(g, "(%s) ", CGenClsType[Cls]);
+    CGen_Value(g, pNode, FALSE);
+}
+
+/**
+********************************************************************************
+* @brief Writes the target of an assignment.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pTarget  MIST_N_VAR or MIST_N_INDEX node
+* @param[in]  InIdx    TRUE .. the element number is in the local 'Idx'
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Target(CGEN * g, const MIST_NODE * pTarget, BOOL InIdx)
+{
+    if (pTarget->Type == MIST_N_VAR)
+        CGen_Printf(g, "V_%s", pTarget->u.pVar->pName);
+    else if (InIdx)
+        CGen_Printf(g, "A_%s[Idx]", pTarget->pA->u.pVar->pName);
+    else
+        CGen_Value(g, pTarget, FALSE);
+}
+
+/**
+********************************************************************************
+* @brief Writes an assignment, the value is truncated to the size of the
+*        variable. If a fault is possible, value and element number are
+*        calculated first, the store is skipped after a fault like in the VM.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pNode    MIST_N_ASSIGN node
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Assign(CGEN * g, const MIST_NODE * pNode)
+{
+    const MIST_NODE *pTarget = pNode->pA;
+    const MIST_VAR *pVar;
+    const CGEN_TYPE *pType;
+    UINT32  Cls = pTarget->Class;
+    BOOL    InIdx = CGen_MayFault(pTarget);
+
+    pVar = (pTarget->Type == MIST_N_INDEX) ? pTarget->pA->u.pVar : pTarget->u.pVar;
+    pType = &CGenType[pVar->Type];
+
+    if (!InIdx && !CGen_MayFault(pNode->pB))
+    {
+        CGen_Indent(g);
+        CGen_Target(g, pTarget, FALSE);
+        CGen_Printf(g, (pType->Size < 4) ? " = (%s) " : " = ", pType->pName);
+        g->Top = (pType->Size >= 4);
+        CGen_Expr(g, pNode->pB, Cls);
+        CGen_Printf(g, ";\n");
+        return;
+    }
+
+    CGen_Line(g, "{");
+    g->Indent++;
+    CGen_Indent(g);
+    CGen_Printf(g, "%-8sVal = ", CGenClsType[Cls]);
+    g->Top = TRUE;
+    CGen_Expr(g, pNode->pB, Cls);
+    CGen_Printf(g, ";\n");
+    if (InIdx)
+    {
+        CGen_Indent(g);
+        CGen_Printf(g, "UINT32  Idx = ");
+        CGen_Index(g, pTarget);
+        CGen_Printf(g, ";\n");
+    }
+    CGen_Line(g, "");
+    CGen_Check(g);
+    CGen_Indent(g);
+    CGen_Target(g, pTarget, InIdx);
+    CGen_Printf(g, (pType->Size < 4) ? " = (%s) Val;\n" : " = Val;\n", pType->pName);
+    g->Indent--;
+    CGen_Line(g, "}");
+}
+
+/**
+********************************************************************************
+* @brief Writes a statement list as block.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pStmt    first statement, NULL = empty list
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Block(CGEN * g, const MIST_NODE * pStmt)
+{
+    CGen_Line(g, "{");
+    g->Indent++;
+    CGen_StmtList(g, pStmt);
+    g->Indent--;
+    CGen_Line(g, "}");
+}
+
+/**
+********************************************************************************
+* @brief Writes a statement list.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pStmt    first statement, NULL = empty list
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_StmtList(CGEN * g, const MIST_NODE * pStmt)
+{
+    for (; pStmt; pStmt = pStmt->pNext)
+        CGen_Stmt(g, pStmt);
+}
+
+/**
+********************************************************************************
+* @brief Opens a block evaluating a condition into the local 'Cond',
+*        if the condition may fault. CGen_CondEnd() closes the block.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pCond    condition, class BOOL
+* @param[out] N/A
+*
+* @retval     TRUE  .. block opened, the condition is in 'Cond'
+* @retval     FALSE .. the condition is written directly by CGen_IfCond()
+*******************************************************************************/
+MLOCAL BOOL CGen_CondBegin(CGEN * g, const MIST_NODE * pCond)
+{
+    if (!CGen_MayFault(pCond))
+        return (FALSE);
+
+    CGen_Line(g, "{");
+    g->Indent++;
+    CGen_Indent(g);
+    CGen_Printf(g, "SINT32  Cond = ");
+    g->Top = TRUE;
+    CGen_Expr(g, pCond, MIST_CLS_BOOL);
+    CGen_Printf(g, ";\n\n");
+    CGen_Check(g);
+    return (TRUE);
+}
+
+MLOCAL VOID CGen_CondEnd(CGEN * g)
+{
+    g->Indent--;
+    CGen_Line(g, "}");
+}
+
+/**
+********************************************************************************
+* @brief Writes the head of an if statement.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pPrefix  "if" or "else if"
+* @param[in]  pCond    condition, class BOOL
+* @param[in]  Local    TRUE .. the condition is in 'Cond', see CGen_CondBegin()
+* @param[in]  Negate   TRUE .. the condition is inverted
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_IfCond(CGEN * g, const CHAR * pPrefix, const MIST_NODE * pCond, BOOL Local, BOOL Negate)
+{
+    CGen_Indent(g);
+    CGen_Printf(g, Negate ? "%s (!" : "%s (", pPrefix);
+    if (Local)
+        CGen_Printf(g, "Cond");
+    else
+    {
+        g->Top = !Negate;
+        CGen_Expr(g, pCond, MIST_CLS_BOOL);
+    }
+    CGen_Printf(g, ")\n");
+}
+
+/**
+********************************************************************************
+* @brief Writes IF cond THEN body ELSE else_body END_IF,
+*        ELSIF becomes else if. A chain of ELSIF is written in a loop
+*        (see mist_NodeElsif()), the blocks are closed at the end.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pNode    MIST_N_IF node
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_If(CGEN * g, const MIST_NODE * pNode)
+{
+    const MIST_NODE *pElse;
+    const CHAR *pPrefix = "if";
+    UINT32  Open = 0;
+    BOOL    Local;
+
+    for (;; pNode = pElse)
+    {
+        pElse = pNode->pElse;
+        Local = CGen_CondBegin(g, pNode->pA);
+        if (Local)
+            Open++;
+
+        CGen_IfCond(g, pPrefix, pNode->pA, Local, FALSE);
+        CGen_Block(g, pNode->pBody);
+
+        if (!mist_NodeElsif(pElse))
+            break;
+
+        if (!Local && !CGen_MayFault(pElse->pA))
+            pPrefix = "else if";
+        else
+        {
+            /* else block with the ELSIF as only statement */
+            CGen_Line(g, "else");
+            CGen_Line(g, "{");
+            g->Indent++;
+            Open++;
+            pPrefix = "if";
+        }
+    }
+
+    if (pElse)
+    {
+        CGen_Line(g, "else");
+        CGen_Block(g, pElse);
+    }
+
+    /* Condition blocks and else blocks end alike */
+    for (; Open; Open--)
+        CGen_CondEnd(g);
+}
+
+/**
+********************************************************************************
+* @brief Writes the labels of a CASE element as condition on the local 'Sel'.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pLabel   list of labels and ranges
+* @param[in]  Cls      class of the selector
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Labels(CGEN * g, const MIST_NODE * pLabel, UINT32 Cls)
+{
+    BOOL    Paren = (pLabel->pNext != NULL);
+
+    for (; pLabel; pLabel = pLabel->pNext)
+    {
+        CGen_Printf(g, Paren ? "(" : "");
+        if (pLabel->Type == MIST_N_RANGE)
+        {
+            CGen_Printf(g, "(Sel >= ");
+            CGen_Expr(g, pLabel->pA, Cls);
+            CGen_Printf(g, ") && (Sel <= ");
+            CGen_Expr(g, pLabel->pB, Cls);
+            CGen_Printf(g, ")");
+        }
+        else
+        {
+            CGen_Printf(g, "Sel == ");
+            CGen_Expr(g, pLabel, Cls);
+        }
+        CGen_Printf(g, Paren ? ")" : "");
+        CGen_Printf(g, pLabel->pNext ? " || " : "");
+    }
+}
+
+/**
+********************************************************************************
+* @brief Writes a CASE statement as switch, if all labels are literals,
+*        all values are unique and ranges are short.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pNode    MIST_N_CASE node
+* @param[in]  Cls      class of the selector
+* @param[in]  Local    TRUE .. the selector is in 'Sel'
+* @param[out] N/A
+*
+* @retval     TRUE  .. switch written
+* @retval     FALSE .. nothing written, a chain of comparisons is needed
+*******************************************************************************/
+MLOCAL BOOL CGen_CaseSwitch(CGEN * g, const MIST_NODE * pNode, UINT32 Cls, BOOL Local)
+{
+    const MIST_NODE *pElem;
+    const MIST_NODE *pLabel;
+    SINT32 *pValues;
+    UINT32  NbOfValues = 0;
+    UINT32  First, Count;
+    UINT32  Pass, i, k;
+    BOOL    Ok = TRUE;
+
+    pValues = malloc(CGEN_MAXCASES * sizeof(SINT32));
+    if (!pValues)
+        return (FALSE);
+
+    /* Pass 0 checks the labels, pass 1 writes the switch */
+    for (Pass = 0; (Pass < 2) && Ok; Pass++)
+    {
+        if (Pass)
+        {
+            CGen_Indent(g);
+            CGen_Printf(g, "switch (");
+            if (Local)
+                CGen_Printf(g, "Sel");
+            else
+            {
+                g->Top = TRUE;
+                CGen_Expr(g, pNode->pA, Cls);
+            }
+            CGen_Printf(g, ")\n");
+            CGen_Line(g, "{");
+            g->Indent++;
+        }
+
+        for (pElem = pNode->pBody; pElem && Ok; pElem = pElem->pNext)
+        {
+            Count = 0;
+            for (pLabel = pElem->pA; pLabel && Ok; pLabel = pLabel->pNext)
+            {
+                if (pLabel->Type == MIST_N_RANGE)
+                {
+                    if ((pLabel->pA->Type != MIST_N_INT) || (pLabel->pB->Type != MIST_N_INT))
+                    {
+                        Ok = FALSE;
+                        break;
+                    }
+                    First = (UINT32) pLabel->pA->u.Int;
+                    k = (UINT32) pLabel->pB->u.Int;
+                    if ((Cls == MIST_CLS_UINT) ? (k < First) : (pLabel->pB->u.Int < pLabel->pA->u.Int))
+                        continue;
+                    if (k - First >= CGEN_MAXRANGE)
+                    {
+                        Ok = FALSE;
+                        break;
+                    }
+                    k = k - First + 1;
+                }
+                else if (pLabel->Type == MIST_N_INT)
+                {
+                    First = (UINT32) pLabel->u.Int;
+                    k = 1;
+                }
+                else
+                {
+                    Ok = FALSE;
+                    break;
+                }
+
+                for (; k; k--, First++, Count++)
+                {
+                    if (Pass)
+                    {
+                        CGen_Indent(g);
+                        CGen_Printf(g, "case ");
+                        CGen_Int(g, (SINT32) First, Cls);
+                        CGen_Printf(g, ":\n");
+                        continue;
+                    }
+                    /* The first element with a value wins, so values must be unique */
+                    for (i = 0; i < NbOfValues; i++)
+                    {
+                        if (pValues[i] == (SINT32) First)
+                            break;
+                    }
+                    if ((i < NbOfValues) || (NbOfValues >= CGEN_MAXCASES))
+                    {
+                        Ok = FALSE;
+                        break;
+                    }
+                    pValues[NbOfValues++] = (SINT32) First;
+                }
+            }
+
+            if (Pass && Count)
+            {
+                g->Indent++;
+                CGen_StmtList(g, pElem->pBody);
+                CGen_Line(g, "break;");
+                g->Indent--;
+            }
+        }
+
+        if (Pass)
+        {
+            if (pNode->pElse)
+            {
+                CGen_Line(g, "default:");
+                g->Indent++;
+                CGen_StmtList(g, pNode->pElse);
+                CGen_Line(g, "break;");
+                g->Indent--;
+            }
+            g->Indent--;
+            CGen_Line(g, "}");
+        }
+    }
+
+    free(pValues);
+    return (Ok);
+}
+
+/**
+********************************************************************************
+* @brief Writes CASE selector OF labels: body ... ELSE else_body END_CASE.
+*        The selector is evaluated once, the first element with a matching
+*        label is executed, like Comp_Case() in mist_comp.c.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pNode    MIST_N_CASE node
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Case(CGEN * g, const MIST_NODE * pNode)
+{
+    const MIST_NODE *pElem;
+    const MIST_NODE *pLabel;
+    UINT32  Cls = pNode->pA->Class;
+    UINT32  Nest = 0;
+    BOOL    Local = CGen_MayFault(pNode->pA);
+    BOOL    Match = FALSE;
+    BOOL    First = TRUE;
+    BOOL    Fault;
+
+    if (Local || !CGen_CaseSwitch(g, pNode, Cls, FALSE))
+    {
+        for (pElem = pNode->pBody; pElem; pElem = pElem->pNext)
+        {
+            for (pLabel = pElem->pA; pLabel; pLabel = pLabel->pNext)
+                Match |= CGen_MayFault(pLabel);
+        }
+
+        CGen_Line(g, "{");
+        g->Indent++;
+        CGen_Indent(g);
+        CGen_Printf(g, "%-8sSel = ", CGenClsType[Cls]);
+        g->Top = TRUE;
+        CGen_Expr(g, pNode->pA, Cls);
+        CGen_Printf(g, ";\n");
+        if (Match)
+            CGen_Line(g, "SINT32  Match;");
+        CGen_Line(g, "");
+        if (Local)
+            CGen_Check(g);
+
+        if (!Local || !CGen_CaseSwitch(g, pNode, Cls, TRUE))
+        {
+            /* Chain of comparisons, labels which may fault are evaluated before the branch */
+            for (pElem = pNode->pBody; pElem; pElem = pElem->pNext, First = FALSE)
+            {
+                for (Fault = FALSE, pLabel = pElem->pA; pLabel; pLabel = pLabel->pNext)
+                    Fault |= CGen_MayFault(pLabel);
+
+                if (Fault)
+                {
+                    if (!First)
+                    {
+                        CGen_Line(g, "else");
+                        CGen_Line(g, "{");
+                        g->Indent++;
+                        Nest++;
+                    }
+                    CGen_Indent(g);
+                    CGen_Printf(g, "Match = ");
+                    CGen_Labels(g, pElem->pA, Cls);
+                    CGen_Printf(g, ";\n");
+                    CGen_Check(g);
+                    CGen_Line(g, "if (Match)");
+                }
+                else
+                {
+                    CGen_Indent(g);
+                    CGen_Printf(g, First ? "if (" : "else if (");
+                    CGen_Labels(g, pElem->pA, Cls);
+                    CGen_Printf(g, ")\n");
+                }
+                CGen_Block(g, pElem->pBody);
+            }
+
+            if (pNode->pElse && First)
+                CGen_StmtList(g, pNode->pElse);
+            else if (pNode->pElse)
+            {
+                CGen_Line(g, "else");
+                CGen_Block(g, pNode->pElse);
+            }
+            for (; Nest; Nest--)
+            {
+                g->Indent--;
+                CGen_Line(g, "}");
+            }
+        }
+
+        g->Indent--;
+        CGen_Line(g, "}");
+    }
+}
+
+/**
+********************************************************************************
+* @brief Opens and closes a loop for EXIT and CONTINUE.
+*        CGen_LoopEnd() writes the exit label, if it is used.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pLoop    loop, on the stack of the caller
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_LoopBegin(CGEN * g, CGEN_LOOP * pLoop)
+{
+    pLoop->pOuter = g->pLoop;
+    pLoop->Id = ++g->NbOfLoops;
+    pLoop->ContUsed = FALSE;
+    pLoop->ExitUsed = FALSE;
+    g->pLoop = pLoop;
+}
+
+MLOCAL VOID CGen_LoopEnd(CGEN * g, CGEN_LOOP * pLoop)
+{
+    g->pLoop = pLoop->pOuter;
+    if (!pLoop->ExitUsed)
+        return;
+    CGen_Label(g, "L%u_exit:", pLoop->Id);
+    CGen_Line(g, ";");
+}
+
+/**
+********************************************************************************
+* @brief Writes the budget check of a backward jump.
+*
+* @param[in]  g        pointer to generator state
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Budget(CGEN * g)
+{
+    CGen_Line(g, "if (!--Budget)");
+    CGen_Line(g, "    goto L_Budget;");
+}
+
+/**
+********************************************************************************
+* @brief Writes FOR var := start TO end BY step DO body END_FOR.
+*        End and step are evaluated once after the start value has been
+*        stored. The budget counts every entry into the body, like the
+*        backward jump of the VM, see Comp_For() in mist_comp.c.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pNode    MIST_N_FOR node
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_For(CGEN * g, const MIST_NODE * pNode)
+{
+    CGEN_LOOP Loop;
+    MIST_NODE Start;
+    const MIST_VAR *pVar = pNode->pA->u.pVar;
+    const CGEN_TYPE *pType = &CGenType[pVar->Type];
+    UINT32  Cls = pNode->pA->Class;
+    BOOL    StepLit = !pNode->pD || (pNode->pD->Type == MIST_N_INT);
+    BOOL    EndLit = (pNode->pC->Type == MIST_N_INT) && StepLit;
+    SINT32  Sign = 1;
+
+    if (!StepLit && (Cls == MIST_CLS_INT))
+        Sign = 0;
+    else if (pNode->pD && (Cls == MIST_CLS_INT) && (pNode->pD->u.Int < 0))
+        Sign = -1;
+
+    memset(&Start, 0, sizeof(Start));
+    Start.Type = MIST_N_ASSIGN;
+    Start.pA = pNode->pA;
+    Start.pB = pNode->pB;
+    CGen_Assign(g, &Start);
+
+    if (!EndLit || !StepLit)
+    {
+        CGen_Line(g, "{");
+        g->Indent++;
+    }
+    if (!EndLit)
+    {
+        CGen_Indent(g);
+        CGen_Printf(g, "%-8sEnd = ", CGenClsType[Cls]);
+        g->Top = TRUE;
+        CGen_Expr(g, pNode->pC, Cls);
+        CGen_Printf(g, ";\n");
+    }
+    if (!StepLit)
+    {
+        CGen_Indent(g);
+        CGen_Printf(g, "%-8sStep = ", CGenClsType[Cls]);
+        g->Top = TRUE;
+        CGen_Expr(g, pNode->pD, Cls);
+        CGen_Printf(g, ";\n");
+    }
+    if (!EndLit || !StepLit)
+        CGen_Line(g, "");
+    if (CGen_MayFault(pNode->pC) || CGen_MayFault(pNode->pD))
+        CGen_Check(g);
+
+    CGen_LoopBegin(g, &Loop);
+    CGen_Line(g, "for (;;)");
+    CGen_Line(g, "{");
+    g->Indent++;
+
+    /* Condition, the direction of a step in a variable is known at run time only */
+    CGen_Indent(g);
+    CGen_Printf(g, "if (!(");
+    if (Sign == 0)
+        CGen_Printf(g, "(Step < 0) ? (V_%s >= End) : (V_%s <= End)", pVar->pName, pVar->pName);
+    else
+    {
+        CGen_Printf(g, "V_%s %s ", pVar->pName, (Sign > 0) ? "<=" : ">=");
+        if (EndLit)
+            CGen_Lit(g, pNode->pC, Cls);
+        else
+            CGen_Printf(g, "End");
+    }
+    CGen_Printf(g, "))\n");
+    CGen_Line(g, "    break;");
+    CGen_Budget(g);
+
+    CGen_StmtList(g, pNode->pBody);
+
+    /* Increment */
+    if (Loop.ContUsed)
+        CGen_Label(g, "L%u_cont:", Loop.Id);
+    CGen_Indent(g);
+    CGen_Printf(g, "V_%s = ", pVar->pName);
+    if (pType->Size < 4)
+        CGen_Printf(g, "(%s) ", pType->pName);
+    CGen_Printf(g, (Cls == MIST_CLS_UINT) ? "V_%s + " : "CG_ADD(V_%s, ", pVar->pName);
+    if (!StepLit)
+        CGen_Printf(g, "Step");
+    else if (pNode->pD)
+        CGen_Lit(g, pNode->pD, Cls);
+    else
+        CGen_Int(g, 1, Cls);
+    CGen_Printf(g, (Cls == MIST_CLS_UINT) ? ";\n" : ");\n");
+
+    g->Indent--;
+    CGen_Line(g, "}");
+    CGen_LoopEnd(g, &Loop);
+    if (!EndLit || !StepLit)
+    {
+        g->Indent--;
+        CGen_Line(g, "}");
+    }
+}
+
+/**
+********************************************************************************
+* @brief Writes a statement, like Comp_Stmt() in mist_comp.c.
+*        WHILE and REPEAT check the budget where the VM jumps backward.
+*
+* @param[in]  g        pointer to generator state
+* @param[in]  pNode    statement
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Stmt(CGEN * g, const MIST_NODE * pNode)
+{
+    CGEN_LOOP Loop;
+    BOOL    Local;
+
+    switch (pNode->Type)
+    {
+        case MIST_N_ASSIGN:
+            CGen_Assign(g, pNode);
+            break;
+
+        case MIST_N_IF:
+            CGen_If(g, pNode);
+            break;
+
+        case MIST_N_CASE:
+            CGen_Case(g, pNode);
+            break;
+
+        case MIST_N_FOR:
+            CGen_For(g, pNode);
+            break;
+
+        case MIST_N_WHILE:
+            CGen_LoopBegin(g, &Loop);
+            CGen_Line(g, "for (;;)");
+            CGen_Line(g, "{");
+            g->Indent++;
+            Local = CGen_CondBegin(g, pNode->pA);
+            CGen_IfCond(g, "if", pNode->pA, Local, TRUE);
+            CGen_Line(g, "    break;");
+            if (Local)
+                CGen_CondEnd(g);
+            CGen_StmtList(g, pNode->pBody);
+            if (Loop.ContUsed)
+                CGen_Label(g, "L%u_cont:", Loop.Id);
+            CGen_Budget(g);
+            g->Indent--;
+            CGen_Line(g, "}");
+            CGen_LoopEnd(g, &Loop);
+            break;
+
+        case MIST_N_REPEAT:
+            CGen_LoopBegin(g, &Loop);
+            CGen_Line(g, "for (;;)");
+            CGen_Line(g, "{");
+            g->Indent++;
+            CGen_StmtList(g, pNode->pBody);
+            if (Loop.ContUsed)
+                CGen_Label(g, "L%u_cont:", Loop.Id);
+            Local = CGen_CondBegin(g, pNode->pA);
+            CGen_IfCond(g, "if", pNode->pA, Local, FALSE);
+            CGen_Line(g, "    break;");
+            if (Local)
+                CGen_CondEnd(g);
+            CGen_Budget(g);
+            g->Indent--;
+            CGen_Line(g, "}");
+            CGen_LoopEnd(g, &Loop);
+            break;
+
+        case MIST_N_EXIT:
+            if (!g->pLoop)
+                break;
+            g->pLoop->ExitUsed = TRUE;
+            CGen_Line(g, "goto L%u_exit;", g->pLoop->Id);
+            break;
+
+        case MIST_N_CONTINUE:
+            if (!g->pLoop)
+                break;
+            g->pLoop->ContUsed = TRUE;
+            CGen_Line(g, "goto L%u_cont;", g->pLoop->Id);
+            break;
+
+        case MIST_N_RETURN:
+            CGen_Line(g, "goto L_End;");
+            break;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Writes the access macros of all variables: V_<name> for scalars,
+*        A_<name> for arrays, addressing the data area of the VM instance.
+*
+* @param[in]  g        pointer to generator state
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Vars(CGEN * g)
+{
+    const MIST_VAR *pVar;
+    const CGEN_TYPE *pType;
+
+    CGen_Printf(g, "/* Variables in the data area of the VM instance */\n");
+    for (pVar = g->pPou->pVars; pVar; pVar = pVar->pNext)
+    {
+        pType = &CGenType[pVar->Type];
+        if (pVar->NbOfDims)
+            CGen_Printf(g, "#define A_%-14s ((%s *) (pMem + %u))\n", pVar->pName, pType->pName, pVar->MemOffset);
+        else
+            CGen_Printf(g, "#define V_%-14s (*(%s *) (pMem + %u))\n", pVar->pName, pType->pName, pVar->MemOffset);
+    }
+    CGen_Printf(g, "\n");
+}
+
+/**
+********************************************************************************
+* @brief Generates a C file from a compiled ST program. The file defines
+*        VOID mist_<name>_Cycle(TASK_PROPERTIES * pTaskData), which executes
+*        one cycle on pTaskData->pVm like mist_VmRun(), and the hash of the
+*        source mist_<name>_SrcHash, see mist_CGenFind().
+*
+* @param[in]  pPou     program, compiled by mist_Compile()
+* @param[in]  pCode    compiled code of the program
+* @param[in]  pSrcName name of the source file, for the file header
+* @param[in]  pOutName path/name of the C file to be written
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_CGen(const MIST_POU * pPou, const MIST_CODE * pCode, const CHAR * pSrcName, const CHAR * pOutName)
+{
+    CGEN    Gen;
+    CGEN   *g = &Gen;
+    const CHAR *pBase;
+    UINT32  i;
+    CHAR    Func[] = "mist_CGen";
+
+    memset(g, 0, sizeof(*g));
+    g->pPou = pPou;
+    g->pFile = fopen(pOutName, "w");
+    if (!g->pFile)
+    {
+        LOG_E(0, Func, "Could not create file '%s'!", pOutName);
+        return (ERROR);
+    }
+    CGen_Scan(g, pPou->pBody);
+
+    pBase = strrchr(pOutName, '/');
+    pBase = pBase ? pBase + 1 : pOutName;
+    CGen_Printf(g, "/**\n");
+    CGen_Printf(g, "********************************************************************************\n");
+    CGen_Printf(g, "* @file     %s\n", pBase);
+    CGen_Printf(g, "*\n");
+    CGen_Printf(g, "* @brief    C code of the ST program '%s' from %s,\n", pCode->Name, pSrcName);
+    CGen_Printf(g, "*           generated by mist_PrgGenC(). Don't edit, generate it again.\n");
+    CGen_Printf(g, "*\n");
+    CGen_Printf(g, "*******************************************************************************/\n\n");
+    CGen_Printf(g, "/* a * b + c must not become a fused multiply-add, the VM rounds the product */\n");
+    CGen_Printf(g, "#pragma STDC FP_CONTRACT OFF\n#if defined(__GNUC__)\n#pragma GCC optimize(\"fp-contract=off\")\n"
+                "#endif\n\n");
+    CGen_Printf(g, "/* VxWorks includes */\n#include <vxWorks.h>\n#include <string.h>\n#include <math.h>\n\n");
+    CGen_Printf(g, "/* MSys includes */\n#include <mtypes.h>\n#include <msys_e.h>\n#include <svi_e.h>\n"
+                "#include <log_e.h>\n\n");
+    CGen_Printf(g, "/* Project includes */\n#include \"mist_int.h\"\n#include \"mist_prg.h\"\n"
+                "#include \"mist_vm.h\"\n\n");
+    for (i = 0; CGenHelpers[i]; i++)
+        CGen_Printf(g, "%s\n", CGenHelpers[i]);
+    CGen_Printf(g, "\n");
+    CGen_Vars(g);
+
+    CGen_Printf(g, "/* Hash of the source, checked by mist_CGenFind() */\n");
+    CGen_Printf(g, "const UINT32 mist_%s_SrcHash = 0x%08X;\n\n", pCode->Name, pCode->SrcHash);
+    CGen_Printf(g, "VOID    mist_%s_Cycle(TASK_PROPERTIES * pTaskData);\n\n\n", pCode->Name);
+
+    CGen_Printf(g, "VOID mist_%s_Cycle(TASK_PROPERTIES * pTaskData)\n{\n", pCode->Name);
+    CGen_Printf(g, "    MIST_VM *pVm = pTaskData->pVm;\n");
+    CGen_Printf(g, "    UINT8  *pMem = pVm->pMem;\n");
+    if (g->UsesBudget)
+        CGen_Printf(g, "    UINT32  Budget = pVm->Budget;\n");
+    if (g->UsesFault)
+        CGen_Printf(g, "    UINT32  Fault = MIST_VM_E_OK;\n");
+    CGen_Printf(g, "\n    if (pVm->Fault)\n        return;\n");
+    if (pCode->TempSize)
+        CGen_Printf(g, "    memcpy(pMem + %u, pVm->pCode->pInit + %u, %u);\n", pCode->TempOffset, pCode->TempOffset,
+                    pCode->TempSize);
+    CGen_Printf(g, "\n");
+
+    g->Indent = 1;
+    CGen_StmtList(g, pPou->pBody);
+
+    CGen_Printf(g, "\n");
+    if (g->UsesReturn)
+        CGen_Label(g, "L_End:");
+    CGen_Printf(g, "    pVm->NbOfCycles++;\n    return;\n");
+    if (g->UsesBudget)
+    {
+        CGen_Label(g, "L_Budget:");
+        CGen_Printf(g, "    pVm->Fault = MIST_VM_E_BUDGET;\n");
+        if (g->UsesFault)
+            CGen_Printf(g, "    return;\n");
+    }
+    if (g->UsesFault)
+    {
+        CGen_Label(g, "L_Fault:");
+        CGen_Printf(g, "    pVm->Fault = Fault;\n");
+    }
+    CGen_Printf(g, "}\n");
+
+    if (ferror(g->pFile) | fclose(g->pFile))
+    {
+        LOG_E(0, Func, "Could not write file '%s'!", pOutName);
+        return (ERROR);
+    }
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Looks up a symbol of the generated code of a program.
+*
+* @param[in]  pCode    compiled program
+* @param[in]  pSuffix  "Cycle" or "SrcHash"
+* @param[out] ppValue  address of the symbol
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, not linked
+*******************************************************************************/
+MLOCAL SINT32 CGen_Symbol(const MIST_CODE * pCode, const CHAR * pSuffix, CHAR ** ppValue)
+{
+    CHAR    Name[64];
+    SYM_TYPE Type;
+
+    /* Depending on the tool chain, C symbols start with an underscore */
+    snprintf(Name, sizeof(Name), "_mist_%s_%s", pCode->Name, pSuffix);
+    if (symFindByName(sysSymTbl, Name + 1, ppValue, &Type) == OK)
+        return (OK);
+    return (symFindByName(sysSymTbl, Name, ppValue, &Type));
+}
+
+/**
+********************************************************************************
+* @brief Finds the generated code of a program, which must be linked to
+*        the module and must have been generated from the same source.
+*
+* @param[in]  pCode    compiled program
+* @param[out] N/A
+*
+* @retval     function to be called instead of mist_VmRun(), NULL = not found
+*******************************************************************************/
+VOIDFUNCPTR mist_CGenFind(const MIST_CODE * pCode)
+{
+    CHAR   *pCycle;
+    CHAR   *pHash;
+    CHAR    Func[] = "mist_CGenFind";
+
+    if (CGen_Symbol(pCode, "Cycle", &pCycle) < 0)
+    {
+        LOG_W(0, Func, "Generated code of program '%s' is not linked!", pCode->Name);
+        return (NULL);
+    }
+    if ((CGen_Symbol(pCode, "SrcHash", &pHash) < 0) || (*(UINT32 *) pHash != pCode->SrcHash))
+    {
+        LOG_W(0, Func, "Generated code of program '%s' doesn't match the source, generate it again!", pCode->Name);
+        return (NULL);
+    }
+    return ((VOIDFUNCPTR) pCycle);
+}
+
+/**
+********************************************************************************
+* @brief Reads and compiles the first program of an ST file like
+*        mist_PrgLoad(), but keeps source and syntax tree for the generator.
+*
+* @param[in]  pFileName  ST source file
+* @param[out] pSrc       source, to be freed by mist_SrcFree()
+* @param[out] pUnit      syntax tree, to be freed by mist_UnitFree()
+* @param[out] ppCode     compiled program, to be freed by mist_CodeFree()
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, nothing to be freed
+*******************************************************************************/
+MLOCAL SINT32 CGen_Load(const CHAR * pFileName, MIST_SOURCE * pSrc, MIST_UNIT * pUnit, MIST_CODE ** ppCode)
+{
+    SINT32  Ret;
+    CHAR    Func[] = "CGen_Load";
+
+    *ppCode = NULL;
+    if (mist_SrcLoad(pSrc, pFileName) < 0)
+        return (ERROR);
+
+    Ret = mist_Parse(pUnit, pSrc->pBuf, pSrc->Length);
+    if ((Ret == OK) && !pUnit->pPous)
+    {
+        LOG_E(0, Func, "%s: no PROGRAM found", pFileName);
+        Ret = ERROR;
+    }
+    else
+    {
+        if (Ret == OK)
+            Ret = mist_Compile(pUnit, pUnit->pPous, pSrc->pBuf, ppCode);
+        if (Ret < 0)
+            LOG_E(0, Func, "%s:%u: %s", pFileName, pUnit->ErrLine, pUnit->ErrText);
+    }
+
+    if (Ret < 0)
+    {
+        mist_UnitFree(pUnit);
+        mist_SrcFree(pSrc);
+    }
+    return (Ret);
+}
+
+/**
+********************************************************************************
+* @brief Sets all VAR_INPUT variables to pseudo random values, the same
+*        in both data areas. Integers are small most of the time, so that
+*        array indexes and divisors are valid, sometimes they use all bits.
+*
+* @param[in]  pPou     program
+* @param[in]  pMem1    first data area
+* @param[in]  pMem2    second data area
+* @param[in]  pSeed    state of the random generator (xorshift), not 0
+* @param[out] pSeed    new state
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID CGen_Inputs(const MIST_POU * pPou, UINT8 * pMem1, UINT8 * pMem2, UINT32 * pSeed)
+{
+    const MIST_VAR *pVar;
+    UINT32  Bits = *pSeed;
+    UINT32  Count, Offset;
+    UINT32  Dim;
+    SINT32  Value;
+    REAL32  Real;
+    REAL64  LReal;
+
+    for (pVar = pPou->pVars; pVar; pVar = pVar->pNext)
+    {
+        if (pVar->Class != MIST_KW_VAR_INPUT)
+            continue;
+
+        for (Count = 1, Dim = 0; Dim < pVar->NbOfDims; Dim++)
+            Count *= (UINT32) (pVar->Upper[Dim] - pVar->Lower[Dim]) + 1;
+
+        for (Offset = pVar->MemOffset; Count; Count--, Offset += pVar->ElemSize)
+        {
+            Bits ^= Bits << 13;
+            Bits ^= Bits >> 17;
+            Bits ^= Bits << 5;
+            Value = ((Bits >> 28) == 0) ? (SINT32) Bits : (SINT32) (Bits % 201) - 100;
+
+            switch (CGenType[pVar->Type].Cls)
+            {
+                case MIST_CLS_BOOL:
+                    Value = Bits & 1;
+                    break;
+                case MIST_CLS_REAL:
+                    Real = (REAL32) ((SINT32) Bits) / 65536.0f;
+                    memcpy(&Value, &Real, 4);
+                    break;
+                case MIST_CLS_LREAL:
+                    LReal = (REAL64) ((SINT32) Bits) / 65536.0;
+                    memcpy(pMem1 + Offset, &LReal, 8);
+                    memcpy(pMem2 + Offset, &LReal, 8);
+                    continue;
+            }
+
+            /* Little and big endian: store the low bytes */
+            switch (pVar->ElemSize)
+            {
+                case 1:
+                    pMem1[Offset] = pMem2[Offset] = (UINT8) Value;
+                    break;
+                case 2:
+                    *(UINT16 *) (pMem1 + Offset) = *(UINT16 *) (pMem2 + Offset) = (UINT16) Value;
+                    break;
+                default:
+                    *(UINT32 *) (pMem1 + Offset) = *(UINT32 *) (pMem2 + Offset) = (UINT32) Value;
+                    break;
+            }
+        }
+    }
+    *pSeed = Bits;
+}
+
+/**
+********************************************************************************
+* @brief Compares the state of two instances of a program, prints the
+*        first difference.
+*
+* @param[in]  pPou     program
+* @param[in]  pVm      instance executed by the VM
+* @param[in]  pVmC     instance executed by the generated code
+* @param[in]  Cycle    number of the cycle, for the output
+* @param[out] N/A
+*
+* @retval     = 0 .. OK, identical
+* @retval     < 0 .. ERROR, different
+*******************************************************************************/
+MLOCAL SINT32 CGen_Compare(const MIST_POU * pPou, const MIST_VM * pVm, const MIST_VM * pVmC, UINT32 Cycle)
+{
+    const MIST_VAR *pVar;
+    UINT32  Count, Elem;
+    UINT32  Dim;
+
+    if ((pVm->Fault != pVmC->Fault) || (pVm->NbOfCycles != pVmC->NbOfCycles))
+    {
+        printf("%s: cycle %u: VM %u cycles (%s), C %u cycles (%s)\n", pVm->pCode->Name, Cycle, pVm->NbOfCycles,
+               mist_VmFaultText(pVm->Fault), pVmC->NbOfCycles, mist_VmFaultText(pVmC->Fault));
+        return (ERROR);
+    }
+    if (!memcmp(pVm->pMem, pVmC->pMem, pVm->pCode->MemSize))
+        return (OK);
+
+    for (pVar = pPou->pVars; pVar; pVar = pVar->pNext)
+    {
+        for (Count = 1, Dim = 0; Dim < pVar->NbOfDims; Dim++)
+            Count *= (UINT32) (pVar->Upper[Dim] - pVar->Lower[Dim]) + 1;
+
+        for (Elem = 0; Elem < Count; Elem++)
+        {
+            if (memcmp(pVm->pMem + pVar->MemOffset + Elem * pVar->ElemSize,
+                       pVmC->pMem + pVar->MemOffset + Elem * pVar->ElemSize, pVar->ElemSize))
+            {
+                printf("%s: cycle %u: '%s' element %u differs\n", pVm->pCode->Name, Cycle, pVar->pName, Elem);
+                return (ERROR);
+            }
+        }
+    }
+    printf("%s: cycle %u: data areas differ\n", pVm->pCode->Name, Cycle);
+    return (ERROR);
+}
+
+/**
+********************************************************************************
+* @brief Generates the C file of an ST program, to be called from the shell.
+*
+* @param[in]  pFileName  ST source file, the first program is used
+* @param[in]  pOutName   C file to be written
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_PrgGenC(CHAR * pFileName, CHAR * pOutName)
+{
+    MIST_SOURCE Src;
+    MIST_UNIT Unit;
+    MIST_CODE *pCode;
+    SINT32  Ret;
+
+    if (CGen_Load(pFileName, &Src, &Unit, &pCode) < 0)
+        return (ERROR);
+
+    Ret = mist_CGen(Unit.pPous, pCode, pFileName, pOutName);
+    if (Ret == OK)
+        printf("%s: %s written, source hash 0x%08X\n", pCode->Name, pOutName, pCode->SrcHash);
+
+    mist_CodeFree(pCode);
+    mist_UnitFree(&Unit);
+    mist_SrcFree(&Src);
+    return (Ret);
+}
+
+/**
+********************************************************************************
+* @brief Tests the generated code of an ST program against the VM, to be
+*        called from the shell. The generated code must be linked.
+*        Both run the given number of cycles with the same random inputs,
+*        the data areas must be identical after every cycle. Then both
+*        run the cycles again with the initial values to measure the time.
+*
+* @param[in]  pFileName  ST source file, the first program is used
+* @param[in]  Cycles     number of cycles, 0 = 1000
+* @param[out] N/A
+*
+* @retval     = 0 .. OK, identical results
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_PrgCmpC(CHAR * pFileName, UINT32 Cycles)
+{
+    MIST_SOURCE Src;
+    MIST_UNIT Unit;
+    MIST_CODE *pCode;
+    MIST_VM *pVm = NULL;
+    MIST_VM *pVmC = NULL;
+    TASK_PROPERTIES Task;
+    VOIDFUNCPTR pFunc;
+    UINT32  Seed = 0x12345678;
+    UINT32  Start, TimeVm, TimeC;
+    UINT32  i;
+    SINT32  Ret = ERROR;
+
+    if (!Cycles)
+        Cycles = 1000;
+
+    if (CGen_Load(pFileName, &Src, &Unit, &pCode) < 0)
+        return (ERROR);
+
+    do
+    {
+        pFunc = mist_CGenFind(pCode);
+        if (!pFunc)
+            break;
+        pVm = mist_VmCreate(pCode, 0);
+        pVmC = mist_VmCreate(pCode, 0);
+        if (!pVm || !pVmC)
+            break;
+        memset(&Task, 0, sizeof(Task));
+        Task.pVm = pVmC;
+
+        /* Same inputs, same results */
+        Ret = OK;
+        for (i = 0; (i < Cycles) && (Ret == OK) && !pVm->Fault; i++)
+        {
+            CGen_Inputs(Unit.pPous, pVm->pMem, pVmC->pMem, &Seed);
+            mist_VmRun(pVm);
+            pFunc(&Task);
+            Ret = CGen_Compare(Unit.pPous, pVm, pVmC, i);
+        }
+        if (Ret < 0)
+            break;
+        if (pVm->Fault)
+            printf("%s: both stopped in cycle %u: %s\n", pCode->Name, i - 1, mist_VmFaultText(pVm->Fault));
+        printf("%s: %u cycles with identical results\n", pCode->Name, i);
+
+        /* Speed */
+        mist_VmReset(pVm);
+        mist_VmReset(pVmC);
+        Start = m_GetProcTime();
+        for (i = 0; i < Cycles; i++)
+            mist_VmRun(pVm);
+        TimeVm = m_GetProcTime() - Start;
+        Start = m_GetProcTime();
+        for (i = 0; i < Cycles; i++)
+            pFunc(&Task);
+        TimeC = m_GetProcTime() - Start;
+
+        printf("%s: mean %u ns per cycle with VM, %u ns with C code, speedup %.1f\n", pCode->Name,
+               (UINT32) (TimeVm * 1000.0 / Cycles), (UINT32) (TimeC * 1000.0 / Cycles),
+               TimeC ? (REAL64) TimeVm / TimeC : 0.0);
+    } while (0);
+
+    mist_VmDelete(pVmC);
+    mist_VmDelete(pVm);
+    mist_CodeFree(pCode);
+    mist_UnitFree(&Unit);
+    mist_SrcFree(&Src);
+    return (Ret);
+}
@@ -0,0 +1,4792 @@
+/**
+********************************************************************************
+* @file     mist_comp.c
+* @author   Bachmann electronic GmbH
+* @version  $Revision: 3.90 $ $LastChangedBy: BE $
+* @date     $LastChangeDate: 2013-06-10 11:00:00 $
+*
+* @brief    This file contains the bytecode compiler for Structured Text (ST)
+*           programs, executed by the virtual machine in mist_vm.c.
+*
+*           The compiler lays out all variables of a program in one data
+*           area, assigns a computation class (MIST_CLS_xxx) to every
+*           expression node and translates the statements into register
+*           instructions. Expressions are evaluated in temporary registers
+*           allocated like a stack, literals become constant registers.
+*
+*           Before the instructions are generated, the syntax tree is
+*           optimized: expressions on literals and VAR CONSTANT values are
+*           folded with the semantics of the VM, IF, CASE and loops with
+*           constant conditions keep only the branch being executed.
+*
+*           FOR loops with literal bounds are specialized: short loops are
+*           unrolled, sweeps over arrays become block instructions, other
+*           loops count their iterations and address array elements
+*           following the control variable by induction registers without
+*           bounds checks (Comp_ForCount()). Element-wise REAL expressions
+*           over arrays become kernels executed with SIMD (Comp_VecLanes()).
+*
+*           The statements of the program body are grouped by their data
+*           dependencies (Comp_Body()): statements sharing a variable which
+*           is assigned by any of them belong to the same group. Each group
+*           becomes a segment of instructions ending with MIST_I_END, in
+*           source order of its statements. Segments don't depend on each
+*           other, so they can be executed in any order or in parallel with
+*           the same result as the serial execution (mist_VmRunPar()).
+*
+*           The program cache keeps the compiled POUs across configuration
+*           reloads. A POU is identified by its text, so after a change only
+*           the POUs whose text differs are parsed and compiled again, see
+*           mist_PrgCacheLoad().
+*
+*           Type rules, close to C:
+*           - integers are computed with 32 bit, shorter types are truncated
+*             when stored
+*           - INT < UDINT < REAL < LREAL, the operand of lower rank is
+*             converted implicitly
+*           - an untyped real literal is REAL next to a REAL operand,
+*             LREAL otherwise
+*           - REAL to integer needs a conversion function (X_TO_Y rounds,
+*             TRUNC truncates), BOOL does not mix with numbers
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <taskLib.h>
+#include <semLib.h>
+#include <sysLib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+
+/* Project includes */
+#include "mist_int.h"
+#include "mist_prg.h"
+#include "mist_vm.h"
+
+/* Register numbers while compiling: temporaries count from 0, constants are marked */
+#define COMP_CONST       0x8000
+
+/* Jump target not known yet */
+#define COMP_NOTARGET    0xFFFFFFFF
+
+/* Limits */
+#define COMP_MAXARGS     16              /* max. number of function arguments */
+#define COMP_MAXMEM      0x1000000       /* max. size of the data area */
+#define COMP_MAXIND      8               /* max. number of induction registers of nested FOR loops */
+#define COMP_UNROLL_TRIP 8               /* max. number of iterations of an unrolled FOR loop */
+#define COMP_UNROLL_NODE 96              /* max. number of nodes of all copies of an unrolled body */
+
+/* Stack of the task of mist_PrgDepthTest(), like the SMI server tasks which compile programs */
+#define COMP_TEST_STACK  10000
+
+/* Shapes of the programs of mist_PrgDepthTest() */
+#define COMP_TEST_ELSIF  1               /* IF with N - 1 ELSIF */
+#define COMP_TEST_SUM    2               /* sum of N terms */
+#define COMP_TEST_IF     3               /* N nested IF */
+#define COMP_TEST_CALL   4               /* N nested calls of ABS() */
+
+/* Alignment to 8 bytes */
+#define COMP_ALIGN8(x)   (((x) + 7) & ~7)
+
+/* Properties of the elementary data types */
+typedef struct COMP_TYPE
+{
+    UINT8   Cls;                        /* computation class MIST_CLS_xxx, 0 = not supported */
+    UINT8   Size;                       /* size in bytes */
+    UINT8   Load;                       /* load instruction MIST_I_LDxx */
+    UINT8   Narrow;                     /* truncation of conversions to this type, 0 = none */
+    UINT8   Svi;                        /* SVI format of an exported variable, SVI_F_xxx */
+} COMP_TYPE;
+
+/* Standard function */
+typedef struct COMP_FUNC
+{
+    const CHAR *pName;                  /* name in upper case */
+    UINT8   Id;                         /* MIST_F_xxx */
+    UINT8   MinArgs;                    /* min. number of arguments */
+    UINT8   MaxArgs;                    /* max. number of arguments */
+} COMP_FUNC;
+
+/* POU of the program cache, identified by its text */
+typedef struct COMP_POU
+{
+    struct COMP_POU *pNext;             /* next POU of the cache */
+    UINT32  Hash;                       /* mist_SrcHash() of the text */
+    UINT32  Length;                     /* length of the text */
+    CHAR   *pText;                      /* copy of the text, stored behind the entry */
+    CHAR   *pName;                      /* program name, stored behind the text */
+    MIST_CODE *pCode;                   /* compiled program, NULL = only parsed */
+    UINT32  RefCount;                   /* users of pCode, see mist_PrgCacheRelease() */
+    UINT32  Gen;                        /* generation of the last load */
+} COMP_POU;
+
+/* Source file of the program cache, identified by its name and text */
+typedef struct COMP_FILE
+{
+    struct COMP_FILE *pNext;            /* next file of the cache */
+    UINT32  Hash;                       /* mist_SrcHash() of the whole file */
+    UINT32  Length;                     /* length of the file */
+    UINT32  Gen;                        /* generation of the last load */
+    UINT32  NbOfPous;                   /* number of POUs, > 0 */
+    COMP_POU **ppPous;                  /* POUs in source order, stored behind the entry */
+    CHAR   *pText;                      /* copy of the text, stored behind the POU list */
+    CHAR   *pName;                      /* file name, stored behind the text */
+} COMP_FILE;
+
+/* Loop being compiled, for EXIT and CONTINUE */
+typedef struct COMP_LOOP
+{
+    struct COMP_LOOP *pOuter;           /* enclosing loop */
+    UINT32  ExitList;                   /* jumps to the end of the loop */
+    UINT32  ContList;                   /* forward jumps of CONTINUE */
+    UINT32  ContTarget;                 /* target of CONTINUE if known, else COMP_NOTARGET */
+} COMP_LOOP;
+
+/* FOR loop with a number of iterations known at compile time, see Comp_ForTrip() */
+typedef struct COMP_TRIP
+{
+    UINT32  Count;                      /* number of iterations, > 0 */
+    SINT64  First;                      /* value of the control variable in the first iteration */
+    SINT64  Last;                       /* value of the control variable in the last iteration */
+    SINT64  Step;                       /* increment */
+    MIST_REG Final;                     /* value after the loop, truncated to the control variable */
+} COMP_TRIP;
+
+/* Array element following the control variable of a FOR loop, see Comp_Induct() */
+typedef struct COMP_IND
+{
+    const MIST_VAR *pArray;             /* array with one dimension */
+    const MIST_VAR *pVar;               /* control variable */
+    SINT32  Add;                        /* index = control variable + Add */
+    UINT32  Reg;                        /* temporary register holding the data offset of the element */
+} COMP_IND;
+
+/* Dependency analysis of the statements of the program body, see Comp_Body() */
+typedef struct COMP_DEP
+{
+    UINT8  *pWritten;                   /* variable is assigned by a statement, by MIST_VAR.Index */
+    UINT32 *pOwner;                     /* first statement using the variable, COMP_NOTARGET = none */
+    UINT32 *pParent;                    /* group of each statement, union find */
+    BOOL    Return;                     /* the body contains RETURN */
+} COMP_DEP;
+
+/* Program compiled by the task of mist_PrgDepthTest() */
+typedef struct COMP_TEST
+{
+    CHAR   *pSrc;                       /* source text */
+    SEM_ID  DoneSema;                   /* given by the task when it is done */
+    SINT32  Ret;                        /* result of parsing and compiling */
+    UINT32  StackHigh;                  /* max. stack usage of the task in bytes, 0 = unknown */
+    CHAR    ErrText[160];               /* error with its line */
+} COMP_TEST;
+
+/* Compiler state */
+typedef struct COMPILER
+{
+    MIST_UNIT *pUnit;                   /* compilation unit, receives the error */
+    MIST_POU *pPou;                     /* POU being compiled */
+    const CHAR *pSrc;                   /* source buffer, for error lines */
+    MIST_INSTR *pInstr;                 /* instructions */
+    UINT32  NbOfInstr;
+    UINT32  MaxInstr;
+    MIST_REG *pConst;                   /* constants */
+    UINT32  NbOfConsts;
+    UINT32  MaxConsts;
+    MIST_VM_DESC *pDesc;                /* index descriptors */
+    UINT32  NbOfDescs;
+    UINT32  MaxDescs;
+    UINT32 *pVarDesc;                   /* first descriptor of each array variable */
+    MIST_VM_BLOCK *pBlock;              /* block descriptors */
+    UINT32  NbOfBlocks;
+    UINT32  MaxBlocks;
+    MIST_VM_VOP *pVop;                  /* operations of element-wise kernels */
+    UINT32  NbOfVops;
+    UINT32  MaxVops;
+    UINT32  Seg[MIST_VM_MAXSEGS];       /* first instruction of each independent segment */
+    UINT32  NbOfSegs;
+    UINT8  *pInit;                      /* initial values of the data area */
+    UINT32  MemSize;                    /* size of the data area */
+    UINT32  TempOffset;                 /* start of the VAR_TEMP region */
+    UINT32  NextTemp;                   /* next free temporary register */
+    UINT32  MaxTemp;                    /* number of temporary registers used */
+    COMP_LOOP *pLoop;                   /* innermost loop */
+    COMP_IND Ind[COMP_MAXIND];          /* induction registers of the FOR loops being compiled */
+    UINT32  NbOfInd;
+    UINT32  NbOfOptNodes;               /* nodes removed by Comp_Optimize() */
+    UINT32  Error;                      /* an error occurred, compiling is aborted */
+} COMPILER;
+
+/* Program cache, only used by the bTask (configuration) */
+MLOCAL COMP_POU *CompPous = NULL;
+MLOCAL COMP_FILE *CompFiles = NULL;
+MLOCAL UINT32 CompGen = 1;
+
+/* Elementary data types, index is MIST_KW_xxx */
+MLOCAL const COMP_TYPE CompType[MIST_KW_COUNT] = {
+    [MIST_KW_BOOL] = {MIST_CLS_BOOL, 1, MIST_I_LDU8, 0, SVI_F_BOOL8},
+    [MIST_KW_SINT] = {MIST_CLS_INT, 1, MIST_I_LDS8, MIST_I_SX8, SVI_F_SINT8},
+    [MIST_KW_INT] = {MIST_CLS_INT, 2, MIST_I_LDS16, MIST_I_SX16, SVI_F_SINT16},
+    [MIST_KW_DINT] = {MIST_CLS_INT, 4, MIST_I_LD32, 0, SVI_F_SINT32},
+    [MIST_KW_USINT] = {MIST_CLS_INT, 1, MIST_I_LDU8, MIST_I_ZX8, SVI_F_UINT8},
+    [MIST_KW_UINT] = {MIST_CLS_INT, 2, MIST_I_LDU16, MIST_I_ZX16, SVI_F_UINT16},
+    [MIST_KW_UDINT] = {MIST_CLS_UINT, 4, MIST_I_LD32, 0, SVI_F_UINT32},
+    [MIST_KW_REAL] = {MIST_CLS_REAL, 4, MIST_I_LD32, 0, SVI_F_REAL32},
+    [MIST_KW_LREAL] = {MIST_CLS_LREAL, 8, MIST_I_LD64, 0, SVI_F_REAL64},
+    [MIST_KW_TIME] = {MIST_CLS_INT, 4, MIST_I_LD32, 0, SVI_F_SINT32},
+    [MIST_KW_BYTE] = {MIST_CLS_INT, 1, MIST_I_LDU8, MIST_I_ZX8, SVI_F_UINT8},
+    [MIST_KW_WORD] = {MIST_CLS_INT, 2, MIST_I_LDU16, MIST_I_ZX16, SVI_F_UINT16},
+    [MIST_KW_DWORD] = {MIST_CLS_UINT, 4, MIST_I_LD32, 0, SVI_F_UINT32}
+};
+
+/* Data types of folded literals, index is MIST_CLS_xxx */
+MLOCAL const UINT8 CompLitType[MIST_CLS_LREAL + 1] = {
+    0, MIST_KW_BOOL, MIST_KW_DINT, MIST_KW_UDINT, MIST_KW_REAL, MIST_KW_LREAL
+};
+
+/* Names of the computation classes for error texts */
+MLOCAL const CHAR *const CompClsName[] = {"?", "BOOL", "integer", "unsigned integer", "REAL", "LREAL"};
+
+/* Instructions of binary operators, index is MIST_OP_xxx and MIST_CLS_xxx */
+MLOCAL const UINT8 CompBinOp[MIST_OP_XOR + 1][MIST_CLS_LREAL + 1] = {
+    [MIST_OP_ADD] = {0, 0, MIST_I_ADD, MIST_I_ADD, MIST_I_ADDF, MIST_I_ADDD},
+    [MIST_OP_SUB] = {0, 0, MIST_I_SUB, MIST_I_SUB, MIST_I_SUBF, MIST_I_SUBD},
+    [MIST_OP_MUL] = {0, 0, MIST_I_MUL, MIST_I_MUL, MIST_I_MULF, MIST_I_MULD},
+    [MIST_OP_DIV] = {0, 0, MIST_I_DIV, MIST_I_DIVU, MIST_I_DIVF, MIST_I_DIVD},
+    [MIST_OP_MOD] = {0, 0, MIST_I_MOD, MIST_I_MODU, 0, 0},
+    [MIST_OP_POW] = {0, 0, 0, 0, MIST_I_POWF, MIST_I_POWD},
+    [MIST_OP_AND] = {0, MIST_I_AND, MIST_I_AND, MIST_I_AND, 0, 0},
+    [MIST_OP_OR] = {0, MIST_I_OR, MIST_I_OR, MIST_I_OR, 0, 0},
+    [MIST_OP_XOR] = {0, MIST_I_XOR, MIST_I_XOR, MIST_I_XOR, 0, 0},
+    [MIST_OP_EQ] = {0, MIST_I_EQ, MIST_I_EQ, MIST_I_EQ, MIST_I_EQF, MIST_I_EQD},
+    [MIST_OP_NE] = {0, MIST_I_NE, MIST_I_NE, MIST_I_NE, MIST_I_NEF, MIST_I_NED},
+    [MIST_OP_LT] = {0, MIST_I_LTU, MIST_I_LT, MIST_I_LTU, MIST_I_LTF, MIST_I_LTD},
+    [MIST_OP_LE] = {0, MIST_I_LEU, MIST_I_LE, MIST_I_LEU, MIST_I_LEF, MIST_I_LED},
+    [MIST_OP_GT] = {0, MIST_I_GTU, MIST_I_GT, MIST_I_GTU, MIST_I_GTF, MIST_I_GTD},
+    [MIST_OP_GE] = {0, MIST_I_GEU, MIST_I_GE, MIST_I_GEU, MIST_I_GEF, MIST_I_GED}
+};
+
+/* Standard functions, conversions X_TO_Y are resolved separately */
+MLOCAL const COMP_FUNC CompFunc[] = {
+    {"ABS", MIST_F_ABS, 1, 1},
+    {"SQRT", MIST_F_SQRT, 1, 1},
+    {"SIN", MIST_F_SIN, 1, 1},
+    {"COS", MIST_F_COS, 1, 1},
+    {"TAN", MIST_F_TAN, 1, 1},
+    {"ASIN", MIST_F_ASIN, 1, 1},
+    {"ACOS", MIST_F_ACOS, 1, 1},
+    {"ATAN", MIST_F_ATAN, 1, 1},
+    {"EXP", MIST_F_EXP, 1, 1},
+    {"LN", MIST_F_LN, 1, 1},
+    {"LOG", MIST_F_LOG, 1, 1},
+    {"EXPT", MIST_F_EXPT, 2, 2},
+    {"TRUNC", MIST_F_TRUNC, 1, 1},
+    {"MIN", MIST_F_MIN, 2, COMP_MAXARGS},
+    {"MAX", MIST_F_MAX, 2, COMP_MAXARGS},
+    {"LIMIT", MIST_F_LIMIT, 3, 3},
+    {"SEL", MIST_F_SEL, 3, 3}
+};
+
+/* Functions: compiler, being called only within this file */
+MLOCAL VOID Comp_Error(COMPILER * c, UINT32 Offset, const CHAR * pFmt, ...);
+MLOCAL BOOL Comp_Grow(COMPILER * c, VOID ** ppArray, UINT32 * pMax, UINT32 Count, UINT32 Size);
+MLOCAL UINT32 Comp_Emit(COMPILER * c, UINT32 Op, UINT32 A, UINT32 B, UINT32 C);
+MLOCAL UINT32 Comp_EmitImm(COMPILER * c, UINT32 Op, UINT32 A, UINT32 Imm);
+MLOCAL VOID Comp_Jump(COMPILER * c, UINT32 Op, UINT32 Reg, UINT32 * pList);
+MLOCAL VOID Comp_Patch(COMPILER * c, UINT32 List, UINT32 Target);
+MLOCAL UINT32 Comp_Temp(COMPILER * c);
+MLOCAL UINT32 Comp_Const(COMPILER * c, const MIST_REG * pValue);
+MLOCAL UINT32 Comp_ConstInt(COMPILER * c, SINT32 Value);
+MLOCAL BOOL Comp_IsLiteral(const MIST_NODE * pNode);
+MLOCAL BOOL Comp_CanConvert(UINT32 From, UINT32 To);
+MLOCAL VOID Comp_LitValue(const MIST_NODE * pNode, UINT32 Cls, MIST_REG * pValue);
+MLOCAL UINT32 Comp_Common(MIST_NODE ** ppArgs, UINT32 NbOfArgs);
+MLOCAL BOOL Comp_SameName(const CHAR * pStr, UINT32 Length, const CHAR * pName);
+MLOCAL UINT32 Comp_TypeCall(COMPILER * c, MIST_NODE * pNode);
+MLOCAL UINT32 Comp_TypeBinary(COMPILER * c, MIST_NODE * pNode, UINT32 ClsA);
+MLOCAL UINT32 Comp_Type(COMPILER * c, MIST_NODE * pNode);
+MLOCAL UINT32 Comp_Convert(COMPILER * c, const MIST_NODE * pNode, UINT32 Reg, UINT32 From, UINT32 To);
+MLOCAL UINT32 Comp_Desc(COMPILER * c, const MIST_VAR * pVar);
+MLOCAL BOOL Comp_ConstOffset(COMPILER * c, const MIST_NODE * pNode, UINT32 * pOffset);
+MLOCAL UINT32 Comp_Address(COMPILER * c, const MIST_NODE * pNode);
+MLOCAL UINT32 Comp_Call(COMPILER * c, MIST_NODE * pNode);
+MLOCAL UINT32 Comp_BinClass(const MIST_NODE * pNode);
+MLOCAL UINT32 Comp_Value(COMPILER * c, MIST_NODE * pNode);
+MLOCAL UINT32 Comp_Expr(COMPILER * c, MIST_NODE * pNode, UINT32 Cls);
+MLOCAL UINT32 Comp_Cond(COMPILER * c, MIST_NODE * pNode);
+MLOCAL VOID Comp_Store(COMPILER * c, const MIST_NODE * pTarget, UINT32 Reg);
+MLOCAL VOID Comp_StmtList(COMPILER * c, MIST_NODE * pStmt);
+MLOCAL VOID Comp_If(COMPILER * c, MIST_NODE * pNode);
+MLOCAL VOID Comp_Case(COMPILER * c, MIST_NODE * pNode);
+MLOCAL BOOL Comp_IndForm(const MIST_NODE * pIdx, const MIST_VAR * pVar, SINT32 * pAdd);
+MLOCAL BOOL Comp_IndRange(const MIST_NODE * pNode, const MIST_VAR * pVar, const COMP_TRIP * pTrip, SINT32 * pAdd);
+MLOCAL VOID Comp_Induct(COMPILER * c, MIST_NODE * pNode, const MIST_VAR * pVar, const COMP_TRIP * pTrip, BOOL Regs);
+MLOCAL UINT32 Comp_IndReg(COMPILER * c, const MIST_NODE * pNode);
+MLOCAL BOOL Comp_Invariant(const MIST_NODE * pNode, const MIST_VAR * pVar);
+MLOCAL UINT32 Comp_VecLanes(const MIST_NODE * pNode, const MIST_VAR * pVar, const COMP_TRIP * pTrip,
+                            const MIST_VAR * pDst, SINT32 DstAdd);
+MLOCAL VOID Comp_Vop(COMPILER * c, UINT32 Op, UINT32 Dst, UINT32 A, UINT32 B, UINT32 Arg);
+MLOCAL VOID Comp_VecGen(COMPILER * c, MIST_NODE * pNode, const MIST_VAR * pVar, const COMP_TRIP * pTrip, UINT32 Lane);
+MLOCAL UINT32 Comp_ForBlock(const MIST_NODE * pNode, const COMP_TRIP * pTrip, MIST_VM_BLOCK * pK);
+MLOCAL VOID Comp_ForCount(COMPILER * c, MIST_NODE * pNode, const COMP_TRIP * pTrip);
+MLOCAL VOID Comp_For(COMPILER * c, MIST_NODE * pNode);
+MLOCAL VOID Comp_Stmt(COMPILER * c, MIST_NODE * pNode);
+MLOCAL VOID Comp_InitVar(COMPILER * c, const MIST_VAR * pVar);
+MLOCAL VOID Comp_Layout(COMPILER * c);
+MLOCAL UINT32 Comp_DepFind(const COMP_DEP * d, UINT32 Stmt);
+MLOCAL VOID Comp_DepList(COMP_DEP * d, const MIST_NODE * pNode, UINT32 Stmt);
+MLOCAL VOID Comp_DepNode(COMP_DEP * d, const MIST_NODE * pNode, UINT32 Stmt);
+MLOCAL VOID Comp_Body(COMPILER * c);
+MLOCAL int Comp_VarCmp(const VOID * pA, const VOID * pB);
+MLOCAL int Comp_SviCmp(const VOID * pA, const VOID * pB);
+MLOCAL MIST_CODE *Comp_Finish(COMPILER * c);
+
+/* Functions: optimizer, being called only within this file */
+MLOCAL UINT32 Comp_Count(const MIST_NODE * pNode);
+MLOCAL BOOL Comp_FoldOp(UINT32 Op, const MIST_REG * pB, const MIST_REG * pC, MIST_REG * pA);
+MLOCAL VOID Comp_SetLit(MIST_NODE * pNode, UINT32 Cls, const MIST_REG * pValue);
+MLOCAL VOID Comp_InitValue(COMPILER * c, const MIST_VAR * pVar, UINT32 Offset, MIST_REG * pValue);
+MLOCAL VOID Comp_FoldCall(MIST_NODE * pNode);
+MLOCAL VOID Comp_FoldBinary(COMPILER * c, MIST_NODE * pNode);
+MLOCAL VOID Comp_Fold(COMPILER * c, MIST_NODE * pNode);
+MLOCAL BOOL Comp_Straight(const MIST_NODE * pStmt, const MIST_VAR * pVar, BOOL Nested);
+MLOCAL BOOL Comp_ForTrip(const MIST_NODE * pNode, COMP_TRIP * pTrip);
+MLOCAL MIST_NODE *Comp_Clone(COMPILER * c, const MIST_NODE * pNode);
+MLOCAL VOID Comp_Subst(MIST_NODE * pNode, const MIST_VAR * pVar, UINT32 Cls, const MIST_REG * pValue);
+MLOCAL BOOL Comp_OptFor(COMPILER * c, MIST_NODE * pNode, MIST_NODE ** ppList);
+MLOCAL BOOL Comp_OptIf(COMPILER * c, MIST_NODE * pNode, MIST_NODE ** ppList);
+MLOCAL BOOL Comp_OptStmt(COMPILER * c, MIST_NODE * pNode, MIST_NODE ** ppList);
+MLOCAL VOID Comp_OptList(COMPILER * c, MIST_NODE ** ppStmt);
+MLOCAL UINT32 Comp_Optimize(COMPILER * c);
+
+/* Functions: program cache, being called only within this file */
+MLOCAL COMP_POU *Comp_CachePou(const MIST_SOURCE * pSrc, UINT32 Start, UINT32 End, BOOL Compile, UINT32 * pNbOfBuilt);
+
+/* Functions: test functions, to be called from the shell */
+SINT32  mist_PrgCacheShow(VOID);
+SINT32  mist_PrgDepthTest(VOID);
+MLOCAL CHAR *Comp_TestSrc(UINT32 Shape, UINT32 N);
+MLOCAL VOID Comp_TestMain(COMP_TEST * t);
+
+
+/**
+********************************************************************************
+* @brief Records the first compile error with its source line.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  Offset   source offset of the error
+* @param[in]  pFmt     format string of error text
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_Error(COMPILER * c, UINT32 Offset, const CHAR * pFmt, ...)
+{
+    va_list Args;
+
+    if (c->Error)
+        return;
+    c->Error = TRUE;
+
+    c->pUnit->ErrLine = mist_LexLine(c->pSrc, Offset);
+    va_start(Args, pFmt);
+    vsnprintf(c->pUnit->ErrText, sizeof(c->pUnit->ErrText), pFmt, Args);
+    va_end(Args);
+}
+
+/**
+********************************************************************************
+* @brief Makes room for one more element of a growing array.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  ppArray  pointer to array pointer
+* @param[in]  pMax     pointer to allocated number of elements
+* @param[in]  Count    used number of elements
+* @param[in]  Size     size of an element
+* @param[out] N/A
+*
+* @retval     TRUE  .. there is room for another element
+* @retval     FALSE .. out of memory, error has been recorded
+*******************************************************************************/
+MLOCAL BOOL Comp_Grow(COMPILER * c, VOID ** ppArray, UINT32 * pMax, UINT32 Count, UINT32 Size)
+{
+    VOID   *pNew;
+    UINT32  Max;
+
+    if (Count < *pMax)
+        return (TRUE);
+
+    Max = *pMax ? *pMax * 2 : 256;
+    pNew = realloc(*ppArray, Max * Size);
+    if (!pNew)
+    {
+        Comp_Error(c, c->pPou->Offset, "out of memory");
+        return (FALSE);
+    }
+    *ppArray = pNew;
+    *pMax = Max;
+    return (TRUE);
+}
+
+/**
+********************************************************************************
+* @brief Appends an instruction.
+*        Comp_EmitImm() takes a 32 bit data offset or jump target as operand.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  Op       operation code MIST_I_xxx
+* @param[in]  A, B, C  operands
+* @param[out] N/A
+*
+* @retval     index of the instruction
+*******************************************************************************/
+MLOCAL UINT32 Comp_Emit(COMPILER * c, UINT32 Op, UINT32 A, UINT32 B, UINT32 C)
+{
+    MIST_INSTR *pI;
+
+    if (!Comp_Grow(c, (VOID **) &c->pInstr, &c->MaxInstr, c->NbOfInstr, sizeof(MIST_INSTR)))
+        return (0);
+
+    pI = &c->pInstr[c->NbOfInstr];
+    pI->Op = Op;
+    pI->A = A;
+    pI->B = B;
+    pI->C = C;
+    return (c->NbOfInstr++);
+}
+
+MLOCAL UINT32 Comp_EmitImm(COMPILER * c, UINT32 Op, UINT32 A, UINT32 Imm)
+{
+    return (Comp_Emit(c, Op, A, Imm >> 16, Imm & 0xFFFF));
+}
+
+/**
+********************************************************************************
+* @brief Appends a forward jump with unknown target to a patch list.
+*        The list is linked through the target operands of the jumps,
+*        each entry holds the index of the next jump + 1, 0 ends the list.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  Op       jump instruction MIST_I_JMP, MIST_I_JZ, MIST_I_JNZ
+* @param[in]  Reg      condition register, 0 for MIST_I_JMP
+* @param[in]  pList    pointer to patch list
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_Jump(COMPILER * c, UINT32 Op, UINT32 Reg, UINT32 * pList)
+{
+    *pList = Comp_EmitImm(c, Op, Reg, *pList) + 1;
+}
+
+/**
+********************************************************************************
+* @brief Sets the target of all jumps of a patch list.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  List     patch list, see Comp_Jump()
+* @param[in]  Target   index of the target instruction
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_Patch(COMPILER * c, UINT32 List, UINT32 Target)
+{
+    MIST_INSTR *pI;
+
+    while (List && !c->Error)
+    {
+        pI = &c->pInstr[List - 1];
+        List = MIST_I_IMM(pI);
+        pI->B = Target >> 16;
+        pI->C = Target & 0xFFFF;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Allocates the next temporary register.
+*        Temporaries are released by resetting c->NextTemp, so the result
+*        of an expression is always the topmost temporary.
+*
+* @param[in]  c        pointer to compiler state
+* @param[out] N/A
+*
+* @retval     register number
+*******************************************************************************/
+MLOCAL UINT32 Comp_Temp(COMPILER * c)
+{
+    UINT32  Reg = c->NextTemp++;
+
+    if (c->NextTemp > c->MaxTemp)
+        c->MaxTemp = c->NextTemp;
+    if (Reg >= MIST_VM_MAXREGS)
+    {
+        Comp_Error(c, c->pPou->Offset, "expression too complex");
+        return (0);
+    }
+    return (Reg);
+}
+
+/**
+********************************************************************************
+* @brief Returns the constant register of a value, equal values share
+*        one register.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pValue   value, unused bytes must be 0
+* @param[out] N/A
+*
+* @retval     register number | COMP_CONST
+*******************************************************************************/
+MLOCAL UINT32 Comp_Const(COMPILER * c, const MIST_REG * pValue)
+{
+    UINT32  i;
+
+    for (i = 0; i < c->NbOfConsts; i++)
+    {
+        if (!memcmp(&c->pConst[i], pValue, sizeof(MIST_REG)))
+            return (i | COMP_CONST);
+    }
+
+    if (c->NbOfConsts >= MIST_VM_MAXREGS)
+    {
+        Comp_Error(c, c->pPou->Offset, "too many constants");
+        return (COMP_CONST);
+    }
+    if (!Comp_Grow(c, (VOID **) &c->pConst, &c->MaxConsts, c->NbOfConsts, sizeof(MIST_REG)))
+        return (COMP_CONST);
+
+    c->pConst[c->NbOfConsts] = *pValue;
+    return (c->NbOfConsts++ | COMP_CONST);
+}
+
+MLOCAL UINT32 Comp_ConstInt(COMPILER * c, SINT32 Value)
+{
+    MIST_REG Reg;
+
+    memset(&Reg, 0, sizeof(Reg));
+    Reg.i = Value;
+    return (Comp_Const(c, &Reg));
+}
+
+/**
+********************************************************************************
+* @brief Checks if a node is a literal.
+*
+* @param[in]  pNode    pointer to node
+* @param[out] N/A
+*
+* @retval     TRUE, FALSE
+*******************************************************************************/
+MLOCAL BOOL Comp_IsLiteral(const MIST_NODE * pNode)
+{
+    return ((pNode->Type == MIST_N_INT) || (pNode->Type == MIST_N_REAL));
+}
+
+/**
+********************************************************************************
+* @brief Checks if a computation class can be converted implicitly.
+*        BOOL doesn't mix with numbers, REAL and LREAL need a conversion
+*        function to become integers.
+*
+* @param[in]  From     source class MIST_CLS_xxx
+* @param[in]  To       destination class MIST_CLS_xxx
+* @param[out] N/A
+*
+* @retval     TRUE, FALSE
+*******************************************************************************/
+MLOCAL BOOL Comp_CanConvert(UINT32 From, UINT32 To)
+{
+    if (From == To)
+        return (TRUE);
+    if ((From == MIST_CLS_BOOL) || (To == MIST_CLS_BOOL))
+        return (FALSE);
+    return ((From <= MIST_CLS_UINT) || (To >= MIST_CLS_REAL));
+}
+
+/**
+********************************************************************************
+* @brief Calculates the value of a literal in a computation class.
+*
+* @param[in]  pNode    literal node, class already assigned
+* @param[in]  Cls      destination class, see Comp_CanConvert()
+* @param[out] pValue   value, unused bytes are 0
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_LitValue(const MIST_NODE * pNode, UINT32 Cls, MIST_REG * pValue)
+{
+    REAL64  Real;
+
+    memset(pValue, 0, sizeof(*pValue));
+    if (pNode->Type == MIST_N_INT)
+    {
+        if (Cls <= MIST_CLS_UINT)
+        {
+            pValue->i = pNode->u.Int;
+            return;
+        }
+        Real = (pNode->Class == MIST_CLS_UINT) ? (REAL64) (UINT32) pNode->u.Int : (REAL64) pNode->u.Int;
+    }
+    else
+        Real = pNode->u.Real;
+
+    if (Cls == MIST_CLS_REAL)
+        pValue->f = (REAL32) Real;
+    else
+        pValue->d = Real;
+}
+
+/**
+********************************************************************************
+* @brief Determines the common class of operands and assigns REAL to
+*        untyped real literals next to REAL operands.
+*
+* @param[in]  ppArgs   operands, classes already assigned
+* @param[in]  NbOfArgs number of operands
+* @param[out] N/A
+*
+* @retval     common class MIST_CLS_xxx, highest rank
+*******************************************************************************/
+MLOCAL UINT32 Comp_Common(MIST_NODE ** ppArgs, UINT32 NbOfArgs)
+{
+    UINT32  Cls = MIST_CLS_NONE;
+    BOOL    Untyped = FALSE;
+    UINT32  i;
+
+    for (i = 0; i < NbOfArgs; i++)
+    {
+        if ((ppArgs[i]->Type == MIST_N_REAL) && !ppArgs[i]->DataType)
+            Untyped = TRUE;
+        else if (ppArgs[i]->Class > Cls)
+            Cls = ppArgs[i]->Class;
+    }
+    if (!Untyped)
+        return (Cls);
+
+    if (Cls != MIST_CLS_REAL)
+        return (MIST_CLS_LREAL);
+    for (i = 0; i < NbOfArgs; i++)
+    {
+        if ((ppArgs[i]->Type == MIST_N_REAL) && !ppArgs[i]->DataType)
+            ppArgs[i]->Class = MIST_CLS_REAL;
+    }
+    return (MIST_CLS_REAL);
+}
+
+/**
+********************************************************************************
+* @brief Compares an identifier with a name in upper case.
+*
+* @param[in]  pStr     pointer to identifier, not necessarily terminated
+* @param[in]  Length   length of identifier
+* @param[in]  pName    terminated name in upper case
+* @param[out] N/A
+*
+* @retval     TRUE, FALSE
+*******************************************************************************/
+MLOCAL BOOL Comp_SameName(const CHAR * pStr, UINT32 Length, const CHAR * pName)
+{
+    UINT32  i;
+
+    for (i = 0; i < Length; i++)
+    {
+        if (((UINT8) pStr[i] & 0xDF) != ((UINT8) pName[i] & 0xDF))
+            return (FALSE);
+    }
+    return (pName[Length] == 0);
+}
+
+/**
+********************************************************************************
+* @brief Resolves a function call and assigns the classes of the call
+*        and its arguments. The function is stored in pNode->Op,
+*        the destination type of conversions in pNode->DataType.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    MIST_N_CALL node
+* @param[out] N/A
+*
+* @retval     class of the result
+*******************************************************************************/
+MLOCAL UINT32 Comp_TypeCall(COMPILER * c, MIST_NODE * pNode)
+{
+    MIST_NODE *Args[COMP_MAXARGS];
+    MIST_NODE *pArg;
+    const CHAR *pName = pNode->u.pName;
+    const CHAR *pTo;
+    UINT32  NbOfArgs = 0;
+    UINT32  From, To;
+    UINT32  Cls;
+    UINT32  i;
+
+    for (pArg = pNode->pA; pArg; pArg = pArg->pNext)
+    {
+        if (NbOfArgs >= COMP_MAXARGS)
+        {
+            Comp_Error(c, pNode->Offset, "too many arguments for '%s'", pName);
+            return (MIST_CLS_NONE);
+        }
+        Args[NbOfArgs++] = pArg;
+        if (Comp_Type(c, pArg) == MIST_CLS_NONE)
+            return (MIST_CLS_NONE);
+    }
+
+    /* Type conversion X_TO_Y, the argument must fit to X */
+    for (pTo = pName; *pTo; pTo++)
+    {
+        if ((pTo[0] == '_') && ((pTo[1] & 0xDF) == 'T') && ((pTo[2] & 0xDF) == 'O') && (pTo[3] == '_'))
+            break;
+    }
+    if (*pTo && (pTo > pName))
+    {
+        From = mist_LexKeywordId(pName, pTo - pName);
+        To = mist_LexKeywordId(pTo + 4, strlen(pTo + 4));
+        if ((From >= MIST_KW_COUNT) || (To >= MIST_KW_COUNT) || !CompType[From].Cls || !CompType[To].Cls)
+        {
+            Comp_Error(c, pNode->Offset, "function '%s' is not supported", pName);
+            return (MIST_CLS_NONE);
+        }
+        if (NbOfArgs != 1)
+        {
+            Comp_Error(c, pNode->Offset, "'%s' needs 1 argument", pName);
+            return (MIST_CLS_NONE);
+        }
+        if (!Comp_CanConvert(Args[0]->Class, CompType[From].Cls))
+        {
+            Comp_Error(c, Args[0]->Offset, "argument of '%s' must be %s", pName, CompClsName[CompType[From].Cls]);
+            return (MIST_CLS_NONE);
+        }
+        pNode->Op = MIST_F_CONV;
+        pNode->DataType = To;
+        return (CompType[To].Cls);
+    }
+
+    for (i = 0; i < sizeof(CompFunc) / sizeof(CompFunc[0]); i++)
+    {
+        if (Comp_SameName(pName, strlen(pName), CompFunc[i].pName))
+            break;
+    }
+    if (i >= sizeof(CompFunc) / sizeof(CompFunc[0]))
+    {
+        Comp_Error(c, pNode->Offset, "function '%s' is not supported", pName);
+        return (MIST_CLS_NONE);
+    }
+    if ((NbOfArgs < CompFunc[i].MinArgs) || (NbOfArgs > CompFunc[i].MaxArgs))
+    {
+        Comp_Error(c, pNode->Offset, "wrong number of arguments for '%s'", CompFunc[i].pName);
+        return (MIST_CLS_NONE);
+    }
+    pNode->Op = CompFunc[i].Id;
+
+    /* SEL(G, IN0, IN1): G is BOOL, the inputs have a common class */
+    if (pNode->Op == MIST_F_SEL)
+    {
+        if (Args[0]->Class != MIST_CLS_BOOL)
+        {
+            Comp_Error(c, Args[0]->Offset, "BOOL expression expected");
+            return (MIST_CLS_NONE);
+        }
+        if ((Args[1]->Class == MIST_CLS_BOOL) != (Args[2]->Class == MIST_CLS_BOOL))
+        {
+            Comp_Error(c, pNode->Offset, "type mismatch: %s and %s", CompClsName[Args[1]->Class],
+                       CompClsName[Args[2]->Class]);
+            return (MIST_CLS_NONE);
+        }
+        return (Comp_Common(&Args[1], 2));
+    }
+
+    /* All other functions take numbers */
+    for (i = 0; i < NbOfArgs; i++)
+    {
+        if (Args[i]->Class == MIST_CLS_BOOL)
+        {
+            Comp_Error(c, Args[i]->Offset, "numeric expression expected");
+            return (MIST_CLS_NONE);
+        }
+    }
+    Cls = Comp_Common(Args, NbOfArgs);
+
+    switch (pNode->Op)
+    {
+        case MIST_F_ABS:
+        case MIST_F_MIN:
+        case MIST_F_MAX:
+        case MIST_F_LIMIT:
+            return (Cls);
+        case MIST_F_TRUNC:
+            return (MIST_CLS_INT);
+        default:
+            /* Math functions and EXPT are calculated with REAL or LREAL */
+            return ((Cls == MIST_CLS_REAL) ? MIST_CLS_REAL : MIST_CLS_LREAL);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Assigns the classes of a binary operation and its second operand.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    MIST_N_BINARY node
+* @param[in]  ClsA     class of the first operand, typed by the caller
+* @param[out] N/A
+*
+* @retval     class of the result
+*******************************************************************************/
+MLOCAL UINT32 Comp_TypeBinary(COMPILER * c, MIST_NODE * pNode, UINT32 ClsA)
+{
+    MIST_NODE *Args[2];
+    UINT32  ClsB;
+    UINT32  Cls;
+
+    ClsB = Comp_Type(c, pNode->pB);
+    if ((ClsA == MIST_CLS_NONE) || (ClsB == MIST_CLS_NONE))
+        return (MIST_CLS_NONE);
+
+    if ((ClsA == MIST_CLS_BOOL) != (ClsB == MIST_CLS_BOOL))
+    {
+        Comp_Error(c, pNode->Offset, "type mismatch: %s and %s", CompClsName[ClsA], CompClsName[ClsB]);
+        return (MIST_CLS_NONE);
+    }
+    Args[0] = pNode->pA;
+    Args[1] = pNode->pB;
+    Cls = Comp_Common(Args, 2);
+
+    switch (pNode->Op)
+    {
+        case MIST_OP_EQ:
+        case MIST_OP_NE:
+        case MIST_OP_LT:
+        case MIST_OP_LE:
+        case MIST_OP_GT:
+        case MIST_OP_GE:
+            return (MIST_CLS_BOOL);
+
+        case MIST_OP_POW:
+            if (Cls != MIST_CLS_BOOL)
+                return ((Cls == MIST_CLS_REAL) ? MIST_CLS_REAL : MIST_CLS_LREAL);
+            break;
+
+        default:
+            if (CompBinOp[pNode->Op][Cls])
+                return (Cls);
+            break;
+    }
+
+    Comp_Error(c, pNode->Offset, "operator not allowed for %s", CompClsName[Cls]);
+    return (MIST_CLS_NONE);
+}
+
+/**
+********************************************************************************
+* @brief Assigns the computation class to an expression and all its
+*        operands (pNode->Class). A chain of binary operators is typed
+*        in a loop from its innermost node, see mist_NodeChain().
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    expression
+* @param[out] N/A
+*
+* @retval     class MIST_CLS_xxx, MIST_CLS_NONE after an error
+*******************************************************************************/
+MLOCAL UINT32 Comp_Type(COMPILER * c, MIST_NODE * pNode)
+{
+    MIST_NODE *pIdx;
+    MIST_NODE *pBin;
+    UINT32  Cls = MIST_CLS_NONE;
+    UINT32  Len;
+
+    switch (pNode->Type)
+    {
+        case MIST_N_INT:
+            Cls = pNode->DataType ? CompType[pNode->DataType].Cls : MIST_CLS_INT;
+            break;
+
+        case MIST_N_REAL:
+            Cls = (pNode->DataType == MIST_KW_REAL) ? MIST_CLS_REAL : MIST_CLS_LREAL;
+            break;
+
+        case MIST_N_VAR:
+            if (pNode->u.pVar->NbOfDims)
+                Comp_Error(c, pNode->Offset, "array '%s' needs an index", pNode->u.pVar->pName);
+            else
+                Cls = CompType[pNode->u.pVar->Type].Cls;
+            break;
+
+        case MIST_N_INDEX:
+            for (pIdx = pNode->pB; pIdx; pIdx = pIdx->pNext)
+            {
+                Cls = Comp_Type(c, pIdx);
+                if ((Cls != MIST_CLS_INT) && (Cls != MIST_CLS_UINT))
+                {
+                    if (Cls != MIST_CLS_NONE)
+                        Comp_Error(c, pIdx->Offset, "array index must be an integer");
+                    return (MIST_CLS_NONE);
+                }
+            }
+            Cls = CompType[pNode->pA->u.pVar->Type].Cls;
+            pNode->pA->Class = Cls;
+            break;
+
+        case MIST_N_UNARY:
+            Cls = Comp_Type(c, pNode->pA);
+            if (((pNode->Op == MIST_OP_SUB) && (Cls == MIST_CLS_BOOL)) ||
+                ((pNode->Op == MIST_OP_NOT) && (Cls >= MIST_CLS_REAL)))
+            {
+                Comp_Error(c, pNode->Offset, "operator not allowed for %s", CompClsName[Cls]);
+                Cls = MIST_CLS_NONE;
+            }
+            break;
+
+        case MIST_N_BINARY:
+            Len = mist_NodeChain(pNode);
+            Cls = Comp_Type(c, mist_NodeLeft(pNode, Len));
+            while (Len-- > 0)
+            {
+                pBin = mist_NodeLeft(pNode, Len);
+                Cls = Comp_TypeBinary(c, pBin, Cls);
+                pBin->Class = Cls;
+            }
+            break;
+
+        case MIST_N_CALL:
+            Cls = Comp_TypeCall(c, pNode);
+            break;
+
+        default:
+            Comp_Error(c, pNode->Offset, "invalid expression");
+            break;
+    }
+
+    pNode->Class = Cls;
+    return (Cls);
+}
+
+/**
+********************************************************************************
+* @brief Converts a value implicitly to another class.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    expression, for the error position
+* @param[in]  Reg      register holding the value, the topmost temporary
+*                      or a constant
+* @param[in]  From     class of the value
+* @param[in]  To       requested class
+* @param[out] N/A
+*
+* @retval     register holding the converted value
+*******************************************************************************/
+MLOCAL UINT32 Comp_Convert(COMPILER * c, const MIST_NODE * pNode, UINT32 Reg, UINT32 From, UINT32 To)
+{
+    UINT32  Dst;
+    UINT32  Op;
+
+    if ((From == To) || ((From <= MIST_CLS_UINT) && (To <= MIST_CLS_UINT) && Comp_CanConvert(From, To)))
+        return (Reg);
+    if (!Comp_CanConvert(From, To))
+    {
+        Comp_Error(c, pNode->Offset, "%s can't be converted to %s implicitly", CompClsName[From], CompClsName[To]);
+        return (Reg);
+    }
+
+    if (From == MIST_CLS_INT)
+        Op = (To == MIST_CLS_REAL) ? MIST_I_ITOF : MIST_I_ITOD;
+    else if (From == MIST_CLS_UINT)
+        Op = (To == MIST_CLS_REAL) ? MIST_I_UTOF : MIST_I_UTOD;
+    else
+        Op = (To == MIST_CLS_REAL) ? MIST_I_DTOF : MIST_I_FTOD;
+
+    Dst = (Reg & COMP_CONST) ? Comp_Temp(c) : Reg;
+    Comp_Emit(c, Op, Dst, Reg, 0);
+    return (Dst);
+}
+
+/**
+********************************************************************************
+* @brief Returns the index descriptors of an array, they are created on
+*        first use. The scale of a dimension is the size of all following
+*        dimensions, so indexes are combined like a Horner scheme.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pVar     array variable
+* @param[out] N/A
+*
+* @retval     index of the descriptor of the first dimension
+*******************************************************************************/
+MLOCAL UINT32 Comp_Desc(COMPILER * c, const MIST_VAR * pVar)
+{
+    MIST_VM_DESC *pDesc;
+    UINT32  Scale = pVar->ElemSize;
+    UINT32  First = c->NbOfDescs;
+    SINT32  Dim;
+
+    if (c->pVarDesc[pVar->Index] != COMP_NOTARGET)
+        return (c->pVarDesc[pVar->Index]);
+
+    if (First + pVar->NbOfDims > 0xFFFF)
+    {
+        Comp_Error(c, pVar->Offset, "too many arrays");
+        return (0);
+    }
+    for (Dim = 0; Dim < pVar->NbOfDims; Dim++)
+    {
+        if (!Comp_Grow(c, (VOID **) &c->pDesc, &c->MaxDescs, c->NbOfDescs, sizeof(MIST_VM_DESC)))
+            return (0);
+        c->NbOfDescs++;
+    }
+
+    for (Dim = pVar->NbOfDims - 1; Dim >= 0; Dim--)
+    {
+        pDesc = &c->pDesc[First + Dim];
+        pDesc->Base = Dim ? 0 : pVar->MemOffset;
+        pDesc->Lower = pVar->Lower[Dim];
+        pDesc->Count = (UINT32) (pVar->Upper[Dim] - pVar->Lower[Dim]) + 1;
+        pDesc->Scale = Scale;
+        Scale *= pDesc->Count;
+    }
+
+    c->pVarDesc[pVar->Index] = First;
+    return (First);
+}
+
+/**
+********************************************************************************
+* @brief Calculates the data offset of an array element with literal
+*        indexes at compile time.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    MIST_N_INDEX node
+* @param[out] pOffset  data offset of the element
+*
+* @retval     TRUE  .. all indexes are literals
+* @retval     FALSE .. the offset must be calculated at run time
+*******************************************************************************/
+MLOCAL BOOL Comp_ConstOffset(COMPILER * c, const MIST_NODE * pNode, UINT32 * pOffset)
+{
+    const MIST_VAR *pVar = pNode->pA->u.pVar;
+    const MIST_NODE *pIdx;
+    UINT32  Elem = 0;
+    UINT32  Dim = 0;
+
+    for (pIdx = pNode->pB; pIdx; pIdx = pIdx->pNext)
+    {
+        if (pIdx->Type != MIST_N_INT)
+            return (FALSE);
+    }
+
+    for (pIdx = pNode->pB; pIdx; pIdx = pIdx->pNext, Dim++)
+    {
+        if ((pIdx->u.Int < pVar->Lower[Dim]) || (pIdx->u.Int > pVar->Upper[Dim]))
+        {
+            Comp_Error(c, pIdx->Offset, "index %d of '%s' out of bounds", pIdx->u.Int, pVar->pName);
+            return (FALSE);
+        }
+        Elem = Elem * (UINT32) (pVar->Upper[Dim] - pVar->Lower[Dim] + 1) + (UINT32) (pIdx->u.Int - pVar->Lower[Dim]);
+    }
+    *pOffset = pVar->MemOffset + Elem * pVar->ElemSize;
+    return (TRUE);
+}
+
+/**
+********************************************************************************
+* @brief Calculates the data offset of an array element at run time.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    MIST_N_INDEX node
+* @param[out] N/A
+*
+* @retval     temporary register holding the offset
+*******************************************************************************/
+MLOCAL UINT32 Comp_Address(COMPILER * c, const MIST_NODE * pNode)
+{
+    MIST_NODE *pIdx = pNode->pB;
+    UINT32  Desc = Comp_Desc(c, pNode->pA->u.pVar);
+    UINT32  Mark = c->NextTemp;
+    UINT32  Reg;
+    UINT32  Dst;
+
+    Reg = Comp_Expr(c, pIdx, pIdx->Class);
+    c->NextTemp = Mark;
+    Dst = Comp_Temp(c);
+    Comp_Emit(c, MIST_I_IDX, Dst, Reg, Desc);
+
+    for (pIdx = pIdx->pNext; pIdx; pIdx = pIdx->pNext)
+    {
+        Reg = Comp_Expr(c, pIdx, pIdx->Class);
+        c->NextTemp = Dst + 1;
+        Comp_Emit(c, MIST_I_IDXA, Dst, Reg, ++Desc);
+    }
+    return (Dst);
+}
+
+/**
+********************************************************************************
+* @brief Compiles a call of a standard function.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    MIST_N_CALL node, resolved by Comp_TypeCall()
+* @param[out] N/A
+*
+* @retval     register holding the result in pNode->Class
+*******************************************************************************/
+MLOCAL UINT32 Comp_Call(COMPILER * c, MIST_NODE * pNode)
+{
+    MIST_NODE *pArg = pNode->pA;
+    const COMP_TYPE *pTo;
+    UINT32  Cls = pNode->Class;
+    UINT32  Mark = c->NextTemp;
+    UINT32  Dst, Reg, Reg2;
+    UINT32  ElseList = 0;
+    UINT32  EndList = 0;
+    UINT32  Op;
+
+    switch (pNode->Op)
+    {
+        case MIST_F_CONV:
+            pTo = &CompType[pNode->DataType];
+            Reg = Comp_Expr(c, pArg, pArg->Class);
+            Dst = (Reg & COMP_CONST) ? Comp_Temp(c) : Reg;
+
+            if (pTo->Cls == MIST_CLS_BOOL)
+            {
+                /* Anything but zero is TRUE */
+                if (pArg->Class == MIST_CLS_BOOL)
+                    return (Reg);
+                Op = (pArg->Class == MIST_CLS_REAL) ? MIST_I_NEF : (pArg->Class == MIST_CLS_LREAL) ? MIST_I_NED : MIST_I_NE;
+                Comp_Emit(c, Op, Dst, Reg, Comp_ConstInt(c, 0));
+                return (Dst);
+            }
+
+            if (pTo->Cls >= MIST_CLS_REAL)
+                return (Comp_Convert(c, pNode, Reg, (pArg->Class == MIST_CLS_BOOL) ? MIST_CLS_INT : pArg->Class, pTo->Cls));
+
+            /* Integers: REAL is rounded, then truncated to the destination size */
+            if (pArg->Class >= MIST_CLS_REAL)
+            {
+                if (pTo->Cls == MIST_CLS_UINT)
+                    Op = (pArg->Class == MIST_CLS_REAL) ? MIST_I_FTOU : MIST_I_DTOU;
+                else
+                    Op = (pArg->Class == MIST_CLS_REAL) ? MIST_I_FTOI : MIST_I_DTOI;
+                Comp_Emit(c, Op, Dst, Reg, 0);
+                Reg = Dst;
+            }
+            if (!pTo->Narrow)
+                return (Reg);
+            Comp_Emit(c, pTo->Narrow, Dst, Reg, 0);
+            return (Dst);
+
+        case MIST_F_TRUNC:
+            Reg = Comp_Expr(c, pArg, pArg->Class);
+            if (pArg->Class <= MIST_CLS_UINT)
+                return (Reg);
+            Dst = (Reg & COMP_CONST) ? Comp_Temp(c) : Reg;
+            Comp_Emit(c, (pArg->Class == MIST_CLS_REAL) ? MIST_I_TRUNCF : MIST_I_TRUNCD, Dst, Reg, 0);
+            return (Dst);
+
+        case MIST_F_ABS:
+            Reg = Comp_Expr(c, pArg, Cls);
+            if (Cls == MIST_CLS_UINT)
+                return (Reg);
+            Dst = (Reg & COMP_CONST) ? Comp_Temp(c) : Reg;
+            Op = (Cls == MIST_CLS_REAL) ? MIST_I_ABSF : (Cls == MIST_CLS_LREAL) ? MIST_I_ABSD : MIST_I_ABS;
+            Comp_Emit(c, Op, Dst, Reg, 0);
+            return (Dst);
+
+        case MIST_F_EXPT:
+            Reg = Comp_Expr(c, pArg, Cls);
+            Reg2 = Comp_Expr(c, pArg->pNext, Cls);
+            c->NextTemp = Mark;
+            Dst = Comp_Temp(c);
+            Comp_Emit(c, (Cls == MIST_CLS_REAL) ? MIST_I_POWF : MIST_I_POWD, Dst, Reg, Reg2);
+            return (Dst);
+
+        case MIST_F_MIN:
+        case MIST_F_MAX:
+            if (Cls == MIST_CLS_REAL)
+                Op = (pNode->Op == MIST_F_MIN) ? MIST_I_MINF : MIST_I_MAXF;
+            else if (Cls == MIST_CLS_LREAL)
+                Op = (pNode->Op == MIST_F_MIN) ? MIST_I_MIND : MIST_I_MAXD;
+            else if (Cls == MIST_CLS_UINT)
+                Op = (pNode->Op == MIST_F_MIN) ? MIST_I_MINU : MIST_I_MAXU;
+            else
+                Op = (pNode->Op == MIST_F_MIN) ? MIST_I_MIN : MIST_I_MAX;
+
+            Reg = Comp_Expr(c, pArg, Cls);
+            for (pArg = pArg->pNext; pArg; pArg = pArg->pNext)
+            {
+                Reg2 = Comp_Expr(c, pArg, Cls);
+                c->NextTemp = Mark;
+                Dst = Comp_Temp(c);
+                Comp_Emit(c, Op, Dst, Reg, Reg2);
+                Reg = Dst;
+            }
+            return (Reg);
+
+        case MIST_F_LIMIT:
+            /* LIMIT(MN, IN, MX) = MIN(MAX(IN, MN), MX) */
+            Reg = Comp_Expr(c, pArg->pNext, Cls);
+            Reg2 = Comp_Expr(c, pArg, Cls);
+            c->NextTemp = Mark;
+            Dst = Comp_Temp(c);
+            Op = (Cls == MIST_CLS_REAL) ? MIST_I_MAXF : (Cls == MIST_CLS_LREAL) ? MIST_I_MAXD :
+                (Cls == MIST_CLS_UINT) ? MIST_I_MAXU : MIST_I_MAX;
+            Comp_Emit(c, Op, Dst, Reg, Reg2);
+            Reg2 = Comp_Expr(c, pArg->pNext->pNext, Cls);
+            c->NextTemp = Dst + 1;
+            Op = (Cls == MIST_CLS_REAL) ? MIST_I_MINF : (Cls == MIST_CLS_LREAL) ? MIST_I_MIND :
+                (Cls == MIST_CLS_UINT) ? MIST_I_MINU : MIST_I_MIN;
+            Comp_Emit(c, Op, Dst, Dst, Reg2);
+            return (Dst);
+
+        case MIST_F_SEL:
+            /* Only the selected input is evaluated */
+            Dst = Comp_Temp(c);
+            Reg = Comp_Expr(c, pArg, MIST_CLS_BOOL);
+            Comp_Jump(c, MIST_I_JNZ, Reg, &ElseList);
+            c->NextTemp = Dst + 1;
+            Reg = Comp_Expr(c, pArg->pNext, Cls);
+            Comp_Emit(c, MIST_I_MOV, Dst, Reg, 0);
+            Comp_Jump(c, MIST_I_JMP, 0, &EndList);
+            Comp_Patch(c, ElseList, c->NbOfInstr);
+            c->NextTemp = Dst + 1;
+            Reg = Comp_Expr(c, pArg->pNext->pNext, Cls);
+            Comp_Emit(c, MIST_I_MOV, Dst, Reg, 0);
+            Comp_Patch(c, EndList, c->NbOfInstr);
+            c->NextTemp = Dst + 1;
+            return (Dst);
+
+        default:
+            /* Math functions */
+            Reg = Comp_Expr(c, pArg, Cls);
+            Dst = (Reg & COMP_CONST) ? Comp_Temp(c) : Reg;
+            Comp_Emit(c, (Cls == MIST_CLS_REAL) ? MIST_I_MATHF : MIST_I_MATHD, Dst, Reg,
+                      pNode->Op - MIST_F_SQRT + MIST_FN_SQRT);
+            return (Dst);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Returns the class a binary operation computes in. A comparison
+*        has the result class BOOL and compares in the class of its
+*        operands.
+*
+* @param[in]  pNode    MIST_N_BINARY node, classes assigned by Comp_Type()
+* @param[out] N/A
+*
+* @retval     class MIST_CLS_xxx
+*******************************************************************************/
+MLOCAL UINT32 Comp_BinClass(const MIST_NODE * pNode)
+{
+    if (pNode->Class != MIST_CLS_BOOL)
+        return (pNode->Class);
+    return ((pNode->pA->Class > pNode->pB->Class) ? pNode->pA->Class : pNode->pB->Class);
+}
+
+/**
+********************************************************************************
+* @brief Compiles an expression, the result has the class of the expression.
+*        Literals are handled by Comp_Expr().
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    expression, classes assigned by Comp_Type()
+* @param[out] N/A
+*
+* @retval     register holding the result, the topmost temporary or a constant
+*******************************************************************************/
+MLOCAL UINT32 Comp_Value(COMPILER * c, MIST_NODE * pNode)
+{
+    MIST_NODE *pBin, *pParent;
+    UINT32  Mark = c->NextTemp;
+    UINT32  Len;
+    UINT32  Cls;
+    UINT32  RegA, RegB;
+    UINT32  Dst;
+    UINT32  Offset;
+
+    switch (pNode->Type)
+    {
+        case MIST_N_VAR:
+            Dst = Comp_Temp(c);
+            Comp_EmitImm(c, CompType[pNode->u.pVar->Type].Load, Dst, pNode->u.pVar->MemOffset);
+            return (Dst);
+
+        case MIST_N_INDEX:
+            if (Comp_ConstOffset(c, pNode, &Offset))
+            {
+                Dst = Comp_Temp(c);
+                Comp_EmitImm(c, CompType[pNode->pA->u.pVar->Type].Load, Dst, Offset);
+                return (Dst);
+            }
+            RegA = Comp_IndReg(c, pNode);
+            if (RegA != COMP_NOTARGET)
+            {
+                Dst = Comp_Temp(c);
+                Comp_Emit(c, CompType[pNode->pA->u.pVar->Type].Load + MIST_I_LDRS8 - MIST_I_LDS8, Dst, RegA, 0);
+                return (Dst);
+            }
+            Dst = Comp_Address(c, pNode);
+            Comp_Emit(c, CompType[pNode->pA->u.pVar->Type].Load + MIST_I_LDRS8 - MIST_I_LDS8, Dst, Dst, 0);
+            return (Dst);
+
+        case MIST_N_UNARY:
+            Cls = pNode->Class;
+            RegA = Comp_Expr(c, pNode->pA, Cls);
+            c->NextTemp = Mark;
+            Dst = Comp_Temp(c);
+            if ((pNode->Op == MIST_OP_NOT) && (Cls == MIST_CLS_BOOL))
+                Comp_Emit(c, MIST_I_XOR, Dst, RegA, Comp_ConstInt(c, 1));
+            else if (pNode->Op == MIST_OP_NOT)
+                Comp_Emit(c, MIST_I_NOT, Dst, RegA, 0);
+            else
+                Comp_Emit(c, (Cls == MIST_CLS_REAL) ? MIST_I_NEGF : (Cls == MIST_CLS_LREAL) ? MIST_I_NEGD : MIST_I_NEG,
+                          Dst, RegA, 0);
+            return (Dst);
+
+        case MIST_N_BINARY:
+            /* the chain of first operands from the innermost node upwards, the result of
+               each node is converted to the class of its parent like Comp_Expr() does */
+            Len = mist_NodeChain(pNode);
+            pBin = mist_NodeLeft(pNode, Len - 1);
+            RegA = Comp_Expr(c, pBin->pA, Comp_BinClass(pBin));
+            for (;;)
+            {
+                Cls = Comp_BinClass(pBin);
+                RegB = Comp_Expr(c, pBin->pB, Cls);
+                c->NextTemp = Mark;
+                Dst = Comp_Temp(c);
+                Comp_Emit(c, CompBinOp[pBin->Op][Cls], Dst, RegA, RegB);
+                if ((--Len == 0) || c->Error)
+                    return (Dst);
+                pParent = mist_NodeLeft(pNode, Len - 1);
+                RegA = Comp_Convert(c, pBin, Dst, pBin->Class, Comp_BinClass(pParent));
+                pBin = pParent;
+            }
+
+        case MIST_N_CALL:
+            return (Comp_Call(c, pNode));
+    }
+
+    Comp_Error(c, pNode->Offset, "invalid expression");
+    return (0);
+}
+
+/**
+********************************************************************************
+* @brief Compiles an expression and converts the result to a class.
+*        Literals don't need any instruction, they are converted at
+*        compile time and become constant registers.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    expression, classes assigned by Comp_Type()
+* @param[in]  Cls      requested class of the result
+* @param[out] N/A
+*
+* @retval     register holding the result, the topmost temporary or a constant
+*******************************************************************************/
+MLOCAL UINT32 Comp_Expr(COMPILER * c, MIST_NODE * pNode, UINT32 Cls)
+{
+    MIST_REG Value;
+    UINT32  Reg;
+
+    if (c->Error)
+        return (0);
+
+    if (Comp_IsLiteral(pNode))
+    {
+        if (!Comp_CanConvert(pNode->Class, Cls))
+        {
+            Comp_Error(c, pNode->Offset, "%s can't be converted to %s implicitly", CompClsName[pNode->Class],
+                       CompClsName[Cls]);
+            return (0);
+        }
+        Comp_LitValue(pNode, Cls, &Value);
+        return (Comp_Const(c, &Value));
+    }
+
+    Reg = Comp_Value(c, pNode);
+    return (Comp_Convert(c, pNode, Reg, pNode->Class, Cls));
+}
+
+/**
+********************************************************************************
+* @brief Compiles the condition of IF, WHILE or REPEAT.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    expression
+* @param[out] N/A
+*
+* @retval     register holding the condition
+*******************************************************************************/
+MLOCAL UINT32 Comp_Cond(COMPILER * c, MIST_NODE * pNode)
+{
+    UINT32  Cls = Comp_Type(c, pNode);
+
+    if ((Cls != MIST_CLS_BOOL) && (Cls != MIST_CLS_NONE))
+        Comp_Error(c, pNode->Offset, "BOOL expression expected");
+    return (Comp_Expr(c, pNode, MIST_CLS_BOOL));
+}
+
+/**
+********************************************************************************
+* @brief Stores a value to a variable or array element,
+*        the value is truncated to the size of the variable.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pTarget  MIST_N_VAR or MIST_N_INDEX node
+* @param[in]  Reg      register holding the value in the class of the target
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_Store(COMPILER * c, const MIST_NODE * pTarget, UINT32 Reg)
+{
+    const MIST_VAR *pVar;
+    UINT32  Op;
+    UINT32  Offset;
+    UINT32  Dst;
+
+    pVar = (pTarget->Type == MIST_N_INDEX) ? pTarget->pA->u.pVar : pTarget->u.pVar;
+    switch (CompType[pVar->Type].Size)
+    {
+        case 1:
+            Op = MIST_I_ST8;
+            break;
+        case 2:
+            Op = MIST_I_ST16;
+            break;
+        case 4:
+            Op = MIST_I_ST32;
+            break;
+        default:
+            Op = MIST_I_ST64;
+            break;
+    }
+
+    if (pTarget->Type == MIST_N_VAR)
+        Comp_EmitImm(c, Op, Reg, pVar->MemOffset);
+    else if (Comp_ConstOffset(c, pTarget, &Offset))
+        Comp_EmitImm(c, Op, Reg, Offset);
+    else if ((Dst = Comp_IndReg(c, pTarget)) != COMP_NOTARGET)
+        Comp_Emit(c, Op + MIST_I_STR8 - MIST_I_ST8, Reg, Dst, 0);
+    else
+    {
+        Dst = Comp_Address(c, pTarget);
+        Comp_Emit(c, Op + MIST_I_STR8 - MIST_I_ST8, Reg, Dst, 0);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Compiles a statement list.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pStmt    first statement, NULL = empty list
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_StmtList(COMPILER * c, MIST_NODE * pStmt)
+{
+    for (; pStmt && !c->Error; pStmt = pStmt->pNext)
+        Comp_Stmt(c, pStmt);
+}
+
+/**
+********************************************************************************
+* @brief Compiles IF cond THEN body ELSE else_body END_IF,
+*        ELSIF is a nested IF in the ELSE part. The chain of ELSIF is
+*        compiled in a loop, all branches jump to one common end.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    MIST_N_IF node
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_If(COMPILER * c, MIST_NODE * pNode)
+{
+    UINT32  Mark = c->NextTemp;
+    UINT32  ElseList = 0;
+    UINT32  EndList = 0;
+
+    for (;;)
+    {
+        Comp_Jump(c, MIST_I_JZ, Comp_Cond(c, pNode->pA), &ElseList);
+        c->NextTemp = Mark;
+        Comp_StmtList(c, pNode->pBody);
+
+        if (!pNode->pElse)
+        {
+            Comp_Patch(c, ElseList, c->NbOfInstr);
+            break;
+        }
+        Comp_Jump(c, MIST_I_JMP, 0, &EndList);
+        Comp_Patch(c, ElseList, c->NbOfInstr);
+        ElseList = 0;
+
+        pNode = pNode->pElse;
+        if (!mist_NodeElsif(pNode) || c->Error)
+        {
+            Comp_StmtList(c, pNode);
+            break;
+        }
+    }
+    Comp_Patch(c, EndList, c->NbOfInstr);
+}
+
+/**
+********************************************************************************
+* @brief Compiles CASE selector OF labels: body ... ELSE else_body END_CASE
+*        as a chain of comparisons.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    MIST_N_CASE node
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_Case(COMPILER * c, MIST_NODE * pNode)
+{
+    MIST_NODE *pElem;
+    MIST_NODE *pLabel;
+    UINT32  Mark = c->NextTemp;
+    UINT32  Cls;
+    UINT32  Sel;
+    UINT32  Tmp;
+    UINT32  Inner;
+    UINT32  BodyList, NextList, RangeList;
+    UINT32  EndList = 0;
+
+    Cls = Comp_Type(c, pNode->pA);
+    if ((Cls != MIST_CLS_INT) && (Cls != MIST_CLS_UINT))
+    {
+        if (Cls != MIST_CLS_NONE)
+            Comp_Error(c, pNode->pA->Offset, "CASE selector must be an integer");
+        return;
+    }
+
+    /* The selector stays in its register while the labels are compared */
+    Sel = Comp_Expr(c, pNode->pA, Cls);
+    Inner = c->NextTemp;
+
+    for (pElem = pNode->pBody; pElem && !c->Error; pElem = pElem->pNext)
+    {
+        BodyList = 0;
+        NextList = 0;
+        for (pLabel = pElem->pA; pLabel; pLabel = pLabel->pNext)
+        {
+            c->NextTemp = Inner;
+            Tmp = Comp_Temp(c);
+            if (pLabel->Type == MIST_N_RANGE)
+            {
+                RangeList = 0;
+                Comp_Type(c, pLabel->pA);
+                Comp_Type(c, pLabel->pB);
+                Comp_Emit(c, (Cls == MIST_CLS_UINT) ? MIST_I_GEU : MIST_I_GE, Tmp, Sel, Comp_Expr(c, pLabel->pA, Cls));
+                Comp_Jump(c, MIST_I_JZ, Tmp, &RangeList);
+                Comp_Emit(c, (Cls == MIST_CLS_UINT) ? MIST_I_LEU : MIST_I_LE, Tmp, Sel, Comp_Expr(c, pLabel->pB, Cls));
+                Comp_Jump(c, MIST_I_JNZ, Tmp, &BodyList);
+                Comp_Patch(c, RangeList, c->NbOfInstr);
+            }
+            else
+            {
+                Comp_Type(c, pLabel);
+                Comp_Emit(c, MIST_I_EQ, Tmp, Sel, Comp_Expr(c, pLabel, Cls));
+                Comp_Jump(c, MIST_I_JNZ, Tmp, &BodyList);
+            }
+        }
+        c->NextTemp = Mark;
+        Comp_Jump(c, MIST_I_JMP, 0, &NextList);
+        Comp_Patch(c, BodyList, c->NbOfInstr);
+        Comp_StmtList(c, pElem->pBody);
+        Comp_Jump(c, MIST_I_JMP, 0, &EndList);
+        Comp_Patch(c, NextList, c->NbOfInstr);
+    }
+
+    c->NextTemp = Mark;
+    Comp_StmtList(c, pNode->pElse);
+    Comp_Patch(c, EndList, c->NbOfInstr);
+}
+
+/**
+********************************************************************************
+* @brief Checks if an index is the control variable of a FOR loop plus or
+*        minus a literal: var, var + n, n + var, var - n.
+*
+* @param[in]  pIdx     index expression, typed
+* @param[in]  pVar     control variable
+* @param[out] pAdd     index = var + *pAdd
+*
+* @retval     TRUE, FALSE
+*******************************************************************************/
+MLOCAL BOOL Comp_IndForm(const MIST_NODE * pIdx, const MIST_VAR * pVar, SINT32 * pAdd)
+{
+    const MIST_NODE *pLit;
+    SINT64  Add;
+
+    if ((pIdx->Type == MIST_N_VAR) && (pIdx->u.pVar == pVar))
+    {
+        *pAdd = 0;
+        return (TRUE);
+    }
+    if ((pIdx->Type != MIST_N_BINARY) || ((pIdx->Op != MIST_OP_ADD) && (pIdx->Op != MIST_OP_SUB)))
+        return (FALSE);
+
+    if ((pIdx->pA->Type == MIST_N_VAR) && (pIdx->pA->u.pVar == pVar))
+        pLit = pIdx->pB;
+    else if ((pIdx->Op == MIST_OP_ADD) && (pIdx->pB->Type == MIST_N_VAR) && (pIdx->pB->u.pVar == pVar))
+        pLit = pIdx->pA;
+    else
+        return (FALSE);
+    if (pLit->Type != MIST_N_INT)
+        return (FALSE);
+
+    Add = (pLit->Class == MIST_CLS_UINT) ? (SINT64) (UINT32) pLit->u.Int : (SINT64) pLit->u.Int;
+    if (pIdx->Op == MIST_OP_SUB)
+        Add = -Add;
+    if ((Add < -0x7FFFFFFF) || (Add > 0x7FFFFFFF))
+        return (FALSE);
+    *pAdd = (SINT32) Add;
+    return (TRUE);
+}
+
+/**
+********************************************************************************
+* @brief Checks if an element of an array with one dimension follows the
+*        control variable of a FOR loop and stays within the bounds in all
+*        iterations. The check of the VM works modulo 2^32, so an index
+*        proven within bounds here selects the same element at run time.
+*
+* @param[in]  pNode    MIST_N_INDEX node
+* @param[in]  pVar     control variable
+* @param[in]  pTrip    iterations of the loop
+* @param[out] pAdd     index = var + *pAdd
+*
+* @retval     TRUE, FALSE
+*******************************************************************************/
+MLOCAL BOOL Comp_IndRange(const MIST_NODE * pNode, const MIST_VAR * pVar, const COMP_TRIP * pTrip, SINT32 * pAdd)
+{
+    const MIST_VAR *pArray = pNode->pA->u.pVar;
+    SINT64  Low, High;
+
+    if ((pArray->NbOfDims != 1) || !Comp_IndForm(pNode->pB, pVar, pAdd))
+        return (FALSE);
+
+    Low = ((pTrip->Step > 0) ? pTrip->First : pTrip->Last) + *pAdd;
+    High = ((pTrip->Step > 0) ? pTrip->Last : pTrip->First) + *pAdd;
+    return ((Low >= pArray->Lower[0]) && (High <= pArray->Upper[0]));
+}
+
+/**
+********************************************************************************
+* @brief Prepares the array elements of a FOR loop body which follow the
+*        control variable: their indexes are marked as checked (used by
+*        the C code generator), and with Regs the first COMP_MAXIND of them
+*        get induction registers holding their data offset. The registers
+*        are loaded here and advanced by Comp_ForCount() with each
+*        iteration, so accessing such an element needs neither the index
+*        calculation nor the bounds check.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    first node of a list of syntax trees
+* @param[in]  pVar     control variable, not written by the body
+* @param[in]  pTrip    iterations of the loop
+* @param[in]  Regs     TRUE = allocate induction registers
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_Induct(COMPILER * c, MIST_NODE * pNode, const MIST_VAR * pVar, const COMP_TRIP * pTrip, BOOL Regs)
+{
+    const MIST_VAR *pArray;
+    COMP_IND *pInd;
+    SINT32  Add;
+    UINT32  Offset;
+    UINT32  Len;
+    UINT32  i;
+
+    while (pNode && !c->Error)
+    {
+        if (pNode->Type == MIST_N_BINARY)
+        {
+            /* First operands from the innermost node upwards, the order of the registers is kept */
+            Len = mist_NodeChain(pNode);
+            Comp_Induct(c, mist_NodeLeft(pNode, Len), pVar, pTrip, Regs);
+            while (Len-- > 0)
+                Comp_Induct(c, mist_NodeLeft(pNode, Len)->pB, pVar, pTrip, Regs);
+            pNode = pNode->pNext;
+            continue;
+        }
+        if ((pNode->Type == MIST_N_INDEX) && Comp_IndRange(pNode, pVar, pTrip, &Add))
+        {
+            pNode->Op |= MIST_IX_CHECKED;
+            pArray = pNode->pA->u.pVar;
+            for (i = 0; i < c->NbOfInd; i++)
+            {
+                pInd = &c->Ind[i];
+                if ((pInd->pArray == pArray) && (pInd->pVar == pVar) && (pInd->Add == Add))
+                    break;
+            }
+            if (Regs && (i == c->NbOfInd) && (c->NbOfInd < COMP_MAXIND))
+            {
+                pInd = &c->Ind[c->NbOfInd++];
+                pInd->pArray = pArray;
+                pInd->pVar = pVar;
+                pInd->Add = Add;
+                pInd->Reg = Comp_Temp(c);
+                Offset = pArray->MemOffset + (UINT32) (pTrip->First + Add - pArray->Lower[0]) * pArray->ElemSize;
+                Comp_Emit(c, MIST_I_MOV, pInd->Reg, Comp_ConstInt(c, (SINT32) Offset), 0);
+            }
+        }
+        Comp_Induct(c, pNode->pA, pVar, pTrip, Regs);
+        Comp_Induct(c, pNode->pB, pVar, pTrip, Regs);
+        Comp_Induct(c, pNode->pC, pVar, pTrip, Regs);
+        Comp_Induct(c, pNode->pD, pVar, pTrip, Regs);
+        Comp_Induct(c, pNode->pBody, pVar, pTrip, Regs);
+
+        /* The ELSE part of the last node continues the loop, a chain of ELSIF doesn't recurse */
+        if (!pNode->pNext)
+            pNode = pNode->pElse;
+        else
+        {
+            Comp_Induct(c, pNode->pElse, pVar, pTrip, Regs);
+            pNode = pNode->pNext;
+        }
+    }
+}
+
+/**
+********************************************************************************
+* @brief Returns the induction register of an array element,
+*        see Comp_Induct().
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    MIST_N_INDEX node
+* @param[out] N/A
+*
+* @retval     register holding the data offset, COMP_NOTARGET = none
+*******************************************************************************/
+MLOCAL UINT32 Comp_IndReg(COMPILER * c, const MIST_NODE * pNode)
+{
+    const COMP_IND *pInd;
+    SINT32  Add;
+    UINT32  i;
+
+    if (!(pNode->Op & MIST_IX_CHECKED))
+        return (COMP_NOTARGET);
+    for (i = c->NbOfInd; i-- > 0;)
+    {
+        pInd = &c->Ind[i];
+        if ((pInd->pArray == pNode->pA->u.pVar) && Comp_IndForm(pNode->pB, pInd->pVar, &Add) && (pInd->Add == Add))
+            return (pInd->Reg);
+    }
+    return (COMP_NOTARGET);
+}
+
+/**
+********************************************************************************
+* @brief Checks if an expression has the same value in all iterations of
+*        a FOR loop and can't fault: it doesn't read the control variable
+*        or array elements and doesn't divide integers.
+*
+* @param[in]  pNode    expression, typed, the following arguments of a
+*                      function call are not checked
+* @param[in]  pVar     control variable
+* @param[out] N/A
+*
+* @retval     TRUE, FALSE
+*******************************************************************************/
+MLOCAL BOOL Comp_Invariant(const MIST_NODE * pNode, const MIST_VAR * pVar)
+{
+    const MIST_NODE *pArg;
+
+    for (;;)
+    {
+        switch (pNode->Type)
+        {
+            case MIST_N_VAR:
+                if ((pNode->u.pVar == pVar) || pNode->u.pVar->NbOfDims)
+                    return (FALSE);
+                break;
+            case MIST_N_INDEX:
+                return (FALSE);
+            case MIST_N_BINARY:
+                if (((pNode->Op == MIST_OP_DIV) || (pNode->Op == MIST_OP_MOD)) &&
+                    ((pNode->Class == MIST_CLS_INT) || (pNode->Class == MIST_CLS_UINT)))
+                    return (FALSE);
+                break;
+        }
+        for (pArg = pNode->pB; pArg; pArg = pArg->pNext)
+        {
+            if (!Comp_Invariant(pArg, pVar))
+                return (FALSE);
+        }
+        for (pArg = pNode->pA; pArg && pArg->pNext; pArg = pArg->pNext)
+        {
+            if (!Comp_Invariant(pArg, pVar))
+                return (FALSE);
+        }
+
+        /* The last first operand continues the loop, a chain of operators doesn't recurse */
+        if (!pArg)
+            return (TRUE);
+        pNode = pArg;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Checks if an expression can be computed by an element-wise REAL
+*        kernel (MIST_I_VECF) and returns the number of lane buffers it
+*        needs: invariant values, elements of REAL arrays following the
+*        control variable, -, +, -, *, / and ABS, MIN, MAX, LIMIT, all in
+*        class REAL. Elements of the target array must be the element being
+*        written, so that the iterations stay independent.
+*
+* @param[in]  pNode    expression, typed
+* @param[in]  pVar     control variable
+* @param[in]  pTrip    iterations of the loop, step 1 or -1
+* @param[in]  pDst     target array
+* @param[in]  DstAdd   index of the target = var + DstAdd
+* @param[out] N/A
+*
+* @retval     number of lane buffers, 0 = no kernel
+*******************************************************************************/
+MLOCAL UINT32 Comp_VecLanes(const MIST_NODE * pNode, const MIST_VAR * pVar, const COMP_TRIP * pTrip,
+                            const MIST_VAR * pDst, SINT32 DstAdd)
+{
+    const MIST_NODE *pArg = pNode->pA;
+    const MIST_NODE *pBin;
+    UINT32  Lanes, Lanes2, Lanes3;
+    UINT32  Len;
+    SINT32  Add;
+
+    if (Comp_Invariant(pNode, pVar))
+        return (1);
+    if (pNode->Class != MIST_CLS_REAL)
+        return (0);
+
+    switch (pNode->Type)
+    {
+        case MIST_N_INDEX:
+            if ((pNode->pA->u.pVar->Type != MIST_KW_REAL) || !Comp_IndRange(pNode, pVar, pTrip, &Add))
+                return (0);
+            return (((pNode->pA->u.pVar != pDst) || (Add == DstAdd)) ? 1 : 0);
+
+        case MIST_N_UNARY:
+            return ((pNode->Op == MIST_OP_SUB) ? Comp_VecLanes(pArg, pVar, pTrip, pDst, DstAdd) : 0);
+
+        case MIST_N_BINARY:
+            /* First operands from the innermost node upwards, each one checked like the whole */
+            Len = mist_NodeChain(pNode);
+            Lanes = Comp_VecLanes(mist_NodeLeft(pNode, Len), pVar, pTrip, pDst, DstAdd);
+            while (Len-- > 0)
+            {
+                pBin = mist_NodeLeft(pNode, Len);
+                if (Comp_Invariant(pBin, pVar))
+                {
+                    Lanes = 1;
+                    continue;
+                }
+                if ((pBin->Class != MIST_CLS_REAL) || ((pBin->Op != MIST_OP_ADD) && (pBin->Op != MIST_OP_SUB) &&
+                                                        (pBin->Op != MIST_OP_MUL) && (pBin->Op != MIST_OP_DIV)))
+                    return (0);
+                Lanes2 = Comp_VecLanes(pBin->pB, pVar, pTrip, pDst, DstAdd);
+                if (!Lanes || !Lanes2)
+                    return (0);
+                Lanes = (Lanes > Lanes2 + 1) ? Lanes : Lanes2 + 1;
+            }
+            return (Lanes);
+
+        case MIST_N_CALL:
+            if (pNode->Op == MIST_F_ABS)
+                return (Comp_VecLanes(pArg, pVar, pTrip, pDst, DstAdd));
+            if (pNode->Op == MIST_F_LIMIT)
+            {
+                /* The input first, then minimum and maximum, see Comp_Call() */
+                Lanes = Comp_VecLanes(pArg->pNext, pVar, pTrip, pDst, DstAdd);
+                Lanes2 = Comp_VecLanes(pArg, pVar, pTrip, pDst, DstAdd);
+                Lanes3 = Comp_VecLanes(pArg->pNext->pNext, pVar, pTrip, pDst, DstAdd);
+            }
+            else if ((pNode->Op == MIST_F_MIN) || (pNode->Op == MIST_F_MAX))
+            {
+                Lanes = Comp_VecLanes(pArg, pVar, pTrip, pDst, DstAdd);
+                Lanes2 = Lanes3 = 1;
+                for (pArg = pArg->pNext; pArg && Lanes2; pArg = pArg->pNext)
+                {
+                    Lanes3 = Comp_VecLanes(pArg, pVar, pTrip, pDst, DstAdd);
+                    Lanes2 = !Lanes3 ? 0 : (Lanes3 > Lanes2) ? Lanes3 : Lanes2;
+                }
+            }
+            else
+                return (0);
+            if (!Lanes3)
+                return (0);
+            if (Lanes3 > Lanes2)
+                Lanes2 = Lanes3;
+            break;
+
+        default:
+            return (0);
+    }
+
+    /* The second operand is computed while the first one occupies a lane */
+    if (!Lanes || !Lanes2)
+        return (0);
+    return ((Lanes > Lanes2 + 1) ? Lanes : Lanes2 + 1);
+}
+
+/**
+********************************************************************************
+* @brief Appends an operation to the element-wise kernels.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  Op       operation MIST_V_xxx
+* @param[in]  Dst      target lane buffer
+* @param[in]  A, B     lane buffers of the operands
+* @param[in]  Arg      data offset or register
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_Vop(COMPILER * c, UINT32 Op, UINT32 Dst, UINT32 A, UINT32 B, UINT32 Arg)
+{
+    MIST_VM_VOP *pV;
+
+    if (!Comp_Grow(c, (VOID **) &c->pVop, &c->MaxVops, c->NbOfVops, sizeof(MIST_VM_VOP)))
+        return;
+    pV = &c->pVop[c->NbOfVops++];
+    pV->Op = (UINT8) Op;
+    pV->Dst = (UINT8) Dst;
+    pV->A = (UINT8) A;
+    pV->B = (UINT8) B;
+    pV->Arg = Arg;
+}
+
+/**
+********************************************************************************
+* @brief Compiles an expression accepted by Comp_VecLanes() into kernel
+*        operations with the operands and the order of Comp_Value().
+*        Invariant values are computed into registers before the kernel
+*        starts, the caller keeps these temporaries until MIST_I_VECF.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    expression, typed
+* @param[in]  pVar     control variable
+* @param[in]  pTrip    iterations of the loop
+* @param[in]  Lane     lane buffer of the result, the following ones are free
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_VecGen(COMPILER * c, MIST_NODE * pNode, const MIST_VAR * pVar, const COMP_TRIP * pTrip, UINT32 Lane)
+{
+    const MIST_VAR *pArray;
+    MIST_NODE *pArg = pNode->pA;
+    MIST_NODE *pBin;
+    UINT32  Op;
+    UINT32  Len;
+    SINT32  Add;
+
+    if (Comp_Invariant(pNode, pVar))
+    {
+        Comp_Vop(c, MIST_V_SPLAT, Lane, 0, 0, Comp_Expr(c, pNode, MIST_CLS_REAL));
+        return;
+    }
+
+    switch (pNode->Type)
+    {
+        case MIST_N_INDEX:
+            pArray = pNode->pA->u.pVar;
+            Comp_IndRange(pNode, pVar, pTrip, &Add);
+            Comp_Vop(c, MIST_V_LD, Lane, 0, 0,
+                     pArray->MemOffset + (UINT32) (pTrip->First + Add - pArray->Lower[0]) * pArray->ElemSize);
+            break;
+
+        case MIST_N_UNARY:
+            Comp_VecGen(c, pArg, pVar, pTrip, Lane);
+            Comp_Vop(c, MIST_V_NEG, Lane, Lane, 0, 0);
+            break;
+
+        case MIST_N_BINARY:
+            /* Down the first operands to an invariant value or a leaf, then upwards in a loop */
+            for (pBin = pNode->pA, Len = 1; (pBin->Type == MIST_N_BINARY) && !Comp_Invariant(pBin, pVar); Len++)
+                pBin = pBin->pA;
+            Comp_VecGen(c, pBin, pVar, pTrip, Lane);
+            while (Len-- > 0)
+            {
+                pBin = mist_NodeLeft(pNode, Len);
+                Comp_VecGen(c, pBin->pB, pVar, pTrip, Lane + 1);
+                Op = (pBin->Op == MIST_OP_ADD) ? MIST_V_ADD : (pBin->Op == MIST_OP_SUB) ? MIST_V_SUB :
+                    (pBin->Op == MIST_OP_MUL) ? MIST_V_MUL : MIST_V_DIV;
+                Comp_Vop(c, Op, Lane, Lane, Lane + 1, 0);
+            }
+            break;
+
+        case MIST_N_CALL:
+            if (pNode->Op == MIST_F_ABS)
+            {
+                Comp_VecGen(c, pArg, pVar, pTrip, Lane);
+                Comp_Vop(c, MIST_V_ABS, Lane, Lane, 0, 0);
+            }
+            else if (pNode->Op == MIST_F_LIMIT)
+            {
+                /* LIMIT(MN, IN, MX) = MIN(MAX(IN, MN), MX) */
+                Comp_VecGen(c, pArg->pNext, pVar, pTrip, Lane);
+                Comp_VecGen(c, pArg, pVar, pTrip, Lane + 1);
+                Comp_Vop(c, MIST_V_MAX, Lane, Lane, Lane + 1, 0);
+                Comp_VecGen(c, pArg->pNext->pNext, pVar, pTrip, Lane + 1);
+                Comp_Vop(c, MIST_V_MIN, Lane, Lane, Lane + 1, 0);
+            }
+            else
+            {
+                Op = (pNode->Op == MIST_F_MIN) ? MIST_V_MIN : MIST_V_MAX;
+                Comp_VecGen(c, pArg, pVar, pTrip, Lane);
+                for (pArg = pArg->pNext; pArg; pArg = pArg->pNext)
+                {
+                    Comp_VecGen(c, pArg, pVar, pTrip, Lane + 1);
+                    Comp_Vop(c, Op, Lane, Lane, Lane + 1, 0);
+                }
+            }
+            break;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Checks if a FOR loop is a sweep over arrays, which can be executed
+*        as one block operation: the body is a single assignment
+*        a[var + n] := b[var + m] of arrays with the same data type,
+*        a[var + n] := value with an invariant value or a REAL element
+*        a[var + n] := expression of a kernel (Comp_VecLanes()), the step
+*        is 1 or -1 and all elements are within bounds.
+*
+* @param[in]  pNode    MIST_N_FOR node, typed
+* @param[in]  pTrip    iterations of the loop
+* @param[out] pK       block descriptor, without the kernel operations
+*
+* @retval     MIST_I_COPY, MIST_I_FILL, MIST_I_VECF, 0 = no sweep
+*******************************************************************************/
+MLOCAL UINT32 Comp_ForBlock(const MIST_NODE * pNode, const COMP_TRIP * pTrip, MIST_VM_BLOCK * pK)
+{
+    const MIST_VAR *pVar = pNode->pA->u.pVar;
+    const MIST_NODE *pStmt = pNode->pBody;
+    const MIST_VAR *pDst, *pSrc;
+    SINT32  Add, SrcAdd;
+    UINT32  Lanes;
+
+    if (!pStmt || pStmt->pNext || (pStmt->Type != MIST_N_ASSIGN) || (pStmt->pA->Type != MIST_N_INDEX))
+        return (0);
+    if (((pTrip->Step != 1) && (pTrip->Step != -1)) || !Comp_IndRange(pStmt->pA, pVar, pTrip, &Add))
+        return (0);
+
+    memset(pK, 0, sizeof(*pK));
+    pDst = pStmt->pA->pA->u.pVar;
+    pK->Dst = pDst->MemOffset + (UINT32) (pTrip->First + Add - pDst->Lower[0]) * pDst->ElemSize;
+    pK->Count = pTrip->Count;
+    pK->Dir = (SINT16) pTrip->Step;
+    pK->ElemSize = (UINT16) pDst->ElemSize;
+    pK->VarOffset = pVar->MemOffset;
+    pK->VarSize = CompType[pVar->Type].Size;
+    pK->Start = (UINT32) pTrip->First;
+    pK->Step = (UINT32) pTrip->Step;
+
+    if (pStmt->pB->Type == MIST_N_INDEX)
+    {
+        pSrc = pStmt->pB->pA->u.pVar;
+        if ((pSrc != pDst) && (pSrc->Type == pDst->Type) && Comp_IndRange(pStmt->pB, pVar, pTrip, &SrcAdd))
+        {
+            pK->Src = pSrc->MemOffset + (UINT32) (pTrip->First + SrcAdd - pSrc->Lower[0]) * pSrc->ElemSize;
+            return (MIST_I_COPY);
+        }
+    }
+    if (Comp_Invariant(pStmt->pB, pVar))
+        return (MIST_I_FILL);
+
+    if ((pDst->Type != MIST_KW_REAL) || (pStmt->pB->Class != MIST_CLS_REAL))
+        return (0);
+    Lanes = Comp_VecLanes(pStmt->pB, pVar, pTrip, pDst, Add);
+    return ((Lanes && (Lanes <= MIST_VM_VECREGS)) ? MIST_I_VECF : 0);
+}
+
+/**
+********************************************************************************
+* @brief Compiles a FOR loop with a number of iterations known at compile
+*        time, whose body doesn't write the control variable. A sweep over
+*        arrays becomes a single block instruction, see Comp_ForBlock(),
+*        a kernel gets its operations with a final MIST_V_ST.
+*        Otherwise an iteration counter replaces the condition and array
+*        elements following the control variable are addressed by
+*        induction registers, see Comp_Induct():
+*
+*           var := start; cnt := count; JMP test
+*        top:  body
+*        cont: induction registers += step * element size
+*              var := var + step
+*        test: IF cnt <> 0 THEN cnt := cnt - 1; JMP top
+*        exit:
+*
+*        Both count every iteration against the loop budget like Comp_For().
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    MIST_N_FOR node, typed
+* @param[in]  pTrip    iterations of the loop
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_ForCount(COMPILER * c, MIST_NODE * pNode, const COMP_TRIP * pTrip)
+{
+    COMP_LOOP Loop;
+    MIST_VM_BLOCK Block;
+    const MIST_VAR *pVar = pNode->pA->u.pVar;
+    UINT32  Mark = c->NextTemp;
+    UINT32  NbOfInd = c->NbOfInd;
+    UINT32  Reg, Cnt, Var;
+    UINT32  Op;
+    UINT32  CondList = 0;
+    UINT32  Top;
+    UINT32  i;
+
+    Reg = Comp_Expr(c, pNode->pB, pNode->pA->Class);
+    Comp_Store(c, pNode->pA, Reg);
+    c->NextTemp = Mark;
+
+    Op = Comp_ForBlock(pNode, pTrip, &Block);
+    if (Op)
+    {
+        Comp_Induct(c, pNode->pBody, pVar, pTrip, FALSE);
+        if (!Comp_Grow(c, (VOID **) &c->pBlock, &c->MaxBlocks, c->NbOfBlocks, sizeof(MIST_VM_BLOCK)))
+            return;
+        Reg = 0;
+        if (Op == MIST_I_FILL)
+            Reg = Comp_Expr(c, pNode->pBody->pB, pNode->pBody->pA->Class);
+        if (Op == MIST_I_VECF)
+        {
+            Block.Ops = c->NbOfVops;
+            Comp_VecGen(c, pNode->pBody->pB, pVar, pTrip, 0);
+            Comp_Vop(c, MIST_V_ST, 0, 0, 0, Block.Dst);
+            Block.NbOfOps = c->NbOfVops - Block.Ops;
+        }
+        c->pBlock[c->NbOfBlocks] = Block;
+        Comp_EmitImm(c, Op, Reg, c->NbOfBlocks++);
+        c->NextTemp = Mark;
+        return;
+    }
+
+    /* Counter, control variable and induction registers live during the loop */
+    Cnt = Comp_Temp(c);
+    Comp_Emit(c, MIST_I_MOV, Cnt, Comp_ConstInt(c, (SINT32) pTrip->Count), 0);
+    Var = Comp_Temp(c);
+    Comp_Emit(c, MIST_I_MOV, Var, Comp_ConstInt(c, (SINT32) pTrip->First), 0);
+    Comp_Induct(c, pNode->pBody, pVar, pTrip, TRUE);
+
+    Loop.pOuter = c->pLoop;
+    Loop.ExitList = 0;
+    Loop.ContList = 0;
+    Loop.ContTarget = COMP_NOTARGET;
+    c->pLoop = &Loop;
+
+    Comp_Jump(c, MIST_I_JMP, 0, &CondList);
+    Top = c->NbOfInstr;
+    Comp_StmtList(c, pNode->pBody);
+
+    Comp_Patch(c, Loop.ContList, c->NbOfInstr);
+    for (i = NbOfInd; i < c->NbOfInd; i++)
+    {
+        Reg = c->Ind[i].Reg;
+        Comp_Emit(c, MIST_I_ADD, Reg, Reg, Comp_ConstInt(c, (SINT32) (pTrip->Step * c->Ind[i].pArray->ElemSize)));
+    }
+    Comp_Emit(c, MIST_I_ADD, Var, Var, Comp_ConstInt(c, (SINT32) pTrip->Step));
+    Comp_Store(c, pNode->pA, Var);
+
+    Comp_Patch(c, CondList, c->NbOfInstr);
+    Comp_EmitImm(c, MIST_I_LOOP, Cnt, Top);
+
+    Comp_Patch(c, Loop.ExitList, c->NbOfInstr);
+    c->pLoop = Loop.pOuter;
+    c->NbOfInd = NbOfInd;
+    c->NextTemp = Mark;
+}
+
+/**
+********************************************************************************
+* @brief Compiles FOR var := start TO end BY step DO body END_FOR.
+*        End and step are evaluated once. The condition is placed behind
+*        the body, so every iteration takes one backward jump:
+*
+*           var := start; JMP cond
+*        top:  body
+*        cont: var := var + step
+*        cond: IF var <= end (var >= end for step < 0) THEN JMP top
+*        exit:
+*
+*        Loops with a known number of iterations are compiled by
+*        Comp_ForCount().
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    MIST_N_FOR node
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_For(COMPILER * c, MIST_NODE * pNode)
+{
+    COMP_LOOP Loop;
+    COMP_TRIP Trip;
+    const MIST_VAR *pVar = pNode->pA->u.pVar;
+    UINT32  Mark = c->NextTemp;
+    UINT32  Cls;
+    UINT32  Load = CompType[pVar->Type].Load;
+    UINT32  Reg, End, Step;
+    UINT32  Tmp, Cmp;
+    UINT32  Top;
+    UINT32  CondList = 0;
+    UINT32  NegList = 0;
+    SINT32  Sign = 1;
+
+    Cls = Comp_Type(c, pNode->pA);
+    if ((Cls != MIST_CLS_INT) && (Cls != MIST_CLS_UINT))
+    {
+        if (Cls != MIST_CLS_NONE)
+            Comp_Error(c, pNode->pA->Offset, "FOR variable must be an integer");
+        return;
+    }
+    if (!Comp_Type(c, pNode->pB) || !Comp_Type(c, pNode->pC) || (pNode->pD && !Comp_Type(c, pNode->pD)))
+        return;
+    if (Comp_ForTrip(pNode, &Trip) && Comp_Straight(pNode->pBody, pVar, TRUE))
+    {
+        Comp_ForCount(c, pNode, &Trip);
+        return;
+    }
+
+    Reg = Comp_Expr(c, pNode->pB, Cls);
+    Comp_Store(c, pNode->pA, Reg);
+    c->NextTemp = Mark;
+
+    /* End and step keep their registers during the loop */
+    End = Comp_Expr(c, pNode->pC, Cls);
+    if (pNode->pD)
+    {
+        Step = Comp_Expr(c, pNode->pD, Cls);
+        if (!Comp_IsLiteral(pNode->pD) && (Cls == MIST_CLS_INT))
+            Sign = 0;
+        else if ((Cls == MIST_CLS_INT) && (pNode->pD->u.Int < 0))
+            Sign = -1;
+    }
+    else
+        Step = Comp_ConstInt(c, 1);
+
+    Loop.pOuter = c->pLoop;
+    Loop.ExitList = 0;
+    Loop.ContList = 0;
+    Loop.ContTarget = COMP_NOTARGET;
+    c->pLoop = &Loop;
+
+    Comp_Jump(c, MIST_I_JMP, 0, &CondList);
+    Top = c->NbOfInstr;
+    Comp_StmtList(c, pNode->pBody);
+
+    Comp_Patch(c, Loop.ContList, c->NbOfInstr);
+    Tmp = Comp_Temp(c);
+    Comp_EmitImm(c, Load, Tmp, pVar->MemOffset);
+    Comp_Emit(c, MIST_I_ADD, Tmp, Tmp, Step);
+    Comp_Store(c, pNode->pA, Tmp);
+
+    Comp_Patch(c, CondList, c->NbOfInstr);
+    Comp_EmitImm(c, Load, Tmp, pVar->MemOffset);
+    if (Sign == 0)
+    {
+        /* Direction known at run time only */
+        Cmp = Comp_Temp(c);
+        Comp_Emit(c, MIST_I_LT, Cmp, Step, Comp_ConstInt(c, 0));
+        Comp_Jump(c, MIST_I_JNZ, Cmp, &NegList);
+        Comp_Emit(c, MIST_I_LE, Cmp, Tmp, End);
+        Comp_EmitImm(c, MIST_I_JNZB, Cmp, Top);
+        Comp_Jump(c, MIST_I_JMP, 0, &Loop.ExitList);
+        Comp_Patch(c, NegList, c->NbOfInstr);
+        Comp_Emit(c, MIST_I_GE, Cmp, Tmp, End);
+        Comp_EmitImm(c, MIST_I_JNZB, Cmp, Top);
+    }
+    else
+    {
+        if (Cls == MIST_CLS_UINT)
+            Cmp = (Sign > 0) ? MIST_I_LEU : MIST_I_GEU;
+        else
+            Cmp = (Sign > 0) ? MIST_I_LE : MIST_I_GE;
+        Comp_Emit(c, Cmp, Tmp, Tmp, End);
+        Comp_EmitImm(c, MIST_I_JNZB, Tmp, Top);
+    }
+
+    Comp_Patch(c, Loop.ExitList, c->NbOfInstr);
+    c->pLoop = Loop.pOuter;
+    c->NextTemp = Mark;
+}
+
+/**
+********************************************************************************
+* @brief Compiles a statement.
+*        All temporaries allocated by the statement are released afterwards.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    statement
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_Stmt(COMPILER * c, MIST_NODE * pNode)
+{
+    COMP_LOOP Loop;
+    UINT32  Mark = c->NextTemp;
+    UINT32  Cls;
+    UINT32  Top;
+
+    switch (pNode->Type)
+    {
+        case MIST_N_ASSIGN:
+            Cls = Comp_Type(c, pNode->pA);
+            if (Cls && Comp_Type(c, pNode->pB))
+                Comp_Store(c, pNode->pA, Comp_Expr(c, pNode->pB, Cls));
+            break;
+
+        case MIST_N_IF:
+            Comp_If(c, pNode);
+            break;
+
+        case MIST_N_CASE:
+            Comp_Case(c, pNode);
+            break;
+
+        case MIST_N_FOR:
+            Comp_For(c, pNode);
+            break;
+
+        case MIST_N_WHILE:
+            Loop.pOuter = c->pLoop;
+            Loop.ExitList = 0;
+            Loop.ContList = 0;
+            Loop.ContTarget = c->NbOfInstr;
+            c->pLoop = &Loop;
+
+            Comp_Jump(c, MIST_I_JZ, Comp_Cond(c, pNode->pA), &Loop.ExitList);
+            c->NextTemp = Mark;
+            Comp_StmtList(c, pNode->pBody);
+            Comp_EmitImm(c, MIST_I_JMPB, 0, Loop.ContTarget);
+            Comp_Patch(c, Loop.ExitList, c->NbOfInstr);
+            c->pLoop = Loop.pOuter;
+            break;
+
+        case MIST_N_REPEAT:
+            Loop.pOuter = c->pLoop;
+            Loop.ExitList = 0;
+            Loop.ContList = 0;
+            Loop.ContTarget = COMP_NOTARGET;
+            c->pLoop = &Loop;
+
+            Top = c->NbOfInstr;
+            Comp_StmtList(c, pNode->pBody);
+            Comp_Patch(c, Loop.ContList, c->NbOfInstr);
+            Comp_EmitImm(c, MIST_I_JZB, Comp_Cond(c, pNode->pA), Top);
+            Comp_Patch(c, Loop.ExitList, c->NbOfInstr);
+            c->pLoop = Loop.pOuter;
+            break;
+
+        case MIST_N_EXIT:
+            Comp_Jump(c, MIST_I_JMP, 0, &c->pLoop->ExitList);
+            break;
+
+        case MIST_N_CONTINUE:
+            if (c->pLoop->ContTarget != COMP_NOTARGET)
+                Comp_EmitImm(c, MIST_I_JMPB, 0, c->pLoop->ContTarget);
+            else
+                Comp_Jump(c, MIST_I_JMP, 0, &c->pLoop->ContList);
+            break;
+
+        case MIST_N_RETURN:
+            Comp_Emit(c, MIST_I_END, 0, 0, 0);
+            break;
+
+        default:
+            Comp_Error(c, pNode->Offset, "invalid statement");
+            break;
+    }
+
+    c->NextTemp = Mark;
+}
+
+/**
+********************************************************************************
+* @brief Writes the initial values of a variable to the init image.
+*        Arrays take a list of values, n(v) repeats v n times.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pVar     variable with initial value
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_InitVar(COMPILER * c, const MIST_VAR * pVar)
+{
+    const COMP_TYPE *pType = &CompType[pVar->Type];
+    MIST_NODE *pInit;
+    MIST_NODE *pValue;
+    MIST_REG Value;
+    UINT8  *pMem = c->pInit + pVar->MemOffset;
+    UINT32  Count = 1, Index = 0;
+    UINT32  Repeat;
+    UINT32  Dim;
+
+    for (Dim = 0; Dim < pVar->NbOfDims; Dim++)
+        Count *= (UINT32) (pVar->Upper[Dim] - pVar->Lower[Dim]) + 1;
+
+    for (pInit = pVar->pInit; pInit && !c->Error; pInit = pInit->pNext)
+    {
+        Repeat = 1;
+        pValue = pInit;
+        if (pInit->Type == MIST_N_INITREP)
+        {
+            Repeat = (UINT32) pInit->u.Int;
+            pValue = pInit->pA;
+        }
+
+        if (!Comp_IsLiteral(pValue))
+        {
+            Comp_Error(c, pValue->Offset, "initial value of '%s' must be a literal", pVar->pName);
+            return;
+        }
+        Comp_Type(c, pValue);
+        if (!Comp_CanConvert(pValue->Class, pType->Cls))
+        {
+            Comp_Error(c, pValue->Offset, "%s can't be converted to %s implicitly", CompClsName[pValue->Class],
+                       CompClsName[pType->Cls]);
+            return;
+        }
+        if ((Repeat > Count) || (Index > Count - Repeat))
+        {
+            Comp_Error(c, pValue->Offset, "too many initial values for '%s'", pVar->pName);
+            return;
+        }
+
+        Comp_LitValue(pValue, pType->Cls, &Value);
+        for (; Repeat; Repeat--, Index++)
+        {
+            switch (pType->Size)
+            {
+                case 1:
+                    pMem[Index] = (UINT8) Value.u;
+                    break;
+                case 2:
+                    ((UINT16 *) pMem)[Index] = (UINT16) Value.u;
+                    break;
+                case 4:
+                    ((UINT32 *) pMem)[Index] = Value.u;
+                    break;
+                default:
+                    ((REAL64 *) pMem)[Index] = Value.d;
+                    break;
+            }
+        }
+    }
+}
+
+/**
+********************************************************************************
+* @brief Lays out the variables in the data area and creates the init image.
+*        Every variable is aligned to its element size. VAR_TEMP variables
+*        are placed at the end, so they can be reset with one copy per cycle.
+*
+* @param[in]  c        pointer to compiler state
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_Layout(COMPILER * c)
+{
+    MIST_VAR *pVar;
+    UINT64  Offset = 0;
+    UINT64  Size;
+    UINT32  Temp;
+    UINT32  Dim;
+
+    c->pVarDesc = malloc((c->pPou->NbOfVars + 1) * sizeof(UINT32));
+    if (!c->pVarDesc)
+    {
+        Comp_Error(c, c->pPou->Offset, "out of memory");
+        return;
+    }
+    memset(c->pVarDesc, 0xFF, (c->pPou->NbOfVars + 1) * sizeof(UINT32));
+
+    for (Temp = 0; Temp < 2; Temp++)
+    {
+        if (Temp)
+            c->TempOffset = (UINT32) Offset;
+
+        for (pVar = c->pPou->pVars; pVar; pVar = pVar->pNext)
+        {
+            if ((pVar->Class == MIST_KW_VAR_TEMP) != Temp)
+                continue;
+
+            if ((pVar->Type >= MIST_KW_COUNT) || !CompType[pVar->Type].Cls)
+            {
+                Comp_Error(c, pVar->Offset, "data type of '%s' is not supported", pVar->pName);
+                return;
+            }
+            if ((pVar->Class == MIST_KW_VAR_IN_OUT) || (pVar->Class == MIST_KW_VAR_EXTERNAL))
+            {
+                Comp_Error(c, pVar->Offset, "declaration section of '%s' is not supported", pVar->pName);
+                return;
+            }
+
+            pVar->ElemSize = CompType[pVar->Type].Size;
+            Size = pVar->ElemSize;
+            for (Dim = 0; Dim < pVar->NbOfDims; Dim++)
+                Size *= (UINT64) ((SINT64) pVar->Upper[Dim] - pVar->Lower[Dim] + 1);
+
+            Offset = (Offset + pVar->ElemSize - 1) & ~(UINT64) (pVar->ElemSize - 1);
+            pVar->MemOffset = (UINT32) Offset;
+            Offset += Size;
+            if (Offset > COMP_MAXMEM)
+            {
+                Comp_Error(c, pVar->Offset, "data area too large at '%s'", pVar->pName);
+                return;
+            }
+        }
+    }
+
+    c->MemSize = COMP_ALIGN8((UINT32) Offset);
+    c->pInit = calloc(1, c->MemSize + 1);
+    if (!c->pInit)
+    {
+        Comp_Error(c, c->pPou->Offset, "out of memory");
+        return;
+    }
+
+    for (pVar = c->pPou->pVars; pVar && !c->Error; pVar = pVar->pNext)
+    {
+        if (pVar->pInit)
+            Comp_InitVar(c, pVar);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Counts the nodes of a list of syntax trees.
+*
+* @param[in]  pNode    first node of the list, NULL = empty list
+* @param[out] N/A
+*
+* @retval     number of nodes
+*******************************************************************************/
+MLOCAL UINT32 Comp_Count(const MIST_NODE * pNode)
+{
+    UINT32  Count = 0;
+
+    while (pNode)
+    {
+        Count += 1 + Comp_Count(pNode->pB) + Comp_Count(pNode->pC) + Comp_Count(pNode->pD) + Comp_Count(pNode->pBody);
+
+        /* The last node continues with its ELSE part or its first operand, chains don't recurse */
+        if (pNode->pNext)
+        {
+            Count += Comp_Count(pNode->pA) + Comp_Count(pNode->pElse);
+            pNode = pNode->pNext;
+        }
+        else if (pNode->pElse)
+        {
+            Count += Comp_Count(pNode->pA);
+            pNode = pNode->pElse;
+        }
+        else
+            pNode = pNode->pA;
+    }
+    return (Count);
+}
+
+/**
+********************************************************************************
+* @brief Executes one instruction on constant operands at compile time,
+*        exactly like the virtual machine does at run time.
+*
+* @param[in]  Op       operation code MIST_I_xxx, arithmetic or conversion
+* @param[in]  pB, pC   operands, pC is not used by instructions with one operand
+* @param[out] pA       result, unused bytes are 0
+*
+* @retval     TRUE  .. the result is valid
+* @retval     FALSE .. the instruction faults, it is left for the run time
+*******************************************************************************/
+MLOCAL BOOL Comp_FoldOp(UINT32 Op, const MIST_REG * pB, const MIST_REG * pC, MIST_REG * pA)
+{
+    MIST_REG B = *pB;
+    MIST_REG C = pC ? *pC : B;
+
+    memset(pA, 0, sizeof(*pA));
+    switch (Op)
+    {
+        case MIST_I_ADD:
+            pA->u = B.u + C.u;
+            break;
+        case MIST_I_SUB:
+            pA->u = B.u - C.u;
+            break;
+        case MIST_I_MUL:
+            pA->u = B.u * C.u;
+            break;
+        case MIST_I_DIV:
+            if (!C.i)
+                return (FALSE);
+            pA->i = (C.i == -1) ? (SINT32) (0u - B.u) : B.i / C.i;
+            break;
+        case MIST_I_MOD:
+            if (!C.i)
+                return (FALSE);
+            pA->i = (C.i == -1) ? 0 : B.i % C.i;
+            break;
+        case MIST_I_DIVU:
+            if (!C.u)
+                return (FALSE);
+            pA->u = B.u / C.u;
+            break;
+        case MIST_I_MODU:
+            if (!C.u)
+                return (FALSE);
+            pA->u = B.u % C.u;
+            break;
+        case MIST_I_NEG:
+            pA->u = 0u - B.u;
+            break;
+        case MIST_I_AND:
+            pA->u = B.u & C.u;
+            break;
+        case MIST_I_OR:
+            pA->u = B.u | C.u;
+            break;
+        case MIST_I_XOR:
+            pA->u = B.u ^ C.u;
+            break;
+        case MIST_I_NOT:
+            pA->u = ~B.u;
+            break;
+        case MIST_I_EQ:
+            pA->i = (B.u == C.u);
+            break;
+        case MIST_I_NE:
+            pA->i = (B.u != C.u);
+            break;
+        case MIST_I_LT:
+            pA->i = (B.i < C.i);
+            break;
+        case MIST_I_LE:
+            pA->i = (B.i <= C.i);
+            break;
+        case MIST_I_GT:
+            pA->i = (B.i > C.i);
+            break;
+        case MIST_I_GE:
+            pA->i = (B.i >= C.i);
+            break;
+        case MIST_I_LTU:
+            pA->i = (B.u < C.u);
+            break;
+        case MIST_I_LEU:
+            pA->i = (B.u <= C.u);
+            break;
+        case MIST_I_GTU:
+            pA->i = (B.u > C.u);
+            break;
+        case MIST_I_GEU:
+            pA->i = (B.u >= C.u);
+            break;
+        case MIST_I_MIN:
+            pA->i = (B.i < C.i) ? B.i : C.i;
+            break;
+        case MIST_I_MAX:
+            pA->i = (B.i > C.i) ? B.i : C.i;
+            break;
+        case MIST_I_MINU:
+            pA->u = (B.u < C.u) ? B.u : C.u;
+            break;
+        case MIST_I_MAXU:
+            pA->u = (B.u > C.u) ? B.u : C.u;
+            break;
+        case MIST_I_ABS:
+            pA->u = (B.i < 0) ? 0u - B.u : B.u;
+            break;
+        case MIST_I_SX8:
+            pA->i = (SINT8) B.u;
+            break;
+        case MIST_I_SX16:
+            pA->i = (SINT16) B.u;
+            break;
+        case MIST_I_ZX8:
+            pA->u = (UINT8) B.u;
+            break;
+        case MIST_I_ZX16:
+            pA->u = (UINT16) B.u;
+            break;
+
+        case MIST_I_ADDF:
+            pA->f = B.f + C.f;
+            break;
+        case MIST_I_SUBF:
+            pA->f = B.f - C.f;
+            break;
+        case MIST_I_MULF:
+            pA->f = B.f * C.f;
+            break;
+        case MIST_I_DIVF:
+            pA->f = B.f / C.f;
+            break;
+        case MIST_I_NEGF:
+            pA->f = -B.f;
+            break;
+        case MIST_I_ABSF:
+            pA->f = (B.f < 0) ? -B.f : B.f;
+            break;
+        case MIST_I_MINF:
+            pA->f = (B.f < C.f) ? B.f : C.f;
+            break;
+        case MIST_I_MAXF:
+            pA->f = (B.f > C.f) ? B.f : C.f;
+            break;
+        case MIST_I_POWF:
+            pA->f = (REAL32) pow(B.f, C.f);
+            break;
+        case MIST_I_EQF:
+            pA->i = (B.f == C.f);
+            break;
+        case MIST_I_NEF:
+            pA->i = (B.f != C.f);
+            break;
+        case MIST_I_LTF:
+            pA->i = (B.f < C.f);
+            break;
+        case MIST_I_LEF:
+            pA->i = (B.f <= C.f);
+            break;
+        case MIST_I_GTF:
+            pA->i = (B.f > C.f);
+            break;
+        case MIST_I_GEF:
+            pA->i = (B.f >= C.f);
+            break;
+
+        case MIST_I_ADDD:
+            pA->d = B.d + C.d;
+            break;
+        case MIST_I_SUBD:
+            pA->d = B.d - C.d;
+            break;
+        case MIST_I_MULD:
+            pA->d = B.d * C.d;
+            break;
+        case MIST_I_DIVD:
+            pA->d = B.d / C.d;
+            break;
+        case MIST_I_NEGD:
+            pA->d = -B.d;
+            break;
+        case MIST_I_ABSD:
+            pA->d = (B.d < 0) ? -B.d : B.d;
+            break;
+        case MIST_I_MIND:
+            pA->d = (B.d < C.d) ? B.d : C.d;
+            break;
+        case MIST_I_MAXD:
+            pA->d = (B.d > C.d) ? B.d : C.d;
+            break;
+        case MIST_I_POWD:
+            pA->d = pow(B.d, C.d);
+            break;
+        case MIST_I_EQD:
+            pA->i = (B.d == C.d);
+            break;
+        case MIST_I_NED:
+            pA->i = (B.d != C.d);
+            break;
+        case MIST_I_LTD:
+            pA->i = (B.d < C.d);
+            break;
+        case MIST_I_LED:
+            pA->i = (B.d <= C.d);
+            break;
+        case MIST_I_GTD:
+            pA->i = (B.d > C.d);
+            break;
+        case MIST_I_GED:
+            pA->i = (B.d >= C.d);
+            break;
+
+        case MIST_I_FTOI:
+            pA->i = mist_VmRound(B.f);
+            break;
+        case MIST_I_DTOI:
+            pA->i = mist_VmRound(B.d);
+            break;
+        case MIST_I_FTOU:
+            pA->u = mist_VmRoundU(B.f);
+            break;
+        case MIST_I_DTOU:
+            pA->u = mist_VmRoundU(B.d);
+            break;
+        case MIST_I_TRUNCF:
+            pA->i = mist_VmTrunc(B.f);
+            break;
+        case MIST_I_TRUNCD:
+            pA->i = mist_VmTrunc(B.d);
+            break;
+
+        default:
+            return (FALSE);
+    }
+    return (TRUE);
+}
+
+/**
+********************************************************************************
+* @brief Replaces an expression by a literal. The literal gets the data type
+*        of its class, so it is typed again like the replaced expression
+*        (no untyped real literal, see Comp_Common()).
+*
+* @param[in]  pNode    expression, becomes the literal
+* @param[in]  Cls      class of the value
+* @param[in]  pValue   value in this class
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_SetLit(MIST_NODE * pNode, UINT32 Cls, const MIST_REG * pValue)
+{
+    pNode->Type = (Cls >= MIST_CLS_REAL) ? MIST_N_REAL : MIST_N_INT;
+    pNode->Op = 0;
+    pNode->DataType = CompLitType[Cls];
+    pNode->Class = Cls;
+    pNode->pA = pNode->pB = pNode->pC = pNode->pD = NULL;
+    if (Cls == MIST_CLS_REAL)
+        pNode->u.Real = pValue->f;
+    else if (Cls == MIST_CLS_LREAL)
+        pNode->u.Real = pValue->d;
+    else
+        pNode->u.Int = pValue->i;
+}
+
+/**
+********************************************************************************
+* @brief Reads the initial value of a constant from the init image,
+*        like the load instruction of its data type.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pVar     variable declared with VAR CONSTANT
+* @param[in]  Offset   data offset of the variable or array element
+* @param[out] pValue   value in the class of the variable, unused bytes are 0
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_InitValue(COMPILER * c, const MIST_VAR * pVar, UINT32 Offset, MIST_REG * pValue)
+{
+    const UINT8 *pMem = c->pInit + Offset;
+    SINT16  Int16;
+    UINT16  Uint16;
+
+    memset(pValue, 0, sizeof(*pValue));
+    switch (CompType[pVar->Type].Load)
+    {
+        case MIST_I_LDS8:
+            pValue->i = (SINT8) *pMem;
+            break;
+        case MIST_I_LDU8:
+            pValue->i = *pMem;
+            break;
+        case MIST_I_LDS16:
+            memcpy(&Int16, pMem, sizeof(Int16));
+            pValue->i = Int16;
+            break;
+        case MIST_I_LDU16:
+            memcpy(&Uint16, pMem, sizeof(Uint16));
+            pValue->i = Uint16;
+            break;
+        case MIST_I_LD32:
+            memcpy(&pValue->u, pMem, sizeof(UINT32));
+            break;
+        default:
+            memcpy(&pValue->d, pMem, sizeof(REAL64));
+            break;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Folds a call of a standard function with literal arguments,
+*        SEL() with a literal selector is replaced by the selected input.
+*
+* @param[in]  pNode    MIST_N_CALL node, arguments already folded
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_FoldCall(MIST_NODE * pNode)
+{
+    MIST_NODE *pArg = pNode->pA;
+    MIST_NODE *pNext;
+    const COMP_TYPE *pTo;
+    MIST_REG A, B, R;
+    UINT32  Cls = pNode->Class;
+    UINT32  Op = 0;
+
+    if (pNode->Op == MIST_F_SEL)
+    {
+        if (!Comp_IsLiteral(pArg))
+            return;
+        pArg = pArg->u.Int ? pArg->pNext->pNext : pArg->pNext;
+        if (Comp_IsLiteral(pArg))
+        {
+            Comp_LitValue(pArg, Cls, &R);
+            Comp_SetLit(pNode, Cls, &R);
+        }
+        else if (pArg->Class == Cls)
+        {
+            pNext = pNode->pNext;
+            *pNode = *pArg;
+            pNode->pNext = pNext;
+        }
+        return;
+    }
+
+    for (; pArg; pArg = pArg->pNext)
+    {
+        if (!Comp_IsLiteral(pArg))
+            return;
+    }
+    pArg = pNode->pA;
+
+    switch (pNode->Op)
+    {
+        case MIST_F_CONV:
+            pTo = &CompType[pNode->DataType];
+            if ((pTo->Cls == MIST_CLS_BOOL) && (pArg->Class != MIST_CLS_BOOL))
+            {
+                Comp_LitValue(pArg, pArg->Class, &A);
+                memset(&B, 0, sizeof(B));
+                Op = (pArg->Class == MIST_CLS_REAL) ? MIST_I_NEF : (pArg->Class == MIST_CLS_LREAL) ? MIST_I_NED : MIST_I_NE;
+                Comp_FoldOp(Op, &A, &B, &R);
+            }
+            else if ((pTo->Cls >= MIST_CLS_REAL) || (pArg->Class <= MIST_CLS_UINT))
+                Comp_LitValue(pArg, (pTo->Cls >= MIST_CLS_REAL) ? pTo->Cls : pArg->Class, &R);
+            else
+            {
+                Comp_LitValue(pArg, pArg->Class, &A);
+                if (pTo->Cls == MIST_CLS_UINT)
+                    Op = (pArg->Class == MIST_CLS_REAL) ? MIST_I_FTOU : MIST_I_DTOU;
+                else
+                    Op = (pArg->Class == MIST_CLS_REAL) ? MIST_I_FTOI : MIST_I_DTOI;
+                Comp_FoldOp(Op, &A, NULL, &R);
+            }
+            if (pTo->Narrow)
+                Comp_FoldOp(pTo->Narrow, &R, NULL, &R);
+            break;
+
+        case MIST_F_TRUNC:
+            Comp_LitValue(pArg, pArg->Class, &R);
+            if (pArg->Class >= MIST_CLS_REAL)
+                Comp_FoldOp((pArg->Class == MIST_CLS_REAL) ? MIST_I_TRUNCF : MIST_I_TRUNCD, &R, NULL, &R);
+            break;
+
+        case MIST_F_ABS:
+            Comp_LitValue(pArg, Cls, &R);
+            Op = (Cls == MIST_CLS_REAL) ? MIST_I_ABSF : (Cls == MIST_CLS_LREAL) ? MIST_I_ABSD : MIST_I_ABS;
+            if (Cls != MIST_CLS_UINT)
+                Comp_FoldOp(Op, &R, NULL, &R);
+            break;
+
+        case MIST_F_EXPT:
+            Comp_LitValue(pArg, Cls, &A);
+            Comp_LitValue(pArg->pNext, Cls, &B);
+            Comp_FoldOp((Cls == MIST_CLS_REAL) ? MIST_I_POWF : MIST_I_POWD, &A, &B, &R);
+            break;
+
+        case MIST_F_MIN:
+        case MIST_F_MAX:
+            if (Cls == MIST_CLS_REAL)
+                Op = (pNode->Op == MIST_F_MIN) ? MIST_I_MINF : MIST_I_MAXF;
+            else if (Cls == MIST_CLS_LREAL)
+                Op = (pNode->Op == MIST_F_MIN) ? MIST_I_MIND : MIST_I_MAXD;
+            else if (Cls == MIST_CLS_UINT)
+                Op = (pNode->Op == MIST_F_MIN) ? MIST_I_MINU : MIST_I_MAXU;
+            else
+                Op = (pNode->Op == MIST_F_MIN) ? MIST_I_MIN : MIST_I_MAX;
+            Comp_LitValue(pArg, Cls, &R);
+            for (pArg = pArg->pNext; pArg; pArg = pArg->pNext)
+            {
+                Comp_LitValue(pArg, Cls, &B);
+                Comp_FoldOp(Op, &R, &B, &R);
+            }
+            break;
+
+        case MIST_F_LIMIT:
+            Comp_LitValue(pArg->pNext, Cls, &A);
+            Comp_LitValue(pArg, Cls, &B);
+            Op = (Cls == MIST_CLS_REAL) ? MIST_I_MAXF : (Cls == MIST_CLS_LREAL) ? MIST_I_MAXD :
+                (Cls == MIST_CLS_UINT) ? MIST_I_MAXU : MIST_I_MAX;
+            Comp_FoldOp(Op, &A, &B, &R);
+            Comp_LitValue(pArg->pNext->pNext, Cls, &B);
+            Op = (Cls == MIST_CLS_REAL) ? MIST_I_MINF : (Cls == MIST_CLS_LREAL) ? MIST_I_MIND :
+                (Cls == MIST_CLS_UINT) ? MIST_I_MINU : MIST_I_MIN;
+            Comp_FoldOp(Op, &R, &B, &R);
+            break;
+
+        default:
+            /* Math functions */
+            Comp_LitValue(pArg, Cls, &A);
+            memset(&R, 0, sizeof(R));
+            if (Cls == MIST_CLS_REAL)
+                R.f = (REAL32) mist_VmMath(pNode->Op - MIST_F_SQRT + MIST_FN_SQRT, A.f);
+            else
+                R.d = mist_VmMath(pNode->Op - MIST_F_SQRT + MIST_FN_SQRT, A.d);
+            break;
+    }
+    Comp_SetLit(pNode, Cls, &R);
+}
+
+/**
+********************************************************************************
+* @brief Folds a binary operation, see Comp_Fold().
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    MIST_N_BINARY node, first operand already folded
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_FoldBinary(COMPILER * c, MIST_NODE * pNode)
+{
+    MIST_REG A, B, R;
+    UINT32  Cls;
+
+    Comp_Fold(c, pNode->pB);
+    if (!Comp_IsLiteral(pNode->pA) || !Comp_IsLiteral(pNode->pB))
+        return;
+    Cls = Comp_BinClass(pNode);
+    Comp_LitValue(pNode->pA, Cls, &A);
+    Comp_LitValue(pNode->pB, Cls, &B);
+    if (Comp_FoldOp(CompBinOp[pNode->Op][Cls], &A, &B, &R))
+        Comp_SetLit(pNode, pNode->Class, &R);
+}
+
+/**
+********************************************************************************
+* @brief Folds an expression bottom up: operations on literals are
+*        calculated, constants declared with VAR CONSTANT are replaced by
+*        their initial values. Operations that fault, like a division by
+*        zero, remain for the run time.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    expression, classes assigned by Comp_Type()
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_Fold(COMPILER * c, MIST_NODE * pNode)
+{
+    MIST_NODE *pArg;
+    const MIST_VAR *pVar;
+    MIST_REG A, B, R;
+    UINT32  Cls = pNode->Class;
+    UINT32  Op;
+    UINT32  Offset;
+    UINT32  Dim;
+    UINT32  Len;
+
+    switch (pNode->Type)
+    {
+        case MIST_N_VAR:
+            pVar = pNode->u.pVar;
+            if ((pVar->Flags & MIST_VF_CONSTANT) && (pVar->Class != MIST_KW_VAR_INPUT))
+            {
+                Comp_InitValue(c, pVar, pVar->MemOffset, &R);
+                Comp_SetLit(pNode, Cls, &R);
+            }
+            break;
+
+        case MIST_N_INDEX:
+            for (pArg = pNode->pB; pArg; pArg = pArg->pNext)
+                Comp_Fold(c, pArg);
+            pVar = pNode->pA->u.pVar;
+            if (!(pVar->Flags & MIST_VF_CONSTANT) || (pVar->Class == MIST_KW_VAR_INPUT))
+                break;
+
+            /* Element of a constant array, out of bounds is reported by Comp_ConstOffset() */
+            Offset = 0;
+            for (pArg = pNode->pB, Dim = 0; pArg; pArg = pArg->pNext, Dim++)
+            {
+                if ((pArg->Type != MIST_N_INT) || (pArg->u.Int < pVar->Lower[Dim]) || (pArg->u.Int > pVar->Upper[Dim]))
+                    return;
+                Offset = Offset * (UINT32) (pVar->Upper[Dim] - pVar->Lower[Dim] + 1) +
+                    (UINT32) (pArg->u.Int - pVar->Lower[Dim]);
+            }
+            Comp_InitValue(c, pVar, pVar->MemOffset + Offset * pVar->ElemSize, &R);
+            Comp_SetLit(pNode, Cls, &R);
+            break;
+
+        case MIST_N_UNARY:
+            Comp_Fold(c, pNode->pA);
+            if (!Comp_IsLiteral(pNode->pA))
+                break;
+            Comp_LitValue(pNode->pA, Cls, &A);
+            memset(&B, 0, sizeof(B));
+            B.i = 1;
+            if ((pNode->Op == MIST_OP_NOT) && (Cls == MIST_CLS_BOOL))
+                Op = MIST_I_XOR;
+            else if (pNode->Op == MIST_OP_NOT)
+                Op = MIST_I_NOT;
+            else
+                Op = (Cls == MIST_CLS_REAL) ? MIST_I_NEGF : (Cls == MIST_CLS_LREAL) ? MIST_I_NEGD : MIST_I_NEG;
+            if (Comp_FoldOp(Op, &A, &B, &R))
+                Comp_SetLit(pNode, Cls, &R);
+            break;
+
+        case MIST_N_BINARY:
+            /* First operands from the innermost node upwards, see mist_NodeChain() */
+            Len = mist_NodeChain(pNode);
+            Comp_Fold(c, mist_NodeLeft(pNode, Len));
+            while (Len-- > 0)
+                Comp_FoldBinary(c, mist_NodeLeft(pNode, Len));
+            break;
+
+        case MIST_N_CALL:
+            for (pArg = pNode->pA; pArg; pArg = pArg->pNext)
+                Comp_Fold(c, pArg);
+            Comp_FoldCall(pNode);
+            break;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Checks if a loop body can be executed without the loop around:
+*        it doesn't use EXIT or CONTINUE of this loop and doesn't assign
+*        the control variable.
+*
+* @param[in]  pStmt    statement list
+* @param[in]  pVar     control variable, NULL = none
+* @param[in]  Nested   statements belong to an inner loop
+* @param[out] N/A
+*
+* @retval     TRUE, FALSE
+*******************************************************************************/
+MLOCAL BOOL Comp_Straight(const MIST_NODE * pStmt, const MIST_VAR * pVar, BOOL Nested)
+{
+    const MIST_NODE *pElem;
+    const MIST_NODE *pNext;
+
+    for (; pStmt; pStmt = pNext)
+    {
+        pNext = pStmt->pNext;
+        switch (pStmt->Type)
+        {
+            case MIST_N_EXIT:
+            case MIST_N_CONTINUE:
+                if (!Nested)
+                    return (FALSE);
+                break;
+
+            case MIST_N_ASSIGN:
+                if (((pStmt->pA->Type == MIST_N_VAR) ? pStmt->pA->u.pVar : pStmt->pA->pA->u.pVar) == pVar)
+                    return (FALSE);
+                break;
+
+            case MIST_N_FOR:
+                if (pStmt->pA->u.pVar == pVar)
+                    return (FALSE);
+                /* no break */
+            case MIST_N_WHILE:
+            case MIST_N_REPEAT:
+                if (!Comp_Straight(pStmt->pBody, pVar, TRUE))
+                    return (FALSE);
+                break;
+
+            case MIST_N_IF:
+                if (!Comp_Straight(pStmt->pBody, pVar, Nested))
+                    return (FALSE);
+                /* The ELSE part of the last statement continues the loop, a chain of ELSIF doesn't recurse */
+                if (!pNext)
+                    pNext = pStmt->pElse;
+                else if (!Comp_Straight(pStmt->pElse, pVar, Nested))
+                    return (FALSE);
+                break;
+
+            case MIST_N_CASE:
+                for (pElem = pStmt->pBody; pElem; pElem = pElem->pNext)
+                {
+                    if (!Comp_Straight(pElem->pBody, pVar, Nested))
+                        return (FALSE);
+                }
+                if (!Comp_Straight(pStmt->pElse, pVar, Nested))
+                    return (FALSE);
+                break;
+        }
+    }
+    return (TRUE);
+}
+
+/**
+********************************************************************************
+* @brief Calculates the iterations of a FOR loop with literal start, end
+*        and step. Values are truncated to the control variable like
+*        Comp_For() does at run time. Loops without iteration, with step 0
+*        or wrapping around the range of the control variable are not
+*        counted.
+*
+* @param[in]  pNode    MIST_N_FOR node, typed and folded
+* @param[out] pTrip    iterations of the loop
+*
+* @retval     TRUE  .. the number of iterations is known
+* @retval     FALSE .. the loop is left to the run time
+*******************************************************************************/
+MLOCAL BOOL Comp_ForTrip(const MIST_NODE * pNode, COMP_TRIP * pTrip)
+{
+    const COMP_TYPE *pType = &CompType[pNode->pA->u.pVar->Type];
+    MIST_REG Start, End, Step, Var, Next, Cond;
+    UINT32  Cls = pNode->pA->Class;
+    SINT64  Min, Max, Last, Count;
+
+    if (!Comp_IsLiteral(pNode->pB) || !Comp_IsLiteral(pNode->pC) || (pNode->pD && !Comp_IsLiteral(pNode->pD)))
+        return (FALSE);
+    if (!Comp_CanConvert(pNode->pB->Class, Cls) || !Comp_CanConvert(pNode->pC->Class, Cls) ||
+        (pNode->pD && !Comp_CanConvert(pNode->pD->Class, Cls)))
+        return (FALSE);
+
+    Comp_LitValue(pNode->pB, Cls, &Start);
+    Comp_LitValue(pNode->pC, Cls, &End);
+    memset(&Step, 0, sizeof(Step));
+    Step.i = 1;
+    if (pNode->pD)
+        Comp_LitValue(pNode->pD, Cls, &Step);
+    Var = Start;
+    if (pType->Narrow)
+        Comp_FoldOp(pType->Narrow, &Start, NULL, &Var);
+
+    if (Cls == MIST_CLS_UINT)
+    {
+        pTrip->First = Var.u;
+        Last = End.u;
+        pTrip->Step = Step.u;
+        Min = 0;
+        Max = 0xFFFFFFFF;
+    }
+    else
+    {
+        pTrip->First = Var.i;
+        Last = End.i;
+        pTrip->Step = Step.i;
+        switch (pType->Narrow)
+        {
+            case MIST_I_SX8:
+                Min = -0x80;
+                Max = 0x7F;
+                break;
+            case MIST_I_SX16:
+                Min = -0x8000;
+                Max = 0x7FFF;
+                break;
+            case MIST_I_ZX8:
+                Min = 0;
+                Max = 0xFF;
+                break;
+            case MIST_I_ZX16:
+                Min = 0;
+                Max = 0xFFFF;
+                break;
+            default:
+                Min = -(SINT64) 0x80000000;
+                Max = 0x7FFFFFFF;
+                break;
+        }
+    }
+
+    if (pTrip->Step > 0)
+        Count = (Last >= pTrip->First) ? (Last - pTrip->First) / pTrip->Step + 1 : 0;
+    else if (pTrip->Step < 0)
+        Count = (Last <= pTrip->First) ? (pTrip->First - Last) / -pTrip->Step + 1 : 0;
+    else
+        Count = 0;
+    if ((Count <= 0) || (Count > 0xFFFFFFFF))
+        return (FALSE);
+
+    /* All values must fit into the control variable and the loop must end */
+    pTrip->Count = (UINT32) Count;
+    pTrip->Last = pTrip->First + (Count - 1) * pTrip->Step;
+    if ((pTrip->Last < Min) || (pTrip->Last > Max))
+        return (FALSE);
+    memset(&Var, 0, sizeof(Var));
+    Var.u = (UINT32) pTrip->Last;
+    Comp_FoldOp(MIST_I_ADD, &Var, &Step, &Next);
+    pTrip->Final = Next;
+    if (pType->Narrow)
+        Comp_FoldOp(pType->Narrow, &Next, NULL, &pTrip->Final);
+    if (Cls == MIST_CLS_UINT)
+        Comp_FoldOp(MIST_I_LEU, &pTrip->Final, &End, &Cond);
+    else
+        Comp_FoldOp((pTrip->Step < 0) ? MIST_I_GE : MIST_I_LE, &pTrip->Final, &End, &Cond);
+    return (!Cond.i);
+}
+
+/**
+********************************************************************************
+* @brief Copies a list of syntax trees into the arena of the unit.
+*        Variables and names are shared with the original. The last node
+*        of a list continues with its ELSE part or its first operand, so
+*        chains of ELSIF and operators are copied in a loop.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    first node of the list, NULL = empty list
+* @param[out] N/A
+*
+* @retval     first node of the copy
+*******************************************************************************/
+MLOCAL MIST_NODE *Comp_Clone(COMPILER * c, const MIST_NODE * pNode)
+{
+    MIST_NODE *pList = NULL;
+    MIST_NODE **ppTail = &pList;
+    MIST_NODE *pCopy;
+
+    while (pNode && !c->Error)
+    {
+        pCopy = mist_ArenaAlloc(&c->pUnit->Arena, sizeof(MIST_NODE));
+        if (!pCopy)
+        {
+            Comp_Error(c, pNode->Offset, "out of memory");
+            return (NULL);
+        }
+        *pCopy = *pNode;
+        pCopy->pNext = NULL;
+        pCopy->pB = Comp_Clone(c, pNode->pB);
+        pCopy->pC = Comp_Clone(c, pNode->pC);
+        pCopy->pD = Comp_Clone(c, pNode->pD);
+        pCopy->pBody = Comp_Clone(c, pNode->pBody);
+        *ppTail = pCopy;
+
+        if (pNode->pNext)
+        {
+            pCopy->pA = Comp_Clone(c, pNode->pA);
+            pCopy->pElse = Comp_Clone(c, pNode->pElse);
+            ppTail = &pCopy->pNext;
+            pNode = pNode->pNext;
+        }
+        else if (pNode->pElse)
+        {
+            pCopy->pA = Comp_Clone(c, pNode->pA);
+            pCopy->pElse = NULL;
+            ppTail = &pCopy->pElse;
+            pNode = pNode->pElse;
+        }
+        else
+        {
+            pCopy->pA = NULL;
+            ppTail = &pCopy->pA;
+            pNode = pNode->pA;
+        }
+    }
+    return (pList);
+}
+
+/**
+********************************************************************************
+* @brief Replaces all reads of a variable in a list of syntax trees by a
+*        literal. The variable must not be written.
+*
+* @param[in]  pNode    first node of the list, NULL = empty list
+* @param[in]  pVar     scalar variable
+* @param[in]  Cls      class of the variable
+* @param[in]  pValue   value in this class
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_Subst(MIST_NODE * pNode, const MIST_VAR * pVar, UINT32 Cls, const MIST_REG * pValue)
+{
+    while (pNode)
+    {
+        if ((pNode->Type == MIST_N_VAR) && (pNode->u.pVar == pVar))
+        {
+            Comp_SetLit(pNode, Cls, pValue);
+            pNode = pNode->pNext;
+            continue;
+        }
+        Comp_Subst(pNode->pB, pVar, Cls, pValue);
+        Comp_Subst(pNode->pC, pVar, Cls, pValue);
+        Comp_Subst(pNode->pD, pVar, Cls, pValue);
+        Comp_Subst(pNode->pBody, pVar, Cls, pValue);
+
+        /* The last node continues with its ELSE part or its first operand, see Comp_Clone() */
+        if (pNode->pNext)
+        {
+            Comp_Subst(pNode->pA, pVar, Cls, pValue);
+            Comp_Subst(pNode->pElse, pVar, Cls, pValue);
+            pNode = pNode->pNext;
+        }
+        else if (pNode->pElse)
+        {
+            Comp_Subst(pNode->pA, pVar, Cls, pValue);
+            pNode = pNode->pElse;
+        }
+        else
+            pNode = pNode->pA;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Simplifies a FOR loop with literal start, end and step:
+*        a loop without iteration becomes the assignment of the start value,
+*        a short loop is unrolled. Every copy of the body is preceded by the
+*        assignment of its value and reads the control variable as literal,
+*        the final value is assigned behind the last copy. Unrolled
+*        iterations don't count against the loop budget. Sweeps which
+*        become copies or fills (Comp_ForBlock()) are kept as loops.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    MIST_N_FOR node, expressions already folded
+* @param[out] ppList   replacing statement list
+*
+* @retval     TRUE  .. the loop is replaced by *ppList
+* @retval     FALSE .. the loop remains
+*******************************************************************************/
+MLOCAL BOOL Comp_OptFor(COMPILER * c, MIST_NODE * pNode, MIST_NODE ** ppList)
+{
+    const COMP_TYPE *pType = &CompType[pNode->pA->u.pVar->Type];
+    const MIST_VAR *pVar = pNode->pA->u.pVar;
+    MIST_VM_BLOCK Block;
+    COMP_TRIP Trip;
+    MIST_NODE *pAssign;
+    MIST_NODE *pBody;
+    MIST_NODE **ppTail;
+    MIST_REG Start, End, Step, Var, Cond;
+    UINT32  Cls = pNode->pA->Class;
+    UINT32  Cmp, Op;
+    UINT32  i;
+
+    if (!Comp_IsLiteral(pNode->pB) || !Comp_IsLiteral(pNode->pC) || (pNode->pD && !Comp_IsLiteral(pNode->pD)))
+        return (FALSE);
+    if (!Comp_CanConvert(pNode->pB->Class, Cls) || !Comp_CanConvert(pNode->pC->Class, Cls) ||
+        (pNode->pD && !Comp_CanConvert(pNode->pD->Class, Cls)))
+        return (FALSE);
+
+    Comp_LitValue(pNode->pB, Cls, &Start);
+    Comp_LitValue(pNode->pC, Cls, &End);
+    memset(&Step, 0, sizeof(Step));
+    Step.i = 1;
+    if (pNode->pD)
+        Comp_LitValue(pNode->pD, Cls, &Step);
+    if (Cls == MIST_CLS_UINT)
+        Cmp = MIST_I_LEU;
+    else
+        Cmp = (Step.i < 0) ? MIST_I_GE : MIST_I_LE;
+
+    Var = Start;
+    if (pType->Narrow)
+        Comp_FoldOp(pType->Narrow, &Start, NULL, &Var);
+    Comp_FoldOp(Cmp, &Var, &End, &Cond);
+    if (!Cond.i)
+    {
+        pNode->Type = MIST_N_ASSIGN;
+        pNode->pNext = pNode->pC = pNode->pD = pNode->pBody = NULL;
+        *ppList = pNode;
+        return (TRUE);
+    }
+
+    if (!Comp_ForTrip(pNode, &Trip) || !Comp_Straight(pNode->pBody, pVar, FALSE))
+        return (FALSE);
+    if ((Trip.Count > COMP_UNROLL_TRIP) || (Trip.Count * Comp_Count(pNode->pBody) > COMP_UNROLL_NODE))
+        return (FALSE);
+    Op = Comp_ForBlock(pNode, &Trip, &Block);
+    if ((Trip.Count > 1) && ((Op == MIST_I_COPY) || (Op == MIST_I_FILL)))
+        return (FALSE);
+
+    /* var := v0; body(v0); var := v1; body(v1); ... var := final */
+    *ppList = NULL;
+    ppTail = ppList;
+    memset(&Var, 0, sizeof(Var));
+    for (i = 0; (i <= Trip.Count) && !c->Error; i++)
+    {
+        pAssign = mist_ArenaAlloc(&c->pUnit->Arena, sizeof(MIST_NODE));
+        if (!pAssign)
+        {
+            Comp_Error(c, pNode->Offset, "out of memory");
+            return (FALSE);
+        }
+        Var.u = (UINT32) (Trip.First + i * Trip.Step);
+        if (i == Trip.Count)
+            Var = Trip.Final;
+        pAssign->Type = MIST_N_ASSIGN;
+        pAssign->Offset = pNode->Offset;
+        pAssign->pA = pNode->pA;
+        pAssign->pB = Comp_Clone(c, pNode->pC);
+        if (pAssign->pB)
+            Comp_SetLit(pAssign->pB, Cls, &Var);
+        *ppTail = pAssign;
+        ppTail = &pAssign->pNext;
+        if (i == Trip.Count)
+            break;
+
+        /* The last copy is the original body */
+        pBody = (i + 1 < Trip.Count) ? Comp_Clone(c, pNode->pBody) : pNode->pBody;
+        Comp_Subst(pBody, pVar, Cls, &Var);
+        Comp_OptList(c, &pBody);
+        *ppTail = pBody;
+        for (; *ppTail; ppTail = &(*ppTail)->pNext)
+            ;
+    }
+    return (!c->Error);
+}
+
+/**
+********************************************************************************
+* @brief Optimizes IF and its chain of ELSIF in a loop, see Comp_OptStmt().
+*        A branch with the literal condition TRUE replaces the rest of the
+*        chain, a branch with FALSE is removed.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    MIST_N_IF node
+* @param[out] ppList   replacing statement list, NULL = statement is removed
+*
+* @retval     TRUE  .. the statement is replaced by *ppList
+* @retval     FALSE .. the statement remains
+*******************************************************************************/
+MLOCAL BOOL Comp_OptIf(COMPILER * c, MIST_NODE * pNode, MIST_NODE ** ppList)
+{
+    MIST_NODE *pLink;
+    MIST_NODE **ppSlot;
+
+    for (pLink = pNode; !c->Error; pLink = pLink->pElse)
+    {
+        if (Comp_Type(c, pLink->pA) == MIST_CLS_BOOL)
+            Comp_Fold(c, pLink->pA);
+        Comp_OptList(c, &pLink->pBody);
+        if (!mist_NodeElsif(pLink->pElse))
+        {
+            Comp_OptList(c, &pLink->pElse);
+            break;
+        }
+    }
+    if (c->Error)
+        return (FALSE);
+
+    /* From the top, *ppSlot receives what remains of the chain below */
+    ppSlot = ppList;
+    for (pLink = pNode;; pLink = pLink->pElse)
+    {
+        if ((pLink->pA->Type != MIST_N_INT) || (pLink->pA->Class != MIST_CLS_BOOL))
+        {
+            *ppSlot = pLink;
+            ppSlot = &pLink->pElse;
+        }
+        else if (pLink->pA->u.Int)
+        {
+            *ppSlot = pLink->pBody;
+            break;
+        }
+        else
+            *ppSlot = pLink->pElse;
+        if (!mist_NodeElsif(pLink->pElse))
+            break;
+    }
+    return (*ppList != pNode);
+}
+
+/**
+********************************************************************************
+* @brief Optimizes a statement: types and folds its expressions and
+*        removes branches and loops that never execute.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  pNode    statement
+* @param[out] ppList   replacing statement list, NULL = statement is removed
+*
+* @retval     TRUE  .. the statement is replaced by *ppList
+* @retval     FALSE .. the statement remains
+*******************************************************************************/
+MLOCAL BOOL Comp_OptStmt(COMPILER * c, MIST_NODE * pNode, MIST_NODE ** ppList)
+{
+    MIST_NODE *pElem;
+    MIST_NODE *pLabel;
+    MIST_REG Sel, Low, High, Cond;
+    UINT32  Cls;
+
+    switch (pNode->Type)
+    {
+        case MIST_N_ASSIGN:
+            if (Comp_Type(c, pNode->pA) && Comp_Type(c, pNode->pB))
+            {
+                Comp_Fold(c, pNode->pA);
+                Comp_Fold(c, pNode->pB);
+            }
+            return (FALSE);
+
+        case MIST_N_IF:
+            return (Comp_OptIf(c, pNode, ppList));
+
+        case MIST_N_CASE:
+            Cls = Comp_Type(c, pNode->pA);
+            if ((Cls != MIST_CLS_INT) && (Cls != MIST_CLS_UINT))
+                return (FALSE);
+            Comp_Fold(c, pNode->pA);
+            for (pElem = pNode->pBody; pElem && !c->Error; pElem = pElem->pNext)
+            {
+                for (pLabel = pElem->pA; pLabel; pLabel = pLabel->pNext)
+                {
+                    if (pLabel->Type == MIST_N_RANGE)
+                    {
+                        if (Comp_Type(c, pLabel->pA) && Comp_Type(c, pLabel->pB))
+                        {
+                            Comp_Fold(c, pLabel->pA);
+                            Comp_Fold(c, pLabel->pB);
+                        }
+                    }
+                    else if (Comp_Type(c, pLabel))
+                        Comp_Fold(c, pLabel);
+                }
+                Comp_OptList(c, &pElem->pBody);
+            }
+            Comp_OptList(c, &pNode->pElse);
+            if (c->Error || !Comp_IsLiteral(pNode->pA))
+                return (FALSE);
+
+            /* Literal selector: the matching element remains */
+            Comp_LitValue(pNode->pA, Cls, &Sel);
+            for (pElem = pNode->pBody; pElem; pElem = pElem->pNext)
+            {
+                for (pLabel = pElem->pA; pLabel; pLabel = pLabel->pNext)
+                {
+                    if (pLabel->Type == MIST_N_RANGE)
+                    {
+                        if (!Comp_IsLiteral(pLabel->pA) || !Comp_IsLiteral(pLabel->pB) ||
+                            !Comp_CanConvert(pLabel->pA->Class, Cls) || !Comp_CanConvert(pLabel->pB->Class, Cls))
+                            return (FALSE);
+                        Comp_LitValue(pLabel->pA, Cls, &Low);
+                        Comp_LitValue(pLabel->pB, Cls, &High);
+                        Comp_FoldOp((Cls == MIST_CLS_UINT) ? MIST_I_GEU : MIST_I_GE, &Sel, &Low, &Cond);
+                        if (Cond.i)
+                            Comp_FoldOp((Cls == MIST_CLS_UINT) ? MIST_I_LEU : MIST_I_LE, &Sel, &High, &Cond);
+                    }
+                    else
+                    {
+                        if (!Comp_IsLiteral(pLabel) || !Comp_CanConvert(pLabel->Class, Cls))
+                            return (FALSE);
+                        Comp_LitValue(pLabel, Cls, &Low);
+                        Comp_FoldOp(MIST_I_EQ, &Sel, &Low, &Cond);
+                    }
+                    if (Cond.i)
+                    {
+                        *ppList = pElem->pBody;
+                        return (TRUE);
+                    }
+                }
+            }
+            *ppList = pNode->pElse;
+            return (TRUE);
+
+        case MIST_N_FOR:
+            Cls = Comp_Type(c, pNode->pA);
+            if ((Cls != MIST_CLS_INT) && (Cls != MIST_CLS_UINT))
+                return (FALSE);
+            if (!Comp_Type(c, pNode->pB) || !Comp_Type(c, pNode->pC) || (pNode->pD && !Comp_Type(c, pNode->pD)))
+                return (FALSE);
+            Comp_Fold(c, pNode->pB);
+            Comp_Fold(c, pNode->pC);
+            if (pNode->pD)
+                Comp_Fold(c, pNode->pD);
+            Comp_OptList(c, &pNode->pBody);
+            return (!c->Error && Comp_OptFor(c, pNode, ppList));
+
+        case MIST_N_WHILE:
+        case MIST_N_REPEAT:
+            if (Comp_Type(c, pNode->pA) == MIST_CLS_BOOL)
+                Comp_Fold(c, pNode->pA);
+            Comp_OptList(c, &pNode->pBody);
+            if (c->Error || (pNode->pA->Type != MIST_N_INT) || (pNode->pA->Class != MIST_CLS_BOOL))
+                return (FALSE);
+
+            /* WHILE FALSE never executes, REPEAT UNTIL TRUE executes once */
+            if ((pNode->Type == MIST_N_WHILE) && !pNode->pA->u.Int)
+            {
+                *ppList = NULL;
+                return (TRUE);
+            }
+            if ((pNode->Type == MIST_N_REPEAT) && pNode->pA->u.Int && Comp_Straight(pNode->pBody, NULL, FALSE))
+            {
+                *ppList = pNode->pBody;
+                return (TRUE);
+            }
+            return (FALSE);
+    }
+    return (FALSE);
+}
+
+/**
+********************************************************************************
+* @brief Optimizes a statement list, statements are replaced in place.
+*
+* @param[in]  c        pointer to compiler state
+* @param[in]  ppStmt   pointer to the first statement of the list
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_OptList(COMPILER * c, MIST_NODE ** ppStmt)
+{
+    MIST_NODE *pStmt;
+    MIST_NODE *pList;
+    MIST_NODE *pNext;
+
+    while ((pStmt = *ppStmt) && !c->Error)
+    {
+        pNext = pStmt->pNext;
+        if (!Comp_OptStmt(c, pStmt, &pList))
+        {
+            ppStmt = &pStmt->pNext;
+            continue;
+        }
+
+        /* The replacing statements are optimized already */
+        *ppStmt = pList;
+        for (; *ppStmt; ppStmt = &(*ppStmt)->pNext)
+            ;
+        *ppStmt = pNext;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Optimizes the syntax tree of a program before the instructions
+*        are generated, see Comp_OptStmt(). Needs the layout of the data
+*        area for the values of constants.
+*
+* @param[in]  c        pointer to compiler state
+* @param[out] N/A
+*
+* @retval     number of nodes removed from the syntax tree
+*******************************************************************************/
+MLOCAL UINT32 Comp_Optimize(COMPILER * c)
+{
+    UINT32  Before = Comp_Count(c->pPou->pBody);
+    UINT32  After;
+
+    Comp_OptList(c, &c->pPou->pBody);
+    After = Comp_Count(c->pPou->pBody);
+    return ((Before > After) ? Before - After : 0);
+}
+
+/**
+********************************************************************************
+* @brief Group of a statement of the program body: its first statement.
+*
+* @param[in]  d        dependency analysis
+* @param[in]  Stmt     index of the statement in the body
+* @param[out] N/A
+*
+* @retval     index of the first statement of the group
+*******************************************************************************/
+MLOCAL UINT32 Comp_DepFind(const COMP_DEP * d, UINT32 Stmt)
+{
+    while (d->pParent[Stmt] != Stmt)
+        Stmt = d->pParent[Stmt];
+    return (Stmt);
+}
+
+/**
+********************************************************************************
+* @brief Dependency analysis of a list of syntax trees, see Comp_DepNode().
+*
+* @param[in]  d        dependency analysis
+* @param[in]  pNode    first node of the list, NULL = empty list
+* @param[in]  Stmt     statement of the body containing the list
+* @param[out] d        updated
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_DepList(COMP_DEP * d, const MIST_NODE * pNode, UINT32 Stmt)
+{
+    for (; pNode; pNode = pNode->pNext)
+        Comp_DepNode(d, pNode, Stmt);
+}
+
+/**
+********************************************************************************
+* @brief Dependency analysis of a syntax tree, in two passes over the body:
+*        with Stmt = COMP_NOTARGET, the assigned variables and RETURN are
+*        recorded. Then the statement is joined with the group of every
+*        other statement using one of the assigned variables. Variables
+*        only being read don't make statements dependent.
+*
+* @param[in]  d        dependency analysis
+* @param[in]  pNode    node, its successors in the list are not analyzed
+* @param[in]  Stmt     statement of the body containing the node, COMP_NOTARGET = first pass
+* @param[out] d        updated
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_DepNode(COMP_DEP * d, const MIST_NODE * pNode, UINT32 Stmt)
+{
+    const MIST_NODE *pTarget;
+    const MIST_NODE *pTail;
+    UINT32  Idx;
+    UINT32  RootA, RootB;
+
+    for (;;)
+    {
+        switch (pNode->Type)
+        {
+            case MIST_N_VAR:
+                Idx = pNode->u.pVar->Index;
+                if ((Stmt == COMP_NOTARGET) || !d->pWritten[Idx])
+                    break;
+                if (d->pOwner[Idx] == COMP_NOTARGET)
+                {
+                    d->pOwner[Idx] = Stmt;
+                    break;
+                }
+                /* The group keeps its first statement as root */
+                RootA = Comp_DepFind(d, d->pOwner[Idx]);
+                RootB = Comp_DepFind(d, Stmt);
+                if (RootA < RootB)
+                    d->pParent[RootB] = RootA;
+                else
+                    d->pParent[RootA] = RootB;
+                break;
+
+            case MIST_N_ASSIGN:
+            case MIST_N_FOR:
+                if (Stmt == COMP_NOTARGET)
+                {
+                    pTarget = (pNode->pA->Type == MIST_N_VAR) ? pNode->pA : pNode->pA->pA;
+                    d->pWritten[pTarget->u.pVar->Index] = TRUE;
+                }
+                break;
+
+            case MIST_N_RETURN:
+                d->Return = TRUE;
+                break;
+        }
+
+        Comp_DepList(d, pNode->pB, Stmt);
+        Comp_DepList(d, pNode->pC, Stmt);
+        Comp_DepList(d, pNode->pD, Stmt);
+        Comp_DepList(d, pNode->pBody, Stmt);
+
+        /* A single first operand or ELSIF continues the loop, chains don't recurse */
+        pTail = pNode->pA;
+        if (pNode->pElse)
+        {
+            Comp_DepList(d, pNode->pA, Stmt);
+            pTail = pNode->pElse;
+        }
+        if (!pTail || pTail->pNext)
+        {
+            Comp_DepList(d, pTail, Stmt);
+            return;
+        }
+        pNode = pTail;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Compiles the program body into independent segments, see file
+*        header. The groups of statements are assigned to the segments in
+*        the order of their first statement. Beyond MIST_VM_MAXSEGS groups,
+*        a group is added to the segment with the fewest syntax tree nodes.
+*        A body with RETURN remains a single segment, as RETURN ends the
+*        whole cycle.
+*
+* @param[in]  c        pointer to compiler state
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_Body(COMPILER * c)
+{
+    COMP_DEP Dep;
+    COMP_DEP *d = &Dep;
+    MIST_NODE *pStmt;
+    UINT32 *pSegOf = NULL;              /* segment of each statement */
+    UINT32 *pNodes = NULL;              /* syntax tree nodes of each group */
+    UINT32  Nodes[MIST_VM_MAXSEGS];
+    UINT32  NbOfStmts = 0;
+    UINT32  NbOfVars = c->pPou->NbOfVars + 1;
+    UINT32  Seg;
+    UINT32  Root;
+    UINT32  i;
+
+    memset(d, 0, sizeof(*d));
+    for (pStmt = c->pPou->pBody; pStmt; pStmt = pStmt->pNext)
+        NbOfStmts++;
+
+    c->NbOfSegs = 1;
+    if (NbOfStmts > 1)
+    {
+        d->pWritten = calloc(NbOfVars, sizeof(UINT8));
+        d->pOwner = malloc(NbOfVars * sizeof(UINT32));
+        d->pParent = malloc(NbOfStmts * sizeof(UINT32));
+        pSegOf = malloc(NbOfStmts * sizeof(UINT32));
+        pNodes = calloc(NbOfStmts, sizeof(UINT32));
+    }
+
+    /* Without memory the body remains a single segment */
+    if (d->pWritten && d->pOwner && d->pParent && pSegOf && pNodes)
+    {
+        for (i = 0; i < NbOfVars; i++)
+            d->pOwner[i] = COMP_NOTARGET;
+        for (i = 0; i < NbOfStmts; i++)
+            d->pParent[i] = i;
+
+        for (pStmt = c->pPou->pBody; pStmt; pStmt = pStmt->pNext)
+            Comp_DepNode(d, pStmt, COMP_NOTARGET);
+        for (pStmt = c->pPou->pBody, i = 0; pStmt && !d->Return; pStmt = pStmt->pNext, i++)
+            Comp_DepNode(d, pStmt, i);
+
+        if (!d->Return)
+        {
+            for (pStmt = c->pPou->pBody, i = 0; pStmt; pStmt = pStmt->pNext, i++)
+            {
+                pNodes[Comp_DepFind(d, i)] += 1 + Comp_Count(pStmt->pA) + Comp_Count(pStmt->pB) +
+                    Comp_Count(pStmt->pC) + Comp_Count(pStmt->pD) + Comp_Count(pStmt->pBody) +
+                    Comp_Count(pStmt->pElse);
+            }
+
+            c->NbOfSegs = 0;
+            for (i = 0; i < NbOfStmts; i++)
+            {
+                Root = Comp_DepFind(d, i);
+                if (Root != i)
+                {
+                    pSegOf[i] = pSegOf[Root];
+                    continue;
+                }
+
+                if (c->NbOfSegs < MIST_VM_MAXSEGS)
+                {
+                    Seg = c->NbOfSegs++;
+                    Nodes[Seg] = 0;
+                }
+                else
+                {
+                    for (Seg = 0, Root = 1; Root < MIST_VM_MAXSEGS; Root++)
+                    {
+                        if (Nodes[Root] < Nodes[Seg])
+                            Seg = Root;
+                    }
+                }
+                Nodes[Seg] += pNodes[i];
+                pSegOf[i] = Seg;
+            }
+        }
+    }
+
+    if (c->NbOfSegs < 2)
+    {
+        c->NbOfSegs = 1;
+        c->Seg[0] = c->NbOfInstr;
+        Comp_StmtList(c, c->pPou->pBody);
+        Comp_Emit(c, MIST_I_END, 0, 0, 0);
+    }
+    else
+    {
+        for (Seg = 0; (Seg < c->NbOfSegs) && !c->Error; Seg++)
+        {
+            c->Seg[Seg] = c->NbOfInstr;
+            for (pStmt = c->pPou->pBody, i = 0; pStmt && !c->Error; pStmt = pStmt->pNext, i++)
+            {
+                if (pSegOf[i] == Seg)
+                    Comp_Stmt(c, pStmt);
+            }
+            Comp_Emit(c, MIST_I_END, 0, 0, 0);
+        }
+    }
+
+    free(d->pWritten);
+    free(d->pOwner);
+    free(d->pParent);
+    free(pSegOf);
+    free(pNodes);
+}
+
+/**
+********************************************************************************
+* @brief Sort order of the variable table of a compiled program.
+*
+* @param[in]  pA, pB   variables
+* @param[out] N/A
+*
+* @retval     < 0, = 0, > 0 .. pA is sorted before, equal to, after pB
+*******************************************************************************/
+MLOCAL int Comp_VarCmp(const VOID * pA, const VOID * pB)
+{
+    return (mist_VmNameCmp(((const MIST_CODE_VAR *) pA)->pName, ((const MIST_CODE_VAR *) pB)->pName));
+}
+
+/**
+********************************************************************************
+* @brief Compares the names of two entries of the SVI registration table,
+*        case sensitive like the SVI, for qsort().
+*
+* @param[in]  pA, pB   entries
+* @param[out] N/A
+*
+* @retval     < 0, = 0, > 0 .. pA is sorted before, equal to, after pB
+*******************************************************************************/
+MLOCAL int Comp_SviCmp(const VOID * pA, const VOID * pB)
+{
+    return (strcmp(((const MIST_CODE_SVI *) pA)->pName, ((const MIST_CODE_SVI *) pB)->pName));
+}
+
+/**
+********************************************************************************
+* @brief Relocates the registers and copies the result into one block:
+*        constants get the first registers, temporaries follow. The
+*        variable table, the SVI registration table and the names are
+*        stored behind the initial values. The SVI table holds all
+*        variables with a lasting value, those with an attribute 'svi'
+*        are marked; mist_SviExport() selects from it by the task setting.
+*
+* @param[in]  c        pointer to compiler state
+* @param[out] N/A
+*
+* @retval     != NULL .. compiled program
+* @retval     = NULL  .. ERROR, error has been recorded
+*******************************************************************************/
+MLOCAL MIST_CODE *Comp_Finish(COMPILER * c)
+{
+    MIST_CODE *pCode;
+    MIST_CODE_VAR *pCv;
+    MIST_CODE_SVI *pCs;
+    MIST_INSTR *pI;
+    MIST_VAR *pVar;
+    UINT8  *pData;
+    CHAR   *pName;
+    UINT32  Head = COMP_ALIGN8(sizeof(MIST_CODE));
+    UINT32  NameSize = 0;
+    UINT32  NbOfSvis = 0;
+    UINT32  Dim;
+    UINT32  i;
+
+    if (c->NbOfConsts + c->MaxTemp > MIST_VM_MAXREGS)
+    {
+        Comp_Error(c, c->pPou->Offset, "program needs too many registers");
+        return (NULL);
+    }
+
+#define COMP_RELOC(r)  (((r) & COMP_CONST) ? ((r) & ~COMP_CONST) : (r) + c->NbOfConsts)
+    for (i = 0, pI = c->pInstr; i < c->NbOfInstr; i++, pI++)
+    {
+        switch (mist_VmFormat[pI->Op])
+        {
+            case MIST_FMT_RRR:
+                pI->C = COMP_RELOC(pI->C);
+                /* no break */
+            case MIST_FMT_RR:
+            case MIST_FMT_RRD:
+            case MIST_FMT_RRF:
+                pI->B = COMP_RELOC(pI->B);
+                /* no break */
+            case MIST_FMT_RT:
+            case MIST_FMT_RM:
+            case MIST_FMT_RK:
+                pI->A = COMP_RELOC(pI->A);
+                break;
+        }
+    }
+    for (i = 0; i < c->NbOfVops; i++)
+    {
+        if (c->pVop[i].Op == MIST_V_SPLAT)
+            c->pVop[i].Arg = COMP_RELOC(c->pVop[i].Arg);
+    }
+#undef COMP_RELOC
+
+    for (pVar = c->pPou->pVars; pVar; pVar = pVar->pNext)
+    {
+        NameSize += strlen(pVar->pName) + 1;
+        if ((pVar->Class != MIST_KW_VAR_TEMP) && !(pVar->Flags & MIST_VF_SVI_NONE))
+            NbOfSvis++;
+    }
+
+    pCode = malloc(Head + c->NbOfConsts * sizeof(MIST_REG) + c->NbOfInstr * sizeof(MIST_INSTR) +
+                   c->NbOfDescs * sizeof(MIST_VM_DESC) + c->NbOfBlocks * sizeof(MIST_VM_BLOCK) +
+                   c->NbOfVops * sizeof(MIST_VM_VOP) + c->MemSize +
+                   c->pPou->NbOfVars * sizeof(MIST_CODE_VAR) + NbOfSvis * sizeof(MIST_CODE_SVI) +
+                   c->NbOfSegs * sizeof(UINT32) + NameSize);
+    if (!pCode)
+    {
+        Comp_Error(c, c->pPou->Offset, "out of memory");
+        return (NULL);
+    }
+
+    snprintf(pCode->Name, sizeof(pCode->Name), "%s", c->pPou->pName);
+    pData = (UINT8 *) pCode + Head;
+
+    pCode->pConst = (MIST_REG *) pData;
+    pCode->NbOfConsts = c->NbOfConsts;
+    memcpy(pData, c->pConst, c->NbOfConsts * sizeof(MIST_REG));
+    pData += c->NbOfConsts * sizeof(MIST_REG);
+
+    pCode->pInstr = (MIST_INSTR *) pData;
+    pCode->NbOfInstr = c->NbOfInstr;
+    memcpy(pData, c->pInstr, c->NbOfInstr * sizeof(MIST_INSTR));
+    pData += c->NbOfInstr * sizeof(MIST_INSTR);
+
+    pCode->pDesc = (MIST_VM_DESC *) pData;
+    pCode->NbOfDescs = c->NbOfDescs;
+    memcpy(pData, c->pDesc, c->NbOfDescs * sizeof(MIST_VM_DESC));
+    pData += c->NbOfDescs * sizeof(MIST_VM_DESC);
+
+    pCode->pBlock = (MIST_VM_BLOCK *) pData;
+    pCode->NbOfBlocks = c->NbOfBlocks;
+    memcpy(pData, c->pBlock, c->NbOfBlocks * sizeof(MIST_VM_BLOCK));
+    pData += c->NbOfBlocks * sizeof(MIST_VM_BLOCK);
+
+    pCode->pVop = (MIST_VM_VOP *) pData;
+    pCode->NbOfVops = c->NbOfVops;
+    memcpy(pData, c->pVop, c->NbOfVops * sizeof(MIST_VM_VOP));
+    pData += c->NbOfVops * sizeof(MIST_VM_VOP);
+
+    pCode->pInit = pData;
+    pCode->MemSize = c->MemSize;
+    memcpy(pData, c->pInit, c->MemSize);
+    pData += c->MemSize;
+
+    pCode->pVar = (MIST_CODE_VAR *) pData;
+    pCode->NbOfVars = c->pPou->NbOfVars;
+    pData += c->pPou->NbOfVars * sizeof(MIST_CODE_VAR);
+
+    pCode->pSvi = (MIST_CODE_SVI *) pData;
+    pCode->NbOfSvis = NbOfSvis;
+    pData += NbOfSvis * sizeof(MIST_CODE_SVI);
+
+    pCode->pSeg = (UINT32 *) pData;
+    pCode->NbOfSegs = c->NbOfSegs;
+    memcpy(pData, c->Seg, c->NbOfSegs * sizeof(UINT32));
+    pData += c->NbOfSegs * sizeof(UINT32);
+
+    pName = (CHAR *) pData;
+    pCs = pCode->pSvi;
+    for (pVar = c->pPou->pVars, pCv = pCode->pVar; pVar; pVar = pVar->pNext, pCv++)
+    {
+        strcpy(pName, pVar->pName);
+        pCv->pName = pName;
+        pName += strlen(pName) + 1;
+        pCv->Type = pVar->Type;
+        pCv->Class = pVar->Class;
+        pCv->Flags = pVar->Flags;
+        pCv->NbOfDims = pVar->NbOfDims;
+        memcpy(pCv->Lower, pVar->Lower, sizeof(pCv->Lower));
+        memcpy(pCv->Upper, pVar->Upper, sizeof(pCv->Upper));
+        pCv->MemOffset = pVar->MemOffset;
+        pCv->ElemSize = pVar->ElemSize;
+
+        if ((pVar->Class == MIST_KW_VAR_TEMP) || (pVar->Flags & MIST_VF_SVI_NONE))
+            continue;
+        pCs->pName = pCv->pName;
+        pCs->Format = CompType[pVar->Type].Svi | ((pVar->Flags & MIST_VF_SVI_RW) ? SVI_F_INOUT : SVI_F_OUT);
+        pCs->Size = pVar->ElemSize;
+        for (Dim = 0; Dim < pVar->NbOfDims; Dim++)
+            pCs->Size *= (UINT32) (pVar->Upper[Dim] - pVar->Lower[Dim] + 1);
+        pCs->MemOffset = pVar->MemOffset;
+        pCs->Flags = pVar->Flags & (MIST_VF_SVI_R | MIST_VF_SVI_RW);
+        pCs++;
+    }
+    qsort(pCode->pVar, pCode->NbOfVars, sizeof(MIST_CODE_VAR), Comp_VarCmp);
+    qsort(pCode->pSvi, pCode->NbOfSvis, sizeof(MIST_CODE_SVI), Comp_SviCmp);
+
+    pCode->NbOfRegs = c->NbOfConsts + c->MaxTemp;
+    pCode->TempOffset = c->TempOffset;
+    pCode->TempSize = c->MemSize - c->TempOffset;
+    pCode->SrcHash = mist_SrcHash(c->pSrc + c->pPou->Offset, c->pPou->Length);
+    pCode->NbOfOptNodes = c->NbOfOptNodes;
+    return (pCode);
+}
+
+/**
+********************************************************************************
+* @brief Compiles a program to bytecode.
+*        Sets MemOffset and ElemSize of all variables and the class of all
+*        expression nodes. The syntax tree is optimized in place, constant
+*        expressions become literals and dead branches are removed.
+*        Errors are recorded in the compilation unit.
+*
+* @param[in]  pUnit    compilation unit holding the program
+* @param[in]  pPou     program to be compiled
+* @param[in]  pSrc     source buffer the unit has been parsed from
+* @param[out] ppCode   compiled program, release with mist_CodeFree()
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, see pUnit->ErrLine and pUnit->ErrText
+*******************************************************************************/
+SINT32 mist_Compile(MIST_UNIT * pUnit, MIST_POU * pPou, const CHAR * pSrc, MIST_CODE ** ppCode)
+{
+    COMPILER Comp;
+    COMPILER *c = &Comp;
+
+    memset(c, 0, sizeof(*c));
+    c->pUnit = pUnit;
+    c->pPou = pPou;
+    c->pSrc = pSrc;
+    *ppCode = NULL;
+
+    Comp_Layout(c);
+    if (!c->Error)
+        c->NbOfOptNodes = Comp_Optimize(c);
+    if (!c->Error)
+        Comp_Body(c);
+    if (!c->Error)
+        *ppCode = Comp_Finish(c);
+
+    free(c->pInstr);
+    free(c->pConst);
+    free(c->pDesc);
+    free(c->pBlock);
+    free(c->pVop);
+    free(c->pVarDesc);
+    free(c->pInit);
+    return (*ppCode ? OK : ERROR);
+}
+
+/**
+********************************************************************************
+* @brief Releases a compiled program.
+*
+* @param[in]  pCode    compiled program, NULL is ignored
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_CodeFree(MIST_CODE * pCode)
+{
+    if (pCode)
+        free(pCode);
+}
+
+/**
+********************************************************************************
+* @brief Reads an ST source file and compiles its first program.
+*        Errors are logged with file name and line.
+*
+* @param[in]  pFileName  ST source file
+* @param[out] ppCode     compiled program, release with mist_CodeFree()
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_PrgLoad(const CHAR * pFileName, MIST_CODE ** ppCode)
+{
+    MIST_SOURCE Src;
+    MIST_UNIT Unit;
+    SINT32  Ret;
+    CHAR    Func[] = "mist_PrgLoad";
+
+    *ppCode = NULL;
+    if (mist_SrcLoad(&Src, pFileName) < 0)
+        return (ERROR);
+
+    Ret = mist_Parse(&Unit, Src.pBuf, Src.Length);
+    if ((Ret == OK) && !Unit.pPous)
+    {
+        LOG_E(0, Func, "%s: no PROGRAM found", pFileName);
+        Ret = ERROR;
+    }
+    else
+    {
+        if (Ret == OK)
+            Ret = mist_Compile(&Unit, Unit.pPous, Src.pBuf, ppCode);
+        if (Ret < 0)
+            LOG_E(0, Func, "%s:%u: %s", pFileName, Unit.ErrLine, Unit.ErrText);
+    }
+
+    mist_UnitFree(&Unit);
+    mist_SrcFree(&Src);
+    return (Ret);
+}
+
+/**
+********************************************************************************
+* @brief Looks up a POU of a source in the program cache. A POU whose text
+*        is not cached yet is parsed, with Compile it is compiled as well.
+*        Errors are logged with file name and line.
+*
+* @param[in]  pSrc         source file
+* @param[in]  Start, End   text of the POU, see mist_LexPou()
+* @param[in]  Compile      TRUE = the compiled program is needed
+* @param[out] pNbOfBuilt   incremented if the POU had to be parsed
+*
+* @retval     != NULL .. cached POU
+* @retval     = NULL  .. ERROR
+*******************************************************************************/
+MLOCAL COMP_POU *Comp_CachePou(const MIST_SOURCE * pSrc, UINT32 Start, UINT32 End, BOOL Compile, UINT32 * pNbOfBuilt)
+{
+    const CHAR *pText = pSrc->pBuf + Start;
+    UINT32  Length = End - Start;
+    UINT32  Hash = mist_SrcHash(pText, Length);
+    MIST_UNIT Unit;
+    MIST_CODE *pCode = NULL;
+    COMP_POU *pPou;
+    SINT32  Ret;
+    CHAR    Func[] = "mist_PrgCacheLoad";
+
+    /* The hash only preselects, the text decides */
+    for (pPou = CompPous; pPou; pPou = pPou->pNext)
+    {
+        if ((pPou->Hash == Hash) && (pPou->Length == Length) && !memcmp(pPou->pText, pText, Length))
+            break;
+    }
+    if (pPou && (pPou->pCode || !Compile))
+    {
+        pPou->Gen = CompGen;
+        return (pPou);
+    }
+
+    /* New text, or a POU which has only been parsed so far */
+    Ret = mist_Parse(&Unit, pText, Length);
+    if ((Ret == OK) && Compile)
+        Ret = mist_Compile(&Unit, Unit.pPous, pText, &pCode);
+    if (Ret < 0)
+    {
+        LOG_E(0, Func, "%s:%u: %s", pSrc->FileName, mist_LexLine(pSrc->pBuf, Start) + Unit.ErrLine - 1, Unit.ErrText);
+        mist_UnitFree(&Unit);
+        return (NULL);
+    }
+    (*pNbOfBuilt)++;
+
+    if (!pPou)
+    {
+        pPou = malloc(sizeof(COMP_POU) + Length + strlen(Unit.pPous->pName) + 1);
+        if (!pPou)
+        {
+            LOG_E(0, Func, "No memory for program '%s'!", Unit.pPous->pName);
+            mist_CodeFree(pCode);
+            mist_UnitFree(&Unit);
+            return (NULL);
+        }
+        memset(pPou, 0, sizeof(COMP_POU));
+        pPou->Hash = Hash;
+        pPou->Length = Length;
+        pPou->pText = (CHAR *) (pPou + 1);
+        memcpy(pPou->pText, pText, Length);
+        pPou->pName = pPou->pText + Length;
+        strcpy(pPou->pName, Unit.pPous->pName);
+        pPou->pNext = CompPous;
+        CompPous = pPou;
+    }
+    if (pCode)
+        pPou->pCode = pCode;
+    pPou->Gen = CompGen;
+    mist_UnitFree(&Unit);
+    return (pPou);
+}
+
+/**
+********************************************************************************
+* @brief Reads an ST source file and returns its first program compiled,
+*        like mist_PrgLoad(), but through the program cache: an unchanged
+*        file is neither lexed nor parsed, in a changed file only the POUs
+*        with a new text are parsed, and only the first one is compiled.
+*        Like in Comp_CachePou() the hash only preselects, the text decides.
+*        So the time of a configuration reload depends on the size of the
+*        change. The program is shared, release it with
+*        mist_PrgCacheRelease() instead of mist_CodeFree().
+*
+* @param[in]  pFileName  ST source file
+* @param[out] ppCode     compiled program
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_PrgCacheLoad(const CHAR * pFileName, MIST_CODE ** ppCode)
+{
+    MIST_SOURCE Src;
+    COMP_FILE *pFile, **ppFile;
+    COMP_POU *pPou;
+    COMP_POU **ppPous = NULL, **ppTmp;
+    UINT32  NbOfPous = 0, MaxPous = 0, NbOfBuilt = 0;
+    UINT32  Hash, Start, End, Offset;
+    UINT32  Time = m_GetProcTime();
+    UINT32  i;
+    SINT32  Ret = OK;
+    CHAR    Func[] = "mist_PrgCacheLoad";
+
+    *ppCode = NULL;
+    if (mist_SrcLoad(&Src, pFileName) < 0)
+        return (ERROR);
+
+    Hash = mist_SrcHash(Src.pBuf, Src.Length);
+    for (ppFile = &CompFiles; *ppFile; ppFile = &(*ppFile)->pNext)
+    {
+        if (!strcmp((*ppFile)->pName, pFileName))
+            break;
+    }
+    pFile = *ppFile;
+
+    if (!pFile || (pFile->Hash != Hash) || (pFile->Length != Src.Length) ||
+        memcmp(pFile->pText, Src.pBuf, Src.Length))
+    {
+        /* Split into POUs, the first one is executed and needs to be compiled */
+        for (Offset = 0; (Ret == OK) && mist_LexPou(Src.pBuf, Src.Length, Offset, &Start, &End); Offset = End)
+        {
+            if (NbOfPous == MaxPous)
+            {
+                MaxPous = MaxPous ? 2 * MaxPous : 16;
+                ppTmp = realloc(ppPous, MaxPous * sizeof(COMP_POU *));
+                if (!ppTmp)
+                {
+                    LOG_E(0, Func, "No memory for file '%s'!", pFileName);
+                    Ret = ERROR;
+                    break;
+                }
+                ppPous = ppTmp;
+            }
+
+            pPou = Comp_CachePou(&Src, Start, End, !NbOfPous, &NbOfBuilt);
+            if (!pPou)
+            {
+                Ret = ERROR;
+                break;
+            }
+
+            /* Names of POUs are unique within the file */
+            for (i = 0; i < NbOfPous; i++)
+            {
+                if (Comp_SameName(pPou->pName, strlen(pPou->pName), ppPous[i]->pName))
+                {
+                    LOG_E(0, Func, "%s:%u: program '%s' is already defined", pFileName,
+                          mist_LexLine(Src.pBuf, Start), pPou->pName);
+                    Ret = ERROR;
+                }
+            }
+            ppPous[NbOfPous++] = pPou;
+        }
+
+        if ((Ret == OK) && !NbOfPous)
+        {
+            LOG_E(0, Func, "%s: no PROGRAM found", pFileName);
+            Ret = ERROR;
+        }
+
+        /* The file entry is replaced */
+        if (Ret == OK)
+        {
+            pFile = malloc(sizeof(COMP_FILE) + NbOfPous * sizeof(COMP_POU *) + Src.Length + strlen(pFileName) + 1);
+            if (!pFile)
+            {
+                LOG_E(0, Func, "No memory for file '%s'!", pFileName);
+                Ret = ERROR;
+            }
+        }
+        if (Ret == OK)
+        {
+            pFile->Hash = Hash;
+            pFile->Length = Src.Length;
+            pFile->NbOfPous = NbOfPous;
+            pFile->ppPous = (COMP_POU **) (pFile + 1);
+            memcpy(pFile->ppPous, ppPous, NbOfPous * sizeof(COMP_POU *));
+            pFile->pText = (CHAR *) (pFile->ppPous + NbOfPous);
+            memcpy(pFile->pText, Src.pBuf, Src.Length);
+            pFile->pName = pFile->pText + Src.Length;
+            strcpy(pFile->pName, pFileName);
+            pFile->pNext = *ppFile ? (*ppFile)->pNext : NULL;
+            free(*ppFile);
+            *ppFile = pFile;
+        }
+        free(ppPous);
+    }
+
+    if (Ret == OK)
+    {
+        pFile->Gen = CompGen;
+        for (i = 0; i < pFile->NbOfPous; i++)
+            pFile->ppPous[i]->Gen = CompGen;
+
+        pPou = pFile->ppPous[0];
+        pPou->RefCount++;
+        *ppCode = pPou->pCode;
+        LOG_I(0, Func, "%s: %u POUs, %u parsed, program '%s' %s in %u us", pFileName, pFile->NbOfPous, NbOfBuilt,
+              pPou->pName, NbOfBuilt ? "loaded" : "unchanged", m_GetProcTime() - Time);
+    }
+
+    mist_SrcFree(&Src);
+    return (Ret);
+}
+
+/**
+********************************************************************************
+* @brief Releases a program returned by mist_PrgCacheLoad(). The program
+*        stays in the cache until mist_PrgCachePurge() finds it unused.
+*
+* @param[in]  pCode    compiled program, NULL is ignored
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_PrgCacheRelease(MIST_CODE * pCode)
+{
+    COMP_POU *pPou;
+
+    for (pPou = CompPous; pPou && pCode; pPou = pPou->pNext)
+    {
+        if ((pPou->pCode == pCode) && pPou->RefCount)
+        {
+            pPou->RefCount--;
+            break;
+        }
+    }
+}
+
+/**
+********************************************************************************
+* @brief Removes the files and POUs from the program cache which have not
+*        been loaded since the previous call, e.g. after all tasks have
+*        loaded their programs. Programs still in use are kept.
+*
+* @param[in]  All      TRUE = remove all unused entries, e.g. at module deinit
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_PrgCachePurge(BOOL All)
+{
+    COMP_FILE *pFile, **ppFile;
+    COMP_POU *pPou, **ppPou;
+
+    for (ppFile = &CompFiles; (pFile = *ppFile) != NULL;)
+    {
+        if (All || (pFile->Gen != CompGen))
+        {
+            *ppFile = pFile->pNext;
+            free(pFile);
+        }
+        else
+            ppFile = &pFile->pNext;
+    }
+
+    for (ppPou = &CompPous; (pPou = *ppPou) != NULL;)
+    {
+        if (!pPou->RefCount && (All || (pPou->Gen != CompGen)))
+        {
+            *ppPou = pPou->pNext;
+            mist_CodeFree(pPou->pCode);
+            free(pPou);
+        }
+        else
+            ppPou = &pPou->pNext;
+    }
+    CompGen++;
+}
+
+/**
+********************************************************************************
+* @brief Prints the contents of the program cache, to be called from the
+*        shell.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+*******************************************************************************/
+SINT32 mist_PrgCacheShow(VOID)
+{
+    const COMP_FILE *pFile;
+    const COMP_POU *pPou;
+
+    printf("Generation %u\n", CompGen);
+    for (pFile = CompFiles; pFile; pFile = pFile->pNext)
+        printf("  file %s: %u bytes, hash 0x%08X, %u POUs, generation %u\n", pFile->pName, pFile->Length,
+               pFile->Hash, pFile->NbOfPous, pFile->Gen);
+    for (pPou = CompPous; pPou; pPou = pPou->pNext)
+        printf("  program %s: %u bytes, hash 0x%08X, %s, %u users, generation %u\n", pPou->pName, pPou->Length,
+               pPou->Hash, pPou->pCode ? "compiled" : "parsed", pPou->RefCount, pPou->Gen);
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Generates the source of a program of mist_PrgDepthTest().
+*
+* @param[in]  Shape    COMP_TEST_xxx
+* @param[in]  N        size of the shape
+* @param[out] N/A
+*
+* @retval     != NULL .. source text, release with free()
+* @retval     = NULL  .. no memory
+*******************************************************************************/
+MLOCAL CHAR *Comp_TestSrc(UINT32 Shape, UINT32 N)
+{
+    UINT32  Size = 128 + N * 48;
+    UINT32  Len;
+    UINT32  i;
+    CHAR   *pSrc = malloc(Size);
+
+    if (!pSrc)
+        return (NULL);
+
+    Len = sprintf(pSrc, "PROGRAM DepthTest\nVAR x : DINT; y : DINT; END_VAR\n");
+    switch (Shape)
+    {
+        case COMP_TEST_ELSIF:
+            Len += sprintf(pSrc + Len, "IF x = 0 THEN y := 0;\n");
+            for (i = 1; i < N; i++)
+                Len += sprintf(pSrc + Len, "ELSIF x = %u THEN y := %u;\n", i, i * 3);
+            Len += sprintf(pSrc + Len, "ELSE y := -1;\nEND_IF;\n");
+            break;
+
+        case COMP_TEST_SUM:
+            Len += sprintf(pSrc + Len, "y := x");
+            for (i = 1; i < N; i++)
+            {
+                if (i % 3)
+                    Len += sprintf(pSrc + Len, " + x");
+                else
+                    Len += sprintf(pSrc + Len, " - y * %u", i);
+            }
+            Len += sprintf(pSrc + Len, ";\n");
+            break;
+
+        case COMP_TEST_IF:
+            for (i = 0; i < N; i++)
+                Len += sprintf(pSrc + Len, "IF x > %u THEN\n", i);
+            Len += sprintf(pSrc + Len, "y := y + 1;\n");
+            for (i = 0; i < N; i++)
+                Len += sprintf(pSrc + Len, "END_IF;\n");
+            break;
+
+        default:
+            Len += sprintf(pSrc + Len, "y := ");
+            for (i = 0; i < N; i++)
+                Len += sprintf(pSrc + Len, "ABS(");
+            Len += sprintf(pSrc + Len, "x");
+            for (i = 0; i < N; i++)
+                Len += sprintf(pSrc + Len, ")");
+            Len += sprintf(pSrc + Len, ";\n");
+            break;
+    }
+    sprintf(pSrc + Len, "END_PROGRAM\n");
+    return (pSrc);
+}
+
+/**
+********************************************************************************
+* @brief Task of mist_PrgDepthTest(): parses and compiles one program and
+*        records its max. stack usage.
+*
+* @param[in]  t        program
+* @param[out] t        result
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Comp_TestMain(COMP_TEST * t)
+{
+    MIST_UNIT Unit;
+    MIST_CODE *pCode = NULL;
+    TASK_DESC Desc;
+
+    t->Ret = mist_Parse(&Unit, t->pSrc, strlen(t->pSrc));
+    if (t->Ret == OK)
+        t->Ret = mist_Compile(&Unit, Unit.pPous, t->pSrc, &pCode);
+    if (t->Ret < 0)
+        snprintf(t->ErrText, sizeof(t->ErrText), "line %u: %s", Unit.ErrLine, Unit.ErrText);
+    mist_CodeFree(pCode);
+    mist_UnitFree(&Unit);
+
+    if (taskInfoGet(taskIdSelf(), &Desc) == OK)
+        t->StackHigh = Desc.td_stackHigh;
+    semGive(t->DoneSema);
+}
+
+/**
+********************************************************************************
+* @brief Test function: compiles long chains of ELSIF and operators and the
+*        deepest nesting accepted by the parser in a task with the stack of
+*        the SMI server tasks, to be called from the shell. A task which
+*        overflows its stack doesn't finish and the case fails.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     = 0 .. OK, all programs compiled
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_PrgDepthTest(VOID)
+{
+    MLOCAL const struct
+    {
+        const CHAR *pName;              /* description */
+        UINT32  Shape;                  /* COMP_TEST_xxx */
+        UINT32  N;                      /* size */
+    } Cases[] = {
+        {"IF with 50 branches", COMP_TEST_ELSIF, 50},
+        {"sum of 100 terms", COMP_TEST_SUM, 100},
+        {"IF with 1000 branches", COMP_TEST_ELSIF, 1000},
+        {"sum of 1000 terms", COMP_TEST_SUM, 1000},
+        {"14 nested IF", COMP_TEST_IF, 14},
+        {"29 nested calls", COMP_TEST_CALL, 29}
+    };
+    COMP_TEST Test;
+    SINT32  TaskId;
+    int     Priority;
+    UINT32  NbOfFailed = 0;
+    UINT32  i;
+    CHAR    Func[] = "mist_PrgDepthTest";
+
+    taskPriorityGet(taskIdSelf(), &Priority);
+    for (i = 0; i < sizeof(Cases) / sizeof(Cases[0]); i++)
+    {
+        memset(&Test, 0, sizeof(Test));
+        Test.Ret = ERROR;
+        Test.pSrc = Comp_TestSrc(Cases[i].Shape, Cases[i].N);
+        Test.DoneSema = semBCreate(SEM_Q_PRIORITY, SEM_EMPTY);
+        if (!Test.pSrc || !Test.DoneSema)
+        {
+            LOG_E(0, Func, "No memory for the test!");
+            free(Test.pSrc);
+            if (Test.DoneSema)
+                semDelete(Test.DoneSema);
+            return (ERROR);
+        }
+
+        TaskId = sys_TaskSpawn(mist_AppName, "aMIST_Depth", Priority, VX_FP_TASK, COMP_TEST_STACK,
+                               (FUNCPTR) Comp_TestMain, &Test);
+        if (TaskId == ERROR)
+        {
+            LOG_E(0, Func, "Error in sys_TaskSpawn for the test task!");
+            free(Test.pSrc);
+            semDelete(Test.DoneSema);
+            return (ERROR);
+        }
+
+        /* A crashed task never gives the semaphore, it keeps using the test data */
+        if (semTake(Test.DoneSema, 10 * sysClkRateGet()) < 0)
+        {
+            printf("%-24s FAILED, the task did not finish\n", Cases[i].pName);
+            return (ERROR);
+        }
+        if (Test.Ret < 0)
+        {
+            printf("%-24s FAILED, %s\n", Cases[i].pName, Test.ErrText);
+            NbOfFailed++;
+        }
+        else
+            printf("%-24s ok, %u of %u bytes stack\n", Cases[i].pName, Test.StackHigh, COMP_TEST_STACK);
+        free(Test.pSrc);
+        semDelete(Test.DoneSema);
+    }
+
+    printf("%u of %u cases failed\n", NbOfFailed, (UINT32) (sizeof(Cases) / sizeof(Cases[0])));
+    return (NbOfFailed ? ERROR : OK);
+}
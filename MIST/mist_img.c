@@ -0,0 +1,526 @@
+/**
+********************************************************************************
+* @file     mist_img.c
+* @author   Bachmann electronic GmbH
+* @version  $Revision: 3.90 $ $LastChangedBy: BE $
+* @date     $LastChangeDate: 2013-06-10 11:00:00 $
+*
+* @brief    This file contains the process image of an ST program: the
+*           VAR_INPUT and VAR_OUTPUT variables of its data area, exchanged
+*           with other tasks as consistent snapshots.
+*
+*           The program task copies the latest input snapshot into the data
+*           area at cycle start (mist_ImgInputs()) and publishes its outputs
+*           at cycle end (mist_ImgOutputs()). Each direction has two buffers.
+*           A writer fills the buffer which is not published, then switches
+*           Front to it. Seq of a buffer is odd while it is being written, a
+*           reader copies the front buffer and repeats when Seq has changed
+*           meanwhile. So readers never see values of different cycles or
+*           half written multi-word values, and the program task neither
+*           waits for a reader nor takes a lock.
+*
+*           Other tasks write inputs with mist_ImgWrite(): the front buffer
+*           is copied to the other one, the variable is changed and the
+*           buffer is published. WriteSema serializes these writers only.
+*
+*           The image belongs to a program instance (MIST_VM.pImg). After an
+*           online change the new instance has its own image, loaded from
+*           the data area taken over. Inputs written to the old image while
+*           the task switches are lost.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <semLib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+
+/* Project includes */
+#include "mist_int.h"
+#include "mist_prg.h"
+#include "mist_vm.h"
+
+/* Functions: system global, see mist_vm.h */
+SINT32  mist_ImgCreate(const MIST_CODE * pCode, MIST_IMAGE ** ppImg);
+VOID    mist_ImgDelete(MIST_IMAGE * pImg);
+VOID    mist_ImgLoad(MIST_IMAGE * pImg, const UINT8 * pMem, UINT32 Cycle);
+VOID    mist_ImgInputs(MIST_IMAGE * pImg, UINT8 * pMem);
+VOID    mist_ImgOutputs(MIST_IMAGE * pImg, const UINT8 * pMem, UINT32 Cycle);
+SINT32  mist_ImgRead(MIST_IMAGE * pImg, const CHAR * pName, VOID * pBuf, UINT32 Size, UINT32 * pCycle);
+SINT32  mist_ImgWrite(MIST_IMAGE * pImg, const CHAR * pName, const VOID * pData, UINT32 Size);
+
+/* Functions: local */
+MLOCAL UINT32 Img_VarSize(const MIST_CODE_VAR * pVar);
+MLOCAL UINT32 Img_Ranges(const MIST_CODE * pCode, UINT32 Class, MIST_IMG_RANGE * pRange, UINT32 * pSize);
+MLOCAL SINT32 Img_RangeCmp(const void *pA, const void *pB);
+MLOCAL const MIST_CODE_VAR *Img_VarFind(const MIST_CODE * pCode, const CHAR * pName);
+MLOCAL MIST_IMG_SIDE *Img_VarSide(MIST_IMAGE * pImg, const MIST_CODE_VAR * pVar, UINT32 * pImgOffset);
+MLOCAL VOID Img_Publish(MIST_IMG_SIDE * pSide, const UINT8 * pMem, UINT32 Cycle);
+MLOCAL UINT32 Img_Fetch(MIST_IMAGE * pImg, MIST_IMG_SIDE * pSide, UINT8 * pMem, UINT32 ImgOffset,
+                        UINT8 * pBuf, UINT32 Size);
+
+/**
+********************************************************************************
+* @brief Creates the process image of a program. Programs without
+*        VAR_INPUT and VAR_OUTPUT variables get no image.
+*        Ranges and buffers are allocated in one block.
+*
+* @param[in]  pCode    compiled program, must stay valid as long as the image exists
+* @param[out] ppImg    image, NULL = no inputs and outputs
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, out of memory
+*******************************************************************************/
+SINT32 mist_ImgCreate(const MIST_CODE * pCode, MIST_IMAGE ** ppImg)
+{
+    MIST_IMAGE *pImg;
+    UINT8  *pData;
+    UINT32  NbOfIn;
+    UINT32  NbOfOut;
+    UINT32  InSize;
+    UINT32  OutSize;
+    UINT32  RangeSize;
+    CHAR    Func[] = "mist_ImgCreate";
+
+    *ppImg = NULL;
+    NbOfIn = Img_Ranges(pCode, MIST_KW_VAR_INPUT, NULL, &InSize);
+    NbOfOut = Img_Ranges(pCode, MIST_KW_VAR_OUTPUT, NULL, &OutSize);
+    if (!NbOfIn && !NbOfOut)
+        return (OK);
+
+    /* Buffers 8 byte aligned, like the data area */
+    InSize = (InSize + 7) & ~7;
+    OutSize = (OutSize + 7) & ~7;
+    RangeSize = ((NbOfIn + NbOfOut) * sizeof(MIST_IMG_RANGE) + 7) & ~7;
+    pImg = calloc(1, ((sizeof(MIST_IMAGE) + 7) & ~7) + RangeSize + 2 * InSize + 2 * OutSize);
+    if (!pImg)
+    {
+        LOG_E(0, Func, "No memory for the process image of program '%s'!", pCode->Name);
+        return (ERROR);
+    }
+
+    pImg->pCode = pCode;
+    pData = (UINT8 *) pImg + ((sizeof(MIST_IMAGE) + 7) & ~7);
+    pImg->In.pRange = (MIST_IMG_RANGE *) pData;
+    pImg->Out.pRange = pImg->In.pRange + NbOfIn;
+    pData += RangeSize;
+    pImg->In.NbOfRanges = Img_Ranges(pCode, MIST_KW_VAR_INPUT, pImg->In.pRange, &pImg->In.Size);
+    pImg->Out.NbOfRanges = Img_Ranges(pCode, MIST_KW_VAR_OUTPUT, pImg->Out.pRange, &pImg->Out.Size);
+    pImg->In.Buf[0].pData = pData;
+    pImg->In.Buf[1].pData = pData + InSize;
+    pImg->Out.Buf[0].pData = pData + 2 * InSize;
+    pImg->Out.Buf[1].pData = pData + 2 * InSize + OutSize;
+
+    pImg->WriteSema = semMCreate(SEM_Q_PRIORITY | SEM_INVERSION_SAFE);
+    if (!pImg->WriteSema)
+    {
+        LOG_E(0, Func, "Could not create the write semaphore of program '%s'!", pCode->Name);
+        free(pImg);
+        return (ERROR);
+    }
+
+    *ppImg = pImg;
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Releases a process image. No other task may access it any more.
+*
+* @param[in]  pImg     image, NULL is ignored
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_ImgDelete(MIST_IMAGE * pImg)
+{
+    if (pImg)
+    {
+        semDelete(pImg->WriteSema);
+        free(pImg);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Publishes inputs and outputs from the data area, after the
+*        variables have been set by a reset or an online change.
+*        Called by the task owning the program or before it runs.
+*
+* @param[in]  pImg     image
+* @param[in]  pMem     data area of the program
+* @param[in]  Cycle    cycle of the program
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_ImgLoad(MIST_IMAGE * pImg, const UINT8 * pMem, UINT32 Cycle)
+{
+    semTake(pImg->WriteSema, WAIT_FOREVER);
+    Img_Publish(&pImg->In, pMem, pImg->In.Buf[pImg->In.Front].Cycle);
+    semGive(pImg->WriteSema);
+
+    Img_Publish(&pImg->Out, pMem, Cycle);
+}
+
+/**
+********************************************************************************
+* @brief Copies the latest input snapshot into the data area, at the start
+*        of a cycle. Takes no lock.
+*
+* @param[in]  pImg     image
+* @param[in]  pMem     data area of the program
+* @param[out] pMem     VAR_INPUT variables set
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_ImgInputs(MIST_IMAGE * pImg, UINT8 * pMem)
+{
+    if (pImg->In.NbOfRanges)
+        Img_Fetch(pImg, &pImg->In, pMem, 0, NULL, 0);
+}
+
+/**
+********************************************************************************
+* @brief Publishes the outputs of the data area as one snapshot, at the end
+*        of a cycle. Takes no lock and does not wait for readers.
+*
+* @param[in]  pImg     image
+* @param[in]  pMem     data area of the program
+* @param[in]  Cycle    cycle of the program
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_ImgOutputs(MIST_IMAGE * pImg, const UINT8 * pMem, UINT32 Cycle)
+{
+    if (pImg->Out.NbOfRanges)
+        Img_Publish(&pImg->Out, pMem, Cycle);
+}
+
+/**
+********************************************************************************
+* @brief Reads a variable of the process image, any task. Outputs are read
+*        from the snapshot of the last cycle, inputs as written last.
+*
+* @param[in]  pImg     image
+* @param[in]  pName    variable name, case insensitive
+* @param[out] pBuf     value of the variable
+* @param[in]  Size     size of pBuf, at least the size of the variable
+* @param[out] pCycle   outputs: cycle of the value, inputs: number of writes; may be NULL
+*
+* @retval     > 0 .. size of the variable in bytes
+* @retval     < 0 .. ERROR, no variable of the image or buffer too small
+*******************************************************************************/
+SINT32 mist_ImgRead(MIST_IMAGE * pImg, const CHAR * pName, VOID * pBuf, UINT32 Size, UINT32 * pCycle)
+{
+    const MIST_CODE_VAR *pVar = Img_VarFind(pImg->pCode, pName);
+    MIST_IMG_SIDE *pSide;
+    UINT32  ImgOffset;
+    UINT32  VarSize;
+    UINT32  Cycle;
+
+    if (!pVar)
+        return (ERROR);
+    pSide = Img_VarSide(pImg, pVar, &ImgOffset);
+    VarSize = Img_VarSize(pVar);
+    if (!pSide || (Size < VarSize))
+        return (ERROR);
+
+    Cycle = Img_Fetch(pImg, pSide, NULL, ImgOffset, pBuf, VarSize);
+    if (pCycle)
+        *pCycle = Cycle;
+    return (VarSize);
+}
+
+/**
+********************************************************************************
+* @brief Writes an input variable of the process image, any task except the
+*        one executing the program. The program gets the value at the start
+*        of its next cycle, together with all inputs written before.
+*
+* @param[in]  pImg     image
+* @param[in]  pName    name of a VAR_INPUT variable, case insensitive
+* @param[in]  pData    value
+* @param[in]  Size     size of the value, must be the size of the variable
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, no input variable or wrong size
+*******************************************************************************/
+SINT32 mist_ImgWrite(MIST_IMAGE * pImg, const CHAR * pName, const VOID * pData, UINT32 Size)
+{
+    const MIST_CODE_VAR *pVar = Img_VarFind(pImg->pCode, pName);
+    MIST_IMG_SIDE *pSide = &pImg->In;
+    MIST_IMG_BUF *pFront;
+    MIST_IMG_BUF *pBack;
+    UINT32  ImgOffset;
+
+    if (!pVar || (Img_VarSide(pImg, pVar, &ImgOffset) != pSide) || (Size != Img_VarSize(pVar)))
+        return (ERROR);
+
+    semTake(pImg->WriteSema, WAIT_FOREVER);
+    pFront = &pSide->Buf[pSide->Front];
+    pBack = &pSide->Buf[pSide->Front ^ 1];
+
+    pBack->Seq++;
+    MIST_BARRIER();
+    memcpy(pBack->pData, pFront->pData, pSide->Size);
+    memcpy(pBack->pData + ImgOffset, pData, Size);
+    pBack->Cycle = pFront->Cycle + 1;
+    MIST_BARRIER();
+    pBack->Seq++;
+    MIST_BARRIER();
+    pSide->Front ^= 1;
+
+    semGive(pImg->WriteSema);
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Size of a variable including all array elements.
+*
+* @param[in]  pVar     variable
+* @param[out] N/A
+*
+* @retval     size in bytes
+*******************************************************************************/
+MLOCAL UINT32 Img_VarSize(const MIST_CODE_VAR * pVar)
+{
+    UINT32  Size = pVar->ElemSize;
+    UINT32  Dim;
+
+    for (Dim = 0; Dim < pVar->NbOfDims; Dim++)
+        Size *= (UINT32) (pVar->Upper[Dim] - pVar->Lower[Dim] + 1);
+    return (Size);
+}
+
+/**
+********************************************************************************
+* @brief Determines the regions of the data area holding the variables of a
+*        declaration section. Adjacent variables are merged into one region.
+*        Called twice: without pRange to count, then to fill in.
+*
+* @param[in]  pCode    compiled program
+* @param[in]  Class    declaration section, MIST_KW_VAR_INPUT or MIST_KW_VAR_OUTPUT
+* @param[out] pRange   regions, ascending, NULL = count only
+* @param[out] pSize    total size of the variables in bytes
+*
+* @retval     number of regions, upper limit if pRange is NULL
+*******************************************************************************/
+MLOCAL UINT32 Img_Ranges(const MIST_CODE * pCode, UINT32 Class, MIST_IMG_RANGE * pRange, UINT32 * pSize)
+{
+    const MIST_CODE_VAR *pVar;
+    UINT32  NbOfRanges = 0;
+    UINT32  Size = 0;
+    UINT32  i;
+
+    for (i = 0, pVar = pCode->pVar; i < pCode->NbOfVars; i++, pVar++)
+    {
+        if ((pVar->Class != Class) || (pVar->Flags & MIST_VF_CONSTANT))
+            continue;
+        if (pRange)
+        {
+            pRange[NbOfRanges].MemOffset = pVar->MemOffset;
+            pRange[NbOfRanges].Size = Img_VarSize(pVar);
+        }
+        Size += Img_VarSize(pVar);
+        NbOfRanges++;
+    }
+
+    *pSize = Size;
+    if (!pRange || !NbOfRanges)
+        return (NbOfRanges);
+
+    /* Sort by the data area, merge adjacent variables, pack the image */
+    qsort(pRange, NbOfRanges, sizeof(MIST_IMG_RANGE), Img_RangeCmp);
+    Size = 0;
+    for (i = 0; i < NbOfRanges; i++)
+    {
+        if (i && (pRange[Size - 1].MemOffset + pRange[Size - 1].Size == pRange[i].MemOffset))
+        {
+            pRange[Size - 1].Size += pRange[i].Size;
+            continue;
+        }
+        pRange[Size] = pRange[i];
+        pRange[Size].ImgOffset = Size ? pRange[Size - 1].ImgOffset + pRange[Size - 1].Size : 0;
+        Size++;
+    }
+    return (Size);
+}
+
+/**
+********************************************************************************
+* @brief Compares two regions by their offset in the data area, for qsort().
+*
+* @param[in]  pA, pB   regions
+* @param[out] N/A
+*
+* @retval     < 0, = 0, > 0
+*******************************************************************************/
+MLOCAL SINT32 Img_RangeCmp(const void *pA, const void *pB)
+{
+    UINT32  A = ((const MIST_IMG_RANGE *) pA)->MemOffset;
+    UINT32  B = ((const MIST_IMG_RANGE *) pB)->MemOffset;
+
+    return ((A > B) - (A < B));
+}
+
+/**
+********************************************************************************
+* @brief Finds a variable of a program by name, binary search in the sorted
+*        variable table.
+*
+* @param[in]  pCode    compiled program
+* @param[in]  pName    variable name, case insensitive
+* @param[out] N/A
+*
+* @retval     != NULL .. variable
+* @retval     = NULL  .. not found
+*******************************************************************************/
+MLOCAL const MIST_CODE_VAR *Img_VarFind(const MIST_CODE * pCode, const CHAR * pName)
+{
+    UINT32  Lo = 0;
+    UINT32  Hi = pCode->NbOfVars;
+    UINT32  Mid;
+    SINT32  Cmp;
+
+    while (Lo < Hi)
+    {
+        Mid = (Lo + Hi) / 2;
+        Cmp = mist_VmNameCmp(pName, pCode->pVar[Mid].pName);
+        if (!Cmp)
+            return (&pCode->pVar[Mid]);
+        if (Cmp < 0)
+            Hi = Mid;
+        else
+            Lo = Mid + 1;
+    }
+    return (NULL);
+}
+
+/**
+********************************************************************************
+* @brief Determines the direction and the position of a variable in the
+*        image buffers.
+*
+* @param[in]  pImg        image
+* @param[in]  pVar        variable of the program
+* @param[out] pImgOffset  offset in the buffers of the direction
+*
+* @retval     != NULL .. direction, &pImg->In or &pImg->Out
+* @retval     = NULL  .. variable is not part of the image
+*******************************************************************************/
+MLOCAL MIST_IMG_SIDE *Img_VarSide(MIST_IMAGE * pImg, const MIST_CODE_VAR * pVar, UINT32 * pImgOffset)
+{
+    MIST_IMG_SIDE *pSide;
+    const MIST_IMG_RANGE *pRange;
+    UINT32  i;
+
+    if (pVar->Flags & MIST_VF_CONSTANT)
+        return (NULL);
+    if (pVar->Class == MIST_KW_VAR_INPUT)
+        pSide = &pImg->In;
+    else if (pVar->Class == MIST_KW_VAR_OUTPUT)
+        pSide = &pImg->Out;
+    else
+        return (NULL);
+
+    for (i = 0, pRange = pSide->pRange; i < pSide->NbOfRanges; i++, pRange++)
+    {
+        if ((pVar->MemOffset >= pRange->MemOffset) && (pVar->MemOffset < pRange->MemOffset + pRange->Size))
+        {
+            *pImgOffset = pRange->ImgOffset + pVar->MemOffset - pRange->MemOffset;
+            return (pSide);
+        }
+    }
+    return (NULL);
+}
+
+/**
+********************************************************************************
+* @brief Writes the variables of the data area to the buffer which is not
+*        published, then publishes it. Only one writer per direction.
+*
+* @param[in]  pSide    direction
+* @param[in]  pMem     data area of the program
+* @param[in]  Cycle    cycle stored with the snapshot
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Img_Publish(MIST_IMG_SIDE * pSide, const UINT8 * pMem, UINT32 Cycle)
+{
+    MIST_IMG_BUF *pBack = &pSide->Buf[pSide->Front ^ 1];
+    const MIST_IMG_RANGE *pRange;
+    UINT32  i;
+
+    pBack->Seq++;
+    MIST_BARRIER();
+    for (i = 0, pRange = pSide->pRange; i < pSide->NbOfRanges; i++, pRange++)
+        memcpy(pBack->pData + pRange->ImgOffset, pMem + pRange->MemOffset, pRange->Size);
+    pBack->Cycle = Cycle;
+    MIST_BARRIER();
+    pBack->Seq++;
+    MIST_BARRIER();
+    pSide->Front ^= 1;
+}
+
+/**
+********************************************************************************
+* @brief Reads the published buffer of a direction, repeated until no
+*        writer has changed it meanwhile. Either all variables are copied
+*        into the data area or Size bytes at ImgOffset into pBuf.
+*
+* @param[in]  pImg       image, for the statistics
+* @param[in]  pSide      direction
+* @param[in]  pMem       data area of the program, NULL = copy to pBuf
+* @param[in]  ImgOffset  first byte in the buffer, pMem = NULL only
+* @param[out] pBuf       copied bytes, pMem = NULL only
+* @param[in]  Size       number of bytes, pMem = NULL only
+*
+* @retval     cycle of the snapshot
+*******************************************************************************/
+MLOCAL UINT32 Img_Fetch(MIST_IMAGE * pImg, MIST_IMG_SIDE * pSide, UINT8 * pMem, UINT32 ImgOffset,
+                        UINT8 * pBuf, UINT32 Size)
+{
+    const MIST_IMG_BUF *pFront;
+    const MIST_IMG_RANGE *pRange;
+    UINT32  Seq;
+    UINT32  Cycle;
+    UINT32  i;
+
+    for (;;)
+    {
+        pFront = &pSide->Buf[pSide->Front];
+        MIST_BARRIER();
+        Seq = pFront->Seq;
+        MIST_BARRIER();
+        if (!(Seq & 1))
+        {
+            if (pMem)
+            {
+                for (i = 0, pRange = pSide->pRange; i < pSide->NbOfRanges; i++, pRange++)
+                    memcpy(pMem + pRange->MemOffset, pFront->pData + pRange->ImgOffset, pRange->Size);
+            }
+            else
+                memcpy(pBuf, pFront->pData + ImgOffset, Size);
+            Cycle = pFront->Cycle;
+            MIST_BARRIER();
+            if (pFront->Seq == Seq)
+                return (Cycle);
+        }
+        pImg->NbOfRetries++;
+    }
+}
@@ -1,115 +1,379 @@
-/**
-********************************************************************************
-* @file     mist_int.h
-* @author   Bachmann electronic GmbH
-* @version  $Revision: 3.90 $ $LastChangedBy: BE $
-* @date     $LastChangeDate: 2013-06-10 11:00:00 $
-*
-* @brief    This file contains all definitions and declarations,
-*           which are global within the SW-module.
-*
-********************************************************************************
-* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
-*******************************************************************************/
-
-/* Avoid problems with multiple including */
-#ifndef MIST_INT__H
-#define MIST_INT__H
-
-/* Defines: SMI server */
-#define MIST_MINVERS     2        /* min. version number */
-#define MIST_MAXVERS     2        /* max. version number */
-#define MIST_PROTVERS    2        /* Version number */
-
-/* Structure for module base configuration values */
-typedef struct MIST_BASE_PARMS
-{
-    CHAR    CfgFileName[M_PATHLEN_A];   /* Path/Name of config file, NULL = MCONFIG.INI */
-    CHAR    AppName[M_MODNAMELEN_A];    /* Instance name of module */
-    SINT32  CfgLine;                    /* Start line number in mconfig file */
-    SINT32  DebugMode;                  /* Debug mode from mconfig parameters */
-    UINT32  DefaultPriority;            /* Default priority for all worker tasks */
-} MIST_BASE_PARMS;
-
-/* Logging macros (single line, so that it does not need parentheses in the code */
-#define LOG_I(Level, FuncName, Text, Args...) (mist_Debug >= Level) ? log_Info("%s: %s: " Text, "mist", FuncName, ## Args) : 0
-#define LOG_W(Level, FuncName, Text, Args...) (mist_Debug >= Level) ? log_Wrn ("%s: %s: " Text, "mist", FuncName, ## Args) : 0
-#define LOG_E(Level, FuncName, Text, Args...) (mist_Debug >= Level) ? log_Err ("%s: %s: " Text, "mist", FuncName, ## Args) : 0
-#define LOG_U(Level, FuncName, Text, Args...) (mist_Debug >= Level) ? log_User("%s: %s: " Text, "mist", FuncName, ## Args) : 0
-
-/* Structure for task settings and actual data */
-typedef struct TASK_PROPERTIES
-{
-    /* set values, to be specified */
-    CHAR    Name[M_TSKNAMELEN_A];       /* unique visible name for task */
-    CHAR    CfgGroup[PF_KEYLEN_A];      /* configuration group name in mconfig */
-    VOIDFUNCPTR pMainFunc;              /* function pointer to main function of this task */
-    UINT32  Priority;                   /* priority for this task */
-    REAL32  CycleTime_ms;               /* cycle time for this task in ms */
-    UINT32  TimeBase;                   /* selection of time base */
-    UINT32  WDogRatio;                  /* WDogTime = CycleTime * WDogMultiple */
-    UINT32  StackSize;                  /* stack size of this task in bytes */
-    UINT32  UseFPU;                     /* this task uses the FPU */
-    /* actual data, calculated by application */
-    UINT32  TaskId;                     /* id returned by task spawn */
-    UINT32  WdogId;                     /* watchdog id returned by create wdog */
-    UINT32  CycleTime;                  /* cycle time in ticks or syncs */
-    UINT32  NextCycleStart;             /* tick/sync counter for next cycle start */
-    UINT32  PrevCycleStart;             /* tick/sync counter for next cycle start */
-    SINT32  UnitsToWait;                /* number of ticks/syncs to wait (delay) */
-    SEM_ID  CycleSema;                  /* semaphore for cycle timing */
-    SINT32  SyncSessionId;              /* session id in case of using sync */
-    UINT32  SyncEdge;                   /* sync edge selection */
-    UINT32  Quit;                       /* task deinit is requested */
-    UINT32  NbOfCycleBacklogs;          /* total nb of cycles within a backlog */
-    UINT32  NbOfSkippedCycles;          /* total nb of cycles skipped due to backlog */
-} TASK_PROPERTIES;
-
-/* SVI parameter function defines */
-typedef SINT32(*SVIFKPTSTART) (SVI_VAR * pVar, UINT32 UserParam);
-typedef VOID(*SVIFKPTEND) (SVI_VAR * pVar, UINT32 UserParam);
-
-/* Settings for a single global SVI variable */
-typedef struct SVI_GLOBVAR
-{
-    CHAR   *VarName;                    /* Visible name of exported variable */
-    UINT32  Format;                     /* Format and access type, use defines SVI_F_xxx */
-    UINT32  Size;                       /* Size of exported variable in bytes */
-    UINT32 *pVar;                       /* Pointer to exported variable */
-    UINT32  UserParam;                  /* User parameter for pSviStart and pSviEnd */
-    SVIFKPTSTART pSviStart;             /* Function pointer to lock the access to the variable */
-    SVIFKPTEND pSviEnd;                 /* Function pointer to release the lock function */
-} SVI_GLOBVAR;
-
-/*--- Variables ---*/
-
-/* Variable definitions: general */
-EXTERN SMI_ID *mist_pSmiId;       /* Id for standard module interface */
-EXTERN UINT32 mist_ModState;      /* Module state */
-EXTERN SEM_ID mist_StateSema;     /* Semaphore for halting tasks */
-EXTERN CHAR mist_Version[M_VERSTRGLEN_A]; /* Module version string */
-
-/* Function pointer to application specific smi server */
-EXTERN  SINT32(*mist_fpAppSmiSvr) (SMI_MSG * pMsg, UINT32 SessionId);
-
-/* Variable definitions: module parameters */
-EXTERN MIST_BASE_PARMS mist_BaseParams;
-EXTERN UINT32 mist_CfgLine;       /* Line number in config file to start searching */
-EXTERN CHAR mist_ProfileName[M_PATHLEN_A];        /* Path/Name of config file; NULL =
-                                                         * mconfig.ini */
-EXTERN CHAR mist_AppName[M_MODNAMELEN_A]; /* Instance name of module */
-EXTERN SINT32 mist_AppPrio;
-EXTERN SINT32 mist_Debug;
-EXTERN CHAR8 mist_ModuleInfoDesc[SMI_DESCLEN_A];
-
-/* Variable definitions: SVI server */
-EXTERN UINT32 mist_SviHandle;
-
-/* Functions: system global, defined in mist_app.c */
-EXTERN SINT32 mist_AppEOI(VOID);
-EXTERN VOID mist_AppDeinit(VOID);
-EXTERN SINT32 mist_CfgRead(VOID);
-EXTERN SINT32 mist_SviSrvInit(VOID);
-EXTERN VOID mist_SviSrvDeinit(VOID);
-
-#endif /* Avoid problems with multiple include */
+/**
+********************************************************************************
+* @file     mist_int.h
+* @author   Bachmann electronic GmbH
+* @version  $Revision: 3.90 $ $LastChangedBy: BE $
+* @date     $LastChangeDate: 2013-06-10 11:00:00 $
+*
+* @brief    This file contains all definitions and declarations,
+*           which are global within the SW-module.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef MIST_INT__H
+#define MIST_INT__H
+
+/* Defines: SMI server */
+#define MIST_MINVERS     2        /* min. version number */
+#define MIST_MAXVERS     2        /* max. version number */
+#define MIST_PROTVERS    2        /* Version number */
+
+/* Defines: task administration */
+#define TASK_MAX          16      /* max. number of tasks, mconfig groups ControlTask, ControlTask2 .. 16 */
+
+/* Defines: task timing */
+#define TASK_HR_MAX       8       /* max. number of tasks using the high resolution timer (TimeBase 2) */
+#define TASK_EVT_RING     256     /* number of overrun events kept for MIST_PROC_GETEVENTS, power of 2 */
+#define TASK_EVT_BUSY     0xFFFFFFFF    /* Seq of an overrun event which is being written */
+
+/* Defines: task affinity */
+#define TASK_CORE_MAX     32      /* max. number of CPU cores the tasks are distributed on */
+
+/* Defines: worker pools executing the segments of a program in parallel, see mist_par.c */
+#define MIST_PAR_MAXWORKERS 16    /* max. number of workers of a pool, including the calling task */
+#define MIST_PAR_MAXJOBS  64      /* max. number of jobs per worker and run */
+
+/* Defines: cycle trace of the tasks, see mist_trc.c */
+#define MIST_TRC_MAXRECORDS 1048576 /* max. number of records per task, mconfig (Trace)Records */
+#define MIST_TRC_MAGIC    0x4D545243 /* 'MTRC', first word of a dump, shows the byte order */
+#define MIST_TRC_VERSION  1       /* version of the dump format */
+
+/* Types of trace records */
+#define MIST_TRC_CYCLE    1       /* cycle start, Arg = cycle number */
+#define MIST_TRC_CYCLEEND 2       /* cycle end, Arg = cycle number */
+#define MIST_TRC_SEG      3       /* program segment start, Id = segment, Arg = worker */
+#define MIST_TRC_SEGEND   4       /* program segment end, Id = segment, Arg = worker */
+#define MIST_TRC_OVERRUN  5       /* cycle overrun, Id = policy MIST_OVR_xxx, Arg = delay in us */
+#define MIST_TRC_FAULT    6       /* program stopped, Id = MIST_VM_E_xxx, Arg = instruction */
+#define MIST_TRC_SWAP     7       /* online change, Arg = duration of the switch in us */
+
+/* Reasons of a dump */
+#define MIST_TRC_R_SMI    1       /* SMI call MIST_PROC_TRCDUMP */
+#define MIST_TRC_R_PANIC  2       /* panic signal, e.g. expired watchdog */
+#define MIST_TRC_R_SHELL  3       /* mist_TrcDump() */
+
+/* Defines: cycle statistics of the tasks */
+#define TASK_HIST_BUCKETS 20      /* execution time histogram, bucket n counts 2^(n-1) <= t < 2^n us */
+#define TASK_SVI_SPIN     100     /* failed tries of an SVI reader before it yields, Task_SviStart(), Svi_AreaStart() */
+#define TASK_SVI_YIELDS   10      /* ticks an SVI reader waits for the task before it gives up */
+
+/* Structure for module base configuration values */
+typedef struct MIST_BASE_PARMS
+{
+    CHAR    CfgFileName[M_PATHLEN_A];   /* Path/Name of config file, NULL = MCONFIG.INI */
+    CHAR    AppName[M_MODNAMELEN_A];    /* Instance name of module */
+    SINT32  CfgLine;                    /* Start line number in mconfig file */
+    SINT32  DebugMode;                  /* Debug mode from mconfig parameters */
+    UINT32  DefaultPriority;            /* Default priority for all worker tasks */
+} MIST_BASE_PARMS;
+
+/* Logging macros (single line, so that it does not need parentheses in the code */
+#define LOG_I(Level, FuncName, Text, Args...) (mist_Debug >= Level) ? log_Info("%s: %s: " Text, "mist", FuncName, ## Args) : 0
+#define LOG_W(Level, FuncName, Text, Args...) (mist_Debug >= Level) ? log_Wrn ("%s: %s: " Text, "mist", FuncName, ## Args) : 0
+#define LOG_E(Level, FuncName, Text, Args...) (mist_Debug >= Level) ? log_Err ("%s: %s: " Text, "mist", FuncName, ## Args) : 0
+#define LOG_U(Level, FuncName, Text, Args...) (mist_Debug >= Level) ? log_User("%s: %s: " Text, "mist", FuncName, ## Args) : 0
+
+/* Memory barrier for data handed over between tasks without a semaphore */
+#ifdef __GNUC__
+#define MIST_BARRIER()  __sync_synchronize()
+#else
+#define MIST_BARRIER()
+#endif
+
+/* Write section of the seqlock SviSeq of a task, see TASK_SVISNAP */
+#define TASK_SEQ_BEGIN(pTaskData) do { (pTaskData)->SviSeq++; MIST_BARRIER(); } while (0)
+#define TASK_SEQ_END(pTaskData)   do { MIST_BARRIER(); (pTaskData)->SviSeq++; } while (0)
+
+/* Atomic increment/decrement (return the previous value) and compare and swap, without GCC not atomic */
+#ifdef __GNUC__
+#define MIST_FETCH_INC(p)     __sync_fetch_and_add((p), 1)
+#define MIST_FETCH_DEC(p)     __sync_fetch_and_sub((p), 1)
+#define MIST_CAS(p, Old, New) __sync_bool_compare_and_swap((p), (Old), (New))
+#else
+#define MIST_FETCH_INC(p)     ((*(p))++)
+#define MIST_FETCH_DEC(p)     ((*(p))--)
+#define MIST_CAS(p, Old, New) ((*(p) == (Old)) ? ((*(p) = (New)), 1) : 0)
+#endif
+
+/*
+ * Cycle trace record, 16 bytes. Stamp is taken by mist_TrcStamp(), the
+ * header of a dump gives its rate. The layout is part of the dump format
+ * read by tools/mist_trc2json.c.
+ */
+typedef struct MIST_TRC_RECORD
+{
+    UINT64  Stamp;                      /* time stamp */
+    UINT16  Type;                       /* MIST_TRC_xxx */
+    UINT16  Id;                         /* depends on Type */
+    UINT32  Arg;                        /* depends on Type */
+} MIST_TRC_RECORD;
+
+/* Header of the records of a task in a dump, 56 bytes */
+typedef struct MIST_TRC_HEADER
+{
+    UINT32  Magic;                      /* MIST_TRC_MAGIC */
+    UINT16  Version;                    /* MIST_TRC_VERSION */
+    UINT16  Reason;                     /* reason of the dump, MIST_TRC_R_xxx */
+    CHAR    TaskName[16];               /* task name */
+    UINT32  NbOfRecords;                /* number of records following the header, oldest first */
+    UINT32  NbOfWritten;                /* records written since the start, older ones are lost */
+    UINT32  StampsPerMs;                /* rate of the time stamps */
+    UINT32  Period;                     /* nominal cycle time in us */
+    UINT64  Stamp;                      /* time stamp at the dump */
+    UINT32  Time;                       /* time of day at the dump in s */
+    UINT32  Arg;                        /* panic: mode of the panic signal */
+} MIST_TRC_HEADER;
+
+/*
+ * Cycle trace ring of a task, written by the task only, without lock.
+ * A dump while the task runs drops the records being overwritten.
+ */
+typedef struct MIST_TRC
+{
+    MIST_TRC_RECORD *pRec;              /* ring */
+    UINT32  Mask;                       /* number of records - 1, power of 2 */
+    volatile UINT32 Head;               /* records written since the start */
+} MIST_TRC;
+
+/* Writes a trace record, only the task owning the ring */
+#define MIST_TRC_AT(pTrc, RecStamp, RecType, RecId, RecArg) \
+    do \
+    { \
+        if (pTrc) \
+        { \
+            volatile MIST_TRC_RECORD *pRec_ = &(pTrc)->pRec[(pTrc)->Head & (pTrc)->Mask]; \
+            pRec_->Stamp = (RecStamp); \
+            pRec_->Type = (RecType); \
+            pRec_->Id = (RecId); \
+            pRec_->Arg = (RecArg); \
+            (pTrc)->Head++; \
+        } \
+    } while (0)
+#define MIST_TRC(pTrc, RecType, RecId, RecArg) MIST_TRC_AT(pTrc, mist_TrcStamp(), RecType, RecId, RecArg)
+
+/*
+ * Cycle statistics of a task, all times in us.
+ * Written by the task only, once per cycle in Task_WaitCycle(). Every value
+ * can be read at any time without a lock, values of different fields may
+ * stem from consecutive cycles. SVI clients read them as a consistent set
+ * from TASK_SVISNAP instead.
+ */
+typedef struct TASK_STATS
+{
+    UINT32  NbOfCycles;                 /* number of recorded cycles */
+    UINT32  ExecTime;                   /* execution time of the last cycle */
+    UINT32  ExecMin;                    /* min. execution time */
+    UINT32  ExecMax;                    /* max. execution time */
+    UINT32  ExecMean;                   /* mean execution time */
+    UINT32  Jitter;                     /* deviation of the last cycle start from the period */
+    UINT32  JitterMax;                  /* max. deviation of the cycle start from the period */
+    UINT32  JitterMean;                 /* mean deviation of the cycle start from the period */
+    UINT32  Period;                     /* nominal period, set by Task_InitTiming */
+    UINT32  Hist[TASK_HIST_BUCKETS];    /* histogram of the execution times */
+    UINT32  Reset;                      /* restart of the statistics requested, cleared by the task */
+    UINT32  NbOfStarts;                 /* number of recorded cycle starts */
+    UINT32  CycleStart;                 /* time stamp of the current cycle start, 0 = none */
+    UINT64  ExecSum;                    /* sum of the execution times */
+    UINT64  JitterSum;                  /* sum of the deviations */
+} TASK_STATS;
+
+/*
+ * Values of a task read by SVI clients as a consistent set, see
+ * Task_SviStart(). Copied from the values of the task under the seqlock
+ * SviSeq of TASK_PROPERTIES: the task increments SviSeq before and after
+ * writing them, a copy is valid if SviSeq was even and unchanged meanwhile.
+ */
+typedef struct TASK_SVISNAP
+{
+    TASK_STATS Stats;                   /* cycle statistics */
+    UINT32  NbOfCycleBacklogs;          /* total nb of cycles within a backlog */
+    UINT32  NbOfSkippedCycles;          /* total nb of cycles skipped due to backlog */
+    UINT32  Aborted;                    /* cycles stopped by MIST_OVR_ABORT */
+    SINT32  CoreUsed;                   /* CPU core the task is bound to, -1 = any core */
+} TASK_SVISNAP;
+
+/* Structure for task settings and actual data */
+typedef struct TASK_PROPERTIES
+{
+    /* set values, to be specified */
+    CHAR    Name[M_TSKNAMELEN_A];       /* unique visible name for task */
+    CHAR    CfgGroup[PF_KEYLEN_A];      /* configuration group name in mconfig */
+    VOIDFUNCPTR pMainFunc;              /* function pointer to main function of this task */
+    UINT32  Priority;                   /* priority for this task */
+    REAL32  CycleTime_ms;               /* cycle time for this task in ms */
+    UINT32  TimeBase;                   /* selection of time base */
+    UINT32  WDogRatio;                  /* WDogTime = CycleTime * WDogMultiple */
+    UINT32  StackSize;                  /* stack size of this task in bytes */
+    UINT32  UseFPU;                     /* this task uses the FPU */
+    CHAR    PrgFile[M_PATHLEN_A];       /* ST program executed in each cycle, "" = none */
+    UINT32  LoopBudget;                 /* max. backward jumps of the program per cycle */
+    UINT32  Backend;                    /* execution of the program: 0 = VM, 1 = generated C code */
+    UINT32  OverrunPolicy;              /* handling of a cycle backlog, MIST_OVR_xxx */
+    UINT32  CatchUpMax;                 /* max. backlog in cycles caught up by MIST_OVR_CATCHUP, 0 = all */
+    UINT32  Wcet;                       /* declared worst case execution time in us, 0 = measured */
+    SINT32  Core;                       /* CPU core of the task, -1 = any core or set by the partitioner */
+    UINT32  Workers;                    /* additional tasks executing the program in parallel, 0 = serial */
+    UINT32  SviExport;                  /* export of the program variables to the SVI, MIST_SVIEXP_xxx */
+    /* actual data, calculated by application */
+    SINT32  TaskId;                     /* id returned by task spawn */
+    SINT32  CoreUsed;                   /* CPU core the task is bound to, -1 = any core */
+    struct MIST_PAR *pPar;              /* worker pool of the program, NULL = serial */
+    MIST_TRC *pTrc;                     /* cycle trace ring, NULL = no trace */
+    UINT32  WdogId;                     /* watchdog id returned by create wdog */
+    UINT32  CycleTime;                  /* cycle time in ticks or syncs */
+    UINT32  NextCycleStart;             /* tick/sync counter for next cycle start */
+    UINT32  PrevCycleStart;             /* tick/sync counter for next cycle start */
+    SINT32  UnitsToWait;                /* number of ticks/syncs to wait (delay) */
+    SEM_ID  CycleSema;                  /* semaphore for cycle timing */
+    SINT32  SyncSessionId;              /* session id in case of using sync */
+    UINT32  SyncEdge;                   /* sync edge selection */
+    volatile UINT32 HrCount;            /* timer periods of the current cycle, high resolution timer */
+    volatile UINT32 HrCycles;           /* cycles signalled by the high resolution timer */
+    UINT64  HrDeadline;                 /* next cycle start in ns, high resolution timer of the host build */
+    UINT32  Quit;                       /* task deinit is requested */
+    UINT32  NbOfCycleBacklogs;          /* total nb of cycles within a backlog */
+    UINT32  NbOfSkippedCycles;          /* total nb of cycles skipped due to backlog */
+    UINT32  Aborted;                    /* cycles stopped by MIST_OVR_ABORT until the module is restarted */
+    UINT32  WcetMeasured;               /* max. execution time of the previous runs in us */
+    TASK_STATS Stats;                   /* cycle statistics */
+    volatile UINT32 SviSeq;             /* seqlock of the values in SviSnap, odd while the task writes them */
+    TASK_SVISNAP SviSnap;               /* values read by SVI clients, see Task_SviStart() */
+    struct MIST_CODE *pCode;            /* compiled ST program */
+    struct MIST_VM *pVm;                /* instance of the ST program */
+    VOIDFUNCPTR pCycleFunc;             /* generated C code of the program, NULL = VM */
+    struct MIST_CODE *pNewCode;         /* online change: program taking over, afterwards the old one */
+    struct MIST_VM *pNewVm;             /* online change: instance of pNewCode */
+    VOIDFUNCPTR pNewCycleFunc;          /* online change: generated C code of pNewCode */
+    struct MIST_VM_XFER *pXfer;         /* online change: values taken over from pVm */
+    UINT32  NbOfXfers;                  /* online change: number of copy operations in pXfer */
+    volatile UINT32 SwapReq;            /* online change: set by mist_AppOnlineChange, cleared by the task */
+    UINT32  SwapTime;                   /* online change: duration of the last switch in us */
+} TASK_PROPERTIES;
+
+/* Job of a worker pool, see mist_ParRun() */
+typedef VOID(*MIST_PAR_FUNC) (VOID * pArg, UINT32 Job, UINT32 Worker);
+
+/* SVI parameter function defines */
+typedef SINT32(*SVIFKPTSTART) (SVI_VAR * pVar, UINT32 UserParam);
+typedef VOID(*SVIFKPTEND) (SVI_VAR * pVar, UINT32 UserParam);
+
+/* Settings for a single global SVI variable */
+typedef struct SVI_GLOBVAR
+{
+    CHAR   *VarName;                    /* Visible name of exported variable */
+    UINT32  Format;                     /* Format and access type, use defines SVI_F_xxx */
+    UINT32  Size;                       /* Size of exported variable in bytes */
+    UINT32 *pVar;                       /* Pointer to exported variable */
+    UINT32  UserParam;                  /* User parameter for pSviStart and pSviEnd */
+    SVIFKPTSTART pSviStart;             /* Function pointer to lock the access to the variable */
+    SVIFKPTEND pSviEnd;                 /* Function pointer to release the lock function */
+} SVI_GLOBVAR;
+
+/* Settings for an SVI variable which is exported for each task */
+typedef struct SVI_TASKVAR
+{
+    CHAR   *VarName;                    /* Visible name, exported as "<task group>/<name>" */
+    UINT32  Format;                     /* Format and access type, use defines SVI_F_xxx */
+    UINT32  Size;                       /* Size of exported variable in bytes */
+    UINT32  Offset;                     /* Offset of exported variable in TASK_PROPERTIES */
+    SVIFKPTSTART pSviStart;             /* Function pointer to lock the access, UserParam = index in TaskPool */
+    SVIFKPTEND pSviEnd;                 /* Function pointer to release the lock function */
+} SVI_TASKVAR;
+
+/* Settings for an SVI variable of a list, see mist_SviAddList() */
+typedef struct MIST_SVI_VAR
+{
+    const CHAR *pName;                  /* Visible name, max. length = SVI_ADDRLEN */
+    UINT32  Format;                     /* Format and access type, use defines SVI_F_xxx */
+    UINT32  Size;                       /* Size of exported variable in bytes */
+    VOID   *pVar;                       /* Pointer to exported variable */
+    UINT32  UserParam;                  /* User parameter for pSviStart and pSviEnd */
+    SVIFKPTSTART pSviStart;             /* Function pointer to lock the access to the variable, NULL = none */
+    SVIFKPTEND pSviEnd;                 /* Function pointer to release the lock function */
+} MIST_SVI_VAR;
+
+/*--- Variables ---*/
+
+/* Variable definitions: general */
+EXTERN SMI_ID *mist_pSmiId;       /* Id for standard module interface */
+EXTERN UINT32 mist_ModState;      /* Module state */
+EXTERN SEM_ID mist_StateSema;     /* Semaphore for halting tasks */
+EXTERN CHAR mist_Version[M_VERSTRGLEN_A]; /* Module version string */
+
+/* Function pointer to application specific smi server */
+EXTERN  SINT32(*mist_fpAppSmiSvr) (SMI_MSG * pMsg, UINT32 SessionId);
+
+/* Variable definitions: module parameters */
+EXTERN MIST_BASE_PARMS mist_BaseParams;
+EXTERN UINT32 mist_CfgLine;       /* Line number in config file to start searching */
+EXTERN CHAR mist_ProfileName[M_PATHLEN_A];        /* Path/Name of config file; NULL =
+                                                         * mconfig.ini */
+EXTERN CHAR mist_AppName[M_MODNAMELEN_A]; /* Instance name of module */
+EXTERN SINT32 mist_AppPrio;
+EXTERN SINT32 mist_Debug;
+EXTERN CHAR8 mist_ModuleInfoDesc[SMI_DESCLEN_A];
+
+/* Variable definitions: SVI server */
+EXTERN UINT32 mist_SviHandle;
+EXTERN SEM_ID mist_SviSema;       /* Serializes the calls of the SVI library */
+
+/* Functions: system global, defined in mist_app.c */
+struct MIST_EVENT;
+EXTERN SINT32 mist_AppEOI(VOID);
+EXTERN VOID mist_AppDeinit(VOID);
+EXTERN SINT32 mist_AppOnlineChange(VOID);
+EXTERN UINT32 mist_EvtRead(UINT32 FirstSeq, struct MIST_EVENT *pEvt, UINT32 MaxEvents, UINT32 * pNextSeq,
+                           UINT32 * pNbOfLost);
+EXTERN SINT32 mist_ImgGetVar(const CHAR * pTaskName, const CHAR * pVarName, VOID * pBuf, UINT32 Size,
+                            UINT32 * pCycle);
+EXTERN SINT32 mist_ImgSetVar(const CHAR * pTaskName, const CHAR * pVarName, const VOID * pData, UINT32 Size);
+EXTERN SINT32 mist_AppTrcDump(const CHAR * pFileName, UINT32 Reason, UINT32 Arg);
+EXTERN SINT32 mist_CfgRead(VOID);
+EXTERN SINT32 mist_SviSrvInit(VOID);
+EXTERN VOID mist_SviSrvDeinit(VOID);
+
+/* Functions: system global, defined in mist_sched.c */
+EXTERN SINT32 mist_SchedCfgRead(VOID);
+EXTERN SINT32 mist_SchedCheck(TASK_PROPERTIES ** pTaskList, UINT32 NbOfTasks);
+EXTERN VOID mist_SchedPartition(TASK_PROPERTIES ** pTaskList, UINT32 NbOfTasks, UINT32 NbOfCores);
+EXTERN VOID mist_SchedPrint(TASK_PROPERTIES ** pTaskList, UINT32 NbOfTasks);
+
+/* Functions: system global, defined in mist_par.c */
+struct MIST_PAR;
+EXTERN struct MIST_PAR *mist_ParCreate(const CHAR * pName, UINT32 NbOfWorkers, UINT32 Priority);
+EXTERN VOID mist_ParDelete(struct MIST_PAR *pPar);
+EXTERN VOID mist_ParRun(struct MIST_PAR *pPar, UINT32 NbOfJobs, MIST_PAR_FUNC pFunc, VOID * pArg);
+EXTERN UINT32 mist_ParWorkers(const struct MIST_PAR *pPar);
+
+/* Functions: system global, defined in mist_svi.c */
+EXTERN SINT32 mist_SviAdd(const CHAR * pName, UINT32 Format, UINT32 Size, VOID * pVar, UINT32 UserParam,
+                          SVIFKPTSTART pSviStart, SVIFKPTEND pSviEnd);
+EXTERN SINT32 mist_SviFind(const CHAR * pName, UINT32 * pFormat, UINT32 * pSize);
+EXTERN SINT32 mist_SviReadList(const UINT32 * pHandle, UINT32 NbOfVars, UINT8 * pBuf, UINT32 BufSize);
+EXTERN UINT32 mist_SviIndexId(VOID);
+EXTERN VOID mist_SviClear(VOID);
+EXTERN SINT32 mist_SviSubscribe(const UINT32 * pHandle, const REAL32 * pDeadband, UINT32 NbOfVars);
+EXTERN SINT32 mist_SviSubUpdate(UINT32 SubId, UINT32 Full, UINT8 * pBuf, UINT32 BufSize, UINT32 * pNbOfChanged);
+EXTERN SINT32 mist_SviUnsubscribe(UINT32 SubId);
+EXTERN SINT32 mist_SviAddList(const MIST_SVI_VAR * pList, UINT32 NbOfVars);
+struct MIST_CODE;
+struct MIST_SVI_MAP;
+EXTERN struct MIST_SVI_MAP *mist_SviExport(const CHAR * pPrefix, const struct MIST_CODE *pCode, UINT32 Mode,
+                                           const UINT8 * pMem);
+EXTERN VOID mist_SviExportIn(const struct MIST_SVI_MAP *pMap, UINT8 * pMem);
+EXTERN VOID mist_SviExportOut(const struct MIST_SVI_MAP *pMap, const UINT8 * pMem);
+EXTERN VOID mist_SviMapFree(struct MIST_SVI_MAP *pMap);
+EXTERN VOID mist_SviAreaFree(VOID);
+
+/* Functions: system global, defined in mist_trc.c */
+EXTERN SINT32 mist_TrcCfgRead(VOID);
+EXTERN MIST_TRC *mist_TrcCreate(const CHAR * pTaskName);
+EXTERN VOID mist_TrcDelete(MIST_TRC * pTrc);
+EXTERN UINT64 mist_TrcStamp(VOID);
+EXTERN SINT32 mist_TrcWrite(TASK_PROPERTIES ** pTaskList, UINT32 NbOfTasks, const CHAR * pFileName, UINT32 Reason,
+                            UINT32 Arg);
+
+#endif /* Avoid problems with multiple include */
@@ -1,916 +1,2099 @@
-/**
-********************************************************************************
-* @file     mist_module.c
-* @author   Bachmann electronic GmbH
-* @version  $Revision: 3.90 $ $LastChangedBy: BE $
-* @date     $LastChangeDate: 2013-06-10 11:00:00 $
-*
-* @brief    This file contains all standard initialization-/deinitialization
-*           routines which are required for a software module.
-*           On starting the module, the system calls the function
-*           mist_Init() which spawns the function mist_bTaskMain
-*           as the communication task (b-Task).
-*           If mist_Init returns "successfully", the SMI call
-*           SMI_PROC_ENDOFINIT is sent in a second stage which brings
-*           the module to the state RUN.
-*
-*           Normally it is not necessary to change this file,
-*           all application specific work is done in the file mist_app.c.
-*           Only the execution of module specific SMI calls (if used)
-*           has to be added to mist_Main.
-*
-********************************************************************************
-* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
-*******************************************************************************/
-
-/* VxWorks includes */
-#include <vxWorks.h>
-#include <string.h>
-#include <taskLib.h>
-#include <sigLib.h>
-#include <stdio.h>
-#include <setjmp.h>
-#include <sysLib.h>
-#include <symLib.h>
-#include <sysSymTbl.h>
-
-/* MSys includes */
-#include <mtypes.h>
-#include <msys_e.h>
-#include <log_e.h>
-#include <smi_e.h>
-#include <res_e.h>
-#include <mod_e.h>
-#include <svi_e.h>
-#include <prof_e.h>
-
-/* Project includes */
-#include "mist_e.h"
-#include "mist_int.h"
-
-/* Defines for SMI server task */
-#define SMI_SRV_PRIO        120         /* Priority (range 118 ... 127) */
-#define SMI_SRV_STACKSIZE   10000       /* Stack size in bytes */
-
-/* Variable definitions */
-SMI_ID *mist_pSmiId;              /* Id of module-SMI */
-SINT32  mist_Debug = 0;           /* Debug level of module */
-SINT32  mist_AppPrio = 0;         /* Task priority of module */
-UINT32  mist_ModState;            /* Module state */
-SEM_ID  mist_StateSema = 0;       /* Semaphore for halting tasks */
-CHAR    mist_ProfileName[M_PATHLEN_A];    /* Path/Name of config file */
-UINT32  mist_CfgLine = 0;         /* Start line in config file */
-CHAR    mist_AppName[M_MODNAMELEN_A];     /* Instance name of module */
-CHAR    mist_ModuleInfoDesc[SMI_DESCLEN_A];
-UINT32  mist_SviHandle = 0;       /* SVI server handle */
-MLOCAL jmp_buf JumpEnv;                 /* Jump Environment for 'longjmp' */
-/* The file mist.ver will be generated by the C++ Developer tool */
-CHAR    mist_Version[M_VERSTRGLEN_A] = {
-#include "mist.ver"
-};
-
-/* Functions to be called from outside this file */
-SINT32  mist_Init(MOD_CONF * pConf, MOD_LOAD * pLoad);
-
-/* Functions to be called only from within this file */
-MLOCAL SINT32 BaseInit(VOID);
-MLOCAL VOID BaseDeinit(VOID);
-MLOCAL VOID bTaskMain(VOID);
-MLOCAL VOID RpcNull(SMI_MSG * pMsg);
-MLOCAL VOID RpcReset(SMI_MSG * pMsg);
-MLOCAL VOID RpcStop(SMI_MSG * pMsg);
-MLOCAL VOID RpcRun(SMI_MSG * pMsg);
-MLOCAL VOID RpcNewCfg(SMI_MSG * pMsg);
-MLOCAL VOID RpcDeinit(SMI_MSG * pMsg);
-MLOCAL VOID RpcSetDbg(SMI_MSG * pMsg);
-MLOCAL VOID RpcGetInfo(SMI_MSG * pMsg);
-MLOCAL VOID RpcEndOfInit(SMI_MSG * pMsg);
-MLOCAL VOID PanicHandler(UINT32 PanicMode);
-
-/* Function pointer for extended version of smi_receive and svi_MsgHandler */
-MLOCAL FUNCPTR fpSmiReceive = NULL;
-MLOCAL FUNCPTR fpSviMsgHandler = NULL;
-
-/**
-********************************************************************************
-* @brief Entry point of the module.
-*        Will be called after module loading as part of the module handler.
-*        Initializes the interfaces to the environment
-*        (SMI, SVI) so that they are ready to operate.
-*
-*        Further steps of initialization will be performed in RpcEndOfInit()
-*        which will be called by SMI after the function mist_Init()
-*        has returned.
-*
-* @param[in]  pConf   Parameter for configuration (data from MCONFIG.INI).
-* @param[in]  pLoad   Parameter from module loading.
-* @param[out] N/A
-*
-* @retval     >= 0 .. Task-Id, module initialized correctly
-* @retval      < 0 .. Error during initialization
-*******************************************************************************/
-SINT32 mist_Init(MOD_CONF * pConf, MOD_LOAD * pLoad)
-{
-    SINT32  TskId = ERROR;
-    CHAR    TaskName[M_TSKNAMELEN_A];
-    CHAR    Func[] = "mist_Init";
-
-    /* Copy profile content to module variables */
-    mist_Debug = pConf->DebugMode;
-    mist_CfgLine = pConf->LineNbr;
-    mist_AppPrio = pConf->TskPrior;
-    strncpy(mist_AppName, pConf->AppName, M_MODNAMELEN);
-    mist_AppName[M_MODNAMELEN] = 0;
-    strncpy(mist_ProfileName, pConf->ProfileName, M_PATHLEN);
-    mist_ProfileName[M_PATHLEN] = 0;
-
-    /* Conditional info message */
-    LOG_I(2, Func, "Initializing module '%s' of type '%s.m' in partition %d",
-    	  pConf->AppName, pConf->TypeName, pConf->MemPart);
-
-    /* to be left upon error */
-    do
-    {
-        /*
-         * Deliver module parameters to resource management.
-         * The variable mist_SmiId will be initialized by MOD.
-         * This ID will be required as parameter to send and receive
-         * SMI calls
-         */
-        if (res_ModParam(mist_AppName, MIST_MINVERS,
-                         MIST_MAXVERS, RES_UNLIMITUSR, &mist_pSmiId) != RES_E_OK)
-        {
-            LOG_E(0, Func, "Could not register Module on MOD!");
-            break;
-        }
-
-        /*
-         * Base initialization of module
-         * An error in this function does not abort initialization
-         * but leads to the module state ERROR
-         */
-        if (BaseInit() < 0)
-            mist_ModState = RES_S_ERROR;
-        else
-            mist_ModState = RES_S_EOI;
-
-        /*
-         * Start the SMI server as task for handling incoming SMI-calls.
-         * This task should be in the priority group "Application 2"
-         */
-        snprintf(TaskName, sizeof(TaskName), "b%s", mist_AppName);
-        TskId = sys_TaskSpawn(mist_AppName, TaskName, SMI_SRV_PRIO,
-                              VX_FP_TASK, SMI_SRV_STACKSIZE, (FUNCPTR) bTaskMain);
-
-        /* Test if task is successfully started */
-        if (TskId == ERROR)
-        {
-            LOG_E(0, Func, "Error in sys_TaskSpawn;'%s'!", TaskName);
-            break;
-        }
-
-        /*
-         * After the values have been copied from pLoad, the memory can now be freed.
-         * ATTENTION: In case of an error the module handler will free this memory.
-         */
-        if (pLoad->pCfg && pLoad->LenCfg)
-            sys_MemPFree(pConf->MemPart, pLoad->pCfg);
-
-        if (pLoad->pAttr && pLoad->LenAttr)
-            sys_MemPFree(pConf->MemPart, pLoad->pAttr);
-
-        /* Inform resource handler about changes of the module state */
-        if (res_ModState(mist_AppName, mist_ModState) < 0)
-            LOG_E(0, Func, "Change of Software-Module-State failed!");
-
-        /* Success message */
-        LOG_I(0, Func, "Initialized module '%s' of type '%s.m' in partition %d",
-              pConf->AppName, pConf->TypeName, pConf->MemPart);
-
-        /* Return Id of Task which will handle RPC-calls */
-        return (TskId);
-
-    }
-    while (FALSE);
-
-    /*
-     * If processing reaches this point, there has been an error.
-     * Free all resources which could have been allocated so far
-     * and return an error.
-     */
-    LOG_E(0, Func, "Initialization error, cleaning up resources now");
-    BaseDeinit();
-
-    return (ERROR);
-}
-
-/**
-********************************************************************************
-* @brief Base initializations concerning the main task of the module
-*        - reading configuration
-*        - applying SVI
-*        - start for module necessary tasks
-*        - ...
-*        Normally initialization routines of the adequate subranges of the
-*        SW-module will be called.
-*
-* @param[in]  N/A
-* @param[out] N/A
-*
-* @retval    >= 0 .. OK
-* @retval     < 0 .. ERROR
-*******************************************************************************/
-MLOCAL SINT32 BaseInit(VOID)
-{
-    SINT32  ret = 0;
-    SYM_TYPE symType = 0;
-    CHAR    Func[] = "BaseInit";
-
-    /*
-     * Check availability of extended access functions
-     * smi_Receive2 and svi_MsgHandler2 are newer versions with
-     * improved security features. On MSys versions before 3.85,
-     * the old functions must be used.
-     * SINT32 smi_Receive(SMI_ID *SmiId, SMI_MSG *pMsg, SINT32 Timeout)
-     * SINT32 smi_Receive2(SMI_ID *SmiId, SMI_MSG *pMsg, SINT32 Timeout , UINT32 *User);
-     */
-    symFindByName(sysSymTbl, "_smi_Receive2", (char **)&fpSmiReceive, &symType);
-    if (!fpSmiReceive)
-        symFindByName(sysSymTbl, "_smi_Receive", (char **)&fpSmiReceive, &symType);
-    if (!fpSmiReceive)
-    {
-        LOG_E(0, Func, "Could not find smi_Receive function, SMI communication with module not possible!");
-        LOG_E(0, Func, "Online de-installation of module not possible, reboot is necessary!");
-    }
-
-    symFindByName(sysSymTbl, "_svi_MsgHandler2", (char **)&fpSviMsgHandler, &symType);
-    if (!fpSviMsgHandler)
-        symFindByName(sysSymTbl, "_svi_MsgHandler", (char **)&fpSviMsgHandler, &symType);
-    if (!fpSviMsgHandler)
-        LOG_E(0, Func, "Could not find smi_MsgHandler function, external SVI access to module not possible!");
-
-    /* create semaphore for halting all tasks in STOP state of module */
-    if (!(mist_StateSema = semBCreate(SEM_Q_PRIORITY, SEM_EMPTY)))
-    {
-        LOG_E(0, Func, "Could not create semaphore for stop state of module tasks, aborting module initialization!");
-        return (ERROR);
-    }
-
-    /*
-     * Read configuration.
-     * The SVI of the module can depend on the configuration,
-     * so the configuration is read before the SVI server init is being called.
-     */
-    ret = mist_CfgRead();
-    if (ret < 0)
-    {
-        LOG_E(0, Func, "Reading module configuration returned error, aborting module initialization!");
-        return (ret);
-    }
-
-    /* Initialize SVI server */
-    ret = mist_SviSrvInit();
-    if (ret < 0)
-    {
-        LOG_E(0, Func, "Initializing SVI server for module returned error, aborting module initialization!");
-        return (ret);
-    }
-
-    return (ret);
-}
-
-/**
-********************************************************************************
-* @brief Frees all module resources
-*        Complement to BaseInit(), resources are free'd in reverse order.
-*
-* @param[in]  N/A
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID BaseDeinit(VOID)
-{
-    SINT32  ret;
-    CHAR    Func[] = "BaseDeInit";
-
-    /* Inform resource handler about changes of the module state */
-    ret = res_ModState(mist_AppName, mist_ModState = RES_S_DEINIT);
-    if (ret != RES_E_OK)
-        LOG_E(0, Func, "Change of Software-Module-State to DEINIT failed!");
-
-    /* Delete semaphore for halting all tasks in STOP state of module */
-    if (mist_StateSema)
-    {
-        if (semDelete(mist_StateSema) < 0)
-            LOG_E(0, Func, "Could not delete state semaphore!");
-        else
-        	mist_StateSema = 0;
-    }
-
-    /*
-     * Prevent external SVI-clients from accessing the module
-     * before the exported resources are being deleted
-     */
-    mist_SviSrvDeinit();
-
-    /* De-initialize resources allocated in mist_AppInit() */
-    mist_AppDeinit();
-
-}
-
-/**
-********************************************************************************
-* @brief Started as communication task when the SW-module is loaded
-*        Handles incoming SMI-calls in an endless loop.
-*        Contains the entry point for the optional restart after an
-*        exception (ExecpitonSignal) and for
-*        optional shutdown sequences. (PanicSignal)
-*
-* @param[in]  N/A
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID bTaskMain(VOID)
-{
-    SINT32  Status;
-    SMI_MSG Msg;
-    SINT32  ret;
-    UINT32  UserSessionId = 0;          /* Session Id for checking user rights */
-    CHAR    Func[] = "bTaskMain";
-
-    LOG_I(2, Func, "Starting communication task");
-
-    /*
-     * The function setjmp() acts as entry point after exceptions.
-     * This is necessary if you want to restart you application
-     * after an exception.
-     */
-    Status = setjmp(JumpEnv);
-    if (Status == 0)
-    {
-        /* This branch will be taken after start of MIST */
-
-        /* Install signal handler for power-down */
-        if (sys_PanicSigSet(PanicHandler) < 0)
-            LOG_E(0, Func, "Panic signal handler could not be installed!");
-    }
-    else
-    {
-        /* This branch will be taken after longjmp() (after an exception) */
-        LOG_I(2, Func, "Task restarted on signal %d.", Status);
-
-        /* Cleanup after an exception */
-        BaseDeinit();
-
-        /* Make base initialization of module (after an exception) */
-        if (BaseInit() < 0)
-        {
-            ret = res_ModState(mist_AppName, mist_ModState = RES_S_ERROR);
-            if (ret != RES_E_OK)
-                LOG_E(0, Func, "Change of Software-Module-State to EOI failed!");
-        }
-        else
-        {
-            /* Module is now running correctly */
-            ret = res_ModState(mist_AppName, mist_ModState = RES_S_RUN);
-            if (ret != RES_E_OK)
-                LOG_E(0, Func, "Change of Software-Module-State to RUN failed!");
-        }
-    }
-
-    /*
-     * Initialization of SMI task is finished, the following endless loop
-     * is executed endlessly as task for handling incoming SMI calls.
-     * The task is suspended by the OS on calling the function smi_Receive().
-     * smi_Receive can either WAIT_FOREVER (sleep until SMI call comes in),
-     * or it can resume after the given timeout.
-     * The timeout in smi_Receive() is only required if the software module
-     * expects replies of other modules to own requests,
-     * and these replies have to be checked for timeout.
-     */
-    while (1)
-    {
-        /*
-         * Inform the system that the cycle ends.
-         * This if for cycle time statistics,
-         * values can be seen in the task view of the Device Manager.
-         */
-        sys_CycleEnd();
-
-        /* Wait for SMI message in receive buffer */
-        if (fpSmiReceive)
-            Status = fpSmiReceive(mist_pSmiId, &Msg, WAIT_FOREVER, &UserSessionId);
-        else
-            Status = 0;
-
-        /* Inform the system that the cycle starts */
-        sys_CycleStart();
-
-        /* Test if SMI message has been received */
-        if (Status != 0)
-        {
-            continue;
-        }
-
-        if (Msg.Type & SMI_F_CALL)
-        {
-            switch (Msg.ProcRetCode)
-            {
-                case SMI_PROC_NULL:
-                    LOG_I(4, mist_AppName, "%s: received call SMI_PROC_NULL", Func);
-                    RpcNull(&Msg);
-                    break;
-
-                case SMI_PROC_DEINIT:
-                    LOG_I(4, mist_AppName, "%s: received call SMI_PROC_DEINIT", Func);
-                    RpcDeinit(&Msg);
-                    return;             /* quit task completely in this case */
-
-                case SMI_PROC_RESET:
-                    LOG_I(4, mist_AppName, "%s: received call SMI_PROC_RESET", Func);
-                    RpcReset(&Msg);
-                    break;
-
-                case SMI_PROC_STOP:
-                    LOG_I(4, mist_AppName, "%s: received call SMI_PROC_STOP", Func);
-                    RpcStop(&Msg);
-                    break;
-
-                case SMI_PROC_RUN:
-                    LOG_I(4, mist_AppName, "%s: received call SMI_PROC_RUN", Func);
-                    RpcRun(&Msg);
-                    break;
-
-                case SMI_PROC_NEWCFG:
-                    LOG_I(4, mist_AppName, "%s: received call SMI_PROC_NEWCFG", Func);
-                    RpcNewCfg(&Msg);
-                    break;
-
-                case SMI_PROC_GETINFO:
-                    LOG_I(4, mist_AppName, "%s: received call SMI_PROC_GETINFO", Func);
-                    RpcGetInfo(&Msg);
-                    break;
-
-                case SMI_PROC_ENDOFINIT:
-                    LOG_I(4, mist_AppName, "%s: received call SMI_PROC_ENDOFINIT", Func);
-                    RpcEndOfInit(&Msg);
-                    break;
-
-                case SMI_PROC_SETDBG:
-                    LOG_I(4, mist_AppName, "%s: received call SMI_PROC_SETDBG", Func);
-                    RpcSetDbg(&Msg);
-                    break;
-
-                    /*
-                     * All SVI access operations that are required in SMI calls
-                     * will be handled by the SVI handler.
-                     */
-
-                    /* for information on server and variable properties */
-                case SVI_PROC_GETADDR:
-                case SVI_PROC_GETPVINF:
-                case SVI_PROC_GETSERVINF:
-                    /* mainly used for list access access by SC and HMI */
-                case SVI_PROC_GETVALLST:
-                case SVI_PROC_SETVALLST:
-                    /* mainly used by other applications for single access */
-                case SVI_PROC_GETVAL:
-                case SVI_PROC_SETVAL:
-                case SVI_PROC_GETBLK:
-                case SVI_PROC_SETBLK:
-                case SVI_PROC_GETMULTIBLK:
-                case SVI_PROC_SETMULTIBLK:
-                    LOG_I(4, mist_AppName, "%s: received call SVI_PROC_....", Func);
-                    /* Pass call to message handler */
-                    if (fpSviMsgHandler)
-                        fpSviMsgHandler(mist_SviHandle, &Msg, mist_pSmiId, UserSessionId);
-                    break;
-
-                    /* Not a standard SMI call */
-                default:
-                    LOG_W(2, mist_AppName, "%s: received unknown call with SMI id %d", Func, Msg.ProcRetCode);
-
-                    smi_FreeData(&Msg);
-
-                    if (smi_SendReply(mist_pSmiId, &Msg, SMI_E_PROC, 0, 0) < 0)
-                        LOG_E(0, Func, "User defined smi_SendReply failed!");
-            }
-        }
-
-        smi_FreeData(&Msg);
-    }
-}
-
-/**
-********************************************************************************
-* @brief Handles the RPC-request SMI_PROC_NULL.
-*
-* @param[in]  pMsg    RPC--request
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID RpcNull(SMI_MSG * pMsg)
-{
-    smi_FreeData(pMsg);
-    if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_OK, 0, 0) < 0)
-        LOG_E(0, "RpcNull", "Case SMI_PROC_NULL - SMI SendReply failed!");
-}
-
-/**
-********************************************************************************
-* @brief Resets the module to the same state as after template_Init()
-*
-*        All module specific resources were freed and new allocated.
-*
-* @param[in]  pMsg    SMI call
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID RpcReset(SMI_MSG * pMsg)
-{
-    SMI_RESET_R Reply;
-    SINT32  ret;
-    Reply.RetCode = SMI_E_OK;
-
-    /* Freeing application specific resources */
-    BaseDeinit();
-
-    /* Make base initialization of module */
-    if (BaseInit() < 0)
-    {
-        /* Set module state to ERROR */
-        ret = res_ModState(mist_AppName, mist_ModState = RES_S_ERROR);
-        if (ret != RES_E_OK)
-            LOG_E(0, "RpcReset", "Change of Software-Module-State to ERROR failed!");
-
-        Reply.RetCode = SMI_E_FAILED;
-    }
-    else
-    {
-        /* Set module state to "End Of Init" */
-        ret = res_ModState(mist_AppName, mist_ModState = RES_S_EOI);
-        if (ret != RES_E_OK)
-            LOG_E(0, "RpcReset", "Change of Software-Module-State to EOI failed!");
-
-        Reply.RetCode = SMI_E_OK;
-    }
-
-    /* Send reply */
-    smi_FreeData(pMsg);
-    if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
-        LOG_E(0, "RpcReset", "SMI SendCReply failed!");
-}
-
-/**
-********************************************************************************
-* @brief Sets the module from RUN to STOP state.
-*        In this state only a few RPC's are accepted.
-*
-*        All additional tasks (beside mist_main()) have to implement the
-*        following lines in order to stop the whole module:
-*
-*        if ((mist_ModState != RES_S_STOP) || (mist_ModState != RES_S_EOI))
-*             semTake(mist_StateSema, WAIT_FOREVER);
-*
-* @param[in]  pMsg    RPC-request
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID RpcStop(SMI_MSG * pMsg)
-{
-    SMI_STOP_R Reply;
-    SINT32  ret;
-
-    if (mist_ModState != RES_S_RUN)
-    {
-        Reply.RetCode = SMI_E_FAILED;
-    }
-    else
-    {
-        /* Set module state */
-        ret = res_ModState(mist_AppName, mist_ModState = RES_S_STOP);
-        if (ret != RES_E_OK)
-            LOG_E(0, "RpcStop", "Change of Software-Module-State to STOP failed!");
-
-        Reply.RetCode = SMI_E_OK;
-    }
-
-    /* Send reply */
-    smi_FreeData(pMsg);
-    if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
-        LOG_E(0, "RpcStop", "SMI SendCReply failed!");
-}
-
-/**
-********************************************************************************
-* @brief Changes module state from STOP to RUN
-*
-* @param[in]  pMsg    RPC-request
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID RpcRun(SMI_MSG * pMsg)
-{
-    SMI_RUN_R Reply;
-    SINT32  ret;
-
-    if (mist_ModState != RES_S_STOP)
-    {
-        LOG_E(0, "RpcRun", "Module is not in STOP state!");
-        Reply.RetCode = SMI_E_FAILED;
-    }
-    else
-    {
-        /* Set module state to RUN */
-        ret = res_ModState(mist_AppName, mist_ModState = RES_S_RUN);
-        if (ret != RES_E_OK)
-            LOG_E(0, "RpcRun", "Change of Software-Module-State to RUN failed!");
-
-        /* Restart all stopped tasks of the module which are waiting in semTake() */
-        semFlush(mist_StateSema);
-
-        Reply.RetCode = SMI_E_OK;
-    }
-
-    /* Send reply */
-    smi_FreeData(pMsg);
-    if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
-        LOG_E(0, "RpcRun", "SMI SendCReply failed!");
-}
-
-/**
-********************************************************************************
-* @brief Reloads the module configuration.
-*
-* @param[in]  pMsg    SMI call
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID RpcNewCfg(SMI_MSG * pMsg)
-{
-    SMI_NEWCFG_R Reply;
-    SINT32  ret;
-
-    /* Test if module is in a valid state to take over a new configuration */
-    if (mist_ModState == RES_S_STOP || mist_ModState == RES_S_RUN ||
-        mist_ModState == RES_S_ERROR)
-    {
-        /* Remove application (if it is running) */
-        mist_AppDeinit();
-
-        /* Restart application with the new configuration */
-        if (mist_CfgRead() || mist_AppEOI())
-        {
-            ret = res_ModState(mist_AppName, mist_ModState = RES_S_ERROR);
-            if (ret != RES_E_OK)
-                LOG_E(0, "RpcNewCfg", "Change of Software-Module-State to ERROR failed!");
-
-            Reply.RetCode = SMI_E_FAILED;
-        }
-        else
-        {
-            /* Set module state OK */
-            ret = res_ModState(mist_AppName, mist_ModState = RES_S_EOI);
-            if (ret != RES_E_OK)
-                LOG_E(0, "RpcNewCfg", "Change of Software-Module-State to EOI failed!");
-
-            Reply.RetCode = SMI_E_OK;
-        }
-    }
-    else
-        Reply.RetCode = SMI_E_FAILED;
-
-    /* Send reply */
-    smi_FreeData(pMsg);
-    if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
-        LOG_E(0, "RpcNewCfg", "SMI SendCReply failed!");
-}
-
-/**
-********************************************************************************
-* @brief Handles the RPC-call SMI_PROC_DEINIT.
-*        This RPC-call causes the module to delete itself.
-*
-* @param[in]  pMsg    SMI call
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID RpcDeinit(SMI_MSG * pMsg)
-{
-    SMI_DEINIT_R Reply;
-
-    /*
-     * First the reply-message has to be sent back,
-     * because mist_SmiId will become invalid
-     * after calling res_ModDelete().
-     */
-    Reply.RetCode = SMI_E_OK;
-    smi_FreeData(pMsg);
-    if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
-        LOG_E(0, "RpcDeinit", "SMI SendCReply failed!");
-
-    /* Freeing application specific resources */
-    BaseDeinit();
-
-    /* Logout from the resource handler */
-    if (res_ModDelete(mist_AppName) != RES_E_OK)
-        LOG_E(0, "RpcDeinit", "Delete of module resource failed!");
-
-    /* De-install signal handlers */
-    if (sys_PanicSigReset() < 0)
-        LOG_E(0, "RpcDeinit", "Panic signal handler could not be deleted!",
-              mist_AppName);
-
-    if (sys_ExcSigReset() < 0)
-        LOG_E(0, "RpcDeinit", "Exception signal handler could not be deleted!");
-
-    LOG_I(1, "RpcDeinit", "Module has been deleted");
-}
-
-/**
-********************************************************************************
-* @brief Handles the SMI call SMI_PROC_ENDOFINIT.
-*        This call causes the module to make all initializations which
-*        are required by the module and sets it to the state RUN.
-*
-*        A operational system requires that all SW-modules are started and
-*        had initialized there environment interfaces.
-*
-* @param[in]  pMsg    SMI call
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID RpcEndOfInit(SMI_MSG * pMsg)
-{
-    SMI_ENDOFINIT_R Reply;
-    SINT32  ret;
-    CHAR	Func[]="RpcEndOfInit";
-
-    Reply.RetCode = SMI_E_OK;
-
-    if (mist_ModState != RES_S_EOI)
-    {
-        LOG_E(0, Func, "Module is not in end of init state!");
-
-        /* Wrong module state for "End of Init" */
-        Reply.RetCode = SMI_E_FAILED;
-
-        /* Send reply and return */
-        smi_FreeData(pMsg);
-        if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
-            LOG_E(0, Func, "SMI SendCReply failed!");
-
-        return;
-    }
-
-    /* Installing my application task */
-    if (mist_AppEOI() < 0)
-    {
-        Reply.RetCode = SMI_E_FAILED;
-    }
-    else
-    {
-        /* Module is now running correctly */
-        ret = res_ModState(mist_AppName, mist_ModState = RES_S_RUN);
-
-        if (ret)
-        {
-            LOG_E(0, Func, "Change of Software-Module-State to RUN failed!");
-            Reply.RetCode = SMI_E_FAILED;
-        }
-        else
-        {
-            /* Restart all stopped tasks of the module which are waiting in semTake() */
-            semFlush(mist_StateSema);
-
-            LOG_I(1, Func, "Module successfully started.");
-        }
-    }
-
-    if (Reply.RetCode == SMI_E_FAILED)
-    {
-        ret = res_ModState(mist_AppName, mist_ModState = RES_S_ERROR);
-        if (ret != RES_E_OK)
-            LOG_E(0, Func, "Change of module state to ERROR failed!");
-    }
-    else
-    {
-        ret = res_ModState(mist_AppName, mist_ModState = RES_S_RUN);
-        if (ret != RES_E_OK)
-            LOG_E(0, Func, "Change of module state to RUN failed!");
-    }
-
-    /* Send reply */
-    smi_FreeData(pMsg);
-    if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
-        LOG_E(0, Func, "SMI SendCReply failed!");
-}
-
-/**
-********************************************************************************
-* @brief Handles the RPC-request SMI_PROC_SETDBG.
-*        This RPC-call causes the module to set the debug mode.
-*
-* @param[in]  pMsg    RPC-request
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID RpcSetDbg(SMI_MSG * pMsg)
-{
-    SMI_SETDBG_C *pCall;
-    SMI_SETDBG_R Reply;
-
-    pCall = (SMI_SETDBG_C *) pMsg->Data;
-
-    /* Take over the new debug mode */
-    mist_Debug = pCall->DebugMode;
-    Reply.RetCode = SMI_E_OK;
-
-    /* Send reply */
-    smi_FreeData(pMsg);
-    if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
-        LOG_E(0, "RpcSetDbg", "SMI SendCReply failed!");
-}
-
-/**
-********************************************************************************
-* @brief Handles the RPC-request SMI_PROC_GETINFO.
-*
-* @param[in]  pMsg    RPC-request
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID RpcGetInfo(SMI_MSG * pMsg)
-{
-    SMI_GETINFO_R *pReply;
-    SYS_VERSION Version;
-
-    smi_FreeData(pMsg);
-
-    /* Allocate memory for the answer */
-    pReply = smi_MemAlloc(sizeof(*pReply));
-    if (!pReply)
-    {
-        LOG_E(0, "RpcGetInfo", "No memory!");
-        if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_ARGS, 0, 0) < 0)
-            LOG_E(0, "RpcGetInfo", "SendReply failed!");
-
-        return;
-    }
-
-    /* Deposit module name and description */
-    strncpy(pReply->Name, mist_AppName, M_MODNAMELEN);
-    pReply->Name[M_MODNAMELEN] = 0;
-
-    strncpy(pReply->Desc, mist_ModuleInfoDesc, sizeof(pReply->Desc));
-    pReply->Desc[sizeof(pReply->Desc) - 1] = 0;
-
-    /*
-     * Convert the version string to an integer
-     * CONSIDERATION:   The version string has the following format
-     *                  "Vaa.bb.cc ddd"  whereas cc is optional
-     *                  Example: "V1.02.03 Alpha", "V2.12 Beta",
-     *                           "V5.01 Release" or "V5.01"
-     * In this case, the msys function sys_GetVersion() can be used.
-     */
-    sys_GetVersion(&Version, mist_Version);
-    pReply->VersType = Version.Type;
-    memcpy(&pReply->VersCode, Version.Code, sizeof(pReply->VersCode));
-
-    pReply->State = mist_ModState;
-    pReply->DebugMode = mist_Debug;
-    pReply->RetCode = SMI_E_OK;
-
-    /* Send reply */
-    if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_OK, pReply, sizeof(*pReply)) < 0)
-        LOG_E(0, "RpcGetInfo", "SendReply of module information (Ping) failed!");
-}
-
-/**
-********************************************************************************
-* @brief Handler for panic-situation.
-*
-* @param[in]  PanicMode       Type of panic-situation (SYS_APPPANIC, ...)
-* @param[out] N/A
-*
-* @retval     N/A
-*******************************************************************************/
-MLOCAL VOID PanicHandler(UINT32 PanicMode)
-{
-    /*
-     * TODO:
-     * Bring critical parts to a predefined state.
-     * For example save data to NV-RAM or close open files.
-     */
-}
+/**
+********************************************************************************
+* @file     mist_module.c
+* @author   Bachmann electronic GmbH
+* @version  $Revision: 3.90 $ $LastChangedBy: BE $
+* @date     $LastChangeDate: 2013-06-10 11:00:00 $
+*
+* @brief    This file contains all standard initialization-/deinitialization
+*           routines which are required for a software module.
+*           On starting the module, the system calls the function
+*           mist_Init() which spawns the function mist_bTaskMain
+*           as the communication task (b-Task).
+*           If mist_Init returns "successfully", the SMI call
+*           SMI_PROC_ENDOFINIT is sent in a second stage which brings
+*           the module to the state RUN.
+*           The b-Task only receives the SMI calls, a small pool of worker
+*           tasks executes them: read calls of the module and of the SVI
+*           library concurrently, all others in the order of reception
+*           (see Smi_Class()).
+*           The calls of the SVI library are serialized by their own lock
+*           mist_SviSema, so SVI reads don't wait for a reset or a new
+*           configuration of the module.
+*
+*           Normally it is not necessary to change this file,
+*           all application specific work is done in the file mist_app.c.
+*           Only the execution of module specific SMI calls (if used)
+*           has to be added to Smi_Call() and Smi_Class().
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <taskLib.h>
+#include <sigLib.h>
+#include <stdio.h>
+#include <setjmp.h>
+#include <sysLib.h>
+#include <symLib.h>
+#include <sysSymTbl.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <log_e.h>
+#include <smi_e.h>
+#include <res_e.h>
+#include <mod_e.h>
+#include <svi_e.h>
+#include <prof_e.h>
+
+/* Project includes */
+#include "mist_e.h"
+#include "mist_int.h"
+#include "mist_prg.h"
+#include "mist_vm.h"
+
+/* Defines for SMI server task */
+#define SMI_SRV_PRIO        120         /* Priority (range 118 ... 127) */
+#define SMI_SRV_STACKSIZE   10000       /* Stack size in bytes */
+#define SMI_SRV_WORKERS     2           /* Workers executing read calls concurrently */
+#define SMI_SRV_QUEUE       16          /* Calls waiting per queue of the worker pool */
+#define SMI_SRV_QUITWAIT    100000      /* Max. time in us for the workers to end */
+
+/* Classes of SMI calls, see Smi_Class() */
+#define SMI_C_READ          0           /* Read only, executed concurrently */
+#define SMI_C_SVI           1           /* SVI read, executed concurrently, also with exclusive calls */
+#define SMI_C_SERIAL        2           /* Executed in order of reception */
+#define SMI_C_EXCL          3           /* Serial, while no read call is executed */
+#define SMI_C_DEINIT        4           /* Executed after the worker pool has been deleted */
+#define SMI_C_QUIT          5           /* Ends a worker */
+#define SMI_C_REJECT        6           /* Not executed, answered with an error */
+
+/* SMI call received by bTaskMain(), executed by the worker pool */
+typedef struct SMI_JOB
+{
+    SMI_MSG Msg;                        /* SMI message */
+    UINT32  UserSessionId;              /* Session Id for checking user rights */
+    UINT32  Class;                      /* SMI_C_xxx */
+    UINT32  Stamp;                      /* m_GetProcTime() at reception, for mist_SmiBench() */
+} SMI_JOB;
+
+/* Queue of a worker pool, a ring of jobs */
+typedef struct SMI_QUEUE
+{
+    SMI_JOB Job[SMI_SRV_QUEUE];         /* Ring of waiting jobs */
+    UINT32  Head;                       /* Number of jobs taken */
+    UINT32  Tail;                       /* Number of jobs put */
+    SEM_ID  LockSema;                   /* Protects Job, Head and Tail */
+    SEM_ID  FreeSema;                   /* Counts the free entries */
+    SEM_ID  ReadySema;                  /* Counts the waiting jobs */
+} SMI_QUEUE;
+
+/*
+ * Worker pool of the SMI server: a serial worker executes the SMI_C_SERIAL
+ * and SMI_C_EXCL calls in order of reception, the read workers execute the
+ * SMI_C_READ and SMI_C_SVI calls concurrently. An exclusive call closes the
+ * gate and waits until the read calls in progress have left it; the SVI
+ * reads don't pass the gate.
+ */
+typedef struct SMI_POOL
+{
+    SMI_QUEUE Serial;                   /* Queue of the serial worker */
+    SMI_QUEUE Read;                     /* Queue of the read workers */
+    VOID    (*pFunc) (struct SMI_JOB *);        /* Executes a job, Smi_Call() */
+    UINT32  NbOfWorkers;                /* Number of read workers */
+    SINT32  TaskId[SMI_SRV_WORKERS + 1];        /* Task ids, [0] = serial worker */
+    SEM_ID  GateSema;                   /* Taken by an exclusive call while it is executed */
+    SEM_ID  IdleSema;                   /* Given by the last read call leaving the gate */
+    volatile UINT32 Readers;            /* Number of read calls in progress */
+} SMI_POOL;
+
+/* Variable definitions */
+SMI_ID *mist_pSmiId;              /* Id of module-SMI */
+SINT32  mist_Debug = 0;           /* Debug level of module */
+SINT32  mist_AppPrio = 0;         /* Task priority of module */
+UINT32  mist_ModState;            /* Module state */
+SEM_ID  mist_StateSema = 0;       /* Semaphore for halting tasks */
+CHAR    mist_ProfileName[M_PATHLEN_A];    /* Path/Name of config file */
+UINT32  mist_CfgLine = 0;         /* Start line in config file */
+CHAR    mist_AppName[M_MODNAMELEN_A];     /* Instance name of module */
+CHAR    mist_ModuleInfoDesc[SMI_DESCLEN_A];
+UINT32  mist_SviHandle = 0;       /* SVI server handle */
+SEM_ID  mist_SviSema = 0;         /* Serializes the calls of the SVI library */
+MLOCAL jmp_buf JumpEnv;                 /* Jump Environment for 'longjmp' */
+MLOCAL SMI_POOL *SmiPool = NULL;        /* Worker pool of the SMI server */
+/* The file mist.ver will be generated by the C++ Developer tool */
+CHAR    mist_Version[M_VERSTRGLEN_A] = {
+#include "mist.ver"
+};
+
+/* Functions to be called from outside this file */
+SINT32  mist_Init(MOD_CONF * pConf, MOD_LOAD * pLoad);
+
+/* Functions: test functions, to be called from the shell */
+SINT32  mist_SmiBench(UINT32 Requests, UINT32 SlowEvery, UINT32 SlowMs);
+
+/* Functions to be called only from within this file */
+MLOCAL SINT32 BaseInit(VOID);
+MLOCAL VOID BaseDeinit(VOID);
+MLOCAL VOID bTaskMain(VOID);
+MLOCAL UINT32 Smi_Class(UINT32 ProcRetCode);
+MLOCAL VOID Smi_Call(SMI_JOB * pJob);
+MLOCAL VOID Smi_Exec(SMI_POOL * pPool, SMI_JOB * pJob);
+MLOCAL VOID Smi_Dispatch(SMI_POOL * pPool, SMI_JOB * pJob);
+MLOCAL VOID Smi_Main(SMI_POOL * pPool, SMI_QUEUE * pQueue);
+MLOCAL SINT32 Smi_Put(SMI_QUEUE * pQueue, const SMI_JOB * pJob, SINT32 Timeout);
+MLOCAL VOID Smi_Get(SMI_QUEUE * pQueue, SMI_JOB * pJob);
+MLOCAL SMI_POOL *Smi_PoolCreate(const CHAR * pName, UINT32 NbOfWorkers, VOID (*pFunc) (SMI_JOB *));
+MLOCAL VOID Smi_PoolDelete(SMI_POOL * pPool);
+MLOCAL VOID RpcNull(SMI_MSG * pMsg);
+MLOCAL VOID RpcReset(SMI_MSG * pMsg);
+MLOCAL VOID RpcStop(SMI_MSG * pMsg);
+MLOCAL VOID RpcRun(SMI_MSG * pMsg);
+MLOCAL VOID RpcNewCfg(SMI_MSG * pMsg);
+MLOCAL VOID RpcDeinit(SMI_MSG * pMsg);
+MLOCAL VOID RpcSetDbg(SMI_MSG * pMsg);
+MLOCAL VOID RpcGetInfo(SMI_MSG * pMsg);
+MLOCAL VOID RpcEndOfInit(SMI_MSG * pMsg);
+MLOCAL VOID RpcGetEvents(SMI_MSG * pMsg);
+MLOCAL VOID RpcGetVar(SMI_MSG * pMsg);
+MLOCAL VOID RpcSetVar(SMI_MSG * pMsg);
+MLOCAL VOID RpcTrcDump(SMI_MSG * pMsg);
+MLOCAL VOID RpcSviFind(SMI_MSG * pMsg);
+MLOCAL VOID RpcSviRead(SMI_MSG * pMsg);
+MLOCAL VOID RpcSviSub(SMI_MSG * pMsg);
+MLOCAL VOID RpcSviUpdate(SMI_MSG * pMsg);
+MLOCAL VOID RpcSviUnsub(SMI_MSG * pMsg);
+MLOCAL VOID PanicHandler(UINT32 PanicMode);
+MLOCAL VOID Bench_Job(SMI_JOB * pJob);
+MLOCAL int Bench_LatCmp(const VOID * pA, const VOID * pB);
+
+/* Function pointer for extended version of smi_receive and svi_MsgHandler */
+MLOCAL FUNCPTR fpSmiReceive = NULL;
+MLOCAL FUNCPTR fpSviMsgHandler = NULL;
+
+/* Read latencies of mist_SmiBench() */
+MLOCAL UINT32 *pBenchLat = NULL;        /* Latencies in us */
+MLOCAL UINT32 BenchMaxLat = 0;          /* Size of pBenchLat */
+MLOCAL UINT32 BenchNbOfLat = 0;         /* Number of read calls executed */
+MLOCAL UINT32 BenchNbOfDone = 0;        /* Number of calls executed */
+MLOCAL UINT32 BenchNbOfBusy = 0;        /* Number of read calls rejected */
+MLOCAL UINT32 BenchSlowTicks = 0;       /* Duration of a slow call */
+
+/**
+********************************************************************************
+* @brief Entry point of the module.
+*        Will be called after module loading as part of the module handler.
+*        Initializes the interfaces to the environment
+*        (SMI, SVI) so that they are ready to operate.
+*
+*        Further steps of initialization will be performed in RpcEndOfInit()
+*        which will be called by SMI after the function mist_Init()
+*        has returned.
+*
+* @param[in]  pConf   Parameter for configuration (data from MCONFIG.INI).
+* @param[in]  pLoad   Parameter from module loading.
+* @param[out] N/A
+*
+* @retval     >= 0 .. Task-Id, module initialized correctly
+* @retval      < 0 .. Error during initialization
+*******************************************************************************/
+SINT32 mist_Init(MOD_CONF * pConf, MOD_LOAD * pLoad)
+{
+    SINT32  TskId = ERROR;
+    CHAR    TaskName[M_TSKNAMELEN_A];
+    CHAR    Func[] = "mist_Init";
+
+    /* Copy profile content to module variables */
+    mist_Debug = pConf->DebugMode;
+    mist_CfgLine = pConf->LineNbr;
+    mist_AppPrio = pConf->TskPrior;
+    strncpy(mist_AppName, pConf->AppName, M_MODNAMELEN);
+    mist_AppName[M_MODNAMELEN] = 0;
+    strncpy(mist_ProfileName, pConf->ProfileName, M_PATHLEN);
+    mist_ProfileName[M_PATHLEN] = 0;
+
+    /* Conditional info message */
+    LOG_I(2, Func, "Initializing module '%s' of type '%s.m' in partition %d",
+    	  pConf->AppName, pConf->TypeName, pConf->MemPart);
+
+    /* to be left upon error */
+    do
+    {
+        /*
+         * Deliver module parameters to resource management.
+         * The variable mist_SmiId will be initialized by MOD.
+         * This ID will be required as parameter to send and receive
+         * SMI calls
+         */
+        if (res_ModParam(mist_AppName, MIST_MINVERS,
+                         MIST_MAXVERS, RES_UNLIMITUSR, &mist_pSmiId) != RES_E_OK)
+        {
+            LOG_E(0, Func, "Could not register Module on MOD!");
+            break;
+        }
+
+        /*
+         * Base initialization of module
+         * An error in this function does not abort initialization
+         * but leads to the module state ERROR
+         */
+        if (BaseInit() < 0)
+            mist_ModState = RES_S_ERROR;
+        else
+            mist_ModState = RES_S_EOI;
+
+        /*
+         * Start the SMI server as task for handling incoming SMI-calls.
+         * This task should be in the priority group "Application 2"
+         */
+        snprintf(TaskName, sizeof(TaskName), "b%s", mist_AppName);
+        TskId = sys_TaskSpawn(mist_AppName, TaskName, SMI_SRV_PRIO,
+                              VX_FP_TASK, SMI_SRV_STACKSIZE, (FUNCPTR) bTaskMain);
+
+        /* Test if task is successfully started */
+        if (TskId == ERROR)
+        {
+            LOG_E(0, Func, "Error in sys_TaskSpawn;'%s'!", TaskName);
+            break;
+        }
+
+        /*
+         * After the values have been copied from pLoad, the memory can now be freed.
+         * ATTENTION: In case of an error the module handler will free this memory.
+         */
+        if (pLoad->pCfg && pLoad->LenCfg)
+            sys_MemPFree(pConf->MemPart, pLoad->pCfg);
+
+        if (pLoad->pAttr && pLoad->LenAttr)
+            sys_MemPFree(pConf->MemPart, pLoad->pAttr);
+
+        /* Inform resource handler about changes of the module state */
+        if (res_ModState(mist_AppName, mist_ModState) < 0)
+            LOG_E(0, Func, "Change of Software-Module-State failed!");
+
+        /* Success message */
+        LOG_I(0, Func, "Initialized module '%s' of type '%s.m' in partition %d",
+              pConf->AppName, pConf->TypeName, pConf->MemPart);
+
+        /* Return Id of Task which will handle RPC-calls */
+        return (TskId);
+
+    }
+    while (FALSE);
+
+    /*
+     * If processing reaches this point, there has been an error.
+     * Free all resources which could have been allocated so far
+     * and return an error.
+     */
+    LOG_E(0, Func, "Initialization error, cleaning up resources now");
+    BaseDeinit();
+
+    return (ERROR);
+}
+
+/**
+********************************************************************************
+* @brief Base initializations concerning the main task of the module
+*        - reading configuration
+*        - applying SVI
+*        - start for module necessary tasks
+*        - ...
+*        Normally initialization routines of the adequate subranges of the
+*        SW-module will be called.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval    >= 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 BaseInit(VOID)
+{
+    SINT32  ret = 0;
+    SYM_TYPE symType = 0;
+    CHAR    Func[] = "BaseInit";
+
+    /*
+     * Check availability of extended access functions
+     * smi_Receive2 and svi_MsgHandler2 are newer versions with
+     * improved security features. On MSys versions before 3.85,
+     * the old functions must be used.
+     * SINT32 smi_Receive(SMI_ID *SmiId, SMI_MSG *pMsg, SINT32 Timeout)
+     * SINT32 smi_Receive2(SMI_ID *SmiId, SMI_MSG *pMsg, SINT32 Timeout , UINT32 *User);
+     */
+    symFindByName(sysSymTbl, "_smi_Receive2", (char **)&fpSmiReceive, &symType);
+    if (!fpSmiReceive)
+        symFindByName(sysSymTbl, "_smi_Receive", (char **)&fpSmiReceive, &symType);
+    if (!fpSmiReceive)
+    {
+        LOG_E(0, Func, "Could not find smi_Receive function, SMI communication with module not possible!");
+        LOG_E(0, Func, "Online de-installation of module not possible, reboot is necessary!");
+    }
+
+    symFindByName(sysSymTbl, "_svi_MsgHandler2", (char **)&fpSviMsgHandler, &symType);
+    if (!fpSviMsgHandler)
+        symFindByName(sysSymTbl, "_svi_MsgHandler", (char **)&fpSviMsgHandler, &symType);
+    if (!fpSviMsgHandler)
+        LOG_E(0, Func, "Could not find smi_MsgHandler function, external SVI access to module not possible!");
+
+    /* create semaphore for halting all tasks in STOP state of module */
+    if (!(mist_StateSema = semBCreate(SEM_Q_PRIORITY, SEM_EMPTY)))
+    {
+        LOG_E(0, Func, "Could not create semaphore for stop state of module tasks, aborting module initialization!");
+        return (ERROR);
+    }
+
+    /* create semaphore for the calls of the SVI library, see Smi_Class() */
+    if (!(mist_SviSema = semMCreate(SEM_Q_PRIORITY | SEM_INVERSION_SAFE)))
+    {
+        LOG_E(0, Func, "Could not create semaphore for the SVI library, aborting module initialization!");
+        return (ERROR);
+    }
+
+    /*
+     * Read configuration.
+     * The SVI of the module can depend on the configuration,
+     * so the configuration is read before the SVI server init is being called.
+     */
+    ret = mist_CfgRead();
+    if (ret < 0)
+    {
+        LOG_E(0, Func, "Reading module configuration returned error, aborting module initialization!");
+        return (ret);
+    }
+
+    /* Initialize SVI server */
+    ret = mist_SviSrvInit();
+    if (ret < 0)
+    {
+        LOG_E(0, Func, "Initializing SVI server for module returned error, aborting module initialization!");
+        return (ret);
+    }
+
+    return (ret);
+}
+
+/**
+********************************************************************************
+* @brief Frees all module resources
+*        Complement to BaseInit(), resources are free'd in reverse order.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID BaseDeinit(VOID)
+{
+    SINT32  ret;
+    CHAR    Func[] = "BaseDeInit";
+
+    /* Inform resource handler about changes of the module state */
+    ret = res_ModState(mist_AppName, mist_ModState = RES_S_DEINIT);
+    if (ret != RES_E_OK)
+        LOG_E(0, Func, "Change of Software-Module-State to DEINIT failed!");
+
+    /* Delete semaphore for halting all tasks in STOP state of module */
+    if (mist_StateSema)
+    {
+        if (semDelete(mist_StateSema) < 0)
+            LOG_E(0, Func, "Could not delete state semaphore!");
+        else
+        	mist_StateSema = 0;
+    }
+
+    /*
+     * Prevent external SVI-clients from accessing the module
+     * before the exported resources are being deleted
+     */
+    mist_SviSrvDeinit();
+
+    /* De-initialize resources allocated in mist_AppInit() */
+    mist_AppDeinit();
+
+    /* Export areas of the ST programs, no task is left to write them */
+    mist_SviAreaFree();
+
+    /* Compiled programs are kept across configuration reloads, not beyond */
+    mist_PrgCachePurge(TRUE);
+
+    /* Delete semaphore for the calls of the SVI library, no call is left */
+    if (mist_SviSema)
+    {
+        if (semDelete(mist_SviSema) < 0)
+            LOG_E(0, Func, "Could not delete SVI semaphore!");
+        else
+            mist_SviSema = 0;
+    }
+
+}
+
+/**
+********************************************************************************
+* @brief Started as communication task when the SW-module is loaded
+*        Receives incoming SMI-calls in an endless loop and hands them over
+*        to the worker pool of the SMI server (Smi_Dispatch()). Without a
+*        pool, the calls are executed by this task itself.
+*        Contains the entry point for the optional restart after an
+*        exception (ExecpitonSignal) and for
+*        optional shutdown sequences. (PanicSignal)
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID bTaskMain(VOID)
+{
+    SINT32  Status;
+    SMI_MSG Msg;
+    SMI_JOB Job;
+    SINT32  ret;
+    UINT32  UserSessionId = 0;          /* Session Id for checking user rights */
+    CHAR    TaskName[M_TSKNAMELEN_A];
+    CHAR    Func[] = "bTaskMain";
+
+    LOG_I(2, Func, "Starting communication task");
+
+    /*
+     * The function setjmp() acts as entry point after exceptions.
+     * This is necessary if you want to restart you application
+     * after an exception.
+     */
+    Status = setjmp(JumpEnv);
+    if (Status == 0)
+    {
+        /* This branch will be taken after start of MIST */
+
+        /* Install signal handler for power-down */
+        if (sys_PanicSigSet(PanicHandler) < 0)
+            LOG_E(0, Func, "Panic signal handler could not be installed!");
+    }
+    else
+    {
+        /* This branch will be taken after longjmp() (after an exception) */
+        LOG_I(2, Func, "Task restarted on signal %d.", Status);
+
+        /* The workers must not execute calls meanwhile, a new pool is created below */
+        Smi_PoolDelete(SmiPool);
+        SmiPool = NULL;
+
+        /* Cleanup after an exception */
+        BaseDeinit();
+
+        /* Make base initialization of module (after an exception) */
+        if (BaseInit() < 0)
+        {
+            ret = res_ModState(mist_AppName, mist_ModState = RES_S_ERROR);
+            if (ret != RES_E_OK)
+                LOG_E(0, Func, "Change of Software-Module-State to EOI failed!");
+        }
+        else
+        {
+            /* Module is now running correctly */
+            ret = res_ModState(mist_AppName, mist_ModState = RES_S_RUN);
+            if (ret != RES_E_OK)
+                LOG_E(0, Func, "Change of Software-Module-State to RUN failed!");
+        }
+    }
+
+    /* Worker pool, named after this task */
+    snprintf(TaskName, sizeof(TaskName), "b%s", mist_AppName);
+    SmiPool = Smi_PoolCreate(TaskName, SMI_SRV_WORKERS, Smi_Call);
+    if (!SmiPool)
+        LOG_W(0, Func, "SMI calls are executed without worker pool!");
+
+    /*
+     * Initialization of SMI task is finished, the following endless loop
+     * is executed endlessly as task for handling incoming SMI calls.
+     * The task is suspended by the OS on calling the function smi_Receive().
+     * smi_Receive can either WAIT_FOREVER (sleep until SMI call comes in),
+     * or it can resume after the given timeout.
+     * The timeout in smi_Receive() is only required if the software module
+     * expects replies of other modules to own requests,
+     * and these replies have to be checked for timeout.
+     */
+    while (1)
+    {
+        /*
+         * Inform the system that the cycle ends.
+         * This if for cycle time statistics,
+         * values can be seen in the task view of the Device Manager.
+         */
+        sys_CycleEnd();
+
+        /* Wait for SMI message in receive buffer */
+        if (fpSmiReceive)
+            Status = fpSmiReceive(mist_pSmiId, &Msg, WAIT_FOREVER, &UserSessionId);
+        else
+            Status = 0;
+
+        /* Inform the system that the cycle starts */
+        sys_CycleStart();
+
+        /* Test if SMI message has been received */
+        if (Status != 0)
+        {
+            continue;
+        }
+
+        if (!(Msg.Type & SMI_F_CALL))
+        {
+            smi_FreeData(&Msg);
+            continue;
+        }
+
+        Job.Msg = Msg;
+        Job.UserSessionId = UserSessionId;
+        Job.Class = Smi_Class(Msg.ProcRetCode);
+        Job.Stamp = m_GetProcTime();
+
+        if (Job.Class == SMI_C_DEINIT)
+        {
+            LOG_I(4, mist_AppName, "%s: received call SMI_PROC_DEINIT", Func);
+            Smi_PoolDelete(SmiPool);
+            SmiPool = NULL;
+            RpcDeinit(&Job.Msg);
+            return;             /* quit task completely in this case */
+        }
+
+        if (SmiPool)
+            Smi_Dispatch(SmiPool, &Job);
+        else
+            Smi_Call(&Job);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Executes an SMI call received by bTaskMain(). Depending on the class
+*        of the call (Smi_Class()), this is done by a worker of the SMI server
+*        or by bTaskMain() itself. A call of the class SMI_C_REJECT is only
+*        answered with SMI_E_FAILED.
+*
+* @param[in]  pJob    SMI call, the data of the message is freed
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Smi_Call(SMI_JOB * pJob)
+{
+    SMI_MSG *pMsg = &pJob->Msg;
+    CHAR    Func[] = "Smi_Call";
+
+    if (pJob->Class == SMI_C_REJECT)
+    {
+        smi_FreeData(pMsg);
+        if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_FAILED, 0, 0) < 0)
+            LOG_E(0, Func, "SendReply failed!");
+        return;
+    }
+
+    switch (pMsg->ProcRetCode)
+    {
+        case SMI_PROC_NULL:
+            LOG_I(4, mist_AppName, "%s: received call SMI_PROC_NULL", Func);
+            RpcNull(pMsg);
+            break;
+
+        case SMI_PROC_RESET:
+            LOG_I(4, mist_AppName, "%s: received call SMI_PROC_RESET", Func);
+            RpcReset(pMsg);
+            break;
+
+        case SMI_PROC_STOP:
+            LOG_I(4, mist_AppName, "%s: received call SMI_PROC_STOP", Func);
+            RpcStop(pMsg);
+            break;
+
+        case SMI_PROC_RUN:
+            LOG_I(4, mist_AppName, "%s: received call SMI_PROC_RUN", Func);
+            RpcRun(pMsg);
+            break;
+
+        case SMI_PROC_NEWCFG:
+            LOG_I(4, mist_AppName, "%s: received call SMI_PROC_NEWCFG", Func);
+            RpcNewCfg(pMsg);
+            break;
+
+        case SMI_PROC_GETINFO:
+            LOG_I(4, mist_AppName, "%s: received call SMI_PROC_GETINFO", Func);
+            RpcGetInfo(pMsg);
+            break;
+
+        case SMI_PROC_ENDOFINIT:
+            LOG_I(4, mist_AppName, "%s: received call SMI_PROC_ENDOFINIT", Func);
+            RpcEndOfInit(pMsg);
+            break;
+
+        case SMI_PROC_SETDBG:
+            LOG_I(4, mist_AppName, "%s: received call SMI_PROC_SETDBG", Func);
+            RpcSetDbg(pMsg);
+            break;
+
+        case MIST_PROC_GETEVENTS:
+            LOG_I(4, mist_AppName, "%s: received call MIST_PROC_GETEVENTS", Func);
+            RpcGetEvents(pMsg);
+            break;
+
+        case MIST_PROC_GETVAR:
+            LOG_I(4, mist_AppName, "%s: received call MIST_PROC_GETVAR", Func);
+            RpcGetVar(pMsg);
+            break;
+
+        case MIST_PROC_SETVAR:
+            LOG_I(4, mist_AppName, "%s: received call MIST_PROC_SETVAR", Func);
+            RpcSetVar(pMsg);
+            break;
+
+        case MIST_PROC_TRCDUMP:
+            LOG_I(4, mist_AppName, "%s: received call MIST_PROC_TRCDUMP", Func);
+            RpcTrcDump(pMsg);
+            break;
+
+        case MIST_PROC_SVIFIND:
+            LOG_I(4, mist_AppName, "%s: received call MIST_PROC_SVIFIND", Func);
+            RpcSviFind(pMsg);
+            break;
+
+        case MIST_PROC_SVIREAD:
+            LOG_I(4, mist_AppName, "%s: received call MIST_PROC_SVIREAD", Func);
+            RpcSviRead(pMsg);
+            break;
+
+        case MIST_PROC_SVISUB:
+            LOG_I(4, mist_AppName, "%s: received call MIST_PROC_SVISUB", Func);
+            RpcSviSub(pMsg);
+            break;
+
+        case MIST_PROC_SVIUPDATE:
+            LOG_I(4, mist_AppName, "%s: received call MIST_PROC_SVIUPDATE", Func);
+            RpcSviUpdate(pMsg);
+            break;
+
+        case MIST_PROC_SVIUNSUB:
+            LOG_I(4, mist_AppName, "%s: received call MIST_PROC_SVIUNSUB", Func);
+            RpcSviUnsub(pMsg);
+            break;
+
+            /*
+             * All SVI access operations that are required in SMI calls
+             * will be handled by the SVI handler.
+             */
+
+            /* for information on server and variable properties */
+        case SVI_PROC_GETADDR:
+        case SVI_PROC_GETPVINF:
+        case SVI_PROC_GETSERVINF:
+            /* mainly used for list access access by SC and HMI */
+        case SVI_PROC_GETVALLST:
+        case SVI_PROC_SETVALLST:
+            /* mainly used by other applications for single access */
+        case SVI_PROC_GETVAL:
+        case SVI_PROC_SETVAL:
+        case SVI_PROC_GETBLK:
+        case SVI_PROC_SETBLK:
+        case SVI_PROC_GETMULTIBLK:
+        case SVI_PROC_SETMULTIBLK:
+            LOG_I(4, mist_AppName, "%s: received call SVI_PROC_....", Func);
+            /* Pass call to message handler, reads run concurrently with the exclusive calls */
+            if (fpSviMsgHandler)
+            {
+                semTake(mist_SviSema, WAIT_FOREVER);
+                fpSviMsgHandler(mist_SviHandle, pMsg, mist_pSmiId, pJob->UserSessionId);
+                semGive(mist_SviSema);
+            }
+            break;
+
+            /* Not a standard SMI call */
+        default:
+            LOG_W(2, mist_AppName, "%s: received unknown call with SMI id %d", Func, pMsg->ProcRetCode);
+
+            smi_FreeData(pMsg);
+
+            if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_PROC, 0, 0) < 0)
+                LOG_E(0, Func, "User defined smi_SendReply failed!");
+    }
+
+    smi_FreeData(pMsg);
+}
+
+/**
+********************************************************************************
+* @brief Returns the class of an SMI call, which decides how it is executed
+*        by the worker pool of the SMI server:
+*        SMI_C_READ: reads only data of the module which is locked by the
+*        module itself, executed concurrently by the read workers.
+*        MIST_PROC_SVIUPDATE reads the index as well, it serializes the
+*        updates of the subscriptions with mist_SviSema.
+*        SMI_C_SVI: reads of the SVI library, executed by the read workers
+*        without passing the gate, so also while an exclusive call is
+*        executed. The handler of the library is not known to be reentrant,
+*        so all its calls and the registrations of variables (mist_SviAdd())
+*        take mist_SviSema. The variables stay valid: the SVI library cannot
+*        remove them and their lock functions protect the values.
+*        SMI_C_SERIAL: executed by the serial worker in the order of
+*        reception, concurrently with the read calls, e.g. the writes of
+*        the SVI library.
+*        SMI_C_EXCL: executed by the serial worker while no read call is
+*        executed. Used by the calls which rebuild the SVI index, the tasks
+*        or the subscriptions.
+*        SMI_C_DEINIT: executed by bTaskMain() after the pool has been
+*        deleted.
+*
+* @param[in]  ProcRetCode  procedure number of the call
+* @param[out] N/A
+*
+* @retval     SMI_C_xxx
+*******************************************************************************/
+MLOCAL UINT32 Smi_Class(UINT32 ProcRetCode)
+{
+    switch (ProcRetCode)
+    {
+        case SMI_PROC_NULL:
+        case SMI_PROC_GETINFO:
+        case MIST_PROC_GETEVENTS:
+        case MIST_PROC_GETVAR:
+        case MIST_PROC_SVIFIND:
+        case MIST_PROC_SVIREAD:
+        case MIST_PROC_SVIUPDATE:
+            return (SMI_C_READ);
+
+        case SVI_PROC_GETADDR:
+        case SVI_PROC_GETPVINF:
+        case SVI_PROC_GETSERVINF:
+        case SVI_PROC_GETVALLST:
+        case SVI_PROC_GETVAL:
+        case SVI_PROC_GETBLK:
+        case SVI_PROC_GETMULTIBLK:
+            return (SMI_C_SVI);
+
+        case SMI_PROC_RESET:
+        case SMI_PROC_NEWCFG:
+        case SMI_PROC_ENDOFINIT:
+        case MIST_PROC_SVISUB:
+        case MIST_PROC_SVIUNSUB:
+            return (SMI_C_EXCL);
+
+        case SMI_PROC_DEINIT:
+            return (SMI_C_DEINIT);
+
+        default:
+            return (SMI_C_SERIAL);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Executes a job of the worker pool according to its class. A read
+*        call enters the gate shared, an exclusive call closes the gate and
+*        waits until the running read calls have left it. The other calls,
+*        also the SVI reads, are executed without the gate.
+*
+* @param[in]  pPool   worker pool
+* @param[in]  pJob    SMI call
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Smi_Exec(SMI_POOL * pPool, SMI_JOB * pJob)
+{
+    if (pJob->Class == SMI_C_READ)
+    {
+        semTake(pPool->GateSema, WAIT_FOREVER);
+        MIST_FETCH_INC(&pPool->Readers);
+        semGive(pPool->GateSema);
+
+        pPool->pFunc(pJob);
+
+        /* The last one wakes up an exclusive call waiting at the gate */
+        if (MIST_FETCH_DEC(&pPool->Readers) == 1)
+            semGive(pPool->IdleSema);
+    }
+    else if (pJob->Class == SMI_C_EXCL)
+    {
+        semTake(pPool->GateSema, WAIT_FOREVER);
+        while (pPool->Readers)
+            semTake(pPool->IdleSema, WAIT_FOREVER);
+
+        pPool->pFunc(pJob);
+
+        semGive(pPool->GateSema);
+    }
+    else
+    {
+        pPool->pFunc(pJob);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Hands an SMI call over to the worker pool. If the queue of the read
+*        workers is full, a read call is answered with SMI_E_FAILED (busy)
+*        instead of delaying the reception of further calls. It is not
+*        executed by the caller, which could block it behind an exclusive
+*        call.
+*        SMI clients wait for the reply before they send the next call, so
+*        the calls of a client are executed in order although read calls
+*        overtake the serial ones of other clients.
+*
+* @param[in]  pPool   worker pool
+* @param[in]  pJob    SMI call, owned by the pool afterwards
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Smi_Dispatch(SMI_POOL * pPool, SMI_JOB * pJob)
+{
+    CHAR    Func[] = "Smi_Dispatch";
+
+    if (((pJob->Class == SMI_C_READ) || (pJob->Class == SMI_C_SVI)) && pPool->NbOfWorkers)
+    {
+        if (Smi_Put(&pPool->Read, pJob, NO_WAIT) < 0)
+        {
+            LOG_I(1, Func, "SMI server busy, call with SMI id %d rejected", pJob->Msg.ProcRetCode);
+            pJob->Class = SMI_C_REJECT;
+            pPool->pFunc(pJob);
+        }
+        return;
+    }
+
+    if (Smi_Put(&pPool->Serial, pJob, WAIT_FOREVER) < 0)
+    {
+        LOG_E(0, Func, "Could not queue call with SMI id %d!", pJob->Msg.ProcRetCode);
+        pJob->Class = SMI_C_REJECT;
+        pPool->pFunc(pJob);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Main function of a worker of the SMI server. Executes the jobs of
+*        its queue until it gets a job of the class SMI_C_QUIT.
+*
+* @param[in]  pPool   worker pool
+* @param[in]  pQueue  queue of the worker, Serial or Read of the pool
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Smi_Main(SMI_POOL * pPool, SMI_QUEUE * pQueue)
+{
+    SMI_JOB Job;
+
+    while (1)
+    {
+        Smi_Get(pQueue, &Job);
+        if (Job.Class == SMI_C_QUIT)
+            break;
+        Smi_Exec(pPool, &Job);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Appends a job to a queue of the worker pool.
+*
+* @param[in]  pQueue  queue
+* @param[in]  pJob    job, copied to the queue
+* @param[in]  Timeout ticks to wait for a free entry, NO_WAIT or WAIT_FOREVER
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, queue full
+*******************************************************************************/
+MLOCAL SINT32 Smi_Put(SMI_QUEUE * pQueue, const SMI_JOB * pJob, SINT32 Timeout)
+{
+    if (semTake(pQueue->FreeSema, Timeout) < 0)
+        return (ERROR);
+
+    semTake(pQueue->LockSema, WAIT_FOREVER);
+    pQueue->Job[pQueue->Tail % SMI_SRV_QUEUE] = *pJob;
+    pQueue->Tail++;
+    semGive(pQueue->LockSema);
+
+    semGive(pQueue->ReadySema);
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Removes the oldest job from a queue of the worker pool, waits for
+*        one if the queue is empty.
+*
+* @param[in]  pQueue  queue
+* @param[out] pJob    job
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Smi_Get(SMI_QUEUE * pQueue, SMI_JOB * pJob)
+{
+    semTake(pQueue->ReadySema, WAIT_FOREVER);
+
+    semTake(pQueue->LockSema, WAIT_FOREVER);
+    *pJob = pQueue->Job[pQueue->Head % SMI_SRV_QUEUE];
+    pQueue->Head++;
+    semGive(pQueue->LockSema);
+
+    semGive(pQueue->FreeSema);
+}
+
+/**
+********************************************************************************
+* @brief Creates the worker pool of the SMI server: a serial worker and
+*        up to SMI_SRV_WORKERS read workers, see Smi_Class().
+*
+* @param[in]  pName        name of the pool, prefix of the task names
+* @param[in]  NbOfWorkers  number of read workers, 0 = all calls are
+*                          executed by the serial worker
+* @param[in]  pFunc        function executing a job, Smi_Call()
+* @param[out] N/A
+*
+* @retval     != NULL .. pool
+* @retval     == NULL .. ERROR
+*******************************************************************************/
+MLOCAL SMI_POOL *Smi_PoolCreate(const CHAR * pName, UINT32 NbOfWorkers, VOID (*pFunc) (SMI_JOB *))
+{
+    SMI_POOL *pPool;
+    SMI_QUEUE *pQueue;
+    CHAR    TaskName[M_TSKNAMELEN_A];
+    BOOL    Ok;
+    UINT32  i;
+    CHAR    Func[] = "Smi_PoolCreate";
+
+    pPool = calloc(1, sizeof(*pPool));
+    if (!pPool)
+    {
+        LOG_E(0, Func, "No memory for the worker pool of the SMI server!");
+        return (NULL);
+    }
+
+    pPool->NbOfWorkers = (NbOfWorkers > SMI_SRV_WORKERS) ? SMI_SRV_WORKERS : NbOfWorkers;
+    pPool->pFunc = pFunc;
+    for (i = 0; i <= SMI_SRV_WORKERS; i++)
+        pPool->TaskId[i] = ERROR;
+
+    pPool->GateSema = semMCreate(SEM_Q_PRIORITY | SEM_INVERSION_SAFE);
+    pPool->IdleSema = semBCreate(SEM_Q_PRIORITY, SEM_EMPTY);
+    Ok = pPool->GateSema && pPool->IdleSema;
+    for (i = 0; i < 2; i++)
+    {
+        pQueue = i ? &pPool->Read : &pPool->Serial;
+        pQueue->LockSema = semMCreate(SEM_Q_PRIORITY | SEM_INVERSION_SAFE);
+        pQueue->FreeSema = semCCreate(SEM_Q_FIFO, SMI_SRV_QUEUE);
+        pQueue->ReadySema = semCCreate(SEM_Q_FIFO, 0);
+        Ok = Ok && pQueue->LockSema && pQueue->FreeSema && pQueue->ReadySema;
+    }
+    if (!Ok)
+    {
+        LOG_E(0, Func, "Could not create the semaphores of the SMI server!");
+        Smi_PoolDelete(pPool);
+        return (NULL);
+    }
+
+    /* Worker 0 is the serial one */
+    for (i = 0; i <= pPool->NbOfWorkers; i++)
+    {
+        snprintf(TaskName, sizeof(TaskName), "%.9s_%u", pName, i);
+        pPool->TaskId[i] = sys_TaskSpawn(mist_AppName, TaskName, SMI_SRV_PRIO, VX_FP_TASK, SMI_SRV_STACKSIZE,
+                                         (FUNCPTR) Smi_Main, pPool, i ? &pPool->Read : &pPool->Serial);
+        if (pPool->TaskId[i] == ERROR)
+        {
+            LOG_E(0, Func, "Error in sys_TaskSpawn for worker task '%s'!", TaskName);
+            Smi_PoolDelete(pPool);
+            return (NULL);
+        }
+    }
+
+    return (pPool);
+}
+
+/**
+********************************************************************************
+* @brief Ends the workers and releases the worker pool of the SMI server.
+*        The calls waiting in the queues are executed before. Workers which
+*        have not ended after SMI_SRV_QUITWAIT are deleted, the calls left
+*        in their queues are answered with SMI_E_FAILED.
+*
+* @param[in]  pPool   pool, NULL is ignored
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Smi_PoolDelete(SMI_POOL * pPool)
+{
+    SMI_QUEUE *pQueue;
+    SMI_JOB *pJob;
+    SMI_JOB Quit;
+    UINT32  RequestTime;
+    UINT32  Running;
+    UINT32  i;
+    CHAR    Func[] = "Smi_PoolDelete";
+
+    if (!pPool)
+        return;
+
+    /* A quit job for each worker, queued behind the waiting calls */
+    memset(&Quit, 0, sizeof(Quit));
+    Quit.Class = SMI_C_QUIT;
+    for (i = 0; i <= SMI_SRV_WORKERS; i++)
+    {
+        if (pPool->TaskId[i] != ERROR)
+            Smi_Put(i ? &pPool->Read : &pPool->Serial, &Quit, sysClkRateGet() * SMI_SRV_QUITWAIT / 1000000 + 1);
+    }
+
+    /* Wait up to SMI_SRV_QUITWAIT, then delete the remaining ones */
+    RequestTime = m_GetProcTime();
+    do
+    {
+        Running = 0;
+        for (i = 0; i <= SMI_SRV_WORKERS; i++)
+        {
+            if ((pPool->TaskId[i] != ERROR) && (taskIdVerify(pPool->TaskId[i]) == OK))
+                Running++;
+        }
+        if (Running)
+            taskDelay(1);
+    }
+    while (Running && ((m_GetProcTime() - RequestTime) < SMI_SRV_QUITWAIT));
+
+    for (i = 0; i <= SMI_SRV_WORKERS; i++)
+    {
+        if ((pPool->TaskId[i] != ERROR) && (taskIdVerify(pPool->TaskId[i]) == OK))
+        {
+            LOG_W(0, Func, "Worker %u of the SMI server had to be deleted!", i);
+            taskDelete(pPool->TaskId[i]);
+        }
+    }
+
+    for (i = 0; i < 2; i++)
+    {
+        pQueue = i ? &pPool->Read : &pPool->Serial;
+        for (; pQueue->Head != pQueue->Tail; pQueue->Head++)
+        {
+            pJob = &pQueue->Job[pQueue->Head % SMI_SRV_QUEUE];
+            if (pJob->Class != SMI_C_QUIT)
+            {
+                pJob->Class = SMI_C_REJECT;
+                pPool->pFunc(pJob);
+            }
+        }
+        if (pQueue->LockSema)
+            semDelete(pQueue->LockSema);
+        if (pQueue->FreeSema)
+            semDelete(pQueue->FreeSema);
+        if (pQueue->ReadySema)
+            semDelete(pQueue->ReadySema);
+    }
+
+    if (pPool->GateSema)
+        semDelete(pPool->GateSema);
+    if (pPool->IdleSema)
+        semDelete(pPool->IdleSema);
+    free(pPool);
+}
+
+/**
+********************************************************************************
+* @brief Handles the RPC-request SMI_PROC_NULL.
+*
+* @param[in]  pMsg    RPC--request
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID RpcNull(SMI_MSG * pMsg)
+{
+    smi_FreeData(pMsg);
+    if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_OK, 0, 0) < 0)
+        LOG_E(0, "RpcNull", "Case SMI_PROC_NULL - SMI SendReply failed!");
+}
+
+/**
+********************************************************************************
+* @brief Resets the module to the same state as after template_Init()
+*
+*        All module specific resources were freed and new allocated.
+*
+* @param[in]  pMsg    SMI call
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID RpcReset(SMI_MSG * pMsg)
+{
+    SMI_RESET_R Reply;
+    SINT32  ret;
+    Reply.RetCode = SMI_E_OK;
+
+    /* Freeing application specific resources */
+    BaseDeinit();
+
+    /* Make base initialization of module */
+    if (BaseInit() < 0)
+    {
+        /* Set module state to ERROR */
+        ret = res_ModState(mist_AppName, mist_ModState = RES_S_ERROR);
+        if (ret != RES_E_OK)
+            LOG_E(0, "RpcReset", "Change of Software-Module-State to ERROR failed!");
+
+        Reply.RetCode = SMI_E_FAILED;
+    }
+    else
+    {
+        /* Set module state to "End Of Init" */
+        ret = res_ModState(mist_AppName, mist_ModState = RES_S_EOI);
+        if (ret != RES_E_OK)
+            LOG_E(0, "RpcReset", "Change of Software-Module-State to EOI failed!");
+
+        Reply.RetCode = SMI_E_OK;
+    }
+
+    /* Send reply */
+    smi_FreeData(pMsg);
+    if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
+        LOG_E(0, "RpcReset", "SMI SendCReply failed!");
+}
+
+/**
+********************************************************************************
+* @brief Sets the module from RUN to STOP state.
+*        In this state only a few RPC's are accepted.
+*
+*        All additional tasks (beside mist_main()) have to implement the
+*        following lines in order to stop the whole module:
+*
+*        if ((mist_ModState != RES_S_STOP) || (mist_ModState != RES_S_EOI))
+*             semTake(mist_StateSema, WAIT_FOREVER);
+*
+* @param[in]  pMsg    RPC-request
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID RpcStop(SMI_MSG * pMsg)
+{
+    SMI_STOP_R Reply;
+    SINT32  ret;
+
+    if (mist_ModState != RES_S_RUN)
+    {
+        Reply.RetCode = SMI_E_FAILED;
+    }
+    else
+    {
+        /* Set module state */
+        ret = res_ModState(mist_AppName, mist_ModState = RES_S_STOP);
+        if (ret != RES_E_OK)
+            LOG_E(0, "RpcStop", "Change of Software-Module-State to STOP failed!");
+
+        Reply.RetCode = SMI_E_OK;
+    }
+
+    /* Send reply */
+    smi_FreeData(pMsg);
+    if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
+        LOG_E(0, "RpcStop", "SMI SendCReply failed!");
+}
+
+/**
+********************************************************************************
+* @brief Changes module state from STOP to RUN
+*
+* @param[in]  pMsg    RPC-request
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID RpcRun(SMI_MSG * pMsg)
+{
+    SMI_RUN_R Reply;
+    SINT32  ret;
+
+    if (mist_ModState != RES_S_STOP)
+    {
+        LOG_E(0, "RpcRun", "Module is not in STOP state!");
+        Reply.RetCode = SMI_E_FAILED;
+    }
+    else
+    {
+        /* Set module state to RUN */
+        ret = res_ModState(mist_AppName, mist_ModState = RES_S_RUN);
+        if (ret != RES_E_OK)
+            LOG_E(0, "RpcRun", "Change of Software-Module-State to RUN failed!");
+
+        /* Restart all stopped tasks of the module which are waiting in semTake() */
+        semFlush(mist_StateSema);
+
+        Reply.RetCode = SMI_E_OK;
+    }
+
+    /* Send reply */
+    smi_FreeData(pMsg);
+    if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
+        LOG_E(0, "RpcRun", "SMI SendCReply failed!");
+}
+
+/**
+********************************************************************************
+* @brief Reloads the module configuration.
+*        A running module switches to the new programs without stopping
+*        its tasks (mist_AppOnlineChange()). Otherwise, or if the timing
+*        of the tasks has changed, the tasks are restarted. Programs are
+*        only compiled again if the source has changed (mist_PrgCacheLoad()).
+*
+* @param[in]  pMsg    SMI call
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID RpcNewCfg(SMI_MSG * pMsg)
+{
+    SMI_NEWCFG_R Reply;
+    SINT32  ret;
+
+    /* Test if module is in a valid state to take over a new configuration */
+    if (mist_ModState == RES_S_STOP || mist_ModState == RES_S_RUN ||
+        mist_ModState == RES_S_ERROR)
+    {
+        /* Online change of a running application, the module state remains */
+        ret = (mist_ModState == RES_S_RUN) ? mist_AppOnlineChange() : 1;
+        if (ret == 0)
+            Reply.RetCode = SMI_E_OK;
+        else if (ret < 0)
+            Reply.RetCode = SMI_E_FAILED;
+        else
+        {
+            /* Remove application (if it is running) */
+            mist_AppDeinit();
+
+            /* Restart application with the new configuration */
+            if (mist_CfgRead() || mist_AppEOI())
+            {
+                ret = res_ModState(mist_AppName, mist_ModState = RES_S_ERROR);
+                if (ret != RES_E_OK)
+                    LOG_E(0, "RpcNewCfg", "Change of Software-Module-State to ERROR failed!");
+
+                Reply.RetCode = SMI_E_FAILED;
+            }
+            else
+            {
+                /* Set module state OK */
+                ret = res_ModState(mist_AppName, mist_ModState = RES_S_EOI);
+                if (ret != RES_E_OK)
+                    LOG_E(0, "RpcNewCfg", "Change of Software-Module-State to EOI failed!");
+
+                Reply.RetCode = SMI_E_OK;
+            }
+        }
+    }
+    else
+        Reply.RetCode = SMI_E_FAILED;
+
+    /* Send reply */
+    smi_FreeData(pMsg);
+    if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
+        LOG_E(0, "RpcNewCfg", "SMI SendCReply failed!");
+}
+
+/**
+********************************************************************************
+* @brief Handles the RPC-call SMI_PROC_DEINIT.
+*        This RPC-call causes the module to delete itself.
+*
+* @param[in]  pMsg    SMI call
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID RpcDeinit(SMI_MSG * pMsg)
+{
+    SMI_DEINIT_R Reply;
+
+    /*
+     * First the reply-message has to be sent back,
+     * because mist_SmiId will become invalid
+     * after calling res_ModDelete().
+     */
+    Reply.RetCode = SMI_E_OK;
+    smi_FreeData(pMsg);
+    if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
+        LOG_E(0, "RpcDeinit", "SMI SendCReply failed!");
+
+    /* Freeing application specific resources */
+    BaseDeinit();
+
+    /* Logout from the resource handler */
+    if (res_ModDelete(mist_AppName) != RES_E_OK)
+        LOG_E(0, "RpcDeinit", "Delete of module resource failed!");
+
+    /* De-install signal handlers */
+    if (sys_PanicSigReset() < 0)
+        LOG_E(0, "RpcDeinit", "Panic signal handler could not be deleted!",
+              mist_AppName);
+
+    if (sys_ExcSigReset() < 0)
+        LOG_E(0, "RpcDeinit", "Exception signal handler could not be deleted!");
+
+    LOG_I(1, "RpcDeinit", "Module has been deleted");
+}
+
+/**
+********************************************************************************
+* @brief Handles the SMI call SMI_PROC_ENDOFINIT.
+*        This call causes the module to make all initializations which
+*        are required by the module and sets it to the state RUN.
+*
+*        A operational system requires that all SW-modules are started and
+*        had initialized there environment interfaces.
+*
+* @param[in]  pMsg    SMI call
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID RpcEndOfInit(SMI_MSG * pMsg)
+{
+    SMI_ENDOFINIT_R Reply;
+    SINT32  ret;
+    CHAR	Func[]="RpcEndOfInit";
+
+    Reply.RetCode = SMI_E_OK;
+
+    if (mist_ModState != RES_S_EOI)
+    {
+        LOG_E(0, Func, "Module is not in end of init state!");
+
+        /* Wrong module state for "End of Init" */
+        Reply.RetCode = SMI_E_FAILED;
+
+        /* Send reply and return */
+        smi_FreeData(pMsg);
+        if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
+            LOG_E(0, Func, "SMI SendCReply failed!");
+
+        return;
+    }
+
+    /* Installing my application task */
+    if (mist_AppEOI() < 0)
+    {
+        Reply.RetCode = SMI_E_FAILED;
+    }
+    else
+    {
+        /* Module is now running correctly */
+        ret = res_ModState(mist_AppName, mist_ModState = RES_S_RUN);
+
+        if (ret)
+        {
+            LOG_E(0, Func, "Change of Software-Module-State to RUN failed!");
+            Reply.RetCode = SMI_E_FAILED;
+        }
+        else
+        {
+            /* Restart all stopped tasks of the module which are waiting in semTake() */
+            semFlush(mist_StateSema);
+
+            LOG_I(1, Func, "Module successfully started.");
+        }
+    }
+
+    if (Reply.RetCode == SMI_E_FAILED)
+    {
+        ret = res_ModState(mist_AppName, mist_ModState = RES_S_ERROR);
+        if (ret != RES_E_OK)
+            LOG_E(0, Func, "Change of module state to ERROR failed!");
+    }
+    else
+    {
+        ret = res_ModState(mist_AppName, mist_ModState = RES_S_RUN);
+        if (ret != RES_E_OK)
+            LOG_E(0, Func, "Change of module state to RUN failed!");
+    }
+
+    /* Send reply */
+    smi_FreeData(pMsg);
+    if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
+        LOG_E(0, Func, "SMI SendCReply failed!");
+}
+
+/**
+********************************************************************************
+* @brief Handles the RPC-request SMI_PROC_SETDBG.
+*        This RPC-call causes the module to set the debug mode.
+*
+* @param[in]  pMsg    RPC-request
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID RpcSetDbg(SMI_MSG * pMsg)
+{
+    SMI_SETDBG_C *pCall;
+    SMI_SETDBG_R Reply;
+
+    pCall = (SMI_SETDBG_C *) pMsg->Data;
+
+    /* Take over the new debug mode */
+    mist_Debug = pCall->DebugMode;
+    Reply.RetCode = SMI_E_OK;
+
+    /* Send reply */
+    smi_FreeData(pMsg);
+    if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
+        LOG_E(0, "RpcSetDbg", "SMI SendCReply failed!");
+}
+
+/**
+********************************************************************************
+* @brief Handles the RPC-request SMI_PROC_GETINFO.
+*
+* @param[in]  pMsg    RPC-request
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID RpcGetInfo(SMI_MSG * pMsg)
+{
+    SMI_GETINFO_R *pReply;
+    SYS_VERSION Version;
+
+    smi_FreeData(pMsg);
+
+    /* Allocate memory for the answer */
+    pReply = smi_MemAlloc(sizeof(*pReply));
+    if (!pReply)
+    {
+        LOG_E(0, "RpcGetInfo", "No memory!");
+        if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_ARGS, 0, 0) < 0)
+            LOG_E(0, "RpcGetInfo", "SendReply failed!");
+
+        return;
+    }
+
+    /* Deposit module name and description */
+    strncpy(pReply->Name, mist_AppName, M_MODNAMELEN);
+    pReply->Name[M_MODNAMELEN] = 0;
+
+    strncpy(pReply->Desc, mist_ModuleInfoDesc, sizeof(pReply->Desc));
+    pReply->Desc[sizeof(pReply->Desc) - 1] = 0;
+
+    /*
+     * Convert the version string to an integer
+     * CONSIDERATION:   The version string has the following format
+     *                  "Vaa.bb.cc ddd"  whereas cc is optional
+     *                  Example: "V1.02.03 Alpha", "V2.12 Beta",
+     *                           "V5.01 Release" or "V5.01"
+     * In this case, the msys function sys_GetVersion() can be used.
+     */
+    sys_GetVersion(&Version, mist_Version);
+    pReply->VersType = Version.Type;
+    memcpy(&pReply->VersCode, Version.Code, sizeof(pReply->VersCode));
+
+    pReply->State = mist_ModState;
+    pReply->DebugMode = mist_Debug;
+    pReply->RetCode = SMI_E_OK;
+
+    /* Send reply */
+    if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_OK, pReply, sizeof(*pReply)) < 0)
+        LOG_E(0, "RpcGetInfo", "SendReply of module information (Ping) failed!");
+}
+
+/**
+********************************************************************************
+* @brief Handles the RPC-request MIST_PROC_GETEVENTS.
+*        Returns the overrun events of the tasks, starting with FirstSeq.
+*        Only the valid events are sent.
+*
+* @param[in]  pMsg    RPC-request
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID RpcGetEvents(SMI_MSG * pMsg)
+{
+    MIST_GETEVENTS_C *pCall;
+    MIST_GETEVENTS_R *pReply;
+    UINT32  FirstSeq = 0;
+    UINT32  MaxEvents = MIST_EVT_MAXREPLY;
+
+    pCall = (MIST_GETEVENTS_C *) pMsg->Data;
+    if (pMsg->DataLen >= sizeof(*pCall))
+    {
+        FirstSeq = pCall->FirstSeq;
+        if (pCall->MaxEvents && (pCall->MaxEvents < MIST_EVT_MAXREPLY))
+            MaxEvents = pCall->MaxEvents;
+    }
+    smi_FreeData(pMsg);
+
+    /* Allocate memory for the answer */
+    pReply = smi_MemAlloc(sizeof(*pReply));
+    if (!pReply)
+    {
+        LOG_E(0, "RpcGetEvents", "No memory!");
+        if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_ARGS, 0, 0) < 0)
+            LOG_E(0, "RpcGetEvents", "SendReply failed!");
+
+        return;
+    }
+
+    pReply->NbOfEvents = mist_EvtRead(FirstSeq, pReply->Event, MaxEvents, &pReply->NextSeq, &pReply->NbOfLost);
+    pReply->RetCode = SMI_E_OK;
+
+    /* Send reply */
+    if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_OK, pReply,
+                      offsetof(MIST_GETEVENTS_R, Event) + pReply->NbOfEvents * sizeof(MIST_EVENT)) < 0)
+        LOG_E(0, "RpcGetEvents", "SendReply of overrun events failed!");
+}
+
+/**
+********************************************************************************
+* @brief Handles the RPC-request MIST_PROC_GETVAR.
+*        Reads a variable of the process image of a task, see
+*        mist_ImgGetVar(). Only the valid bytes of the value are sent.
+*
+* @param[in]  pMsg    RPC-request
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID RpcGetVar(SMI_MSG * pMsg)
+{
+    MIST_GETVAR_C Call;
+    MIST_GETVAR_R *pReply;
+    SINT32  Size;
+
+    if (pMsg->DataLen < sizeof(Call))
+    {
+        smi_FreeData(pMsg);
+        if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_ARGS, 0, 0) < 0)
+            LOG_E(0, "RpcGetVar", "SendReply failed!");
+        return;
+    }
+    memcpy(&Call, pMsg->Data, sizeof(Call));
+    Call.TaskName[sizeof(Call.TaskName) - 1] = 0;
+    Call.VarName[sizeof(Call.VarName) - 1] = 0;
+    smi_FreeData(pMsg);
+
+    /* Allocate memory for the answer */
+    pReply = smi_MemAlloc(sizeof(*pReply));
+    if (!pReply)
+    {
+        LOG_E(0, "RpcGetVar", "No memory!");
+        if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_ARGS, 0, 0) < 0)
+            LOG_E(0, "RpcGetVar", "SendReply failed!");
+
+        return;
+    }
+
+    Size = mist_ImgGetVar(Call.TaskName, Call.VarName, pReply->Data, sizeof(pReply->Data), &pReply->Cycle);
+    pReply->RetCode = (Size < 0) ? SMI_E_FAILED : SMI_E_OK;
+    pReply->Size = (Size < 0) ? 0 : Size;
+
+    /* Send reply */
+    if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_OK, pReply, offsetof(MIST_GETVAR_R, Data) + pReply->Size) < 0)
+        LOG_E(0, "RpcGetVar", "SendReply of variable failed!");
+}
+
+/**
+********************************************************************************
+* @brief Handles the RPC-request MIST_PROC_SETVAR.
+*        Writes an input variable of the process image of a task, see
+*        mist_ImgSetVar().
+*
+* @param[in]  pMsg    RPC-request
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID RpcSetVar(SMI_MSG * pMsg)
+{
+    MIST_SETVAR_C *pCall;
+    MIST_SETVAR_R Reply;
+
+    pCall = (MIST_SETVAR_C *) pMsg->Data;
+    Reply.RetCode = SMI_E_ARGS;
+    if ((pMsg->DataLen >= offsetof(MIST_SETVAR_C, Data)) && (pCall->Size <= MIST_IMG_MAXDATA) &&
+        (pMsg->DataLen >= offsetof(MIST_SETVAR_C, Data) + pCall->Size))
+    {
+        pCall->TaskName[sizeof(pCall->TaskName) - 1] = 0;
+        pCall->VarName[sizeof(pCall->VarName) - 1] = 0;
+        if (mist_ImgSetVar(pCall->TaskName, pCall->VarName, pCall->Data, pCall->Size) < 0)
+            Reply.RetCode = SMI_E_FAILED;
+        else
+            Reply.RetCode = SMI_E_OK;
+    }
+
+    /* Send reply */
+    smi_FreeData(pMsg);
+    if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
+        LOG_E(0, "RpcSetVar", "SMI SendCReply failed!");
+}
+
+/**
+********************************************************************************
+* @brief Handles the RPC-request MIST_PROC_TRCDUMP.
+*        Writes the cycle traces of the tasks to a file, see
+*        mist_AppTrcDump().
+*
+* @param[in]  pMsg    RPC-request
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID RpcTrcDump(SMI_MSG * pMsg)
+{
+    MIST_TRCDUMP_C *pCall;
+    MIST_TRCDUMP_R Reply;
+    SINT32  ret;
+
+    pCall = (MIST_TRCDUMP_C *) pMsg->Data;
+    Reply.RetCode = SMI_E_ARGS;
+    Reply.NbOfRecords = 0;
+    if (pMsg->DataLen >= sizeof(MIST_TRCDUMP_C))
+    {
+        pCall->FileName[sizeof(pCall->FileName) - 1] = 0;
+        ret = mist_AppTrcDump(pCall->FileName, MIST_TRC_R_SMI, 0);
+        if (ret < 0)
+        {
+            Reply.RetCode = SMI_E_FAILED;
+        }
+        else
+        {
+            Reply.RetCode = SMI_E_OK;
+            Reply.NbOfRecords = ret;
+        }
+    }
+
+    /* Send reply */
+    smi_FreeData(pMsg);
+    if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
+        LOG_E(0, "RpcTrcDump", "SMI SendCReply failed!");
+}
+
+/**
+********************************************************************************
+* @brief Handles the RPC-request MIST_PROC_SVIFIND.
+*        Resolves the names of SVI variables to handles, see mist_SviFind().
+*        Only the entries of the names are sent.
+*
+* @param[in]  pMsg    RPC-request
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID RpcSviFind(SMI_MSG * pMsg)
+{
+    MIST_SVIFIND_C *pCall;
+    MIST_SVIFIND_R *pReply;
+    UINT32  NbOfNames;
+    UINT32  Len;
+    UINT32  Pos = 0;
+    UINT32  i;
+    SINT32  Handle;
+
+    /* Allocate memory for the answer */
+    pReply = smi_MemAlloc(sizeof(*pReply));
+    if (!pReply)
+    {
+        LOG_E(0, "RpcSviFind", "No memory!");
+        smi_FreeData(pMsg);
+        if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_ARGS, 0, 0) < 0)
+            LOG_E(0, "RpcSviFind", "SendReply failed!");
+        return;
+    }
+
+    pCall = (MIST_SVIFIND_C *) pMsg->Data;
+    pReply->RetCode = SMI_E_ARGS;
+    pReply->IndexId = mist_SviIndexId();
+    pReply->NbOfVars = 0;
+    Len = (pMsg->DataLen > offsetof(MIST_SVIFIND_C, Names)) ? pMsg->DataLen - offsetof(MIST_SVIFIND_C, Names) : 0;
+    if (Len > sizeof(pCall->Names))
+        Len = sizeof(pCall->Names);
+    NbOfNames = Len ? pCall->NbOfNames : 0;
+
+    for (i = 0; (i < NbOfNames) && (i < MIST_SVI_MAXLIST); i++)
+    {
+        /* name must be terminated within the received data */
+        if ((Pos >= Len) || !memchr(&pCall->Names[Pos], 0, Len - Pos))
+            break;
+        Handle = mist_SviFind(&pCall->Names[Pos], &pReply->Var[i].Format, &pReply->Var[i].Size);
+        if (Handle < 0)
+        {
+            pReply->Var[i].Handle = MIST_SVI_NOHANDLE;
+            pReply->Var[i].Format = 0;
+            pReply->Var[i].Size = 0;
+        }
+        else
+        {
+            pReply->Var[i].Handle = Handle;
+        }
+        Pos += strlen(&pCall->Names[Pos]) + 1;
+    }
+    if (i == NbOfNames)
+    {
+        pReply->RetCode = SMI_E_OK;
+        pReply->NbOfVars = i;
+    }
+    smi_FreeData(pMsg);
+
+    /* Send reply */
+    if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_OK, pReply, offsetof(MIST_SVIFIND_R, Var) +
+                      pReply->NbOfVars * sizeof(MIST_SVI_INFO)) < 0)
+        LOG_E(0, "RpcSviFind", "SendReply failed!");
+}
+
+/**
+********************************************************************************
+* @brief Handles the RPC-request MIST_PROC_SVIREAD.
+*        Reads a list of SVI variables by their handles into one reply, see
+*        mist_SviReadList(). Only the valid bytes of the values are sent.
+*
+* @param[in]  pMsg    RPC-request
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID RpcSviRead(SMI_MSG * pMsg)
+{
+    MIST_SVIREAD_C *pCall;
+    MIST_SVIREAD_R *pReply;
+    SINT32  Size = ERROR;
+
+    /* Allocate memory for the answer */
+    pReply = smi_MemAlloc(sizeof(*pReply));
+    if (!pReply)
+    {
+        LOG_E(0, "RpcSviRead", "No memory!");
+        smi_FreeData(pMsg);
+        if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_ARGS, 0, 0) < 0)
+            LOG_E(0, "RpcSviRead", "SendReply failed!");
+        return;
+    }
+
+    pCall = (MIST_SVIREAD_C *) pMsg->Data;
+    pReply->RetCode = SMI_E_ARGS;
+    if ((pMsg->DataLen >= offsetof(MIST_SVIREAD_C, Handle)) && (pCall->NbOfVars <= MIST_SVI_MAXLIST) &&
+        (pMsg->DataLen >= offsetof(MIST_SVIREAD_C, Handle) + pCall->NbOfVars * sizeof(UINT32)))
+    {
+        pReply->RetCode = SMI_E_FAILED;
+        if (pCall->IndexId && (pCall->IndexId == mist_SviIndexId()))
+            Size = mist_SviReadList(pCall->Handle, pCall->NbOfVars, pReply->Data, sizeof(pReply->Data));
+        if (Size >= 0)
+            pReply->RetCode = SMI_E_OK;
+    }
+    pReply->Size = (Size < 0) ? 0 : Size;
+    smi_FreeData(pMsg);
+
+    /* Send reply */
+    if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_OK, pReply, offsetof(MIST_SVIREAD_R, Data) + pReply->Size) < 0)
+        LOG_E(0, "RpcSviRead", "SendReply of values failed!");
+}
+
+/**
+********************************************************************************
+* @brief Handles the RPC-request MIST_PROC_SVISUB.
+*        Subscribes to the changes of a list of SVI variables, see
+*        mist_SviSubscribe().
+*
+* @param[in]  pMsg    RPC-request
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID RpcSviSub(SMI_MSG * pMsg)
+{
+    MIST_SVISUB_C *pCall;
+    MIST_SVISUB_R Reply;
+    UINT32 *pHandle;
+    REAL32 *pDeadband;
+    SINT32  SubId = ERROR;
+    UINT32  i;
+
+    pCall = (MIST_SVISUB_C *) pMsg->Data;
+    Reply.RetCode = SMI_E_ARGS;
+    Reply.SubId = 0;
+    if ((pMsg->DataLen >= offsetof(MIST_SVISUB_C, Var)) && pCall->NbOfVars && (pCall->NbOfVars <= MIST_SVI_MAXLIST) &&
+        (pMsg->DataLen >= offsetof(MIST_SVISUB_C, Var) + pCall->NbOfVars * sizeof(MIST_SVI_SUBVAR)))
+    {
+        Reply.RetCode = SMI_E_FAILED;
+        pHandle = malloc(pCall->NbOfVars * (sizeof(UINT32) + sizeof(REAL32)));
+        if (pHandle && pCall->IndexId && (pCall->IndexId == mist_SviIndexId()))
+        {
+            pDeadband = (REAL32 *) (pHandle + pCall->NbOfVars);
+            for (i = 0; i < pCall->NbOfVars; i++)
+            {
+                pHandle[i] = pCall->Var[i].Handle;
+                pDeadband[i] = pCall->Var[i].Deadband;
+            }
+            SubId = mist_SviSubscribe(pHandle, pDeadband, pCall->NbOfVars);
+        }
+        free(pHandle);
+        if (SubId > 0)
+        {
+            Reply.RetCode = SMI_E_OK;
+            Reply.SubId = SubId;
+        }
+    }
+
+    /* Send reply */
+    smi_FreeData(pMsg);
+    if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
+        LOG_E(0, "RpcSviSub", "SMI SendCReply failed!");
+}
+
+/**
+********************************************************************************
+* @brief Handles the RPC-request MIST_PROC_SVIUPDATE.
+*        Reads the changed values of a subscription into one reply, see
+*        mist_SviSubUpdate(). Only the valid bytes are sent, none if nothing
+*        has changed.
+*
+* @param[in]  pMsg    RPC-request
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID RpcSviUpdate(SMI_MSG * pMsg)
+{
+    MIST_SVIUPDATE_C *pCall;
+    MIST_SVIUPDATE_R *pReply;
+    SINT32  Size = ERROR;
+
+    /* Allocate memory for the answer */
+    pReply = smi_MemAlloc(sizeof(*pReply));
+    if (!pReply)
+    {
+        LOG_E(0, "RpcSviUpdate", "No memory!");
+        smi_FreeData(pMsg);
+        if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_ARGS, 0, 0) < 0)
+            LOG_E(0, "RpcSviUpdate", "SendReply failed!");
+        return;
+    }
+
+    pCall = (MIST_SVIUPDATE_C *) pMsg->Data;
+    pReply->RetCode = SMI_E_ARGS;
+    pReply->NbOfChanged = 0;
+    if (pMsg->DataLen >= sizeof(MIST_SVIUPDATE_C))
+    {
+        /* Read call, the updates of the subscriptions are serialized, see Smi_Class() */
+        semTake(mist_SviSema, WAIT_FOREVER);
+        Size = mist_SviSubUpdate(pCall->SubId, pCall->Full, pReply->Data, sizeof(pReply->Data),
+                                 &pReply->NbOfChanged);
+        semGive(mist_SviSema);
+        pReply->RetCode = (Size < 0) ? SMI_E_FAILED : SMI_E_OK;
+    }
+    pReply->Size = (Size < 0) ? 0 : Size;
+    smi_FreeData(pMsg);
+
+    /* Send reply */
+    if (smi_SendReply(mist_pSmiId, pMsg, SMI_E_OK, pReply, offsetof(MIST_SVIUPDATE_R, Data) + pReply->Size) < 0)
+        LOG_E(0, "RpcSviUpdate", "SendReply of values failed!");
+}
+
+/**
+********************************************************************************
+* @brief Handles the RPC-request MIST_PROC_SVIUNSUB.
+*        Cancels a subscription, see mist_SviUnsubscribe().
+*
+* @param[in]  pMsg    RPC-request
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID RpcSviUnsub(SMI_MSG * pMsg)
+{
+    MIST_SVIUNSUB_C *pCall;
+    MIST_SVIUNSUB_R Reply;
+
+    pCall = (MIST_SVIUNSUB_C *) pMsg->Data;
+    Reply.RetCode = SMI_E_ARGS;
+    if (pMsg->DataLen >= sizeof(MIST_SVIUNSUB_C))
+        Reply.RetCode = (mist_SviUnsubscribe(pCall->SubId) < 0) ? SMI_E_FAILED : SMI_E_OK;
+
+    /* Send reply */
+    smi_FreeData(pMsg);
+    if (smi_SendCReply(mist_pSmiId, pMsg, SMI_E_OK, &Reply, sizeof(Reply)) < 0)
+        LOG_E(0, "RpcSviUnsub", "SMI SendCReply failed!");
+}
+
+/**
+********************************************************************************
+* @brief Handler for panic-situation.
+*
+* @param[in]  PanicMode       Type of panic-situation (SYS_APPPANIC, ...)
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID PanicHandler(UINT32 PanicMode)
+{
+    /* Post mortem: the last cycles of the tasks, e.g. before the watchdog expired */
+    mist_AppTrcDump(NULL, MIST_TRC_R_PANIC, PanicMode);
+
+    /*
+     * TODO:
+     * Bring critical parts to a predefined state.
+     * For example save data to NV-RAM or close open files.
+     */
+}
+
+/**
+********************************************************************************
+* @brief Job function of mist_SmiBench(), instead of Smi_Call(): an
+*        SVI_PROC_GETVAL call records the time from its reception until it
+*        holds mist_SviSema, under which Smi_Call() passes it to the SVI
+*        library. A rejected call is counted, any other call takes
+*        BenchSlowTicks.
+*
+* @param[in]  pJob    generated call
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Bench_Job(SMI_JOB * pJob)
+{
+    UINT32  Latency;
+    UINT32  Idx;
+
+    if (pJob->Class == SMI_C_REJECT)
+    {
+        MIST_FETCH_INC(&BenchNbOfBusy);
+    }
+    else if (pJob->Msg.ProcRetCode == SVI_PROC_GETVAL)
+    {
+        semTake(mist_SviSema, WAIT_FOREVER);
+        Latency = m_GetProcTime() - pJob->Stamp;
+        semGive(mist_SviSema);
+
+        Idx = MIST_FETCH_INC(&BenchNbOfLat);
+        if (Idx < BenchMaxLat)
+            pBenchLat[Idx] = Latency;
+    }
+    else
+    {
+        taskDelay(BenchSlowTicks);
+    }
+    MIST_FETCH_INC(&BenchNbOfDone);
+}
+
+/**
+********************************************************************************
+* @brief Compares two latencies, for qsort().
+*
+* @param[in]  pA      first latency
+* @param[in]  pB      second latency
+* @param[out] N/A
+*
+* @retval     < 0, 0, > 0 .. A less than, equal to, greater than B
+*******************************************************************************/
+MLOCAL int Bench_LatCmp(const VOID * pA, const VOID * pB)
+{
+    UINT32  A = *(const UINT32 *) pA;
+    UINT32  B = *(const UINT32 *) pB;
+
+    return ((A > B) - (A < B));
+}
+
+/**
+********************************************************************************
+* @brief Test function: latency of SVI reads (SVI_PROC_GETVAL) behind slow
+*        calls, with a single SMI server task and with the worker pool:
+*        behind serial calls (MIST_PROC_TRCDUMP) and behind exclusive calls
+*        (SMI_PROC_NEWCFG, like SMI_PROC_RESET). A load generator hands one
+*        call per tick over to a pool, every SlowEvery-th call is a slow one.
+*        The calls are classified by Smi_Class() and dispatched like received
+*        ones, only Bench_Job() executes them instead of Smi_Call(). The
+*        percentiles of the time from the reception of an SVI read until it
+*        gets the SVI library are printed.
+*        Example: mist_SmiBench 2000, 50, 20
+*
+* @param[in]  Requests   number of generated calls, 0 = 1000
+* @param[in]  SlowEvery  every SlowEvery-th call is slow, 0 = 50
+* @param[in]  SlowMs     duration of a slow call in ms, 0 = 20
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_SmiBench(UINT32 Requests, UINT32 SlowEvery, UINT32 SlowMs)
+{
+    MLOCAL const CHAR *const Names[] = { "single", "pool", "newcfg" };
+    MLOCAL const UINT32 Slow[] = { MIST_PROC_TRCDUMP, MIST_PROC_TRCDUMP, SMI_PROC_NEWCFG };
+    UINT32  NbOfModes = sizeof(Names) / sizeof(Names[0]);
+    SMI_POOL *pPool;
+    SMI_JOB Job;
+    UINT32  RequestTime;
+    UINT32  Mode;
+    UINT32  i, n;
+
+    if (!Requests)
+        Requests = 1000;
+    if (!SlowEvery)
+        SlowEvery = 50;
+    if (!SlowMs)
+        SlowMs = 20;
+    if (!mist_SviSema)
+    {
+        printf("mist_SmiBench: module not initialized\n");
+        return (ERROR);
+    }
+
+    pBenchLat = malloc(Requests * sizeof(UINT32));
+    if (!pBenchLat)
+    {
+        printf("mist_SmiBench: no memory\n");
+        return (ERROR);
+    }
+    BenchMaxLat = Requests;
+    BenchSlowTicks = (SlowMs * sysClkRateGet() + 999) / 1000;
+
+    /* Without read workers, all calls are executed in order like by a single task */
+    for (Mode = 0; Mode < NbOfModes; Mode++)
+    {
+        BenchNbOfLat = 0;
+        BenchNbOfDone = 0;
+        BenchNbOfBusy = 0;
+        pPool = Smi_PoolCreate("tMIST_Smi", Mode ? SMI_SRV_WORKERS : 0, Bench_Job);
+        if (!pPool)
+            break;
+
+        for (i = 0; i < Requests; i++)
+        {
+            memset(&Job, 0, sizeof(Job));
+            Job.Msg.ProcRetCode = ((i + 1) % SlowEvery) ? SVI_PROC_GETVAL : Slow[Mode];
+            Job.Class = Smi_Class(Job.Msg.ProcRetCode);
+            Job.Stamp = m_GetProcTime();
+            Smi_Dispatch(pPool, &Job);
+            taskDelay(1);
+        }
+
+        /* Wait for the calls still queued, at most for all slow calls and a second */
+        RequestTime = m_GetProcTime();
+        while ((BenchNbOfDone < Requests) &&
+               ((m_GetProcTime() - RequestTime) / 1000 < (Requests / SlowEvery + 1) * SlowMs + 1000))
+            taskDelay(1);
+        Smi_PoolDelete(pPool);
+
+        n = (BenchNbOfLat < Requests) ? BenchNbOfLat : Requests;
+        if (!n)
+            continue;
+        qsort(pBenchLat, n, sizeof(UINT32), Bench_LatCmp);
+        printf("%-7s %u reads, %u busy, %u slow calls of %u ms: latency p50 %u us, p99 %u us, max %u us\n",
+               Names[Mode], n, BenchNbOfBusy, Requests - n - BenchNbOfBusy, SlowMs,
+               pBenchLat[n / 2], pBenchLat[n * 99 / 100], pBenchLat[n - 1]);
+    }
+
+    free(pBenchLat);
+    pBenchLat = NULL;
+    return ((Mode < NbOfModes) ? ERROR : OK);
+}
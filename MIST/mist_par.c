@@ -0,0 +1,459 @@
+/**
+********************************************************************************
+* @file     mist_par.c
+* @author   Bachmann electronic GmbH
+* @version  $Revision: 3.90 $ $LastChangedBy: BE $
+* @date     $LastChangeDate: 2013-06-10 11:00:00 $
+*
+* @brief    This file contains the worker pools executing independent jobs
+*           in parallel within one cycle, e.g. the segments of an ST program
+*           (mist_VmRunPar()).
+*
+*           A pool consists of the calling task (worker 0) and a fixed number
+*           of worker tasks with its priority, created once by
+*           mist_ParCreate(). mist_ParRun() deals the jobs out round robin
+*           to a deque of each worker and starts the worker tasks. Each
+*           worker takes jobs from the bottom of its own deque. When it is
+*           empty, the worker steals from the top of the other deques, so a
+*           worker with long jobs is relieved by the others. No jobs are
+*           added while the pool is running, so a deque becomes empty only
+*           once and only its last job is contended (compare and swap).
+*
+*           All workers meet at a barrier at the end of the run: the last
+*           one arriving gives the semaphore the calling task waits for.
+*           The worker tasks then wait for the next run. Which worker
+*           executes a job varies, the jobs must not depend on each other.
+*
+*           Without GCC the atomic operations of mist_int.h are not atomic,
+*           pools must not be used then (Workers = 0).
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <taskLib.h>
+#include <semLib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+
+/* Project includes */
+#include "mist_e.h"
+#include "mist_int.h"
+
+/* No job available */
+#define PAR_NOJOB        0xFFFFFFFF
+
+/* Result of a steal attempt */
+#define PAR_EMPTY        0               /* deque is empty */
+#define PAR_STOLEN       1               /* job has been taken */
+#define PAR_LOST         2               /* another worker was faster, the deque may still hold jobs */
+
+/* Deque of a worker, filled by mist_ParRun() before the workers are started */
+typedef struct PAR_WORKER
+{
+    volatile SINT32 Top;                /* next job to be stolen */
+    volatile SINT32 Bottom;             /* behind the last job, taken by the owner */
+    UINT32  Job[MIST_PAR_MAXJOBS];      /* jobs of the current run */
+    struct MIST_PAR *pPar;              /* pool */
+    UINT32  Index;                      /* worker number, 0 = calling task */
+    SEM_ID  StartSema;                  /* given by mist_ParRun(), worker tasks only */
+    SINT32  TaskId;                     /* id returned by task spawn, worker tasks only */
+    UINT32  NbOfJobs;                   /* jobs executed in total */
+    UINT32  NbOfSteals;                 /* jobs stolen from other workers in total */
+} PAR_WORKER;
+
+/* Worker pool */
+typedef struct MIST_PAR
+{
+    CHAR    Name[M_TSKNAMELEN_A];       /* name of the calling task */
+    UINT32  NbOfWorkers;                /* number of workers including the calling task */
+    MIST_PAR_FUNC pFunc;                /* job function of the current run */
+    VOID   *pArg;                       /* argument of pFunc */
+    volatile UINT32 NbOfArrived;        /* workers at the barrier */
+    volatile UINT32 Quit;               /* worker tasks are requested to end */
+    SEM_ID  DoneSema;                   /* barrier, taken by the calling task */
+    PAR_WORKER Worker[MIST_PAR_MAXWORKERS];
+} MIST_PAR;
+
+/* Functions: system global, see mist_int.h */
+MIST_PAR *mist_ParCreate(const CHAR * pName, UINT32 NbOfWorkers, UINT32 Priority);
+VOID    mist_ParDelete(MIST_PAR * pPar);
+VOID    mist_ParRun(MIST_PAR * pPar, UINT32 NbOfJobs, MIST_PAR_FUNC pFunc, VOID * pArg);
+UINT32  mist_ParWorkers(const MIST_PAR * pPar);
+
+/* Functions: local */
+MLOCAL VOID Par_Main(PAR_WORKER * pWorker);
+MLOCAL VOID Par_Work(PAR_WORKER * pWorker);
+MLOCAL UINT32 Par_Take(PAR_WORKER * pWorker);
+MLOCAL UINT32 Par_StealFrom(PAR_WORKER * pVictim, UINT32 * pJob);
+MLOCAL UINT32 Par_Steal(PAR_WORKER * pWorker);
+
+/**
+********************************************************************************
+* @brief Creates a worker pool: NbOfWorkers - 1 worker tasks are spawned
+*        with the given priority and wait for mist_ParRun().
+*
+* @param[in]  pName        name of the calling task, the worker tasks are named after it
+* @param[in]  NbOfWorkers  number of workers including the calling task, 2 .. MIST_PAR_MAXWORKERS
+* @param[in]  Priority     priority of the worker tasks
+* @param[out] N/A
+*
+* @retval     != NULL .. pointer to the pool
+* @retval     = NULL  .. ERROR
+*******************************************************************************/
+MIST_PAR *mist_ParCreate(const CHAR * pName, UINT32 NbOfWorkers, UINT32 Priority)
+{
+    MIST_PAR *pPar;
+    PAR_WORKER *pWorker;
+    CHAR    TaskName[M_TSKNAMELEN_A];
+    UINT32  i;
+    CHAR    Func[] = "mist_ParCreate";
+
+    if ((NbOfWorkers < 2) || (NbOfWorkers > MIST_PAR_MAXWORKERS))
+    {
+        LOG_E(0, Func, "Invalid number of workers %u for task %s!", NbOfWorkers, pName);
+        return (NULL);
+    }
+
+    pPar = calloc(1, sizeof(MIST_PAR));
+    if (!pPar)
+    {
+        LOG_E(0, Func, "No memory for the worker pool of task %s!", pName);
+        return (NULL);
+    }
+
+    snprintf(pPar->Name, sizeof(pPar->Name), "%s", pName);
+    pPar->NbOfWorkers = NbOfWorkers;
+    pPar->DoneSema = semBCreate(SEM_Q_PRIORITY, SEM_EMPTY);
+    for (i = 0; i < NbOfWorkers; i++)
+    {
+        pPar->Worker[i].pPar = pPar;
+        pPar->Worker[i].Index = i;
+        pPar->Worker[i].TaskId = ERROR;
+    }
+    if (!pPar->DoneSema)
+    {
+        LOG_E(0, Func, "Could not create the barrier semaphore of task %s!", pName);
+        mist_ParDelete(pPar);
+        return (NULL);
+    }
+
+    for (i = 1; i < NbOfWorkers; i++)
+    {
+        pWorker = &pPar->Worker[i];
+        pWorker->StartSema = semBCreate(SEM_Q_PRIORITY, SEM_EMPTY);
+        if (!pWorker->StartSema)
+        {
+            LOG_E(0, Func, "Could not create the start semaphore of worker %u of task %s!", i, pName);
+            mist_ParDelete(pPar);
+            return (NULL);
+        }
+
+        /* Task name: name of the calling task, shortened, and worker number */
+        snprintf(TaskName, sizeof(TaskName), "%.9s_%u", pName, i);
+        pWorker->TaskId = sys_TaskSpawn(mist_AppName, TaskName, Priority, VX_FP_TASK, 10000,
+                                        (FUNCPTR) Par_Main, pWorker);
+        if (pWorker->TaskId == ERROR)
+        {
+            LOG_E(0, Func, "Error in sys_TaskSpawn for worker task '%s'!", TaskName);
+            mist_ParDelete(pPar);
+            return (NULL);
+        }
+    }
+
+    return (pPar);
+}
+
+/**
+********************************************************************************
+* @brief Ends the worker tasks and releases the pool. Must not be called
+*        while mist_ParRun() is running.
+*
+* @param[in]  pPar     pool, NULL is ignored
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_ParDelete(MIST_PAR * pPar)
+{
+    PAR_WORKER *pWorker;
+    UINT32  RequestTime;
+    UINT32  Running;
+    UINT32  i;
+    CHAR    Func[] = "mist_ParDelete";
+
+    if (!pPar)
+        return;
+
+    /* Wake up the worker tasks, they end themselves */
+    pPar->Quit = TRUE;
+    MIST_BARRIER();
+    for (i = 1; i < pPar->NbOfWorkers; i++)
+    {
+        if (pPar->Worker[i].StartSema)
+            semGive(pPar->Worker[i].StartSema);
+    }
+
+    /* Wait up to 100ms, then delete the remaining ones */
+    RequestTime = m_GetProcTime();
+    do
+    {
+        Running = 0;
+        for (i = 1; i < pPar->NbOfWorkers; i++)
+        {
+            if ((pPar->Worker[i].TaskId != ERROR) && (taskIdVerify(pPar->Worker[i].TaskId) == OK))
+                Running++;
+        }
+        if (Running)
+            taskDelay(1);
+    }
+    while (Running && ((m_GetProcTime() - RequestTime) < 100000));
+
+    for (i = 1; i < pPar->NbOfWorkers; i++)
+    {
+        pWorker = &pPar->Worker[i];
+        if ((pWorker->TaskId != ERROR) && (taskIdVerify(pWorker->TaskId) == OK))
+        {
+            LOG_W(0, Func, "Worker %u of task %s had to be deleted!", i, pPar->Name);
+            taskDelete(pWorker->TaskId);
+        }
+        if (pWorker->StartSema)
+            semDelete(pWorker->StartSema);
+    }
+
+    if (pPar->DoneSema)
+        semDelete(pPar->DoneSema);
+    free(pPar);
+}
+
+/**
+********************************************************************************
+* @brief Executes the jobs 0 .. NbOfJobs - 1 on the workers of the pool,
+*        the calling task takes part as worker 0. Returns when all jobs
+*        have been executed. More than MIST_PAR_MAXJOBS jobs per worker are
+*        executed in several runs.
+*
+* @param[in]  pPar     pool
+* @param[in]  NbOfJobs number of jobs
+* @param[in]  pFunc    job function, called with pArg, the job and the worker
+* @param[in]  pArg     argument of pFunc
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_ParRun(MIST_PAR * pPar, UINT32 NbOfJobs, MIST_PAR_FUNC pFunc, VOID * pArg)
+{
+    PAR_WORKER *pWorker;
+    UINT32  First = 0;
+    UINT32  Count;
+    UINT32  Job;
+    UINT32  i;
+
+    pPar->pFunc = pFunc;
+    pPar->pArg = pArg;
+
+    while (First < NbOfJobs)
+    {
+        Count = NbOfJobs - First;
+        if (Count > pPar->NbOfWorkers * MIST_PAR_MAXJOBS)
+            Count = pPar->NbOfWorkers * MIST_PAR_MAXJOBS;
+
+        /* Deal the jobs out, no worker task is running now */
+        for (i = 0; i < pPar->NbOfWorkers; i++)
+        {
+            pPar->Worker[i].Top = 0;
+            pPar->Worker[i].Bottom = 0;
+        }
+        for (Job = First; Job < First + Count; Job++)
+        {
+            pWorker = &pPar->Worker[(Job - First) % pPar->NbOfWorkers];
+            pWorker->Job[pWorker->Bottom++] = Job;
+        }
+        pPar->NbOfArrived = 0;
+        MIST_BARRIER();
+
+        for (i = 1; i < pPar->NbOfWorkers; i++)
+            semGive(pPar->Worker[i].StartSema);
+
+        Par_Work(&pPar->Worker[0]);
+        semTake(pPar->DoneSema, WAIT_FOREVER);
+        First += Count;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Number of workers of a pool, including the calling task.
+*
+* @param[in]  pPar     pool
+* @param[out] N/A
+*
+* @retval     number of workers
+*******************************************************************************/
+UINT32 mist_ParWorkers(const MIST_PAR * pPar)
+{
+    return (pPar->NbOfWorkers);
+}
+
+/**
+********************************************************************************
+* @brief Main entry function of a worker task.
+*        The input parameter is being passed by the task spawn call.
+*
+* @param[in]  pWorker  worker
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Par_Main(PAR_WORKER * pWorker)
+{
+    MIST_PAR *pPar = pWorker->pPar;
+
+    for (;;)
+    {
+        semTake(pWorker->StartSema, WAIT_FOREVER);
+        if (pPar->Quit)
+            break;
+        Par_Work(pWorker);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Executes jobs until all deques are empty, then arrives at the
+*        barrier. The last worker arriving releases the calling task.
+*
+* @param[in]  pWorker  worker
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Par_Work(PAR_WORKER * pWorker)
+{
+    MIST_PAR *pPar = pWorker->pPar;
+    UINT32  Job;
+
+    for (;;)
+    {
+        Job = Par_Take(pWorker);
+        if (Job == PAR_NOJOB)
+        {
+            Job = Par_Steal(pWorker);
+            if (Job == PAR_NOJOB)
+                break;
+            pWorker->NbOfSteals++;
+        }
+        pPar->pFunc(pPar->pArg, Job, pWorker->Index);
+        pWorker->NbOfJobs++;
+    }
+
+    if (MIST_FETCH_INC(&pPar->NbOfArrived) + 1 == pPar->NbOfWorkers)
+        semGive(pPar->DoneSema);
+}
+
+/**
+********************************************************************************
+* @brief Takes the job at the bottom of the own deque.
+*
+* @param[in]  pWorker  worker
+* @param[out] N/A
+*
+* @retval     job, PAR_NOJOB = deque is empty
+*******************************************************************************/
+MLOCAL UINT32 Par_Take(PAR_WORKER * pWorker)
+{
+    SINT32  Bottom = pWorker->Bottom - 1;
+    SINT32  Top;
+    UINT32  Job;
+
+    pWorker->Bottom = Bottom;
+    MIST_BARRIER();
+    Top = pWorker->Top;
+
+    if (Bottom < Top)
+    {
+        pWorker->Bottom = Top;
+        return (PAR_NOJOB);
+    }
+
+    Job = pWorker->Job[Bottom];
+    if (Bottom > Top)
+        return (Job);
+
+    /* Last job, thieves may take it at the same time */
+    if (!MIST_CAS(&pWorker->Top, Top, Top + 1))
+        Job = PAR_NOJOB;
+    pWorker->Bottom = Top + 1;
+    return (Job);
+}
+
+/**
+********************************************************************************
+* @brief Steals the job at the top of the deque of another worker.
+*
+* @param[in]  pVictim  worker to steal from
+* @param[out] pJob     job, if PAR_STOLEN
+*
+* @retval     PAR_EMPTY, PAR_STOLEN, PAR_LOST
+*******************************************************************************/
+MLOCAL UINT32 Par_StealFrom(PAR_WORKER * pVictim, UINT32 * pJob)
+{
+    SINT32  Top = pVictim->Top;
+    SINT32  Bottom;
+
+    MIST_BARRIER();
+    Bottom = pVictim->Bottom;
+    if (Top >= Bottom)
+        return (PAR_EMPTY);
+
+    *pJob = pVictim->Job[Top];
+    if (!MIST_CAS(&pVictim->Top, Top, Top + 1))
+        return (PAR_LOST);
+    return (PAR_STOLEN);
+}
+
+/**
+********************************************************************************
+* @brief Steals a job from the other workers, starting with the next one.
+*        Gives up only when all deques have been seen empty.
+*
+* @param[in]  pWorker  worker looking for a job
+* @param[out] N/A
+*
+* @retval     job, PAR_NOJOB = no jobs left
+*******************************************************************************/
+MLOCAL UINT32 Par_Steal(PAR_WORKER * pWorker)
+{
+    MIST_PAR *pPar = pWorker->pPar;
+    UINT32  Job;
+    UINT32  Lost;
+    UINT32  i;
+
+    do
+    {
+        Lost = FALSE;
+        for (i = 1; i < pPar->NbOfWorkers; i++)
+        {
+            switch (Par_StealFrom(&pPar->Worker[(pWorker->Index + i) % pPar->NbOfWorkers], &Job))
+            {
+                case PAR_STOLEN:
+                    return (Job);
+                case PAR_LOST:
+                    Lost = TRUE;
+                    break;
+            }
+        }
+    }
+    while (Lost);
+
+    return (PAR_NOJOB);
+}
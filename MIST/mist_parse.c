@@ -0,0 +1,1845 @@
+/**
+********************************************************************************
+* @file     mist_parse.c
+* @author   Bachmann electronic GmbH
+* @version  $Revision: 3.90 $ $LastChangedBy: BE $
+* @date     $LastChangeDate: 2013-06-10 11:00:00 $
+*
+* @brief    This file contains the recursive descent parser of the
+*           Structured Text (ST) front end and the arena allocator for the
+*           syntax tree.
+*
+*           The parser reads the tokens of mist_LexNext() and builds one
+*           MIST_POU per PROGRAM with its variables and statements. All POUs,
+*           variables, nodes and names are taken from a single bump arena of
+*           the compilation unit. There is no malloc per node, the complete
+*           unit is released with one call of mist_UnitFree().
+*
+*           Pragmas are ignored except {attribute 'svi' := 'r' | 'rw' |
+*           'none'} directly in front of a declaration, which selects the
+*           export of the variables to the SVI (see mist_SviExport()).
+*
+*           Operator precedence, from highest to lowest:
+*           function call, **, unary - and NOT, * / MOD, + -,
+*           < > <= >=, = <>, AND, XOR, OR.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+
+/* Project includes */
+#include "mist_int.h"
+#include "mist_prg.h"
+
+/* Binding strength of the binary operators, 0 = no binary operator */
+#define PAR_PREC_OR      1
+#define PAR_PREC_XOR     2
+#define PAR_PREC_AND     3
+#define PAR_PREC_EQU     4
+#define PAR_PREC_CMP     5
+#define PAR_PREC_ADD     6
+#define PAR_PREC_MUL     7
+
+/* Max. length of a number literal without underscores */
+#define PAR_NUMLEN       64
+
+/* Max. length of a pragma evaluated by Par_Attribute() */
+#define PAR_PRAGMALEN    64
+
+/* Max. nesting depth of expressions and statement lists, bounds the stack used by the recursion */
+#define PAR_MAXDEPTH     32
+
+/* Levels of a statement list, compiling a statement needs about twice the stack of an operand */
+#define PAR_STMTLEVELS   2
+
+/* Max. number of binary operators along the first operands, see mist_NodeChain() */
+#define PAR_MAXCHAIN     1024
+
+/* Parser state */
+typedef struct PARSER
+{
+    MIST_LEXER Lex;                     /* lexer state */
+    MIST_TOKEN Tok;                     /* current token */
+    MIST_TOKEN Pragma;                  /* pragma directly in front of the current token, Length 0 = none */
+    const CHAR *pSrc;                   /* source buffer */
+    MIST_UNIT *pUnit;                   /* compilation unit being built */
+    MIST_POU *pPou;                     /* POU being parsed */
+    MIST_VAR *pLastVar;                 /* last variable of the POU, for appending */
+    UINT32  LoopDepth;                  /* nesting depth of FOR, WHILE and REPEAT */
+    UINT32  Depth;                      /* nesting depth of expressions and statement lists, see Par_Enter() */
+    UINT32  Error;                      /* an error occurred, parsing is aborted */
+    MIST_NODE Dummy;                    /* returned instead of a node if out of memory */
+} PARSER;
+
+/* Binding strength of binary operators, index is MIST_OP_xxx */
+MLOCAL const UINT8 ParPrec[MIST_OP_NOT + 1] = {
+    [MIST_OP_MUL] = PAR_PREC_MUL, [MIST_OP_DIV] = PAR_PREC_MUL, [MIST_OP_MOD] = PAR_PREC_MUL,
+    [MIST_OP_ADD] = PAR_PREC_ADD, [MIST_OP_SUB] = PAR_PREC_ADD,
+    [MIST_OP_EQ] = PAR_PREC_EQU, [MIST_OP_NE] = PAR_PREC_EQU,
+    [MIST_OP_LT] = PAR_PREC_CMP, [MIST_OP_LE] = PAR_PREC_CMP,
+    [MIST_OP_GT] = PAR_PREC_CMP, [MIST_OP_GE] = PAR_PREC_CMP,
+    [MIST_OP_AND] = PAR_PREC_AND, [MIST_OP_XOR] = PAR_PREC_XOR, [MIST_OP_OR] = PAR_PREC_OR
+};
+
+/* Functions: parser, being called only within this file */
+MLOCAL VOID Par_Error(PARSER * p, UINT32 Offset, const CHAR * pFmt, ...);
+MLOCAL VOID Par_Next(PARSER * p);
+MLOCAL BOOL Par_IsKw(PARSER * p, UINT32 Id);
+MLOCAL BOOL Par_IsOp(PARSER * p, UINT32 Id);
+MLOCAL BOOL Par_IsPu(PARSER * p, UINT32 Id);
+MLOCAL VOID Par_ExpectKw(PARSER * p, UINT32 Id, const CHAR * pText);
+MLOCAL VOID Par_ExpectPu(PARSER * p, UINT32 Id, const CHAR * pText);
+MLOCAL BOOL Par_Enter(PARSER * p, UINT32 Levels);
+MLOCAL VOID *Par_Alloc(PARSER * p, UINT32 Size);
+MLOCAL MIST_NODE *Par_Node(PARSER * p, UINT32 Type, UINT32 Offset);
+MLOCAL CHAR *Par_Name(PARSER * p, const MIST_TOKEN * pTok);
+MLOCAL BOOL Par_SameName(const CHAR * pStr, UINT32 Length, const CHAR * pName);
+MLOCAL UINT32 Par_Hash(const CHAR * pName, UINT32 Length);
+MLOCAL SINT32 Par_IntValue(PARSER * p, const CHAR * pStr, UINT32 Length, SINT32 * pValue);
+MLOCAL SINT32 Par_RealValue(PARSER * p, const CHAR * pStr, UINT32 Length, REAL64 * pValue);
+MLOCAL SINT32 Par_TimeValue(PARSER * p, const CHAR * pStr, UINT32 Length, SINT32 * pValue);
+MLOCAL MIST_NODE *Par_Typed(PARSER * p);
+MLOCAL MIST_NODE *Par_Variable(PARSER * p, const MIST_TOKEN * pName);
+MLOCAL MIST_NODE *Par_Primary(PARSER * p);
+MLOCAL MIST_NODE *Par_Power(PARSER * p);
+MLOCAL MIST_NODE *Par_Unary(PARSER * p);
+MLOCAL MIST_NODE *Par_Expr(PARSER * p, UINT32 MinPrec);
+MLOCAL SINT32 Par_ConstInt(PARSER * p);
+MLOCAL MIST_NODE *Par_StmtList(PARSER * p);
+MLOCAL MIST_NODE *Par_Stmt(PARSER * p);
+MLOCAL MIST_NODE *Par_If(PARSER * p);
+MLOCAL MIST_NODE *Par_Case(PARSER * p);
+MLOCAL MIST_NODE *Par_For(PARSER * p);
+MLOCAL UINT32 Par_Attribute(PARSER * p, UINT32 Class, UINT32 Flags);
+MLOCAL VOID Par_VarDecl(PARSER * p, UINT32 Class, UINT32 Flags);
+MLOCAL VOID Par_VarSection(PARSER * p);
+MLOCAL VOID Par_Pou(PARSER * p);
+
+/* Functions: test functions, to be called from the shell */
+SINT32  mist_ParseFile(CHAR * pFileName, UINT32 Loops);
+
+
+/**
+********************************************************************************
+* @brief Initializes an arena. No memory is allocated before the first
+*        call of mist_ArenaAlloc().
+*
+* @param[in]  pArena   pointer to arena
+* @param[in]  BlkSize  size of a regular block in bytes, 0 = MIST_ARENA_BLKSIZE
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_ArenaInit(MIST_ARENA * pArena, UINT32 BlkSize)
+{
+    pArena->pBlk = NULL;
+    pArena->BlkSize = BlkSize ? BlkSize : MIST_ARENA_BLKSIZE;
+    pArena->NbOfBytes = 0;
+}
+
+/**
+********************************************************************************
+* @brief Allocates zero initialized memory from an arena.
+*        The memory is aligned to MIST_ARENA_ALIGN and can't be freed
+*        individually. Requests larger than a quarter block get a block of
+*        their own, so that the current block can still be used.
+*
+* @param[in]  pArena   pointer to arena
+* @param[in]  Size     number of bytes
+* @param[out] N/A
+*
+* @retval     != NULL .. pointer to memory
+* @retval     = NULL  .. out of memory
+*******************************************************************************/
+VOID   *mist_ArenaAlloc(MIST_ARENA * pArena, UINT32 Size)
+{
+    MIST_ARENA_BLK *pBlk = pArena->pBlk;
+    UINT8  *pMem;
+
+    Size = (Size + MIST_ARENA_ALIGN - 1) & ~(MIST_ARENA_ALIGN - 1);
+
+    if (!pBlk || (Size > pBlk->Size - pBlk->Used))
+    {
+        if (pBlk && (Size > pArena->BlkSize / 4))
+        {
+            /* Own block, linked behind the current one */
+            pMem = calloc(1, sizeof(MIST_ARENA_BLK) + Size);
+            if (!pMem)
+                return (NULL);
+            ((MIST_ARENA_BLK *) pMem)->Size = Size;
+            ((MIST_ARENA_BLK *) pMem)->Used = Size;
+            ((MIST_ARENA_BLK *) pMem)->pNext = pBlk->pNext;
+            pBlk->pNext = (MIST_ARENA_BLK *) pMem;
+            pArena->NbOfBytes += Size;
+            return (pMem + sizeof(MIST_ARENA_BLK));
+        }
+
+        pBlk = calloc(1, sizeof(MIST_ARENA_BLK) + ((Size > pArena->BlkSize) ? Size : pArena->BlkSize));
+        if (!pBlk)
+            return (NULL);
+        pBlk->Size = (Size > pArena->BlkSize) ? Size : pArena->BlkSize;
+        pBlk->pNext = pArena->pBlk;
+        pArena->pBlk = pBlk;
+    }
+
+    pMem = (UINT8 *) (pBlk + 1) + pBlk->Used;
+    pBlk->Used += Size;
+    pArena->NbOfBytes += Size;
+    return (pMem);
+}
+
+/**
+********************************************************************************
+* @brief Releases all memory of an arena at once.
+*        The arena can be used again afterwards.
+*
+* @param[in]  pArena   pointer to arena
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_ArenaFree(MIST_ARENA * pArena)
+{
+    MIST_ARENA_BLK *pBlk;
+
+    while (pArena->pBlk)
+    {
+        pBlk = pArena->pBlk;
+        pArena->pBlk = pBlk->pNext;
+        free(pBlk);
+    }
+    pArena->NbOfBytes = 0;
+}
+
+/**
+********************************************************************************
+* @brief Records the first error and aborts parsing.
+*        The current token is set to MIST_TK_EOF, so that all loops of the
+*        parser terminate without further checks.
+*
+* @param[in]  p        pointer to parser state
+* @param[in]  Offset   source offset of the error
+* @param[in]  pFmt     format string of the error text, followed by arguments
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Par_Error(PARSER * p, UINT32 Offset, const CHAR * pFmt, ...)
+{
+    va_list Args;
+
+    if (!p->Error)
+    {
+        p->Error = TRUE;
+        p->pUnit->ErrLine = mist_LexLine(p->pSrc, Offset);
+        va_start(Args, pFmt);
+        vsnprintf(p->pUnit->ErrText, sizeof(p->pUnit->ErrText), pFmt, Args);
+        va_end(Args);
+    }
+    p->Tok.Kind = MIST_TK_EOF;
+    p->Tok.Id = 0;
+}
+
+/**
+********************************************************************************
+* @brief Advances to the next token. After an error MIST_TK_EOF is kept.
+*        Pragmas are skipped, the last one in front of the new token is
+*        kept for Par_Attribute().
+*
+* @param[in]  p        pointer to parser state
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Par_Next(PARSER * p)
+{
+    UINT32  Length;
+
+    if (p->Error)
+        return;
+
+    p->Pragma.Length = 0;
+    while (mist_LexNext(&p->Lex, &p->Tok) == MIST_TK_PRAGMA)
+        p->Pragma = p->Tok;
+
+    if (p->Tok.Kind == MIST_TK_ERROR)
+    {
+        /* Only the first line of an unterminated comment or string */
+        for (Length = 0; (Length < p->Tok.Length) && (p->pSrc[p->Tok.Offset + Length] != '\n') &&
+             (p->pSrc[p->Tok.Offset + Length] != '\r'); Length++)
+            ;
+        Par_Error(p, p->Tok.Offset, "invalid character or unterminated comment or string '%.*s'",
+                  (int) Length, p->pSrc + p->Tok.Offset);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Token checks: current token is the given keyword, operator or
+*        punctuator.
+*
+* @param[in]  p        pointer to parser state
+* @param[in]  Id       keyword, operator or punctuator id
+* @param[out] N/A
+*
+* @retval     TRUE, FALSE
+*******************************************************************************/
+MLOCAL BOOL Par_IsKw(PARSER * p, UINT32 Id)
+{
+    return ((p->Tok.Kind == MIST_TK_KEYWORD) && (p->Tok.Id == Id));
+}
+
+MLOCAL BOOL Par_IsOp(PARSER * p, UINT32 Id)
+{
+    return ((p->Tok.Kind == MIST_TK_OPERATOR) && (p->Tok.Id == Id));
+}
+
+MLOCAL BOOL Par_IsPu(PARSER * p, UINT32 Id)
+{
+    return ((p->Tok.Kind == MIST_TK_PUNCT) && (p->Tok.Id == Id));
+}
+
+/**
+********************************************************************************
+* @brief Consumes the given keyword or punctuator, any other token is an error.
+*
+* @param[in]  p        pointer to parser state
+* @param[in]  Id       keyword or punctuator id
+* @param[in]  pText    visible text of the expected token
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Par_ExpectKw(PARSER * p, UINT32 Id, const CHAR * pText)
+{
+    if (Par_IsKw(p, Id))
+        Par_Next(p);
+    else
+        Par_Error(p, p->Tok.Offset, "'%s' expected instead of '%.*s'", pText,
+                  (int) p->Tok.Length, p->pSrc + p->Tok.Offset);
+}
+
+MLOCAL VOID Par_ExpectPu(PARSER * p, UINT32 Id, const CHAR * pText)
+{
+    if (Par_IsPu(p, Id))
+        Par_Next(p);
+    else
+        Par_Error(p, p->Tok.Offset, "'%s' expected instead of '%.*s'", pText,
+                  (int) p->Tok.Length, p->pSrc + p->Tok.Offset);
+}
+
+/**
+********************************************************************************
+* @brief Enters a nested expression or statement list. The parser and
+*        the walks of the compiler recurse into nested operands and
+*        statements, so the nesting is limited to PAR_MAXDEPTH levels to
+*        bound their stack; a deeper nesting is a parse error. Chains of
+*        operators and ELSIF are built and walked in loops, they don't
+*        nest.
+*
+* @param[in]  p        pointer to parser state
+* @param[in]  Levels   levels of the construct, 1 or PAR_STMTLEVELS
+* @param[out] N/A
+*
+* @retval     TRUE .. entered, the caller subtracts Levels from p->Depth when leaving
+* @retval     FALSE .. too deep, error reported
+*******************************************************************************/
+MLOCAL BOOL Par_Enter(PARSER * p, UINT32 Levels)
+{
+    if (p->Depth + Levels > PAR_MAXDEPTH)
+    {
+        Par_Error(p, p->Tok.Offset, "statements or expressions nested too deeply");
+        return (FALSE);
+    }
+    p->Depth += Levels;
+    return (TRUE);
+}
+
+/**
+********************************************************************************
+* @brief Allocates memory from the arena of the compilation unit.
+*        If the arena is exhausted, an error is recorded and the dummy node
+*        of the parser is returned, so that callers need no checks.
+*        The result is discarded anyway after an error.
+*
+* @param[in]  p        pointer to parser state
+* @param[in]  Size     number of bytes, max. sizeof(MIST_NODE) on error
+* @param[out] N/A
+*
+* @retval     pointer to zero initialized memory
+*******************************************************************************/
+MLOCAL VOID *Par_Alloc(PARSER * p, UINT32 Size)
+{
+    VOID   *pMem = mist_ArenaAlloc(&p->pUnit->Arena, Size);
+
+    if (!pMem)
+    {
+        Par_Error(p, p->Tok.Offset, "out of memory");
+        memset(&p->Dummy, 0, sizeof(p->Dummy));
+        pMem = &p->Dummy;
+    }
+    return (pMem);
+}
+
+/**
+********************************************************************************
+* @brief Creates a syntax tree node.
+*
+* @param[in]  p        pointer to parser state
+* @param[in]  Type     node type MIST_N_xxx
+* @param[in]  Offset   source offset of the first token
+* @param[out] N/A
+*
+* @retval     pointer to node
+*******************************************************************************/
+MLOCAL MIST_NODE *Par_Node(PARSER * p, UINT32 Type, UINT32 Offset)
+{
+    MIST_NODE *pNode = Par_Alloc(p, sizeof(MIST_NODE));
+
+    pNode->Type = Type;
+    pNode->Offset = Offset;
+    p->pUnit->NbOfNodes++;
+    return (pNode);
+}
+
+/**
+********************************************************************************
+* @brief Copies an identifier into the arena as terminated string.
+*        Names are copied, so that the syntax tree does not depend on the
+*        source buffer.
+*
+* @param[in]  p        pointer to parser state
+* @param[in]  pTok     identifier token
+* @param[out] N/A
+*
+* @retval     pointer to name
+*******************************************************************************/
+MLOCAL CHAR *Par_Name(PARSER * p, const MIST_TOKEN * pTok)
+{
+    CHAR   *pName = mist_ArenaAlloc(&p->pUnit->Arena, pTok->Length + 1);
+
+    if (!pName)
+    {
+        Par_Error(p, pTok->Offset, "out of memory");
+        return ("");
+    }
+    memcpy(pName, p->pSrc + pTok->Offset, pTok->Length);
+    pName[pTok->Length] = 0;
+    return (pName);
+}
+
+/**
+********************************************************************************
+* @brief Compares an identifier in the source with a name, case insensitive.
+*        Identifiers only consist of letters, digits and '_', clearing bit 5
+*        maps lower to upper case letters without mixing up other characters.
+*
+* @param[in]  pStr     pointer to identifier, not necessarily terminated
+* @param[in]  Length   length of identifier
+* @param[in]  pName    terminated name
+* @param[out] N/A
+*
+* @retval     TRUE, FALSE
+*******************************************************************************/
+MLOCAL BOOL Par_SameName(const CHAR * pStr, UINT32 Length, const CHAR * pName)
+{
+    UINT32  i;
+
+    for (i = 0; i < Length; i++)
+    {
+        if (((UINT8) pStr[i] & 0xDF) != ((UINT8) pName[i] & 0xDF))
+            return (FALSE);
+    }
+    return (pName[Length] == 0);
+}
+
+/**
+********************************************************************************
+* @brief Case insensitive hash of an identifier, see Par_SameName().
+*
+* @param[in]  pName    pointer to first character
+* @param[in]  Length   length of identifier
+* @param[out] N/A
+*
+* @retval     hash value, 0 .. MIST_VAR_HASHSIZE - 1
+*******************************************************************************/
+MLOCAL UINT32 Par_Hash(const CHAR * pName, UINT32 Length)
+{
+    UINT32  Hash = 2166136261u;
+    UINT32  i;
+
+    for (i = 0; i < Length; i++)
+        Hash = (Hash ^ ((UINT8) pName[i] & 0xDF)) * 16777619u;
+
+    return ((Hash ^ (Hash >> 16)) & (MIST_VAR_HASHSIZE - 1));
+}
+
+/**
+********************************************************************************
+* @brief Searches a variable of a POU by name, case insensitive.
+*
+* @param[in]  pPou     pointer to POU
+* @param[in]  pName    pointer to name, not necessarily terminated
+* @param[in]  Length   length of name
+* @param[out] N/A
+*
+* @retval     != NULL .. pointer to variable
+* @retval     = NULL  .. not declared
+*******************************************************************************/
+MIST_VAR *mist_VarFind(const MIST_POU * pPou, const CHAR * pName, UINT32 Length)
+{
+    MIST_VAR *pVar;
+
+    for (pVar = pPou->ppVarHash[Par_Hash(pName, Length)]; pVar; pVar = pVar->pHashNext)
+    {
+        if (Par_SameName(pName, Length, pVar->pName))
+            return (pVar);
+    }
+    return (NULL);
+}
+
+/**
+********************************************************************************
+* @brief Counts the binary operators along the first operands of an
+*        expression. Operator chains are built left-deep, a + b + c is
+*        ((a + b) + c), so a long chain is a long line of first operands.
+*        Walks of the syntax tree process this line in a loop from the
+*        bottom with mist_NodeLeft() instead of recursing into it.
+*
+* @param[in]  pNode    expression
+* @param[out] N/A
+*
+* @retval     number of MIST_N_BINARY nodes, 0 = pNode is no binary node
+*******************************************************************************/
+UINT32 mist_NodeChain(const MIST_NODE * pNode)
+{
+    UINT32  Len = 0;
+
+    for (; pNode->Type == MIST_N_BINARY; pNode = pNode->pA)
+        Len++;
+    return (Len);
+}
+
+/**
+********************************************************************************
+* @brief Returns a node of the line of first operands of an expression,
+*        see mist_NodeChain().
+*
+* @param[in]  pNode    expression
+* @param[in]  Level    number of first operands to descend, max. mist_NodeChain()
+* @param[out] N/A
+*
+* @retval     pointer to node, Level = mist_NodeChain() is the first operand
+*             of the innermost binary node
+*******************************************************************************/
+MIST_NODE *mist_NodeLeft(const MIST_NODE * pNode, UINT32 Level)
+{
+    for (; Level; Level--)
+        pNode = pNode->pA;
+    return ((MIST_NODE *) pNode);
+}
+
+/**
+********************************************************************************
+* @brief Checks if the ELSE part of an IF continues a chain of ELSIF.
+*        ELSIF is a nested IF as the only statement of the ELSE part,
+*        walks of the syntax tree follow such a chain in a loop.
+*
+* @param[in]  pElse    ELSE part of a MIST_N_IF node, NULL = none
+* @param[out] N/A
+*
+* @retval     TRUE, FALSE
+*******************************************************************************/
+BOOL mist_NodeElsif(const MIST_NODE * pElse)
+{
+    return ((pElse != NULL) && (pElse->Type == MIST_N_IF) && (pElse->pNext == NULL));
+}
+
+/**
+********************************************************************************
+* @brief Converts an integer literal, decimal or based (2#, 8#, 16#),
+*        underscores are ignored. Values up to 16#FFFFFFFF are accepted,
+*        larger values are stored as their 32 bit pattern.
+*
+* @param[in]  p        pointer to parser state
+* @param[in]  pStr     pointer to literal
+* @param[in]  Length   length of literal
+* @param[out] pValue   value of literal
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, error has been recorded
+*******************************************************************************/
+MLOCAL SINT32 Par_IntValue(PARSER * p, const CHAR * pStr, UINT32 Length, SINT32 * pValue)
+{
+    UINT64  Value = 0;
+    UINT32  Base = 10;
+    UINT32  Digit;
+    UINT32  i;
+    CHAR    c;
+
+    for (i = 0; i < Length; i++)
+    {
+        c = pStr[i];
+        if (c == '_')
+            continue;
+        if (c == '#')
+        {
+            Base = (UINT32) Value;
+            Value = 0;
+            if ((Base != 2) && (Base != 8) && (Base != 16))
+                break;
+            continue;
+        }
+
+        if ((c >= '0') && (c <= '9'))
+            Digit = c - '0';
+        else if (((c & 0xDF) >= 'A') && ((c & 0xDF) <= 'F'))
+            Digit = (c & 0xDF) - 'A' + 10;
+        else
+            break;
+        if (Digit >= Base)
+            break;
+
+        Value = Value * Base + Digit;
+        if (Value > 0xFFFFFFFFu)
+        {
+            Par_Error(p, p->Tok.Offset, "integer literal '%.*s' out of range", (int) Length, pStr);
+            return (ERROR);
+        }
+    }
+
+    if (i < Length)
+    {
+        Par_Error(p, p->Tok.Offset, "invalid integer literal '%.*s'", (int) Length, pStr);
+        return (ERROR);
+    }
+    *pValue = (SINT32) (UINT32) Value;
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Converts a real literal, underscores are ignored.
+*
+* @param[in]  p        pointer to parser state
+* @param[in]  pStr     pointer to literal
+* @param[in]  Length   length of literal
+* @param[out] pValue   value of literal
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, error has been recorded
+*******************************************************************************/
+MLOCAL SINT32 Par_RealValue(PARSER * p, const CHAR * pStr, UINT32 Length, REAL64 * pValue)
+{
+    CHAR    Buf[PAR_NUMLEN];
+    CHAR   *pEnd;
+    UINT32  i, n = 0;
+
+    for (i = 0; (i < Length) && (n < sizeof(Buf) - 1); i++)
+    {
+        if (pStr[i] != '_')
+            Buf[n++] = pStr[i];
+    }
+    Buf[n] = 0;
+
+    *pValue = strtod(Buf, &pEnd);
+    if ((i < Length) || !n || *pEnd)
+    {
+        Par_Error(p, p->Tok.Offset, "invalid real literal '%.*s'", (int) Length, pStr);
+        return (ERROR);
+    }
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Converts the value of a duration literal to milliseconds,
+*        e.g. 1h30m, 1.5s, 250ms. Units are d, h, m, s, ms, us and ns,
+*        each number may have a fraction.
+*
+* @param[in]  p        pointer to parser state
+* @param[in]  pStr     pointer to value behind the '#'
+* @param[in]  Length   length of value
+* @param[out] pValue   duration in ms
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, error has been recorded
+*******************************************************************************/
+MLOCAL SINT32 Par_TimeValue(PARSER * p, const CHAR * pStr, UINT32 Length, SINT32 * pValue)
+{
+    REAL64  Ms = 0;
+    REAL64  Number;
+    REAL64  Scale;
+    BOOL    Negative = FALSE;
+    BOOL    Digits;
+    UINT32  i = 0;
+    CHAR    c;
+
+    if ((i < Length) && (pStr[i] == '-'))
+    {
+        Negative = TRUE;
+        i++;
+    }
+    if (i >= Length)
+        goto Invalid;
+
+    while (i < Length)
+    {
+        /* Number with optional fraction */
+        Number = 0;
+        Digits = FALSE;
+        for (; (i < Length) && (((pStr[i] >= '0') && (pStr[i] <= '9')) || (pStr[i] == '_')); i++)
+        {
+            if (pStr[i] != '_')
+            {
+                Number = Number * 10 + (pStr[i] - '0');
+                Digits = TRUE;
+            }
+        }
+        if ((i < Length) && (pStr[i] == '.'))
+        {
+            for (Scale = 0.1, i++; (i < Length) && (pStr[i] >= '0') && (pStr[i] <= '9'); i++)
+            {
+                Number += (pStr[i] - '0') * Scale;
+                Scale /= 10;
+                Digits = TRUE;
+            }
+        }
+        if (!Digits || (i >= Length))
+            goto Invalid;
+
+        /* Unit */
+        c = pStr[i++] & 0xDF;
+        if ((i < Length) && ((pStr[i] & 0xDF) == 'S') && ((c == 'M') || (c == 'U') || (c == 'N')))
+        {
+            i++;
+            Ms += Number * ((c == 'M') ? 1.0 : (c == 'U') ? 0.001 : 0.000001);
+        }
+        else if (c == 'D')
+            Ms += Number * 86400000.0;
+        else if (c == 'H')
+            Ms += Number * 3600000.0;
+        else if (c == 'M')
+            Ms += Number * 60000.0;
+        else if (c == 'S')
+            Ms += Number * 1000.0;
+        else
+            goto Invalid;
+
+        if ((i < Length) && (pStr[i] == '_'))
+            i++;
+    }
+
+    if (Ms > 2147483647.0)
+    {
+        Par_Error(p, p->Tok.Offset, "duration '%.*s' out of range", (int) Length, pStr);
+        return (ERROR);
+    }
+    *pValue = (SINT32) (Ms + 0.5);
+    if (Negative)
+        *pValue = -*pValue;
+    return (OK);
+
+  Invalid:
+    Par_Error(p, p->Tok.Offset, "invalid duration '%.*s'", (int) Length, pStr);
+    return (ERROR);
+}
+
+/**
+********************************************************************************
+* @brief Parses a typed literal type#value, e.g. T#10ms, INT#-5, REAL#1.5,
+*        BOOL#TRUE. TIME literals are converted to milliseconds.
+*
+* @param[in]  p        pointer to parser state
+* @param[out] N/A
+*
+* @retval     pointer to literal node
+*******************************************************************************/
+MLOCAL MIST_NODE *Par_Typed(PARSER * p)
+{
+    const CHAR *pStr = p->pSrc + p->Tok.Offset;
+    const CHAR *pVal;
+    MIST_NODE *pNode;
+    UINT32  PrefixLen;
+    UINT32  ValLen;
+    UINT32  Type;
+    UINT32  i;
+
+    for (PrefixLen = 0; pStr[PrefixLen] != '#'; PrefixLen++)
+        ;
+    pVal = pStr + PrefixLen + 1;
+    ValLen = p->Tok.Length - PrefixLen - 1;
+
+    if ((PrefixLen == 1) && ((pStr[0] & 0xDF) == 'T'))
+        Type = MIST_KW_TIME;
+    else
+        Type = mist_LexKeywordId(pStr, PrefixLen);
+
+    pNode = Par_Node(p, MIST_N_INT, p->Tok.Offset);
+    pNode->DataType = Type;
+
+    switch (Type)
+    {
+        case MIST_KW_TIME:
+            Par_TimeValue(p, pVal, ValLen, &pNode->u.Int);
+            break;
+
+        case MIST_KW_BOOL:
+            if (mist_LexKeywordId(pVal, ValLen) == MIST_KW_TRUE)
+                pNode->u.Int = 1;
+            else if (mist_LexKeywordId(pVal, ValLen) != MIST_KW_FALSE)
+            {
+                Par_IntValue(p, pVal, ValLen, &pNode->u.Int);
+                if ((UINT32) pNode->u.Int > 1)
+                    Par_Error(p, p->Tok.Offset, "invalid BOOL literal '%.*s'", (int) p->Tok.Length, pStr);
+            }
+            break;
+
+        case MIST_KW_REAL:
+        case MIST_KW_LREAL:
+            pNode->Type = MIST_N_REAL;
+            Par_RealValue(p, pVal, ValLen, &pNode->u.Real);
+            break;
+
+        case MIST_KW_SINT:
+        case MIST_KW_INT:
+        case MIST_KW_DINT:
+        case MIST_KW_USINT:
+        case MIST_KW_UINT:
+        case MIST_KW_UDINT:
+        case MIST_KW_BYTE:
+        case MIST_KW_WORD:
+        case MIST_KW_DWORD:
+            i = (ValLen && (pVal[0] == '-')) ? 1 : 0;
+            if (Par_IntValue(p, pVal + i, ValLen - i, &pNode->u.Int) < 0)
+                break;
+            if (i)
+                pNode->u.Int = -pNode->u.Int;
+            break;
+
+        default:
+            Par_Error(p, p->Tok.Offset, "typed literal '%.*s' not supported", (int) p->Tok.Length, pStr);
+            break;
+    }
+
+    Par_Next(p);
+    return (pNode);
+}
+
+/**
+********************************************************************************
+* @brief Parses a variable with optional array index: name [ '[' expr {',' expr} ']' ]
+*        The name has already been consumed.
+*
+* @param[in]  p        pointer to parser state
+* @param[in]  pName    identifier token of the name
+* @param[out] N/A
+*
+* @retval     pointer to MIST_N_VAR or MIST_N_INDEX node
+*******************************************************************************/
+MLOCAL MIST_NODE *Par_Variable(PARSER * p, const MIST_TOKEN * pName)
+{
+    MIST_NODE *pNode;
+    MIST_NODE *pIndex;
+    MIST_NODE **ppLast;
+    MIST_VAR *pVar;
+    UINT32  NbOfIdx = 0;
+
+    pVar = mist_VarFind(p->pPou, p->pSrc + pName->Offset, pName->Length);
+    if (!pVar)
+    {
+        Par_Error(p, pName->Offset, "'%.*s' is not declared", (int) pName->Length, p->pSrc + pName->Offset);
+        return (&p->Dummy);
+    }
+    pNode = Par_Node(p, MIST_N_VAR, pName->Offset);
+    pNode->u.pVar = pVar;
+
+    if (!Par_IsPu(p, MIST_PU_LBRACKET))
+        return (pNode);
+
+    if (!pVar->NbOfDims)
+    {
+        Par_Error(p, p->Tok.Offset, "'%s' is no array", pVar->pName);
+        return (pNode);
+    }
+
+    pIndex = Par_Node(p, MIST_N_INDEX, pNode->Offset);
+    pIndex->pA = pNode;
+    ppLast = &pIndex->pB;
+    do
+    {
+        Par_Next(p);
+        *ppLast = Par_Expr(p, PAR_PREC_OR);
+        ppLast = &(*ppLast)->pNext;
+        NbOfIdx++;
+    }
+    while (Par_IsPu(p, MIST_PU_COMMA));
+    Par_ExpectPu(p, MIST_PU_RBRACKET, "]");
+
+    if (!p->Error && (NbOfIdx != pVar->NbOfDims))
+        Par_Error(p, pIndex->Offset, "'%s' needs %u index(es)", pVar->pName, pVar->NbOfDims);
+    return (pIndex);
+}
+
+/**
+********************************************************************************
+* @brief Parses a primary expression: literal, variable, function call
+*        or expression in parentheses.
+*
+* @param[in]  p        pointer to parser state
+* @param[out] N/A
+*
+* @retval     pointer to node
+*******************************************************************************/
+MLOCAL MIST_NODE *Par_Primary(PARSER * p)
+{
+    MIST_NODE *pNode;
+    MIST_NODE **ppLast;
+    MIST_TOKEN Name;
+    const CHAR *pStr = p->pSrc + p->Tok.Offset;
+
+    switch (p->Tok.Kind)
+    {
+        case MIST_TK_INT:
+            pNode = Par_Node(p, MIST_N_INT, p->Tok.Offset);
+            Par_IntValue(p, pStr, p->Tok.Length, &pNode->u.Int);
+            Par_Next(p);
+            return (pNode);
+
+        case MIST_TK_REAL:
+            pNode = Par_Node(p, MIST_N_REAL, p->Tok.Offset);
+            Par_RealValue(p, pStr, p->Tok.Length, &pNode->u.Real);
+            Par_Next(p);
+            return (pNode);
+
+        case MIST_TK_TYPED:
+            return (Par_Typed(p));
+
+        case MIST_TK_KEYWORD:
+            if (Par_IsKw(p, MIST_KW_TRUE) || Par_IsKw(p, MIST_KW_FALSE))
+            {
+                pNode = Par_Node(p, MIST_N_INT, p->Tok.Offset);
+                pNode->DataType = MIST_KW_BOOL;
+                pNode->u.Int = Par_IsKw(p, MIST_KW_TRUE);
+                Par_Next(p);
+                return (pNode);
+            }
+            break;
+
+        case MIST_TK_PUNCT:
+            if (Par_IsPu(p, MIST_PU_LPAREN))
+            {
+                Par_Next(p);
+                pNode = Par_Expr(p, PAR_PREC_OR);
+                Par_ExpectPu(p, MIST_PU_RPAREN, ")");
+                return (pNode);
+            }
+            break;
+
+        case MIST_TK_IDENT:
+            Name = p->Tok;
+            Par_Next(p);
+            if (!Par_IsPu(p, MIST_PU_LPAREN))
+                return (Par_Variable(p, &Name));
+
+            /* Function call, the function itself is resolved by the compiler */
+            pNode = Par_Node(p, MIST_N_CALL, Name.Offset);
+            pNode->u.pName = Par_Name(p, &Name);
+            Par_Next(p);
+            ppLast = &pNode->pA;
+            if (!Par_IsPu(p, MIST_PU_RPAREN))
+            {
+                *ppLast = Par_Expr(p, PAR_PREC_OR);
+                ppLast = &(*ppLast)->pNext;
+                while (Par_IsPu(p, MIST_PU_COMMA))
+                {
+                    Par_Next(p);
+                    *ppLast = Par_Expr(p, PAR_PREC_OR);
+                    ppLast = &(*ppLast)->pNext;
+                }
+            }
+            Par_ExpectPu(p, MIST_PU_RPAREN, ")");
+            return (pNode);
+
+        case MIST_TK_STRING:
+            Par_Error(p, p->Tok.Offset, "string literals are not supported");
+            return (&p->Dummy);
+    }
+
+    Par_Error(p, p->Tok.Offset, "expression expected instead of '%.*s'", (int) p->Tok.Length, pStr);
+    return (&p->Dummy);
+}
+
+/**
+********************************************************************************
+* @brief Parses an exponentiation: primary {'**' primary}, left associative.
+*
+* @param[in]  p        pointer to parser state
+* @param[out] N/A
+*
+* @retval     pointer to node
+*******************************************************************************/
+MLOCAL MIST_NODE *Par_Power(PARSER * p)
+{
+    MIST_NODE *pLeft = Par_Primary(p);
+    MIST_NODE *pNode;
+    UINT32  Len = mist_NodeChain(pLeft);
+
+    while (Par_IsOp(p, MIST_OP_POW))
+    {
+        if (++Len > PAR_MAXCHAIN)
+        {
+            Par_Error(p, p->Tok.Offset, "more than %u operators in a row", PAR_MAXCHAIN);
+            break;
+        }
+        pNode = Par_Node(p, MIST_N_BINARY, pLeft->Offset);
+        pNode->Op = MIST_OP_POW;
+        pNode->pA = pLeft;
+        Par_Next(p);
+        pNode->pB = Par_Primary(p);
+        pLeft = pNode;
+    }
+    return (pLeft);
+}
+
+/**
+********************************************************************************
+* @brief Parses a unary expression: {'-' | '+' | NOT} power.
+*        A negated literal is folded into the literal, so that the smallest
+*        DINT value and negative CASE labels can be written directly.
+*
+* @param[in]  p        pointer to parser state
+* @param[out] N/A
+*
+* @retval     pointer to node
+*******************************************************************************/
+MLOCAL MIST_NODE *Par_Unary(PARSER * p)
+{
+    MIST_NODE *pNode;
+    MIST_NODE *pUnary;
+    UINT32  Offset = p->Tok.Offset;
+    UINT32  Op;
+
+    if (!Par_IsOp(p, MIST_OP_ADD) && !Par_IsOp(p, MIST_OP_SUB) && !Par_IsOp(p, MIST_OP_NOT))
+        return (Par_Power(p));
+
+    Op = p->Tok.Id;
+    Par_Next(p);
+    if (!Par_Enter(p, 1))
+        return (&p->Dummy);
+    pNode = Par_Unary(p);
+    p->Depth--;
+
+    if (Op == MIST_OP_ADD)
+        return (pNode);
+    if ((Op == MIST_OP_SUB) && (pNode->Type == MIST_N_INT) && (pNode->DataType != MIST_KW_BOOL))
+    {
+        pNode->u.Int = (SINT32) (0u - (UINT32) pNode->u.Int);
+        pNode->Offset = Offset;
+        return (pNode);
+    }
+    if ((Op == MIST_OP_SUB) && (pNode->Type == MIST_N_REAL))
+    {
+        pNode->u.Real = -pNode->u.Real;
+        pNode->Offset = Offset;
+        return (pNode);
+    }
+
+    pUnary = Par_Node(p, MIST_N_UNARY, Offset);
+    pUnary->Op = Op;
+    pUnary->pA = pNode;
+    return (pUnary);
+}
+
+/**
+********************************************************************************
+* @brief Parses a binary expression by precedence climbing.
+*        Operators binding at least as strong as MinPrec are consumed,
+*        all binary operators are left associative. A chain like
+*        a + b + c is built in the loop, its length is limited to
+*        PAR_MAXCHAIN operators.
+*
+* @param[in]  p        pointer to parser state
+* @param[in]  MinPrec  weakest binding operator to be consumed, PAR_PREC_xxx (> 0)
+* @param[out] N/A
+*
+* @retval     pointer to node
+*******************************************************************************/
+MLOCAL MIST_NODE *Par_Expr(PARSER * p, UINT32 MinPrec)
+{
+    MIST_NODE *pLeft;
+    MIST_NODE *pNode;
+    UINT32  Prec;
+    UINT32  Len;
+
+    if (!Par_Enter(p, 1))
+        return (&p->Dummy);
+
+    pLeft = Par_Unary(p);
+    Len = mist_NodeChain(pLeft);
+    while ((p->Tok.Kind == MIST_TK_OPERATOR) && (p->Tok.Id <= MIST_OP_NOT) &&
+           ((Prec = ParPrec[p->Tok.Id]) >= MinPrec))
+    {
+        if (++Len > PAR_MAXCHAIN)
+        {
+            Par_Error(p, p->Tok.Offset, "more than %u operators in a row", PAR_MAXCHAIN);
+            break;
+        }
+        pNode = Par_Node(p, MIST_N_BINARY, pLeft->Offset);
+        pNode->Op = p->Tok.Id;
+        pNode->pA = pLeft;
+        Par_Next(p);
+        pNode->pB = Par_Expr(p, Prec + 1);
+        pLeft = pNode;
+    }
+    p->Depth--;
+    return (pLeft);
+}
+
+/**
+********************************************************************************
+* @brief Parses a signed integer constant, e.g. an array bound.
+*
+* @param[in]  p        pointer to parser state
+* @param[out] N/A
+*
+* @retval     value of the constant
+*******************************************************************************/
+MLOCAL SINT32 Par_ConstInt(PARSER * p)
+{
+    SINT32  Value = 0;
+    BOOL    Negative = FALSE;
+
+    if (Par_IsOp(p, MIST_OP_SUB))
+    {
+        Negative = TRUE;
+        Par_Next(p);
+    }
+    if (p->Tok.Kind != MIST_TK_INT)
+    {
+        Par_Error(p, p->Tok.Offset, "integer constant expected instead of '%.*s'",
+                  (int) p->Tok.Length, p->pSrc + p->Tok.Offset);
+        return (0);
+    }
+    Par_IntValue(p, p->pSrc + p->Tok.Offset, p->Tok.Length, &Value);
+    Par_Next(p);
+    return (Negative ? -Value : Value);
+}
+
+/**
+********************************************************************************
+* @brief Parses a list of statements. The list ends in front of the first
+*        token which can't start a statement, the caller checks whether
+*        it is the expected END_xxx, ELSE, ELSIF, UNTIL or CASE label.
+*
+* @param[in]  p        pointer to parser state
+* @param[out] N/A
+*
+* @retval     pointer to first statement, NULL = empty list
+*******************************************************************************/
+MLOCAL MIST_NODE *Par_StmtList(PARSER * p)
+{
+    MIST_NODE *pFirst = NULL;
+    MIST_NODE **ppLast = &pFirst;
+    MIST_NODE *pStmt;
+
+    if (!Par_Enter(p, PAR_STMTLEVELS))
+        return (NULL);
+
+    for (;;)
+    {
+        if (Par_IsPu(p, MIST_PU_SEMI))
+        {
+            Par_Next(p);
+            continue;
+        }
+        if (p->Tok.Kind == MIST_TK_IDENT)
+            ;
+        else if (p->Tok.Kind != MIST_TK_KEYWORD)
+            break;
+        else if ((p->Tok.Id != MIST_KW_IF) && (p->Tok.Id != MIST_KW_CASE) &&
+                 (p->Tok.Id != MIST_KW_FOR) && (p->Tok.Id != MIST_KW_WHILE) &&
+                 (p->Tok.Id != MIST_KW_REPEAT) && (p->Tok.Id != MIST_KW_EXIT) &&
+                 (p->Tok.Id != MIST_KW_CONTINUE) && (p->Tok.Id != MIST_KW_RETURN))
+            break;
+
+        pStmt = Par_Stmt(p);
+        *ppLast = pStmt;
+        ppLast = &pStmt->pNext;
+    }
+    p->Depth -= PAR_STMTLEVELS;
+    return (pFirst);
+}
+
+/**
+********************************************************************************
+* @brief Parses a single statement. Structured statements may be followed
+*        by ';', all other statements must be.
+*
+* @param[in]  p        pointer to parser state
+* @param[out] N/A
+*
+* @retval     pointer to statement node
+*******************************************************************************/
+MLOCAL MIST_NODE *Par_Stmt(PARSER * p)
+{
+    MIST_NODE *pNode;
+    MIST_NODE *pTarget;
+    MIST_VAR *pVar;
+    UINT32  Offset = p->Tok.Offset;
+
+    if (p->Tok.Kind == MIST_TK_IDENT)
+    {
+        pNode = Par_Primary(p);
+        if (pNode->Type != MIST_N_CALL)
+        {
+            pTarget = pNode;
+            pVar = (pTarget->Type == MIST_N_INDEX) ? pTarget->pA->u.pVar : pTarget->u.pVar;
+            if (!p->Error && (pVar->Flags & MIST_VF_CONSTANT))
+                Par_Error(p, Offset, "constant '%s' can't be assigned", pVar->pName);
+            if (!Par_IsOp(p, MIST_OP_ASSIGN))
+                Par_Error(p, p->Tok.Offset, "':=' expected instead of '%.*s'",
+                          (int) p->Tok.Length, p->pSrc + p->Tok.Offset);
+            pNode = Par_Node(p, MIST_N_ASSIGN, Offset);
+            pNode->pA = pTarget;
+            Par_Next(p);
+            pNode->pB = Par_Expr(p, PAR_PREC_OR);
+        }
+        Par_ExpectPu(p, MIST_PU_SEMI, ";");
+        return (pNode);
+    }
+
+    switch (p->Tok.Id)
+    {
+        case MIST_KW_IF:
+            pNode = Par_If(p);
+            Par_ExpectKw(p, MIST_KW_END_IF, "END_IF");
+            break;
+
+        case MIST_KW_CASE:
+            pNode = Par_Case(p);
+            break;
+
+        case MIST_KW_FOR:
+            pNode = Par_For(p);
+            break;
+
+        case MIST_KW_WHILE:
+            pNode = Par_Node(p, MIST_N_WHILE, Offset);
+            Par_Next(p);
+            pNode->pA = Par_Expr(p, PAR_PREC_OR);
+            Par_ExpectKw(p, MIST_KW_DO, "DO");
+            p->LoopDepth++;
+            pNode->pBody = Par_StmtList(p);
+            p->LoopDepth--;
+            Par_ExpectKw(p, MIST_KW_END_WHILE, "END_WHILE");
+            break;
+
+        case MIST_KW_REPEAT:
+            pNode = Par_Node(p, MIST_N_REPEAT, Offset);
+            Par_Next(p);
+            p->LoopDepth++;
+            pNode->pBody = Par_StmtList(p);
+            p->LoopDepth--;
+            Par_ExpectKw(p, MIST_KW_UNTIL, "UNTIL");
+            pNode->pA = Par_Expr(p, PAR_PREC_OR);
+            Par_ExpectKw(p, MIST_KW_END_REPEAT, "END_REPEAT");
+            break;
+
+        default:
+            /* EXIT, CONTINUE, RETURN */
+            pNode = Par_Node(p, (p->Tok.Id == MIST_KW_EXIT) ? MIST_N_EXIT :
+                             (p->Tok.Id == MIST_KW_CONTINUE) ? MIST_N_CONTINUE : MIST_N_RETURN, Offset);
+            if ((pNode->Type != MIST_N_RETURN) && !p->LoopDepth)
+                Par_Error(p, Offset, "'%.*s' outside of a loop", (int) p->Tok.Length, p->pSrc + Offset);
+            Par_Next(p);
+            Par_ExpectPu(p, MIST_PU_SEMI, ";");
+            return (pNode);
+    }
+
+    if (Par_IsPu(p, MIST_PU_SEMI))
+        Par_Next(p);
+    return (pNode);
+}
+
+/**
+********************************************************************************
+* @brief Parses IF cond THEN list {ELSIF cond THEN list} [ELSE list].
+*        Each ELSIF becomes an IF node in the ELSE list of its predecessor,
+*        the chain is built in a loop (see mist_NodeElsif()).
+*        The caller consumes END_IF.
+*
+* @param[in]  p        pointer to parser state
+* @param[out] N/A
+*
+* @retval     pointer to IF node
+*******************************************************************************/
+MLOCAL MIST_NODE *Par_If(PARSER * p)
+{
+    MIST_NODE *pFirst = Par_Node(p, MIST_N_IF, p->Tok.Offset);
+    MIST_NODE *pNode = pFirst;
+
+    for (;;)
+    {
+        Par_Next(p);
+        pNode->pA = Par_Expr(p, PAR_PREC_OR);
+        Par_ExpectKw(p, MIST_KW_THEN, "THEN");
+        pNode->pBody = Par_StmtList(p);
+        if (!Par_IsKw(p, MIST_KW_ELSIF))
+            break;
+        pNode->pElse = Par_Node(p, MIST_N_IF, p->Tok.Offset);
+        pNode = pNode->pElse;
+    }
+
+    if (Par_IsKw(p, MIST_KW_ELSE))
+    {
+        Par_Next(p);
+        pNode->pElse = Par_StmtList(p);
+    }
+    return (pFirst);
+}
+
+/**
+********************************************************************************
+* @brief Parses CASE expr OF {labels ':' list} [ELSE list] END_CASE.
+*        Labels are integer constants or ranges of them.
+*
+* @param[in]  p        pointer to parser state
+* @param[out] N/A
+*
+* @retval     pointer to CASE node
+*******************************************************************************/
+MLOCAL MIST_NODE *Par_Case(PARSER * p)
+{
+    MIST_NODE *pNode = Par_Node(p, MIST_N_CASE, p->Tok.Offset);
+    MIST_NODE **ppElem = &pNode->pBody;
+    MIST_NODE **ppLabel;
+    MIST_NODE *pElem;
+    MIST_NODE *pLabel;
+
+    Par_Next(p);
+    pNode->pA = Par_Expr(p, PAR_PREC_OR);
+    Par_ExpectKw(p, MIST_KW_OF, "OF");
+
+    while ((p->Tok.Kind == MIST_TK_INT) || (p->Tok.Kind == MIST_TK_TYPED) || Par_IsOp(p, MIST_OP_SUB))
+    {
+        pElem = Par_Node(p, MIST_N_CASE_ELEM, p->Tok.Offset);
+        ppLabel = &pElem->pA;
+        for (;;)
+        {
+            pLabel = Par_Unary(p);
+            if (Par_IsPu(p, MIST_PU_RANGE))
+            {
+                MIST_NODE *pRange = Par_Node(p, MIST_N_RANGE, pLabel->Offset);
+
+                pRange->pA = pLabel;
+                Par_Next(p);
+                pRange->pB = Par_Unary(p);
+                pLabel = pRange;
+            }
+            *ppLabel = pLabel;
+            ppLabel = &pLabel->pNext;
+            if (!Par_IsPu(p, MIST_PU_COMMA))
+                break;
+            Par_Next(p);
+        }
+        Par_ExpectPu(p, MIST_PU_COLON, ":");
+        pElem->pBody = Par_StmtList(p);
+        *ppElem = pElem;
+        ppElem = &pElem->pNext;
+    }
+
+    if (Par_IsKw(p, MIST_KW_ELSE))
+    {
+        Par_Next(p);
+        pNode->pElse = Par_StmtList(p);
+    }
+    Par_ExpectKw(p, MIST_KW_END_CASE, "END_CASE");
+    return (pNode);
+}
+
+/**
+********************************************************************************
+* @brief Parses FOR var := expr TO expr [BY expr] DO list END_FOR.
+*
+* @param[in]  p        pointer to parser state
+* @param[out] N/A
+*
+* @retval     pointer to FOR node
+*******************************************************************************/
+MLOCAL MIST_NODE *Par_For(PARSER * p)
+{
+    MIST_NODE *pNode = Par_Node(p, MIST_N_FOR, p->Tok.Offset);
+    MIST_TOKEN Name;
+
+    Par_Next(p);
+    if (p->Tok.Kind != MIST_TK_IDENT)
+    {
+        Par_Error(p, p->Tok.Offset, "control variable expected instead of '%.*s'",
+                  (int) p->Tok.Length, p->pSrc + p->Tok.Offset);
+        return (pNode);
+    }
+    Name = p->Tok;
+    Par_Next(p);
+    pNode->pA = Par_Variable(p, &Name);
+    if (!p->Error && ((pNode->pA->Type != MIST_N_VAR) || pNode->pA->u.pVar->NbOfDims ||
+                      (pNode->pA->u.pVar->Flags & MIST_VF_CONSTANT)))
+        Par_Error(p, pNode->pA->Offset, "control variable must be a scalar variable");
+
+    if (!Par_IsOp(p, MIST_OP_ASSIGN))
+        Par_Error(p, p->Tok.Offset, "':=' expected instead of '%.*s'", (int) p->Tok.Length,
+                  p->pSrc + p->Tok.Offset);
+    Par_Next(p);
+    pNode->pB = Par_Expr(p, PAR_PREC_OR);
+    Par_ExpectKw(p, MIST_KW_TO, "TO");
+    pNode->pC = Par_Expr(p, PAR_PREC_OR);
+    if (Par_IsKw(p, MIST_KW_BY))
+    {
+        Par_Next(p);
+        pNode->pD = Par_Expr(p, PAR_PREC_OR);
+    }
+    Par_ExpectKw(p, MIST_KW_DO, "DO");
+
+    p->LoopDepth++;
+    pNode->pBody = Par_StmtList(p);
+    p->LoopDepth--;
+    Par_ExpectKw(p, MIST_KW_END_FOR, "END_FOR");
+    return (pNode);
+}
+
+/**
+********************************************************************************
+* @brief Evaluates the pragma in front of a declaration. Only the attribute
+*        {attribute 'svi' := 'r' | 'rw' | 'none'} is known, all other
+*        pragmas are ignored. Temporaries have no lasting value and are not
+*        exported, inputs are overwritten by the process image and constants
+*        are folded into the code, so both cannot be written by the SVI.
+*
+* @param[in]  p        pointer to parser state
+* @param[in]  Class    declaration section, MIST_KW_VAR .. MIST_KW_VAR_TEMP
+* @param[in]  Flags    MIST_VF_xxx of the section
+* @param[out] N/A
+*
+* @retval     MIST_VF_SVI_xxx, 0 = no attribute
+*******************************************************************************/
+MLOCAL UINT32 Par_Attribute(PARSER * p, UINT32 Class, UINT32 Flags)
+{
+    CHAR    Text[PAR_PRAGMALEN + 1];
+    CHAR    Name[16];
+    CHAR    Value[16];
+
+    if (!p->Pragma.Length || (p->Pragma.Length > PAR_PRAGMALEN))
+        return (0);
+    memcpy(Text, p->pSrc + p->Pragma.Offset, p->Pragma.Length);
+    Text[p->Pragma.Length] = 0;
+    if ((sscanf(Text, "{ attribute '%15[^']' := '%15[^']'", Name, Value) != 2) || strcmp(Name, "svi"))
+        return (0);
+
+    if (!strcmp(Value, "none"))
+        return (MIST_VF_SVI_NONE);
+    if (strcmp(Value, "r") && strcmp(Value, "rw"))
+    {
+        Par_Error(p, p->Pragma.Offset, "'%s' is no value of attribute 'svi', 'r', 'rw' or 'none' expected", Value);
+        return (0);
+    }
+    if (Class == MIST_KW_VAR_TEMP)
+    {
+        Par_Error(p, p->Pragma.Offset, "VAR_TEMP cannot be exported to the SVI");
+        return (0);
+    }
+    if (!strcmp(Value, "r"))
+        return (MIST_VF_SVI_R);
+    if ((Class == MIST_KW_VAR_INPUT) || (Flags & MIST_VF_CONSTANT))
+    {
+        Par_Error(p, p->Pragma.Offset, "inputs and constants cannot be written by the SVI, use 'r'");
+        return (0);
+    }
+    return (MIST_VF_SVI_RW);
+}
+
+/**
+********************************************************************************
+* @brief Parses one declaration: name {',' name} ':' type [':=' init] ';'
+*        Type is an elementary type or ARRAY '[' l..u {',' l..u} ']' OF type.
+*        Arrays are initialized by '[' value {',' value} ']', a value may be
+*        repeated with n(value). An attribute in front of the declaration
+*        applies to all of its names.
+*
+* @param[in]  p        pointer to parser state
+* @param[in]  Class    declaration section, MIST_KW_VAR .. MIST_KW_VAR_TEMP
+* @param[in]  Flags    MIST_VF_xxx of the section
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Par_VarDecl(PARSER * p, UINT32 Class, UINT32 Flags)
+{
+    MIST_VAR *pFirst = NULL;
+    MIST_VAR *pVar;
+    MIST_VAR Decl;
+    MIST_NODE *pInit = NULL;
+    MIST_NODE **ppLast;
+    MIST_NODE *pRep;
+    UINT32  Hash;
+
+    memset(&Decl, 0, sizeof(Decl));
+    Flags |= Par_Attribute(p, Class, Flags);
+
+    /* Names, entered at once so that duplicates are detected */
+    for (;;)
+    {
+        if (p->Tok.Kind != MIST_TK_IDENT)
+        {
+            Par_Error(p, p->Tok.Offset, "variable name expected instead of '%.*s'",
+                      (int) p->Tok.Length, p->pSrc + p->Tok.Offset);
+            return;
+        }
+        if (mist_VarFind(p->pPou, p->pSrc + p->Tok.Offset, p->Tok.Length))
+        {
+            Par_Error(p, p->Tok.Offset, "'%.*s' is already declared", (int) p->Tok.Length,
+                      p->pSrc + p->Tok.Offset);
+            return;
+        }
+
+        pVar = Par_Alloc(p, sizeof(MIST_VAR));
+        if (p->Error)
+            return;
+        pVar->pName = Par_Name(p, &p->Tok);
+        pVar->Class = Class;
+        pVar->Flags = Flags;
+        pVar->Index = p->pPou->NbOfVars++;
+        pVar->Offset = p->Tok.Offset;
+        Hash = Par_Hash(pVar->pName, p->Tok.Length);
+        pVar->pHashNext = p->pPou->ppVarHash[Hash];
+        p->pPou->ppVarHash[Hash] = pVar;
+        if (p->pLastVar)
+            p->pLastVar->pNext = pVar;
+        else
+            p->pPou->pVars = pVar;
+        p->pLastVar = pVar;
+        if (!pFirst)
+            pFirst = pVar;
+
+        Par_Next(p);
+        if (!Par_IsPu(p, MIST_PU_COMMA))
+            break;
+        Par_Next(p);
+    }
+    if (Par_IsKw(p, MIST_KW_AT))
+    {
+        Par_Error(p, p->Tok.Offset, "located variables are not supported");
+        return;
+    }
+    Par_ExpectPu(p, MIST_PU_COLON, ":");
+
+    /* Array dimensions */
+    if (Par_IsKw(p, MIST_KW_ARRAY))
+    {
+        Par_Next(p);
+        Par_ExpectPu(p, MIST_PU_LBRACKET, "[");
+        for (;;)
+        {
+            if (Decl.NbOfDims >= MIST_MAX_DIMS)
+            {
+                Par_Error(p, p->Tok.Offset, "more than %u array dimensions", MIST_MAX_DIMS);
+                return;
+            }
+            Decl.Lower[Decl.NbOfDims] = Par_ConstInt(p);
+            Par_ExpectPu(p, MIST_PU_RANGE, "..");
+            Decl.Upper[Decl.NbOfDims] = Par_ConstInt(p);
+            if (!p->Error && (Decl.Upper[Decl.NbOfDims] < Decl.Lower[Decl.NbOfDims]))
+                Par_Error(p, p->Tok.Offset, "upper array bound below lower bound");
+            Decl.NbOfDims++;
+            if (!Par_IsPu(p, MIST_PU_COMMA))
+                break;
+            Par_Next(p);
+        }
+        Par_ExpectPu(p, MIST_PU_RBRACKET, "]");
+        Par_ExpectKw(p, MIST_KW_OF, "OF");
+    }
+
+    /* Elementary type */
+    if ((p->Tok.Kind != MIST_TK_KEYWORD) || (p->Tok.Id < MIST_KW_BOOL) || (p->Tok.Id > MIST_KW_LWORD))
+        Par_Error(p, p->Tok.Offset, "data type expected instead of '%.*s'", (int) p->Tok.Length,
+                  p->pSrc + p->Tok.Offset);
+    else if ((p->Tok.Id == MIST_KW_STRING) || (p->Tok.Id == MIST_KW_WSTRING))
+        Par_Error(p, p->Tok.Offset, "data type '%.*s' is not supported", (int) p->Tok.Length,
+                  p->pSrc + p->Tok.Offset);
+    Decl.Type = p->Tok.Id;
+    Par_Next(p);
+
+    /* Initial value */
+    if (Par_IsOp(p, MIST_OP_ASSIGN))
+    {
+        Par_Next(p);
+        if (!Decl.NbOfDims)
+            pInit = Par_Expr(p, PAR_PREC_OR);
+        else
+        {
+            Par_ExpectPu(p, MIST_PU_LBRACKET, "[");
+            ppLast = &pInit;
+            do
+            {
+                if (pInit)
+                    Par_Next(p);
+                *ppLast = Par_Expr(p, PAR_PREC_OR);
+                if (((*ppLast)->Type == MIST_N_INT) && Par_IsPu(p, MIST_PU_LPAREN))
+                {
+                    pRep = Par_Node(p, MIST_N_INITREP, (*ppLast)->Offset);
+                    pRep->u.Int = (*ppLast)->u.Int;
+                    Par_Next(p);
+                    pRep->pA = Par_Expr(p, PAR_PREC_OR);
+                    Par_ExpectPu(p, MIST_PU_RPAREN, ")");
+                    if (!p->Error && (pRep->u.Int <= 0))
+                        Par_Error(p, pRep->Offset, "repetition count must be positive");
+                    *ppLast = pRep;
+                }
+                ppLast = &(*ppLast)->pNext;
+            }
+            while (Par_IsPu(p, MIST_PU_COMMA));
+            Par_ExpectPu(p, MIST_PU_RBRACKET, "]");
+        }
+    }
+    Par_ExpectPu(p, MIST_PU_SEMI, ";");
+
+    /* All names of the declaration share type and initial value */
+    for (pVar = pFirst; pVar && !p->Error; pVar = pVar->pNext)
+    {
+        memcpy(pVar->Lower, Decl.Lower, sizeof(Decl.Lower));
+        memcpy(pVar->Upper, Decl.Upper, sizeof(Decl.Upper));
+        pVar->NbOfDims = Decl.NbOfDims;
+        pVar->Type = Decl.Type;
+        pVar->pInit = pInit;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Parses a declaration section: VAR_xxx [CONSTANT | RETAIN | NON_RETAIN]
+*        {declaration} END_VAR
+*
+* @param[in]  p        pointer to parser state
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Par_VarSection(PARSER * p)
+{
+    UINT32  Class = p->Tok.Id;
+    UINT32  Flags = 0;
+
+    if ((Class == MIST_KW_VAR_ACCESS) || (Class == MIST_KW_VAR_CONFIG))
+    {
+        Par_Error(p, p->Tok.Offset, "'%.*s' is not supported", (int) p->Tok.Length, p->pSrc + p->Tok.Offset);
+        return;
+    }
+    Par_Next(p);
+
+    for (;;)
+    {
+        if (Par_IsKw(p, MIST_KW_CONSTANT))
+            Flags |= MIST_VF_CONSTANT;
+        else if (Par_IsKw(p, MIST_KW_RETAIN))
+            Flags |= MIST_VF_RETAIN;
+        else if (!Par_IsKw(p, MIST_KW_NON_RETAIN))
+            break;
+        Par_Next(p);
+    }
+
+    while (p->Tok.Kind == MIST_TK_IDENT)
+        Par_VarDecl(p, Class, Flags);
+    Par_ExpectKw(p, MIST_KW_END_VAR, "END_VAR");
+}
+
+/**
+********************************************************************************
+* @brief Parses a program organization unit:
+*        PROGRAM name {declaration section} statements END_PROGRAM
+*
+* @param[in]  p        pointer to parser state
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Par_Pou(PARSER * p)
+{
+    MIST_POU *pPou;
+    MIST_POU **ppLast;
+
+    if (!Par_IsKw(p, MIST_KW_PROGRAM))
+    {
+        Par_Error(p, p->Tok.Offset, "PROGRAM expected instead of '%.*s'", (int) p->Tok.Length,
+                  p->pSrc + p->Tok.Offset);
+        return;
+    }
+
+    pPou = Par_Alloc(p, sizeof(MIST_POU));
+    pPou->ppVarHash = Par_Alloc(p, MIST_VAR_HASHSIZE * sizeof(MIST_VAR *));
+    if (p->Error)
+        return;
+    pPou->Kind = MIST_KW_PROGRAM;
+    pPou->Offset = p->Tok.Offset;
+    p->pPou = pPou;
+    p->pLastVar = NULL;
+    Par_Next(p);
+
+    if (p->Tok.Kind != MIST_TK_IDENT)
+    {
+        Par_Error(p, p->Tok.Offset, "program name expected instead of '%.*s'", (int) p->Tok.Length,
+                  p->pSrc + p->Tok.Offset);
+        return;
+    }
+    pPou->pName = Par_Name(p, &p->Tok);
+
+    /* Names of POUs are unique within the unit */
+    for (ppLast = &p->pUnit->pPous; *ppLast; ppLast = &(*ppLast)->pNext)
+    {
+        if (Par_SameName(p->pSrc + p->Tok.Offset, p->Tok.Length, (*ppLast)->pName))
+        {
+            Par_Error(p, p->Tok.Offset, "program '%s' is already defined", pPou->pName);
+            return;
+        }
+    }
+    *ppLast = pPou;
+    p->pUnit->NbOfPous++;
+    Par_Next(p);
+
+    while ((p->Tok.Kind == MIST_TK_KEYWORD) && (p->Tok.Id >= MIST_KW_VAR) && (p->Tok.Id <= MIST_KW_VAR_CONFIG))
+        Par_VarSection(p);
+
+    pPou->pBody = Par_StmtList(p);
+
+    pPou->Length = p->Tok.Offset + p->Tok.Length - pPou->Offset;
+    Par_ExpectKw(p, MIST_KW_END_PROGRAM, "END_PROGRAM");
+}
+
+/**
+********************************************************************************
+* @brief Parses an ST source into a compilation unit.
+*        The source buffer is only needed during parsing, the syntax tree
+*        keeps copies of all names. On error the unit is released and the
+*        first error is reported in ErrLine and ErrText.
+*
+* @param[in]  pUnit    pointer to compilation unit
+* @param[in]  pSrc     pointer to source buffer
+* @param[in]  Length   length of source buffer in bytes
+* @param[out] pUnit    POUs with their variables and statements
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_Parse(MIST_UNIT * pUnit, const CHAR * pSrc, UINT32 Length)
+{
+    PARSER  Par;
+
+    memset(pUnit, 0, sizeof(*pUnit));
+    mist_ArenaInit(&pUnit->Arena, 0);
+
+    memset(&Par, 0, sizeof(Par));
+    Par.pSrc = pSrc;
+    Par.pUnit = pUnit;
+    mist_LexInit(&Par.Lex, pSrc, Length);
+    Par_Next(&Par);
+
+    while (Par.Tok.Kind != MIST_TK_EOF)
+        Par_Pou(&Par);
+
+    if (Par.Error)
+    {
+        mist_ArenaFree(&pUnit->Arena);
+        pUnit->pPous = NULL;
+        pUnit->NbOfPous = 0;
+        pUnit->NbOfNodes = 0;
+        return (ERROR);
+    }
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Releases a compilation unit with all POUs, variables and nodes.
+*
+* @param[in]  pUnit    pointer to compilation unit
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_UnitFree(MIST_UNIT * pUnit)
+{
+    mist_ArenaFree(&pUnit->Arena);
+    pUnit->pPous = NULL;
+    pUnit->NbOfPous = 0;
+    pUnit->NbOfNodes = 0;
+}
+
+/**
+********************************************************************************
+* @brief Parser benchmark, to be called from the shell.
+*        An ST source file is parsed the given number of times, each syntax
+*        tree is released at once. Prints the size of the syntax tree and
+*        the parse throughput in lines per second.
+*
+* @param[in]  pFileName  ST source file
+* @param[in]  Loops      number of parse runs, 0 = 10
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_ParseFile(CHAR * pFileName, UINT32 Loops)
+{
+    MIST_SOURCE Src;
+    MIST_UNIT Unit;
+    UINT32  Lines;
+    UINT32  Time;
+    UINT32  Loop;
+    SINT32  Ret = OK;
+
+    if (!Loops)
+        Loops = 10;
+
+    if (mist_SrcLoad(&Src, pFileName) < 0)
+    {
+        printf("Could not read '%s'\n", pFileName);
+        return (ERROR);
+    }
+    Lines = mist_LexLine(Src.pBuf, Src.Length);
+
+    Time = m_GetProcTime();
+    for (Loop = 0; (Loop < Loops) && (Ret == OK); Loop++)
+    {
+        Ret = mist_Parse(&Unit, Src.pBuf, Src.Length);
+        if ((Ret == OK) && (Loop < Loops - 1))
+            mist_UnitFree(&Unit);
+    }
+    Time = m_GetProcTime() - Time;
+
+    if (Ret < 0)
+        printf("%s: line %u: %s\n", pFileName, Unit.ErrLine, Unit.ErrText);
+    else
+    {
+        printf("%s: %u lines, %u POUs, %u nodes, %u bytes arena\n", pFileName, Lines,
+               Unit.NbOfPous, Unit.NbOfNodes, Unit.Arena.NbOfBytes);
+        printf("  %u loops in %u us, %u us/parse", Loops, Time, Time / Loops);
+        if (Time)
+            printf(", %u lines/s", (UINT32) ((REAL64) Lines * Loops * 1000000.0 / Time));
+        printf("\n");
+        mist_UnitFree(&Unit);
+    }
+
+    mist_SrcFree(&Src);
+    return (Ret);
+}
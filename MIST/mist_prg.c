@@ -1,159 +1,1233 @@
-
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <ctype.h>
-
-#define PASSWORT "BACHMANN"
-#define MAX 80
-
-char * keywords[] = {
-        "IF",
-        "THEN",
-        "ELSE",
-        "ELSIF",
-        "END_IF",
-        "FOR",
-        "TO",
-        "DO",
-        "BY",
-        "END_FOR"
-};
-int keywordCount = sizeof(keywords)/sizeof(keywords[0]);
-
-char * operators[] = {
-        "*",
-        "/",
-        "%",
-        "+",
-        "-"
-};
-int operatorCount = sizeof(operators)/sizeof(operators[0]);
-
-char * specialKeys[] = {
-        ":",
-        ";",
-        "(",
-        ")"
-};
-int specialKeyCount = sizeof(specialKeys)/sizeof(specialKeys[0]);
-
-char  whiteSpaces[] = {
-        ' ',
-        '\n',
-        '\t'
-};
-int whiteSpaceCount = sizeof(whiteSpaces)/sizeof(whiteSpaces[0]);
-
-
-void chomp(char *str) {
-   size_t p=strlen(str);
-   /* '\n' mit '\0' berschreiben */
-   str[p-1]='\0';
-}
-
-
-
-int strToUpper(char str[]){
-    int i = 0;
-    while(str[i]) {
-       str[i] = toupper(str[i]);
-       i++;
-    }
-    return i;
-}
-
-unsigned char isKeyword(char *token){
-    int i = 0;
-    for (i = 0; i < keywordCount; i++) {
-        if(strcmp(keywords[i], token) == 0){
-            return 1;
-        }
-    }
-    return 0;
-}
-
-unsigned char isOperator(char *token){
-    int i = 0;
-    for (i = 0; i < operatorCount; i++) {
-        if(strcmp(operators[i], token) == 0){
-            return 1;
-        }
-    }
-    return 0;
-}
-
-unsigned char isSpecialKey(char *token){
-    int i = 0;
-    for (i = 0; i < specialKeyCount; i++) {
-        if(strcmp(specialKeys[i], token) == 0){
-            return 1;
-        }
-    }
-    return 0;
-}
-
-unsigned char isWhiteSpace(char token){
-    int i = 0;
-    for (i = 0; i < whiteSpaceCount; i++) {
-        if(whiteSpaces[i] == token){
-            return 1;
-        }
-    }
-    return 0;
-}
-
-
-unsigned char tokenizer(char *line){
-    int i = 0;
-    char tokenSpace[30];
-    char *token = tokenSpace;
-    int tokenPointer = 0;
-
-    for(i = 0; i < strlen(line); i++){
-        if(isWhiteSpace(line[i]) == 1){
-            token[tokenPointer+1] = '\0';
-            printf("%s\n", token);
-            bfill(token, sizeof(tokenSpace),' ');
-            tokenPointer = 0;
-        } else {
-            token[tokenPointer++] = line[i];
-            //printf("%s\n", token);
-        }
-    }
-    return 0;
-}
-
-int mist(void) {
-   char pswd[MAX];
-   int exitFlag = 0;
-
-   while(exitFlag == 0){
-       printf("C> ");
-       fgets(pswd, MAX, stdin);
-       chomp(pswd);
-       strToUpper(pswd);
-
-       if(strcmp(PASSWORT, pswd) == 0){
-          printf("Willkommen\n");
-       } else if(strcmp("EXIT", pswd) == 0){
-           printf("Auf Wiedersehen\n");
-           return EXIT_SUCCESS;
-/*       } else if(isKeyword(pswd) == 1){
-           printf("Keyword <%s>\n", pswd);
-       } else if(isOperator(pswd) == 1){
-           printf("Operator <%s>\n", pswd);
-       } else if(isWhiteSpace(pswd) == 1){
-           printf("WhiteSpace <%s>\n", pswd);
-       } else if(isSpecialKey(pswd) == 1){
-           printf("SpecialKey <%s>\n", pswd);
-       } else
-          printf("Id <%s>\n", pswd);
-*/
-
-       } else
-           tokenizer(pswd);
-   }
-   return EXIT_SUCCESS;
-}
+/**
+********************************************************************************
+* @file     mist_prg.c
+* @author   Bachmann electronic GmbH
+* @version  $Revision: 3.90 $ $LastChangedBy: BE $
+* @date     $LastChangeDate: 2013-06-10 11:00:00 $
+*
+* @brief    This file contains the source handling and the lexer of the
+*           Structured Text (ST) front end and the interactive test shell
+*           mist().
+*
+*           A source file is read once into a single buffer. Tokens are
+*           views into this buffer (offset, length, kind), nothing is copied
+*           or allocated per token, and identifiers of any length are
+*           supported.
+*
+*           The lexer is table driven: every character is mapped to a
+*           character class by a 256 entry table, and the class drives a
+*           deterministic finite automaton (DFA). A token is the longest
+*           prefix which ends in an accepting state, so multi character
+*           operators like ":=", "<=", "<>" and "**" are kept intact.
+*           Whitespace and comments are consumed by the DFA as well and
+*           are never delivered as tokens.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <prof_e.h>
+
+/* Project includes */
+#include "mist_int.h"
+#include "mist_prg.h"
+
+#define PASSWORT "BACHMANN"
+#define MAX 80
+
+/* Character classes, index of the columns in the DFA table */
+#define LEX_C_OTHER      0
+#define LEX_C_SPACE      1
+#define LEX_C_NL         2
+#define LEX_C_ALPHA      3
+#define LEX_C_E          4
+#define LEX_C_UNDER      5
+#define LEX_C_DIGIT      6
+#define LEX_C_HASH       7
+#define LEX_C_DOT        8
+#define LEX_C_COLON      9
+#define LEX_C_EQ         10
+#define LEX_C_LT         11
+#define LEX_C_GT         12
+#define LEX_C_STAR       13
+#define LEX_C_SLASH      14
+#define LEX_C_PLUS       15
+#define LEX_C_MINUS      16
+#define LEX_C_PERCENT    17
+#define LEX_C_AMP        18
+#define LEX_C_LPAREN     19
+#define LEX_C_RPAREN     20
+#define LEX_C_SEMI       21
+#define LEX_C_COMMA      22
+#define LEX_C_LBRACKET   23
+#define LEX_C_RBRACKET   24
+#define LEX_C_QUOTE      25
+#define LEX_C_DQUOTE     26
+#define LEX_C_DOLLAR     27
+#define LEX_C_LBRACE     28
+#define LEX_C_RBRACE     29
+#define LEX_C_COUNT      30
+
+/* DFA states, state 0 is the error state which stops scanning */
+#define LEX_S_ERR        0
+#define LEX_S_START      1
+#define LEX_S_WS         2
+#define LEX_S_IDENT      3
+#define LEX_S_TYPED_HASH 4
+#define LEX_S_TYPED      5
+#define LEX_S_INT        6
+#define LEX_S_REAL_DOT   7
+#define LEX_S_REAL       8
+#define LEX_S_EXP        9
+#define LEX_S_EXP_SIGN   10
+#define LEX_S_EXP_DIGITS 11
+#define LEX_S_BASED_HASH 12
+#define LEX_S_BASED      13
+#define LEX_S_COLON      14
+#define LEX_S_ASSIGN     15
+#define LEX_S_EQ         16
+#define LEX_S_OUTASSIGN  17
+#define LEX_S_LT         18
+#define LEX_S_LE         19
+#define LEX_S_NE         20
+#define LEX_S_GT         21
+#define LEX_S_GE         22
+#define LEX_S_STAR       23
+#define LEX_S_POW        24
+#define LEX_S_SLASH      25
+#define LEX_S_LCOMMENT   26
+#define LEX_S_LPAREN     27
+#define LEX_S_BCOMMENT   28
+#define LEX_S_BCSTAR     29
+#define LEX_S_BCEND      30
+#define LEX_S_LBRACE     31
+#define LEX_S_PRAGMA     32
+#define LEX_S_PRAGMA_END 33
+#define LEX_S_STR        34
+#define LEX_S_STR_ESC    35
+#define LEX_S_STR_END    36
+#define LEX_S_WSTR       37
+#define LEX_S_WSTR_ESC   38
+#define LEX_S_WSTR_END   39
+#define LEX_S_DOT        40
+#define LEX_S_RANGE      41
+#define LEX_S_PLUS       42
+#define LEX_S_MINUS      43
+#define LEX_S_PERCENT    44
+#define LEX_S_AMP        45
+#define LEX_S_RPAREN     46
+#define LEX_S_SEMI       47
+#define LEX_S_COMMA      48
+#define LEX_S_LBRACKET   49
+#define LEX_S_RBRACKET   50
+#define LEX_S_TYPED_FRAC 51
+#define LEX_S_TYPED_EXP  52
+#define LEX_S_COUNT      53
+
+/* Keyword recognition: limits of the keyword table and perfect hash */
+#define KW_MINLEN        2
+#define KW_MAXLEN        18
+#define KW_HASHSIZE      256
+
+/* Internal token kinds, never delivered to the caller */
+#define LEX_TK_SKIP      0xFE     /* whitespace or comment */
+#define LEX_TK_UNTERM    0xFF     /* only valid if the source ends in this state */
+
+/* Accepting information of a DFA state */
+typedef struct LEX_ACCEPT
+{
+    UINT8   Kind;                       /* token kind, 0 = state is not accepting */
+    UINT8   Id;                         /* operator or punctuator id */
+} LEX_ACCEPT;
+
+/* Entry of the keyword table */
+typedef struct LEX_KEYWORD
+{
+    const CHAR *pName;                  /* keyword in upper case */
+    UINT8   OpId;                       /* operator id if keyword is an operator */
+} LEX_KEYWORD;
+
+/*
+ * Character class table
+ * All characters which are not listed are invalid in ST source (LEX_C_OTHER).
+ */
+MLOCAL const UINT8 LexClass[256] = {
+    [' '] = LEX_C_SPACE, ['\t'] = LEX_C_SPACE, ['\r'] = LEX_C_SPACE,
+    ['\f'] = LEX_C_SPACE, ['\v'] = LEX_C_SPACE, ['\n'] = LEX_C_NL,
+    ['A' ... 'Z'] = LEX_C_ALPHA, ['a' ... 'z'] = LEX_C_ALPHA,
+    ['E'] = LEX_C_E, ['e'] = LEX_C_E, ['_'] = LEX_C_UNDER,
+    ['0' ... '9'] = LEX_C_DIGIT,
+    ['#'] = LEX_C_HASH, ['.'] = LEX_C_DOT, [':'] = LEX_C_COLON,
+    ['='] = LEX_C_EQ, ['<'] = LEX_C_LT, ['>'] = LEX_C_GT,
+    ['*'] = LEX_C_STAR, ['/'] = LEX_C_SLASH, ['+'] = LEX_C_PLUS,
+    ['-'] = LEX_C_MINUS, ['%'] = LEX_C_PERCENT, ['&'] = LEX_C_AMP,
+    ['('] = LEX_C_LPAREN, [')'] = LEX_C_RPAREN, [';'] = LEX_C_SEMI,
+    [','] = LEX_C_COMMA, ['['] = LEX_C_LBRACKET, [']'] = LEX_C_RBRACKET,
+    ['\''] = LEX_C_QUOTE, ['"'] = LEX_C_DQUOTE, ['$'] = LEX_C_DOLLAR,
+    ['{'] = LEX_C_LBRACE, ['}'] = LEX_C_RBRACE
+};
+
+/*
+ * DFA transition table [state][character class]
+ * Missing entries are 0 (LEX_S_ERR) and terminate the current token.
+ * Rows of comments and strings first fill all classes with a range
+ * and then override the classes which leave the state.
+ */
+MLOCAL const UINT8 LexDfa[LEX_S_COUNT][LEX_C_COUNT] = {
+    [LEX_S_START] = {
+        [LEX_C_SPACE] = LEX_S_WS, [LEX_C_NL] = LEX_S_WS,
+        [LEX_C_ALPHA] = LEX_S_IDENT, [LEX_C_E] = LEX_S_IDENT, [LEX_C_UNDER] = LEX_S_IDENT,
+        [LEX_C_DIGIT] = LEX_S_INT, [LEX_C_DOT] = LEX_S_DOT,
+        [LEX_C_COLON] = LEX_S_COLON, [LEX_C_EQ] = LEX_S_EQ,
+        [LEX_C_LT] = LEX_S_LT, [LEX_C_GT] = LEX_S_GT,
+        [LEX_C_STAR] = LEX_S_STAR, [LEX_C_SLASH] = LEX_S_SLASH,
+        [LEX_C_PLUS] = LEX_S_PLUS, [LEX_C_MINUS] = LEX_S_MINUS,
+        [LEX_C_PERCENT] = LEX_S_PERCENT, [LEX_C_AMP] = LEX_S_AMP,
+        [LEX_C_LPAREN] = LEX_S_LPAREN, [LEX_C_RPAREN] = LEX_S_RPAREN,
+        [LEX_C_SEMI] = LEX_S_SEMI, [LEX_C_COMMA] = LEX_S_COMMA,
+        [LEX_C_LBRACKET] = LEX_S_LBRACKET, [LEX_C_RBRACKET] = LEX_S_RBRACKET,
+        [LEX_C_QUOTE] = LEX_S_STR, [LEX_C_DQUOTE] = LEX_S_WSTR,
+        [LEX_C_LBRACE] = LEX_S_LBRACE},
+    [LEX_S_WS] = {
+        [LEX_C_SPACE] = LEX_S_WS, [LEX_C_NL] = LEX_S_WS},
+    [LEX_S_IDENT] = {
+        [LEX_C_ALPHA] = LEX_S_IDENT, [LEX_C_E] = LEX_S_IDENT, [LEX_C_UNDER] = LEX_S_IDENT,
+        [LEX_C_DIGIT] = LEX_S_IDENT, [LEX_C_HASH] = LEX_S_TYPED_HASH},
+    [LEX_S_TYPED_HASH] = {
+        [LEX_C_ALPHA] = LEX_S_TYPED, [LEX_C_E] = LEX_S_TYPED, [LEX_C_UNDER] = LEX_S_TYPED,
+        [LEX_C_DIGIT] = LEX_S_TYPED, [LEX_C_MINUS] = LEX_S_TYPED},
+    [LEX_S_TYPED] = {
+        [LEX_C_ALPHA] = LEX_S_TYPED, [LEX_C_E] = LEX_S_TYPED, [LEX_C_UNDER] = LEX_S_TYPED,
+        [LEX_C_DIGIT] = LEX_S_TYPED, [LEX_C_DOT] = LEX_S_TYPED_FRAC, [LEX_C_COLON] = LEX_S_TYPED},
+    [LEX_S_TYPED_FRAC] = {
+        [LEX_C_ALPHA] = LEX_S_TYPED, [LEX_C_E] = LEX_S_TYPED_EXP, [LEX_C_UNDER] = LEX_S_TYPED_FRAC,
+        [LEX_C_DIGIT] = LEX_S_TYPED_FRAC, [LEX_C_DOT] = LEX_S_TYPED_FRAC, [LEX_C_COLON] = LEX_S_TYPED},
+    [LEX_S_TYPED_EXP] = {
+        [LEX_C_ALPHA] = LEX_S_TYPED, [LEX_C_E] = LEX_S_TYPED, [LEX_C_UNDER] = LEX_S_TYPED,
+        [LEX_C_DIGIT] = LEX_S_TYPED, [LEX_C_DOT] = LEX_S_TYPED_FRAC, [LEX_C_COLON] = LEX_S_TYPED,
+        [LEX_C_PLUS] = LEX_S_TYPED, [LEX_C_MINUS] = LEX_S_TYPED},
+    [LEX_S_INT] = {
+        [LEX_C_DIGIT] = LEX_S_INT, [LEX_C_UNDER] = LEX_S_INT, [LEX_C_DOT] = LEX_S_REAL_DOT,
+        [LEX_C_E] = LEX_S_EXP, [LEX_C_HASH] = LEX_S_BASED_HASH},
+    [LEX_S_REAL_DOT] = {
+        [LEX_C_DIGIT] = LEX_S_REAL},
+    [LEX_S_REAL] = {
+        [LEX_C_DIGIT] = LEX_S_REAL, [LEX_C_UNDER] = LEX_S_REAL, [LEX_C_E] = LEX_S_EXP},
+    [LEX_S_EXP] = {
+        [LEX_C_PLUS] = LEX_S_EXP_SIGN, [LEX_C_MINUS] = LEX_S_EXP_SIGN,
+        [LEX_C_DIGIT] = LEX_S_EXP_DIGITS},
+    [LEX_S_EXP_SIGN] = {
+        [LEX_C_DIGIT] = LEX_S_EXP_DIGITS},
+    [LEX_S_EXP_DIGITS] = {
+        [LEX_C_DIGIT] = LEX_S_EXP_DIGITS},
+    [LEX_S_BASED_HASH] = {
+        [LEX_C_ALPHA] = LEX_S_BASED, [LEX_C_E] = LEX_S_BASED, [LEX_C_DIGIT] = LEX_S_BASED},
+    [LEX_S_BASED] = {
+        [LEX_C_ALPHA] = LEX_S_BASED, [LEX_C_E] = LEX_S_BASED, [LEX_C_DIGIT] = LEX_S_BASED,
+        [LEX_C_UNDER] = LEX_S_BASED},
+    [LEX_S_COLON] = {
+        [LEX_C_EQ] = LEX_S_ASSIGN},
+    [LEX_S_EQ] = {
+        [LEX_C_GT] = LEX_S_OUTASSIGN},
+    [LEX_S_LT] = {
+        [LEX_C_EQ] = LEX_S_LE, [LEX_C_GT] = LEX_S_NE},
+    [LEX_S_GT] = {
+        [LEX_C_EQ] = LEX_S_GE},
+    [LEX_S_STAR] = {
+        [LEX_C_STAR] = LEX_S_POW},
+    [LEX_S_SLASH] = {
+        [LEX_C_SLASH] = LEX_S_LCOMMENT},
+    [LEX_S_LCOMMENT] = {
+        [0 ... LEX_C_COUNT - 1] = LEX_S_LCOMMENT, [LEX_C_NL] = LEX_S_ERR},
+    [LEX_S_LPAREN] = {
+        [LEX_C_STAR] = LEX_S_BCOMMENT},
+    [LEX_S_BCOMMENT] = {
+        [0 ... LEX_C_COUNT - 1] = LEX_S_BCOMMENT, [LEX_C_STAR] = LEX_S_BCSTAR},
+    [LEX_S_BCSTAR] = {
+        [0 ... LEX_C_COUNT - 1] = LEX_S_BCOMMENT, [LEX_C_STAR] = LEX_S_BCSTAR,
+        [LEX_C_RPAREN] = LEX_S_BCEND},
+    [LEX_S_LBRACE] = {
+        [0 ... LEX_C_COUNT - 1] = LEX_S_PRAGMA, [LEX_C_RBRACE] = LEX_S_PRAGMA_END},
+    [LEX_S_PRAGMA] = {
+        [0 ... LEX_C_COUNT - 1] = LEX_S_PRAGMA, [LEX_C_RBRACE] = LEX_S_PRAGMA_END},
+    [LEX_S_STR] = {
+        [0 ... LEX_C_COUNT - 1] = LEX_S_STR, [LEX_C_QUOTE] = LEX_S_STR_END,
+        [LEX_C_DOLLAR] = LEX_S_STR_ESC, [LEX_C_NL] = LEX_S_ERR},
+    [LEX_S_STR_ESC] = {
+        [0 ... LEX_C_COUNT - 1] = LEX_S_STR, [LEX_C_NL] = LEX_S_ERR},
+    [LEX_S_WSTR] = {
+        [0 ... LEX_C_COUNT - 1] = LEX_S_WSTR, [LEX_C_DQUOTE] = LEX_S_WSTR_END,
+        [LEX_C_DOLLAR] = LEX_S_WSTR_ESC, [LEX_C_NL] = LEX_S_ERR},
+    [LEX_S_WSTR_ESC] = {
+        [0 ... LEX_C_COUNT - 1] = LEX_S_WSTR, [LEX_C_NL] = LEX_S_ERR},
+    [LEX_S_DOT] = {
+        [LEX_C_DOT] = LEX_S_RANGE}
+};
+
+/*
+ * Token kind and id for all accepting states.
+ * States of unterminated comments and strings are marked with LEX_TK_UNTERM,
+ * they only produce an error if the end of the source is reached in them.
+ */
+MLOCAL const LEX_ACCEPT LexAccept[LEX_S_COUNT] = {
+    [LEX_S_WS] = {LEX_TK_SKIP, 0},
+    [LEX_S_IDENT] = {MIST_TK_IDENT, 0},
+    [LEX_S_TYPED] = {MIST_TK_TYPED, 0},
+    [LEX_S_TYPED_FRAC] = {MIST_TK_TYPED, 0},
+    [LEX_S_TYPED_EXP] = {MIST_TK_TYPED, 0},
+    [LEX_S_INT] = {MIST_TK_INT, 0},
+    [LEX_S_REAL] = {MIST_TK_REAL, 0},
+    [LEX_S_EXP_DIGITS] = {MIST_TK_REAL, 0},
+    [LEX_S_BASED] = {MIST_TK_INT, 0},
+    [LEX_S_COLON] = {MIST_TK_PUNCT, MIST_PU_COLON},
+    [LEX_S_ASSIGN] = {MIST_TK_OPERATOR, MIST_OP_ASSIGN},
+    [LEX_S_EQ] = {MIST_TK_OPERATOR, MIST_OP_EQ},
+    [LEX_S_OUTASSIGN] = {MIST_TK_OPERATOR, MIST_OP_OUTASSIGN},
+    [LEX_S_LT] = {MIST_TK_OPERATOR, MIST_OP_LT},
+    [LEX_S_LE] = {MIST_TK_OPERATOR, MIST_OP_LE},
+    [LEX_S_NE] = {MIST_TK_OPERATOR, MIST_OP_NE},
+    [LEX_S_GT] = {MIST_TK_OPERATOR, MIST_OP_GT},
+    [LEX_S_GE] = {MIST_TK_OPERATOR, MIST_OP_GE},
+    [LEX_S_STAR] = {MIST_TK_OPERATOR, MIST_OP_MUL},
+    [LEX_S_POW] = {MIST_TK_OPERATOR, MIST_OP_POW},
+    [LEX_S_SLASH] = {MIST_TK_OPERATOR, MIST_OP_DIV},
+    [LEX_S_LCOMMENT] = {LEX_TK_SKIP, 0},
+    [LEX_S_LPAREN] = {MIST_TK_PUNCT, MIST_PU_LPAREN},
+    [LEX_S_BCOMMENT] = {LEX_TK_UNTERM, 0},
+    [LEX_S_BCSTAR] = {LEX_TK_UNTERM, 0},
+    [LEX_S_BCEND] = {LEX_TK_SKIP, 0},
+    [LEX_S_LBRACE] = {LEX_TK_UNTERM, 0},
+    [LEX_S_PRAGMA] = {LEX_TK_UNTERM, 0},
+    [LEX_S_PRAGMA_END] = {MIST_TK_PRAGMA, 0},
+    [LEX_S_STR] = {LEX_TK_UNTERM, 0},
+    [LEX_S_STR_ESC] = {LEX_TK_UNTERM, 0},
+    [LEX_S_STR_END] = {MIST_TK_STRING, 0},
+    [LEX_S_WSTR] = {LEX_TK_UNTERM, 0},
+    [LEX_S_WSTR_ESC] = {LEX_TK_UNTERM, 0},
+    [LEX_S_WSTR_END] = {MIST_TK_STRING, 0},
+    [LEX_S_DOT] = {MIST_TK_PUNCT, MIST_PU_DOT},
+    [LEX_S_RANGE] = {MIST_TK_PUNCT, MIST_PU_RANGE},
+    [LEX_S_PLUS] = {MIST_TK_OPERATOR, MIST_OP_ADD},
+    [LEX_S_MINUS] = {MIST_TK_OPERATOR, MIST_OP_SUB},
+    [LEX_S_PERCENT] = {MIST_TK_OPERATOR, MIST_OP_MOD},
+    [LEX_S_AMP] = {MIST_TK_OPERATOR, MIST_OP_AND},
+    [LEX_S_RPAREN] = {MIST_TK_PUNCT, MIST_PU_RPAREN},
+    [LEX_S_SEMI] = {MIST_TK_PUNCT, MIST_PU_SEMI},
+    [LEX_S_COMMA] = {MIST_TK_PUNCT, MIST_PU_COMMA},
+    [LEX_S_LBRACKET] = {MIST_TK_PUNCT, MIST_PU_LBRACKET},
+    [LEX_S_RBRACKET] = {MIST_TK_PUNCT, MIST_PU_RBRACKET}
+};
+
+/* Visible names of the token kinds, index is MIST_TK_xxx */
+MLOCAL const CHAR *LexKindNames[] = {
+    "EOF", "Error", "Keyword", "Id", "Int", "Real", "String", "Typed", "Operator", "SpecialKey", "Pragma"
+};
+
+/*
+ * Keyword table, index is the keyword id MIST_KW_xxx.
+ * Keywords which are operators are delivered as operator tokens.
+ */
+MLOCAL const LEX_KEYWORD KwList[MIST_KW_COUNT] = {
+    {"", MIST_OP_NONE},
+    {"IF", MIST_OP_NONE},
+    {"THEN", MIST_OP_NONE},
+    {"ELSE", MIST_OP_NONE},
+    {"ELSIF", MIST_OP_NONE},
+    {"END_IF", MIST_OP_NONE},
+    {"FOR", MIST_OP_NONE},
+    {"TO", MIST_OP_NONE},
+    {"DO", MIST_OP_NONE},
+    {"BY", MIST_OP_NONE},
+    {"END_FOR", MIST_OP_NONE},
+    {"WHILE", MIST_OP_NONE},
+    {"END_WHILE", MIST_OP_NONE},
+    {"REPEAT", MIST_OP_NONE},
+    {"UNTIL", MIST_OP_NONE},
+    {"END_REPEAT", MIST_OP_NONE},
+    {"CASE", MIST_OP_NONE},
+    {"OF", MIST_OP_NONE},
+    {"END_CASE", MIST_OP_NONE},
+    {"EXIT", MIST_OP_NONE},
+    {"RETURN", MIST_OP_NONE},
+    {"CONTINUE", MIST_OP_NONE},
+    {"PROGRAM", MIST_OP_NONE},
+    {"END_PROGRAM", MIST_OP_NONE},
+    {"FUNCTION", MIST_OP_NONE},
+    {"END_FUNCTION", MIST_OP_NONE},
+    {"FUNCTION_BLOCK", MIST_OP_NONE},
+    {"END_FUNCTION_BLOCK", MIST_OP_NONE},
+    {"VAR", MIST_OP_NONE},
+    {"VAR_INPUT", MIST_OP_NONE},
+    {"VAR_OUTPUT", MIST_OP_NONE},
+    {"VAR_IN_OUT", MIST_OP_NONE},
+    {"VAR_GLOBAL", MIST_OP_NONE},
+    {"VAR_EXTERNAL", MIST_OP_NONE},
+    {"VAR_TEMP", MIST_OP_NONE},
+    {"VAR_ACCESS", MIST_OP_NONE},
+    {"VAR_CONFIG", MIST_OP_NONE},
+    {"END_VAR", MIST_OP_NONE},
+    {"CONSTANT", MIST_OP_NONE},
+    {"RETAIN", MIST_OP_NONE},
+    {"NON_RETAIN", MIST_OP_NONE},
+    {"AT", MIST_OP_NONE},
+    {"BOOL", MIST_OP_NONE},
+    {"SINT", MIST_OP_NONE},
+    {"INT", MIST_OP_NONE},
+    {"DINT", MIST_OP_NONE},
+    {"LINT", MIST_OP_NONE},
+    {"USINT", MIST_OP_NONE},
+    {"UINT", MIST_OP_NONE},
+    {"UDINT", MIST_OP_NONE},
+    {"ULINT", MIST_OP_NONE},
+    {"REAL", MIST_OP_NONE},
+    {"LREAL", MIST_OP_NONE},
+    {"TIME", MIST_OP_NONE},
+    {"DATE", MIST_OP_NONE},
+    {"TIME_OF_DAY", MIST_OP_NONE},
+    {"TOD", MIST_OP_NONE},
+    {"DATE_AND_TIME", MIST_OP_NONE},
+    {"DT", MIST_OP_NONE},
+    {"STRING", MIST_OP_NONE},
+    {"WSTRING", MIST_OP_NONE},
+    {"BYTE", MIST_OP_NONE},
+    {"WORD", MIST_OP_NONE},
+    {"DWORD", MIST_OP_NONE},
+    {"LWORD", MIST_OP_NONE},
+    {"ARRAY", MIST_OP_NONE},
+    {"STRUCT", MIST_OP_NONE},
+    {"END_STRUCT", MIST_OP_NONE},
+    {"TYPE", MIST_OP_NONE},
+    {"END_TYPE", MIST_OP_NONE},
+    {"TRUE", MIST_OP_NONE},
+    {"FALSE", MIST_OP_NONE},
+    {"AND", MIST_OP_AND},
+    {"OR", MIST_OP_OR},
+    {"XOR", MIST_OP_XOR},
+    {"NOT", MIST_OP_NOT},
+    {"MOD", MIST_OP_MOD},
+    {"CONFIGURATION", MIST_OP_NONE},
+    {"END_CONFIGURATION", MIST_OP_NONE},
+    {"RESOURCE", MIST_OP_NONE},
+    {"END_RESOURCE", MIST_OP_NONE},
+    {"TASK", MIST_OP_NONE},
+    {"WITH", MIST_OP_NONE},
+    {"ON", MIST_OP_NONE},
+    {"READ_ONLY", MIST_OP_NONE},
+    {"READ_WRITE", MIST_OP_NONE},
+    {"STEP", MIST_OP_NONE},
+    {"END_STEP", MIST_OP_NONE},
+    {"INITIAL_STEP", MIST_OP_NONE},
+    {"TRANSITION", MIST_OP_NONE},
+    {"END_TRANSITION", MIST_OP_NONE},
+    {"FROM", MIST_OP_NONE},
+    {"ACTION", MIST_OP_NONE},
+    {"END_ACTION", MIST_OP_NONE},
+    {"REF_TO", MIST_OP_NONE}
+};
+
+/*
+ * Perfect hash for keyword recognition, generated by tools/mist_kwgen.c.
+ * Hash = Length + KwAsso[c0] + KwAsso[c1] + KwAsso[c4] + KwAsso[cLast],
+ * c4 is the last character for keywords with less than 5 characters.
+ * KwSlot[Hash] is the only keyword which can match, 0 = no keyword.
+ */
+MLOCAL const UINT8 KwAsso[256] = {
+    ['A'] = 35, ['a'] = 35,
+    ['B'] =  4, ['b'] =  4,
+    ['C'] =  1, ['c'] =  1,
+    ['D'] = 47, ['d'] = 47,
+    ['E'] =  8, ['e'] =  8,
+    ['F'] = 42, ['f'] = 42,
+    ['G'] = 34, ['g'] = 34,
+    ['H'] = 10, ['h'] = 10,
+    ['I'] =  8, ['i'] =  8,
+    ['J'] = 24, ['j'] = 24,
+    ['K'] = 43, ['k'] = 43,
+    ['L'] = 29, ['l'] = 29,
+    ['M'] = 45, ['m'] = 45,
+    ['N'] = 45, ['n'] = 45,
+    ['O'] = 13, ['o'] = 13,
+    ['P'] = 33, ['p'] = 33,
+    ['Q'] = 10, ['q'] = 10,
+    ['R'] = 38, ['r'] = 38,
+    ['S'] =  3, ['s'] =  3,
+    ['T'] =  3, ['t'] =  3,
+    ['U'] = 19, ['u'] = 19,
+    ['V'] = 40, ['v'] = 40,
+    ['W'] = 42, ['w'] = 42,
+    ['X'] = 18, ['x'] = 18,
+    ['Y'] =  0, ['y'] =  0,
+    ['Z'] = 42, ['z'] = 42
+};
+
+MLOCAL const UINT8 KwSlot[KW_HASHSIZE] = {
+    [  6] = MIST_KW_BY,
+    [ 16] = MIST_KW_STRUCT,
+    [ 21] = MIST_KW_SINT,
+    [ 22] = MIST_KW_TIME_OF_DAY,
+    [ 23] = MIST_KW_TYPE,
+    [ 24] = MIST_KW_BYTE,
+    [ 28] = MIST_KW_CONSTANT,
+    [ 31] = MIST_KW_TIME,
+    [ 33] = MIST_KW_USINT,
+    [ 36] = MIST_KW_EXIT,
+    [ 37] = MIST_KW_UINT,
+    [ 38] = MIST_KW_CONTINUE,
+    [ 44] = MIST_KW_TO,
+    [ 46] = MIST_KW_AT,
+    [ 47] = MIST_KW_LINT,
+    [ 55] = MIST_KW_READ_ONLY,
+    [ 56] = MIST_KW_CASE,
+    [ 57] = MIST_KW_ELSE,
+    [ 58] = MIST_KW_DT,
+    [ 59] = MIST_KW_ULINT,
+    [ 61] = MIST_KW_TRUE,
+    [ 62] = MIST_KW_INT,
+    [ 64] = MIST_KW_READ_WRITE,
+    [ 65] = MIST_KW_DINT,
+    [ 67] = MIST_KW_NOT,
+    [ 68] = MIST_KW_REF_TO,
+    [ 69] = MIST_KW_END_STRUCT,
+    [ 70] = MIST_KW_END_CASE,
+    [ 72] = MIST_KW_END_TYPE,
+    [ 73] = MIST_KW_WHILE,
+    [ 74] = MIST_KW_WITH,
+    [ 76] = MIST_KW_STEP,
+    [ 77] = MIST_KW_UDINT,
+    [ 78] = MIST_KW_ARRAY,
+    [ 79] = MIST_KW_BOOL,
+    [ 80] = MIST_KW_CONFIGURATION,
+    [ 81] = MIST_KW_RESOURCE,
+    [ 88] = MIST_KW_DO,
+    [ 90] = MIST_KW_REPEAT,
+    [ 91] = MIST_KW_STRING,
+    [ 94] = MIST_KW_WSTRING,
+    [ 95] = MIST_KW_VAR_INPUT,
+    [ 96] = MIST_KW_VAR_IN_OUT,
+    [ 97] = MIST_KW_END_STEP,
+    [ 98] = MIST_KW_FALSE,
+    [ 99] = MIST_KW_TRANSITION,
+    [100] = MIST_KW_ACTION,
+    [101] = MIST_KW_VAR_OUTPUT,
+    [102] = MIST_KW_DATE,
+    [103] = MIST_KW_DATE_AND_TIME,
+    [104] = MIST_KW_END_REPEAT,
+    [105] = MIST_KW_RETAIN,
+    [106] = MIST_KW_INITIAL_STEP,
+    [107] = MIST_KW_THEN,
+    [108] = MIST_KW_REAL,
+    [109] = MIST_KW_END_IF,
+    [110] = MIST_KW_XOR,
+    [111] = MIST_KW_END_RESOURCE,
+    [112] = MIST_KW_END_WHILE,
+    [113] = MIST_KW_TOD,
+    [115] = MIST_KW_END_TRANSITION,
+    [116] = MIST_KW_END_CONFIGURATION,
+    [117] = MIST_KW_FUNCTION,
+    [119] = MIST_KW_VAR_TEMP,
+    [120] = MIST_KW_VAR_CONFIG,
+    [121] = MIST_KW_FUNCTION_BLOCK,
+    [123] = MIST_KW_VAR_ACCESS,
+    [124] = MIST_KW_VAR_EXTERNAL,
+    [126] = MIST_KW_ELSIF,
+    [127] = MIST_KW_UNTIL,
+    [128] = MIST_KW_TASK,
+    [129] = MIST_KW_OR,
+    [130] = MIST_KW_LREAL,
+    [134] = MIST_KW_FOR,
+    [135] = MIST_KW_RETURN,
+    [136] = MIST_KW_IF,
+    [138] = MIST_KW_END_VAR,
+    [140] = MIST_KW_END_FOR,
+    [141] = MIST_KW_OF,
+    [142] = MIST_KW_END_PROGRAM,
+    [143] = MIST_KW_END_ACTION,
+    [148] = MIST_KW_VAR_GLOBAL,
+    [150] = MIST_KW_ON,
+    [151] = MIST_KW_NON_RETAIN,
+    [152] = MIST_KW_END_FUNCTION,
+    [153] = MIST_KW_WORD,
+    [154] = MIST_KW_VAR,
+    [155] = MIST_KW_MOD,
+    [156] = MIST_KW_END_FUNCTION_BLOCK,
+    [161] = MIST_KW_PROGRAM,
+    [170] = MIST_KW_LWORD,
+    [174] = MIST_KW_FROM,
+    [177] = MIST_KW_AND,
+    [188] = MIST_KW_DWORD
+};
+
+/* Functions: lexer, being called only within this file */
+MLOCAL UINT32 Lex_KeywordId(const CHAR * pStr, UINT32 Length);
+MLOCAL UINT32 Lex_KeywordIdLinear(const CHAR * pStr, UINT32 Length);
+
+/* Functions: test functions, to be called from the shell */
+SINT32  mist_KwBench(CHAR * pFileName, UINT32 Loops);
+SINT32  mist_LexFile(CHAR * pFileName, UINT32 Print);
+SINT32  mist_LexTest(VOID);
+
+
+void chomp(char *str) {
+   size_t p=strlen(str);
+   /* '\n' mit '\0' berschreiben */
+   str[p-1]='\0';
+}
+
+
+
+int strToUpper(char str[]){
+    int i = 0;
+    while(str[i]) {
+       str[i] = toupper(str[i]);
+       i++;
+    }
+    return i;
+}
+
+/**
+********************************************************************************
+* @brief Returns the keyword id of an identifier.
+*        The perfect hash selects the only possible candidate, which is then
+*        compared once. The comparison is case insensitive, the identifier
+*        is not modified.
+*
+* @param[in]  pStr     pointer to first character of identifier in source
+* @param[in]  Length   length of identifier
+* @param[out] N/A
+*
+* @retval     > 0 .. keyword id MIST_KW_xxx
+* @retval     = 0 .. identifier is no keyword
+*******************************************************************************/
+MLOCAL UINT32 Lex_KeywordId(const CHAR * pStr, UINT32 Length)
+{
+    const UINT8 *p = (const UINT8 *) pStr;
+    const CHAR *pKw;
+    UINT32  Hash;
+    UINT32  Id;
+    UINT32  i;
+
+    if ((Length < KW_MINLEN) || (Length > KW_MAXLEN))
+        return (MIST_KW_NONE);
+
+    Hash = Length + KwAsso[p[0]] + KwAsso[p[1]] + KwAsso[p[(Length > 4) ? 4 : Length - 1]]
+        + KwAsso[p[Length - 1]];
+    if (Hash >= KW_HASHSIZE)
+        return (MIST_KW_NONE);
+
+    Id = KwSlot[Hash];
+    if (Id == MIST_KW_NONE)
+        return (MIST_KW_NONE);
+
+    /*
+     * Identifiers only consist of letters, digits and '_'.
+     * Clearing bit 5 turns lower into upper case letters and keeps '_',
+     * digits are moved out of the letter range and thus never match.
+     */
+    pKw = KwList[Id].pName;
+    for (i = 0; i < Length; i++)
+    {
+        if ((p[i] & 0xDF) != (UINT8) pKw[i])
+            return (MIST_KW_NONE);
+    }
+    if (pKw[Length])
+        return (MIST_KW_NONE);
+
+    return (Id);
+}
+
+/**
+********************************************************************************
+* @brief Returns the keyword id of an identifier by a linear scan over the
+*        keyword table, as it was done by the former isKeyword().
+*        Only used as reference in mist_KwBench().
+*
+* @param[in]  pStr     pointer to first character of identifier in source
+* @param[in]  Length   length of identifier
+* @param[out] N/A
+*
+* @retval     > 0 .. keyword id MIST_KW_xxx
+* @retval     = 0 .. identifier is no keyword
+*******************************************************************************/
+MLOCAL UINT32 Lex_KeywordIdLinear(const CHAR * pStr, UINT32 Length)
+{
+    const CHAR *pKw;
+    UINT32  Id;
+    UINT32  i;
+
+    for (Id = 1; Id < MIST_KW_COUNT; Id++)
+    {
+        pKw = KwList[Id].pName;
+        for (i = 0; (i < Length) && (toupper((UINT8) pStr[i]) == pKw[i]); i++)
+            ;
+        if ((i == Length) && (pKw[Length] == 0))
+            return (Id);
+    }
+    return (MIST_KW_NONE);
+}
+
+/**
+********************************************************************************
+* @brief Reads an ST source file into a single buffer.
+*        The file is read with one call, the buffer is terminated with an
+*        additional 0 so that it can be used as string for diagnostics.
+*        The lexer does not rely on the termination.
+*
+* @param[in]  pSrc       pointer to source descriptor
+* @param[in]  pFileName  path/name of source file
+* @param[out] pSrc       buffer and length of the source file
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_SrcLoad(MIST_SOURCE * pSrc, const CHAR * pFileName)
+{
+    FILE   *pFile;
+    SINT32  Length;
+    CHAR    Func[] = "mist_SrcLoad";
+
+    pSrc->pBuf = NULL;
+    pSrc->Length = 0;
+    snprintf(pSrc->FileName, sizeof(pSrc->FileName), "%s", pFileName);
+
+    pFile = fopen(pFileName, "rb");
+    if (!pFile)
+    {
+        LOG_E(0, Func, "Could not open ST source file '%s'!", pFileName);
+        return (ERROR);
+    }
+
+    /* do while(0), to be left as soon as there is an error */
+    do
+    {
+        if (fseek(pFile, 0, SEEK_END) < 0)
+            break;
+        Length = ftell(pFile);
+        if ((Length < 0) || (fseek(pFile, 0, SEEK_SET) < 0))
+            break;
+
+        pSrc->pBuf = malloc(Length + 1);
+        if (!pSrc->pBuf)
+        {
+            LOG_E(0, Func, "No memory for ST source file '%s' (%d bytes)!", pFileName, Length);
+            break;
+        }
+
+        if (fread(pSrc->pBuf, 1, Length, pFile) != (size_t) Length)
+            break;
+
+        pSrc->pBuf[Length] = 0;
+        pSrc->Length = Length;
+        fclose(pFile);
+        return (OK);
+    }
+    while (0);
+
+    LOG_E(0, Func, "Could not read ST source file '%s'!", pFileName);
+    fclose(pFile);
+    mist_SrcFree(pSrc);
+    return (ERROR);
+}
+
+/**
+********************************************************************************
+* @brief Frees the buffer of an ST source file.
+*        All tokens of this source become invalid.
+*
+* @param[in]  pSrc       pointer to source descriptor
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_SrcFree(MIST_SOURCE * pSrc)
+{
+    if (pSrc->pBuf)
+        free(pSrc->pBuf);
+    pSrc->pBuf = NULL;
+    pSrc->Length = 0;
+}
+
+/**
+********************************************************************************
+* @brief Calculates the FNV-1a hash of a source text, e.g. of a single POU.
+*        Compiled code and generated C code carry this hash to detect that
+*        they belong to the same source.
+*
+* @param[in]  pSrc       pointer to source text, not necessarily terminated
+* @param[in]  Length     length of source text in bytes
+* @param[out] N/A
+*
+* @retval     hash value
+*******************************************************************************/
+UINT32 mist_SrcHash(const CHAR * pSrc, UINT32 Length)
+{
+    UINT32  Hash = 0x811C9DC5;
+    UINT32  i;
+
+    for (i = 0; i < Length; i++)
+    {
+        Hash ^= (UINT8) pSrc[i];
+        Hash *= 0x01000193;
+    }
+    return (Hash);
+}
+
+/**
+********************************************************************************
+* @brief Initializes a lexer for the given source buffer.
+*        The buffer is not copied, it must stay valid as long as the lexer
+*        and its tokens are being used.
+*
+* @param[in]  pLex     pointer to lexer state
+* @param[in]  pSrc     pointer to source buffer
+* @param[in]  Length   length of source buffer in bytes
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_LexInit(MIST_LEXER * pLex, const CHAR * pSrc, UINT32 Length)
+{
+    pLex->pSrc = pSrc;
+    pLex->Length = Length;
+    pLex->Pos = 0;
+}
+
+/**
+********************************************************************************
+* @brief Scans the next token of the source in a single pass.
+*        The DFA is run from the current position as long as there is a valid
+*        transition. The token ends at the last accepting state (longest match),
+*        scanning continues directly behind it with the next call.
+*
+* @param[in]  pLex     pointer to lexer state
+* @param[out] pTok     token: kind, id and position in the source buffer
+*
+* @retval     token kind MIST_TK_xxx, MIST_TK_EOF at the end of the source
+*******************************************************************************/
+UINT32 mist_LexNext(MIST_LEXER * pLex, MIST_TOKEN * pTok)
+{
+    const UINT8 *pSrc = (const UINT8 *) pLex->pSrc;
+    UINT32  Length = pLex->Length;
+    UINT32  Pos = pLex->Pos;
+    UINT32  Start;
+    UINT32  State;
+    UINT32  AcceptState;
+    UINT32  AcceptEnd;
+    UINT32  Id;
+
+    do
+    {
+        /* Fast path for whitespace between tokens, the DFA handles it as well */
+        while ((Pos < Length) && ((UINT32) (LexClass[pSrc[Pos]] - LEX_C_SPACE) <= (LEX_C_NL - LEX_C_SPACE)))
+            Pos++;
+
+        Start = Pos;
+        State = LEX_S_START;
+        AcceptState = LEX_S_ERR;
+        AcceptEnd = Start;
+
+        /* Run the DFA as long as there is a valid transition */
+        while (Pos < Length)
+        {
+            State = LexDfa[State][LexClass[pSrc[Pos]]];
+            if (State == LEX_S_ERR)
+                break;
+            Pos++;
+            if (LexAccept[State].Kind && (LexAccept[State].Kind != LEX_TK_UNTERM))
+            {
+                AcceptState = State;
+                AcceptEnd = Pos;
+            }
+        }
+
+        /* End of source */
+        if (Start >= Length)
+        {
+            pTok->Offset = Length;
+            pTok->Length = 0;
+            pTok->Kind = MIST_TK_EOF;
+            pTok->Id = 0;
+            pLex->Pos = Length;
+            return (MIST_TK_EOF);
+        }
+
+        /* Comment or string which is still open at the end of the source */
+        if ((Pos >= Length) && (LexAccept[State].Kind == LEX_TK_UNTERM))
+        {
+            AcceptState = LEX_S_ERR;
+            AcceptEnd = Length;
+        }
+        /* No accepting prefix: invalid character */
+        else if (AcceptState == LEX_S_ERR)
+            AcceptEnd = Start + 1;
+
+        Pos = AcceptEnd;
+    }
+    while (LexAccept[AcceptState].Kind == LEX_TK_SKIP);
+
+    pLex->Pos = Pos;
+    pTok->Offset = Start;
+    pTok->Length = Pos - Start;
+
+    if (AcceptState == LEX_S_ERR)
+    {
+        pTok->Kind = MIST_TK_ERROR;
+        pTok->Id = 0;
+    }
+    else
+    {
+        pTok->Kind = LexAccept[AcceptState].Kind;
+        pTok->Id = LexAccept[AcceptState].Id;
+
+        /* Identifiers are checked for keywords */
+        if (pTok->Kind == MIST_TK_IDENT)
+        {
+            Id = Lex_KeywordId((const CHAR *) pSrc + Start, pTok->Length);
+            if (KwList[Id].OpId != MIST_OP_NONE)
+            {
+                pTok->Kind = MIST_TK_OPERATOR;
+                pTok->Id = KwList[Id].OpId;
+            }
+            else if (Id != MIST_KW_NONE)
+            {
+                pTok->Kind = MIST_TK_KEYWORD;
+                pTok->Id = Id;
+            }
+        }
+    }
+    return (pTok->Kind);
+}
+
+/**
+********************************************************************************
+* @brief Returns the keyword id of a word, e.g. the prefix of a typed literal.
+*
+* @param[in]  pStr     pointer to first character of the word
+* @param[in]  Length   length of the word
+* @param[out] N/A
+*
+* @retval     > 0 .. keyword id MIST_KW_xxx
+* @retval     = 0 .. word is no keyword
+*******************************************************************************/
+UINT32 mist_LexKeywordId(const CHAR * pStr, UINT32 Length)
+{
+    return (Lex_KeywordId(pStr, Length));
+}
+
+/**
+********************************************************************************
+* @brief Calculates the line number of a source offset.
+*        Lines are not counted while scanning, this function is only
+*        intended for error messages.
+*
+* @param[in]  pSrc     pointer to source buffer
+* @param[in]  Offset   offset in source buffer
+* @param[out] N/A
+*
+* @retval     line number, starting with 1
+*******************************************************************************/
+UINT32 mist_LexLine(const CHAR * pSrc, UINT32 Offset)
+{
+    UINT32  i;
+    UINT32  Line = 1;
+
+    for (i = 0; i < Offset; i++)
+    {
+        if (pSrc[i] == '\n')
+            Line++;
+    }
+    return (Line);
+}
+
+/**
+********************************************************************************
+* @brief Finds the next POU of a source without parsing it. The POU starts
+*        with the first token behind Offset and ends with the next
+*        END_PROGRAM or at the end of the source. So the POU text is the
+*        same as MIST_POU Offset and Length of a parsed source, and
+*        unchanged POUs can be recognized by their text alone.
+*
+* @param[in]  pSrc     pointer to source buffer
+* @param[in]  Length   length of source buffer in bytes
+* @param[in]  Offset   offset in source buffer, e.g. the end of the previous POU
+* @param[out] pStart   offset of the first token of the POU
+* @param[out] pEnd     offset behind the POU
+*
+* @retval     TRUE  .. POU found
+* @retval     FALSE .. only whitespace and comments behind Offset
+*******************************************************************************/
+BOOL mist_LexPou(const CHAR * pSrc, UINT32 Length, UINT32 Offset, UINT32 * pStart, UINT32 * pEnd)
+{
+    MIST_LEXER Lex;
+    MIST_TOKEN Tok;
+
+    mist_LexInit(&Lex, pSrc, Length);
+    Lex.Pos = Offset;
+    if (mist_LexNext(&Lex, &Tok) == MIST_TK_EOF)
+        return (FALSE);
+
+    *pStart = Tok.Offset;
+    while ((Tok.Kind != MIST_TK_EOF) && ((Tok.Kind != MIST_TK_KEYWORD) || (Tok.Id != MIST_KW_END_PROGRAM)))
+        mist_LexNext(&Lex, &Tok);
+    *pEnd = Tok.Offset + Tok.Length;
+    return (TRUE);
+}
+
+/**
+********************************************************************************
+* @brief Returns the visible name of a token kind.
+*
+* @param[in]  Kind     token kind MIST_TK_xxx
+* @param[out] N/A
+*
+* @retval     pointer to name string
+*******************************************************************************/
+const CHAR *mist_LexKindName(UINT32 Kind)
+{
+    if (Kind >= sizeof(LexKindNames) / sizeof(LexKindNames[0]))
+        return ("?");
+    return (LexKindNames[Kind]);
+}
+
+/**
+********************************************************************************
+* @brief Microbenchmark of the keyword recognition, to be called from the shell.
+*        All words of an ST source file (identifiers and keywords) are
+*        collected first. Then all of them are looked up with the perfect
+*        hash and with the linear scan for the given number of loops.
+*        Both methods must find the same number of keywords.
+*
+* @param[in]  pFileName  ST source file
+* @param[in]  Loops      number of loops over all words, 0 = 100
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_KwBench(CHAR * pFileName, UINT32 Loops)
+{
+    MIST_SOURCE Src;
+    MIST_TOKEN *pWords = NULL;
+    MIST_LEXER Lex;
+    MIST_TOKEN Tok;
+    const CHAR *pSrc;
+    UINT32  NbOfWords = 0;
+    UINT32  HashFound = 0, LinearFound = 0;
+    UINT32  HashTime, LinearTime;
+    UINT32  Loop, i;
+
+    if (!Loops)
+        Loops = 100;
+
+    if (mist_SrcLoad(&Src, pFileName) < 0)
+    {
+        printf("Could not read '%s'\n", pFileName);
+        return (ERROR);
+    }
+    pSrc = Src.pBuf;
+
+    /* Collect all words, there can't be more tokens than characters */
+    pWords = malloc((Src.Length + 1) * sizeof(MIST_TOKEN));
+    if (!pWords)
+    {
+        mist_SrcFree(&Src);
+        return (ERROR);
+    }
+    mist_LexInit(&Lex, pSrc, Src.Length);
+    while (mist_LexNext(&Lex, &Tok) != MIST_TK_EOF)
+    {
+        if ((LexClass[(UINT8) pSrc[Tok.Offset]] == LEX_C_ALPHA) ||
+            (LexClass[(UINT8) pSrc[Tok.Offset]] == LEX_C_E) ||
+            (LexClass[(UINT8) pSrc[Tok.Offset]] == LEX_C_UNDER))
+            pWords[NbOfWords++] = Tok;
+    }
+
+    /* Perfect hash */
+    HashTime = m_GetProcTime();
+    for (Loop = 0; Loop < Loops; Loop++)
+    {
+        for (i = 0; i < NbOfWords; i++)
+        {
+            if (Lex_KeywordId(pSrc + pWords[i].Offset, pWords[i].Length))
+                HashFound++;
+        }
+    }
+    HashTime = m_GetProcTime() - HashTime;
+
+    /* Linear scan */
+    LinearTime = m_GetProcTime();
+    for (Loop = 0; Loop < Loops; Loop++)
+    {
+        for (i = 0; i < NbOfWords; i++)
+        {
+            if (Lex_KeywordIdLinear(pSrc + pWords[i].Offset, pWords[i].Length))
+                LinearFound++;
+        }
+    }
+    LinearTime = m_GetProcTime() - LinearTime;
+
+    printf("%s: %u words, %u keywords, %u loops\n", pFileName, NbOfWords,
+           HashFound / Loops, Loops);
+    printf("  perfect hash: %10u us, %6u ns/word\n", HashTime,
+           NbOfWords ? (UINT32) (HashTime * 1000.0 / ((REAL64) NbOfWords * Loops)) : 0);
+    printf("  linear scan:  %10u us, %6u ns/word\n", LinearTime,
+           NbOfWords ? (UINT32) (LinearTime * 1000.0 / ((REAL64) NbOfWords * Loops)) : 0);
+    if (HashFound != LinearFound)
+        printf("  MISMATCH: linear scan found %u keywords\n", LinearFound / Loops);
+
+    free(pWords);
+    mist_SrcFree(&Src);
+    return ((HashFound == LinearFound) ? OK : ERROR);
+}
+
+/**
+********************************************************************************
+* @brief Lexes a complete ST source file, to be called from the shell.
+*        Prints the number of tokens per kind and the lexer throughput.
+*        Printing of the tokens is optional, since it takes much more time
+*        than the lexing itself.
+*
+* @param[in]  pFileName  ST source file
+* @param[in]  Print      != 0 .. print every token
+* @param[out] N/A
+*
+* @retval     = 0 .. OK, no error tokens
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_LexFile(CHAR * pFileName, UINT32 Print)
+{
+    MIST_SOURCE Src;
+    MIST_LEXER Lex;
+    MIST_TOKEN Tok;
+    UINT32  Count[MIST_TK_PRAGMA + 1];
+    UINT32  NbOfTokens = 0;
+    UINT32  Time;
+    UINT32  Kind;
+
+    if (mist_SrcLoad(&Src, pFileName) < 0)
+    {
+        printf("Could not read '%s'\n", pFileName);
+        return (ERROR);
+    }
+    memset(Count, 0, sizeof(Count));
+
+    Time = m_GetProcTime();
+    mist_LexInit(&Lex, Src.pBuf, Src.Length);
+    while ((Kind = mist_LexNext(&Lex, &Tok)) != MIST_TK_EOF)
+    {
+        Count[Kind]++;
+        NbOfTokens++;
+        if (Print)
+            printf("%5u %-10s <%.*s>\n", mist_LexLine(Src.pBuf, Tok.Offset), mist_LexKindName(Kind),
+                   (int) Tok.Length, Src.pBuf + Tok.Offset);
+    }
+    Time = m_GetProcTime() - Time;
+
+    printf("%s: %u bytes, %u lines, %u tokens in %u us", pFileName, Src.Length,
+           mist_LexLine(Src.pBuf, Src.Length), NbOfTokens, Time);
+    if (Time && !Print)
+        printf(", %u kB/s", (UINT32) ((REAL64) Src.Length * 1000.0 / 1024.0 / Time * 1000.0));
+    printf("\n");
+    for (Kind = MIST_TK_ERROR; Kind <= MIST_TK_PRAGMA; Kind++)
+        printf("  %-10s %u\n", mist_LexKindName(Kind), Count[Kind]);
+
+    mist_SrcFree(&Src);
+    return (Count[MIST_TK_ERROR] ? ERROR : OK);
+}
+
+/**
+********************************************************************************
+* @brief Test function: lexes short sources with known token boundaries,
+*        to be called from the shell. Prints each source whose first token
+*        differs in kind or length from the expected one.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     = 0 .. OK, all tokens as expected
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_LexTest(VOID)
+{
+    MLOCAL const struct
+    {
+        const CHAR *pSrc;               /* source */
+        UINT32  Kind;                   /* kind of the first token */
+        UINT32  Length;                 /* length of the first token */
+    } Cases[] = {
+        {"REAL#1.0E-3", MIST_TK_TYPED, 11},
+        {"LREAL#1.5E+10;", MIST_TK_TYPED, 13},
+        {"LREAL#2.5e-7*x", MIST_TK_TYPED, 12},
+        {"REAL#1.0E3-x", MIST_TK_TYPED, 10},
+        {"REAL#1.5-x", MIST_TK_TYPED, 8},
+        {"INT#-5", MIST_TK_TYPED, 6},
+        {"MODE#IDLE-1", MIST_TK_TYPED, 9},
+        {"TOD#12:30:15.5", MIST_TK_TYPED, 14},
+        {"T#1.5s+t", MIST_TK_TYPED, 6},
+        {"1.0E-3", MIST_TK_REAL, 6},
+        {"1E+2-x", MIST_TK_REAL, 4}
+    };
+    MIST_LEXER Lex;
+    MIST_TOKEN Tok;
+    UINT32  NbOfFailed = 0;
+    UINT32  Kind;
+    UINT32  i;
+
+    for (i = 0; i < sizeof(Cases) / sizeof(Cases[0]); i++)
+    {
+        mist_LexInit(&Lex, Cases[i].pSrc, strlen(Cases[i].pSrc));
+        Kind = mist_LexNext(&Lex, &Tok);
+        if ((Kind != Cases[i].Kind) || (Tok.Length != Cases[i].Length))
+        {
+            printf("%s: %s <%.*s>, expected %s of %u characters\n", Cases[i].pSrc, mist_LexKindName(Kind),
+                   (int) Tok.Length, Cases[i].pSrc + Tok.Offset, mist_LexKindName(Cases[i].Kind), Cases[i].Length);
+            NbOfFailed++;
+        }
+    }
+    printf("%u of %u lexer tests failed\n", NbOfFailed, i);
+    return (NbOfFailed ? ERROR : OK);
+}
+
+
+unsigned char tokenizer(char *line){
+    MIST_LEXER Lex;
+    MIST_TOKEN Tok;
+
+    mist_LexInit(&Lex, line, strlen(line));
+    while(mist_LexNext(&Lex, &Tok) != MIST_TK_EOF){
+        printf("%s <%.*s>\n", mist_LexKindName(Tok.Kind), (int) Tok.Length, line + Tok.Offset);
+    }
+    return 0;
+}
+
+int mist(void) {
+   char pswd[MAX];
+   int exitFlag = 0;
+
+   while(exitFlag == 0){
+       printf("C> ");
+       fgets(pswd, MAX, stdin);
+       chomp(pswd);
+       strToUpper(pswd);
+
+       if(strcmp(PASSWORT, pswd) == 0){
+          printf("Willkommen\n");
+       } else if(strcmp("EXIT", pswd) == 0){
+           printf("Auf Wiedersehen\n");
+           return EXIT_SUCCESS;
+       } else
+           tokenizer(pswd);
+   }
+   return EXIT_SUCCESS;
+}
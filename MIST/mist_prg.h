@@ -0,0 +1,374 @@
+/**
+********************************************************************************
+* @file     mist_prg.h
+* @author   Bachmann electronic GmbH
+* @version  $Revision: 3.90 $ $LastChangedBy: BE $
+* @date     $LastChangeDate: 2013-06-10 11:00:00 $
+*
+* @brief    This file contains all definitions and declarations of the
+*           Structured Text (ST) program front end,
+*           which are global within the SW-module.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef MIST_PRG__H
+#define MIST_PRG__H
+
+/*--- Defines ---*/
+
+/* Token kinds delivered by the lexer */
+#define MIST_TK_EOF          0    /* end of source reached */
+#define MIST_TK_ERROR        1    /* invalid character or unterminated comment/string */
+#define MIST_TK_KEYWORD      2    /* keyword, Id is MIST_KW_xxx */
+#define MIST_TK_IDENT        3    /* identifier */
+#define MIST_TK_INT          4    /* integer literal, also based literal 16#FF */
+#define MIST_TK_REAL         5    /* real literal */
+#define MIST_TK_STRING       6    /* string literal including quotes */
+#define MIST_TK_TYPED        7    /* typed literal, e.g. T#10ms */
+#define MIST_TK_OPERATOR     8    /* operator, Id is MIST_OP_xxx, also AND, OR, XOR, NOT, MOD */
+#define MIST_TK_PUNCT        9    /* punctuator, Id is MIST_PU_xxx */
+#define MIST_TK_PRAGMA       10   /* pragma {...}, see Par_Next() */
+
+/* Keyword ids, full IEC 61131-3 ST keyword set (see tools/mist_kwgen.c) */
+#define MIST_KW_NONE                 0
+#define MIST_KW_IF                   1
+#define MIST_KW_THEN                 2
+#define MIST_KW_ELSE                 3
+#define MIST_KW_ELSIF                4
+#define MIST_KW_END_IF               5
+#define MIST_KW_FOR                  6
+#define MIST_KW_TO                   7
+#define MIST_KW_DO                   8
+#define MIST_KW_BY                   9
+#define MIST_KW_END_FOR              10
+#define MIST_KW_WHILE                11
+#define MIST_KW_END_WHILE            12
+#define MIST_KW_REPEAT               13
+#define MIST_KW_UNTIL                14
+#define MIST_KW_END_REPEAT           15
+#define MIST_KW_CASE                 16
+#define MIST_KW_OF                   17
+#define MIST_KW_END_CASE             18
+#define MIST_KW_EXIT                 19
+#define MIST_KW_RETURN               20
+#define MIST_KW_CONTINUE             21
+#define MIST_KW_PROGRAM              22
+#define MIST_KW_END_PROGRAM          23
+#define MIST_KW_FUNCTION             24
+#define MIST_KW_END_FUNCTION         25
+#define MIST_KW_FUNCTION_BLOCK       26
+#define MIST_KW_END_FUNCTION_BLOCK   27
+#define MIST_KW_VAR                  28
+#define MIST_KW_VAR_INPUT            29
+#define MIST_KW_VAR_OUTPUT           30
+#define MIST_KW_VAR_IN_OUT           31
+#define MIST_KW_VAR_GLOBAL           32
+#define MIST_KW_VAR_EXTERNAL         33
+#define MIST_KW_VAR_TEMP             34
+#define MIST_KW_VAR_ACCESS           35
+#define MIST_KW_VAR_CONFIG           36
+#define MIST_KW_END_VAR              37
+#define MIST_KW_CONSTANT             38
+#define MIST_KW_RETAIN               39
+#define MIST_KW_NON_RETAIN           40
+#define MIST_KW_AT                   41
+#define MIST_KW_BOOL                 42
+#define MIST_KW_SINT                 43
+#define MIST_KW_INT                  44
+#define MIST_KW_DINT                 45
+#define MIST_KW_LINT                 46
+#define MIST_KW_USINT                47
+#define MIST_KW_UINT                 48
+#define MIST_KW_UDINT                49
+#define MIST_KW_ULINT                50
+#define MIST_KW_REAL                 51
+#define MIST_KW_LREAL                52
+#define MIST_KW_TIME                 53
+#define MIST_KW_DATE                 54
+#define MIST_KW_TIME_OF_DAY          55
+#define MIST_KW_TOD                  56
+#define MIST_KW_DATE_AND_TIME        57
+#define MIST_KW_DT                   58
+#define MIST_KW_STRING               59
+#define MIST_KW_WSTRING              60
+#define MIST_KW_BYTE                 61
+#define MIST_KW_WORD                 62
+#define MIST_KW_DWORD                63
+#define MIST_KW_LWORD                64
+#define MIST_KW_ARRAY                65
+#define MIST_KW_STRUCT               66
+#define MIST_KW_END_STRUCT           67
+#define MIST_KW_TYPE                 68
+#define MIST_KW_END_TYPE             69
+#define MIST_KW_TRUE                 70
+#define MIST_KW_FALSE                71
+#define MIST_KW_AND                  72
+#define MIST_KW_OR                   73
+#define MIST_KW_XOR                  74
+#define MIST_KW_NOT                  75
+#define MIST_KW_MOD                  76
+#define MIST_KW_CONFIGURATION        77
+#define MIST_KW_END_CONFIGURATION    78
+#define MIST_KW_RESOURCE             79
+#define MIST_KW_END_RESOURCE         80
+#define MIST_KW_TASK                 81
+#define MIST_KW_WITH                 82
+#define MIST_KW_ON                   83
+#define MIST_KW_READ_ONLY            84
+#define MIST_KW_READ_WRITE           85
+#define MIST_KW_STEP                 86
+#define MIST_KW_END_STEP             87
+#define MIST_KW_INITIAL_STEP         88
+#define MIST_KW_TRANSITION           89
+#define MIST_KW_END_TRANSITION       90
+#define MIST_KW_FROM                 91
+#define MIST_KW_ACTION               92
+#define MIST_KW_END_ACTION           93
+#define MIST_KW_REF_TO               94
+#define MIST_KW_COUNT                95
+
+/* Operator ids, the first entries follow the original operator table */
+#define MIST_OP_NONE         0
+#define MIST_OP_MUL          1    /* * */
+#define MIST_OP_DIV          2    /* / */
+#define MIST_OP_MOD          3    /* % or MOD */
+#define MIST_OP_ADD          4    /* + */
+#define MIST_OP_SUB          5    /* - */
+#define MIST_OP_POW          6    /* ** */
+#define MIST_OP_EQ           7    /* = */
+#define MIST_OP_NE           8    /* <> */
+#define MIST_OP_LT           9    /* < */
+#define MIST_OP_LE           10   /* <= */
+#define MIST_OP_GT           11   /* > */
+#define MIST_OP_GE           12   /* >= */
+#define MIST_OP_AND          13   /* & or AND */
+#define MIST_OP_ASSIGN       14   /* := */
+#define MIST_OP_OUTASSIGN    15   /* => */
+#define MIST_OP_OR           16   /* OR */
+#define MIST_OP_XOR          17   /* XOR */
+#define MIST_OP_NOT          18   /* NOT */
+
+/* Punctuator ids, the first entries follow the original special key table */
+#define MIST_PU_NONE         0
+#define MIST_PU_COLON        1    /* : */
+#define MIST_PU_SEMI         2    /* ; */
+#define MIST_PU_LPAREN       3    /* ( */
+#define MIST_PU_RPAREN       4    /* ) */
+#define MIST_PU_COMMA        5    /* , */
+#define MIST_PU_LBRACKET     6    /* [ */
+#define MIST_PU_RBRACKET     7    /* ] */
+#define MIST_PU_DOT          8    /* . */
+#define MIST_PU_RANGE        9    /* .. */
+
+/* Node types of the abstract syntax tree, see MIST_NODE */
+#define MIST_N_INT           1    /* integer, BOOL or TIME literal, u.Int */
+#define MIST_N_REAL          2    /* real literal, u.Real */
+#define MIST_N_VAR           3    /* variable u.pVar, arrays without index denote the whole array */
+#define MIST_N_INDEX         4    /* array element, pA = MIST_N_VAR, pB = list of indexes, Op = MIST_IX_xxx */
+#define MIST_N_UNARY         5    /* unary operation Op (MIST_OP_SUB, MIST_OP_NOT) on pA */
+#define MIST_N_BINARY        6    /* binary operation Op on pA and pB */
+#define MIST_N_CALL          7    /* function call u.pName, pA = list of arguments, Op = MIST_F_xxx */
+#define MIST_N_INITREP       8    /* repeated initial value u.Int(pA) of an array */
+#define MIST_N_ASSIGN        9    /* pA := pB */
+#define MIST_N_IF            10   /* IF pA THEN pBody ELSE pElse, ELSIF is a nested IF in pElse */
+#define MIST_N_CASE          11   /* CASE pA OF pBody (list of MIST_N_CASE_ELEM) ELSE pElse */
+#define MIST_N_CASE_ELEM     12   /* pA = list of labels (literals and ranges): pBody */
+#define MIST_N_RANGE         13   /* case label range pA..pB */
+#define MIST_N_FOR           14   /* FOR pA := pB TO pC BY pD (NULL = 1) DO pBody */
+#define MIST_N_WHILE         15   /* WHILE pA DO pBody */
+#define MIST_N_REPEAT        16   /* REPEAT pBody UNTIL pA */
+#define MIST_N_EXIT          17   /* EXIT */
+#define MIST_N_CONTINUE      18   /* CONTINUE */
+#define MIST_N_RETURN        19   /* RETURN */
+
+/* Flags of array elements (MIST_N_INDEX), set by the compiler */
+#define MIST_IX_CHECKED      0x0001    /* index follows a FOR loop and is always within bounds */
+
+/* Computation classes of expressions, assigned by the compiler (ascending rank) */
+#define MIST_CLS_NONE        0
+#define MIST_CLS_BOOL        1    /* BOOL, 0 or 1 */
+#define MIST_CLS_INT         2    /* signed 32 bit, also all shorter integer types */
+#define MIST_CLS_UINT        3    /* unsigned 32 bit, UDINT and DWORD */
+#define MIST_CLS_REAL        4    /* REAL */
+#define MIST_CLS_LREAL       5    /* LREAL */
+
+/* Standard functions of MIST_N_CALL nodes, resolved by the compiler */
+#define MIST_F_NONE          0
+#define MIST_F_ABS           1
+#define MIST_F_SQRT          2    /* MIST_F_SQRT .. MIST_F_LOG follow MIST_FN_xxx of the VM */
+#define MIST_F_SIN           3
+#define MIST_F_COS           4
+#define MIST_F_TAN           5
+#define MIST_F_ASIN          6
+#define MIST_F_ACOS          7
+#define MIST_F_ATAN          8
+#define MIST_F_EXP           9
+#define MIST_F_LN            10
+#define MIST_F_LOG           11
+#define MIST_F_EXPT          12
+#define MIST_F_TRUNC         13
+#define MIST_F_MIN           14
+#define MIST_F_MAX           15
+#define MIST_F_LIMIT         16
+#define MIST_F_SEL           17
+#define MIST_F_CONV          18   /* type conversion X_TO_Y, DataType = Y */
+
+/* Variable flags, see MIST_VAR */
+#define MIST_VF_CONSTANT     0x0001    /* declared in a CONSTANT section */
+#define MIST_VF_RETAIN       0x0002    /* declared in a RETAIN section */
+#define MIST_VF_SVI_R        0x0004    /* {attribute 'svi' := 'r'}: exported to the SVI, read only */
+#define MIST_VF_SVI_RW       0x0008    /* {attribute 'svi' := 'rw'}: exported to the SVI, writable */
+#define MIST_VF_SVI_NONE     0x0010    /* {attribute 'svi' := 'none'}: never exported */
+
+/* Limits of the parser */
+#define MIST_MAX_DIMS        3    /* max. number of array dimensions */
+#define MIST_VAR_HASHSIZE    256  /* size of the variable name hash table of a POU, power of 2 */
+#define MIST_ARENA_BLKSIZE   0x10000   /* default block size of an arena */
+#define MIST_ARENA_ALIGN     8    /* alignment of all arena allocations */
+
+
+/*--- Structures ---*/
+
+/* Single token, a view into the source buffer */
+typedef struct MIST_TOKEN
+{
+    UINT32  Offset;                     /* offset of first character in source buffer */
+    UINT32  Length;                     /* number of characters */
+    UINT16  Kind;                       /* token kind, MIST_TK_xxx */
+    UINT16  Id;                         /* keyword, operator or punctuator id */
+} MIST_TOKEN;
+
+/* ST source file, read once into a single buffer */
+typedef struct MIST_SOURCE
+{
+    CHAR   *pBuf;                       /* source text, terminated by an additional 0 */
+    UINT32  Length;                     /* length of source text in bytes */
+    CHAR    FileName[M_PATHLEN_A];      /* path/name of source file */
+} MIST_SOURCE;
+
+/* Memory block of an arena, the data follows directly behind */
+typedef struct MIST_ARENA_BLK
+{
+    struct MIST_ARENA_BLK *pNext;       /* previously allocated block */
+    UINT32  Size;                       /* usable size of this block in bytes */
+    UINT32  Used;                       /* bytes already handed out */
+    UINT32  Spare;                      /* keeps the header a multiple of MIST_ARENA_ALIGN */
+} MIST_ARENA_BLK;
+
+/* Bump allocator, everything is released at once with mist_ArenaFree() */
+typedef struct MIST_ARENA
+{
+    MIST_ARENA_BLK *pBlk;               /* current block, head of the block list */
+    UINT32  BlkSize;                    /* size of a regular block */
+    UINT32  NbOfBytes;                  /* total bytes handed out */
+} MIST_ARENA;
+
+/* Declared variable */
+typedef struct MIST_VAR
+{
+    struct MIST_VAR *pNext;             /* next variable of the POU in declaration order */
+    struct MIST_VAR *pHashNext;         /* next variable with the same name hash */
+    CHAR   *pName;                      /* name as declared, copied into the arena */
+    UINT16  Type;                       /* elementary data type, MIST_KW_BOOL .. MIST_KW_LWORD */
+    UINT16  Class;                      /* declaration section, MIST_KW_VAR .. MIST_KW_VAR_TEMP */
+    UINT16  Flags;                      /* MIST_VF_xxx */
+    UINT16  NbOfDims;                   /* 0 = scalar, else number of array dimensions */
+    SINT32  Lower[MIST_MAX_DIMS];       /* lower bound of each array dimension */
+    SINT32  Upper[MIST_MAX_DIMS];       /* upper bound of each array dimension */
+    struct MIST_NODE *pInit;            /* initial value, list of values for arrays, NULL = 0 */
+    UINT32  Index;                      /* declaration index within the POU */
+    UINT32  Offset;                     /* source offset of the declaration */
+    UINT32  MemOffset;                  /* offset in the data area, set by the compiler */
+    UINT32  ElemSize;                   /* size of an element in bytes, set by the compiler */
+} MIST_VAR;
+
+/* Node of the abstract syntax tree, the meaning of the links depends on Type */
+typedef struct MIST_NODE
+{
+    UINT16  Type;                       /* node type, MIST_N_xxx */
+    UINT16  Op;                         /* operator id MIST_OP_xxx of unary and binary nodes */
+    UINT16  DataType;                   /* data type of literals (MIST_KW_xxx), 0 = untyped */
+    UINT16  Class;                      /* computation class MIST_CLS_xxx, set by the compiler */
+    UINT32  Offset;                     /* source offset of the first token */
+    struct MIST_NODE *pNext;            /* next element of a statement, argument or label list */
+    struct MIST_NODE *pA;               /* operands and expressions, see MIST_N_xxx */
+    struct MIST_NODE *pB;
+    struct MIST_NODE *pC;
+    struct MIST_NODE *pD;
+    struct MIST_NODE *pBody;            /* statement list */
+    struct MIST_NODE *pElse;            /* ELSE statement list */
+    union
+    {
+        SINT32  Int;                    /* MIST_N_INT, MIST_N_INITREP */
+        REAL64  Real;                   /* MIST_N_REAL */
+        MIST_VAR *pVar;                 /* MIST_N_VAR */
+        CHAR   *pName;                  /* MIST_N_CALL, copied into the arena */
+    } u;
+} MIST_NODE;
+
+/* Program organization unit (POU) */
+typedef struct MIST_POU
+{
+    struct MIST_POU *pNext;             /* next POU of the compilation unit */
+    CHAR   *pName;                      /* name, copied into the arena */
+    UINT32  Kind;                       /* MIST_KW_PROGRAM */
+    MIST_VAR *pVars;                    /* variables in declaration order */
+    UINT32  NbOfVars;                   /* number of variables */
+    MIST_VAR **ppVarHash;               /* name hash table, MIST_VAR_HASHSIZE entries */
+    MIST_NODE *pBody;                   /* statement list */
+    UINT32  Offset;                     /* source offset of the POU */
+    UINT32  Length;                     /* source length of the POU up to END_xxx */
+} MIST_POU;
+
+/* Compilation unit, all POUs and nodes are allocated from its arena */
+typedef struct MIST_UNIT
+{
+    MIST_ARENA Arena;                   /* arena for POUs, variables, nodes and names */
+    MIST_POU *pPous;                    /* POUs in source order */
+    UINT32  NbOfPous;                   /* number of POUs */
+    UINT32  NbOfNodes;                  /* number of syntax tree nodes */
+    UINT32  ErrLine;                    /* line of the first error, 0 = no error */
+    CHAR    ErrText[128];               /* text of the first error */
+} MIST_UNIT;
+
+/* Lexer state */
+typedef struct MIST_LEXER
+{
+    const CHAR *pSrc;                   /* source buffer, not necessarily terminated */
+    UINT32  Length;                     /* length of source buffer in bytes */
+    UINT32  Pos;                        /* offset of next character to be scanned */
+} MIST_LEXER;
+
+
+/*--- Function prototyping ---*/
+
+/* Functions: source files, defined in mist_prg.c */
+EXTERN SINT32 mist_SrcLoad(MIST_SOURCE * pSrc, const CHAR * pFileName);
+EXTERN VOID mist_SrcFree(MIST_SOURCE * pSrc);
+EXTERN UINT32 mist_SrcHash(const CHAR * pSrc, UINT32 Length);
+
+/* Functions: lexer, defined in mist_prg.c */
+EXTERN VOID mist_LexInit(MIST_LEXER * pLex, const CHAR * pSrc, UINT32 Length);
+EXTERN UINT32 mist_LexNext(MIST_LEXER * pLex, MIST_TOKEN * pTok);
+EXTERN UINT32 mist_LexKeywordId(const CHAR * pStr, UINT32 Length);
+EXTERN UINT32 mist_LexLine(const CHAR * pSrc, UINT32 Offset);
+EXTERN BOOL mist_LexPou(const CHAR * pSrc, UINT32 Length, UINT32 Offset, UINT32 * pStart, UINT32 * pEnd);
+EXTERN const CHAR *mist_LexKindName(UINT32 Kind);
+
+/* Functions: arena, defined in mist_parse.c */
+EXTERN VOID mist_ArenaInit(MIST_ARENA * pArena, UINT32 BlkSize);
+EXTERN VOID *mist_ArenaAlloc(MIST_ARENA * pArena, UINT32 Size);
+EXTERN VOID mist_ArenaFree(MIST_ARENA * pArena);
+
+/* Functions: parser, defined in mist_parse.c */
+EXTERN SINT32 mist_Parse(MIST_UNIT * pUnit, const CHAR * pSrc, UINT32 Length);
+EXTERN VOID mist_UnitFree(MIST_UNIT * pUnit);
+EXTERN MIST_VAR *mist_VarFind(const MIST_POU * pPou, const CHAR * pName, UINT32 Length);
+EXTERN UINT32 mist_NodeChain(const MIST_NODE * pNode);
+EXTERN MIST_NODE *mist_NodeLeft(const MIST_NODE * pNode, UINT32 Level);
+EXTERN BOOL mist_NodeElsif(const MIST_NODE * pElse);
+
+#endif /* Avoid problems with multiple include */
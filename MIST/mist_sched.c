@@ -0,0 +1,511 @@
+/**
+********************************************************************************
+* @file     mist_sched.c
+* @author   Bachmann electronic GmbH
+* @version  $Revision: 3.90 $ $LastChangedBy: BE $
+* @date     $LastChangeDate: 2013-06-10 11:00:00 $
+*
+* @brief    This file contains the schedulability check of the application
+*           tasks. Before the tasks are started, a response time analysis
+*           for fixed priority preemptive scheduling is done over all
+*           configured tasks (VxWorks: lower value = higher priority):
+*
+*               R = C + sum over all tasks j with higher or equal priority
+*                       of ceil(R / T(j)) * C(j)
+*
+*           iterated until R is stable. A task is schedulable if its worst
+*           case response time R does not exceed its cycle time T (implicit
+*           deadline). Tasks with equal priority are assumed to delay each
+*           other, which is conservative.
+*
+*           The worst case execution time C of a task is the value declared
+*           in its configuration group (WCET), otherwise the max. execution
+*           time measured since the module start (cycle statistics). Tasks
+*           without either are not checked. Interrupts and tasks of other
+*           modules are not included, declared values should have a margin.
+*
+*           If the priorities are not ordered by the cycle times, the rate
+*           monotonic order is suggested. It is optimal: if the tasks are
+*           not schedulable with it, no other priority order helps.
+*
+*           On a multi-core CPU, tasks bound to different cores do not delay
+*           each other, the analysis is done per core. A task which is not
+*           bound to a core may run on any core and is counted on all of them.
+*           With Partition = "Auto", the tasks without a configured core are
+*           distributed by their load U = C / T (worst fit decreasing): the
+*           task with the highest load first, each to the core with the least
+*           load so far, including the tasks with a configured core.
+*
+*           Usage:
+*           - Check = "Warn" (default) in the configuration group Scheduling
+*             logs the result at EOI, "Refuse" does not start the tasks if
+*             they are not schedulable, "Off" disables the check
+*           - Partition = "Auto" in the configuration group Scheduling
+*             distributes the tasks with Core = -1 on the cores at EOI
+*           - mist_SchedShow() prints the analysis of the running tasks
+*             with their current max. execution times
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <stdio.h>
+#include <string.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <prof_e.h>
+
+/* Project includes */
+#include "mist_e.h"
+#include "mist_int.h"
+
+/* Modes of the check, mconfig (Scheduling)Check */
+#define SCHED_OFF        0               /* no check */
+#define SCHED_WARN       1               /* log the result */
+#define SCHED_REFUSE     2               /* do not start the tasks if not schedulable */
+
+/* Modes of the partitioner, mconfig (Scheduling)Partition */
+#define SCHED_PART_OFF   0               /* tasks with Core = -1 run on any core */
+#define SCHED_PART_AUTO  1               /* tasks with Core = -1 are distributed by their load */
+
+/* Lowest task priority on VxWorks */
+#define SCHED_PRIO_MAX   255
+
+/* A task in the analysis */
+typedef struct SCHED_TASK
+{
+    TASK_PROPERTIES *pTaskData;         /* task */
+    UINT32  Period;                     /* cycle time in us */
+    UINT32  Wcet;                       /* worst case execution time in us, 0 = unknown */
+    UINT32  Prio;                       /* priority, lower value = higher priority */
+    SINT32  Core;                       /* CPU core, -1 = any core */
+    UINT32  Resp;                       /* worst case response time in us, > Period = deadline missed */
+} SCHED_TASK;
+
+/* Functions: system global, see mist_int.h */
+SINT32  mist_SchedCfgRead(VOID);
+SINT32  mist_SchedCheck(TASK_PROPERTIES ** pTaskList, UINT32 NbOfTasks);
+VOID    mist_SchedPartition(TASK_PROPERTIES ** pTaskList, UINT32 NbOfTasks, UINT32 NbOfCores);
+VOID    mist_SchedPrint(TASK_PROPERTIES ** pTaskList, UINT32 NbOfTasks);
+
+/* Functions: local */
+MLOCAL UINT32 Sched_Load(SCHED_TASK * pSet, TASK_PROPERTIES ** pTaskList, UINT32 NbOfTasks);
+MLOCAL UINT32 Sched_Analyze(SCHED_TASK * pSet, UINT32 NbOfTasks);
+MLOCAL BOOL Sched_Suggest(SCHED_TASK * pSet, UINT32 NbOfTasks);
+
+/* Mode of the check and of the partitioner */
+MLOCAL UINT32 SchedCheck = SCHED_WARN;
+MLOCAL UINT32 SchedPartition = SCHED_PART_OFF;
+
+/**
+********************************************************************************
+* @brief Reads the mode of the schedulability check and of the partitioner
+*        from the configuration group Scheduling. Being called by mist_CfgRead.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+*******************************************************************************/
+SINT32 mist_SchedCfgRead(VOID)
+{
+    SINT32  ret;
+    SINT32  TmpVal;
+    CHAR    section[PF_KEYLEN_A];
+    CHAR    Func[] = "mist_SchedCfgRead";
+
+    snprintf(section, sizeof(section), mist_BaseParams.AppName);
+
+    ret = pf_GetInt(section, "Scheduling", "Check", SchedCheck, &TmpVal,
+                    mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
+    /* keyword has been found */
+    if ((ret >= 0) && (TmpVal >= SCHED_OFF) && (TmpVal <= SCHED_REFUSE))
+    {
+        SchedCheck = TmpVal;
+    }
+    /* keyword has not been found */
+    else
+    {
+        LOG_W(0, Func, "Missing configuration parameter '[%s](Scheduling)Check'", section);
+        LOG_W(0, Func, " -> using initialization value of %d", SchedCheck);
+    }
+
+    ret = pf_GetInt(section, "Scheduling", "Partition", SchedPartition, &TmpVal,
+                    mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
+    /* keyword has been found */
+    if ((ret >= 0) && (TmpVal >= SCHED_PART_OFF) && (TmpVal <= SCHED_PART_AUTO))
+    {
+        SchedPartition = TmpVal;
+    }
+    /* keyword has not been found */
+    else
+    {
+        LOG_W(0, Func, "Missing configuration parameter '[%s](Scheduling)Partition'", section);
+        LOG_W(0, Func, " -> using initialization value of %d", SchedPartition);
+    }
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Checks if the tasks are schedulable before they are started.
+*        Being called by mist_AppEOI.
+*
+* @param[in]  pTaskList   tasks to be started
+* @param[in]  NbOfTasks   number of tasks
+* @param[out] N/A
+*
+* @retval     = 0 .. OK, schedulable or not refused
+* @retval     < 0 .. ERROR, not schedulable and Check = "Refuse"
+*******************************************************************************/
+SINT32 mist_SchedCheck(TASK_PROPERTIES ** pTaskList, UINT32 NbOfTasks)
+{
+    SCHED_TASK Set[TASK_MAX];
+    SCHED_TASK Rm[TASK_MAX];
+    UINT32  NbOfKnown;
+    UINT32  NbOfMissed;
+    UINT32  NbOfMissedRm;
+    UINT32  Util = 0;
+    UINT32  i;
+    CHAR    Func[] = "mist_SchedCheck";
+
+    if ((SchedCheck == SCHED_OFF) || !NbOfTasks || (NbOfTasks > TASK_MAX))
+        return (OK);
+
+    NbOfKnown = Sched_Load(Set, pTaskList, NbOfTasks);
+    if (!NbOfKnown)
+    {
+        LOG_I(0, Func, "No execution times known yet, configure WCET to check the tasks");
+        return (OK);
+    }
+
+    NbOfMissed = Sched_Analyze(Set, NbOfTasks);
+    for (i = 0; i < NbOfTasks; i++)
+    {
+        if (!Set[i].Wcet)
+            LOG_W(0, Func, "Task %s has no execution time yet and is not checked", Set[i].pTaskData->Name);
+        else
+            Util += (UINT32) (((UINT64) Set[i].Wcet * 1000) / Set[i].Period);
+    }
+
+    /* Rate monotonic priorities, if the configured ones are ordered differently */
+    memcpy(Rm, Set, sizeof(SCHED_TASK) * NbOfTasks);
+    if (Sched_Suggest(Rm, NbOfTasks))
+    {
+        NbOfMissedRm = Sched_Analyze(Rm, NbOfTasks);
+        LOG_W(0, Func, "Priorities are not ordered by cycle time, rate monotonic order%s:",
+              (NbOfMissed && !NbOfMissedRm) ? " would be schedulable" : "");
+        for (i = 0; i < NbOfTasks; i++)
+            LOG_W(0, Func, " -> task %s (%.3f ms): priority %u instead of %u", Rm[i].pTaskData->Name,
+                  Rm[i].pTaskData->CycleTime_ms, Rm[i].Prio, Rm[i].pTaskData->Priority);
+    }
+
+    if (!NbOfMissed)
+    {
+        LOG_I(0, Func, "%u tasks are schedulable, CPU load %u.%u%%", NbOfKnown, Util / 10, Util % 10);
+        return (OK);
+    }
+
+    for (i = 0; i < NbOfTasks; i++)
+    {
+        if (Set[i].Resp > Set[i].Period)
+            LOG_W(0, Func, "Task %s misses its cycle: response time %u us > cycle time %u us (WCET %u us)",
+                  Set[i].pTaskData->Name, Set[i].Resp, Set[i].Period, Set[i].Wcet);
+    }
+
+    if (SchedCheck == SCHED_REFUSE)
+    {
+        LOG_E(0, Func, "%u of %u tasks are not schedulable, CPU load %u.%u%%, tasks are not started!", NbOfMissed,
+              NbOfKnown, Util / 10, Util % 10);
+        return (ERROR);
+    }
+
+    LOG_W(0, Func, "%u of %u tasks are not schedulable, CPU load %u.%u%%", NbOfMissed, NbOfKnown, Util / 10,
+          Util % 10);
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Binds the tasks to the CPU cores, before they are started: the
+*        configured core, or with Partition = "Auto" the core with the least
+*        load (see file header). Being called by mist_AppEOI.
+*
+* @param[in]  pTaskList   tasks to be started
+* @param[in]  NbOfTasks   number of tasks
+* @param[in]  NbOfCores   number of CPU cores available to the tasks
+* @param[out] pTaskList   CoreUsed of each task
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_SchedPartition(TASK_PROPERTIES ** pTaskList, UINT32 NbOfTasks, UINT32 NbOfCores)
+{
+    SCHED_TASK Set[TASK_MAX];
+    UINT32  Order[TASK_MAX];
+    UINT32  Load[TASK_CORE_MAX];        /* sum of C / T in 1/1000 % */
+    UINT32  Count[TASK_CORE_MAX];
+    UINT32  Util[TASK_MAX];
+    UINT32  NbOfAuto = 0;
+    UINT32  Core;
+    UINT32  i, j;
+    CHAR    Func[] = "mist_SchedPartition";
+
+    if (NbOfTasks > TASK_MAX)
+        return;
+    if (NbOfCores > TASK_CORE_MAX)
+        NbOfCores = TASK_CORE_MAX;
+
+    /* Configured cores */
+    for (i = 0; i < NbOfTasks; i++)
+    {
+        pTaskList[i]->CoreUsed = pTaskList[i]->Core;
+        if ((pTaskList[i]->Core >= 0) && ((UINT32) pTaskList[i]->Core >= NbOfCores))
+        {
+            LOG_W(0, Func, "Task %s: core %d not available (%u cores), running on any core", pTaskList[i]->Name,
+                  pTaskList[i]->Core, NbOfCores);
+            pTaskList[i]->CoreUsed = -1;
+        }
+    }
+
+    if ((SchedPartition != SCHED_PART_AUTO) || (NbOfCores < 2))
+        return;
+
+    Sched_Load(Set, pTaskList, NbOfTasks);
+    memset(Load, 0, sizeof(Load));
+    memset(Count, 0, sizeof(Count));
+
+    /* Load of the bound tasks, the others by load descending, insertion sort */
+    for (i = 0; i < NbOfTasks; i++)
+    {
+        Util[i] = (UINT32) (((UINT64) Set[i].Wcet * 100000) / Set[i].Period);
+        if (Set[i].Core >= 0)
+        {
+            Load[Set[i].Core] += Util[i];
+            Count[Set[i].Core]++;
+            continue;
+        }
+
+        for (j = NbOfAuto; (j > 0) && (Util[Order[j - 1]] < Util[i]); j--)
+            Order[j] = Order[j - 1];
+        Order[j] = i;
+        NbOfAuto++;
+    }
+
+    /* Each task to the core with the least load, tasks without known load to the one with the fewest tasks */
+    for (i = 0; i < NbOfAuto; i++)
+    {
+        Core = 0;
+        for (j = 1; j < NbOfCores; j++)
+        {
+            if ((Load[j] < Load[Core]) || ((Load[j] == Load[Core]) && (Count[j] < Count[Core])))
+                Core = j;
+        }
+        Load[Core] += Util[Order[i]];
+        Count[Core]++;
+        pTaskList[Order[i]]->CoreUsed = Core;
+    }
+
+    for (j = 0; j < NbOfCores; j++)
+    {
+        if (Load[j] > 100000)
+            LOG_W(0, Func, "Core %u: %u tasks, load %u.%u%% exceeds the core", j, Count[j], Load[j] / 1000,
+                  (Load[j] % 1000) / 100);
+        else if (Count[j])
+            LOG_I(0, Func, "Core %u: %u tasks, load %u.%u%%", j, Count[j], Load[j] / 1000, (Load[j] % 1000) / 100);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Prints the schedulability analysis of the tasks, with the rate
+*        monotonic priorities for comparison. Shell output, see mist_SchedShow().
+*
+* @param[in]  pTaskList   tasks
+* @param[in]  NbOfTasks   number of tasks
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_SchedPrint(TASK_PROPERTIES ** pTaskList, UINT32 NbOfTasks)
+{
+    SCHED_TASK Set[TASK_MAX];
+    SCHED_TASK Rm[TASK_MAX];
+    UINT32  NbOfMissed;
+    UINT32  NbOfMissedRm;
+    UINT32  i;
+
+    if (NbOfTasks > TASK_MAX)
+        return;
+
+    Sched_Load(Set, pTaskList, NbOfTasks);
+    NbOfMissed = Sched_Analyze(Set, NbOfTasks);
+    memcpy(Rm, Set, sizeof(SCHED_TASK) * NbOfTasks);
+    Sched_Suggest(Rm, NbOfTasks);
+    NbOfMissedRm = Sched_Analyze(Rm, NbOfTasks);
+
+    printf("%-15s %4s %10s %10s %5s %10s %8s %10s\n", "Task", "Core", "Cycle[us]", "WCET[us]", "Prio", "Resp[us]",
+           "RM prio", "Resp[us]");
+    for (i = 0; i < NbOfTasks; i++)
+    {
+        if (!Set[i].Wcet)
+        {
+            printf("%-15s %4d %10u %10s %5u %10s\n", Set[i].pTaskData->Name, Set[i].Core, Set[i].Period, "-",
+                   Set[i].Prio, "-");
+            continue;
+        }
+        printf("%-15s %4d %10u %10u %5u %10u%c %7u %10u%c\n", Set[i].pTaskData->Name, Set[i].Core, Set[i].Period,
+               Set[i].Wcet, Set[i].Prio, Set[i].Resp, (Set[i].Resp > Set[i].Period) ? '!' : ' ', Rm[i].Prio,
+               Rm[i].Resp, (Rm[i].Resp > Rm[i].Period) ? '!' : ' ');
+    }
+    printf("%u tasks miss their cycle, %u with rate monotonic priorities\n", NbOfMissed, NbOfMissedRm);
+}
+
+/**
+********************************************************************************
+* @brief Takes over cycle time, priority and worst case execution time of
+*        the tasks: the declared WCET, otherwise the max. execution time
+*        measured so far.
+*
+* @param[out] pSet        analysis data, NbOfTasks entries
+* @param[in]  pTaskList   tasks
+* @param[in]  NbOfTasks   number of tasks
+*
+* @retval     number of tasks with known execution time
+*******************************************************************************/
+MLOCAL UINT32 Sched_Load(SCHED_TASK * pSet, TASK_PROPERTIES ** pTaskList, UINT32 NbOfTasks)
+{
+    TASK_PROPERTIES *pTaskData;
+    UINT32  NbOfKnown = 0;
+    UINT32  i;
+
+    for (i = 0; i < NbOfTasks; i++)
+    {
+        pTaskData = pTaskList[i];
+        pSet[i].pTaskData = pTaskData;
+        pSet[i].Period = (UINT32) (pTaskData->CycleTime_ms * 1000.0 + 0.5);
+        if (!pSet[i].Period)
+            pSet[i].Period = 1;
+        pSet[i].Prio = pTaskData->Priority;
+        pSet[i].Core = pTaskData->CoreUsed;
+        pSet[i].Resp = 0;
+
+        pSet[i].Wcet = pTaskData->Wcet;
+        if (!pSet[i].Wcet)
+        {
+            pSet[i].Wcet = pTaskData->WcetMeasured;
+            if (pTaskData->Stats.ExecMax > pSet[i].Wcet)
+                pSet[i].Wcet = pTaskData->Stats.ExecMax;
+        }
+        if (pSet[i].Wcet)
+            NbOfKnown++;
+    }
+
+    return (NbOfKnown);
+}
+
+/**
+********************************************************************************
+* @brief Response time analysis, see file header. Tasks without execution
+*        time are neither checked nor counted as interference, nor are
+*        tasks bound to another core.
+*
+* @param[in]  pSet        analysis data
+* @param[in]  NbOfTasks   number of tasks
+* @param[out] pSet        Resp of each task
+*
+* @retval     number of tasks missing their cycle
+*******************************************************************************/
+MLOCAL UINT32 Sched_Analyze(SCHED_TASK * pSet, UINT32 NbOfTasks)
+{
+    UINT64  Resp;
+    UINT64  Prev;
+    UINT32  NbOfMissed = 0;
+    UINT32  i, j;
+
+    for (i = 0; i < NbOfTasks; i++)
+    {
+        pSet[i].Resp = 0;
+        if (!pSet[i].Wcet)
+            continue;
+
+        /* Fixed point iteration, stops as soon as the cycle time is exceeded */
+        Resp = pSet[i].Wcet;
+        do
+        {
+            Prev = Resp;
+            Resp = pSet[i].Wcet;
+            for (j = 0; j < NbOfTasks; j++)
+            {
+                if ((j != i) && pSet[j].Wcet && (pSet[j].Prio <= pSet[i].Prio) &&
+                    ((pSet[j].Core < 0) || (pSet[i].Core < 0) || (pSet[j].Core == pSet[i].Core)))
+                    Resp += ((Prev + pSet[j].Period - 1) / pSet[j].Period) * pSet[j].Wcet;
+            }
+        }
+        while ((Resp != Prev) && (Resp <= pSet[i].Period));
+
+        pSet[i].Resp = (Resp > 0xFFFFFFFF) ? 0xFFFFFFFF : (UINT32) Resp;
+        if (Resp > pSet[i].Period)
+            NbOfMissed++;
+    }
+
+    return (NbOfMissed);
+}
+
+/**
+********************************************************************************
+* @brief Assigns rate monotonic priorities: the shorter the cycle time, the
+*        higher the priority. The configured priorities are reused in this
+*        order, equal values are made distinct.
+*
+* @param[in]  pSet        analysis data with the configured priorities
+* @param[in]  NbOfTasks   number of tasks
+* @param[out] pSet        Prio of each task
+*
+* @retval     TRUE .. a task has a lower priority than one with a longer cycle time
+*******************************************************************************/
+MLOCAL BOOL Sched_Suggest(SCHED_TASK * pSet, UINT32 NbOfTasks)
+{
+    UINT32  Order[TASK_MAX];
+    UINT32  Prio[TASK_MAX];
+    UINT32  Tmp;
+    UINT32  i, j;
+    BOOL    Changed = FALSE;
+
+    /* Tasks by cycle time and priorities ascending, insertion sort */
+    for (i = 0; i < NbOfTasks; i++)
+    {
+        for (j = 0; j < i; j++)
+        {
+            if (((pSet[j].Period < pSet[i].Period) && (pSet[j].Prio > pSet[i].Prio)) ||
+                ((pSet[j].Period > pSet[i].Period) && (pSet[j].Prio < pSet[i].Prio)))
+                Changed = TRUE;
+        }
+
+        for (j = i; (j > 0) && ((pSet[Order[j - 1]].Period > pSet[i].Period) ||
+                                ((pSet[Order[j - 1]].Period == pSet[i].Period) &&
+                                 (pSet[Order[j - 1]].Prio > pSet[i].Prio))); j--)
+            Order[j] = Order[j - 1];
+        Order[j] = i;
+
+        Tmp = pSet[i].Prio;
+        for (j = i; (j > 0) && (Prio[j - 1] > Tmp); j--)
+            Prio[j] = Prio[j - 1];
+        Prio[j] = Tmp;
+    }
+
+    for (i = 0; i < NbOfTasks; i++)
+    {
+        if ((i > 0) && (Prio[i] <= Prio[i - 1]))
+            Prio[i] = (Prio[i - 1] < SCHED_PRIO_MAX) ? Prio[i - 1] + 1 : SCHED_PRIO_MAX;
+        pSet[Order[i]].Prio = Prio[i];
+    }
+
+    return (Changed);
+}
@@ -0,0 +1,1461 @@
+/**
+********************************************************************************
+* @file     mist_svi.c
+* @author   Bachmann electronic GmbH
+* @version  $Revision: 3.90 $ $LastChangedBy: BE $
+* @date     $LastChangeDate: 2013-06-10 11:00:00 $
+*
+* @brief    This file contains the variable index of the SVI server, the
+*           fast path for clients polling many variables.
+*
+*           All SVI variables of the module are added by mist_SviAdd(),
+*           which registers them at the SVI library (under mist_SviSema,
+*           like the SVI calls of the clients) and in the index: an
+*           array in the order of registration, its position being the
+*           handle of the variable, and the handles sorted by name for
+*           the lookup (binary search). The handles remain valid until the
+*           SVI server is closed; the index id tells a client whether its
+*           handles are still valid, e.g. after a restart of the module.
+*
+*           A client resolves its variable names once (MIST_PROC_SVIFIND)
+*           and then reads the whole list with one call (MIST_PROC_SVIREAD).
+*           The values are copied into the reply in one pass over the
+*           handles, without name lookup or an SVI message per variable.
+*           As with the SVI library, variables with lock functions are read
+*           between pSviStart and pSviEnd (pVar = NULL), the others without
+*           lock; consecutive variables of a list with the same lock are
+*           read under one lock, as a consistent set.
+*
+*           mist_SviExport() exports the variables of an ST program, using
+*           the registration table generated by the compiler (MIST_CODE_SVI).
+*           The SVI library cannot remove variables, while the data area of
+*           a program is replaced by each online change. So each variable
+*           gets an export area of its own, registered once per name and
+*           reused by all later programs with the same variable; the task
+*           copies the program values into it at the end of each cycle
+*           (mist_SviExportOut) and takes over the values written by
+*           clients at the start of the next one (mist_SviExportIn).
+*           Each access of the SVI to an export area takes its lock
+*           (Svi_AreaStart), so a client neither reads a value half copied
+*           by the task nor writes between its comparison and copy. The
+*           task never waits for the lock: it skips a locked area, which is
+*           copied by the next cycle.
+*           A program registers all its new variables with one call of
+*           mist_SviAddList(): the table is sorted by name, so the handles
+*           are merged into the index in one pass instead of one insertion
+*           per variable.
+*
+*           Instead of polling a list, a client may subscribe to it
+*           (MIST_PROC_SVISUB) and fetch only the changes (MIST_PROC_SVIUPDATE).
+*           mist_SviSubUpdate() reads the list into a packed copy and
+*           compares it with the values last sent, first with one memcmp()
+*           over all values, which is all for an unchanged plant; a numeric
+*           variable with a deadband is sent when it differs from its last
+*           sent value by more than the deadband, so a slow drift is sent as
+*           well. The reply contains the changed variables only.
+*
+*           Usage:
+*           - mist_SviBench(n, loops) in the shell measures the variables
+*             per second read by lists on an index of n variables and the
+*             size of the subscription updates
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <taskLib.h>
+#include <semLib.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+
+/* Project includes */
+#include "mist.h"
+#include "mist_e.h"
+#include "mist_int.h"
+#include "mist_prg.h"
+#include "mist_vm.h"
+
+/* Initial number of entries of the index, doubled when full */
+#define SVI_INITSIZE     256
+
+/* Alignment of the export areas, suits all SVI formats */
+#define SVI_ALIGN(x)     (((x) + 7) & ~7)
+
+/* Flags of an index entry */
+#define SVI_E_AREA       0x0001    /* export area of an ST program variable, see mist_SviExport() */
+
+/* Locks of the export areas, shared by the areas, power of 2 */
+#define SVI_AREA_LOCKS   64
+
+/* A variable in the index */
+typedef struct SVI_ENTRY
+{
+    CHAR    Name[SVI_ADDRLEN + 1];      /* visible name */
+    UINT32  Format;                     /* format and access type, SVI_F_xxx */
+    UINT32  Size;                       /* size in bytes */
+    UINT8  *pVar;                       /* value */
+    UINT32  UserParam;                  /* user parameter for pSviStart and pSviEnd */
+    SVIFKPTSTART pSviStart;             /* lock function, NULL = none */
+    SVIFKPTEND pSviEnd;                 /* unlock function, NULL = none */
+    UINT32  Flags;                      /* SVI_E_xxx */
+} SVI_ENTRY;
+
+/* Variable index */
+typedef struct SVI_INDEX
+{
+    SVI_ENTRY *pEntry;                  /* variables in the order of registration, position = handle */
+    UINT32 *pSorted;                    /* handles sorted by name */
+    UINT32  NbOfEntries;                /* number of variables */
+    UINT32  MaxEntries;                 /* allocated entries */
+    UINT32  Id;                         /* changes when the handles become invalid, never 0 */
+} SVI_INDEX;
+
+/* Block of export areas, allocated by mist_SviExport() and freed by mist_SviAreaFree() */
+typedef struct SVI_AREA
+{
+    struct SVI_AREA *pNext;             /* next block */
+} SVI_AREA;
+
+/* Exported variable of a program instance */
+typedef struct SVI_MAPVAR
+{
+    UINT32  MemOffset;                  /* offset in the data area */
+    UINT32  Size;                       /* size in bytes */
+    UINT8  *pArea;                      /* export area, registered at the SVI */
+    UINT8  *pShadow;                    /* writable: value of pArea last taken over or published, else NULL */
+    UINT32  Lock;                       /* lock of pArea, index in SviAreaLock[] */
+} SVI_MAPVAR;
+
+/* Exported variables of a program instance, a single memory block */
+typedef struct MIST_SVI_MAP
+{
+    SVI_MAPVAR *pVar;                   /* variables in the order of the registration table */
+    UINT32  NbOfVars;                   /* number of variables */
+    UINT32  NbOfWritable;               /* number of variables with pShadow */
+} MIST_SVI_MAP;
+
+/* A variable of a subscription */
+typedef struct SVI_SUBVAR
+{
+    UINT32  Format;                     /* format and access type, SVI_F_xxx */
+    UINT32  Size;                       /* size in bytes */
+    REAL32  Deadband;                   /* min. change of a numeric value to be sent, 0 = every change */
+} SVI_SUBVAR;
+
+/* Subscription of a client, see mist_SviSubscribe() */
+typedef struct SVI_SUB
+{
+    UINT32  Id;                         /* subscription id, 0 = free */
+    UINT32  IndexId;                    /* id of the index the handles belong to */
+    UINT32  LastUse;                    /* SviSubClock at the last call, the oldest one is replaced */
+    UINT32  Sent;                       /* values have been sent, pSent is valid */
+    UINT32  NbOfVars;                   /* number of variables */
+    UINT32  Size;                       /* size of the values in bytes */
+    SVI_SUBVAR *pVar;                   /* variables, a single memory block with the following */
+    UINT32 *pHandle;                    /* handles in the order of pVar */
+    UINT8  *pCur;                       /* values of the last update, packed as by Svi_Read() */
+    UINT8  *pSent;                      /* values last sent */
+} SVI_SUB;
+
+/* Functions: system global, see mist_int.h */
+SINT32  mist_SviAdd(const CHAR * pName, UINT32 Format, UINT32 Size, VOID * pVar, UINT32 UserParam,
+                    SVIFKPTSTART pSviStart, SVIFKPTEND pSviEnd);
+SINT32  mist_SviFind(const CHAR * pName, UINT32 * pFormat, UINT32 * pSize);
+SINT32  mist_SviReadList(const UINT32 * pHandle, UINT32 NbOfVars, UINT8 * pBuf, UINT32 BufSize);
+UINT32  mist_SviIndexId(VOID);
+VOID    mist_SviClear(VOID);
+SINT32  mist_SviSubscribe(const UINT32 * pHandle, const REAL32 * pDeadband, UINT32 NbOfVars);
+SINT32  mist_SviSubUpdate(UINT32 SubId, UINT32 Full, UINT8 * pBuf, UINT32 BufSize, UINT32 * pNbOfChanged);
+SINT32  mist_SviUnsubscribe(UINT32 SubId);
+SINT32  mist_SviAddList(const MIST_SVI_VAR * pList, UINT32 NbOfVars);
+MIST_SVI_MAP *mist_SviExport(const CHAR * pPrefix, const MIST_CODE * pCode, UINT32 Mode, const UINT8 * pMem);
+VOID    mist_SviExportIn(const MIST_SVI_MAP * pMap, UINT8 * pMem);
+VOID    mist_SviExportOut(const MIST_SVI_MAP * pMap, const UINT8 * pMem);
+VOID    mist_SviMapFree(MIST_SVI_MAP * pMap);
+VOID    mist_SviAreaFree(VOID);
+
+/* Functions: test functions, to be called from the shell */
+SINT32  mist_SviBench(UINT32 NbOfVars, UINT32 Loops);
+
+/* Functions: local */
+MLOCAL SINT32 Svi_Grow(SVI_INDEX * pIdx, UINT32 NbOfEntries);
+MLOCAL SINT32 Svi_AddList(SVI_INDEX * pIdx, const MIST_SVI_VAR * pList, UINT32 NbOfVars, UINT32 Flags);
+MLOCAL SINT32 Svi_Insert(SVI_INDEX * pIdx, const CHAR * pName, UINT32 Format, UINT32 Size, VOID * pVar,
+                         UINT32 UserParam, SVIFKPTSTART pSviStart, SVIFKPTEND pSviEnd);
+MLOCAL SINT32 Svi_Lookup(const SVI_INDEX * pIdx, const CHAR * pName, UINT32 * pPos);
+MLOCAL SINT32 Svi_Read(const SVI_INDEX * pIdx, const UINT32 * pHandle, UINT32 NbOfVars, UINT8 * pBuf,
+                       UINT32 BufSize);
+MLOCAL VOID Svi_Free(SVI_INDEX * pIdx);
+MLOCAL SVI_SUB *Svi_SubFind(UINT32 SubId);
+MLOCAL SINT32 Svi_SubInit(const SVI_INDEX * pIdx, SVI_SUB * pSub, const UINT32 * pHandle, const REAL32 * pDeadband,
+                          UINT32 NbOfVars);
+MLOCAL SINT32 Svi_SubUpdate(const SVI_INDEX * pIdx, SVI_SUB * pSub, UINT32 Full, UINT8 * pBuf, UINT32 BufSize,
+                            UINT32 * pNbOfChanged);
+MLOCAL BOOL Svi_SubChanged(const SVI_SUBVAR * pVar, const UINT8 * pNew, const UINT8 * pOld);
+MLOCAL SINT32 Svi_SubValue(const SVI_SUBVAR * pVar, const UINT8 * pValue, REAL64 * pNum);
+MLOCAL VOID Svi_SubFree(SVI_SUB * pSub);
+MLOCAL SINT32 Svi_AreaStart(SVI_VAR * pVar, UINT32 UserParam);
+MLOCAL VOID Svi_AreaEnd(SVI_VAR * pVar, UINT32 UserParam);
+
+/* Index of the SVI server of the module */
+MLOCAL SVI_INDEX SviIndex;
+
+/*
+ * Subscriptions of the clients, slot = lowest byte of the id. Like the
+ * index, only changed by exclusive SMI calls (see Smi_Class() in
+ * mist_module.c); updates are read calls serialized by mist_SviSema.
+ */
+MLOCAL SVI_SUB SviSubs[MIST_SVI_MAXSUBS];
+MLOCAL UINT32 SviSubClock = 0;              /* number of subscription calls, for LastUse */
+MLOCAL UINT32 SviNextSub = 0;               /* source of the subscription ids */
+
+/* Source of the index ids */
+MLOCAL UINT32 SviNextId = 0;
+
+/* Export areas of the ST programs, kept until all tasks are deleted */
+MLOCAL SVI_AREA *SviAreas = NULL;
+
+/* Locks of the export areas, 1 = locked, see Svi_AreaStart() */
+MLOCAL volatile UINT32 SviAreaLock[SVI_AREA_LOCKS];
+MLOCAL UINT32 SviNextLock = 0;              /* lock of the next new export area */
+
+/**
+********************************************************************************
+* @brief Adds a variable to the SVI server and to the index.
+*        Replaces svi_AddGlobVar(), same parameters.
+*
+* @param[in]  pName       visible name, max. length = SVI_ADDRLEN
+* @param[in]  Format      format and access type, SVI_F_xxx
+* @param[in]  Size        size in bytes
+* @param[in]  pVar        variable
+* @param[in]  UserParam   user parameter for pSviStart and pSviEnd
+* @param[in]  pSviStart   lock function, NULL = none
+* @param[in]  pSviEnd     unlock function, NULL = none
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     != 0 .. error of svi_AddGlobVar(), ERROR = not indexed (no memory)
+*******************************************************************************/
+SINT32 mist_SviAdd(const CHAR * pName, UINT32 Format, UINT32 Size, VOID * pVar, UINT32 UserParam,
+                   SVIFKPTSTART pSviStart, SVIFKPTEND pSviEnd)
+{
+    SINT32  ret;
+
+    semTake(mist_SviSema, WAIT_FOREVER);
+    ret = svi_AddGlobVar(mist_SviHandle, (CHAR *) pName, Format, Size, pVar, 0, UserParam, pSviStart, pSviEnd);
+    semGive(mist_SviSema);
+    if (ret)
+        return (ret);
+
+    /* The variable remains accessible by the SVI library */
+    if (Svi_Insert(&SviIndex, pName, Format, Size, pVar, UserParam, pSviStart, pSviEnd) < 0)
+    {
+        LOG_W(0, "mist_SviAdd", "Could not index SVI variable '%s'", pName);
+        return (ERROR);
+    }
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Looks up a variable of the SVI server by name (binary search).
+*
+* @param[in]  pName       visible name, case sensitive
+* @param[out] pFormat     format and access type, SVI_F_xxx, may be NULL
+* @param[out] pSize       size in bytes, may be NULL
+*
+* @retval     >= 0 .. handle of the variable for mist_SviReadList()
+* @retval     < 0 .. ERROR, no such variable
+*******************************************************************************/
+SINT32 mist_SviFind(const CHAR * pName, UINT32 * pFormat, UINT32 * pSize)
+{
+    const SVI_ENTRY *pEntry;
+    UINT32  Pos;
+
+    if (Svi_Lookup(&SviIndex, pName, &Pos) < 0)
+        return (ERROR);
+
+    pEntry = &SviIndex.pEntry[SviIndex.pSorted[Pos]];
+    if (pFormat)
+        *pFormat = pEntry->Format;
+    if (pSize)
+        *pSize = pEntry->Size;
+    return (SviIndex.pSorted[Pos]);
+}
+
+/**
+********************************************************************************
+* @brief Reads a list of variables of the SVI server into one buffer, the
+*        values one after the other without padding, in the order of the
+*        handles.
+*
+* @param[in]  pHandle     handles returned by mist_SviFind()
+* @param[in]  NbOfVars    number of handles
+* @param[out] pBuf        values
+* @param[in]  BufSize     size of pBuf in bytes
+*
+* @retval     >= 0 .. number of bytes written to pBuf
+* @retval     < 0 .. ERROR, invalid handle, variable not readable or locked,
+*                    or pBuf too small
+*******************************************************************************/
+SINT32 mist_SviReadList(const UINT32 * pHandle, UINT32 NbOfVars, UINT8 * pBuf, UINT32 BufSize)
+{
+    return (Svi_Read(&SviIndex, pHandle, NbOfVars, pBuf, BufSize));
+}
+
+/**
+********************************************************************************
+* @brief Id of the index, changes when the handles become invalid.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     index id, 0 = no variables
+*******************************************************************************/
+UINT32 mist_SviIndexId(VOID)
+{
+    return (SviIndex.Id);
+}
+
+/**
+********************************************************************************
+* @brief Clears the index and the subscriptions, when the SVI server is
+*        closed.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_SviClear(VOID)
+{
+    UINT32  i;
+
+    for (i = 0; i < MIST_SVI_MAXSUBS; i++)
+        Svi_SubFree(&SviSubs[i]);
+    Svi_Free(&SviIndex);
+}
+
+/**
+********************************************************************************
+* @brief Subscribes to the changes of a list of variables of the SVI server,
+*        see mist_SviSubUpdate(). If all MIST_SVI_MAXSUBS subscriptions are
+*        in use, the least recently used one is replaced, e.g. the one of a
+*        client which has gone without mist_SviUnsubscribe().
+*
+* @param[in]  pHandle     handles returned by mist_SviFind()
+* @param[in]  pDeadband   min. change of each numeric variable to be sent,
+*                         0 = every change; other variables are sent on
+*                         every change
+* @param[in]  NbOfVars    number of variables, max. MIST_SVI_MAXLIST
+* @param[out] N/A
+*
+* @retval     > 0 .. id of the subscription
+* @retval     < 0 .. ERROR, invalid handle, variable not readable, negative
+*                    deadband, values larger than MIST_SVI_MAXDATA or no memory
+*******************************************************************************/
+SINT32 mist_SviSubscribe(const UINT32 * pHandle, const REAL32 * pDeadband, UINT32 NbOfVars)
+{
+    SVI_SUB *pSub = NULL;
+    SVI_SUB New;
+    UINT32  i;
+
+    memset(&New, 0, sizeof(New));
+    if (Svi_SubInit(&SviIndex, &New, pHandle, pDeadband, NbOfVars) < 0)
+        return (ERROR);
+
+    /* A free slot or the least recently used one */
+    for (i = 0; i < MIST_SVI_MAXSUBS; i++)
+    {
+        if (!SviSubs[i].Id)
+        {
+            pSub = &SviSubs[i];
+            break;
+        }
+        if (!pSub || (SviSubClock - SviSubs[i].LastUse > SviSubClock - pSub->LastUse))
+            pSub = &SviSubs[i];
+    }
+    if (pSub->Id)
+    {
+        LOG_I(0, "mist_SviSubscribe", "Subscription %08x unused for %u calls, replaced", pSub->Id,
+              SviSubClock - pSub->LastUse);
+        Svi_SubFree(pSub);
+    }
+    *pSub = New;
+
+    /* Ids are positive and differ from the previous ones of the slot */
+    do
+        SviNextSub++;
+    while (!(SviNextSub & 0x7FFFFF));
+    pSub->Id = ((SviNextSub & 0x7FFFFF) << 8) | (UINT32) (pSub - SviSubs);
+    pSub->LastUse = ++SviSubClock;
+    return (pSub->Id);
+}
+
+/**
+********************************************************************************
+* @brief Reads the variables of a subscription and copies those which have
+*        changed since they were last sent into one buffer: for each one the
+*        position in the subscribed list (UINT32) followed by the value,
+*        without padding. The first call after the subscription returns all
+*        variables.
+*
+* @param[in]  SubId       id returned by mist_SviSubscribe()
+* @param[in]  Full        TRUE = all variables, e.g. after a lost reply
+* @param[out] pBuf        positions and values
+* @param[in]  BufSize     size of pBuf in bytes, MIST_SVI_MAXUPDATE suits every
+*                         subscription
+* @param[out] pNbOfChanged number of variables in pBuf
+*
+* @retval     >= 0 .. number of bytes written to pBuf
+* @retval     < 0 .. ERROR, no such subscription, the handles have become
+*                    invalid, variable locked or pBuf too small
+*******************************************************************************/
+SINT32 mist_SviSubUpdate(UINT32 SubId, UINT32 Full, UINT8 * pBuf, UINT32 BufSize, UINT32 * pNbOfChanged)
+{
+    SVI_SUB *pSub = Svi_SubFind(SubId);
+
+    *pNbOfChanged = 0;
+    if (!pSub)
+        return (ERROR);
+    pSub->LastUse = ++SviSubClock;
+    return (Svi_SubUpdate(&SviIndex, pSub, Full, pBuf, BufSize, pNbOfChanged));
+}
+
+/**
+********************************************************************************
+* @brief Cancels a subscription.
+*
+* @param[in]  SubId       id returned by mist_SviSubscribe()
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, no such subscription
+*******************************************************************************/
+SINT32 mist_SviUnsubscribe(UINT32 SubId)
+{
+    SVI_SUB *pSub = Svi_SubFind(SubId);
+
+    if (!pSub)
+        return (ERROR);
+    Svi_SubFree(pSub);
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Adds a list of variables to the SVI server and to the index, like
+*        mist_SviAdd(). A list sorted by name (strcmp) is merged into the
+*        index in one pass.
+*
+* @param[in]  pList       variables
+* @param[in]  NbOfVars    number of variables
+* @param[out] N/A
+*
+* @retval     >= 0 .. number of variables added, the others are logged
+* @retval     < 0 .. ERROR, no memory, no variable has been added
+*******************************************************************************/
+SINT32 mist_SviAddList(const MIST_SVI_VAR * pList, UINT32 NbOfVars)
+{
+    return (Svi_AddList(&SviIndex, pList, NbOfVars, 0));
+}
+
+/**
+********************************************************************************
+* @brief Exports the variables of an ST program to the SVI as
+*        "<prefix>/<name>". Variables already exported by an earlier program
+*        (same name, format and size) keep their export area and handle,
+*        the new ones get areas initialized from pMem and are added by one
+*        call of Svi_AddList(), with the lock functions of the export areas.
+*        A name used with another format is not
+*        exported until the module is restarted.
+*        Called by the bTask while the program instance is not running.
+*
+* @param[in]  pPrefix     prefix of the names, e.g. "<task group>/<program>"
+* @param[in]  pCode       compiled program with its registration table
+* @param[in]  Mode        selection of the variables, MIST_SVIEXP_xxx
+* @param[in]  pMem        data area of the program instance
+* @param[out] N/A
+*
+* @retval     != NULL .. exported variables, release with mist_SviMapFree()
+* @retval     = NULL  .. nothing exported
+*******************************************************************************/
+MIST_SVI_MAP *mist_SviExport(const CHAR * pPrefix, const MIST_CODE * pCode, UINT32 Mode, const UINT8 * pMem)
+{
+    const MIST_CODE_SVI *pCs;
+    const SVI_ENTRY *pEntry;
+    MIST_SVI_MAP *pMap;
+    SVI_MAPVAR *pMv;
+    MIST_SVI_VAR *pList;
+    UINT32 *pNewPos;
+    CHAR   *pName;
+    SVI_AREA *pBlk;
+    UINT8  *pArea;
+    UINT32  NbOfNew = 0;
+    UINT32  AreaSize = 0;
+    UINT32  Pos;
+    UINT32  i;
+    CHAR    Func[] = "mist_SviExport";
+
+    if (!mist_SviHandle || (Mode == MIST_SVIEXP_OFF) || !pCode->NbOfSvis)
+        return (NULL);
+
+    pMap = malloc(sizeof(MIST_SVI_MAP) + pCode->NbOfSvis * sizeof(SVI_MAPVAR));
+    pList = malloc(pCode->NbOfSvis * (sizeof(MIST_SVI_VAR) + sizeof(UINT32) + SVI_ADDRLEN + 1));
+    if (!pMap || !pList)
+    {
+        LOG_E(0, Func, "No memory for the SVI export of program '%s'!", pCode->Name);
+        free(pMap);
+        free(pList);
+        return (NULL);
+    }
+    pMap->pVar = (SVI_MAPVAR *) (pMap + 1);
+    pMap->NbOfVars = 0;
+    pMap->NbOfWritable = 0;
+    pNewPos = (UINT32 *) (pList + pCode->NbOfSvis);
+    pName = (CHAR *) (pNewPos + pCode->NbOfSvis);
+
+    /* Known names take their area, the new ones are collected in table order */
+    for (i = 0, pCs = pCode->pSvi; i < pCode->NbOfSvis; i++, pCs++)
+    {
+        if ((Mode == MIST_SVIEXP_ATTR) && !pCs->Flags)
+            continue;
+        if (snprintf(pName, SVI_ADDRLEN + 1, "%s/%s", pPrefix, pCs->pName) > SVI_ADDRLEN)
+        {
+            LOG_W(0, Func, "SVI name of '%s' in program '%s' is too long, not exported", pCs->pName, pCode->Name);
+            continue;
+        }
+
+        pMv = &pMap->pVar[pMap->NbOfVars];
+        pMv->MemOffset = pCs->MemOffset;
+        pMv->Size = pCs->Size;
+        pMv->pShadow = NULL;
+        if (Svi_Lookup(&SviIndex, pName, &Pos) == OK)
+        {
+            pEntry = &SviIndex.pEntry[SviIndex.pSorted[Pos]];
+            if (!(pEntry->Flags & SVI_E_AREA) || (pEntry->Format != pCs->Format) || (pEntry->Size != pCs->Size))
+            {
+                LOG_W(0, Func, "SVI variable '%s' exists with another format, not exported until restart", pName);
+                continue;
+            }
+            pMv->pArea = pEntry->pVar;
+            pMv->Lock = pEntry->UserParam;
+            if (pCs->Format & SVI_F_IN)
+                pMv->pShadow = pEntry->pVar + SVI_ALIGN(pCs->Size);
+        }
+        else
+        {
+            pList[NbOfNew].pName = pName;
+            pList[NbOfNew].Format = pCs->Format;
+            pList[NbOfNew].Size = pCs->Size;
+            pList[NbOfNew].UserParam = SviNextLock++ & (SVI_AREA_LOCKS - 1);
+            pList[NbOfNew].pSviStart = Svi_AreaStart;
+            pList[NbOfNew].pSviEnd = Svi_AreaEnd;
+            pMv->Lock = pList[NbOfNew].UserParam;
+            pNewPos[NbOfNew++] = pMap->NbOfVars;
+            AreaSize += SVI_ALIGN(pCs->Size) * ((pCs->Format & SVI_F_IN) ? 2 : 1);
+            pName += SVI_ADDRLEN + 1;
+        }
+        pMap->NbOfWritable += (pCs->Format & SVI_F_IN) ? 1 : 0;
+        pMap->NbOfVars++;
+    }
+
+    /* Areas of the new variables, with the value before the first cycle */
+    if (NbOfNew)
+    {
+        pBlk = malloc(SVI_ALIGN(sizeof(SVI_AREA)) + AreaSize);
+        if (!pBlk)
+        {
+            LOG_E(0, Func, "No memory for the SVI export of program '%s'!", pCode->Name);
+            free(pMap);
+            free(pList);
+            return (NULL);
+        }
+        pBlk->pNext = SviAreas;
+        SviAreas = pBlk;
+
+        pArea = (UINT8 *) pBlk + SVI_ALIGN(sizeof(SVI_AREA));
+        for (i = 0; i < NbOfNew; i++)
+        {
+            pMv = &pMap->pVar[pNewPos[i]];
+            pMv->pArea = pArea;
+            memcpy(pArea, pMem + pMv->MemOffset, pMv->Size);
+            pArea += SVI_ALIGN(pMv->Size);
+            if (pList[i].Format & SVI_F_IN)
+            {
+                pMv->pShadow = pArea;
+                memcpy(pArea, pMem + pMv->MemOffset, pMv->Size);
+                pArea += SVI_ALIGN(pMv->Size);
+            }
+            pList[i].pVar = pMv->pArea;
+        }
+        if (Svi_AddList(&SviIndex, pList, NbOfNew, SVI_E_AREA) < 0)
+            LOG_E(0, Func, "No memory to add the SVI variables of program '%s'!", pCode->Name);
+    }
+    free(pList);
+
+    if (!pMap->NbOfVars)
+    {
+        free(pMap);
+        return (NULL);
+    }
+    LOG_I(0, Func, "Program '%s': %u variables exported as %s/..., %u writable, %u added", pCode->Name,
+          pMap->NbOfVars, pPrefix, pMap->NbOfWritable, NbOfNew);
+    return (pMap);
+}
+
+/**
+********************************************************************************
+* @brief Takes over the values written by SVI clients into the program,
+*        at the start of a cycle. A client value is recognized by the
+*        difference to the shadow copy and copied to the shadow under the
+*        lock of the area. A variable locked by the SVI is taken over by
+*        the next cycle.
+*
+* @param[in]  pMap        exported variables
+* @param[in]  pMem        data area of the program instance
+* @param[out] pMem        values written by clients
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_SviExportIn(const MIST_SVI_MAP * pMap, UINT8 * pMem)
+{
+    const SVI_MAPVAR *pMv;
+    volatile UINT32 *pLock;
+    BOOL    Changed;
+    UINT32  i;
+
+    if (!pMap->NbOfWritable)
+        return;
+
+    for (i = 0, pMv = pMap->pVar; i < pMap->NbOfVars; i++, pMv++)
+    {
+        pLock = &SviAreaLock[pMv->Lock];
+        if (!pMv->pShadow || !MIST_CAS(pLock, 0, 1))
+            continue;
+        MIST_BARRIER();
+        Changed = memcmp(pMv->pArea, pMv->pShadow, pMv->Size) ? TRUE : FALSE;
+        if (Changed)
+            memcpy(pMv->pShadow, pMv->pArea, pMv->Size);
+        MIST_BARRIER();
+        *pLock = 0;
+
+        if (Changed)
+            memcpy(pMem + pMv->MemOffset, pMv->pShadow, pMv->Size);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Publishes the values of the program in the export areas, at the
+*        end of a cycle, each under the lock of its area. A writable
+*        variable with a client value not taken over yet keeps it until the
+*        next cycle start. A variable locked by the SVI is published by the
+*        next cycle.
+*
+* @param[in]  pMap        exported variables
+* @param[in]  pMem        data area of the program instance
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_SviExportOut(const MIST_SVI_MAP * pMap, const UINT8 * pMem)
+{
+    const SVI_MAPVAR *pMv;
+    volatile UINT32 *pLock;
+    UINT32  i;
+
+    for (i = 0, pMv = pMap->pVar; i < pMap->NbOfVars; i++, pMv++)
+    {
+        pLock = &SviAreaLock[pMv->Lock];
+        if (!MIST_CAS(pLock, 0, 1))
+            continue;
+        MIST_BARRIER();
+        if (!pMv->pShadow || !memcmp(pMv->pArea, pMv->pShadow, pMv->Size))
+        {
+            if (pMv->pShadow)
+                memcpy(pMv->pShadow, pMem + pMv->MemOffset, pMv->Size);
+            memcpy(pMv->pArea, pMem + pMv->MemOffset, pMv->Size);
+        }
+        MIST_BARRIER();
+        *pLock = 0;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Releases the exported variables of a program instance. The export
+*        areas and their SVI variables remain.
+*
+* @param[in]  pMap        exported variables, NULL = none
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_SviMapFree(MIST_SVI_MAP * pMap)
+{
+    free(pMap);
+}
+
+/**
+********************************************************************************
+* @brief Frees the export areas of all programs. To be called after all
+*        tasks and the SVI server have been deleted.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_SviAreaFree(VOID)
+{
+    SVI_AREA *pBlk;
+
+    while (SviAreas)
+    {
+        pBlk = SviAreas;
+        SviAreas = pBlk->pNext;
+        free(pBlk);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Benchmark of the list read, to be called from the shell. Builds a
+*        separate index of synthetic UINT32 variables, not visible by SVI,
+*        and reads them all in lists of MIST_SVI_MAXLIST variables.
+*        For comparison, the same variables are read one by one with a
+*        lookup by name each, like separate SVI requests do.
+*        Finally a subscription of MIST_SVI_MAXLIST variables is updated
+*        with one variable changed per update, a slowly changing plant.
+*        Example: mist_SviBench 5000, 1000
+*
+* @param[in]  NbOfVars    number of variables, 0 = 5000
+* @param[in]  Loops       number of reads of all variables, 0 = 100
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, no memory
+*******************************************************************************/
+SINT32 mist_SviBench(UINT32 NbOfVars, UINT32 Loops)
+{
+    SVI_INDEX Idx;
+    SVI_SUB Sub;
+    UINT32 *pVars;
+    UINT32 *pHandle;
+    REAL32 *pDeadband;
+    UINT8  *pBuf;
+    CHAR    Name[SVI_ADDRLEN + 1];
+    UINT32  Pos;
+    UINT32  Time, TimeList, TimeFind, TimeSub;
+    UINT32  i, j, n;
+    UINT32  Sum = 0;
+    UINT32  Sent = 0;
+
+    if (!NbOfVars)
+        NbOfVars = 5000;
+    if (!Loops)
+        Loops = 100;
+
+    memset(&Idx, 0, sizeof(Idx));
+    memset(&Sub, 0, sizeof(Sub));
+    pVars = malloc(NbOfVars * sizeof(UINT32));
+    pHandle = malloc(NbOfVars * sizeof(UINT32));
+    pDeadband = calloc(MIST_SVI_MAXLIST, sizeof(REAL32));
+    pBuf = malloc(MIST_SVI_MAXUPDATE);
+    for (i = 0; pVars && pHandle && pDeadband && pBuf && (i < NbOfVars); i++)
+    {
+        pVars[i] = i;
+        snprintf(Name, sizeof(Name), "Bench/Group%03u/Var%05u", (i * 7919) % 997, i);
+        if (Svi_Insert(&Idx, Name, SVI_F_OUT | SVI_F_UINT32, sizeof(UINT32), &pVars[i], 0, NULL, NULL) < 0)
+            break;
+    }
+    if (i < NbOfVars)
+    {
+        printf("mist_SviBench: no memory\n");
+        Svi_Free(&Idx);
+        free(pVars);
+        free(pHandle);
+        free(pDeadband);
+        free(pBuf);
+        return (ERROR);
+    }
+
+    /* The client resolves the names once */
+    Time = m_GetProcTime();
+    for (i = 0; i < NbOfVars; i++)
+    {
+        snprintf(Name, sizeof(Name), "Bench/Group%03u/Var%05u", (i * 7919) % 997, i);
+        Svi_Lookup(&Idx, Name, &Pos);
+        pHandle[i] = Idx.pSorted[Pos];
+    }
+    Time = m_GetProcTime() - Time;
+    printf("mist_SviBench: %u variables resolved in %u us\n", NbOfVars, Time);
+
+    /* List reads */
+    Time = m_GetProcTime();
+    for (j = 0; j < Loops; j++)
+    {
+        for (i = 0; i < NbOfVars; i += n)
+        {
+            n = (NbOfVars - i < MIST_SVI_MAXLIST) ? NbOfVars - i : MIST_SVI_MAXLIST;
+            Svi_Read(&Idx, &pHandle[i], n, pBuf, MIST_SVI_MAXLIST * sizeof(UINT32));
+            Sum += pBuf[0];
+        }
+    }
+    TimeList = m_GetProcTime() - Time;
+
+    /* One lookup by name and read per variable */
+    Time = m_GetProcTime();
+    for (j = 0; j < Loops / 10 + 1; j++)
+    {
+        for (i = 0; i < NbOfVars; i++)
+        {
+            snprintf(Name, sizeof(Name), "Bench/Group%03u/Var%05u", (i * 7919) % 997, i);
+            if (Svi_Lookup(&Idx, Name, &Pos) == OK)
+                Svi_Read(&Idx, &Idx.pSorted[Pos], 1, pBuf, sizeof(UINT32));
+            Sum += pBuf[0];
+        }
+    }
+    TimeFind = m_GetProcTime() - Time;
+
+    /* Subscription, one variable changes per update */
+    n = (NbOfVars < MIST_SVI_MAXLIST) ? NbOfVars : MIST_SVI_MAXLIST;
+    TimeSub = 0;
+    if (Svi_SubInit(&Idx, &Sub, pHandle, pDeadband, n) == OK)
+    {
+        Svi_SubUpdate(&Idx, &Sub, FALSE, pBuf, MIST_SVI_MAXUPDATE, &i);
+        Time = m_GetProcTime();
+        for (j = 0; j < Loops; j++)
+        {
+            pVars[pHandle[j % n]]++;
+            Sent += Svi_SubUpdate(&Idx, &Sub, FALSE, pBuf, MIST_SVI_MAXUPDATE, &i);
+        }
+        TimeSub = m_GetProcTime() - Time;
+    }
+
+    printf("mist_SviBench: list read   %u x %u variables in %u us = %.0f variables/s\n", Loops, NbOfVars,
+           TimeList, TimeList ? (REAL64) Loops * NbOfVars * 1e6 / TimeList : 0.0);
+    printf("mist_SviBench: single read %u x %u variables in %u us = %.0f variables/s (%u)\n", Loops / 10 + 1,
+           NbOfVars, TimeFind, TimeFind ? (REAL64) (Loops / 10 + 1) * NbOfVars * 1e6 / TimeFind : 0.0, Sum & 1);
+    printf("mist_SviBench: subscription %u x %u variables in %u us, %u bytes sent instead of %u\n", Loops, n,
+           TimeSub, Sent, Loops * n * (UINT32) sizeof(UINT32));
+
+    Svi_SubFree(&Sub);
+    Svi_Free(&Idx);
+    free(pVars);
+    free(pHandle);
+    free(pDeadband);
+    free(pBuf);
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Makes room for a number of entries in an index, the size is
+*        doubled as often as needed. Assigns the index id to a new index.
+*
+* @param[in]  pIdx        index
+* @param[in]  NbOfEntries number of entries needed
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, no memory
+*******************************************************************************/
+MLOCAL SINT32 Svi_Grow(SVI_INDEX * pIdx, UINT32 NbOfEntries)
+{
+    SVI_ENTRY *pEntry;
+    UINT32 *pSorted;
+    UINT32  Max = pIdx->MaxEntries ? pIdx->MaxEntries : SVI_INITSIZE;
+
+    while (Max < NbOfEntries)
+        Max *= 2;
+    if (Max > pIdx->MaxEntries)
+    {
+        pEntry = realloc(pIdx->pEntry, Max * sizeof(SVI_ENTRY));
+        if (!pEntry)
+            return (ERROR);
+        pIdx->pEntry = pEntry;
+        pSorted = realloc(pIdx->pSorted, Max * sizeof(UINT32));
+        if (!pSorted)
+            return (ERROR);
+        pIdx->pSorted = pSorted;
+        pIdx->MaxEntries = Max;
+    }
+    if (!pIdx->Id)
+    {
+        pIdx->Id = (m_GetProcTime() & 0xFFFF0000) | (++SviNextId & 0xFFFF);
+        if (!pIdx->Id)
+            pIdx->Id = 1;
+    }
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Registers a list of variables at the SVI server and appends those
+*        accepted to an index. If the names are sorted, the new handles are
+*        merged with the sorted handles in one pass, otherwise they are
+*        inserted one by one.
+*
+* @param[in]  pIdx        index
+* @param[in]  pList       variables
+* @param[in]  NbOfVars    number of variables
+* @param[in]  Flags       SVI_E_xxx of the entries
+* @param[out] N/A
+*
+* @retval     >= 0 .. number of variables added
+* @retval     < 0 .. ERROR, no memory
+*******************************************************************************/
+MLOCAL SINT32 Svi_AddList(SVI_INDEX * pIdx, const MIST_SVI_VAR * pList, UINT32 NbOfVars, UINT32 Flags)
+{
+    SVI_ENTRY *pEntry;
+    UINT32 *pMerged;
+    UINT32  First = pIdx->NbOfEntries;
+    UINT32  Last = First;
+    UINT32  Pos, Old, New, i;
+    BOOL    Sorted = TRUE;
+    SINT32  ret;
+
+    if (Svi_Grow(pIdx, First + NbOfVars) < 0)
+        return (ERROR);
+
+    /* The entries are appended, they become visible with the sorted handles */
+    for (i = 0; i < NbOfVars; i++)
+    {
+        semTake(mist_SviSema, WAIT_FOREVER);
+        ret = svi_AddGlobVar(mist_SviHandle, (CHAR *) pList[i].pName, pList[i].Format, pList[i].Size, pList[i].pVar,
+                             0, pList[i].UserParam, pList[i].pSviStart, pList[i].pSviEnd);
+        semGive(mist_SviSema);
+        if (ret)
+        {
+            LOG_E(0, "Svi_AddList", "Could not add SVI variable '%s'!, Error %d", pList[i].pName, ret);
+            continue;
+        }
+        pEntry = &pIdx->pEntry[Last];
+        snprintf(pEntry->Name, sizeof(pEntry->Name), "%s", pList[i].pName);
+        pEntry->Format = pList[i].Format;
+        pEntry->Size = pList[i].Size;
+        pEntry->pVar = pList[i].pVar;
+        pEntry->UserParam = pList[i].UserParam;
+        pEntry->pSviStart = pList[i].pSviStart;
+        pEntry->pSviEnd = pList[i].pSviEnd;
+        pEntry->Flags = Flags;
+        if ((Last > First) && (strcmp(pEntry[-1].Name, pEntry->Name) >= 0))
+            Sorted = FALSE;
+        Last++;
+    }
+
+    pMerged = Sorted ? malloc(pIdx->MaxEntries * sizeof(UINT32)) : NULL;
+    if (pMerged)
+    {
+        for (Pos = 0, Old = 0, New = First; Pos < Last; Pos++)
+        {
+            if ((New == Last) ||
+                ((Old < First) && (strcmp(pIdx->pEntry[pIdx->pSorted[Old]].Name, pIdx->pEntry[New].Name) < 0)))
+                pMerged[Pos] = pIdx->pSorted[Old++];
+            else
+                pMerged[Pos] = New++;
+        }
+        free(pIdx->pSorted);
+        pIdx->pSorted = pMerged;
+        pIdx->NbOfEntries = Last;
+    }
+    else
+    {
+        for (New = First; New < Last; New++)
+        {
+            Svi_Lookup(pIdx, pIdx->pEntry[New].Name, &Pos);
+            memmove(&pIdx->pSorted[Pos + 1], &pIdx->pSorted[Pos], (pIdx->NbOfEntries - Pos) * sizeof(UINT32));
+            pIdx->pSorted[Pos] = pIdx->NbOfEntries++;
+        }
+    }
+    return (Last - First);
+}
+
+/**
+********************************************************************************
+* @brief Appends a variable to an index and inserts its handle into the
+*        sorted handles.
+*
+* @param[in]  pIdx        index
+* @param[in]  pName       visible name
+* @param[in]  Format      format and access type, SVI_F_xxx
+* @param[in]  Size        size in bytes
+* @param[in]  pVar        variable
+* @param[in]  UserParam   user parameter for pSviStart and pSviEnd
+* @param[in]  pSviStart   lock function, NULL = none
+* @param[in]  pSviEnd     unlock function, NULL = none
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, no memory or name already in the index
+*******************************************************************************/
+MLOCAL SINT32 Svi_Insert(SVI_INDEX * pIdx, const CHAR * pName, UINT32 Format, UINT32 Size, VOID * pVar,
+                         UINT32 UserParam, SVIFKPTSTART pSviStart, SVIFKPTEND pSviEnd)
+{
+    SVI_ENTRY *pEntry;
+    UINT32  Pos;
+
+    if (Svi_Lookup(pIdx, pName, &Pos) == OK)
+        return (ERROR);
+    if (Svi_Grow(pIdx, pIdx->NbOfEntries + 1) < 0)
+        return (ERROR);
+
+    pEntry = &pIdx->pEntry[pIdx->NbOfEntries];
+    snprintf(pEntry->Name, sizeof(pEntry->Name), "%s", pName);
+    pEntry->Format = Format;
+    pEntry->Size = Size;
+    pEntry->pVar = pVar;
+    pEntry->UserParam = UserParam;
+    pEntry->pSviStart = pSviStart;
+    pEntry->pSviEnd = pSviEnd;
+    pEntry->Flags = 0;
+
+    memmove(&pIdx->pSorted[Pos + 1], &pIdx->pSorted[Pos], (pIdx->NbOfEntries - Pos) * sizeof(UINT32));
+    pIdx->pSorted[Pos] = pIdx->NbOfEntries++;
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Binary search of a name in the sorted handles of an index.
+*
+* @param[in]  pIdx        index
+* @param[in]  pName       visible name, case sensitive
+* @param[out] pPos        position of the name in pSorted, or where to
+*                         insert it if not found
+*
+* @retval     = 0 .. OK, found
+* @retval     < 0 .. ERROR, not found
+*******************************************************************************/
+MLOCAL SINT32 Svi_Lookup(const SVI_INDEX * pIdx, const CHAR * pName, UINT32 * pPos)
+{
+    UINT32  Lo = 0;
+    UINT32  Hi = pIdx->NbOfEntries;
+    UINT32  Mid;
+    SINT32  Cmp;
+
+    while (Lo < Hi)
+    {
+        Mid = (Lo + Hi) / 2;
+        Cmp = strcmp(pIdx->pEntry[pIdx->pSorted[Mid]].Name, pName);
+        if (!Cmp)
+        {
+            *pPos = Mid;
+            return (OK);
+        }
+        if (Cmp < 0)
+            Lo = Mid + 1;
+        else
+            Hi = Mid;
+    }
+    *pPos = Lo;
+    return (ERROR);
+}
+
+/**
+********************************************************************************
+* @brief Copies the values of a list of variables of an index into one
+*        buffer, see mist_SviReadList().
+*        Consecutive variables with the same lock function and user
+*        parameter are read under one lock, so a consistency group (e.g.
+*        the statistics of a task) is read as a set from the same cycle.
+*
+* @param[in]  pIdx        index
+* @param[in]  pHandle     handles
+* @param[in]  NbOfVars    number of handles
+* @param[out] pBuf        values
+* @param[in]  BufSize     size of pBuf in bytes
+*
+* @retval     >= 0 .. number of bytes written to pBuf
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Svi_Read(const SVI_INDEX * pIdx, const UINT32 * pHandle, UINT32 NbOfVars, UINT8 * pBuf,
+                       UINT32 BufSize)
+{
+    const SVI_ENTRY *pEntry;
+    const SVI_ENTRY *pLocked = NULL;    /* entry whose lock function has been called */
+    SINT32  Used = 0;
+    UINT32  i;
+
+    for (i = 0; i < NbOfVars; i++)
+    {
+        if (pHandle[i] >= pIdx->NbOfEntries)
+        {
+            Used = ERROR;
+            break;
+        }
+        pEntry = &pIdx->pEntry[pHandle[i]];
+        if (!(pEntry->Format & SVI_F_OUT) || (pEntry->Size > BufSize - (UINT32) Used))
+        {
+            Used = ERROR;
+            break;
+        }
+
+        /* Release the lock at the end of a group */
+        if (pLocked && ((pEntry->pSviStart != pLocked->pSviStart) || (pEntry->UserParam != pLocked->UserParam)))
+        {
+            if (pLocked->pSviEnd)
+                pLocked->pSviEnd(NULL, pLocked->UserParam);
+            pLocked = NULL;
+        }
+
+        if (pEntry->pSviStart)
+        {
+            if (!pLocked)
+            {
+                if (pEntry->pSviStart(NULL, pEntry->UserParam) < 0)
+                {
+                    Used = ERROR;
+                    break;
+                }
+                pLocked = pEntry;
+            }
+            memcpy(pBuf + Used, pEntry->pVar, pEntry->Size);
+        }
+        else if ((pEntry->Size == sizeof(UINT32)) && !((size_t) pEntry->pVar & (sizeof(UINT32) - 1)))
+        {
+            /* most variables: one load, never mixed from two writes of the task */
+            UINT32  Val = *(volatile UINT32 *) pEntry->pVar;
+
+            memcpy(pBuf + Used, &Val, sizeof(Val));
+        }
+        else
+        {
+            memcpy(pBuf + Used, pEntry->pVar, pEntry->Size);
+        }
+        Used += pEntry->Size;
+    }
+    if (pLocked && pLocked->pSviEnd)
+        pLocked->pSviEnd(NULL, pLocked->UserParam);
+    return (Used);
+}
+
+/**
+********************************************************************************
+* @brief Looks up a subscription by its id.
+*
+* @param[in]  SubId       id returned by mist_SviSubscribe()
+* @param[out] N/A
+*
+* @retval     != NULL .. subscription
+* @retval     = NULL  .. no such subscription
+*******************************************************************************/
+MLOCAL SVI_SUB *Svi_SubFind(UINT32 SubId)
+{
+    UINT32  Slot = SubId & 0xFF;
+
+    if (!SubId || (Slot >= MIST_SVI_MAXSUBS) || (SviSubs[Slot].Id != SubId))
+        return (NULL);
+    return (&SviSubs[Slot]);
+}
+
+/**
+********************************************************************************
+* @brief Sets up a subscription of a list of variables of an index, nothing
+*        has been sent yet. The id is set by the caller.
+*
+* @param[in]  pIdx        index
+* @param[in]  pSub        free subscription
+* @param[in]  pHandle     handles
+* @param[in]  pDeadband   deadbands, see mist_SviSubscribe()
+* @param[in]  NbOfVars    number of variables
+* @param[out] pSub        subscription
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Svi_SubInit(const SVI_INDEX * pIdx, SVI_SUB * pSub, const UINT32 * pHandle, const REAL32 * pDeadband,
+                          UINT32 NbOfVars)
+{
+    const SVI_ENTRY *pEntry;
+    UINT32  Size = 0;
+    UINT32  i;
+
+    if (!NbOfVars || (NbOfVars > MIST_SVI_MAXLIST))
+        return (ERROR);
+    for (i = 0; i < NbOfVars; i++)
+    {
+        /* also rejects a deadband NaN */
+        if ((pHandle[i] >= pIdx->NbOfEntries) || !(pDeadband[i] >= 0))
+            return (ERROR);
+        pEntry = &pIdx->pEntry[pHandle[i]];
+        if (!(pEntry->Format & SVI_F_OUT))
+            return (ERROR);
+        Size += pEntry->Size;
+    }
+    if (Size > MIST_SVI_MAXDATA)
+        return (ERROR);
+
+    pSub->pVar = malloc(NbOfVars * (sizeof(SVI_SUBVAR) + sizeof(UINT32)) + 2 * Size);
+    if (!pSub->pVar)
+        return (ERROR);
+    pSub->pHandle = (UINT32 *) (pSub->pVar + NbOfVars);
+    pSub->pCur = (UINT8 *) (pSub->pHandle + NbOfVars);
+    pSub->pSent = pSub->pCur + Size;
+    for (i = 0; i < NbOfVars; i++)
+    {
+        pEntry = &pIdx->pEntry[pHandle[i]];
+        pSub->pHandle[i] = pHandle[i];
+        pSub->pVar[i].Format = pEntry->Format;
+        pSub->pVar[i].Size = pEntry->Size;
+        pSub->pVar[i].Deadband = pDeadband[i];
+    }
+    pSub->IndexId = pIdx->Id;
+    pSub->Sent = FALSE;
+    pSub->NbOfVars = NbOfVars;
+    pSub->Size = Size;
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Reads the variables of a subscription and copies the changed ones
+*        into one buffer, see mist_SviSubUpdate(). Their values are taken
+*        as sent.
+*
+* @param[in]  pIdx        index
+* @param[in]  pSub        subscription
+* @param[in]  Full        TRUE = all variables
+* @param[out] pBuf        positions and values
+* @param[in]  BufSize     size of pBuf in bytes
+* @param[out] pNbOfChanged number of variables in pBuf
+*
+* @retval     >= 0 .. number of bytes written to pBuf
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+MLOCAL SINT32 Svi_SubUpdate(const SVI_INDEX * pIdx, SVI_SUB * pSub, UINT32 Full, UINT8 * pBuf, UINT32 BufSize,
+                            UINT32 * pNbOfChanged)
+{
+    const SVI_SUBVAR *pVar;
+    UINT32  Used = 0;
+    UINT32  Offset = 0;
+    UINT32  i;
+
+    *pNbOfChanged = 0;
+    if ((pSub->IndexId != pIdx->Id) || (BufSize < pSub->Size + pSub->NbOfVars * sizeof(UINT32)))
+        return (ERROR);
+    if (Svi_Read(pIdx, pSub->pHandle, pSub->NbOfVars, pSub->pCur, pSub->Size) < 0)
+        return (ERROR);
+
+    /* Nothing has changed: one compare of all values */
+    if (!Full && pSub->Sent && !memcmp(pSub->pCur, pSub->pSent, pSub->Size))
+        return (0);
+
+    for (i = 0, pVar = pSub->pVar; i < pSub->NbOfVars; i++, Offset += pVar->Size, pVar++)
+    {
+        if (!Full && pSub->Sent && !Svi_SubChanged(pVar, pSub->pCur + Offset, pSub->pSent + Offset))
+            continue;
+        memcpy(pBuf + Used, &i, sizeof(UINT32));
+        memcpy(pBuf + Used + sizeof(UINT32), pSub->pCur + Offset, pVar->Size);
+        memcpy(pSub->pSent + Offset, pSub->pCur + Offset, pVar->Size);
+        Used += sizeof(UINT32) + pVar->Size;
+        (*pNbOfChanged)++;
+    }
+    pSub->Sent = TRUE;
+    return (Used);
+}
+
+/**
+********************************************************************************
+* @brief Compares a value of a subscription with the value last sent. A
+*        numeric variable with a deadband has changed if the difference
+*        exceeds the deadband, any other one (including arrays and
+*        strings) if a byte differs.
+*
+* @param[in]  pVar        variable
+* @param[in]  pNew        value read
+* @param[in]  pOld        value last sent
+* @param[out] N/A
+*
+* @retval     TRUE  .. changed, to be sent
+* @retval     FALSE .. unchanged
+*******************************************************************************/
+MLOCAL BOOL Svi_SubChanged(const SVI_SUBVAR * pVar, const UINT8 * pNew, const UINT8 * pOld)
+{
+    REAL64  New, Old;
+
+    if (!memcmp(pNew, pOld, pVar->Size))
+        return (FALSE);
+    if ((pVar->Deadband <= 0) || (Svi_SubValue(pVar, pNew, &New) < 0) || (Svi_SubValue(pVar, pOld, &Old) < 0))
+        return (TRUE);
+
+    /* a NaN is always sent */
+    return (!(fabs(New - Old) <= pVar->Deadband));
+}
+
+/**
+********************************************************************************
+* @brief Converts a numeric scalar value of a subscription, which may be
+*        unaligned, to REAL64.
+*
+* @param[in]  pVar        variable
+* @param[in]  pValue      value
+* @param[out] pNum        numeric value
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, not a numeric scalar
+*******************************************************************************/
+MLOCAL SINT32 Svi_SubValue(const SVI_SUBVAR * pVar, const UINT8 * pValue, REAL64 * pNum)
+{
+    union
+    {
+        UINT8   U8;
+        SINT8   S8;
+        UINT16  U16;
+        SINT16  S16;
+        UINT32  U32;
+        SINT32  S32;
+        REAL32  R32;
+        UINT64  U64;
+        SINT64  S64;
+        REAL64  R64;
+    } Val;
+    UINT32  Size;
+
+    if (pVar->Size > sizeof(Val))
+        return (ERROR);
+    memcpy(&Val, pValue, pVar->Size);
+
+    switch (pVar->Format & ~SVI_F_INOUT)
+    {
+        case SVI_F_UINT8:
+            *pNum = Val.U8;
+            Size = sizeof(UINT8);
+            break;
+        case SVI_F_SINT8:
+            *pNum = Val.S8;
+            Size = sizeof(SINT8);
+            break;
+        case SVI_F_UINT16:
+            *pNum = Val.U16;
+            Size = sizeof(UINT16);
+            break;
+        case SVI_F_SINT16:
+            *pNum = Val.S16;
+            Size = sizeof(SINT16);
+            break;
+        case SVI_F_UINT32:
+            *pNum = Val.U32;
+            Size = sizeof(UINT32);
+            break;
+        case SVI_F_SINT32:
+            *pNum = Val.S32;
+            Size = sizeof(SINT32);
+            break;
+        case SVI_F_REAL32:
+            *pNum = Val.R32;
+            Size = sizeof(REAL32);
+            break;
+        case SVI_F_UINT64:
+            *pNum = (REAL64) Val.U64;
+            Size = sizeof(UINT64);
+            break;
+        case SVI_F_SINT64:
+            *pNum = (REAL64) Val.S64;
+            Size = sizeof(SINT64);
+            break;
+        case SVI_F_REAL64:
+            *pNum = Val.R64;
+            Size = sizeof(REAL64);
+            break;
+        default:
+            return (ERROR);
+    }
+    return ((pVar->Size == Size) ? OK : ERROR);
+}
+
+/**
+********************************************************************************
+* @brief Frees a subscription, its id becomes invalid.
+*
+* @param[in]  pSub        subscription, may be free
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Svi_SubFree(SVI_SUB * pSub)
+{
+    free(pSub->pVar);
+    memset(pSub, 0, sizeof(*pSub));
+}
+
+/**
+********************************************************************************
+* @brief Frees an index, its handles become invalid.
+*
+* @param[in]  pIdx        index
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Svi_Free(SVI_INDEX * pIdx)
+{
+    free(pIdx->pEntry);
+    free(pIdx->pSorted);
+    memset(pIdx, 0, sizeof(*pIdx));
+}
+
+/**
+********************************************************************************
+* @brief Lock function of the export areas, see mist_SviExport(). Takes the
+*        lock of the area, which the task holds only while it copies the
+*        area in mist_SviExportIn() or mist_SviExportOut().
+*        A reader of higher priority may have preempted the task holding
+*        the lock, so it waits a tick after TASK_SVI_SPIN failed tries.
+*        After TASK_SVI_YIELDS ticks, e.g. if the task has been deleted
+*        while copying, the access fails.
+*
+* @param[in]  pVar        SVI variable, not used
+* @param[in]  UserParam   lock of the area, index in SviAreaLock[]
+* @param[out] N/A
+*
+* @retval     = 0 .. OK, locked until Svi_AreaEnd()
+* @retval     < 0 .. ERROR, not locked
+*******************************************************************************/
+MLOCAL SINT32 Svi_AreaStart(SVI_VAR * pVar, UINT32 UserParam)
+{
+    volatile UINT32 *pLock = &SviAreaLock[UserParam & (SVI_AREA_LOCKS - 1)];
+    UINT32  Spin = 0;
+    UINT32  Yields = 0;
+
+    while (!MIST_CAS(pLock, 0, 1))
+    {
+        if (++Spin >= TASK_SVI_SPIN)
+        {
+            if (++Yields > TASK_SVI_YIELDS)
+                return (ERROR);
+            taskDelay(1);
+            Spin = 0;
+        }
+    }
+    MIST_BARRIER();
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Release function of the export areas, see Svi_AreaStart().
+*
+* @param[in]  pVar        SVI variable, not used
+* @param[in]  UserParam   lock of the area, index in SviAreaLock[]
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Svi_AreaEnd(SVI_VAR * pVar, UINT32 UserParam)
+{
+    MIST_BARRIER();
+    SviAreaLock[UserParam & (SVI_AREA_LOCKS - 1)] = 0;
+}
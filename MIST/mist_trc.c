@@ -0,0 +1,383 @@
+/**
+********************************************************************************
+* @file     mist_trc.c
+* @author   Bachmann electronic GmbH
+* @version  $Revision: 3.90 $ $LastChangedBy: BE $
+* @date     $LastChangeDate: 2013-06-10 11:00:00 $
+*
+* @brief    This file contains the cycle trace of the application tasks.
+*
+*           Each task writes records of fixed size into its own ring:
+*           cycle start and end, start and end of the program segments
+*           (also of the workers executing them in parallel), overruns,
+*           program stops and online changes. A record is written by a few
+*           stores without lock or system call (MIST_TRC(), mist_int.h), the
+*           time stamp is the time base register of the CPU. The ring keeps
+*           the last records, older ones are overwritten.
+*
+*           The rings are written to a file on request: by the panic handler
+*           of the module (e.g. expired watchdog), the SMI call
+*           MIST_PROC_TRCDUMP or mist_TrcDump() in the shell. A ring is
+*           copied while its task keeps running; records overwritten during
+*           the copy are dropped. The file holds for each task a header
+*           (MIST_TRC_HEADER) followed by the records, oldest first, in the
+*           byte order of the controller. tools/mist_trc2json.c converts it
+*           to the trace event format of chrome://tracing and Perfetto.
+*
+*           Usage:
+*           - Records = n in the configuration group Trace enables the trace
+*             with n records per task (rounded up to a power of 2), 0 = off
+*           - File = path in the configuration group Trace sets the file of
+*             the dumps without a file name
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+#include <prof_e.h>
+
+/* Project includes */
+#include "mist_e.h"
+#include "mist_int.h"
+
+/* Default file of the dumps, mconfig (Trace)File */
+#define TRC_FILE         "/cfc0/app/mist.trc"
+
+/* Duration of the calibration of the time stamps in us */
+#define TRC_CALIBRATION  10000
+
+/* Functions: system global, see mist_int.h */
+SINT32  mist_TrcCfgRead(VOID);
+MIST_TRC *mist_TrcCreate(const CHAR * pTaskName);
+VOID    mist_TrcDelete(MIST_TRC * pTrc);
+UINT64  mist_TrcStamp(VOID);
+SINT32  mist_TrcWrite(TASK_PROPERTIES ** pTaskList, UINT32 NbOfTasks, const CHAR * pFileName, UINT32 Reason,
+                      UINT32 Arg);
+
+/* Functions: local */
+MLOCAL VOID Trc_Calibrate(VOID);
+MLOCAL UINT32 Trc_Copy(MIST_TRC * pTrc, MIST_TRC_RECORD * pBuf, UINT32 * pNbOfWritten);
+
+/* Settings of the trace, mconfig (Trace) */
+MLOCAL UINT32 TrcRecords = 0;
+MLOCAL CHAR TrcFile[M_PATHLEN_A] = TRC_FILE;
+
+/* Rate of the time stamps, set by Trc_Calibrate() */
+MLOCAL UINT32 TrcStampsPerMs = 0;
+
+/**
+********************************************************************************
+* @brief Reads the settings of the cycle trace from the configuration group
+*        Trace. Being called by mist_CfgRead.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+*******************************************************************************/
+SINT32 mist_TrcCfgRead(VOID)
+{
+    SINT32  ret;
+    SINT32  TmpVal;
+    CHAR    TmpPath[M_PATHLEN_A];
+    CHAR    section[PF_KEYLEN_A];
+    CHAR    Func[] = "mist_TrcCfgRead";
+
+    snprintf(section, sizeof(section), mist_BaseParams.AppName);
+
+    ret = pf_GetInt(section, "Trace", "Records", TrcRecords, &TmpVal,
+                    mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
+    /* keyword has been found */
+    if ((ret >= 0) && (TmpVal >= 0) && (TmpVal <= MIST_TRC_MAXRECORDS))
+    {
+        TrcRecords = TmpVal;
+    }
+    /* keyword has not been found, the trace is optional */
+    else if (ret >= 0)
+    {
+        LOG_W(0, Func, "Invalid configuration parameter '[%s](Trace)Records' = %d", section, TmpVal);
+        LOG_W(0, Func, " -> using initialization value of %u", TrcRecords);
+    }
+
+    ret = pf_GetStrg(section, "Trace", "File", TRC_FILE, TmpPath, sizeof(TmpPath),
+                     mist_BaseParams.CfgLine, mist_BaseParams.CfgFileName);
+    /* keyword has been found */
+    if ((ret >= 0) && TmpPath[0])
+    {
+        snprintf(TrcFile, sizeof(TrcFile), "%s", TmpPath);
+    }
+
+    if (TrcRecords && !TrcStampsPerMs)
+        Trc_Calibrate();
+
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Creates the trace ring of a task with the configured number of
+*        records.
+*
+* @param[in]  pTaskName   name of the task, for the log only
+* @param[out] N/A
+*
+* @retval     != NULL .. trace ring
+* @retval     = NULL .. trace disabled or not enough memory
+*******************************************************************************/
+MIST_TRC *mist_TrcCreate(const CHAR * pTaskName)
+{
+    MIST_TRC *pTrc;
+    UINT32  NbOfRecords = 1;
+    CHAR    Func[] = "mist_TrcCreate";
+
+    if (!TrcRecords)
+        return (NULL);
+
+    while (NbOfRecords < TrcRecords)
+        NbOfRecords <<= 1;
+
+    pTrc = calloc(1, sizeof(*pTrc));
+    if (pTrc)
+        pTrc->pRec = calloc(NbOfRecords, sizeof(MIST_TRC_RECORD));
+    if (!pTrc || !pTrc->pRec)
+    {
+        LOG_W(0, Func, "Task %s: no memory for %u trace records, trace disabled", pTaskName, NbOfRecords);
+        free(pTrc);
+        return (NULL);
+    }
+    pTrc->Mask = NbOfRecords - 1;
+
+    return (pTrc);
+}
+
+/**
+********************************************************************************
+* @brief Frees a trace ring created by mist_TrcCreate.
+*
+* @param[in]  pTrc        trace ring, may be NULL
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_TrcDelete(MIST_TRC * pTrc)
+{
+    if (!pTrc)
+        return;
+
+    free(pTrc->pRec);
+    free(pTrc);
+}
+
+/**
+********************************************************************************
+* @brief Returns a time stamp for the trace: the time base register of the
+*        CPU, without a system call. The rate is determined once by
+*        Trc_Calibrate() and written to the header of the dumps.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     time stamp
+*******************************************************************************/
+UINT64 mist_TrcStamp(VOID)
+{
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    UINT32  Lo, Hi;
+
+    __asm__ __volatile__("rdtsc":"=a"(Lo), "=d"(Hi));
+    return (((UINT64) Hi << 32) | Lo);
+#elif defined(__GNUC__) && (defined(__PPC__) || defined(__powerpc__))
+    UINT32  Lo, Hi, Hi2;
+
+    /* upper half may change between the reads */
+    do
+    {
+        __asm__ __volatile__("mftbu %0":"=r"(Hi));
+        __asm__ __volatile__("mftb %0":"=r"(Lo));
+        __asm__ __volatile__("mftbu %0":"=r"(Hi2));
+    }
+    while (Hi != Hi2);
+    return (((UINT64) Hi << 32) | Lo);
+#else
+    return (m_GetProcTime());
+#endif
+}
+
+/**
+********************************************************************************
+* @brief Writes the trace rings of the tasks to a file, each one as header
+*        followed by its records, oldest first. The tasks keep running.
+*
+* @param[in]  pTaskList   tasks, the ones without trace ring are skipped
+* @param[in]  NbOfTasks   number of tasks
+* @param[in]  pFileName   file to be written, NULL or "" = configured file
+* @param[in]  Reason      reason of the dump, MIST_TRC_R_xxx
+* @param[in]  Arg         written to the headers, panic: mode of the signal
+* @param[out] N/A
+*
+* @retval     >= 0 .. number of records written
+* @retval     < 0 .. ERROR, trace disabled or file not written
+*******************************************************************************/
+SINT32 mist_TrcWrite(TASK_PROPERTIES ** pTaskList, UINT32 NbOfTasks, const CHAR * pFileName, UINT32 Reason,
+                     UINT32 Arg)
+{
+    MIST_TRC_HEADER Hdr;
+    MIST_TRC_RECORD *pBuf = NULL;
+    FILE   *pFile;
+    UINT32  idx;
+    UINT32  NbOfRecords;
+    UINT32  Total = 0;
+    SINT32  ret = OK;
+    CHAR    Func[] = "mist_TrcWrite";
+
+    if (!TrcRecords)
+    {
+        LOG_W(0, Func, "Trace is disabled, see '(Trace)Records'");
+        return (ERROR);
+    }
+    if (!pFileName || !pFileName[0])
+        pFileName = TrcFile;
+
+    pFile = fopen(pFileName, "wb");
+    if (!pFile)
+    {
+        LOG_E(0, Func, "Could not open trace file '%s'", pFileName);
+        return (ERROR);
+    }
+
+    for (idx = 0; (idx < NbOfTasks) && (ret == OK); idx++)
+    {
+        MIST_TRC *pTrc = pTaskList[idx]->pTrc;
+
+        if (!pTrc)
+            continue;
+
+        /* copy first, the file system is too slow to keep up with the task */
+        pBuf = realloc(pBuf, (pTrc->Mask + 1) * sizeof(MIST_TRC_RECORD));
+        if (!pBuf)
+        {
+            LOG_E(0, Func, "No memory to copy the trace of task %s", pTaskList[idx]->Name);
+            ret = ERROR;
+            break;
+        }
+
+        memset(&Hdr, 0, sizeof(Hdr));
+        Hdr.Magic = MIST_TRC_MAGIC;
+        Hdr.Version = MIST_TRC_VERSION;
+        Hdr.Reason = Reason;
+        snprintf(Hdr.TaskName, sizeof(Hdr.TaskName), "%s", pTaskList[idx]->Name);
+        Hdr.StampsPerMs = TrcStampsPerMs;
+        Hdr.Period = (UINT32) (pTaskList[idx]->CycleTime_ms * 1000);
+        Hdr.Stamp = mist_TrcStamp();
+        Hdr.Time = time(NULL);
+        Hdr.Arg = Arg;
+        NbOfRecords = Trc_Copy(pTrc, pBuf, &Hdr.NbOfWritten);
+        Hdr.NbOfRecords = NbOfRecords;
+
+        if ((fwrite(&Hdr, sizeof(Hdr), 1, pFile) != 1) ||
+            (fwrite(pBuf, sizeof(MIST_TRC_RECORD), NbOfRecords, pFile) != NbOfRecords))
+        {
+            ret = ERROR;
+            break;
+        }
+        Total += NbOfRecords;
+    }
+
+    free(pBuf);
+    if (ferror(pFile) | fclose(pFile))
+        ret = ERROR;
+
+    if (ret != OK)
+    {
+        LOG_E(0, Func, "Could not write trace file '%s'", pFileName);
+        return (ERROR);
+    }
+
+    LOG_I(0, Func, "%u trace records written to '%s'", Total, pFileName);
+    return (Total);
+}
+
+/**
+********************************************************************************
+* @brief Copies the records of a trace ring, oldest first, while its task
+*        keeps writing. Records the task may have overwritten during the
+*        copy are dropped.
+*
+* @param[in]  pTrc         trace ring
+* @param[out] pBuf         records, at least Mask + 1
+* @param[out] pNbOfWritten records written by the task when the copy started
+*
+* @retval     number of records copied
+*******************************************************************************/
+MLOCAL UINT32 Trc_Copy(MIST_TRC * pTrc, MIST_TRC_RECORD * pBuf, UINT32 * pNbOfWritten)
+{
+    UINT32  Size = pTrc->Mask + 1;
+    UINT32  Head = pTrc->Head;
+    UINT32  First;
+    UINT32  Valid;
+    UINT32  idx;
+
+    MIST_BARRIER();
+    First = (Head > Size) ? Head - Size : 0;
+    for (idx = First; idx != Head; idx++)
+        pBuf[idx - First] = pTrc->pRec[idx & pTrc->Mask];
+    MIST_BARRIER();
+
+    /*
+     * Meanwhile, the task has written the records up to its current head
+     * and may be writing the next one, each overwriting the record Size
+     * places before it. Only the records after these are valid.
+     */
+    *pNbOfWritten = Head;
+    Valid = pTrc->Head + 1;
+    Valid = (Valid > Size) ? Valid - Size : 0;
+    if (Valid <= First)
+        return (Head - First);
+    if (Valid >= Head)
+        return (0);
+
+    memmove(pBuf, pBuf + (Valid - First), (Head - Valid) * sizeof(MIST_TRC_RECORD));
+    return (Head - Valid);
+}
+
+/**
+********************************************************************************
+* @brief Determines the rate of the time stamps from the process time.
+*        Busy waits TRC_CALIBRATION us, once at the module start.
+*
+* @param[in]  N/A
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Trc_Calibrate(VOID)
+{
+    UINT32  Start;
+    UINT32  Now;
+    UINT64  Stamp;
+
+    Start = m_GetProcTime();
+    while ((Now = m_GetProcTime()) == Start)
+        ;
+    Stamp = mist_TrcStamp();
+    while ((m_GetProcTime() - Now) < TRC_CALIBRATION)
+        ;
+    Stamp = mist_TrcStamp() - Stamp;
+    Now = m_GetProcTime() - Now;
+
+    TrcStampsPerMs = (UINT32) (Stamp * 1000 / Now);
+    if (!TrcStampsPerMs)
+        TrcStampsPerMs = 1;
+}
@@ -0,0 +1,1759 @@
+/**
+********************************************************************************
+* @file     mist_vm.c
+* @author   Bachmann electronic GmbH
+* @version  $Revision: 3.90 $ $LastChangedBy: BE $
+* @date     $LastChangeDate: 2013-06-10 11:00:00 $
+*
+* @brief    This file contains the virtual machine (VM) executing the
+*           bytecode of compiled Structured Text (ST) programs.
+*
+*           The dispatch loop uses threaded code: with GCC every handler
+*           jumps directly to the handler of the next instruction via a
+*           table of label addresses. Other compilers use a switch, which
+*           can also be selected with MIST_VM_SWITCH.
+*
+*           All memory of a program instance is allocated by mist_VmCreate(),
+*           mist_VmRun() never allocates. Only backward jumps can repeat code,
+*           each of them is counted against the loop budget of the cycle.
+*           So a cycle executes at most (Budget + 1) * NbOfInstr instructions.
+*           Block instructions (MIST_I_COPY, MIST_I_FILL, MIST_I_VECF) execute
+*           a whole FOR loop at once and count each iteration like the loop
+*           would.
+*
+*           The instructions consist of independent segments, each ending
+*           with MIST_I_END (see mist_comp.c). mist_VmRun() executes them one
+*           after the other, mist_VmRunPar() distributes them on the workers
+*           of a pool (mist_par.c). The workers execute on their own register
+*           files and lane buffers (clones), the data area is shared. As no
+*           variable assigned by one segment is used by another one, the
+*           results are the same as with the serial execution. The loop
+*           budget applies to the sum of all segments: a segment gets what
+*           the segments finished so far have left, so a runaway cycle does
+*           at most NbOfWorkers * Budget backward jumps. Once a segment has
+*           stopped, the segments behind it not started yet are skipped.
+*           Faults are reported for the first segment in serial order. Which
+*           segment runs out of the budget depends on the timing of the
+*           workers, it is reported at the instruction where this happened,
+*           or at its first instruction if nothing was left at its start.
+*           Only after a fault the data area can differ: segments behind the
+*           faulting one may have been executed as well.
+*
+*           Element-wise REAL kernels (MIST_I_VECF) use SSE or AVX on x86
+*           hosts, MIST_VM_NOSIMD selects the scalar code. Both perform the
+*           same IEEE operations per element, so the results are identical.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
+*******************************************************************************/
+
+/* VxWorks includes */
+#include <vxWorks.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+/* MSys includes */
+#include <mtypes.h>
+#include <msys_e.h>
+#include <svi_e.h>
+#include <log_e.h>
+
+/* Project includes */
+#include "mist_int.h"
+#include "mist_prg.h"
+#include "mist_vm.h"
+
+/* Dispatch: threaded code with GCC, switch otherwise */
+#if defined(__GNUC__) && !defined(MIST_VM_SWITCH)
+#define VM_THREADED
+#define VM_OP(Op)        L_##Op:
+#define VM_NEXT          pI++; goto *VmLabels[pI->Op]
+#define VM_JUMP(Target)  pI = pBase + (Target); goto *VmLabels[pI->Op]
+#else
+#define VM_OP(Op)        case Op:
+#define VM_NEXT          pI++; continue
+#define VM_JUMP(Target)  pI = pBase + (Target); continue
+#endif
+
+/* SIMD of element-wise kernels: VM_VSEL(m, a, b) = m ? a : b per lane */
+#if defined(__AVX__) && !defined(MIST_VM_NOSIMD)
+#include <immintrin.h>
+#define VM_SIMD          8
+#define VM_V             __m256
+#define VM_VLOAD(p)      _mm256_loadu_ps(p)
+#define VM_VSTORE(p, v)  _mm256_storeu_ps(p, v)
+#define VM_VSPLAT(x)     _mm256_set1_ps(x)
+#define VM_VADD(a, b)    _mm256_add_ps(a, b)
+#define VM_VSUB(a, b)    _mm256_sub_ps(a, b)
+#define VM_VMUL(a, b)    _mm256_mul_ps(a, b)
+#define VM_VDIV(a, b)    _mm256_div_ps(a, b)
+#define VM_VMIN(a, b)    _mm256_min_ps(a, b)
+#define VM_VMAX(a, b)    _mm256_max_ps(a, b)
+#define VM_VXOR(a, b)    _mm256_xor_ps(a, b)
+#define VM_VLT(a, b)     _mm256_cmp_ps(a, b, _CMP_LT_OQ)
+#define VM_VSEL(m, a, b) _mm256_blendv_ps(b, a, m)
+#elif (defined(__SSE2__) || defined(__SSE__)) && !defined(MIST_VM_NOSIMD)
+#include <xmmintrin.h>
+#define VM_SIMD          4
+#define VM_V             __m128
+#define VM_VLOAD(p)      _mm_loadu_ps(p)
+#define VM_VSTORE(p, v)  _mm_storeu_ps(p, v)
+#define VM_VSPLAT(x)     _mm_set1_ps(x)
+#define VM_VADD(a, b)    _mm_add_ps(a, b)
+#define VM_VSUB(a, b)    _mm_sub_ps(a, b)
+#define VM_VMUL(a, b)    _mm_mul_ps(a, b)
+#define VM_VDIV(a, b)    _mm_div_ps(a, b)
+#define VM_VMIN(a, b)    _mm_min_ps(a, b)
+#define VM_VMAX(a, b)    _mm_max_ps(a, b)
+#define VM_VXOR(a, b)    _mm_xor_ps(a, b)
+#define VM_VLT(a, b)     _mm_cmplt_ps(a, b)
+#define VM_VSEL(m, a, b) _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b))
+#endif
+
+/* Operands */
+#define RA               R[pI->A]
+#define RB               R[pI->B]
+#define RC               R[pI->C]
+#define MEM(Type)        (*(Type *) (pMem + MIST_I_IMM(pI)))
+#define MEMR(Type)       (*(Type *) (pMem + RB.u))
+
+/* Operand formats, index is MIST_I_xxx */
+const UINT8 mist_VmFormat[MIST_I_COUNT] = {
+    [MIST_I_END] = MIST_FMT_NONE,
+    [MIST_I_JMP] = MIST_FMT_T, [MIST_I_JMPB] = MIST_FMT_T,
+    [MIST_I_JZ] = MIST_FMT_RT, [MIST_I_JNZ] = MIST_FMT_RT,
+    [MIST_I_JZB] = MIST_FMT_RT, [MIST_I_JNZB] = MIST_FMT_RT,
+    [MIST_I_MOV] = MIST_FMT_RR,
+    [MIST_I_LDS8 ... MIST_I_ST64] = MIST_FMT_RM,
+    [MIST_I_LDRS8 ... MIST_I_STR64] = MIST_FMT_RR,
+    [MIST_I_IDX] = MIST_FMT_RRD, [MIST_I_IDXA] = MIST_FMT_RRD,
+    [MIST_I_ADD ... MIST_I_MAXU] = MIST_FMT_RRR,
+    [MIST_I_NEG] = MIST_FMT_RR, [MIST_I_NOT] = MIST_FMT_RR,
+    [MIST_I_ABS ... MIST_I_ZX16] = MIST_FMT_RR,
+    [MIST_I_ADDF ... MIST_I_GED] = MIST_FMT_RRR,
+    [MIST_I_NEGF] = MIST_FMT_RR, [MIST_I_ABSF] = MIST_FMT_RR,
+    [MIST_I_NEGD] = MIST_FMT_RR, [MIST_I_ABSD] = MIST_FMT_RR,
+    [MIST_I_MATHF] = MIST_FMT_RRF, [MIST_I_MATHD] = MIST_FMT_RRF,
+    [MIST_I_ITOF ... MIST_I_TRUNCD] = MIST_FMT_RR,
+    [MIST_I_LOOP] = MIST_FMT_RT,
+    [MIST_I_COPY] = MIST_FMT_K, [MIST_I_FILL] = MIST_FMT_RK, [MIST_I_VECF] = MIST_FMT_K
+};
+
+/* Operation names for the disassembler, index is MIST_I_xxx */
+const CHAR *const mist_VmOpName[MIST_I_COUNT] = {
+    "END", "JMP", "JZ", "JNZ", "JMPB", "JZB", "JNZB", "MOV",
+    "LDS8", "LDU8", "LDS16", "LDU16", "LD32", "LD64", "ST8", "ST16", "ST32", "ST64",
+    "LDRS8", "LDRU8", "LDRS16", "LDRU16", "LDR32", "LDR64", "STR8", "STR16", "STR32", "STR64",
+    "IDX", "IDXA", "ADD", "SUB", "MUL", "DIV", "MOD", "DIVU", "MODU", "NEG",
+    "AND", "OR", "XOR", "NOT", "EQ", "NE", "LT", "LE", "GT", "GE", "LTU", "LEU", "GTU", "GEU",
+    "MIN", "MAX", "MINU", "MAXU", "ABS", "SX8", "SX16", "ZX8", "ZX16",
+    "ADDF", "SUBF", "MULF", "DIVF", "NEGF", "ABSF", "MINF", "MAXF", "POWF", "MATHF",
+    "EQF", "NEF", "LTF", "LEF", "GTF", "GEF",
+    "ADDD", "SUBD", "MULD", "DIVD", "NEGD", "ABSD", "MIND", "MAXD", "POWD", "MATHD",
+    "EQD", "NED", "LTD", "LED", "GTD", "GED",
+    "ITOF", "UTOF", "ITOD", "UTOD", "FTOD", "DTOF", "FTOI", "DTOI", "FTOU", "DTOU",
+    "TRUNCF", "TRUNCD", "LOOP", "COPY", "FILL", "VECF"
+};
+
+/* Names of the kernel operations, index is MIST_V_xxx */
+MLOCAL const CHAR *const VmVopName[] = {
+    "LD", "SPLAT", "ST", "ADD", "SUB", "MUL", "DIV", "MIN", "MAX", "NEG", "ABS"
+};
+
+/* Names of the math functions, index is MIST_FN_xxx */
+MLOCAL const CHAR *const VmFnName[MIST_FN_COUNT] = {
+    "SQRT", "SIN", "COS", "TAN", "ASIN", "ACOS", "ATAN", "EXP", "LN", "LOG"
+};
+
+/* Element-wise kernels: FALSE = scalar code only, for comparisons (mist_VecBench) */
+MLOCAL BOOL VmSimd = TRUE;
+
+/* Functions: virtual machine, being called only within this file */
+MLOCAL VOID Vm_VecOp(UINT32 Op, REAL32 * pD, const REAL32 * pA, const REAL32 * pB, UINT32 Count);
+MLOCAL VOID Vm_Vector(MIST_VM * pVm, const MIST_VM_BLOCK * pK, UINT32 Count);
+MLOCAL VOID Vm_Block(MIST_VM * pVm, const MIST_VM_BLOCK * pK, UINT32 Op, const MIST_REG * pValue, UINT32 Count);
+MLOCAL int Vm_XferCmp(const VOID * pA, const VOID * pB);
+MLOCAL MIST_VM *Vm_Alloc(const MIST_CODE * pCode, UINT32 MemSize);
+MLOCAL SINT32 Vm_Exec(MIST_VM * pVm, UINT32 Entry, UINT32 * pBudget);
+MLOCAL VOID Vm_ParJob(VOID * pArg, UINT32 Job, UINT32 Worker);
+
+/* Functions: test functions, to be called from the shell */
+SINT32  mist_PrgRun(CHAR * pFileName, UINT32 Cycles, UINT32 Disasm);
+SINT32  mist_VecBench(UINT32 Cycles);
+
+
+/**
+********************************************************************************
+* @brief Conversions of floating point values to integers.
+*        mist_VmRound() and mist_VmRoundU() round half away from zero,
+*        mist_VmTrunc() truncates. Values out of range are saturated, NaN
+*        results in 0. The generated C code (mist_cgen.c) calls the same
+*        functions.
+*
+* @param[in]  Value    value to be converted
+* @param[out] N/A
+*
+* @retval     converted value
+*******************************************************************************/
+SINT32 mist_VmRound(REAL64 Value)
+{
+    if (Value != Value)
+        return (0);
+    if (Value >= 2147483647.0)
+        return (0x7FFFFFFF);
+    if (Value <= -2147483648.0)
+        return ((SINT32) 0x80000000);
+    return ((SINT32) ((Value >= 0) ? Value + 0.5 : Value - 0.5));
+}
+
+UINT32 mist_VmRoundU(REAL64 Value)
+{
+    if ((Value != Value) || (Value <= 0))
+        return (0);
+    if (Value >= 4294967295.0)
+        return (0xFFFFFFFF);
+    return ((UINT32) (Value + 0.5));
+}
+
+SINT32 mist_VmTrunc(REAL64 Value)
+{
+    if (Value != Value)
+        return (0);
+    if (Value >= 2147483647.0)
+        return (0x7FFFFFFF);
+    if (Value <= -2147483648.0)
+        return ((SINT32) 0x80000000);
+    return ((SINT32) Value);
+}
+
+/**
+********************************************************************************
+* @brief Calculates a math function in double precision.
+*        The compiler folds calls with literal arguments with it.
+*
+* @param[in]  Fn       function MIST_FN_xxx
+* @param[in]  Value    argument
+* @param[out] N/A
+*
+* @retval     result
+*******************************************************************************/
+REAL64 mist_VmMath(UINT32 Fn, REAL64 Value)
+{
+    switch (Fn)
+    {
+        case MIST_FN_SQRT:
+            return (sqrt(Value));
+        case MIST_FN_SIN:
+            return (sin(Value));
+        case MIST_FN_COS:
+            return (cos(Value));
+        case MIST_FN_TAN:
+            return (tan(Value));
+        case MIST_FN_ASIN:
+            return (asin(Value));
+        case MIST_FN_ACOS:
+            return (acos(Value));
+        case MIST_FN_ATAN:
+            return (atan(Value));
+        case MIST_FN_EXP:
+            return (exp(Value));
+        case MIST_FN_LN:
+            return (log(Value));
+        case MIST_FN_LOG:
+            return (log10(Value));
+    }
+    return (0);
+}
+
+/**
+********************************************************************************
+* @brief Executes one operation of an element-wise REAL kernel on all
+*        lanes. The SIMD loop and the scalar loop compute exactly what the
+*        corresponding instruction MIST_I_xxxF computes for one element.
+*
+* @param[in]  Op       operation MIST_V_ADD .. MIST_V_ABS
+* @param[out] pD       result lanes, may be the same as pA or pB
+* @param[in]  pA, pB   operand lanes, pB is not used by MIST_V_NEG and MIST_V_ABS
+* @param[in]  Count    number of lanes
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Vm_VecOp(UINT32 Op, REAL32 * pD, const REAL32 * pA, const REAL32 * pB, UINT32 Count)
+{
+    UINT32  i = 0;
+#ifdef VM_SIMD
+    VM_V    Sign = VM_VSPLAT(-0.0f);
+    VM_V    Zero = VM_VSPLAT(0.0f);
+    VM_V    V;
+
+    if (VmSimd)
+    {
+        switch (Op)
+        {
+            case MIST_V_ADD:
+                for (; i + VM_SIMD <= Count; i += VM_SIMD)
+                    VM_VSTORE(pD + i, VM_VADD(VM_VLOAD(pA + i), VM_VLOAD(pB + i)));
+                break;
+            case MIST_V_SUB:
+                for (; i + VM_SIMD <= Count; i += VM_SIMD)
+                    VM_VSTORE(pD + i, VM_VSUB(VM_VLOAD(pA + i), VM_VLOAD(pB + i)));
+                break;
+            case MIST_V_MUL:
+                for (; i + VM_SIMD <= Count; i += VM_SIMD)
+                    VM_VSTORE(pD + i, VM_VMUL(VM_VLOAD(pA + i), VM_VLOAD(pB + i)));
+                break;
+            case MIST_V_DIV:
+                for (; i + VM_SIMD <= Count; i += VM_SIMD)
+                    VM_VSTORE(pD + i, VM_VDIV(VM_VLOAD(pA + i), VM_VLOAD(pB + i)));
+                break;
+            case MIST_V_MIN:
+                /* (a < b) ? a : b, also for NaN and signed zeros */
+                for (; i + VM_SIMD <= Count; i += VM_SIMD)
+                    VM_VSTORE(pD + i, VM_VMIN(VM_VLOAD(pA + i), VM_VLOAD(pB + i)));
+                break;
+            case MIST_V_MAX:
+                for (; i + VM_SIMD <= Count; i += VM_SIMD)
+                    VM_VSTORE(pD + i, VM_VMAX(VM_VLOAD(pA + i), VM_VLOAD(pB + i)));
+                break;
+            case MIST_V_NEG:
+                for (; i + VM_SIMD <= Count; i += VM_SIMD)
+                    VM_VSTORE(pD + i, VM_VXOR(VM_VLOAD(pA + i), Sign));
+                break;
+            case MIST_V_ABS:
+                /* (a < 0) ? -a : a, -0 and NaN remain unchanged */
+                for (; i + VM_SIMD <= Count; i += VM_SIMD)
+                {
+                    V = VM_VLOAD(pA + i);
+                    VM_VSTORE(pD + i, VM_VSEL(VM_VLT(V, Zero), VM_VXOR(V, Sign), V));
+                }
+                break;
+        }
+    }
+#endif
+
+    /* Scalar code for the remaining lanes */
+    switch (Op)
+    {
+        case MIST_V_ADD:
+            for (; i < Count; i++)
+                pD[i] = pA[i] + pB[i];
+            break;
+        case MIST_V_SUB:
+            for (; i < Count; i++)
+                pD[i] = pA[i] - pB[i];
+            break;
+        case MIST_V_MUL:
+            for (; i < Count; i++)
+                pD[i] = pA[i] * pB[i];
+            break;
+        case MIST_V_DIV:
+            for (; i < Count; i++)
+                pD[i] = pA[i] / pB[i];
+            break;
+        case MIST_V_MIN:
+            for (; i < Count; i++)
+                pD[i] = (pA[i] < pB[i]) ? pA[i] : pB[i];
+            break;
+        case MIST_V_MAX:
+            for (; i < Count; i++)
+                pD[i] = (pA[i] > pB[i]) ? pA[i] : pB[i];
+            break;
+        case MIST_V_NEG:
+            for (; i < Count; i++)
+                pD[i] = -pA[i];
+            break;
+        case MIST_V_ABS:
+            for (; i < Count; i++)
+                pD[i] = (pA[i] < 0) ? -pA[i] : pA[i];
+            break;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Executes the first iterations of an element-wise REAL kernel in
+*        chunks of MIST_VM_VECLEN iterations. Loads don't copy, the lanes
+*        point into the data area. The iterations of a chunk are processed
+*        in ascending order of the addresses, they are independent.
+*
+* @param[in]  pVm      program instance
+* @param[in]  pK       block descriptor of MIST_I_VECF
+* @param[in]  Count    number of iterations, <= pK->Count
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Vm_Vector(MIST_VM * pVm, const MIST_VM_BLOCK * pK, UINT32 Count)
+{
+    const MIST_VM_VOP *pFirst = pVm->pCode->pVop + pK->Ops;
+    const MIST_VM_VOP *pEnd = pFirst + pK->NbOfOps;
+    const MIST_VM_VOP *pOp;
+    REAL32 *pLane[MIST_VM_VECREGS];
+    REAL32 *pD;
+    REAL32  Value;
+    UINT32  Done, n, i;
+    SINT32  Offset;
+
+    for (Done = 0; Done < Count; Done += n)
+    {
+        n = (Count - Done < MIST_VM_VECLEN) ? Count - Done : MIST_VM_VECLEN;
+        Offset = (pK->Dir > 0) ? (SINT32) (Done * sizeof(REAL32)) : -(SINT32) ((Done + n - 1) * sizeof(REAL32));
+
+        for (pOp = pFirst; pOp < pEnd; pOp++)
+        {
+            pD = pVm->pLane + pOp->Dst * MIST_VM_VECLEN;
+            switch (pOp->Op)
+            {
+                case MIST_V_LD:
+                    pLane[pOp->Dst] = (REAL32 *) (pVm->pMem + pOp->Arg + Offset);
+                    break;
+                case MIST_V_SPLAT:
+                    Value = pVm->pReg[pOp->Arg].f;
+                    for (i = 0; i < n; i++)
+                        pD[i] = Value;
+                    pLane[pOp->Dst] = pD;
+                    break;
+                case MIST_V_ST:
+                    memmove(pVm->pMem + pOp->Arg + Offset, pLane[pOp->A], n * sizeof(REAL32));
+                    break;
+                default:
+                    Vm_VecOp(pOp->Op, pD, pLane[pOp->A], pLane[pOp->B], n);
+                    pLane[pOp->Dst] = pD;
+                    break;
+            }
+        }
+    }
+}
+
+/**
+********************************************************************************
+* @brief Executes the first iterations of a block operation, the elements
+*        are copied, filled or computed in one pass instead of one dispatch
+*        per element. Afterwards the control variable has the value the
+*        loop would have left behind, truncated to its size.
+*
+* @param[in]  pVm      program instance
+* @param[in]  pK       block descriptor
+* @param[in]  Op       MIST_I_COPY, MIST_I_FILL or MIST_I_VECF
+* @param[in]  pValue   fill value of MIST_I_FILL
+* @param[in]  Count    number of iterations, <= pK->Count
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Vm_Block(MIST_VM * pVm, const MIST_VM_BLOCK * pK, UINT32 Op, const MIST_REG * pValue, UINT32 Count)
+{
+    UINT8  *pMem = pVm->pMem;
+    UINT32  Dst = pK->Dst;
+    UINT32  Src = pK->Src;
+    UINT32  Var = pK->Start + Count * pK->Step;
+    UINT32  i;
+
+    /* Lowest element first, source and target never overlap */
+    if (Count && (pK->Dir < 0))
+    {
+        Dst -= (Count - 1) * pK->ElemSize;
+        Src -= (Count - 1) * pK->ElemSize;
+    }
+
+    if (!Count)
+        ;
+    else if (Op == MIST_I_VECF)
+        Vm_Vector(pVm, pK, Count);
+    else if (Op == MIST_I_COPY)
+        memcpy(pMem + Dst, pMem + Src, Count * pK->ElemSize);
+    else
+    {
+        switch (pK->ElemSize)
+        {
+            case 1:
+                memset(pMem + Dst, (UINT8) pValue->u, Count);
+                break;
+            case 2:
+                for (i = 0; i < Count; i++)
+                    ((UINT16 *) (pMem + Dst))[i] = (UINT16) pValue->u;
+                break;
+            case 4:
+                for (i = 0; i < Count; i++)
+                    ((UINT32 *) (pMem + Dst))[i] = pValue->u;
+                break;
+            default:
+                for (i = 0; i < Count; i++)
+                    ((REAL64 *) (pMem + Dst))[i] = pValue->d;
+                break;
+        }
+    }
+
+    switch (pK->VarSize)
+    {
+        case 1:
+            *(UINT8 *) (pMem + pK->VarOffset) = (UINT8) Var;
+            break;
+        case 2:
+            *(UINT16 *) (pMem + pK->VarOffset) = (UINT16) Var;
+            break;
+        default:
+            *(UINT32 *) (pMem + pK->VarOffset) = Var;
+            break;
+    }
+}
+
+/**
+********************************************************************************
+* @brief Allocates an instance of a compiled program: register file, data
+*        area and the lane buffers of element-wise kernels in one block.
+*
+* @param[in]  pCode    compiled program
+* @param[in]  MemSize  size of the data area, 0 for a clone sharing it
+* @param[out] N/A
+*
+* @retval     != NULL .. pointer to program instance, all memory is 0
+* @retval     = NULL  .. out of memory
+*******************************************************************************/
+MLOCAL MIST_VM *Vm_Alloc(const MIST_CODE * pCode, UINT32 MemSize)
+{
+    MIST_VM *pVm;
+    UINT32  RegSize = pCode->NbOfRegs * sizeof(MIST_REG);
+    UINT32  LaneSize = 0;
+
+    /* Lanes 32 byte aligned for the SIMD code */
+    if (pCode->NbOfVops)
+        LaneSize = MIST_VM_VECREGS * MIST_VM_VECLEN * sizeof(REAL32) + 32;
+
+    /* Registers first, so that the data area is 8 byte aligned as well */
+    pVm = calloc(1, sizeof(MIST_VM) + sizeof(MIST_REG) + RegSize + MemSize + LaneSize);
+    if (!pVm)
+        return (NULL);
+
+    pVm->pCode = pCode;
+    pVm->pReg = (MIST_REG *) ((UINT8 *) pVm + ((sizeof(MIST_VM) + sizeof(MIST_REG) - 1) & ~(sizeof(MIST_REG) - 1)));
+    pVm->pMem = (UINT8 *) (pVm->pReg + pCode->NbOfRegs);
+    if (LaneSize)
+        pVm->pLane = (REAL32 *) (pVm->pMem + MemSize + ((0 - (UINT32) (size_t) (pVm->pMem + MemSize)) & 31));
+    return (pVm);
+}
+
+/**
+********************************************************************************
+* @brief Creates an instance of a compiled program.
+*        Register file, data area and the lane buffers of element-wise
+*        kernels are allocated in one block, the constants and initial
+*        values are set by mist_VmReset(). Programs with VAR_INPUT or
+*        VAR_OUTPUT variables get a process image (mist_img.c).
+*        The code must stay valid as long as the instance exists.
+*
+* @param[in]  pCode    compiled program
+* @param[in]  Budget   max. number of backward jumps per cycle, 0 = MIST_VM_BUDGET
+* @param[out] N/A
+*
+* @retval     != NULL .. pointer to program instance
+* @retval     = NULL  .. out of memory
+*******************************************************************************/
+MIST_VM *mist_VmCreate(const MIST_CODE * pCode, UINT32 Budget)
+{
+    CHAR    Func[] = "mist_VmCreate";
+    MIST_VM *pVm;
+
+    pVm = Vm_Alloc(pCode, pCode->MemSize);
+    if (!pVm)
+    {
+        LOG_E(0, Func, "No memory for program '%s'!", pCode->Name);
+        return (NULL);
+    }
+
+    if (mist_ImgCreate(pCode, &pVm->pImg) < 0)
+    {
+        free(pVm);
+        return (NULL);
+    }
+
+    pVm->Budget = Budget ? Budget : MIST_VM_BUDGET;
+    mist_VmReset(pVm);
+    return (pVm);
+}
+
+/**
+********************************************************************************
+* @brief Prepares an instance for the parallel execution by mist_VmRunPar():
+*        creates a clone with its own register file and lane buffers for
+*        each worker. Programs with a single segment remain serial.
+*        Being called before the instance is executed the first time.
+*
+* @param[in]  pVm          program instance
+* @param[in]  NbOfWorkers  number of workers of the pool, including the calling task
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, out of memory
+*******************************************************************************/
+SINT32 mist_VmParInit(MIST_VM * pVm, UINT32 NbOfWorkers)
+{
+    const MIST_CODE *pCode = pVm->pCode;
+    MIST_VM *pClone;
+    UINT32  i;
+    CHAR    Func[] = "mist_VmParInit";
+
+    if ((pCode->NbOfSegs < 2) || (NbOfWorkers < 2) || pVm->NbOfClones)
+        return (OK);
+
+    pVm->ppClone = calloc(NbOfWorkers, sizeof(MIST_VM *));
+    pVm->pSegRun = calloc(pCode->NbOfSegs, sizeof(MIST_VM_SEGRUN));
+    for (i = 0; pVm->ppClone && pVm->pSegRun && (i < NbOfWorkers); i++)
+    {
+        pClone = Vm_Alloc(pCode, 0);
+        if (!pClone)
+            break;
+        memcpy(pClone->pReg, pCode->pConst, pCode->NbOfConsts * sizeof(MIST_REG));
+        pClone->pMem = pVm->pMem;
+        pClone->Budget = pVm->Budget;
+        pVm->ppClone[i] = pClone;
+    }
+
+    if (i < NbOfWorkers)
+    {
+        LOG_E(0, Func, "No memory for %u workers of program '%s'!", NbOfWorkers, pCode->Name);
+        for (i = 0; pVm->ppClone && (i < NbOfWorkers); i++)
+            free(pVm->ppClone[i]);
+        free(pVm->ppClone);
+        free(pVm->pSegRun);
+        pVm->ppClone = NULL;
+        pVm->pSegRun = NULL;
+        return (ERROR);
+    }
+
+    pVm->NbOfClones = NbOfWorkers;
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Deletes a program instance, the code is not released.
+*
+* @param[in]  pVm      program instance
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_VmDelete(MIST_VM * pVm)
+{
+    UINT32  i;
+
+    if (pVm)
+    {
+        for (i = 0; i < pVm->NbOfClones; i++)
+            free(pVm->ppClone[i]);
+        free(pVm->ppClone);
+        free(pVm->pSegRun);
+        mist_ImgDelete(pVm->pImg);
+        mist_SviMapFree(pVm->pSviMap);
+        free(pVm);
+    }
+}
+
+/**
+********************************************************************************
+* @brief Sets all variables to their initial values (cold start)
+*        and clears a previous fault.
+*
+* @param[in]  pVm      program instance
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_VmReset(MIST_VM * pVm)
+{
+    const MIST_CODE *pCode = pVm->pCode;
+
+    memset(pVm->pReg, 0, pCode->NbOfRegs * sizeof(MIST_REG));
+    memcpy(pVm->pReg, pCode->pConst, pCode->NbOfConsts * sizeof(MIST_REG));
+    memcpy(pVm->pMem, pCode->pInit, pCode->MemSize);
+    pVm->Fault = MIST_VM_E_OK;
+    pVm->FaultPc = 0;
+    pVm->NbOfCycles = 0;
+    if (pVm->pImg)
+        mist_ImgLoad(pVm->pImg, pVm->pMem, 0);
+}
+
+/**
+********************************************************************************
+* @brief Compares two variable names case insensitive, defines the order
+*        of the variable table of a compiled program.
+*
+* @param[in]  pA, pB   names
+* @param[out] N/A
+*
+* @retval     < 0, = 0, > 0 .. pA is sorted before, equal to, after pB
+*******************************************************************************/
+SINT32 mist_VmNameCmp(const CHAR * pA, const CHAR * pB)
+{
+    while (*pA && (toupper((UINT8) *pA) == toupper((UINT8) *pB)))
+    {
+        pA++;
+        pB++;
+    }
+    return (toupper((UINT8) *pA) - toupper((UINT8) *pB));
+}
+
+/**
+********************************************************************************
+* @brief Sort order of copy operations, ascending target offset.
+*
+* @param[in]  pA, pB   copy operations
+* @param[out] N/A
+*
+* @retval     < 0, = 0, > 0 .. pA is sorted before, equal to, after pB
+*******************************************************************************/
+MLOCAL int Vm_XferCmp(const VOID * pA, const VOID * pB)
+{
+    UINT32  DstA = ((const MIST_VM_XFER *) pA)->Dst;
+    UINT32  DstB = ((const MIST_VM_XFER *) pB)->Dst;
+
+    return ((DstA > DstB) - (DstA < DstB));
+}
+
+/**
+********************************************************************************
+* @brief Prepares the online change from one program to another one.
+*        Variables with the same name, data type and array bounds keep
+*        their values. One-dimensional arrays keep the elements within the
+*        bounds of both programs. Constants and VAR_TEMP are not taken
+*        over, new or changed variables start with their initial values.
+*        Adjacent variables are joined to a single copy operation, so
+*        mist_VmXfer() is a few memcpy() for an unchanged data layout.
+*
+* @param[in]  pOld        program being executed
+* @param[in]  pNew        program taking over
+* @param[out] ppXfer      copy operations, release with free(), NULL = none
+* @param[out] pNbOfXfers  number of copy operations
+* @param[out] pNbOfKept   number of variables keeping their values
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, out of memory
+*******************************************************************************/
+SINT32 mist_VmXferMap(const MIST_CODE * pOld, const MIST_CODE * pNew, MIST_VM_XFER ** ppXfer,
+                      UINT32 * pNbOfXfers, UINT32 * pNbOfKept)
+{
+    const MIST_CODE_VAR *pO = pOld->pVar;
+    const MIST_CODE_VAR *pOEnd = pOld->pVar + pOld->NbOfVars;
+    const MIST_CODE_VAR *pN;
+    MIST_VM_XFER *pXfer;
+    MIST_VM_XFER *pX;
+    UINT32  Count = 0;
+    UINT32  Elems;
+    UINT32  Dim;
+    UINT32  i;
+    SINT32  Cmp = 0;
+    SINT32  Lower, Upper;
+    CHAR    Func[] = "mist_VmXferMap";
+
+    *ppXfer = NULL;
+    *pNbOfXfers = 0;
+    *pNbOfKept = 0;
+
+    pXfer = malloc((pNew->NbOfVars + 1) * sizeof(MIST_VM_XFER));
+    if (!pXfer)
+    {
+        LOG_E(0, Func, "No memory for the online change of program '%s'!", pNew->Name);
+        return (ERROR);
+    }
+
+    /* Both tables are sorted by name */
+    for (i = 0, pN = pNew->pVar; i < pNew->NbOfVars; i++, pN++)
+    {
+        while ((pO < pOEnd) && ((Cmp = mist_VmNameCmp(pO->pName, pN->pName)) < 0))
+            pO++;
+        if ((pO == pOEnd) || Cmp)
+            continue;
+
+        if ((pN->Flags & MIST_VF_CONSTANT) || (pO->Flags & MIST_VF_CONSTANT) ||
+            (pN->Class == MIST_KW_VAR_TEMP) || (pO->Class == MIST_KW_VAR_TEMP) ||
+            (pN->Type != pO->Type) || (pN->NbOfDims != pO->NbOfDims))
+            continue;
+
+        pX = &pXfer[Count];
+        if (pN->NbOfDims == 1)
+        {
+            Lower = (pN->Lower[0] > pO->Lower[0]) ? pN->Lower[0] : pO->Lower[0];
+            Upper = (pN->Upper[0] < pO->Upper[0]) ? pN->Upper[0] : pO->Upper[0];
+            if (Lower > Upper)
+                continue;
+            pX->Dst = pN->MemOffset + (UINT32) (Lower - pN->Lower[0]) * pN->ElemSize;
+            pX->Src = pO->MemOffset + (UINT32) (Lower - pO->Lower[0]) * pO->ElemSize;
+            pX->Size = (UINT32) (Upper - Lower + 1) * pN->ElemSize;
+        }
+        else
+        {
+            for (Dim = 0, Elems = 1; Dim < pN->NbOfDims; Dim++)
+            {
+                if ((pN->Lower[Dim] != pO->Lower[Dim]) || (pN->Upper[Dim] != pO->Upper[Dim]))
+                    break;
+                Elems *= (UINT32) (pN->Upper[Dim] - pN->Lower[Dim] + 1);
+            }
+            if (Dim < pN->NbOfDims)
+                continue;
+            pX->Dst = pN->MemOffset;
+            pX->Src = pO->MemOffset;
+            pX->Size = Elems * pN->ElemSize;
+        }
+        Count++;
+    }
+    *pNbOfKept = Count;
+
+    if (!Count)
+    {
+        free(pXfer);
+        return (OK);
+    }
+
+    /* Join operations which are adjacent in both data areas */
+    qsort(pXfer, Count, sizeof(MIST_VM_XFER), Vm_XferCmp);
+    for (i = 1, pX = pXfer; i < Count; i++)
+    {
+        if ((pX->Dst + pX->Size == pXfer[i].Dst) && (pX->Src + pX->Size == pXfer[i].Src))
+            pX->Size += pXfer[i].Size;
+        else
+            *++pX = pXfer[i];
+    }
+
+    *ppXfer = pXfer;
+    *pNbOfXfers = pX - pXfer + 1;
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Takes over the variable values of a program instance into the
+*        instance of another program, see mist_VmXferMap(). The cycle
+*        counter continues. Executed between two cycles, never allocates.
+*
+* @param[in]  pNew       instance taking over
+* @param[in]  pOld       instance being executed so far
+* @param[in]  pXfer      copy operations of mist_VmXferMap()
+* @param[in]  NbOfXfers  number of copy operations
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_VmXfer(MIST_VM * pNew, const MIST_VM * pOld, const MIST_VM_XFER * pXfer, UINT32 NbOfXfers)
+{
+    for (; NbOfXfers; NbOfXfers--, pXfer++)
+        memcpy(pNew->pMem + pXfer->Dst, pOld->pMem + pXfer->Src, pXfer->Size);
+
+    pNew->NbOfCycles = pOld->NbOfCycles;
+    if (pNew->pImg)
+        mist_ImgLoad(pNew->pImg, pNew->pMem, pNew->NbOfCycles);
+}
+
+/**
+********************************************************************************
+* @brief Executes one cycle of a program, all segments in serial order.
+*        After a fault the program is not executed any more until
+*        mist_VmReset() is called.
+*
+* @param[in]  pVm      program instance
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, program has been stopped, see pVm->Fault
+*******************************************************************************/
+SINT32 mist_VmRun(MIST_VM * pVm)
+{
+    const MIST_CODE *pCode = pVm->pCode;
+    UINT32  Budget = pVm->Budget;
+    UINT32  Seg;
+
+    if (pVm->Fault)
+        return (ERROR);
+
+    /* Temporary variables start with their initial values in every cycle */
+    if (pCode->TempSize)
+        memcpy(pVm->pMem + pCode->TempOffset, pCode->pInit + pCode->TempOffset, pCode->TempSize);
+
+    for (Seg = 0; Seg < pCode->NbOfSegs; Seg++)
+    {
+        MIST_TRC(pVm->pTrc, MIST_TRC_SEG, Seg, 0);
+        if (Vm_Exec(pVm, pCode->pSeg[Seg], &Budget) < 0)
+            return (ERROR);
+        MIST_TRC(pVm->pTrc, MIST_TRC_SEGEND, Seg, 0);
+    }
+
+    pVm->NbOfCycles++;
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Executes one cycle of a program, the segments in parallel on the
+*        workers of a pool, see file header. Returns when all segments
+*        have been executed. Without clones (mist_VmParInit()) or pool the
+*        program is executed by mist_VmRun().
+*
+* @param[in]  pVm      program instance
+* @param[in]  pPar     worker pool, NULL = serial
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, program has been stopped, see pVm->Fault
+*******************************************************************************/
+SINT32 mist_VmRunPar(MIST_VM * pVm, struct MIST_PAR *pPar)
+{
+    const MIST_CODE *pCode = pVm->pCode;
+    MIST_VM_SEGRUN *pRun;
+    UINT32  Used = 0;
+    UINT32  Seg;
+
+    if (!pPar || (mist_ParWorkers(pPar) > pVm->NbOfClones))
+        return (mist_VmRun(pVm));
+    if (pVm->Fault)
+        return (ERROR);
+
+    /* Temporary variables start with their initial values in every cycle */
+    if (pCode->TempSize)
+        memcpy(pVm->pMem + pCode->TempOffset, pCode->pInit + pCode->TempOffset, pCode->TempSize);
+
+    pVm->ParLeft = pVm->Budget;
+    pVm->ParStopSeg = pCode->NbOfSegs;
+    mist_ParRun(pPar, pCode->NbOfSegs, Vm_ParJob, pVm);
+
+    /* Faults and loop budget like the serial execution */
+    for (Seg = 0, pRun = pVm->pSegRun; Seg < pCode->NbOfSegs; Seg++, pRun++)
+    {
+        /* the workers only take the time stamps, the ring has a single writer */
+        MIST_TRC_AT(pVm->pTrc, pRun->Start, MIST_TRC_SEG, Seg, pRun->Worker);
+        MIST_TRC_AT(pVm->pTrc, pRun->End, MIST_TRC_SEGEND, Seg, pRun->Worker);
+        Used += pRun->Used;
+        if (pRun->Fault || (Used >= pVm->Budget))
+        {
+            pVm->Fault = pRun->Fault ? pRun->Fault : MIST_VM_E_BUDGET;
+            pVm->FaultPc = pRun->Fault ? pRun->FaultPc : pCode->pSeg[Seg];
+            return (ERROR);
+        }
+    }
+
+    pVm->NbOfCycles++;
+    return (OK);
+}
+
+/**
+********************************************************************************
+* @brief Executes a segment of a program on the clone of a worker, job
+*        function of mist_VmRunPar(). The segment gets the budget left by
+*        the segments finished so far, it is skipped if a segment in front
+*        of it has stopped.
+*
+* @param[in]  pArg     program instance
+* @param[in]  Job      segment
+* @param[in]  Worker   worker of the pool
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+MLOCAL VOID Vm_ParJob(VOID * pArg, UINT32 Job, UINT32 Worker)
+{
+    MIST_VM *pVm = (MIST_VM *) pArg;
+    MIST_VM *pClone = pVm->ppClone[Worker];
+    MIST_VM_SEGRUN *pRun = &pVm->pSegRun[Job];
+    UINT32  Left = pVm->ParLeft;
+    UINT32  Budget = Left;
+    UINT32  Old;
+
+    if (pVm->pTrc)
+    {
+        pRun->Worker = Worker;
+        pRun->Start = mist_TrcStamp();
+    }
+    pRun->Fault = MIST_VM_E_OK;
+    pRun->Used = 0;
+    if (Job > pVm->ParStopSeg)
+    {
+        /* skipped, the cycle is stopped in front of it */
+    }
+    else if (!Left)
+    {
+        pRun->Fault = MIST_VM_E_BUDGET;
+        pRun->FaultPc = pVm->pCode->pSeg[Job];
+    }
+    else
+    {
+        pClone->Fault = MIST_VM_E_OK;
+        Vm_Exec(pClone, pVm->pCode->pSeg[Job], &Budget);
+        pRun->Fault = pClone->Fault;
+        pRun->FaultPc = pClone->FaultPc;
+        pRun->Used = (pClone->Fault == MIST_VM_E_BUDGET) ? Left : Left - Budget;
+
+        /* Take the used part from the shared budget, the others may have used it meanwhile */
+        do
+        {
+            Old = pVm->ParLeft;
+        }
+        while (!MIST_CAS(&pVm->ParLeft, Old, (Old > pRun->Used) ? Old - pRun->Used : 0));
+    }
+
+    /* The first stopped segment in serial order, the ones behind it are skipped */
+    if (pRun->Fault)
+    {
+        do
+        {
+            Old = pVm->ParStopSeg;
+        }
+        while ((Job < Old) && !MIST_CAS(&pVm->ParStopSeg, Old, Job));
+    }
+    if (pVm->pTrc)
+        pRun->End = mist_TrcStamp();
+}
+
+/**
+********************************************************************************
+* @brief Executes a segment of a program up to its MIST_I_END.
+*
+* @param[in]  pVm      program instance or clone
+* @param[in]  Entry    first instruction of the segment
+* @param[in]  pBudget  remaining backward jumps of the cycle
+* @param[out] pBudget  updated, not after a fault
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, program has been stopped, see pVm->Fault
+*******************************************************************************/
+MLOCAL SINT32 Vm_Exec(MIST_VM * pVm, UINT32 Entry, UINT32 * pBudget)
+{
+    const MIST_CODE *pCode = pVm->pCode;
+    const MIST_INSTR *pBase = pCode->pInstr;
+    const MIST_INSTR *pI = pBase + Entry;
+    const MIST_VM_DESC *pD;
+    const MIST_VM_BLOCK *pK;
+    MIST_REG *R = pVm->pReg;
+    UINT8  *pMem = pVm->pMem;
+    UINT32  Budget = *pBudget;
+    UINT32  Fault;
+    UINT32  Idx;
+
+#ifdef VM_THREADED
+    static const VOID *const VmLabels[MIST_I_COUNT] = {
+        &&L_MIST_I_END, &&L_MIST_I_JMP, &&L_MIST_I_JZ, &&L_MIST_I_JNZ,
+        &&L_MIST_I_JMPB, &&L_MIST_I_JZB, &&L_MIST_I_JNZB, &&L_MIST_I_MOV,
+        &&L_MIST_I_LDS8, &&L_MIST_I_LDU8, &&L_MIST_I_LDS16, &&L_MIST_I_LDU16,
+        &&L_MIST_I_LD32, &&L_MIST_I_LD64, &&L_MIST_I_ST8, &&L_MIST_I_ST16,
+        &&L_MIST_I_ST32, &&L_MIST_I_ST64, &&L_MIST_I_LDRS8, &&L_MIST_I_LDRU8,
+        &&L_MIST_I_LDRS16, &&L_MIST_I_LDRU16, &&L_MIST_I_LDR32, &&L_MIST_I_LDR64,
+        &&L_MIST_I_STR8, &&L_MIST_I_STR16, &&L_MIST_I_STR32, &&L_MIST_I_STR64,
+        &&L_MIST_I_IDX, &&L_MIST_I_IDXA, &&L_MIST_I_ADD, &&L_MIST_I_SUB,
+        &&L_MIST_I_MUL, &&L_MIST_I_DIV, &&L_MIST_I_MOD, &&L_MIST_I_DIVU,
+        &&L_MIST_I_MODU, &&L_MIST_I_NEG, &&L_MIST_I_AND, &&L_MIST_I_OR,
+        &&L_MIST_I_XOR, &&L_MIST_I_NOT, &&L_MIST_I_EQ, &&L_MIST_I_NE,
+        &&L_MIST_I_LT, &&L_MIST_I_LE, &&L_MIST_I_GT, &&L_MIST_I_GE,
+        &&L_MIST_I_LTU, &&L_MIST_I_LEU, &&L_MIST_I_GTU, &&L_MIST_I_GEU,
+        &&L_MIST_I_MIN, &&L_MIST_I_MAX, &&L_MIST_I_MINU, &&L_MIST_I_MAXU,
+        &&L_MIST_I_ABS, &&L_MIST_I_SX8, &&L_MIST_I_SX16, &&L_MIST_I_ZX8,
+        &&L_MIST_I_ZX16, &&L_MIST_I_ADDF, &&L_MIST_I_SUBF, &&L_MIST_I_MULF,
+        &&L_MIST_I_DIVF, &&L_MIST_I_NEGF, &&L_MIST_I_ABSF, &&L_MIST_I_MINF,
+        &&L_MIST_I_MAXF, &&L_MIST_I_POWF, &&L_MIST_I_MATHF, &&L_MIST_I_EQF,
+        &&L_MIST_I_NEF, &&L_MIST_I_LTF, &&L_MIST_I_LEF, &&L_MIST_I_GTF,
+        &&L_MIST_I_GEF, &&L_MIST_I_ADDD, &&L_MIST_I_SUBD, &&L_MIST_I_MULD,
+        &&L_MIST_I_DIVD, &&L_MIST_I_NEGD, &&L_MIST_I_ABSD, &&L_MIST_I_MIND,
+        &&L_MIST_I_MAXD, &&L_MIST_I_POWD, &&L_MIST_I_MATHD, &&L_MIST_I_EQD,
+        &&L_MIST_I_NED, &&L_MIST_I_LTD, &&L_MIST_I_LED, &&L_MIST_I_GTD,
+        &&L_MIST_I_GED, &&L_MIST_I_ITOF, &&L_MIST_I_UTOF, &&L_MIST_I_ITOD,
+        &&L_MIST_I_UTOD, &&L_MIST_I_FTOD, &&L_MIST_I_DTOF, &&L_MIST_I_FTOI,
+        &&L_MIST_I_DTOI, &&L_MIST_I_FTOU, &&L_MIST_I_DTOU, &&L_MIST_I_TRUNCF,
+        &&L_MIST_I_TRUNCD, &&L_MIST_I_LOOP, &&L_MIST_I_COPY, &&L_MIST_I_FILL,
+        &&L_MIST_I_VECF
+    };
+#endif
+
+#ifdef VM_THREADED
+    goto *VmLabels[pI->Op];
+#else
+    for (;;)
+    {
+        if (pI->Op >= MIST_I_COUNT)
+        {
+            Fault = MIST_VM_E_OPCODE;
+            goto Stop;
+        }
+
+        switch (pI->Op)
+        {
+#endif
+            VM_OP(MIST_I_END)
+                *pBudget = Budget;
+                return (OK);
+
+            /* Jumps, backward jumps are counted against the budget */
+            VM_OP(MIST_I_JMP)
+                VM_JUMP(MIST_I_IMM(pI));
+            VM_OP(MIST_I_JZ)
+                if (!RA.i)
+                {
+                    VM_JUMP(MIST_I_IMM(pI));
+                }
+                VM_NEXT;
+            VM_OP(MIST_I_JNZ)
+                if (RA.i)
+                {
+                    VM_JUMP(MIST_I_IMM(pI));
+                }
+                VM_NEXT;
+            VM_OP(MIST_I_JMPB)
+                if (!--Budget)
+                    goto Budget;
+                VM_JUMP(MIST_I_IMM(pI));
+            VM_OP(MIST_I_JZB)
+                if (!RA.i)
+                {
+                    if (!--Budget)
+                        goto Budget;
+                    VM_JUMP(MIST_I_IMM(pI));
+                }
+                VM_NEXT;
+            VM_OP(MIST_I_JNZB)
+                if (RA.i)
+                {
+                    if (!--Budget)
+                        goto Budget;
+                    VM_JUMP(MIST_I_IMM(pI));
+                }
+                VM_NEXT;
+            VM_OP(MIST_I_MOV)
+                RA = RB;
+                VM_NEXT;
+
+            /* Data area, direct */
+            VM_OP(MIST_I_LDS8)
+                RA.i = MEM(SINT8);
+                VM_NEXT;
+            VM_OP(MIST_I_LDU8)
+                RA.i = MEM(UINT8);
+                VM_NEXT;
+            VM_OP(MIST_I_LDS16)
+                RA.i = MEM(SINT16);
+                VM_NEXT;
+            VM_OP(MIST_I_LDU16)
+                RA.i = MEM(UINT16);
+                VM_NEXT;
+            VM_OP(MIST_I_LD32)
+                RA.u = MEM(UINT32);
+                VM_NEXT;
+            VM_OP(MIST_I_LD64)
+                RA.d = MEM(REAL64);
+                VM_NEXT;
+            VM_OP(MIST_I_ST8)
+                MEM(UINT8) = (UINT8) RA.u;
+                VM_NEXT;
+            VM_OP(MIST_I_ST16)
+                MEM(UINT16) = (UINT16) RA.u;
+                VM_NEXT;
+            VM_OP(MIST_I_ST32)
+                MEM(UINT32) = RA.u;
+                VM_NEXT;
+            VM_OP(MIST_I_ST64)
+                MEM(REAL64) = RA.d;
+                VM_NEXT;
+
+            /* Data area, offset in register */
+            VM_OP(MIST_I_LDRS8)
+                RA.i = MEMR(SINT8);
+                VM_NEXT;
+            VM_OP(MIST_I_LDRU8)
+                RA.i = MEMR(UINT8);
+                VM_NEXT;
+            VM_OP(MIST_I_LDRS16)
+                RA.i = MEMR(SINT16);
+                VM_NEXT;
+            VM_OP(MIST_I_LDRU16)
+                RA.i = MEMR(UINT16);
+                VM_NEXT;
+            VM_OP(MIST_I_LDR32)
+                RA.u = MEMR(UINT32);
+                VM_NEXT;
+            VM_OP(MIST_I_LDR64)
+                RA.d = MEMR(REAL64);
+                VM_NEXT;
+            VM_OP(MIST_I_STR8)
+                MEMR(UINT8) = (UINT8) RA.u;
+                VM_NEXT;
+            VM_OP(MIST_I_STR16)
+                MEMR(UINT16) = (UINT16) RA.u;
+                VM_NEXT;
+            VM_OP(MIST_I_STR32)
+                MEMR(UINT32) = RA.u;
+                VM_NEXT;
+            VM_OP(MIST_I_STR64)
+                MEMR(REAL64) = RA.d;
+                VM_NEXT;
+
+            /* Array index with bounds check */
+            VM_OP(MIST_I_IDX)
+                pD = &pCode->pDesc[pI->C];
+                Idx = RB.u - (UINT32) pD->Lower;
+                if (Idx >= pD->Count)
+                    goto Bounds;
+                RA.u = pD->Base + Idx * pD->Scale;
+                VM_NEXT;
+            VM_OP(MIST_I_IDXA)
+                pD = &pCode->pDesc[pI->C];
+                Idx = RB.u - (UINT32) pD->Lower;
+                if (Idx >= pD->Count)
+                    goto Bounds;
+                RA.u += Idx * pD->Scale;
+                VM_NEXT;
+
+            /* 32 bit integer */
+            VM_OP(MIST_I_ADD)
+                RA.u = RB.u + RC.u;
+                VM_NEXT;
+            VM_OP(MIST_I_SUB)
+                RA.u = RB.u - RC.u;
+                VM_NEXT;
+            VM_OP(MIST_I_MUL)
+                RA.u = RB.u * RC.u;
+                VM_NEXT;
+            VM_OP(MIST_I_DIV)
+                if (!RC.i)
+                    goto DivZero;
+                RA.i = (RC.i == -1) ? (SINT32) (0u - RB.u) : RB.i / RC.i;
+                VM_NEXT;
+            VM_OP(MIST_I_MOD)
+                if (!RC.i)
+                    goto DivZero;
+                RA.i = (RC.i == -1) ? 0 : RB.i % RC.i;
+                VM_NEXT;
+            VM_OP(MIST_I_DIVU)
+                if (!RC.u)
+                    goto DivZero;
+                RA.u = RB.u / RC.u;
+                VM_NEXT;
+            VM_OP(MIST_I_MODU)
+                if (!RC.u)
+                    goto DivZero;
+                RA.u = RB.u % RC.u;
+                VM_NEXT;
+            VM_OP(MIST_I_NEG)
+                RA.u = 0u - RB.u;
+                VM_NEXT;
+            VM_OP(MIST_I_AND)
+                RA.u = RB.u & RC.u;
+                VM_NEXT;
+            VM_OP(MIST_I_OR)
+                RA.u = RB.u | RC.u;
+                VM_NEXT;
+            VM_OP(MIST_I_XOR)
+                RA.u = RB.u ^ RC.u;
+                VM_NEXT;
+            VM_OP(MIST_I_NOT)
+                RA.u = ~RB.u;
+                VM_NEXT;
+            VM_OP(MIST_I_EQ)
+                RA.i = (RB.u == RC.u);
+                VM_NEXT;
+            VM_OP(MIST_I_NE)
+                RA.i = (RB.u != RC.u);
+                VM_NEXT;
+            VM_OP(MIST_I_LT)
+                RA.i = (RB.i < RC.i);
+                VM_NEXT;
+            VM_OP(MIST_I_LE)
+                RA.i = (RB.i <= RC.i);
+                VM_NEXT;
+            VM_OP(MIST_I_GT)
+                RA.i = (RB.i > RC.i);
+                VM_NEXT;
+            VM_OP(MIST_I_GE)
+                RA.i = (RB.i >= RC.i);
+                VM_NEXT;
+            VM_OP(MIST_I_LTU)
+                RA.i = (RB.u < RC.u);
+                VM_NEXT;
+            VM_OP(MIST_I_LEU)
+                RA.i = (RB.u <= RC.u);
+                VM_NEXT;
+            VM_OP(MIST_I_GTU)
+                RA.i = (RB.u > RC.u);
+                VM_NEXT;
+            VM_OP(MIST_I_GEU)
+                RA.i = (RB.u >= RC.u);
+                VM_NEXT;
+            VM_OP(MIST_I_MIN)
+                RA.i = (RB.i < RC.i) ? RB.i : RC.i;
+                VM_NEXT;
+            VM_OP(MIST_I_MAX)
+                RA.i = (RB.i > RC.i) ? RB.i : RC.i;
+                VM_NEXT;
+            VM_OP(MIST_I_MINU)
+                RA.u = (RB.u < RC.u) ? RB.u : RC.u;
+                VM_NEXT;
+            VM_OP(MIST_I_MAXU)
+                RA.u = (RB.u > RC.u) ? RB.u : RC.u;
+                VM_NEXT;
+            VM_OP(MIST_I_ABS)
+                RA.u = (RB.i < 0) ? 0u - RB.u : RB.u;
+                VM_NEXT;
+            VM_OP(MIST_I_SX8)
+                RA.i = (SINT8) RB.u;
+                VM_NEXT;
+            VM_OP(MIST_I_SX16)
+                RA.i = (SINT16) RB.u;
+                VM_NEXT;
+            VM_OP(MIST_I_ZX8)
+                RA.u = (UINT8) RB.u;
+                VM_NEXT;
+            VM_OP(MIST_I_ZX16)
+                RA.u = (UINT16) RB.u;
+                VM_NEXT;
+
+            /* REAL */
+            VM_OP(MIST_I_ADDF)
+                RA.f = RB.f + RC.f;
+                VM_NEXT;
+            VM_OP(MIST_I_SUBF)
+                RA.f = RB.f - RC.f;
+                VM_NEXT;
+            VM_OP(MIST_I_MULF)
+                RA.f = RB.f * RC.f;
+                VM_NEXT;
+            VM_OP(MIST_I_DIVF)
+                RA.f = RB.f / RC.f;
+                VM_NEXT;
+            VM_OP(MIST_I_NEGF)
+                RA.f = -RB.f;
+                VM_NEXT;
+            VM_OP(MIST_I_ABSF)
+                RA.f = (RB.f < 0) ? -RB.f : RB.f;
+                VM_NEXT;
+            VM_OP(MIST_I_MINF)
+                RA.f = (RB.f < RC.f) ? RB.f : RC.f;
+                VM_NEXT;
+            VM_OP(MIST_I_MAXF)
+                RA.f = (RB.f > RC.f) ? RB.f : RC.f;
+                VM_NEXT;
+            VM_OP(MIST_I_POWF)
+                RA.f = (REAL32) pow(RB.f, RC.f);
+                VM_NEXT;
+            VM_OP(MIST_I_MATHF)
+                RA.f = (REAL32) mist_VmMath(pI->C, RB.f);
+                VM_NEXT;
+            VM_OP(MIST_I_EQF)
+                RA.i = (RB.f == RC.f);
+                VM_NEXT;
+            VM_OP(MIST_I_NEF)
+                RA.i = (RB.f != RC.f);
+                VM_NEXT;
+            VM_OP(MIST_I_LTF)
+                RA.i = (RB.f < RC.f);
+                VM_NEXT;
+            VM_OP(MIST_I_LEF)
+                RA.i = (RB.f <= RC.f);
+                VM_NEXT;
+            VM_OP(MIST_I_GTF)
+                RA.i = (RB.f > RC.f);
+                VM_NEXT;
+            VM_OP(MIST_I_GEF)
+                RA.i = (RB.f >= RC.f);
+                VM_NEXT;
+
+            /* LREAL */
+            VM_OP(MIST_I_ADDD)
+                RA.d = RB.d + RC.d;
+                VM_NEXT;
+            VM_OP(MIST_I_SUBD)
+                RA.d = RB.d - RC.d;
+                VM_NEXT;
+            VM_OP(MIST_I_MULD)
+                RA.d = RB.d * RC.d;
+                VM_NEXT;
+            VM_OP(MIST_I_DIVD)
+                RA.d = RB.d / RC.d;
+                VM_NEXT;
+            VM_OP(MIST_I_NEGD)
+                RA.d = -RB.d;
+                VM_NEXT;
+            VM_OP(MIST_I_ABSD)
+                RA.d = (RB.d < 0) ? -RB.d : RB.d;
+                VM_NEXT;
+            VM_OP(MIST_I_MIND)
+                RA.d = (RB.d < RC.d) ? RB.d : RC.d;
+                VM_NEXT;
+            VM_OP(MIST_I_MAXD)
+                RA.d = (RB.d > RC.d) ? RB.d : RC.d;
+                VM_NEXT;
+            VM_OP(MIST_I_POWD)
+                RA.d = pow(RB.d, RC.d);
+                VM_NEXT;
+            VM_OP(MIST_I_MATHD)
+                RA.d = mist_VmMath(pI->C, RB.d);
+                VM_NEXT;
+            VM_OP(MIST_I_EQD)
+                RA.i = (RB.d == RC.d);
+                VM_NEXT;
+            VM_OP(MIST_I_NED)
+                RA.i = (RB.d != RC.d);
+                VM_NEXT;
+            VM_OP(MIST_I_LTD)
+                RA.i = (RB.d < RC.d);
+                VM_NEXT;
+            VM_OP(MIST_I_LED)
+                RA.i = (RB.d <= RC.d);
+                VM_NEXT;
+            VM_OP(MIST_I_GTD)
+                RA.i = (RB.d > RC.d);
+                VM_NEXT;
+            VM_OP(MIST_I_GED)
+                RA.i = (RB.d >= RC.d);
+                VM_NEXT;
+
+            /* Conversions */
+            VM_OP(MIST_I_ITOF)
+                RA.f = (REAL32) RB.i;
+                VM_NEXT;
+            VM_OP(MIST_I_UTOF)
+                RA.f = (REAL32) RB.u;
+                VM_NEXT;
+            VM_OP(MIST_I_ITOD)
+                RA.d = (REAL64) RB.i;
+                VM_NEXT;
+            VM_OP(MIST_I_UTOD)
+                RA.d = (REAL64) RB.u;
+                VM_NEXT;
+            VM_OP(MIST_I_FTOD)
+                RA.d = (REAL64) RB.f;
+                VM_NEXT;
+            VM_OP(MIST_I_DTOF)
+                RA.f = (REAL32) RB.d;
+                VM_NEXT;
+            VM_OP(MIST_I_FTOI)
+                RA.i = mist_VmRound(RB.f);
+                VM_NEXT;
+            VM_OP(MIST_I_DTOI)
+                RA.i = mist_VmRound(RB.d);
+                VM_NEXT;
+            VM_OP(MIST_I_FTOU)
+                RA.u = mist_VmRoundU(RB.f);
+                VM_NEXT;
+            VM_OP(MIST_I_DTOU)
+                RA.u = mist_VmRoundU(RB.d);
+                VM_NEXT;
+            VM_OP(MIST_I_TRUNCF)
+                RA.i = mist_VmTrunc(RB.f);
+                VM_NEXT;
+            VM_OP(MIST_I_TRUNCD)
+                RA.i = mist_VmTrunc(RB.d);
+                VM_NEXT;
+
+            /* FOR loops with a trip count known by the compiler */
+            VM_OP(MIST_I_LOOP)
+                if (RA.u)
+                {
+                    RA.u--;
+                    if (!--Budget)
+                        goto Budget;
+                    VM_JUMP(MIST_I_IMM(pI));
+                }
+                VM_NEXT;
+            VM_OP(MIST_I_COPY)
+            VM_OP(MIST_I_FILL)
+            VM_OP(MIST_I_VECF)
+                /* Each iteration counts against the budget like the loop would */
+                pK = &pCode->pBlock[MIST_I_IMM(pI)];
+                Idx = (pK->Count < Budget) ? pK->Count : Budget - 1;
+                Vm_Block(pVm, pK, pI->Op, &RA, Idx);
+                if (Idx < pK->Count)
+                    goto Budget;
+                Budget -= Idx;
+                VM_NEXT;
+#ifndef VM_THREADED
+        }
+    }
+#endif
+
+  Bounds:
+    Fault = MIST_VM_E_BOUNDS;
+    goto Stop;
+  DivZero:
+    Fault = MIST_VM_E_DIVZERO;
+    goto Stop;
+  Budget:
+    Fault = MIST_VM_E_BUDGET;
+  Stop:
+    pVm->Fault = Fault;
+    pVm->FaultPc = pI - pBase;
+    return (ERROR);
+}
+
+/**
+********************************************************************************
+* @brief Returns the visible text of a fault reason.
+*
+* @param[in]  Fault    reason MIST_VM_E_xxx
+* @param[out] N/A
+*
+* @retval     pointer to text
+*******************************************************************************/
+const CHAR *mist_VmFaultText(UINT32 Fault)
+{
+    switch (Fault)
+    {
+        case MIST_VM_E_OK:
+            return ("no fault");
+        case MIST_VM_E_BOUNDS:
+            return ("array index out of bounds");
+        case MIST_VM_E_DIVZERO:
+            return ("integer division by zero");
+        case MIST_VM_E_BUDGET:
+            return ("loop budget exhausted");
+        default:
+            return ("invalid instruction");
+    }
+}
+
+/**
+********************************************************************************
+* @brief Prints the instructions of a compiled program.
+*
+* @param[in]  pCode    compiled program
+* @param[out] N/A
+*
+* @retval     N/A
+*******************************************************************************/
+VOID mist_VmDisasm(const MIST_CODE * pCode)
+{
+    const MIST_INSTR *pI;
+    const MIST_VM_BLOCK *pK;
+    const MIST_VM_VOP *pV;
+    UINT32  Seg = 0;
+    UINT32  i, j;
+
+    printf("%s: %u instructions, %u registers (%u constants), %u descriptors, %u blocks, %u bytes data, "
+           "%u segments\n", pCode->Name, pCode->NbOfInstr, pCode->NbOfRegs, pCode->NbOfConsts, pCode->NbOfDescs,
+           pCode->NbOfBlocks, pCode->MemSize, pCode->NbOfSegs);
+    for (i = 0; i < pCode->NbOfBlocks; i++)
+    {
+        pK = &pCode->pBlock[i];
+        printf("    k%u: @%u, @%u, %u x %d x %u bytes, @%u := %d + n * %d\n", i, pK->Dst, pK->Src,
+               pK->Count, pK->Dir, pK->ElemSize, pK->VarOffset, (SINT32) pK->Start, (SINT32) pK->Step);
+        for (j = pK->Ops; j < pK->Ops + pK->NbOfOps; j++)
+        {
+            pV = &pCode->pVop[j];
+            printf("        %-6s", (pV->Op <= MIST_V_ABS) ? VmVopName[pV->Op] : "???");
+            if (pV->Op == MIST_V_LD)
+                printf("v%u, @%u\n", pV->Dst, pV->Arg);
+            else if (pV->Op == MIST_V_SPLAT)
+                printf("v%u, r%u\n", pV->Dst, pV->Arg);
+            else if (pV->Op == MIST_V_ST)
+                printf("@%u, v%u\n", pV->Arg, pV->A);
+            else if (pV->Op >= MIST_V_NEG)
+                printf("v%u, v%u\n", pV->Dst, pV->A);
+            else
+                printf("v%u, v%u, v%u\n", pV->Dst, pV->A, pV->B);
+        }
+    }
+
+    for (i = 0; i < pCode->NbOfInstr; i++)
+    {
+        if ((pCode->NbOfSegs > 1) && (Seg < pCode->NbOfSegs) && (pCode->pSeg[Seg] == i))
+            printf("  segment %u:\n", Seg++);
+
+        pI = &pCode->pInstr[i];
+        if (pI->Op >= MIST_I_COUNT)
+        {
+            printf("%6u  ??? %u\n", i, pI->Op);
+            continue;
+        }
+
+        printf("%6u  %-7s", i, mist_VmOpName[pI->Op]);
+        switch (mist_VmFormat[pI->Op])
+        {
+            case MIST_FMT_T:
+                printf("%u", MIST_I_IMM(pI));
+                break;
+            case MIST_FMT_RT:
+                printf("r%u, %u", pI->A, MIST_I_IMM(pI));
+                break;
+            case MIST_FMT_RR:
+                printf("r%u, r%u", pI->A, pI->B);
+                break;
+            case MIST_FMT_RRR:
+                printf("r%u, r%u, r%u", pI->A, pI->B, pI->C);
+                break;
+            case MIST_FMT_RM:
+                printf("r%u, @%u", pI->A, MIST_I_IMM(pI));
+                break;
+            case MIST_FMT_RRD:
+                printf("r%u, r%u, d%u", pI->A, pI->B, pI->C);
+                break;
+            case MIST_FMT_RRF:
+                printf("r%u, r%u, %s", pI->A, pI->B, (pI->C < MIST_FN_COUNT) ? VmFnName[pI->C] : "?");
+                break;
+            case MIST_FMT_K:
+                printf("k%u", MIST_I_IMM(pI));
+                break;
+            case MIST_FMT_RK:
+                printf("r%u, k%u", pI->A, MIST_I_IMM(pI));
+                break;
+        }
+        printf("\n");
+    }
+}
+
+/**
+********************************************************************************
+* @brief Compiles and runs an ST program, to be called from the shell.
+*        The first program of the file is executed for the given number
+*        of cycles. Prints the average and maximum time per cycle.
+*
+* @param[in]  pFileName  ST source file
+* @param[in]  Cycles     number of cycles, 0 = 1000
+* @param[in]  Disasm     != 0 .. print the instructions
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR
+*******************************************************************************/
+SINT32 mist_PrgRun(CHAR * pFileName, UINT32 Cycles, UINT32 Disasm)
+{
+    MIST_CODE *pCode;
+    MIST_VM *pVm;
+    UINT32  Time, Start, MaxTime = 0, SumTime = 0;
+    UINT32  i;
+    SINT32  Ret = OK;
+
+    if (!Cycles)
+        Cycles = 1000;
+
+    if (mist_PrgLoad(pFileName, &pCode) < 0)
+        return (ERROR);
+    if (Disasm)
+        mist_VmDisasm(pCode);
+
+    pVm = mist_VmCreate(pCode, 0);
+    if (!pVm)
+    {
+        mist_CodeFree(pCode);
+        return (ERROR);
+    }
+
+    for (i = 0; (i < Cycles) && (Ret == OK); i++)
+    {
+        Start = m_GetProcTime();
+        Ret = mist_VmRun(pVm);
+        Time = m_GetProcTime() - Start;
+        SumTime += Time;
+        if (Time > MaxTime)
+            MaxTime = Time;
+    }
+
+    if (Ret < 0)
+        printf("%s: stopped in cycle %u at instruction %u: %s\n", pCode->Name, pVm->NbOfCycles,
+               pVm->FaultPc, mist_VmFaultText(pVm->Fault));
+    printf("%s: %u cycles, %u instructions, %u nodes optimized away, mean %u ns, max %u us per cycle\n",
+           pCode->Name, pVm->NbOfCycles, pCode->NbOfInstr, pCode->NbOfOptNodes, (UINT32) (SumTime * 1000.0 / i),
+           MaxTime);
+
+    mist_VmDelete(pVm);
+    mist_CodeFree(pCode);
+    return (Ret);
+}
+
+/**
+********************************************************************************
+* @brief Benchmark of the element-wise REAL kernels, to be called from the
+*        shell. Runs a program with three kernels over arrays of 1k to 64k
+*        elements once with SIMD and once with the scalar code, checks that
+*        both data areas are identical and prints the time per element.
+*
+* @param[in]  Cycles   number of cycles per array size, 0 = 100
+* @param[out] N/A
+*
+* @retval     = 0 .. OK
+* @retval     < 0 .. ERROR, results differ or compilation failed
+*******************************************************************************/
+SINT32 mist_VecBench(UINT32 Cycles)
+{
+    CHAR    Func[] = "mist_VecBench";
+    CHAR    Src[1024];
+    MIST_UNIT Unit;
+    MIST_CODE *pCode;
+    MIST_VM *pVm[2];
+    REAL32 *pX;
+    UINT32  Time[2];
+    UINT32  N, Offset, Seed, Start, i, k;
+    SINT32  Ret = OK;
+
+    if (!Cycles)
+        Cycles = 100;
+
+    for (N = 1024; (N <= 65536) && (Ret == OK); N *= 4)
+    {
+        snprintf(Src, sizeof(Src),
+                 "PROGRAM VecBench\n"
+                 "VAR\n"
+                 "  x, y, z : ARRAY[1..%u] OF REAL;\n"
+                 "  i : DINT;\n"
+                 "  k : REAL := 0.75;\n"
+                 "END_VAR\n"
+                 "FOR i := 1 TO %u DO\n"
+                 "  y[i] := x[i] * k + 1.0;\n"
+                 "END_FOR;\n"
+                 "FOR i := 1 TO %u DO\n"
+                 "  z[i] := LIMIT(-0.5, (x[i] - y[i]) / 3.0, 0.5);\n"
+                 "END_FOR;\n"
+                 "FOR i := %u TO 1 BY -1 DO\n"
+                 "  x[i] := ABS(z[i]) * 0.5 - y[i] * 0.25;\n"
+                 "END_FOR;\n"
+                 "END_PROGRAM\n", N, N, N, N);
+
+        pCode = NULL;
+        Ret = mist_Parse(&Unit, Src, strlen(Src));
+        if (Ret == OK)
+            Ret = mist_Compile(&Unit, Unit.pPous, Src, &pCode);
+        if (Ret < 0)
+        {
+            LOG_E(0, Func, "line %u: %s", Unit.ErrLine, Unit.ErrText);
+            mist_UnitFree(&Unit);
+            return (ERROR);
+        }
+        Offset = Unit.pPous->pVars->MemOffset;
+        mist_UnitFree(&Unit);
+
+        /* Same pseudo random values of x in both instances */
+        pVm[0] = mist_VmCreate(pCode, 4 * N);
+        pVm[1] = mist_VmCreate(pCode, 4 * N);
+        for (k = 0; (k < 2) && pVm[0] && pVm[1]; k++)
+        {
+            pX = (REAL32 *) (pVm[k]->pMem + Offset);
+            for (i = 0, Seed = 12345; i < N; i++)
+            {
+                Seed = Seed * 1103515245 + 12345;
+                pX[i] = ((SINT32) (Seed >> 8) - 0x800000) / 65536.0f;
+            }
+
+            VmSimd = (k == 0);
+            Start = m_GetProcTime();
+            for (i = 0; (i < Cycles) && (Ret == OK); i++)
+                Ret = mist_VmRun(pVm[k]);
+            Time[k] = m_GetProcTime() - Start;
+        }
+        VmSimd = TRUE;
+
+        if (!pVm[0] || !pVm[1])
+            Ret = ERROR;
+        else if (Ret < 0)
+            printf("%s: stopped: %s\n", Func, mist_VmFaultText(pVm[0]->Fault ? pVm[0]->Fault : pVm[1]->Fault));
+        else if (memcmp(pVm[0]->pMem, pVm[1]->pMem, pCode->MemSize))
+        {
+            printf("%s: %u elements: SIMD and scalar results differ!\n", Func, N);
+            Ret = ERROR;
+        }
+        else
+            printf("%s: %5u elements, %u cycles: SIMD %.3f ns, scalar %.3f ns per element, speedup %.2f\n",
+                   Func, N, Cycles, Time[0] * 1000.0 / Cycles / (3 * N), Time[1] * 1000.0 / Cycles / (3 * N),
+                   Time[0] ? (REAL64) Time[1] / Time[0] : 0.0);
+
+        mist_VmDelete(pVm[0]);
+        mist_VmDelete(pVm[1]);
+        mist_CodeFree(pCode);
+    }
+
+    return (Ret);
+}
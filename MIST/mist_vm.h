@@ -0,0 +1,457 @@
+/**
+********************************************************************************
+* @file     mist_vm.h
+* @author   Bachmann electronic GmbH
+* @version  $Revision: 3.90 $ $LastChangedBy: BE $
+* @date     $LastChangeDate: 2013-06-10 11:00:00 $
+*
+* @brief    This file contains all definitions and declarations of the
+*           bytecode compiler and the virtual machine (VM) executing
+*           Structured Text (ST) programs, which are global within the
+*           SW-module.
+*
+*           The VM is register based. Every instruction has 8 bytes:
+*           operation code and three 16 bit operands A, B and C.
+*           Registers hold 32 bit integers, REAL or LREAL values.
+*           Constants are kept in the first registers of the register file,
+*           variables are loaded from and stored to the data area.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
+*******************************************************************************/
+
+/* Avoid problems with multiple including */
+#ifndef MIST_VM__H
+#define MIST_VM__H
+
+/*--- Defines ---*/
+
+/*
+ * Operation codes
+ * Operands: R = register, M = 32 bit offset in data area (B:C),
+ * T = 32 bit jump target (B:C), D = index descriptor, F = math function,
+ * K = 32 bit block descriptor (B:C).
+ */
+#define MIST_I_END           0    /* -            end of cycle */
+#define MIST_I_JMP           1    /* T            jump forward */
+#define MIST_I_JZ            2    /* RA, T        jump forward if RA == 0 */
+#define MIST_I_JNZ           3    /* RA, T        jump forward if RA != 0 */
+#define MIST_I_JMPB          4    /* T            jump backward, counts against loop budget */
+#define MIST_I_JZB           5    /* RA, T        jump backward if RA == 0 */
+#define MIST_I_JNZB          6    /* RA, T        jump backward if RA != 0 */
+#define MIST_I_MOV           7    /* RA := RB */
+#define MIST_I_LDS8          8    /* RA := M, signed 8 bit */
+#define MIST_I_LDU8          9    /* RA := M, unsigned 8 bit, also BOOL */
+#define MIST_I_LDS16         10   /* RA := M, signed 16 bit */
+#define MIST_I_LDU16         11   /* RA := M, unsigned 16 bit */
+#define MIST_I_LD32          12   /* RA := M, 32 bit, also REAL */
+#define MIST_I_LD64          13   /* RA := M, 64 bit LREAL */
+#define MIST_I_ST8           14   /* M := RA, 8 bit */
+#define MIST_I_ST16          15   /* M := RA, 16 bit */
+#define MIST_I_ST32          16   /* M := RA, 32 bit */
+#define MIST_I_ST64          17   /* M := RA, 64 bit */
+#define MIST_I_LDRS8         18   /* RA := [RB], signed 8 bit, RB is an offset in the data area */
+#define MIST_I_LDRU8         19   /* RA := [RB], unsigned 8 bit */
+#define MIST_I_LDRS16        20   /* RA := [RB], signed 16 bit */
+#define MIST_I_LDRU16        21   /* RA := [RB], unsigned 16 bit */
+#define MIST_I_LDR32         22   /* RA := [RB], 32 bit */
+#define MIST_I_LDR64         23   /* RA := [RB], 64 bit */
+#define MIST_I_STR8          24   /* [RB] := RA, 8 bit */
+#define MIST_I_STR16         25   /* [RB] := RA, 16 bit */
+#define MIST_I_STR32         26   /* [RB] := RA, 32 bit */
+#define MIST_I_STR64         27   /* [RB] := RA, 64 bit */
+#define MIST_I_IDX           28   /* RA := Base(D) + (RB - Lower(D)) * Scale(D), bounds checked */
+#define MIST_I_IDXA          29   /* RA := RA + (RB - Lower(D)) * Scale(D), bounds checked */
+#define MIST_I_ADD           30   /* RA := RB + RC, 32 bit integer */
+#define MIST_I_SUB           31
+#define MIST_I_MUL           32
+#define MIST_I_DIV           33   /* signed, division by 0 stops the program */
+#define MIST_I_MOD           34   /* signed, division by 0 stops the program */
+#define MIST_I_DIVU          35   /* unsigned */
+#define MIST_I_MODU          36   /* unsigned */
+#define MIST_I_NEG           37   /* RA := -RB */
+#define MIST_I_AND           38   /* RA := RB & RC, bitwise, also BOOL */
+#define MIST_I_OR            39
+#define MIST_I_XOR           40
+#define MIST_I_NOT           41   /* RA := ~RB */
+#define MIST_I_EQ            42   /* RA := RB == RC, 32 bit integer */
+#define MIST_I_NE            43
+#define MIST_I_LT            44   /* signed */
+#define MIST_I_LE            45
+#define MIST_I_GT            46
+#define MIST_I_GE            47
+#define MIST_I_LTU           48   /* unsigned */
+#define MIST_I_LEU           49
+#define MIST_I_GTU           50
+#define MIST_I_GEU           51
+#define MIST_I_MIN           52   /* signed */
+#define MIST_I_MAX           53
+#define MIST_I_MINU          54   /* unsigned */
+#define MIST_I_MAXU          55
+#define MIST_I_ABS           56   /* RA := |RB| */
+#define MIST_I_SX8           57   /* RA := RB sign extended from 8 bit */
+#define MIST_I_SX16          58   /* RA := RB sign extended from 16 bit */
+#define MIST_I_ZX8           59   /* RA := RB zero extended from 8 bit */
+#define MIST_I_ZX16          60   /* RA := RB zero extended from 16 bit */
+#define MIST_I_ADDF          61   /* RA := RB + RC, REAL */
+#define MIST_I_SUBF          62
+#define MIST_I_MULF          63
+#define MIST_I_DIVF          64
+#define MIST_I_NEGF          65
+#define MIST_I_ABSF          66
+#define MIST_I_MINF          67
+#define MIST_I_MAXF          68
+#define MIST_I_POWF          69
+#define MIST_I_MATHF         70   /* RA := F(RB), F = MIST_FN_xxx in C */
+#define MIST_I_EQF           71
+#define MIST_I_NEF           72
+#define MIST_I_LTF           73
+#define MIST_I_LEF           74
+#define MIST_I_GTF           75
+#define MIST_I_GEF           76
+#define MIST_I_ADDD          77   /* RA := RB + RC, LREAL */
+#define MIST_I_SUBD          78
+#define MIST_I_MULD          79
+#define MIST_I_DIVD          80
+#define MIST_I_NEGD          81
+#define MIST_I_ABSD          82
+#define MIST_I_MIND          83
+#define MIST_I_MAXD          84
+#define MIST_I_POWD          85
+#define MIST_I_MATHD         86
+#define MIST_I_EQD           87
+#define MIST_I_NED           88
+#define MIST_I_LTD           89
+#define MIST_I_LED           90
+#define MIST_I_GTD           91
+#define MIST_I_GED           92
+#define MIST_I_ITOF          93   /* RA := (REAL) RB, signed */
+#define MIST_I_UTOF          94   /* RA := (REAL) RB, unsigned */
+#define MIST_I_ITOD          95   /* RA := (LREAL) RB, signed */
+#define MIST_I_UTOD          96   /* RA := (LREAL) RB, unsigned */
+#define MIST_I_FTOD          97   /* RA := (LREAL) RB */
+#define MIST_I_DTOF          98   /* RA := (REAL) RB */
+#define MIST_I_FTOI          99   /* RA := RB rounded to signed 32 bit, saturated */
+#define MIST_I_DTOI          100
+#define MIST_I_FTOU          101  /* RA := RB rounded to unsigned 32 bit, saturated */
+#define MIST_I_DTOU          102
+#define MIST_I_TRUNCF        103  /* RA := RB truncated to signed 32 bit, saturated */
+#define MIST_I_TRUNCD        104
+#define MIST_I_LOOP          105  /* RA, T        jump backward if RA != 0 and decrement RA */
+#define MIST_I_COPY          106  /* K            block copy of a FOR loop, see MIST_VM_BLOCK */
+#define MIST_I_FILL          107  /* RA, K        block fill of a FOR loop with RA */
+#define MIST_I_VECF          108  /* K            element-wise REAL kernel of a FOR loop, see MIST_VM_VOP */
+#define MIST_I_COUNT         109
+
+/* Operand formats of the operation codes */
+#define MIST_FMT_NONE        0    /* no operands */
+#define MIST_FMT_T           1    /* jump target */
+#define MIST_FMT_RT          2    /* register A, jump target */
+#define MIST_FMT_RR          3    /* registers A, B */
+#define MIST_FMT_RRR         4    /* registers A, B, C */
+#define MIST_FMT_RM          5    /* register A, data offset */
+#define MIST_FMT_RRD         6    /* registers A, B, index descriptor C */
+#define MIST_FMT_RRF         7    /* registers A, B, math function C */
+#define MIST_FMT_K           8    /* block descriptor */
+#define MIST_FMT_RK          9    /* register A, block descriptor */
+
+/* Math functions of MIST_I_MATHF and MIST_I_MATHD */
+#define MIST_FN_SQRT         0
+#define MIST_FN_SIN          1
+#define MIST_FN_COS          2
+#define MIST_FN_TAN          3
+#define MIST_FN_ASIN         4
+#define MIST_FN_ACOS         5
+#define MIST_FN_ATAN         6
+#define MIST_FN_EXP          7
+#define MIST_FN_LN           8
+#define MIST_FN_LOG          9
+#define MIST_FN_COUNT        10
+
+/* Operations of element-wise REAL kernels, see MIST_VM_VOP */
+#define MIST_V_LD            0    /* Dst := elements at Arg */
+#define MIST_V_SPLAT         1    /* Dst := register Arg in all lanes */
+#define MIST_V_ST            2    /* elements at Arg := A */
+#define MIST_V_ADD           3    /* Dst := A + B */
+#define MIST_V_SUB           4
+#define MIST_V_MUL           5
+#define MIST_V_DIV           6
+#define MIST_V_MIN           7    /* like MIST_I_MINF */
+#define MIST_V_MAX           8    /* like MIST_I_MAXF */
+#define MIST_V_NEG           9    /* Dst := -A */
+#define MIST_V_ABS           10   /* like MIST_I_ABSF */
+
+/* Reasons for stopping a program at run time */
+#define MIST_VM_E_OK         0
+#define MIST_VM_E_BOUNDS     1    /* array index out of bounds */
+#define MIST_VM_E_DIVZERO    2    /* integer division by zero */
+#define MIST_VM_E_BUDGET     3    /* loop budget of the cycle exhausted */
+#define MIST_VM_E_OPCODE     4    /* invalid operation code */
+
+/* Limits */
+#define MIST_VM_MAXREGS      0x7FFF    /* max. number of registers of a program */
+#define MIST_VM_BUDGET       100000    /* default number of backward jumps per cycle */
+#define MIST_VM_VECLEN       256       /* elements processed at once by MIST_I_VECF */
+#define MIST_VM_VECREGS      8         /* lane buffers of MIST_I_VECF */
+#define MIST_VM_MAXSEGS      64        /* max. number of independent segments of a program */
+
+/* Access to the 32 bit operand of jumps and memory access */
+#define MIST_I_IMM(pI)       (((UINT32) (pI)->B << 16) | (pI)->C)
+
+
+/*--- Structures ---*/
+
+/* Single instruction */
+typedef struct MIST_INSTR
+{
+    UINT16  Op;                         /* operation code MIST_I_xxx */
+    UINT16  A;                          /* destination or first operand */
+    UINT16  B;                          /* source operand, high word of 32 bit operand */
+    UINT16  C;                          /* source operand, low word of 32 bit operand */
+} MIST_INSTR;
+
+/* Register */
+typedef union MIST_REG
+{
+    SINT32  i;                          /* integer, BOOL */
+    UINT32  u;                          /* unsigned integer, data offset */
+    REAL32  f;                          /* REAL */
+    REAL64  d;                          /* LREAL */
+} MIST_REG;
+
+/* Index descriptor for one array dimension */
+typedef struct MIST_VM_DESC
+{
+    UINT32  Base;                       /* data offset of the array, first dimension only */
+    SINT32  Lower;                      /* lower bound */
+    UINT32  Count;                      /* number of indexes */
+    UINT32  Scale;                      /* bytes per index step */
+} MIST_VM_DESC;
+
+/*
+ * Block operation replacing a FOR loop over array elements, executed at
+ * once by MIST_I_COPY (Dst[k] := Src[k]), MIST_I_FILL (Dst[k] := RA) or
+ * MIST_I_VECF (operations Ops .. Ops + NbOfOps - 1 of pVop).
+ * Element k of the iteration k is at Dst + k * Dir * ElemSize.
+ */
+typedef struct MIST_VM_BLOCK
+{
+    UINT32  Dst;                        /* data offset of the target element of the first iteration */
+    UINT32  Src;                        /* data offset of the source element of the first iteration */
+    UINT32  Count;                      /* number of iterations */
+    SINT16  Dir;                        /* 1 = ascending, -1 = descending elements */
+    UINT16  ElemSize;                   /* bytes per element, 1, 2, 4 or 8 */
+    UINT32  VarOffset;                  /* data offset of the control variable */
+    UINT32  VarSize;                    /* size of the control variable in bytes */
+    UINT32  Start;                      /* value of the control variable in the first iteration */
+    UINT32  Step;                       /* increment of the control variable */
+    UINT32  Ops;                        /* first kernel operation, MIST_I_VECF */
+    UINT32  NbOfOps;                    /* number of kernel operations, MIST_I_VECF */
+} MIST_VM_BLOCK;
+
+/*
+ * Operation of an element-wise REAL kernel. The kernel processes up to
+ * MIST_VM_VECLEN iterations at once in lane buffers, one element per lane.
+ * Arg of MIST_V_LD and MIST_V_ST is the data offset of the element of the
+ * first iteration, all elements follow the control variable like the
+ * target of the block.
+ */
+typedef struct MIST_VM_VOP
+{
+    UINT8   Op;                         /* operation MIST_V_xxx */
+    UINT8   Dst;                        /* target lane buffer */
+    UINT8   A;                          /* lane buffers of the operands */
+    UINT8   B;
+    UINT32  Arg;                        /* data offset or register, see MIST_V_xxx */
+} MIST_VM_VOP;
+
+/*
+ * Variable of a compiled program, the table is sorted by name (case
+ * insensitive, see mist_VmNameCmp()). Describes the data area for the
+ * online change (mist_VmXferMap()).
+ */
+typedef struct MIST_CODE_VAR
+{
+    const CHAR *pName;                  /* name as declared, stored in the program block */
+    UINT16  Type;                       /* elementary data type, MIST_KW_BOOL .. MIST_KW_LWORD */
+    UINT16  Class;                      /* declaration section, MIST_KW_VAR .. MIST_KW_VAR_TEMP */
+    UINT16  Flags;                      /* MIST_VF_xxx */
+    UINT16  NbOfDims;                   /* 0 = scalar, else number of array dimensions */
+    SINT32  Lower[MIST_MAX_DIMS];       /* lower bound of each array dimension */
+    SINT32  Upper[MIST_MAX_DIMS];       /* upper bound of each array dimension */
+    UINT32  MemOffset;                  /* offset in the data area */
+    UINT32  ElemSize;                   /* size of an element in bytes */
+} MIST_CODE_VAR;
+
+/*
+ * Variable of the SVI registration table of a program, generated by the
+ * compiler and sorted by name (strcmp), see mist_SviExport()
+ */
+typedef struct MIST_CODE_SVI
+{
+    const CHAR *pName;                  /* name as declared, stored in the program block */
+    UINT32  Format;                     /* SVI_F_xxx of the element type and access, SVI_F_OUT or SVI_F_INOUT */
+    UINT32  Size;                       /* size in bytes, arrays: all elements */
+    UINT32  MemOffset;                  /* offset in the data area */
+    UINT32  Flags;                      /* MIST_VF_SVI_R or MIST_VF_SVI_RW, 0 = no attribute */
+} MIST_CODE_SVI;
+
+/* Compiled program, a single memory block released with mist_CodeFree() */
+typedef struct MIST_CODE
+{
+    CHAR    Name[32];                   /* program name */
+    MIST_INSTR *pInstr;                 /* instructions */
+    UINT32  NbOfInstr;                  /* number of instructions */
+    MIST_REG *pConst;                   /* constants, copied to the first registers */
+    UINT32  NbOfConsts;                 /* number of constants */
+    UINT32  NbOfRegs;                   /* number of registers including constants */
+    MIST_VM_DESC *pDesc;                /* index descriptors */
+    UINT32  NbOfDescs;                  /* number of index descriptors */
+    MIST_VM_BLOCK *pBlock;              /* block descriptors */
+    UINT32  NbOfBlocks;                 /* number of block descriptors */
+    MIST_VM_VOP *pVop;                  /* operations of element-wise kernels */
+    UINT32  NbOfVops;                   /* number of kernel operations */
+    MIST_CODE_VAR *pVar;                /* variables sorted by name */
+    UINT32  NbOfVars;                   /* number of variables */
+    MIST_CODE_SVI *pSvi;                /* variables which can be exported to the SVI, sorted by name */
+    UINT32  NbOfSvis;                   /* number of entries in pSvi */
+    UINT32 *pSeg;                       /* first instruction of each independent segment, see mist_Compile() */
+    UINT32  NbOfSegs;                   /* number of segments, >= 1 */
+    UINT8  *pInit;                      /* initial values of the data area */
+    UINT32  MemSize;                    /* size of the data area in bytes */
+    UINT32  TempOffset;                 /* VAR_TEMP region, initialized each cycle */
+    UINT32  TempSize;
+    UINT32  SrcHash;                    /* hash of the program source, see mist_SrcHash() */
+    UINT32  NbOfOptNodes;               /* syntax tree nodes removed by the optimizer */
+} MIST_CODE;
+
+/* Result of a segment executed by a worker, see mist_VmRunPar() */
+typedef struct MIST_VM_SEGRUN
+{
+    UINT32  Used;                       /* backward jumps counted against the budget */
+    UINT32  Fault;                      /* reason for stopping, MIST_VM_E_xxx */
+    UINT32  FaultPc;                    /* instruction causing the stop */
+    UINT32  Worker;                     /* trace: worker having executed the segment */
+    UINT64  Start;                      /* trace: time stamp at the start of the segment */
+    UINT64  End;                        /* trace: time stamp at the end of the segment */
+} MIST_VM_SEGRUN;
+
+/*
+ * Process image of a program: its VAR_INPUT and VAR_OUTPUT variables,
+ * exchanged with other tasks at cycle start and end, see mist_img.c.
+ * Each direction has two buffers, the one published last (Front) is read,
+ * the other one is written.
+ */
+typedef struct MIST_IMG_RANGE
+{
+    UINT32  MemOffset;                  /* offset in the data area */
+    UINT32  ImgOffset;                  /* offset in the image buffers */
+    UINT32  Size;                       /* number of bytes */
+} MIST_IMG_RANGE;
+
+typedef struct MIST_IMG_BUF
+{
+    volatile UINT32 Seq;                /* incremented before and after writing, odd = being written */
+    UINT32  Cycle;                      /* outputs: program cycle, inputs: number of writes */
+    UINT8  *pData;                      /* variables of the ranges, packed */
+} MIST_IMG_BUF;
+
+typedef struct MIST_IMG_SIDE
+{
+    volatile UINT32 Front;              /* buffer published last, 0 or 1 */
+    UINT32  Size;                       /* bytes per buffer */
+    MIST_IMG_RANGE *pRange;             /* contiguous regions of the data area, ascending */
+    UINT32  NbOfRanges;                 /* number of regions */
+    MIST_IMG_BUF Buf[2];
+} MIST_IMG_SIDE;
+
+typedef struct MIST_IMAGE
+{
+    const MIST_CODE *pCode;             /* program of the image */
+    MIST_IMG_SIDE In;                   /* VAR_INPUT: written by other tasks, read at cycle start */
+    MIST_IMG_SIDE Out;                  /* VAR_OUTPUT: written at cycle end, read by other tasks */
+    SEM_ID  WriteSema;                  /* serializes the writers of In, never taken by the program task */
+    UINT32  NbOfRetries;                /* reads repeated because the buffer was written meanwhile */
+} MIST_IMAGE;
+
+/* Program instance, all memory is allocated when it is being created */
+typedef struct MIST_VM
+{
+    const MIST_CODE *pCode;             /* program being executed */
+    MIST_REG *pReg;                     /* register file */
+    UINT8  *pMem;                       /* data area of all variables */
+    REAL32 *pLane;                      /* lane buffers of MIST_I_VECF, NULL = no kernels */
+    UINT32  Budget;                     /* max. number of backward jumps per cycle */
+    UINT32  Fault;                      /* reason for stopping, MIST_VM_E_xxx */
+    UINT32  FaultPc;                    /* instruction causing the stop */
+    UINT32  NbOfCycles;                 /* number of executed cycles */
+    struct MIST_VM **ppClone;           /* parallel execution: instance of each worker, see mist_VmParInit() */
+    UINT32  NbOfClones;                 /* parallel execution: number of workers, 0 = serial */
+    MIST_VM_SEGRUN *pSegRun;            /* parallel execution: result of each segment in the cycle */
+    volatile UINT32 ParLeft;            /* parallel execution: loop budget left in the cycle, shared */
+    volatile UINT32 ParStopSeg;         /* parallel execution: first segment having stopped, later ones are skipped */
+    MIST_IMAGE *pImg;                   /* process image, NULL = no VAR_INPUT or VAR_OUTPUT */
+    struct MIST_TRC *pTrc;              /* cycle trace of the task, NULL = segments not traced */
+    struct MIST_SVI_MAP *pSviMap;       /* variables exported to the SVI, NULL = none, see mist_SviExport() */
+} MIST_VM;
+
+
+/*
+ * Copy operation of the online change: Size bytes of the old data area
+ * at Src are taken over by the new data area at Dst.
+ */
+typedef struct MIST_VM_XFER
+{
+    UINT32  Dst;                        /* offset in the data area of the new program */
+    UINT32  Src;                        /* offset in the data area of the old program */
+    UINT32  Size;                       /* number of bytes */
+} MIST_VM_XFER;
+
+
+/*--- Function prototyping ---*/
+
+/* Functions: compiler, defined in mist_comp.c */
+EXTERN SINT32 mist_Compile(MIST_UNIT * pUnit, MIST_POU * pPou, const CHAR * pSrc, MIST_CODE ** ppCode);
+EXTERN VOID mist_CodeFree(MIST_CODE * pCode);
+EXTERN SINT32 mist_PrgLoad(const CHAR * pFileName, MIST_CODE ** ppCode);
+EXTERN SINT32 mist_PrgCacheLoad(const CHAR * pFileName, MIST_CODE ** ppCode);
+EXTERN VOID mist_PrgCacheRelease(MIST_CODE * pCode);
+EXTERN VOID mist_PrgCachePurge(BOOL All);
+
+/* Functions: virtual machine, defined in mist_vm.c */
+EXTERN MIST_VM *mist_VmCreate(const MIST_CODE * pCode, UINT32 Budget);
+EXTERN VOID mist_VmDelete(MIST_VM * pVm);
+EXTERN VOID mist_VmReset(MIST_VM * pVm);
+EXTERN SINT32 mist_VmXferMap(const MIST_CODE * pOld, const MIST_CODE * pNew, MIST_VM_XFER ** ppXfer,
+                             UINT32 * pNbOfXfers, UINT32 * pNbOfKept);
+EXTERN VOID mist_VmXfer(MIST_VM * pNew, const MIST_VM * pOld, const MIST_VM_XFER * pXfer, UINT32 NbOfXfers);
+EXTERN SINT32 mist_VmNameCmp(const CHAR * pA, const CHAR * pB);
+EXTERN SINT32 mist_VmRun(MIST_VM * pVm);
+EXTERN SINT32 mist_VmParInit(MIST_VM * pVm, UINT32 NbOfWorkers);
+EXTERN SINT32 mist_VmRunPar(MIST_VM * pVm, struct MIST_PAR *pPar);
+EXTERN const CHAR *mist_VmFaultText(UINT32 Fault);
+EXTERN VOID mist_VmDisasm(const MIST_CODE * pCode);
+EXTERN SINT32 mist_VmRound(REAL64 Value);
+EXTERN UINT32 mist_VmRoundU(REAL64 Value);
+EXTERN SINT32 mist_VmTrunc(REAL64 Value);
+EXTERN REAL64 mist_VmMath(UINT32 Fn, REAL64 Value);
+
+/* Functions: process image, defined in mist_img.c */
+EXTERN SINT32 mist_ImgCreate(const MIST_CODE * pCode, MIST_IMAGE ** ppImg);
+EXTERN VOID mist_ImgDelete(MIST_IMAGE * pImg);
+EXTERN VOID mist_ImgLoad(MIST_IMAGE * pImg, const UINT8 * pMem, UINT32 Cycle);
+EXTERN VOID mist_ImgInputs(MIST_IMAGE * pImg, UINT8 * pMem);
+EXTERN VOID mist_ImgOutputs(MIST_IMAGE * pImg, const UINT8 * pMem, UINT32 Cycle);
+EXTERN SINT32 mist_ImgRead(MIST_IMAGE * pImg, const CHAR * pName, VOID * pBuf, UINT32 Size, UINT32 * pCycle);
+EXTERN SINT32 mist_ImgWrite(MIST_IMAGE * pImg, const CHAR * pName, const VOID * pData, UINT32 Size);
+
+/* Functions: C code generator, defined in mist_cgen.c */
+EXTERN SINT32 mist_CGen(const MIST_POU * pPou, const MIST_CODE * pCode, const CHAR * pSrcName,
+                        const CHAR * pOutName);
+EXTERN VOIDFUNCPTR mist_CGenFind(const MIST_CODE * pCode);
+
+/* Variables: operation code properties, defined in mist_vm.c */
+EXTERN const UINT8 mist_VmFormat[MIST_I_COUNT];
+EXTERN const CHAR *const mist_VmOpName[MIST_I_COUNT];
+
+#endif /* Avoid problems with multiple include */
@@ -0,0 +1,137 @@
+/**
+********************************************************************************
+* @file     mist_kwgen.c
+* @author   Bachmann electronic GmbH
+* @version  $Revision: 3.90 $ $LastChangedBy: BE $
+* @date     $LastChangeDate: 2013-06-10 11:00:00 $
+*
+* @brief    Host tool which generates the perfect hash tables for the
+*           keyword recognition of the ST lexer in mist_prg.c.
+*
+*           The hash of a keyword is
+*               Length + Asso[c0] + Asso[c1] + Asso[c4] + Asso[cLast]
+*           where Asso[] maps the (upper case) characters to small numbers
+*           and c4 is the fifth character (the last one for short keywords).
+*           The fifth character separates VAR_xxx and END_xxx keywords.
+*           The tool searches association values until all keywords hash to
+*           different slots of a table with KW_HASHSIZE entries, and prints
+*           the tables in C syntax.
+*
+*           Build and run on the host:
+*               gcc -o mist_kwgen mist_kwgen.c && ./mist_kwgen
+*           The keyword list below must be kept in the same order as the
+*           MIST_KW_xxx ids in mist_prg.h.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define KW_HASHSIZE   256
+#define KW_ASSOMAX    48
+
+static const char *Keywords[] = {
+    "IF", "THEN", "ELSE", "ELSIF", "END_IF", "FOR", "TO", "DO", "BY", "END_FOR",
+    "WHILE", "END_WHILE", "REPEAT", "UNTIL", "END_REPEAT", "CASE", "OF", "END_CASE",
+    "EXIT", "RETURN", "CONTINUE",
+    "PROGRAM", "END_PROGRAM", "FUNCTION", "END_FUNCTION", "FUNCTION_BLOCK", "END_FUNCTION_BLOCK",
+    "VAR", "VAR_INPUT", "VAR_OUTPUT", "VAR_IN_OUT", "VAR_GLOBAL", "VAR_EXTERNAL", "VAR_TEMP",
+    "VAR_ACCESS", "VAR_CONFIG", "END_VAR", "CONSTANT", "RETAIN", "NON_RETAIN", "AT",
+    "BOOL", "SINT", "INT", "DINT", "LINT", "USINT", "UINT", "UDINT", "ULINT",
+    "REAL", "LREAL", "TIME", "DATE", "TIME_OF_DAY", "TOD", "DATE_AND_TIME", "DT",
+    "STRING", "WSTRING", "BYTE", "WORD", "DWORD", "LWORD",
+    "ARRAY", "STRUCT", "END_STRUCT", "TYPE", "END_TYPE",
+    "TRUE", "FALSE", "AND", "OR", "XOR", "NOT", "MOD",
+    "CONFIGURATION", "END_CONFIGURATION", "RESOURCE", "END_RESOURCE", "TASK", "WITH", "ON",
+    "READ_ONLY", "READ_WRITE", "STEP", "END_STEP", "INITIAL_STEP", "TRANSITION",
+    "END_TRANSITION", "FROM", "ACTION", "END_ACTION", "REF_TO"
+};
+#define KW_COUNT (sizeof(Keywords) / sizeof(Keywords[0]))
+
+static int Asso[256];
+
+static unsigned Hash(const char *s)
+{
+    size_t  len = strlen(s);
+    size_t  pos4 = (len > 4) ? 4 : len - 1;
+
+    return (unsigned) (len + Asso[(unsigned char) s[0]] + Asso[(unsigned char) s[1]]
+                       + Asso[(unsigned char) s[pos4]] + Asso[(unsigned char) s[len - 1]]);
+}
+
+/* number of colliding keywords with the current association values */
+static int Collisions(void)
+{
+    int     used[KW_HASHSIZE];
+    int     n = 0;
+    size_t  i;
+
+    memset(used, 0, sizeof(used));
+    for (i = 0; i < KW_COUNT; i++)
+    {
+        unsigned h = Hash(Keywords[i]);
+        if (h >= KW_HASHSIZE || used[h]++)
+            n++;
+    }
+    return n;
+}
+
+int main(void)
+{
+    int     best, tries, c, i;
+    int     slot[KW_HASHSIZE];
+
+    srand(61131);
+    for (tries = 0; tries < 1000; tries++)
+    {
+        for (c = 'A'; c <= 'Z'; c++)
+            Asso[c] = rand() % KW_ASSOMAX;
+        best = Collisions();
+
+        /* hill climbing: change single values as long as it does not get worse */
+        for (i = 0; i < 20000 && best; i++)
+        {
+            int     ch = 'A' + rand() % 26;
+            int     old = Asso[ch];
+            int     n;
+
+            Asso[ch] = rand() % KW_ASSOMAX;
+            n = Collisions();
+            if (n <= best)
+                best = n;
+            else
+                Asso[ch] = old;
+        }
+        if (!best)
+            break;
+    }
+    if (best)
+    {
+        fprintf(stderr, "no perfect hash found\n");
+        return 1;
+    }
+
+    /* lower case letters use the same values, the lexer is case insensitive */
+    for (c = 'a'; c <= 'z'; c++)
+        Asso[c] = Asso[c - 'a' + 'A'];
+
+    printf("MLOCAL const UINT8 KwAsso[256] = {\n");
+    for (c = 'A'; c <= 'Z'; c++)
+        printf("    ['%c'] = %2d, ['%c'] = %2d,\n", c, Asso[c], c - 'A' + 'a', Asso[c]);
+    printf("};\n\n");
+
+    memset(slot, 0, sizeof(slot));
+    for (i = 0; i < (int) KW_COUNT; i++)
+        slot[Hash(Keywords[i])] = i + 1;
+    printf("MLOCAL const UINT8 KwSlot[KW_HASHSIZE] = {\n");
+    for (i = 0; i < KW_HASHSIZE; i++)
+    {
+        if (slot[i])
+            printf("    [%3d] = MIST_KW_%s,\n", i, Keywords[slot[i] - 1]);
+    }
+    printf("};\n");
+    return 0;
+}
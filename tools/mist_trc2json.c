@@ -0,0 +1,319 @@
+/**
+********************************************************************************
+* @file     mist_trc2json.c
+* @author   Bachmann electronic GmbH
+* @version  $Revision: 3.90 $ $LastChangedBy: BE $
+* @date     $LastChangeDate: 2013-06-10 11:00:00 $
+*
+* @brief    Host tool which converts a cycle trace written by the module
+*           (mist_trc.c: panic, MIST_PROC_TRCDUMP or mist_TrcDump) to the
+*           trace event format (JSON) of chrome://tracing and Perfetto.
+*
+*           Each task is shown as a thread with its cycles and the segments
+*           of its ST program; segments executed by a worker of the task
+*           are shown as a thread of their own. Overruns, program stops and
+*           online changes are instant events. A cycle or segment still
+*           running at the dump, e.g. the one hanging when the watchdog
+*           expired, ends at the time of the dump and is marked "running".
+*           Times are in us since the first record.
+*
+*           Build and run on the host:
+*               gcc -o mist_trc2json mist_trc2json.c
+*               ./mist_trc2json mist.trc > mist.json
+*           The file is written in the byte order of the controller, the
+*           tool swaps it if necessary. The structures below must be kept
+*           in line with MIST_TRC_HEADER and MIST_TRC_RECORD in mist_int.h.
+*
+********************************************************************************
+* COPYRIGHT BY BACHMANN ELECTRONIC GmbH 2013
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define TRC_MAGIC        0x4D545243
+#define TRC_MAXTASKS     64
+
+/* record types, see MIST_TRC_xxx in mist_int.h */
+#define TRC_CYCLE        1
+#define TRC_CYCLEEND     2
+#define TRC_SEG          3
+#define TRC_SEGEND       4
+#define TRC_OVERRUN      5
+#define TRC_FAULT        6
+#define TRC_SWAP         7
+
+typedef struct
+{
+    uint64_t Stamp;
+    uint16_t Type;
+    uint16_t Id;
+    uint32_t Arg;
+} TRC_RECORD;
+
+typedef struct
+{
+    uint32_t Magic;
+    uint16_t Version;
+    uint16_t Reason;
+    char    TaskName[16];
+    uint32_t NbOfRecords;
+    uint32_t NbOfWritten;
+    uint32_t StampsPerMs;
+    uint32_t Period;
+    uint64_t Stamp;
+    uint32_t Time;
+    uint32_t Arg;
+} TRC_HEADER;
+
+typedef struct
+{
+    TRC_HEADER Hdr;
+    TRC_RECORD *pRec;
+} TRC_TASK;
+
+static const char *Reasons[] = { "?", "SMI", "panic", "shell" };
+static const char *Policies[] = { "CatchUp", "Skip", "PhaseReset", "Abort" };
+
+static TRC_TASK Tasks[TRC_MAXTASKS];
+static int NbOfTasks;
+static int NbOfEvents;
+
+static uint16_t Swap16(uint16_t v)
+{
+    return (uint16_t) ((v >> 8) | (v << 8));
+}
+
+static uint32_t Swap32(uint32_t v)
+{
+    return (v >> 24) | ((v >> 8) & 0xFF00) | ((v << 8) & 0xFF0000) | (v << 24);
+}
+
+static uint64_t Swap64(uint64_t v)
+{
+    return ((uint64_t) Swap32((uint32_t) v) << 32) | Swap32((uint32_t) (v >> 32));
+}
+
+/* reads all task blocks of the file, returns 0 if ok */
+static int Load(FILE * pFile)
+{
+    TRC_HEADER Hdr;
+    uint32_t i;
+
+    while (fread(&Hdr, sizeof(Hdr), 1, pFile) == 1)
+    {
+        TRC_TASK *pTask;
+        int     Swapped = 0;
+
+        if (Hdr.Magic == Swap32(TRC_MAGIC))
+        {
+            Swapped = 1;
+            Hdr.Version = Swap16(Hdr.Version);
+            Hdr.Reason = Swap16(Hdr.Reason);
+            Hdr.NbOfRecords = Swap32(Hdr.NbOfRecords);
+            Hdr.NbOfWritten = Swap32(Hdr.NbOfWritten);
+            Hdr.StampsPerMs = Swap32(Hdr.StampsPerMs);
+            Hdr.Period = Swap32(Hdr.Period);
+            Hdr.Stamp = Swap64(Hdr.Stamp);
+            Hdr.Time = Swap32(Hdr.Time);
+            Hdr.Arg = Swap32(Hdr.Arg);
+        }
+        else if (Hdr.Magic != TRC_MAGIC)
+        {
+            fprintf(stderr, "not a trace file or corrupted after %d tasks\n", NbOfTasks);
+            return -1;
+        }
+        if (Hdr.Version != 1)
+        {
+            fprintf(stderr, "unknown version %u of the trace\n", Hdr.Version);
+            return -1;
+        }
+        if (NbOfTasks == TRC_MAXTASKS)
+        {
+            fprintf(stderr, "more than %d tasks\n", TRC_MAXTASKS);
+            return -1;
+        }
+
+        pTask = &Tasks[NbOfTasks++];
+        pTask->Hdr = Hdr;
+        pTask->Hdr.TaskName[sizeof(Hdr.TaskName) - 1] = 0;
+        if (!pTask->Hdr.StampsPerMs)
+            pTask->Hdr.StampsPerMs = 1;
+        pTask->pRec = malloc((Hdr.NbOfRecords + 1) * sizeof(TRC_RECORD));
+        if (!pTask->pRec || (fread(pTask->pRec, sizeof(TRC_RECORD), Hdr.NbOfRecords, pFile) != Hdr.NbOfRecords))
+        {
+            fprintf(stderr, "task %s: file truncated\n", pTask->Hdr.TaskName);
+            return -1;
+        }
+        for (i = 0; Swapped && (i < Hdr.NbOfRecords); i++)
+        {
+            pTask->pRec[i].Stamp = Swap64(pTask->pRec[i].Stamp);
+            pTask->pRec[i].Type = Swap16(pTask->pRec[i].Type);
+            pTask->pRec[i].Id = Swap16(pTask->pRec[i].Id);
+            pTask->pRec[i].Arg = Swap32(pTask->pRec[i].Arg);
+        }
+    }
+    return NbOfTasks ? 0 : -1;
+}
+
+/* prints the separator and the common fields of an event */
+static void Event(const char *pPh, int Tid, double Ts, const char *pName)
+{
+    printf("%s\n  {\"ph\": \"%s\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"name\": \"%s\"",
+           NbOfEvents++ ? "," : "", pPh, Tid, Ts, pName);
+}
+
+/* prints the thread name of a task or worker */
+static void ThreadName(int Tid, const char *pName, unsigned Worker)
+{
+    Event("M", Tid, 0, "thread_name");
+    if (Worker)
+        printf(", \"args\": {\"name\": \"%s worker %u\"}}", pName, Worker);
+    else
+        printf(", \"args\": {\"name\": \"%s\"}}", pName);
+}
+
+/* converts the records of a task */
+static void Convert(int Idx, uint64_t Base)
+{
+    TRC_TASK *pTask = &Tasks[Idx];
+    double  Scale = 1000.0 / pTask->Hdr.StampsPerMs;
+    double  End = (double) (int64_t) (pTask->Hdr.Stamp - Base) * Scale;
+    int     Tid = (Idx + 1) * 100;
+    int     Cycle = 0;
+    uint32_t CycleNb = 0;
+    double  CycleStart = 0;
+    int     Seg = 0;
+    double  SegStart = 0;
+    TRC_RECORD SegRec;
+    char    Workers[256];
+    char    Name[64];
+    uint32_t i;
+
+    memset(Workers, 0, sizeof(Workers));
+    memset(&SegRec, 0, sizeof(SegRec));
+    ThreadName(Tid, pTask->Hdr.TaskName, 0);
+
+    for (i = 0; i < pTask->Hdr.NbOfRecords; i++)
+    {
+        TRC_RECORD *pRec = &pTask->pRec[i];
+        double  Ts = (double) (int64_t) (pRec->Stamp - Base) * Scale;
+        int     WTid = Tid + (int) (pRec->Arg & 0xFF);
+
+        switch (pRec->Type)
+        {
+            case TRC_CYCLE:
+                Cycle = 1;
+                CycleNb = pRec->Arg;
+                CycleStart = Ts;
+                break;
+
+            case TRC_CYCLEEND:
+                if (!Cycle)
+                    break;
+                Event("X", Tid, CycleStart, "cycle");
+                printf(", \"dur\": %.3f, \"args\": {\"cycle\": %u}}", Ts - CycleStart, CycleNb);
+                Cycle = 0;
+                break;
+
+            case TRC_SEG:
+                Seg = 1;
+                SegRec = *pRec;
+                SegStart = Ts;
+                break;
+
+            case TRC_SEGEND:
+                if (!Seg || (SegRec.Id != pRec->Id) || (SegRec.Arg != pRec->Arg))
+                    break;
+                if ((pRec->Arg & 0xFF) && !Workers[pRec->Arg & 0xFF])
+                {
+                    Workers[pRec->Arg & 0xFF] = 1;
+                    ThreadName(WTid, pTask->Hdr.TaskName, pRec->Arg & 0xFF);
+                }
+                snprintf(Name, sizeof(Name), "segment %u", pRec->Id);
+                Event("X", WTid, SegStart, Name);
+                printf(", \"dur\": %.3f}", Ts - SegStart);
+                Seg = 0;
+                break;
+
+            case TRC_OVERRUN:
+                Event("i", Tid, Ts, "overrun");
+                printf(", \"s\": \"t\", \"args\": {\"policy\": \"%s\", \"late_us\": %u}}",
+                       (pRec->Id < 4) ? Policies[pRec->Id] : "?", pRec->Arg);
+                break;
+
+            case TRC_FAULT:
+                Event("i", Tid, Ts, "program stopped");
+                printf(", \"s\": \"t\", \"args\": {\"fault\": %u, \"pc\": %u}}", pRec->Id, pRec->Arg);
+                break;
+
+            case TRC_SWAP:
+                Event("i", Tid, Ts, "online change");
+                printf(", \"s\": \"t\", \"args\": {\"switch_us\": %u}}", pRec->Arg);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    /* still running at the dump, e.g. hanging when the watchdog expired */
+    if (Seg)
+    {
+        snprintf(Name, sizeof(Name), "segment %u (running)", SegRec.Id);
+        Event("X", Tid + (int) (SegRec.Arg & 0xFF), SegStart, Name);
+        printf(", \"dur\": %.3f}", End - SegStart);
+    }
+    if (Cycle)
+    {
+        Event("X", Tid, CycleStart, "cycle (running)");
+        printf(", \"dur\": %.3f, \"args\": {\"cycle\": %u}}", End - CycleStart, CycleNb);
+    }
+    Event("i", Tid, End, "dump");
+    printf(", \"s\": \"t\", \"args\": {\"reason\": \"%s\", \"records\": %u, \"lost\": %u, \"period_us\": %u}}",
+           (pTask->Hdr.Reason < 4) ? Reasons[pTask->Hdr.Reason] : "?", pTask->Hdr.NbOfRecords,
+           pTask->Hdr.NbOfWritten - pTask->Hdr.NbOfRecords, pTask->Hdr.Period);
+}
+
+int main(int argc, char **argv)
+{
+    FILE   *pFile;
+    uint64_t Base = 0;
+    int     First = 1;
+    int     i;
+
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: %s trace-file > trace.json\n", argv[0]);
+        return 2;
+    }
+    pFile = fopen(argv[1], "rb");
+    if (!pFile)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    if (Load(pFile) < 0)
+        return 1;
+    fclose(pFile);
+
+    /* all tasks use the same time base, the earliest record is time 0 */
+    for (i = 0; i < NbOfTasks; i++)
+    {
+        if (Tasks[i].Hdr.NbOfRecords && (First || (Tasks[i].pRec[0].Stamp < Base)))
+        {
+            Base = Tasks[i].pRec[0].Stamp;
+            First = 0;
+        }
+    }
+
+    printf("{\"displayTimeUnit\": \"ns\", \"traceEvents\": [");
+    Event("M", 0, 0, "process_name");
+    printf(", \"args\": {\"name\": \"mist\"}}");
+    for (i = 0; i < NbOfTasks; i++)
+        Convert(i, Base);
+    printf("\n]}\n");
+    return 0;
+}